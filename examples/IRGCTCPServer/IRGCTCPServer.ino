@@ -33,6 +33,24 @@
  *   or:
  *     <control> + <d> might work.
  *
+ *   Alternatively, a client can send the same command in a binary frame,
+ *   skipping the ASCII parse entirely: a 0x01 marker byte, a little-endian
+ *   uint16_t count of items, then that many little-endian uint16_t values
+ *   (frequency, repeat count, repeat offset, then the timings - the exact
+ *   same items, in the same order, as the comma-separated form). The frame
+ *   is read straight off the socket into the send buffer, which is much
+ *   cheaper for controllers pushing a high rate of commands.
+ *
+ *   Connections are persistent & pipelined: a control system can stream
+ *   many newline-delimited (or binary) commands down one connection without
+ *   waiting in between. Commands are compiled onto the library's send queue
+ *   & transmitted back-to-back, & a "completeir,<n>" line is streamed back
+ *   as each one finishes its airtime, so burst throughput is limited by IR
+ *   airtime rather than TCP round-trips. When all the queue slots are in
+ *   use, further commands simply wait in the TCP buffer (backpressure, not
+ *   loss). Codes that fail to parse or don't fit the buffers are logged to
+ *   the serial console & never acknowledged.
+ *
  * This program will display the ESP's IP address on the serial console, or you
  * can check your wifi router for it's address.
  */
@@ -52,49 +70,99 @@ const char* kPassword = "...";  // Put your WIFI Password here.
 WiFiServer server(4998);  // Uses port 4998.
 WiFiClient client;
 
-uint16_t *code_array;
+// A comfortable maximum: frequency, repeat, offset & the timings of even the
+// longest A/C style codes fit well within this many items.
+const uint16_t kGcBufSize = 512;
+// First byte of a binary GC frame. Never the first byte of an ASCII command,
+// as those always start with a digit.
+const uint8_t kGcBinaryMark = 0x01;
+// The smallest sane GC command: frequency, repeat, offset & one timing.
+const uint16_t kGcMinItems = 4;
+// Nr. of commands that can be in flight (compiled & awaiting airtime) at
+// once. Further commands simply wait in the TCP socket buffer.
+const uint8_t kGcQueueSlots = 4;
+// Maximum length of one ASCII command line. Items are at most 5 digits
+// plus a comma, so even a full-buffer code fits.
+const uint16_t kGcLineMax = 6 * kGcBufSize;
+
+// The (reusable) send buffer. Static, so neither ingestion path allocates.
+uint16_t code_array[kGcBufSize];
+// ASCII line assembly buffer, so partially-arrived commands never block
+// the loop (or the queue drain) waiting for the rest.
+char line_buf[kGcLineMax];
+uint16_t line_len = 0;
+bool line_discard = false;  // Overlong line: eat it up to the newline.
+// Command accounting for the completion acknowledgements.
+uint32_t queued_count = 0;     // Commands accepted onto the send queue.
+uint32_t completed_count = 0;  // Commands that have finished their airtime.
+uint32_t acked_count = 0;      // Acknowledgements streamed to the client.
+bool queue_on = false;  // Did the send queue get its memory?
 #define IR_LED 4  // ESP8266 GPIO pin to use. Recommended: 4 (D2).
 
 IRsend irsend(IR_LED);  // Set the GPIO to be used to sending the message.
 
-void sendGCString(String str) {
-  int16_t index;
-  uint16_t count;
-
-  // Find out how many items there are in the string.
-  index = -1;
-  count = 1;
-  do {
-    index = str.indexOf(',', index + 1);
-    count++;
-  } while (index != -1);
-
-  // Now we know how many there are, allocate the memory to store them all.
-  code_array = reinterpret_cast<uint16_t*>(malloc(count * sizeof(uint16_t)));
-  // Check we malloc'ed successfully.
-  if (code_array == NULL) {  // malloc failed, so give up.
-    Serial.printf("\nCan't allocate %d bytes. (%d bytes free)\n",
-                  count * sizeof(uint16_t), ESP.getFreeHeap());
-    Serial.println("Giving up & forcing a reboot.");
-    ESP.restart();  // Reboot.
-    delay(500);  // Wait for the restart to happen.
-    return;  // Should never get here, but just in case.
-  }
-
-  // Now convert the strings to integers and place them in code_array.
-  count = 0;
-  uint16_t start_from = 0;
-  do {
-    index = str.indexOf(',', start_from);
-    code_array[count] = str.substring(start_from, index).toInt();
-    start_from = index + 1;
-    count++;
-  } while (index != -1);
+// Send queue completion callback: one more command has hit the air.
+// The acknowledgement itself is streamed from loop().
+void gcSendDone(void) { completed_count++; }
 
+// Queue (or, without a queue, directly transmit) the code waiting in
+// code_array. Successfully accepted commands get a completion ack later.
+void transmitGC(uint16_t count) {
 #if SEND_GLOBALCACHE
-  irsend.sendGC(code_array, count);  // All done. Send it.
+  if (queue_on) {
+    irsend.queueBegin();
+    irsend.sendGC(code_array, count);  // Compiles onto the queue.
+    if (irsend.queueCommit(&gcSendDone)) {
+      queued_count++;
+    } else {  // e.g. The compiled pulse train didn't fit a queue buffer.
+      Serial.println("\nCode couldn't be queued. Ignored.");
+    }
+  } else {  // No queue memory. Send it the old (blocking) way.
+    irsend.sendGC(code_array, count);
+    queued_count++;
+    completed_count++;  // It has already hit the air. Ack it right away.
+  }
 #endif  // SEND_GLOBALCACHE
-  free(code_array);  // Free up the memory allocated.
+}
+
+void sendGCString(const char *str) {
+  uint16_t count = 0;
+
+  // Convert the comma-separated values to integers, straight into the
+  // send buffer.
+  while (*str != '\0') {
+    if (count >= kGcBufSize) {  // Code too long for the buffer. Drop it.
+      Serial.printf("\nCode has more than %d items. Ignored.\n", kGcBufSize);
+      return;
+    }
+    char *end;
+    code_array[count++] = strtol(str, &end, 10);
+    if (*end == '\0') break;  // That was the last item.
+    str = end + (*end == ',');  // Step over the separator.
+  }
+  transmitGC(count);
+}
+
+// Read a length-prefixed binary GC frame (see the notes at the top) straight
+// off the TCP socket into the send buffer & transmit it. No ASCII parsing,
+// no String handling & no allocation.
+void sendGCBinary(void) {
+  uint8_t prefix[2];
+  if (client.readBytes(prefix, sizeof(prefix)) != sizeof(prefix))
+    return;  // The client went away mid-frame.
+  uint16_t count = prefix[0] | (prefix[1] << 8);  // Little-endian.
+  if (count < kGcMinItems || count > kGcBufSize) {
+    Serial.printf("\nBogus binary frame length: %d. Ignored.\n", count);
+    client.flush();  // Try to find the start of the next frame.
+    return;
+  }
+  // The items are little-endian uint16_t's & so is this platform, so they
+  // can be received directly into the send buffer.
+  uint16_t nr_bytes = count * sizeof(uint16_t);
+  if (client.readBytes(reinterpret_cast<uint8_t*>(code_array), nr_bytes) !=
+      nr_bytes)
+    return;  // Short read. i.e. The client went away mid-frame.
+  transmitGC(count);  // All done. Send it.
 }
 
 void setup() {
@@ -113,21 +181,56 @@ void setup() {
   IPAddress myAddress = WiFi.localIP();
   Serial.println(myAddress.toString());
   irsend.begin();
+  // Pipelining: commands get compiled onto the send queue so the next one
+  // can be parsed while the previous is still on the air. If the memory
+  // isn't available, transmitGC() falls back to blocking sends.
+  queue_on = irsend.setSendQueue(kGcQueueSlots, kGcBufSize);
+  if (!queue_on)
+    Serial.println("No memory for the send queue. Not pipelining.");
 }
 
 void loop() {
-  while (!client)
-    client = server.available();
+  irsend.sendQueueLoop();  // Transmit anything due from the send queue.
 
-  while (!client.connected()) {
-    delay(900);
-    client = server.available();
+  if (!client || !client.connected()) {  // (Re)accept without blocking, so
+    client = server.available();         // the queue keeps draining.
+    if (!client) return;
+    line_len = 0;  // A new client. Discard any partial line.
+    line_discard = false;
+  }
+
+  // Stream back an acknowledgement for each command that has hit the air.
+  while (acked_count < completed_count) {
+    client.printf("completeir,%lu\r\n", (unsigned long)++acked_count);
   }
 
-  if (client.available()) {
-    String ir_code_str = client.readStringUntil('\r');  // Exclusive of \r
-    client.readStringUntil('\n');  // Skip new line as well
-    client.flush();
-    sendGCString(ir_code_str);
+  // Ingest from the socket, but only while there are free queue slots.
+  // Anything further waits in the TCP buffer. (Backpressure, not loss.)
+  while (client.available() &&
+         queued_count - completed_count < kGcQueueSlots) {
+    if (line_len == 0 && client.peek() == kGcBinaryMark) {  // A binary frame.
+      client.read();  // Consume the marker byte.
+      sendGCBinary();
+      continue;
+    }
+    // An ASCII (comma-separated) command. Accumulate it a character at a
+    // time so a half-arrived line never blocks the loop.
+    char c = client.read();
+    if (c == '\r') continue;  // Tolerate (ignore) carriage returns.
+    if (c == '\n') {  // A complete command line.
+      if (line_discard) {  // It was overlong. We've now eaten all of it.
+        line_discard = false;
+      } else if (line_len > 0) {
+        line_buf[line_len] = '\0';
+        sendGCString(line_buf);
+      }
+      line_len = 0;
+    } else if (line_len >= kGcLineMax - 1) {  // Too long to be a GC code.
+      Serial.println("\nCommand line too long. Ignored.");
+      line_len = 0;
+      line_discard = true;  // Eat the rest of it.
+    } else if (!line_discard) {
+      line_buf[line_len++] = c;
+    }
   }
 }
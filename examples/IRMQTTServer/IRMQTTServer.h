@@ -67,6 +67,7 @@ const uint32_t kMqttReconnectTime = 5000;  // Delay(ms) between reconnect tries.
 #define MQTT_SEND "send"  // Sub-topic we get new commands from.
 #define MQTT_RECV "received"  // Topic we send received IRs to.
 #define MQTT_LOG "log"  // Topic we send log messages to.
+#define MQTT_STATS "stats"  // Topic we publish performance stats to.
 #define MQTT_LWT "status"  // Topic for the Last Will & Testament.
 #define MQTT_CLIMATE "ac"  // Sub-topic for the climate topics.
 #define MQTT_CLIMATE_CMND "cmnd"  // Sub-topic for the climate command topics.
@@ -75,6 +76,19 @@ const uint32_t kMqttReconnectTime = 5000;  // Delay(ms) between reconnect tries.
 
 #define QOS 1  // MQTT broker should queue up any unreceived messages for us
 // #define QOS 0  // MQTT broker WON'T queue up messages for us. Fire & Forget.
+
+// Outbound MQTT messages (acks, logs, stat updates, received IR reports)
+// are parked on a small queue & published a few at a time from loop(),
+// rather than synchronously from wherever they were generated.
+const uint8_t kMqttPubQueueSize = 8;  // Nr. of messages the queue can hold.
+const uint8_t kMqttPubPerLoop = 2;  // Max nr. published per loop() pass.
+
+// Periodically publish a compact performance stats payload (counters since
+// boot, heap watermarks, decode/send timing) to the MQTT_STATS topic, so a
+// fleet of these servers can be monitored & tuned from the broker end.
+// See doStatsReport().
+#define REPORT_STATS true
+const uint32_t kStatsPeriodMs = 5 * 60 * 1000;  // Milliseconds. i.e. 5 mins.
 #endif  // MQTT_ENABLE
 
 // ------------------------ IR Capture Settings --------------------------------
@@ -94,6 +108,23 @@ const uint16_t kMinUnknownSize = 2 * 10;
 #define REPORT_RAW_UNKNOWNS false  // Report the whole buffer, recommended:
                                    // MQTT_MAX_PACKET_SIZE of 1024 or more
 
+// ----------------------- IR Send Queue Settings ------------------------------
+// IR messages are compiled onto an asynchronous send queue (one per send
+// GPIO; see IRsend::setSendQueue()) & transmitted from loop(), so a long
+// A/C transmission (e.g. Daikin2, ~200ms) no longer stalls MQTT keepalives
+// or the web server while it sends.
+// Set kSendQueueMsgs to 0 to revert to the old blocking sends.
+const uint8_t kSendQueueMsgs = 3;  // Nr. of messages each send GPIO can queue.
+const uint16_t kSendQueueEntries = 760;  // Mark/space entries per message.
+                                         // 760 fits a Daikin2, our largest.
+
+// How long to wait after the last climate change before transmitting the
+// resulting A/C state. Home-automation scene changes arrive as several
+// rapid single-field updates; waiting a beat & sending only the final
+// state coalesces them into a single transmitted frame.
+// Set to 0 to disable coalescing. i.e. Transmit every update immediately.
+const uint32_t kClimateSettleMs = 250;  // Milliseconds.
+
 // ------------------------ Advanced Usage Only --------------------------------
 // Change if you need multiple independent send gpio/topics.
 const uint8_t gpioTable[] = {
@@ -180,6 +211,8 @@ void handleSendMqttDiscovery(void);
 void subscribing(const String topic_name);
 void unsubscribing(const String topic_name);
 void mqttLog(const String mesg);
+bool mqttPublish(const String topic, const String payload, const bool retain);
+void mqttDrainPublish(void);
 bool reconnect(void);
 void receivingMQTT(String const topic_name, String const callback_str);
 void callback(char* topic, byte* payload, unsigned int length);
@@ -255,4 +288,6 @@ bool cmpClimate(const commonAcState_t a, const commonAcState_t b);
 bool sendClimate(const commonAcState_t prev, const commonAcState_t next,
                  const String topic_prefix, const bool retain,
                  const bool forceMQTT, const bool forceIR);
+void queueClimate(const commonAcState_t next);
+void flushClimate(const bool force = false);
 #endif  // EXAMPLES_IRMQTTSERVER_IRMQTTSERVER_H_
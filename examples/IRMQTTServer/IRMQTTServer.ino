@@ -330,13 +330,20 @@ IRsend *IrSendTable[kSendTableSize];
 String lastIrReceived = "None";
 uint32_t lastIrReceivedTime = 0;
 uint32_t irRecvCounter = 0;
+uint32_t irUnknownCounter = 0;   // Nr. of frames no decoder recognised.
+uint32_t irOverflowCounter = 0;  // Nr. of captures that overflowed.
 #endif  // IR_RX
+uint32_t minFreeHeap = UINT32_MAX;  // Lowest free heap seen. For the stats.
 
 // Climate stuff
 commonAcState_t climate;
 commonAcState_t climate_prev;
 IRac commonAc(gpioTable[0]);
 TimerMs lastClimateIr = TimerMs();  // When we last sent the IR Climate mesg.
+// Climate command coalescing state. See queueClimate()/flushClimate().
+commonAcState_t climate_pending;  // The state waiting out its settle window.
+bool hasPendingClimate = false;   // Is climate_pending waiting to be sent?
+TimerMs climateSettleTimer = TimerMs();  // Time since the last update to it.
 uint32_t irClimateCounter = 0;  // How many have we sent?
 // Store the success status of the last climate send.
 bool lastClimateSucceeded = false;
@@ -364,6 +371,7 @@ String MqttAck;  // Sub-topic we send back acknowledgements on.
 String MqttSend;  // Sub-topic we get new commands from.
 String MqttRecv;  // Topic we send received IRs to.
 String MqttLog;  // Topic we send log messages to.
+String MqttStats;  // Topic we publish performance stats to.
 String MqttLwt;  // Topic for the Last Will & Testament.
 String MqttClimate;  // Sub-topic for the climate topics.
 String MqttClimateCmnd;  // Sub-topic for the climate command topics.
@@ -372,6 +380,18 @@ String MqttDiscovery;
 String MqttHAName;
 String MqttClientId;
 
+// Outbound MQTT publish queue. Messages generated while an IR message is
+// being handled (or at any other time) are parked here, & loop() publishes
+// a few per pass. See mqttPublish() & mqttDrainPublish().
+typedef struct {
+  String topic;
+  String payload;
+  bool retain;
+} MqttPubEntry;
+MqttPubEntry mqttPubQueue[kMqttPubQueueSize];
+uint8_t mqttPubHead = 0;  // Producer position. One ring slot stays unused.
+uint8_t mqttPubTail = 0;  // Consumer position.
+
 // Primative lock file for gating MQTT state broadcasts.
 bool lockMqttBroadcast = true;
 TimerMs lastBroadcast = TimerMs();  // When we last sent a broadcast.
@@ -379,6 +399,7 @@ bool hasBroadcastBeenSent = false;
 TimerMs lastDiscovery = TimerMs();  // When we last sent a Discovery.
 bool hasDiscoveryBeenSent = false;
 TimerMs statListenTime = TimerMs();  // How long we've been listening for.
+TimerMs lastStatsReport = TimerMs();  // When we last published stats.
 #endif  // MQTT_ENABLE
 
 bool isSerialGpioUsedByIr(void) {
@@ -538,8 +559,10 @@ String listOfSendGpios(void) {
   return result;
 }
 
-String htmlMenu(void) {
-  return F(
+// The static portions of the web pages live in flash (PROGMEM) & are
+// streamed straight from there, rather than being assembled into a heap
+// String on every request.
+const char kHtmlMenu[] PROGMEM =
       "<center>"
         "<button type='button' "
           "onclick='window.location=\"/\"'>"
@@ -562,24 +585,37 @@ String htmlMenu(void) {
           "Admin"
         "</button>"
       "</center>"
-      "<hr>");
+      "<hr>";
+
+String htmlMenu(void) {
+  return FPSTR(kHtmlMenu);
 }
 
-// Root web page with example usage etc.
-void handleRoot(void) {
-#if HTML_PASSWORD_ENABLE
-  if (!server.authenticate(HttpUsername, HttpPassword)) {
-    debug("Basic HTTP authentication failure for /.");
-    return server.requestAuthentication();
-  }
-#endif
-  String html = F(
+// The firmware version doubles as the ETag for the static pages: their
+// content can only change with a reflash, which changes the version & so
+// busts any browser's cached copy.
+#define kHtmlPageEtag "\"" _MY_VERSION_ "\""
+
+// Handle the HTTP caching of the static pages.
+// Returns true if the client's cached copy is still current. (A 304 has been
+// sent & the handler should send nothing more.) Otherwise attaches the
+// ETag/Cache-Control headers for the page about to be sent.
+bool handleCaching(void) {
+  if (server.header(F("If-None-Match")) == kHtmlPageEtag) {
+    server.send(304);
+    return true;
+  }
+  server.sendHeader(F("ETag"), F(kHtmlPageEtag));
+  server.sendHeader(F("Cache-Control"), F("max-age=86400"));
+  return false;
+}
+
+const char kHtmlRootPage1[] PROGMEM =
     "<html><head><title>IR MQTT server</title></head>"
     "<body>"
     "<center><h1>ESP8266 IR MQTT Server</h1></center>"
-    "<center><small><i>" _MY_VERSION_ "</i></small></center>");
-  html += htmlMenu();
-  html += F(
+    "<center><small><i>" _MY_VERSION_ "</i></small></center>";
+const char kHtmlRootPage2[] PROGMEM =
     "<h3>Send a simple IR message</h3><p>"
     "<form method='POST' action='/ir' enctype='multipart/form-data'>"
       "Type: "
@@ -674,11 +710,11 @@ void handleRoot(void) {
         "<option value='45'>Whirlpool</option>"
       "</select>"
       " State code: 0x"
-      "<input type='text' name='code' size='");
-  html += String(kStateSizeMax * 2);
-  html += F("' maxlength='");
-  html += String(kStateSizeMax * 2);
-  html += F("'"
+      "<input type='text' name='code' size='";
+const char kHtmlRootPage3[] PROGMEM =
+    "' maxlength='";
+const char kHtmlRootPage4[] PROGMEM =
+    "'"
           " value='190B8050000000E0190B8070000010F0'>"
       " <input type='submit' value='Send A/C State'>"
     "</form>"
@@ -720,8 +756,31 @@ void handleRoot(void) {
           "size='2' maxlength='2'>"
       " <input type='submit' value='Send Pronto'>"
     "</form>"
-    "<br></body></html>");
-  server.send(200, "text/html", html);
+    "<br></body></html>";
+
+// Root web page with example usage etc.
+void handleRoot(void) {
+#if HTML_PASSWORD_ENABLE
+  if (!server.authenticate(HttpUsername, HttpPassword)) {
+    debug("Basic HTTP authentication failure for /.");
+    return server.requestAuthentication();
+  }
+#endif
+  if (handleCaching()) return;  // The client already has the current copy.
+  // Stream the page straight from flash, pausing only to render the couple
+  // of dynamic values into a small buffer.
+  char buf[8];
+  snprintf(buf, sizeof(buf), "%d", kStateSizeMax * 2);
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/html", "");
+  server.sendContent_P(kHtmlRootPage1);
+  server.sendContent_P(kHtmlMenu);
+  server.sendContent_P(kHtmlRootPage2);
+  server.sendContent(buf);  // The "State code" input's size attribute.
+  server.sendContent_P(kHtmlRootPage3);
+  server.sendContent(buf);  // Its maxlength attribute. (The same value)
+  server.sendContent_P(kHtmlRootPage4);
+  server.sendContent("");  // Terminate the chunked response.
 }
 
 String addJsReloadUrl(const String url, const uint16_t timeout_s,
@@ -748,21 +807,12 @@ String addJsReloadUrl(const String url, const uint16_t timeout_s,
   return html;
 }
 
-// Web page with hardcoded example usage etc.
-void handleExamples(void) {
-#if HTML_PASSWORD_ENABLE
-  if (!server.authenticate(HttpUsername, HttpPassword)) {
-    debug("Basic HTTP authentication failure for /examples.");
-    return server.requestAuthentication();
-  }
-#endif
-  String html = F(
+const char kHtmlExamplesPage1[] PROGMEM =
     "<html><head><title>IR MQTT examples</title></head>"
     "<body>"
     "<center><h1>ESP8266 IR MQTT Server</h1></center>"
-    "<center><small><i>" _MY_VERSION_ "</i></small></center>");
-  html += htmlMenu();
-  html += F(
+    "<center><small><i>" _MY_VERSION_ "</i></small></center>";
+const char kHtmlExamplesPage2[] PROGMEM =
     "<h3>Hardcoded examples</h3>"
     "<p><a href=\"ir?code=38000,1,69,341,171,21,64,21,64,21,21,21,21,21,21,21,"
         "21,21,21,21,64,21,64,21,21,21,64,21,21,21,21,21,21,21,64,21,21,21,64,"
@@ -793,8 +843,24 @@ void handleExamples(void) {
       "Change just the temp to 27C <i>(via HTTP aircon interface)</i></a></p>"
     "<p><a href=\"aircon/set?power=off&mode=off\">"
       "Turn OFF the current A/C <i>(via HTTP aircon interface)</i></a></p>"
-    "<br><hr></body></html>");
-  server.send(200, "text/html", html);
+    "<br><hr></body></html>";
+
+// Web page with hardcoded example usage etc.
+void handleExamples(void) {
+#if HTML_PASSWORD_ENABLE
+  if (!server.authenticate(HttpUsername, HttpPassword)) {
+    debug("Basic HTTP authentication failure for /examples.");
+    return server.requestAuthentication();
+  }
+#endif
+  if (handleCaching()) return;  // The client already has the current copy.
+  // The page is entirely static. Stream it straight from flash.
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "text/html", "");
+  server.sendContent_P(kHtmlExamplesPage1);
+  server.sendContent_P(kHtmlMenu);
+  server.sendContent_P(kHtmlExamplesPage2);
+  server.sendContent("");  // Terminate the chunked response.
 }
 
 String boolToString(const bool value) {
@@ -1062,19 +1128,17 @@ void handleAirConSet(void) {
     return server.requestAuthentication();
   }
 #endif
-  commonAcState_t result = climate;
+  // Base the update on any state still waiting out its settle window, so a
+  // pending MQTT change isn't silently lost.
+  commonAcState_t result = hasPendingClimate ? climate_pending : climate;
   debug("New common a/c received via HTTP");
   for (uint16_t i = 0; i < server.args(); i++)
     result = updateClimate(result, server.argName(i), "", server.arg(i));
 
-#if MQTT_ENABLE
-  sendClimate(climate, result, MqttClimateStat,
-              true, false, false);
-#else  // MQTT_ENABLE
-  sendClimate(climate, result, "", false, false, false);
-#endif  // MQTT_ENABLE
-  // Update the old climate state with the new one.
-  climate = result;
+  // The web form is a single atomic update, so skip the settle window &
+  // transmit it right away.
+  queueClimate(result);
+  flushClimate(true);
   // Redirect back to the aircon page.
   String html = F(
       "<html><head><title>Update Aircon</title></head>"
@@ -1952,6 +2016,8 @@ void init_vars(void) {
   MqttRecv = String(MqttPrefix) + '/' + MQTT_RECV;
   // Topic we send log messages to.
   MqttLog = String(MqttPrefix) + '/' + MQTT_LOG;
+  // Topic we publish performance stats to.
+  MqttStats = String(MqttPrefix) + '/' + MQTT_STATS;
   // Topic for the Last Will & Testament.
   MqttLwt = String(MqttPrefix) + '/' + MQTT_LWT;
   // Sub-topic for the climate topics.
@@ -1994,6 +2060,11 @@ void setup(void) {
     IrSendTable[i] = new IRsend(gpioTable[i]);
     IrSendTable[i]->begin();
     offset = IrSendTable[i]->calibrate();
+    // Enable the asynchronous send queue, so transmission happens from
+    // loop() rather than blocking whatever asked for the send. If the
+    // allocation fails we just fall back to the old blocking behaviour.
+    if (kSendQueueMsgs > 0)
+      IrSendTable[i]->setSendQueue(kSendQueueMsgs, kSendQueueEntries);
   }
 #ifdef IR_RX
 #if IR_RX_PULLUP
@@ -2122,6 +2193,9 @@ void setup(void) {
   // Set up an error page.
   server.onNotFound(handleNotFound);
 
+  // Collect the request header the static pages' caching needs.
+  const char *headerkeys[] = {"If-None-Match"};
+  server.collectHeaders(headerkeys, 1);
   server.begin();
   debug("HTTP server started");
 }
@@ -2149,8 +2223,46 @@ void unsubscribing(const String topic_name) {
 
 void mqttLog(const String mesg) {
   debug(mesg.c_str());
-  mqtt_client.publish(MqttLog.c_str(), mesg.c_str());
-  mqttSentCounter++;
+  mqttPublish(MqttLog, mesg, false);
+}
+
+// Park an outbound MQTT message on the publish queue. The actual publishing
+// happens a few messages at a time from loop() (see mqttDrainPublish()), so
+// callers never block on the network mid-task & message order is preserved.
+// If the queue is full the oldest entry is dropped to make room, as the
+// freshest state is the one worth keeping.
+//
+// Args:
+//   topic:   The topic to publish to.
+//   payload: The message content.
+//   retain:  Should the broker retain the message?
+// Returns:
+//   true. (Queuing always succeeds; failure can only happen at publish time)
+bool mqttPublish(const String topic, const String payload, const bool retain) {
+  uint8_t next = (mqttPubHead + 1) % kMqttPubQueueSize;
+  if (next == mqttPubTail)  // The queue is full. Drop the oldest message.
+    mqttPubTail = (mqttPubTail + 1) % kMqttPubQueueSize;
+  mqttPubQueue[mqttPubHead].topic = topic;
+  mqttPubQueue[mqttPubHead].payload = payload;
+  mqttPubQueue[mqttPubHead].retain = retain;
+  mqttPubHead = next;
+  return true;
+}
+
+// Publish some of the queued outbound MQTT messages. Called from loop()
+// while connected. At most kMqttPubPerLoop are sent per call, keeping each
+// loop() pass short.
+void mqttDrainPublish(void) {
+  for (uint8_t i = 0; i < kMqttPubPerLoop && mqttPubTail != mqttPubHead; i++) {
+    if (!mqtt_client.connected()) return;  // Try again once we reconnect.
+    MqttPubEntry *entry = &mqttPubQueue[mqttPubTail];
+    if (mqtt_client.publish(entry->topic.c_str(), entry->payload.c_str(),
+                            entry->retain))
+      mqttSentCounter++;
+    entry->topic = "";  // Release the String heap memory.
+    entry->payload = "";
+    mqttPubTail = (mqttPubTail + 1) % kMqttPubQueueSize;
+  }
 }
 
 bool reconnect(void) {
@@ -2244,6 +2356,58 @@ void doBroadcast(TimerMs *timer, const uint32_t interval,
   }
 }
 
+#if REPORT_STATS
+// Periodically assemble & publish the performance stats payload.
+// A single compact line of comma-separated counter=value pairs, so a whole
+// fleet of these servers can be graphed/alerted on cheaply at the broker
+// end. All counters are totals since boot.
+void doStatsReport(TimerMs *timer, const uint32_t interval) {
+  if (timer->elapsed() < interval) return;
+  String payload = "up=" + String(millis() / 1000);
+  payload += ",heap=" + String(ESP.getFreeHeap());
+  payload += ",heapmin=" + String(minFreeHeap);
+#if IRMEM_STATS
+  payload += ",irheap=" + String(irMemCurrent());
+  payload += ",irheappeak=" + String(irMemPeak());
+#endif  // IRMEM_STATS
+  payload += ",sends=" + String(sendReqCounter);
+#if IRSEND_STATS
+  irsend_stats_t tx = IrSendTable[0]->getSendStats();
+  payload += ",txpulses=" + String(tx.entries);
+  if (tx.entries) {
+    // Average & worst-case per-pulse timing skew (uSecs), i.e. how far the
+    // modulator strays from the requested mark/space durations.
+    payload += ",txskewavg=" +
+        String((int32_t)(((int64_t)tx.achieved - tx.requested) /
+                         tx.entries));
+    payload += ",txskewmin=" + String(tx.min_skew);
+    payload += ",txskewmax=" + String(tx.max_skew);
+  }
+#endif  // IRSEND_STATS
+#ifdef IR_RX
+  payload += ",recvs=" + String(irRecvCounter);
+  payload += ",unknowns=" + String(irUnknownCounter);
+  payload += ",overflows=" + String(irOverflowCounter);
+  payload += ",bufhigh=" + String(irrecv.getBufHighWaterMark());
+#if IRRECV_STATS
+  // The UNKNOWN entry holds the overall decode() call figures.
+  decoder_stats_t rx = irrecv.getDecodeStats(UNKNOWN);
+  payload += ",decodes=" + String(rx.attempts);
+  payload += ",decodehits=" + String(rx.successes);
+  // Mean decode() latency (uSecs). The counters don't keep a histogram,
+  // so percentiles aren't available; the mean plus the unknown/overflow
+  // counts above cover the tuning signals we act on.
+  if (rx.attempts)
+    payload += ",decodeavgus=" + String(rx.usecs / rx.attempts);
+#endif  // IRRECV_STATS
+#endif  // IR_RX
+  payload += ",mqttdis=" + String(mqttDisconnectCounter);
+  payload += ",mqttpub=" + String(mqttSentCounter);
+  mqttPublish(MqttStats, payload, false);
+  timer->reset();
+}
+#endif  // REPORT_STATS
+
 void receivingMQTT(String const topic_name, String const callback_str) {
   char* tok_ptr;
   uint64_t code = 0;
@@ -2264,11 +2428,13 @@ void receivingMQTT(String const topic_name, String const callback_str) {
   if (topic_name.startsWith(MqttClimate)) {
     if (topic_name.startsWith(MqttClimateCmnd)) {
       debug("It's a climate command topic");
+      // Apply the update on top of any state already waiting out its settle
+      // window, & (re)queue it: only the final state of a rapid burst of
+      // updates actually gets transmitted. (See flushClimate())
       commonAcState_t updated = updateClimate(
-          climate, topic_name, MqttClimateCmnd, callback_str);
-      sendClimate(climate, updated, MqttClimateStat,
-                  true, false, false);
-      climate = updated;
+          hasPendingClimate ? climate_pending : climate, topic_name,
+          MqttClimateCmnd, callback_str);
+      queueClimate(updated);
     } else if (topic_name.startsWith(MqttClimateStat)) {
       debug("It's a climate state topic. Update internal state and DON'T send");
       climate = updateClimate(
@@ -2388,6 +2554,21 @@ void sendMQTTDiscovery(const char *topic) {
 void loop(void) {
   server.handleClient();  // Handle any web activity
 
+#if REPORT_STATS
+  // Track the heap low-water mark for the stats reports.
+  uint32_t freeHeap = ESP.getFreeHeap();
+  if (freeHeap < minFreeHeap) minFreeHeap = freeHeap;
+#endif  // REPORT_STATS
+
+  // Transmit at most one queued IR message per send GPIO per pass, so a
+  // burst of queued sends drains without starving the network handling
+  // between (long) messages.
+  for (uint8_t i = 0; i < kSendTableSize; i++)
+    IrSendTable[i]->sendQueueLoop();
+
+  // Transmit a coalesced climate state whose settle window has expired.
+  flushClimate();
+
 #if MQTT_ENABLE
   uint32_t now = millis();
   // MQTT client connection management
@@ -2428,6 +2609,7 @@ void loop(void) {
     // MQTT loop
     lastConnectedTime = now;
     mqtt_client.loop();
+    mqttDrainPublish();  // Send a few queued outbound messages, if any.
     if (lockMqttBroadcast && statListenTime.elapsed() > kStatListenPeriodMs) {
       unsubscribing(MqttClimateStat + '+');
       mqttLog("Finished listening for previous state.");
@@ -2440,14 +2622,26 @@ void loop(void) {
     }
     // Periodically send all of the climate state via MQTT.
     doBroadcast(&lastBroadcast, kBroadcastPeriodMs, climate, false, false);
+#if REPORT_STATS
+    // Periodically publish the performance stats payload.
+    doStatsReport(&lastStatsReport, kStatsPeriodMs);
+#endif  // REPORT_STATS
   }
 #endif  // MQTT_ENABLE
 #ifdef IR_RX
   // Check if an IR code has been received via the IR RX module.
+  bool gotIrMessage = irrecv.decode(&capture);
+#if REPORT_STATS
+  if (gotIrMessage) {
+    // Keep the stats counters fed, even for messages we don't report.
+    if (capture.decode_type == UNKNOWN) irUnknownCounter++;
+    if (capture.overflow) irOverflowCounter++;
+  }
+#endif  // REPORT_STATS
 #if REPORT_UNKNOWNS
-  if (irrecv.decode(&capture)) {
+  if (gotIrMessage) {
 #else  // REPORT_UNKNOWNS
-  if (irrecv.decode(&capture) && capture.decode_type != UNKNOWN) {
+  if (gotIrMessage && capture.decode_type != UNKNOWN) {
 #endif  // REPORT_UNKNOWNS
     lastIrReceivedTime = millis();
     lastIrReceived = String(capture.decode_type) + "," +
@@ -2472,8 +2666,7 @@ void loop(void) {
     if (!hasACState(capture.decode_type))
       lastIrReceived += "," + String(capture.bits);
 #if MQTT_ENABLE
-    mqtt_client.publish(MqttRecv.c_str(), lastIrReceived.c_str());
-    mqttSentCounter++;
+    mqttPublish(MqttRecv, lastIrReceived, false);
 #endif  // MQTT_ENABLE
     irRecvCounter++;
     debug("Incoming IR message sent to MQTT:");
@@ -2524,6 +2717,13 @@ bool sendIRCode(IRsend *irsend, int const ir_type,
 
   bool success = true;  // Assume success.
 
+  // Compile the message onto the asynchronous send queue (when one is
+  // enabled) instead of transmitting it right here. The transmission itself
+  // happens one message per pass from loop() (see sendQueueLoop()), so MQTT
+  // keepalives & the web server stay serviced through even a Daikin2-length
+  // send. Without a queue the sendXxx() calls below transmit as before.
+  bool queued = irsend->queueBegin();
+
   // send the IR message.
   switch (ir_type) {
 #if SEND_RC5
@@ -2806,6 +3006,9 @@ bool sendIRCode(IRsend *irsend, int const ir_type,
       // If we got here, we didn't know how to send it.
       success = false;
   }
+  // Park the compiled message on the send queue. (A failed/unknown send
+  // compiles to nothing, & queueCommit() just discards it.)
+  if (queued) success &= irsend->queueCommit();
   lastSendTime = millis();
   // Release the lock.
   lockIr = false;
@@ -2830,13 +3033,11 @@ bool sendIRCode(IRsend *irsend, int const ir_type,
 #if MQTT_ENABLE
     if (success) {
       if (ir_type == PRONTO && repeat > 0)
-        mqtt_client.publish(MqttAck.c_str(), (String(ir_type) + ",R" +
-                                              String(repeat) + "," +
-                                              String(code_str)).c_str());
+        mqttPublish(MqttAck, String(ir_type) + ",R" + String(repeat) + "," +
+                        String(code_str),
+                    false);
       else
-        mqtt_client.publish(MqttAck.c_str(), (String(ir_type) + "," +
-                                              String(code_str)).c_str());
-      mqttSentCounter++;
+        mqttPublish(MqttAck, String(ir_type) + "," + String(code_str), false);
     }
 #endif  // MQTT_ENABLE
   } else {  // For "short" codes, we break it down a bit more before we report.
@@ -2845,11 +3046,9 @@ bool sendIRCode(IRsend *irsend, int const ir_type,
     debug(("Repeats: " + String(repeat)).c_str());
 #if MQTT_ENABLE
     if (success) {
-      mqtt_client.publish(MqttAck.c_str(), (String(ir_type) + "," +
-                                            uint64ToString(code, 16)
-                                            + "," + String(bits) + "," +
-                                            String(repeat)).c_str());
-      mqttSentCounter++;
+      mqttPublish(MqttAck, String(ir_type) + "," + uint64ToString(code, 16) +
+                      "," + String(bits) + "," + String(repeat),
+                  false);
     }
 #endif  // MQTT_ENABLE
   }
@@ -2858,8 +3057,7 @@ bool sendIRCode(IRsend *irsend, int const ir_type,
 
 bool sendInt(const String topic, const int32_t num, const bool retain) {
 #if MQTT_ENABLE
-  mqttSentCounter++;
-  return mqtt_client.publish(topic.c_str(), String(num).c_str(), retain);
+  return mqttPublish(topic, String(num), retain);
 #else  // MQTT_ENABLE
   return true;
 #endif  // MQTT_ENABLE
@@ -2867,8 +3065,7 @@ bool sendInt(const String topic, const int32_t num, const bool retain) {
 
 bool sendBool(const String topic, const bool on, const bool retain) {
 #if MQTT_ENABLE
-  mqttSentCounter++;
-  return mqtt_client.publish(topic.c_str(), (on ? "on" : "off"), retain);
+  return mqttPublish(topic, on ? "on" : "off", retain);
 #else  // MQTT_ENABLE
   return true;
 #endif  // MQTT_ENABLE
@@ -2876,8 +3073,7 @@ bool sendBool(const String topic, const bool on, const bool retain) {
 
 bool sendString(const String topic, const String str, const bool retain) {
 #if MQTT_ENABLE
-  mqttSentCounter++;
-  return mqtt_client.publish(topic.c_str(), str.c_str(), retain);
+  return mqttPublish(topic, str, retain);
 #else  // MQTT_ENABLE
   return true;
 #endif  // MQTT_ENABLE
@@ -2885,8 +3081,7 @@ bool sendString(const String topic, const String str, const bool retain) {
 
 bool sendFloat(const String topic, const float_t temp, const bool retain) {
 #if MQTT_ENABLE
-  mqttSentCounter++;
-  return mqtt_client.publish(topic.c_str(), String(temp, 1).c_str(), retain);
+  return mqttPublish(topic, String(temp, 1), retain);
 #else  // MQTT_ENABLE
   return true;
 #endif  // MQTT_ENABLE
@@ -3042,3 +3237,34 @@ bool sendClimate(const commonAcState_t prev, const commonAcState_t next,
   }
   return success;
 }
+
+// Accept a new desired climate state, but don't transmit it yet. The settle
+// window (kClimateSettleMs) is (re)started instead, so a burst of rapid
+// updates (e.g. a scene changing mode, temp & fan in three messages)
+// coalesces into transmitting just the final state, once, from loop().
+//
+// Args:
+//   next: The climate state we (now) want.
+void queueClimate(const commonAcState_t next) {
+  climate_pending = next;
+  hasPendingClimate = true;
+  climateSettleTimer.reset();
+  if (kClimateSettleMs == 0) flushClimate(true);  // Coalescing is disabled.
+}
+
+// Transmit any pending climate state once its settle window has expired.
+// Called every pass of loop().
+//
+// Args:
+//   force: Send a pending state right now, ignoring the settle window.
+void flushClimate(const bool force) {
+  if (!hasPendingClimate) return;
+  if (!force && climateSettleTimer.elapsed() < kClimateSettleMs) return;
+  hasPendingClimate = false;
+#if MQTT_ENABLE
+  sendClimate(climate, climate_pending, MqttClimateStat, true, false, false);
+#else  // MQTT_ENABLE
+  sendClimate(climate, climate_pending, "", false, false, false);
+#endif  // MQTT_ENABLE
+  climate = climate_pending;
+}
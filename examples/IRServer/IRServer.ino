@@ -5,6 +5,9 @@
  *
  * An IR LED circuit *MUST* be connected to the ESP8266 on a pin
  * as specified by kIrLed below.
+ * An IR detector/demodulator may optionally be connected to kRecvPin;
+ * the last message it captures is served at "/capture" as a streamed
+ * (chunked) IRrecvDumpV2-style text dump.
  *
  * TL;DR: The IR LED needs to be driven by a transistor for a good result.
  *
@@ -33,7 +36,9 @@
 #include <ESP8266WebServer.h>
 #include <ESP8266mDNS.h>
 #include <IRremoteESP8266.h>
+#include <IRrecv.h>
 #include <IRsend.h>
+#include <IRutils.h>
 #include <WiFiClient.h>
 
 const char* kSsid = ".....";
@@ -43,8 +48,30 @@ MDNSResponder mdns;
 ESP8266WebServer server(80);
 
 const uint16_t kIrLed = 4;  // ESP8266 GPIO pin to use. Recommended: 4 (D2).
+const uint16_t kRecvPin = 14;  // ESP8266 GPIO pin for the IR detector. (D5)
+const uint16_t kCaptureBufferSize = 1024;  // Big enough for A/C messages.
+const uint8_t kTimeout = 50;  // Milli-Seconds of no-more-data per message.
 
 IRsend irsend(kIrLed);  // Set the GPIO to be used to sending the message.
+IRrecv irrecv(kRecvPin, kCaptureBufferSize, kTimeout, true);
+decode_results results;  // The last capture, served up by handleCapture().
+bool haveCapture = false;  // Have we captured anything yet?
+
+// A tiny Print target that forwards everything written to it into the
+// web server's (chunked) HTTP response body. Lets the streaming dump
+// routines in IRutils write straight to the client, so serving even a
+// huge capture costs no more RAM than their small internal buffer.
+class ChunkedPrint : public Print {
+ public:
+  explicit ChunkedPrint(ESP8266WebServer *server) : _server(server) {}
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    _server->sendContent_P(reinterpret_cast<const char*>(buffer), size);
+    return size;
+  }
+ private:
+  ESP8266WebServer *_server;
+};
 
 void handleRoot() {
   server.send(200, "text/html",
@@ -56,6 +83,7 @@ void handleRoot() {
                   "<p><a href=\"ir?code=16769055\">Send 0xFFE01F</a></p>" \
                   "<p><a href=\"ir?code=16429347\">Send 0xFAB123</a></p>" \
                   "<p><a href=\"ir?code=16771222\">Send 0xFFE896</a></p>" \
+                  "<p><a href=\"capture\">Dump the last IR capture</a></p>" \
                 "</body>" \
               "</html>");
 }
@@ -72,6 +100,22 @@ void handleIr() {
   handleRoot();
 }
 
+// Serve the last capture as IRrecvDumpV2-style text, streamed to the client
+// in chunks. The body is never assembled in RAM, so a 500+ entry capture
+// can be served even under memory pressure.
+void handleCapture() {
+  if (!haveCapture) {
+    server.send(200, "text/plain", "No IR message captured yet.\n");
+    return;
+  }
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);  // i.e. Chunked response.
+  server.send(200, "text/plain", "");
+  ChunkedPrint out(&server);
+  resultToSourceCode(&out, &results);
+  resultToTimingInfo(&out, &results);
+  server.sendContent("");  // Terminate the chunked response.
+}
+
 void handleNotFound() {
   String message = "File Not Found\n\n";
   message += "URI: ";
@@ -88,6 +132,7 @@ void handleNotFound() {
 
 void setup(void) {
   irsend.begin();
+  irrecv.enableIRIn();  // Start up the IR receiver.
 
   Serial.begin(115200);
   WiFi.begin(kSsid, kPassword);
@@ -110,6 +155,7 @@ void setup(void) {
 
   server.on("/", handleRoot);
   server.on("/ir", handleIr);
+  server.on("/capture", handleCapture);
 
   server.on("/inline", [](){
     server.send(200, "text/plain", "this works as well");
@@ -122,5 +168,6 @@ void setup(void) {
 }
 
 void loop(void) {
+  if (irrecv.decode(&results)) haveCapture = true;  // Keep the last capture.
   server.handleClient();
 }
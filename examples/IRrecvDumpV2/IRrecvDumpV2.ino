@@ -9,6 +9,9 @@
  *  https://github.com/markszabo/IRremoteESP8266/wiki#ir-receiving
  *
  * Changes:
+ *   Version 0.5 February, 2019
+ *     - Non-blocking dumps: output is formatted into a RAM ring buffer and
+ *       drained as the UART empties, so capture stays live during dumps.
  *   Version 0.4 July, 2018
  *     - Minor improvements and more A/C unit support.
  *   Version 0.3 November, 2017
@@ -111,6 +114,12 @@ const uint8_t kTimeout = 15;
 // from your device. (e.g. Other IR remotes work.)
 // NOTE: Set this value very high to effectively turn off UNKNOWN detection.
 const uint16_t kMinUnknownSize = 12;
+
+// Size (in bytes) of the RAM ring buffer the dumps are formatted into.
+// A full dump of a large A/C capture (timing info + source code) can run to
+// several KB of text. If a dump doesn't fit, the output is truncated and a
+// warning printed, but capture is unaffected.
+const uint16_t kDumpBufferSize = 8192;
 // ==================== end of TUNEABLE PARAMETERS ====================
 
 // Use turn on the save buffer feature for more complete capture coverage.
@@ -118,6 +127,49 @@ IRrecv irrecv(kRecvPin, kCaptureBufferSize, kTimeout, true);
 
 decode_results results;  // Somewhere to store the results
 
+// A Print sink backed by a RAM ring buffer.
+// The dump formatters write into this instantly, then loop() drains it out
+// the UART a few bytes at a time as the hardware FIFO empties. That way a
+// multi-KB dump never blocks loop(), & the receiver stays live to catch a
+// remote's follow-up frames. e.g. Multi-frame A/C protocols.
+class RingPrint : public Print {
+ public:
+  RingPrint() : _head(0), _tail(0), _truncated(false) {}
+
+  size_t write(uint8_t data) {
+    uint16_t next = (_head + 1) % kDumpBufferSize;
+    if (next == _tail) {  // Full. Drop the byte, but note the truncation.
+      _truncated = true;
+      return 1;  // Claim success so the formatters don't stall or retry.
+    }
+    _buffer[_head] = data;
+    _head = next;
+    return 1;
+  }
+
+  // Write as much pending output as the UART will accept without blocking.
+  void drain(void) {
+    while (_tail != _head && Serial.availableForWrite() > 0) {
+      Serial.write(_buffer[_tail]);
+      _tail = (_tail + 1) % kDumpBufferSize;
+    }
+    if (_truncated && _tail == _head) {  // Drained. Safe to print directly.
+      Serial.println(
+          "WARNING: Dump too big for buffer. Output was truncated. "
+          "Edit & increase kDumpBufferSize.");
+      _truncated = false;
+    }
+  }
+
+ private:
+  uint8_t _buffer[kDumpBufferSize];
+  uint16_t _head;  // Next byte is written here.
+  uint16_t _tail;  // Next byte leaves from here.
+  bool _truncated;  // Did a dump overrun the ring?
+};
+
+RingPrint dump_output;  // Where the dumps are formatted into.
+
 // Display the human readable state of an A/C message if we can.
 void dumpACInfo(decode_results *results) {
   String description = "";
@@ -275,7 +327,7 @@ void dumpACInfo(decode_results *results) {
   }
 #endif  // DECODE_TCL112AC
   // If we got a human-readable description of the message, display it.
-  if (description != "") Serial.println("Mesg Desc.: " + description);
+  if (description != "") dump_output.println("Mesg Desc.: " + description);
 }
 
 // The section of code run only once at start-up.
@@ -297,34 +349,43 @@ void setup() {
 // The repeating section of the code
 //
 void loop() {
+  // Push any pending dump output out the UART, without blocking.
+  dump_output.drain();
+
   // Check if the IR code has been received.
   if (irrecv.decode(&results)) {
+    // All of the output below is formatted into the RAM ring buffer, which
+    // is fast, & drained by the drain() call above over the next passes
+    // through loop(). i.e. Capture continues while the dump prints.
     // Display a crude timestamp.
     uint32_t now = millis();
-    Serial.printf("Timestamp : %06u.%03u\n", now / 1000, now % 1000);
+    dump_output.printf("Timestamp : %06u.%03u\n", now / 1000, now % 1000);
     if (results.overflow)
-      Serial.printf(
+      dump_output.printf(
           "WARNING: IR code is too big for buffer (>= %d). "
           "This result shouldn't be trusted until this is resolved. "
           "Edit & increase kCaptureBufferSize.\n",
           kCaptureBufferSize);
     // Display the basic output of what we found.
-    Serial.print(resultToHumanReadableBasic(&results));
+    dump_output.print(resultToHumanReadableBasic(&results));
     dumpACInfo(&results);  // Display any extra A/C info if we have it.
-    yield();  // Feed the WDT as the text output can take a while to print.
+    yield();  // Feed the WDT as the text formatting can take a while.
 
     // Display the library version the message was captured with.
-    Serial.print("Library   : v");
-    Serial.println(_IRREMOTEESP8266_VERSION_);
-    Serial.println();
+    dump_output.print("Library   : v");
+    dump_output.println(_IRREMOTEESP8266_VERSION_);
+    dump_output.println();
 
     // Output RAW timing info of the result.
-    Serial.println(resultToTimingInfo(&results));
+    // Streamed straight into the ring, so even very large captures can't
+    // exhaust the heap.
+    resultToTimingInfo(&dump_output, &results);
+    dump_output.println();
     yield();  // Feed the WDT (again)
 
     // Output the results as source code
-    Serial.println(resultToSourceCode(&results));
-    Serial.println("");  // Blank line between entries
-    yield();             // Feed the WDT (again)
+    resultToSourceCode(&dump_output, &results);
+    dump_output.println();  // Blank line between entries
+    yield();                // Feed the WDT (again)
   }
 }
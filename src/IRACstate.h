@@ -0,0 +1,144 @@
+// Copyright 2019 David Conran
+
+#ifndef IRACSTATE_H_
+#define IRACSTATE_H_
+
+#define __STDC_LIMIT_MACROS
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+
+// A small template base for the byte-array based A/C protocol classes.
+// (i.e. Most of the ir_*.h vendor classes.)
+//
+// It owns the remote_state[] array & the dirty flag used to skip redundant
+// checksum recomputation, and provides the byte/bit manipulation helpers
+// the vendor classes otherwise each re-implement. Centralising the hot
+// byte-twiddling here keeps the per-vendor code down to just protocol
+// knowledge, which matters as the library is close to the ESP8266's 1MB
+// OTA flash limit.
+//
+// Vendor classes inherit like so:
+//   class IRFooAC : public IRACState<kFooStateLength> { ... };
+// and then drop their own remote_state[]/_dirty declarations. Existing
+// direct remote_state[] accesses keep working; new code should prefer the
+// helpers, as they keep the dirty flag accurate for free.
+//
+// Protocols whose state is split into several independently checksummed
+// sections can supply the (uniform) section size as the second template
+// argument. Dirtiness is then tracked per section, so the vendor checksum()
+// only has to recompute the sums of the sections that actually changed.
+template <uint16_t kStateLength, uint16_t kSectionLength = kStateLength>
+class IRACState {
+ protected:
+  // The state of the IR remote in IR code form.
+  uint8_t remote_state[kStateLength];
+  // Bitmask of the sections changed since the checksum(s) were last
+  // calculated. Bit N covers bytes [N * kSectionLength, N+1 * kSectionLength).
+  uint8_t _dirty;
+
+  // Mark the section containing the given state byte as changed.
+  void markDirty(const uint16_t index) {
+    _dirty |= 1 << (index / kSectionLength);
+  }
+
+  // Mark every section as changed.
+  void markAllDirty(void) { _dirty = (uint8_t)~0; }
+
+  // Set or clear the bits of `mask` in the given state byte & mark the
+  // state dirty.
+  //
+  // Args:
+  //   index: Which byte of remote_state[] to modify.
+  //   mask: The bit(s) to set or clear.
+  //   on: true to set the bits, false to clear them.
+  void setBitMask(const uint16_t index, const uint8_t mask, const bool on) {
+    if (on)
+      remote_state[index] |= mask;
+    else
+      remote_state[index] &= ~mask;
+    markDirty(index);
+  }
+
+  // Are any of the bits of `mask` set in the given state byte?
+  bool getBitMask(const uint16_t index, const uint8_t mask) const {
+    return remote_state[index] & mask;
+  }
+
+  // Replace the entire state with the supplied code & mark it dirty.
+  //
+  // Args:
+  //   new_code: Array of (at least) kStateLength bytes to copy in.
+  void copyState(const uint8_t new_code[]) {
+    memcpy(remote_state, new_code, kStateLength);  // Word-at-a-time copy.
+    markAllDirty();
+  }
+
+  // As copyState(), but reading the template from PROGMEM (flash), so a
+  // class's known-good default frame can live as data instead of a run of
+  // compiled byte assignments. (Outside the Arduino framework PROGMEM is
+  // plain memory & this collapses to copyState().)
+  void copyState_P(const uint8_t new_code[]) {
+#if defined(ESP8266) || defined(ESP32)
+    memcpy_P(remote_state, new_code, kStateLength);
+#else
+    memcpy(remote_state, new_code, kStateLength);
+#endif
+    markAllDirty();
+  }
+
+  // Zero the entire state & mark it dirty. The usual start of the vendor
+  // stateReset() methods.
+  void zeroState(void) {
+    memset(remote_state, 0, kStateLength);
+    markAllDirty();
+  }
+
+  // Clamp a temperature (or any other setting) into the given range.
+  //
+  // Args:
+  //   value: The requested setting.
+  //   min: The lowest value the protocol can represent.
+  //   max: The highest value the protocol can represent.
+  // Returns:
+  //   The value, limited to [min, max].
+  static uint8_t clampValue(const uint8_t value, const uint8_t min,
+                            const uint8_t max) {
+    return std::min(max, std::max(min, value));
+  }
+};
+
+// A companion base for the A/C classes whose state packs into uint64_t
+// word(s) rather than a byte array. (e.g. Vestel) It owns only the dirty
+// flag; the vendor class keeps its own word(s) & threads them through the
+// helpers, which keep the flag accurate so checksum() can skip
+// recalculating when nothing has changed.
+class IRAC64State {
+ protected:
+  bool _dirty;  // Has any state word changed since checksum() last ran?
+
+  // Set `nbits` bits starting at `offset` of `*state` to `data` & mark the
+  // state dirty.
+  void setStateBits(uint64_t *state, const uint8_t offset, const uint8_t nbits,
+                    const uint64_t data) {
+    uint64_t mask = ((((uint64_t)1 << nbits) - 1)) << offset;
+    *state = (*state & ~mask) | ((data << offset) & mask);
+    _dirty = true;
+  }
+
+  // Set or clear the bit at `offset` of `*state` & mark the state dirty.
+  void setStateBit(uint64_t *state, const uint8_t offset, const bool on) {
+    if (on)
+      *state |= ((uint64_t)1 << offset);
+    else
+      *state &= ~((uint64_t)1 << offset);
+    _dirty = true;
+  }
+
+  // Replace a whole state word & mark the state dirty.
+  void setState(uint64_t *state, const uint64_t data) {
+    *state = data;
+    _dirty = true;
+  }
+};
+#endif  // IRACSTATE_H_
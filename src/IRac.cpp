@@ -19,6 +19,7 @@
 #include "ir_Coolix.h"
 #include "ir_Daikin.h"
 #include "ir_Fujitsu.h"
+#include "ir_Gree.h"
 #include "ir_Haier.h"
 #include "ir_Hitachi.h"
 #include "ir_Kelvinator.h"
@@ -35,7 +36,16 @@
 #include "ir_Vestel.h"
 #include "ir_Whirlpool.h"
 
-IRac::IRac(uint8_t pin) { _pin = pin; }
+IRac::IRac(uint8_t pin) {
+  _pin = pin;
+  // No protocol object is constructed until sendAc() needs one.
+  _acobj = NULL;
+  _acobj_type = decode_type_t::UNKNOWN;
+  _sent = false;  // Nothing has been transmitted yet.
+}
+
+// Class destructor.
+IRac::~IRac(void) { deleteAcObj(); }
 
 // Is the given protocol supported by the IRac class?
 bool IRac::isProtocolSupported(const decode_type_t protocol) {
@@ -116,6 +126,168 @@ bool IRac::isProtocolSupported(const decode_type_t protocol) {
   }
 }
 
+// Mode bitmask helpers for the capability table. Bit n of `modes` is
+// (1 << (int)stdAc::opmode_t) for each mode at or above kAuto.
+const uint8_t kAcModesAll = 0b11111;     // Auto, Cool, Heat, Dry & Fan.
+const uint8_t kAcModesNoFan = 0b01111;   // No dedicated Fan-only mode.
+const uint8_t kAcModesNoHeat = 0b11011;  // Cooling-only units.
+
+// One entry per supported protocol, terminated by an UNKNOWN sentinel.
+// Derived from what each vendor helper in this file actually sets on its
+// protocol object. The bool columns are, in order:
+//   swingv, swingh, quiet, turbo, econo, light, filter, clean, beep, sleep,
+//   clock.
+static const acCapability_t kAcCapabilities[] = {
+#if SEND_ARGO
+    {decode_type_t::ARGO, kArgoMinTemp, kArgoMaxTemp, kAcModesNoFan,
+     true, false, false, true, false, false, false, false, false, true,
+     false},
+#endif  // SEND_ARGO
+#if SEND_COOLIX
+    {decode_type_t::COOLIX, kCoolixTempMin, kCoolixTempMax, kAcModesAll,
+     true, false, false, true, false, true, false, true, false, true, false},
+#endif  // SEND_COOLIX
+#if SEND_DAIKIN
+    {decode_type_t::DAIKIN, kDaikinMinTemp, kDaikinMaxTemp, kAcModesAll,
+     true, true, true, true, true, false, false, true, false, false, false},
+#endif  // SEND_DAIKIN
+#if SEND_DAIKIN2
+    {decode_type_t::DAIKIN2, kDaikinMinTemp, kDaikinMaxTemp, kAcModesAll,
+     true, true, true, true, true, true, true, true, true, true, true},
+#endif  // SEND_DAIKIN2
+#if SEND_DAIKIN216
+    {decode_type_t::DAIKIN216, kDaikinMinTemp, kDaikinMaxTemp, kAcModesAll,
+     true, true, true, true, false, false, false, false, false, false,
+     false},
+#endif  // SEND_DAIKIN216
+#if SEND_FUJITSU_AC
+    {decode_type_t::FUJITSU_AC, kFujitsuAcMinTemp, kFujitsuAcMaxTemp,
+     kAcModesAll,
+     true, true, true, false, false, false, false, false, false, false,
+     false},
+#endif  // SEND_FUJITSU_AC
+#if SEND_GREE
+    {decode_type_t::GREE, kGreeMinTemp, kGreeMaxTemp, kAcModesAll,
+     true, false, false, true, false, true, false, true, false, true, false},
+#endif  // SEND_GREE
+#if SEND_HAIER_AC
+    {decode_type_t::HAIER_AC, kHaierAcMinTemp, kHaierAcMaxTemp, kAcModesAll,
+     true, false, false, false, false, false, true, false, false, true,
+     true},
+#endif  // SEND_HAIER_AC
+#if SEND_HAIER_AC_YRW02
+    {decode_type_t::HAIER_AC_YRW02, kHaierAcMinTemp, kHaierAcMaxTemp,
+     kAcModesAll,
+     true, false, false, true, false, false, true, false, false, true,
+     false},
+#endif  // SEND_HAIER_AC_YRW02
+#if SEND_HITACHI_AC
+    {decode_type_t::HITACHI_AC, kHitachiAcMinTemp, kHitachiAcMaxTemp,
+     kAcModesAll,
+     true, true, false, false, false, false, false, false, false, false,
+     false},
+#endif  // SEND_HITACHI_AC
+#if SEND_KELVINATOR
+    {decode_type_t::KELVINATOR, kKelvinatorMinTemp, kKelvinatorMaxTemp,
+     kAcModesAll,
+     true, true, true, true, false, true, true, true, false, false, false},
+#endif  // SEND_KELVINATOR
+#if SEND_MIDEA
+    {decode_type_t::MIDEA, kMideaACMinTempC, kMideaACMaxTempC, kAcModesAll,
+     false, false, false, false, false, false, false, false, false, true,
+     false},
+#endif  // SEND_MIDEA
+#if SEND_MITSUBISHI_AC
+    {decode_type_t::MITSUBISHI_AC, kMitsubishiAcMinTemp, kMitsubishiAcMaxTemp,
+     kAcModesNoFan,
+     true, false, true, false, false, false, false, false, false, false,
+     true},
+#endif  // SEND_MITSUBISHI_AC
+#if SEND_MITSUBISHIHEAVY
+    {decode_type_t::MITSUBISHI_HEAVY_88, kMitsubishiHeavyMinTemp,
+     kMitsubishiHeavyMaxTemp, kAcModesAll,
+     true, true, false, true, true, false, false, true, false, false,
+     false},
+    {decode_type_t::MITSUBISHI_HEAVY_152, kMitsubishiHeavyMinTemp,
+     kMitsubishiHeavyMaxTemp, kAcModesAll,
+     true, true, true, true, true, false, true, true, false, true, false},
+#endif  // SEND_MITSUBISHIHEAVY
+#if SEND_PANASONIC_AC
+    {decode_type_t::PANASONIC_AC, kPanasonicAcMinTemp, kPanasonicAcMaxTemp,
+     kAcModesAll,
+     true, true, true, true, false, false, false, false, false, false,
+     true},
+#endif  // SEND_PANASONIC_AC
+#if SEND_SAMSUNG_AC
+    {decode_type_t::SAMSUNG_AC, kSamsungAcMinTemp, kSamsungAcMaxTemp,
+     kAcModesAll,
+     true, false, true, true, false, false, false, true, true, false,
+     false},
+#endif  // SEND_SAMSUNG_AC
+#if SEND_SHARP_AC
+    {decode_type_t::SHARP_AC, kSharpAcMinTemp, kSharpAcMaxTemp, kAcModesNoFan,
+     false, false, false, false, false, false, false, false, false, false,
+     false},
+#endif  // SEND_SHARP_AC
+#if SEND_TCL112AC
+    // Note: TCL112 does half degrees; the whole-degree bounds are reported.
+    {decode_type_t::TCL112AC, (uint8_t)kTcl112AcTempMin,
+     (uint8_t)kTcl112AcTempMax, kAcModesAll,
+     true, true, false, true, true, true, true, false, false, false, false},
+#endif  // SEND_TCL112AC
+#if SEND_TECO
+    {decode_type_t::TECO, kTecoMinTemp, kTecoMaxTemp, kAcModesAll,
+     true, false, false, false, false, false, false, false, false, true,
+     false},
+#endif  // SEND_TECO
+#if SEND_TOSHIBA_AC
+    {decode_type_t::TOSHIBA_AC, kToshibaAcMinTemp, kToshibaAcMaxTemp,
+     kAcModesNoFan,
+     false, false, false, false, false, false, false, false, false, false,
+     false},
+#endif  // SEND_TOSHIBA_AC
+#if SEND_TROTEC
+    {decode_type_t::TROTEC, kTrotecMinTemp, kTrotecMaxTemp, kAcModesNoHeat,
+     false, false, false, false, false, false, false, false, false, true,
+     false},
+#endif  // SEND_TROTEC
+#if SEND_VESTEL_AC
+    {decode_type_t::VESTEL_AC, kVestelAcMinTempC, kVestelAcMaxTemp,
+     kAcModesAll,
+     true, false, false, true, false, false, true, false, false, true,
+     true},
+#endif  // SEND_VESTEL_AC
+#if SEND_WHIRLPOOL_AC
+    {decode_type_t::WHIRLPOOL_AC, kWhirlpoolAcMinTemp, kWhirlpoolAcMaxTemp,
+     kAcModesAll,
+     true, false, false, true, false, true, false, false, false, true,
+     true},
+#endif  // SEND_WHIRLPOOL_AC
+    // Sentinel. Keeps the table non-empty if nothing above is compiled in.
+    {decode_type_t::UNKNOWN, 0, 0, 0,
+     false, false, false, false, false, false, false, false, false, false,
+     false},
+};
+
+// Fill in the capability descriptor for the given protocol.
+// Args:
+//   protocol: The vendor/protocol type to look up.
+//   result: Ptr to the struct to copy the capabilities into. May be NULL if
+//           only the supported/unsupported answer is wanted.
+// Returns:
+//   A boolean. true if the protocol is supported by this class.
+bool IRac::capabilities(const decode_type_t protocol,
+                        acCapability_t *result) {
+  for (uint16_t i = 0; kAcCapabilities[i].protocol != decode_type_t::UNKNOWN;
+       i++) {
+    if (kAcCapabilities[i].protocol == protocol) {
+      if (result != NULL) *result = kAcCapabilities[i];
+      return true;
+    }
+  }
+  return false;
+}
+
 #if SEND_ARGO
 void IRac::argo(IRArgoAC *ac,
                 const bool on, const stdAc::opmode_t mode, const float degrees,
@@ -747,6 +919,158 @@ void IRac::whirlpool(IRWhirlpoolAc *ac, const whirlpool_ac_remote_model_t model,
 }
 #endif  // SEND_WHIRLPOOL_AC
 
+// Get the protocol object for the given vendor, reusing the one kept from
+// an earlier sendAc() call when it matches. Switching vendors releases the
+// old object & lazily constructs the new one, so only one protocol object
+// is ever held, no matter how many protocols are compiled in.
+//
+// Args:
+//   vendor: The protocol the caller is about to use.
+// Returns:
+//   A ready-to-use (begin() called) protocol object of class T.
+template <class T>
+T *IRac::acObj(const decode_type_t vendor) {
+  if (_acobj != NULL && _acobj_type == vendor)
+    return reinterpret_cast<T *>(_acobj);
+  deleteAcObj();
+  T *ac = new T(_pin);
+  ac->begin();
+  _acobj = ac;
+  _acobj_type = vendor;
+  return ac;
+}
+
+// Destroy the kept protocol object, if any. The object has to be deleted
+// as its real class so the right destructor runs. e.g. to free an IRsend
+// queue or cache.
+void IRac::deleteAcObj(void) {
+  if (_acobj == NULL) return;
+  switch (_acobj_type) {
+#if SEND_ARGO
+    case ARGO:
+      delete reinterpret_cast<IRArgoAC *>(_acobj);
+      break;
+#endif  // SEND_ARGO
+#if SEND_COOLIX
+    case COOLIX:
+      delete reinterpret_cast<IRCoolixAC *>(_acobj);
+      break;
+#endif  // SEND_COOLIX
+#if SEND_DAIKIN
+    case DAIKIN:
+      delete reinterpret_cast<IRDaikinESP *>(_acobj);
+      break;
+#endif  // SEND_DAIKIN
+#if SEND_DAIKIN2
+    case DAIKIN2:
+      delete reinterpret_cast<IRDaikin2 *>(_acobj);
+      break;
+#endif  // SEND_DAIKIN2
+#if SEND_DAIKIN216
+    case DAIKIN216:
+      delete reinterpret_cast<IRDaikin216 *>(_acobj);
+      break;
+#endif  // SEND_DAIKIN216
+#if SEND_FUJITSU_AC
+    case FUJITSU_AC:
+      delete reinterpret_cast<IRFujitsuAC *>(_acobj);
+      break;
+#endif  // SEND_FUJITSU_AC
+#if SEND_GREE
+    case GREE:
+      delete reinterpret_cast<IRGreeAC *>(_acobj);
+      break;
+#endif  // SEND_GREE
+#if SEND_HAIER_AC
+    case HAIER_AC:
+      delete reinterpret_cast<IRHaierAC *>(_acobj);
+      break;
+#endif  // SEND_HAIER_AC
+#if SEND_HAIER_AC_YRW02
+    case HAIER_AC_YRW02:
+      delete reinterpret_cast<IRHaierACYRW02 *>(_acobj);
+      break;
+#endif  // SEND_HAIER_AC_YRW02
+#if SEND_HITACHI_AC
+    case HITACHI_AC:
+      delete reinterpret_cast<IRHitachiAc *>(_acobj);
+      break;
+#endif  // SEND_HITACHI_AC
+#if SEND_KELVINATOR
+    case KELVINATOR:
+      delete reinterpret_cast<IRKelvinatorAC *>(_acobj);
+      break;
+#endif  // SEND_KELVINATOR
+#if SEND_MIDEA
+    case MIDEA:
+      delete reinterpret_cast<IRMideaAC *>(_acobj);
+      break;
+#endif  // SEND_MIDEA
+#if SEND_MITSUBISHI_AC
+    case MITSUBISHI_AC:
+      delete reinterpret_cast<IRMitsubishiAC *>(_acobj);
+      break;
+#endif  // SEND_MITSUBISHI_AC
+#if SEND_MITSUBISHIHEAVY
+    case MITSUBISHI_HEAVY_88:
+      delete reinterpret_cast<IRMitsubishiHeavy88Ac *>(_acobj);
+      break;
+    case MITSUBISHI_HEAVY_152:
+      delete reinterpret_cast<IRMitsubishiHeavy152Ac *>(_acobj);
+      break;
+#endif  // SEND_MITSUBISHIHEAVY
+#if SEND_PANASONIC_AC
+    case PANASONIC_AC:
+      delete reinterpret_cast<IRPanasonicAc *>(_acobj);
+      break;
+#endif  // SEND_PANASONIC_AC
+#if SEND_SAMSUNG_AC
+    case SAMSUNG_AC:
+      delete reinterpret_cast<IRSamsungAc *>(_acobj);
+      break;
+#endif  // SEND_SAMSUNG_AC
+#if SEND_SHARP_AC
+    case SHARP_AC:
+      delete reinterpret_cast<IRSharpAc *>(_acobj);
+      break;
+#endif  // SEND_SHARP_AC
+#if SEND_TCL112AC
+    case TCL112AC:
+      delete reinterpret_cast<IRTcl112Ac *>(_acobj);
+      break;
+#endif  // SEND_TCL112AC
+#if SEND_TECO
+    case TECO:
+      delete reinterpret_cast<IRTecoAc *>(_acobj);
+      break;
+#endif  // SEND_TECO
+#if SEND_TOSHIBA_AC
+    case TOSHIBA_AC:
+      delete reinterpret_cast<IRToshibaAC *>(_acobj);
+      break;
+#endif  // SEND_TOSHIBA_AC
+#if SEND_TROTEC
+    case TROTEC:
+      delete reinterpret_cast<IRTrotecESP *>(_acobj);
+      break;
+#endif  // SEND_TROTEC
+#if SEND_VESTEL_AC
+    case VESTEL_AC:
+      delete reinterpret_cast<IRVestelAc *>(_acobj);
+      break;
+#endif  // SEND_VESTEL_AC
+#if SEND_WHIRLPOOL_AC
+    case WHIRLPOOL_AC:
+      delete reinterpret_cast<IRWhirlpoolAc *>(_acobj);
+      break;
+#endif  // SEND_WHIRLPOOL_AC
+    default:
+      break;  // Shouldn't happen. Leak rather than corrupt the heap.
+  }
+  _acobj = NULL;
+  _acobj_type = decode_type_t::UNKNOWN;
+}
+
 // Send A/C message for a given device using common A/C settings.
 // Args:
 //   vendor:  The type of A/C protocol to use.
@@ -792,16 +1116,16 @@ bool IRac::sendAc(const decode_type_t vendor, const int16_t model,
 #if SEND_ARGO
     case ARGO:
     {
-      IRArgoAC ac(_pin);
-      argo(&ac, on, mode, degC, fan, swingv, turbo, sleep);
+      IRArgoAC *ac = acObj<IRArgoAC>(vendor);
+      argo(ac, on, mode, degC, fan, swingv, turbo, sleep);
       break;
     }
 #endif  // SEND_DAIKIN
 #if SEND_COOLIX
     case COOLIX:
     {
-      IRCoolixAC ac(_pin);
-      coolix(&ac, on, mode, degC, fan, swingv, swingh,
+      IRCoolixAC *ac = acObj<IRCoolixAC>(vendor);
+      coolix(ac, on, mode, degC, fan, swingv, swingh,
              quiet, turbo, econo, clean);
       break;
     }
@@ -809,8 +1133,8 @@ bool IRac::sendAc(const decode_type_t vendor, const int16_t model,
 #if SEND_DAIKIN
     case DAIKIN:
     {
-      IRDaikinESP ac(_pin);
-      daikin(&ac, on, mode, degC, fan, swingv, swingh,
+      IRDaikinESP *ac = acObj<IRDaikinESP>(vendor);
+      daikin(ac, on, mode, degC, fan, swingv, swingh,
              quiet, turbo, econo, clean);
       break;
     }
@@ -818,8 +1142,8 @@ bool IRac::sendAc(const decode_type_t vendor, const int16_t model,
 #if SEND_DAIKIN2
     case DAIKIN2:
     {
-      IRDaikin2 ac(_pin);
-      daikin2(&ac, on, mode, degC, fan, swingv, swingh, quiet, turbo,
+      IRDaikin2 *ac = acObj<IRDaikin2>(vendor);
+      daikin2(ac, on, mode, degC, fan, swingv, swingh, quiet, turbo,
               light, econo, filter, clean, beep, sleep, clock);
       break;
     }
@@ -827,17 +1151,16 @@ bool IRac::sendAc(const decode_type_t vendor, const int16_t model,
 #if SEND_DAIKIN216
     case DAIKIN216:
     {
-      IRDaikin216 ac(_pin);
-      daikin216(&ac, on, mode, degC, fan, swingv, swingh, quiet, turbo);
+      IRDaikin216 *ac = acObj<IRDaikin216>(vendor);
+      daikin216(ac, on, mode, degC, fan, swingv, swingh, quiet, turbo);
       break;
     }
 #endif  // SEND_DAIKIN216
 #if SEND_FUJITSU_AC
     case FUJITSU_AC:
     {
-      IRFujitsuAC ac(_pin);
-      ac.begin();
-      fujitsu(&ac, (fujitsu_ac_remote_model_t)model, on, mode, degC, fan,
+      IRFujitsuAC *ac = acObj<IRFujitsuAC>(vendor);
+      fujitsu(ac, (fujitsu_ac_remote_model_t)model, on, mode, degC, fan,
               swingv, swingh, quiet);
       break;
     }
@@ -845,45 +1168,40 @@ bool IRac::sendAc(const decode_type_t vendor, const int16_t model,
 #if SEND_GREE
     case GREE:
     {
-      IRGreeAC ac(_pin);
-      ac.begin();
-      gree(&ac, on, mode, degC, fan, swingv, light, turbo, clean, sleep);
+      IRGreeAC *ac = acObj<IRGreeAC>(vendor);
+      gree(ac, on, mode, degC, fan, swingv, light, turbo, clean, sleep);
       break;
     }
 #endif  // SEND_GREE
 #if SEND_HAIER_AC
     case HAIER_AC:
     {
-      IRHaierAC ac(_pin);
-      ac.begin();
-      haier(&ac, on, mode, degC, fan, swingv, filter, sleep, clock);
+      IRHaierAC *ac = acObj<IRHaierAC>(vendor);
+      haier(ac, on, mode, degC, fan, swingv, filter, sleep, clock);
       break;
     }
 #endif  // SEND_HAIER_AC
 #if SEND_HAIER_AC_YRW02
     case HAIER_AC_YRW02:
     {
-      IRHaierACYRW02 ac(_pin);
-      ac.begin();
-      haierYrwo2(&ac, on, mode, degC, fan, swingv, turbo, filter, sleep);
+      IRHaierACYRW02 *ac = acObj<IRHaierACYRW02>(vendor);
+      haierYrwo2(ac, on, mode, degC, fan, swingv, turbo, filter, sleep);
       break;
     }
 #endif  // SEND_HAIER_AC_YRW02
 #if SEND_HITACHI_AC
     case HITACHI_AC:
     {
-      IRHitachiAc ac(_pin);
-      ac.begin();
-      hitachi(&ac, on, mode, degC, fan, swingv, swingh);
+      IRHitachiAc *ac = acObj<IRHitachiAc>(vendor);
+      hitachi(ac, on, mode, degC, fan, swingv, swingh);
       break;
     }
 #endif  // SEND_HITACHI_AC
 #if SEND_KELVINATOR
     case KELVINATOR:
     {
-      IRKelvinatorAC ac(_pin);
-      ac.begin();
-      kelvinator(&ac, on, mode, degC, fan, swingv, swingh, quiet, turbo,
+      IRKelvinatorAC *ac = acObj<IRKelvinatorAC>(vendor);
+      kelvinator(ac, on, mode, degC, fan, swingv, swingh, quiet, turbo,
                  light, filter, clean);
       break;
     }
@@ -891,35 +1209,31 @@ bool IRac::sendAc(const decode_type_t vendor, const int16_t model,
 #if SEND_MIDEA
     case MIDEA:
     {
-      IRMideaAC ac(_pin);
-      ac.begin();
-      midea(&ac, on, mode, degC, fan, sleep);
+      IRMideaAC *ac = acObj<IRMideaAC>(vendor);
+      midea(ac, on, mode, degC, fan, sleep);
       break;
     }
 #endif  // SEND_MIDEA
 #if SEND_MITSUBISHI_AC
     case MITSUBISHI_AC:
     {
-      IRMitsubishiAC ac(_pin);
-      ac.begin();
-      mitsubishi(&ac, on, mode, degC, fan, swingv, quiet, clock);
+      IRMitsubishiAC *ac = acObj<IRMitsubishiAC>(vendor);
+      mitsubishi(ac, on, mode, degC, fan, swingv, quiet, clock);
       break;
     }
 #endif  // SEND_MITSUBISHI_AC
 #if SEND_MITSUBISHIHEAVY
     case MITSUBISHI_HEAVY_88:
     {
-      IRMitsubishiHeavy88Ac ac(_pin);
-      ac.begin();
-      mitsubishiHeavy88(&ac, on, mode, degC, fan, swingv, swingh,
+      IRMitsubishiHeavy88Ac *ac = acObj<IRMitsubishiHeavy88Ac>(vendor);
+      mitsubishiHeavy88(ac, on, mode, degC, fan, swingv, swingh,
                         turbo, econo, clean);
       break;
     }
     case MITSUBISHI_HEAVY_152:
     {
-      IRMitsubishiHeavy152Ac ac(_pin);
-      ac.begin();
-      mitsubishiHeavy152(&ac, on, mode, degC, fan, swingv, swingh,
+      IRMitsubishiHeavy152Ac *ac = acObj<IRMitsubishiHeavy152Ac>(vendor);
+      mitsubishiHeavy152(ac, on, mode, degC, fan, swingv, swingh,
                          quiet, turbo, econo, filter, clean, sleep);
       break;
     }
@@ -927,9 +1241,8 @@ bool IRac::sendAc(const decode_type_t vendor, const int16_t model,
 #if SEND_PANASONIC_AC
     case PANASONIC_AC:
     {
-      IRPanasonicAc ac(_pin);
-      ac.begin();
-      panasonic(&ac, (panasonic_ac_remote_model_t)model, on, mode, degC, fan,
+      IRPanasonicAc *ac = acObj<IRPanasonicAc>(vendor);
+      panasonic(ac, (panasonic_ac_remote_model_t)model, on, mode, degC, fan,
                 swingv, swingh, quiet, turbo, clock);
       break;
     }
@@ -937,27 +1250,24 @@ bool IRac::sendAc(const decode_type_t vendor, const int16_t model,
 #if SEND_SAMSUNG_AC
     case SAMSUNG_AC:
     {
-      IRSamsungAc ac(_pin);
-      ac.begin();
-      samsung(&ac, on, mode, degC, fan, swingv, quiet, turbo, clean, beep);
+      IRSamsungAc *ac = acObj<IRSamsungAc>(vendor);
+      samsung(ac, on, mode, degC, fan, swingv, quiet, turbo, clean, beep);
       break;
     }
 #endif  // SEND_SAMSUNG_AC
 #if SEND_SHARP_AC
     case SHARP_AC:
     {
-      IRSharpAc ac(_pin);
-      ac.begin();
-      sharp(&ac, on, mode, degC, fan);
+      IRSharpAc *ac = acObj<IRSharpAc>(vendor);
+      sharp(ac, on, mode, degC, fan);
       break;
     }
 #endif  // SEND_SHARP_AC
 #if SEND_TCL112AC
     case TCL112AC:
     {
-      IRTcl112Ac ac(_pin);
-      ac.begin();
-      tcl112(&ac, on, mode, degC, fan, swingv, swingh, turbo, light, econo,
+      IRTcl112Ac *ac = acObj<IRTcl112Ac>(vendor);
+      tcl112(ac, on, mode, degC, fan, swingv, swingh, turbo, light, econo,
              filter);
       break;
     }
@@ -965,45 +1275,40 @@ bool IRac::sendAc(const decode_type_t vendor, const int16_t model,
 #if SEND_TECO
     case TECO:
     {
-      IRTecoAc ac(_pin);
-      ac.begin();
-      teco(&ac, on, mode, degC, fan, swingv, sleep);
+      IRTecoAc *ac = acObj<IRTecoAc>(vendor);
+      teco(ac, on, mode, degC, fan, swingv, sleep);
       break;
     }
 #endif  // SEND_TECO
 #if SEND_TOSHIBA_AC
     case TOSHIBA_AC:
     {
-      IRToshibaAC ac(_pin);
-      ac.begin();
-      toshiba(&ac, on, mode, degC, fan);
+      IRToshibaAC *ac = acObj<IRToshibaAC>(vendor);
+      toshiba(ac, on, mode, degC, fan);
       break;
     }
 #endif  // SEND_TOSHIBA_AC
 #if SEND_TROTEC
     case TROTEC:
     {
-      IRTrotecESP ac(_pin);
-      ac.begin();
-      trotec(&ac, on, mode, degC, fan, sleep);
+      IRTrotecESP *ac = acObj<IRTrotecESP>(vendor);
+      trotec(ac, on, mode, degC, fan, sleep);
       break;
     }
 #endif  // SEND_TROTEC
 #if SEND_VESTEL_AC
     case VESTEL_AC:
     {
-      IRVestelAc ac(_pin);
-      ac.begin();
-      vestel(&ac, on, mode, degC, fan, swingv, turbo, filter, sleep, clock);
+      IRVestelAc *ac = acObj<IRVestelAc>(vendor);
+      vestel(ac, on, mode, degC, fan, swingv, turbo, filter, sleep, clock);
       break;
     }
 #endif  // SEND_VESTEL_AC
 #if SEND_WHIRLPOOL_AC
     case WHIRLPOOL_AC:
     {
-      IRWhirlpoolAc ac(_pin);
-      ac.begin();
-      whirlpool(&ac, (whirlpool_ac_remote_model_t)model, on, mode, degC, fan,
+      IRWhirlpoolAc *ac = acObj<IRWhirlpoolAc>(vendor);
+      whirlpool(ac, (whirlpool_ac_remote_model_t)model, on, mode, degC, fan,
                 swingv, turbo, light, sleep, clock);
       break;
     }
@@ -1011,9 +1316,97 @@ bool IRac::sendAc(const decode_type_t vendor, const int16_t model,
     default:
       return false;  // Fail, didn't match anything.
   }
+  // Remember exactly what was requested, so hasStateChanged() can spot a
+  // repeat of it later.
+  _lastsent.protocol = vendor;
+  _lastsent.model = model;
+  _lastsent.power = power;
+  _lastsent.mode = mode;
+  _lastsent.degrees = degrees;
+  _lastsent.celsius = celsius;
+  _lastsent.fanspeed = fan;
+  _lastsent.swingv = swingv;
+  _lastsent.swingh = swingh;
+  _lastsent.quiet = quiet;
+  _lastsent.turbo = turbo;
+  _lastsent.econo = econo;
+  _lastsent.light = light;
+  _lastsent.filter = filter;
+  _lastsent.clean = clean;
+  _lastsent.beep = beep;
+  _lastsent.sleep = sleep;
+  _lastsent.clock = clock;
+  _sent = true;
   return true;  // Success.
 }
 
+// Would the given settings result in a different message to the one the last
+// successful sendAc() call transmitted?
+// The arguments are compared verbatim against what the caller passed in last
+// time. i.e. An exact float compare of `degrees` is correct here; both values
+// came from the caller, not from a calculation.
+// Returns:
+//   A boolean. true if the settings differ, or if nothing has been sent yet.
+bool IRac::hasStateChanged(const decode_type_t vendor, const int16_t model,
+                           const bool power, const stdAc::opmode_t mode,
+                           const float degrees, const bool celsius,
+                           const stdAc::fanspeed_t fan,
+                           const stdAc::swingv_t swingv,
+                           const stdAc::swingh_t swingh,
+                           const bool quiet, const bool turbo,
+                           const bool econo, const bool light,
+                           const bool filter, const bool clean,
+                           const bool beep, const int16_t sleep,
+                           const int16_t clock) {
+  if (!_sent) return true;  // Nothing sent yet, so anything is a change.
+  return _lastsent.protocol != vendor ||
+         _lastsent.model != model ||
+         _lastsent.power != power ||
+         _lastsent.mode != mode ||
+         _lastsent.degrees != degrees ||
+         _lastsent.celsius != celsius ||
+         _lastsent.fanspeed != fan ||
+         _lastsent.swingv != swingv ||
+         _lastsent.swingh != swingh ||
+         _lastsent.quiet != quiet ||
+         _lastsent.turbo != turbo ||
+         _lastsent.econo != econo ||
+         _lastsent.light != light ||
+         _lastsent.filter != filter ||
+         _lastsent.clean != clean ||
+         _lastsent.beep != beep ||
+         _lastsent.sleep != sleep ||
+         _lastsent.clock != clock;
+}
+
+// As sendAc(), but skip the transmission entirely when every setting matches
+// the last successful send. A reconcile loop can call this every cycle; in
+// steady state it costs a handful of compares instead of blocking for the
+// 100+ ms a typical A/C message takes to transmit.
+// Returns:
+//   A boolean. true if the device is (now) in the requested state. i.e. true
+//   for both "sent successfully" & "already sent, nothing to do". false only
+//   if a send was needed & failed.
+bool IRac::sendAcIfChanged(const decode_type_t vendor, const int16_t model,
+                           const bool power, const stdAc::opmode_t mode,
+                           const float degrees, const bool celsius,
+                           const stdAc::fanspeed_t fan,
+                           const stdAc::swingv_t swingv,
+                           const stdAc::swingh_t swingh,
+                           const bool quiet, const bool turbo,
+                           const bool econo, const bool light,
+                           const bool filter, const bool clean,
+                           const bool beep, const int16_t sleep,
+                           const int16_t clock) {
+  if (!hasStateChanged(vendor, model, power, mode, degrees, celsius, fan,
+                       swingv, swingh, quiet, turbo, econo, light, filter,
+                       clean, beep, sleep, clock))
+    return true;  // Already in that state. Nothing to do.
+  return sendAc(vendor, model, power, mode, degrees, celsius, fan, swingv,
+                swingh, quiet, turbo, econo, light, filter, clean, beep,
+                sleep, clock);
+}
+
 stdAc::opmode_t IRac::strToOpmode(const char *str,
                                 const stdAc::opmode_t def) {
   if (!strcmp(str, "AUTO") || !strcmp(str, "AUTOMATIC"))
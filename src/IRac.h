@@ -10,31 +10,93 @@
 #include <string>
 #endif
 #include "IRremoteESP8266.h"
-#include "ir_Argo.h"
-#include "ir_Coolix.h"
-#include "ir_Daikin.h"
-#include "ir_Fujitsu.h"
-#include "ir_Gree.h"
-#include "ir_Haier.h"
-#include "ir_Hitachi.h"
-#include "ir_Kelvinator.h"
-#include "ir_Midea.h"
-#include "ir_Mitsubishi.h"
-#include "ir_MitsubishiHeavy.h"
-#include "ir_Panasonic.h"
-#include "ir_Samsung.h"
-#include "ir_Sharp.h"
-#include "ir_Tcl.h"
-#include "ir_Teco.h"
-#include "ir_Toshiba.h"
-#include "ir_Trotec.h"
-#include "ir_Vestel.h"
-#include "ir_Whirlpool.h"
+#include "IRsend.h"  // For the stdAc & *_ac_remote_model_t enums.
+
+// The vendor A/C classes IRac drives. Only pointers to them appear in this
+// header, so forward declarations suffice. Including each vendor's ir_*.h
+// here instead would recompile every IRac client against the entire A/C
+// surface on any change to any of them. IRac.cpp includes the real things.
+class IRArgoAC;
+class IRCoolixAC;
+class IRDaikinESP;
+class IRDaikin2;
+class IRDaikin216;
+class IRFujitsuAC;
+class IRGreeAC;
+class IRHaierAC;
+class IRHaierACYRW02;
+class IRHitachiAc;
+class IRKelvinatorAC;
+class IRMideaAC;
+class IRMitsubishiAC;
+class IRMitsubishiHeavy88Ac;
+class IRMitsubishiHeavy152Ac;
+class IRPanasonicAc;
+class IRSamsungAc;
+class IRSharpAc;
+class IRTcl112Ac;
+class IRTecoAc;
+class IRToshibaAC;
+class IRTrotecESP;
+class IRVestelAc;
+class IRWhirlpoolAc;
+
+// Capability descriptor for a protocol supported by IRac. See
+// IRac::capabilities(). It lets a client validate a request locally, instead
+// of discovering an unsupported setting by watching the A/C ignore it.
+// Notes:
+//   `modes` is a bitmask indexed by the stdAc::opmode_t values >= kAuto.
+//   e.g. `modes & (1 << (int)stdAc::opmode_t::kHeat)` means Heat mode.
+//   All stdAc::fanspeed_t values are always accepted; each vendor maps them
+//   to its nearest native speed, so there is no fan speed mask.
+//   Temperatures are in Celsius & get clamped to [min_temp, max_temp].
+typedef struct {
+  decode_type_t protocol;
+  uint8_t min_temp;
+  uint8_t max_temp;
+  uint8_t modes;
+  bool swingv;
+  bool swingh;
+  bool quiet;
+  bool turbo;
+  bool econo;
+  bool light;
+  bool filter;
+  bool clean;
+  bool beep;
+  bool sleep;
+  bool clock;
+} acCapability_t;
+
+// Structure to hold a common A/C state.
+typedef struct {
+  decode_type_t protocol;
+  int16_t model;
+  bool power;
+  stdAc::opmode_t mode;
+  float degrees;
+  bool celsius;
+  stdAc::fanspeed_t fanspeed;
+  stdAc::swingv_t swingv;
+  stdAc::swingh_t swingh;
+  bool quiet;
+  bool turbo;
+  bool econo;
+  bool light;
+  bool filter;
+  bool clean;
+  bool beep;
+  int16_t sleep;
+  int16_t clock;
+} commonAcState_t;
 
 class IRac {
  public:
   explicit IRac(uint8_t pin);
+  ~IRac();
   static bool isProtocolSupported(const decode_type_t protocol);
+  static bool capabilities(const decode_type_t protocol,
+                           acCapability_t *result);
   bool sendAc(const decode_type_t vendor, const int16_t model,
               const bool power, const stdAc::opmode_t mode, const float degrees,
               const bool celsius, const stdAc::fanspeed_t fan,
@@ -43,6 +105,26 @@ class IRac {
               const bool light, const bool filter, const bool clean,
               const bool beep, const int16_t sleep = -1,
               const int16_t clock = -1);
+  bool hasStateChanged(const decode_type_t vendor, const int16_t model,
+                       const bool power, const stdAc::opmode_t mode,
+                       const float degrees, const bool celsius,
+                       const stdAc::fanspeed_t fan,
+                       const stdAc::swingv_t swingv,
+                       const stdAc::swingh_t swingh,
+                       const bool quiet, const bool turbo, const bool econo,
+                       const bool light, const bool filter, const bool clean,
+                       const bool beep, const int16_t sleep = -1,
+                       const int16_t clock = -1);
+  bool sendAcIfChanged(const decode_type_t vendor, const int16_t model,
+                       const bool power, const stdAc::opmode_t mode,
+                       const float degrees, const bool celsius,
+                       const stdAc::fanspeed_t fan,
+                       const stdAc::swingv_t swingv,
+                       const stdAc::swingh_t swingh,
+                       const bool quiet, const bool turbo, const bool econo,
+                       const bool light, const bool filter, const bool clean,
+                       const bool beep, const int16_t sleep = -1,
+                       const int16_t clock = -1);
 
   static bool strToBool(const char *str, const bool def = false);
   static int16_t strToModel(const char *str, const int16_t def = -1);
@@ -60,6 +142,17 @@ class IRac {
  private:
 #endif
   uint8_t _pin;
+  // The most recently used protocol object, kept between sendAc() calls so
+  // repeated sends of the same protocol skip re-construction/stateReset()
+  // & their dirty-state optimisations persist. See acObj().
+  void *_acobj;
+  decode_type_t _acobj_type;
+  // What the last successful sendAc() transmitted, for hasStateChanged() /
+  // sendAcIfChanged(). Only valid once _sent is true.
+  commonAcState_t _lastsent;
+  bool _sent;
+  template <class T> T *acObj(const decode_type_t vendor);
+  void deleteAcObj();
 #if SEND_ARGO
   void argo(IRArgoAC *ac,
             const bool on, const stdAc::opmode_t mode, const float degrees,
@@ -229,26 +322,4 @@ void daikin216(IRDaikin216 *ac,
                  const int16_t sleep = -1, const int16_t clock = -1);
 #endif  // SEND_WHIRLPOOL_AC
 };  // IRac class
-
-// Structure to hold a common A/C state.
-typedef struct {
-  decode_type_t protocol;
-  int16_t model;
-  bool power;
-  stdAc::opmode_t mode;
-  float degrees;
-  bool celsius;
-  stdAc::fanspeed_t fanspeed;
-  stdAc::swingv_t swingv;
-  stdAc::swingh_t swingh;
-  bool quiet;
-  bool turbo;
-  bool econo;
-  bool light;
-  bool filter;
-  bool clean;
-  bool beep;
-  int16_t sleep;
-  int16_t clock;
-} commonAcState_t;
 #endif  // IRAC_H_
@@ -0,0 +1,243 @@
+// Copyright 2019 David Conran
+
+// An on-device store for learned IR codes. See IRcodestore.h for the
+// record format & the backend contract.
+
+#include "IRcodestore.h"
+#include <string.h>
+#include <algorithm>
+#include "IRrecv.h"
+#include "IRsend.h"
+#include "IRutils.h"
+
+// IRCodeStoreRamBackend
+
+// A trivial backend over a caller-supplied RAM buffer.
+// Args:
+//   buffer: The memory to use as the store.
+//   capacity: Size of `buffer` in bytes.
+IRCodeStoreRamBackend::IRCodeStoreRamBackend(uint8_t *buffer,
+                                             const uint32_t capacity) {
+  _buffer = buffer;
+  _capacity = capacity;
+  _used = 0;
+}
+
+int32_t IRCodeStoreRamBackend::read(uint32_t offset, uint8_t *data,
+                                    uint32_t len) {
+  if (offset >= _used) return 0;
+  len = std::min(len, _used - offset);
+  memcpy(data, _buffer + offset, len);
+  return len;
+}
+
+int32_t IRCodeStoreRamBackend::append(const uint8_t *data, uint32_t len) {
+  if (_used + len > _capacity) return -1;  // Won't fit.
+  uint32_t offset = _used;
+  memcpy(_buffer + offset, data, len);
+  _used += len;
+  return offset;
+}
+
+uint32_t IRCodeStoreRamBackend::size(void) { return _used; }
+
+// IRCodeStore
+
+// As IRrecv::compare(). i.e. 0 if newval is shorter than oldval,
+// 1 if roughly equal, & 2 if longer. 20% tolerance.
+static int16_t tickCompare(const uint16_t oldval, const uint16_t newval) {
+  if (newval < oldval * 0.8)
+    return 0;
+  else if (oldval < newval * 0.8)
+    return 2;
+  else
+    return 1;
+}
+
+// Create a code store.
+// Args:
+//   backend: Where the records live. Not owned; must outlive the store.
+//   irsend: The IRsend object sendStored() will transmit with.
+//
+// Call begin() before anything else, to (re)build the index from whatever
+// the backend already holds.
+IRCodeStore::IRCodeStore(IRCodeStoreBackend *backend, IRsend *irsend) {
+  _backend = backend;
+  _irsend = irsend;
+  _count = 0;
+  _end = 0;
+}
+
+// Read & sanity-check a record header.
+// Returns:
+//   A boolean. true if a plausible record header was read at `offset`.
+bool IRCodeStore::readRecord(const uint32_t offset, ircodestore_rec_t *rec) {
+  if (_backend->read(offset, reinterpret_cast<uint8_t *>(rec),
+                     sizeof(*rec)) != sizeof(*rec))
+    return false;
+  if (rec->count == 0) return false;  // No payload? Not a record.
+  // How big is the payload meant to be?
+  uint32_t payload = (rec->type == kCodeStoreRawType)
+                         ? rec->count * sizeof(uint16_t)
+                         : sizeof(uint64_t);
+  // A record truncated by e.g. a power loss mid-append ends the store.
+  return offset + sizeof(*rec) + payload <= _backend->size();
+}
+
+// Scan the backing store & rebuild the in-RAM index.
+// The scan stops at the first implausible or truncated record, so a store
+// interrupted mid-append simply loses its (incomplete) last record.
+// Returns:
+//   A boolean. true if the store is usable. (An empty store is usable.)
+bool IRCodeStore::begin(void) {
+  _count = 0;
+  _end = 0;
+  ircodestore_rec_t rec;
+  while (_count < kCodeStoreIndexSize && readRecord(_end, &rec)) {
+    _fingerprints[_count] = rec.fingerprint;
+    _offsets[_count] = _end;
+    _count++;
+    uint32_t payload = (rec.type == kCodeStoreRawType)
+                           ? rec.count * sizeof(uint16_t)
+                           : sizeof(uint64_t);
+    _end += sizeof(rec) + payload;
+  }
+  return true;
+}
+
+// Nr. of codes currently indexed.
+uint16_t IRCodeStore::count(void) { return _count; }
+
+// Calculate the fingerprint of a capture.
+// The same shape-based FNV hash as decodeHash() uses, so a button learnt
+// once will produce (almost certainly) the same fingerprint when pressed
+// again, despite the usual timing jitter.
+// Args:
+//   results: A ptr to the capture to fingerprint.
+// Returns:
+//   A 32-bit fingerprint. (Not guaranteed unique, but collisions are rare.)
+uint32_t IRCodeStore::fingerprint(const decode_results *results) {
+  int32_t hash = kFnvBasis32;
+  // 'rawlen - 2' to match getCaptureHash(). See the comments there.
+  for (uint16_t i = 1; i + 2 < results->rawlen; i++) {
+    int16_t value = tickCompare(results->rawbuf[i], results->rawbuf[i + 2]);
+    hash = (hash * kFnvPrime32) ^ value;
+  }
+  return hash & 0xFFFFFFFF;
+}
+
+// Append a capture to the store & index it.
+// Simple (<= 64 bit) decodes are stored as their type, bits, & value.
+// Everything else (UNKNOWN & the byte-array A/C protocols) is stored as its
+// raw timings, which replay faithfully regardless of protocol support.
+// Args:
+//   results: A ptr to the capture to store.
+// Returns:
+//   The id of the new record, or -1 if the index or the backend is full,
+//   or the append failed.
+int16_t IRCodeStore::store(const decode_results *results) {
+  if (_count >= kCodeStoreIndexSize) return -1;  // Index is full.
+  ircodestore_rec_t rec;
+  rec.reserved = 0;
+  rec.fingerprint = fingerprint(results);
+  int32_t offset;
+  if (results->decode_type != UNKNOWN && results->decode_type != UNUSED &&
+      !hasACState(results->decode_type)) {
+    // A simple decoded record. i.e. type + bits + value.
+    rec.type = (uint8_t)results->decode_type;
+    rec.count = results->bits;
+    offset = _backend->append(reinterpret_cast<uint8_t *>(&rec), sizeof(rec));
+    if (offset < 0) return -1;
+    uint64_t value = results->value;
+    if (_backend->append(reinterpret_cast<uint8_t *>(&value),
+                         sizeof(value)) < 0)
+      return -1;
+    _end = offset + sizeof(rec) + sizeof(value);
+  } else {
+    // A raw record. Timings (in usecs) start at rawbuf[1]. (rawbuf[0] is
+    // the gap before the message, which we don't want to replay.)
+    if (results->rawlen < 2) return -1;  // Nothing to store.
+    rec.type = kCodeStoreRawType;
+    rec.count = results->rawlen - 1;
+    offset = _backend->append(reinterpret_cast<uint8_t *>(&rec), sizeof(rec));
+    if (offset < 0) return -1;
+    // Convert & append the timings in small fixed-size chunks.
+    uint16_t chunk[kCodeStoreChunk];
+    for (uint16_t i = 0; i < rec.count;) {
+      uint16_t nr = std::min((uint16_t)(rec.count - i),
+                             (uint16_t)kCodeStoreChunk);
+      for (uint16_t j = 0; j < nr; j++)
+        chunk[j] = results->rawbuf[1 + i + j] * kRawTick;
+      if (_backend->append(reinterpret_cast<uint8_t *>(chunk),
+                           nr * sizeof(uint16_t)) < 0)
+        return -1;
+      i += nr;
+    }
+    _end = offset + sizeof(rec) + rec.count * sizeof(uint16_t);
+  }
+  _fingerprints[_count] = rec.fingerprint;
+  _offsets[_count] = offset;
+  return _count++;
+}
+
+// Find the id of the stored code matching a fingerprint.
+// e.g. find(IRCodeStore::fingerprint(&results)) after a fresh capture tells
+// you if (& where) that button has been learnt before.
+// Args:
+//   fingerprint: The fingerprint to look for.
+// Returns:
+//   The id of the first match, or -1 if it isn't in the store.
+int16_t IRCodeStore::find(const uint32_t fingerprint) {
+  for (uint16_t i = 0; i < _count; i++)
+    if (_fingerprints[i] == fingerprint) return i;
+  return -1;
+}
+
+// Replay a stored code.
+// Reads only the one record, streaming raw timings straight from the
+// backend into mark()/space() via a small stack buffer. No other part of
+// the store is touched & nothing is heap allocated.
+// Args:
+//   id: The id of the record, as returned by store(), find(), or implied
+//       by the (stable) append order.
+// Returns:
+//   A boolean. true if the code was transmitted.
+bool IRCodeStore::sendStored(const uint16_t id) {
+  if (id >= _count) return false;
+  ircodestore_rec_t rec;
+  uint32_t offset = _offsets[id];
+  if (!readRecord(offset, &rec)) return false;
+  offset += sizeof(rec);
+  if (rec.type != kCodeStoreRawType) {  // A simple decoded record.
+    uint64_t value;
+    if (_backend->read(offset, reinterpret_cast<uint8_t *>(&value),
+                       sizeof(value)) != sizeof(value))
+      return false;
+    return _irsend->send((decode_type_t)rec.type, value, rec.count);
+  }
+#if SEND_RAW
+  // A raw record. As sendRaw(), but chunked straight from the backend.
+  _irsend->enableIROut(kCodeStoreRawFreq * 1000);
+  uint16_t chunk[kCodeStoreChunk];
+  for (uint16_t i = 0; i < rec.count;) {
+    uint16_t nr = std::min((uint16_t)(rec.count - i),
+                           (uint16_t)kCodeStoreChunk);
+    uint32_t nr_bytes = nr * sizeof(uint16_t);
+    if (_backend->read(offset + i * sizeof(uint16_t),
+                       reinterpret_cast<uint8_t *>(chunk),
+                       nr_bytes) != (int32_t)nr_bytes)
+      return false;
+    for (uint16_t j = 0; j < nr; j++) {
+      if ((i + j) & 1)  // Entry 0 is a mark, so odd entries are spaces.
+        _irsend->space(chunk[j]);
+      else
+        _irsend->mark(chunk[j]);
+    }
+    i += nr;
+  }
+  _irsend->space(0);  // We potentially ended with a mark(), so LED off.
+  return true;
+#else  // SEND_RAW
+  return false;
+#endif  // SEND_RAW
+}
@@ -0,0 +1,88 @@
+// Copyright 2019 David Conran
+
+// An on-device store for learned IR codes.
+//
+// Captured messages are appended to a backing store (SPIFFS file, EEPROM,
+// raw flash, or just a RAM buffer) in a compact append-only format, with a
+// small in-RAM index mapping a decodeHash()-style fingerprint to the flash
+// offset of its record. Replaying a stored code reads only that one record,
+// in small fixed-size chunks, so lookup & replay are O(1) in the size of
+// the store & require no heap allocation.
+
+#ifndef IRCODESTORE_H_
+#define IRCODESTORE_H_
+
+#define __STDC_LIMIT_MACROS
+#include <stdint.h>
+#include "IRremoteESP8266.h"
+#include "IRrecv.h"
+#include "IRsend.h"
+
+// Constants
+const uint16_t kCodeStoreIndexSize = 16;  // Max nr. of codes in the index.
+const uint8_t kCodeStoreRawType = 0xFF;  // Record payload is raw timings.
+const uint8_t kCodeStoreChunk = 16;  // Nr. of timings per backend read/write.
+const uint16_t kCodeStoreRawFreq = 38;  // Carrier (kHz) for raw replay.
+
+// The fixed per-record header, exactly as laid out in the backing store.
+// A payload immediately follows it:
+//   Decoded records: the value, as a uint64_t.
+//   Raw records:     `count` timings, as uint16_t's of micro-seconds.
+typedef struct {
+  uint8_t type;  // A decode_type_t, or kCodeStoreRawType.
+  uint8_t reserved;  // Unused. Always 0 (for now).
+  uint16_t count;  // Decoded: nr. of bits. Raw: nr. of timing entries.
+  uint32_t fingerprint;  // decodeHash()-style FNV hash of the capture.
+} ircodestore_rec_t;
+
+// The flash/filesystem the store sits on, reduced to the three operations
+// the store needs. Wrap whatever your platform offers (a SPIFFS File,
+// EEPROM, a raw flash partition, ...) in one of these.
+class IRCodeStoreBackend {
+ public:
+  virtual ~IRCodeStoreBackend() {}
+  // Read `len` bytes at `offset` into `data`. Returns nr. of bytes read.
+  virtual int32_t read(uint32_t offset, uint8_t *data, uint32_t len) = 0;
+  // Append `len` bytes to the end of the store.
+  // Returns the offset they were written at, or -1 on failure.
+  virtual int32_t append(const uint8_t *data, uint32_t len) = 0;
+  // Nr. of bytes currently in the store.
+  virtual uint32_t size(void) = 0;
+};
+
+// A trivial backend over a caller-supplied RAM buffer. Useful for small
+// stores, for staging before a bulk flash write, & for testing.
+class IRCodeStoreRamBackend : public IRCodeStoreBackend {
+ public:
+  IRCodeStoreRamBackend(uint8_t *buffer, const uint32_t capacity);
+  int32_t read(uint32_t offset, uint8_t *data, uint32_t len);
+  int32_t append(const uint8_t *data, uint32_t len);
+  uint32_t size(void);
+
+ private:
+  uint8_t *_buffer;
+  uint32_t _capacity;
+  uint32_t _used;
+};
+
+// Classes
+class IRCodeStore {
+ public:
+  IRCodeStore(IRCodeStoreBackend *backend, IRsend *irsend);
+  bool begin(void);
+  int16_t store(const decode_results *results);
+  int16_t find(const uint32_t fingerprint);
+  bool sendStored(const uint16_t id);
+  uint16_t count(void);
+  static uint32_t fingerprint(const decode_results *results);
+
+ private:
+  bool readRecord(const uint32_t offset, ircodestore_rec_t *rec);
+  IRCodeStoreBackend *_backend;
+  IRsend *_irsend;
+  uint16_t _count;
+  uint32_t _end;  // Offset just past the last valid record.
+  uint32_t _fingerprints[kCodeStoreIndexSize];
+  uint32_t _offsets[kCodeStoreIndexSize];
+};
+#endif  // IRCODESTORE_H_
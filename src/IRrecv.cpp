@@ -6,64 +6,301 @@
 #include "IRrecv.h"
 #include <stddef.h>
 #ifndef UNIT_TEST
+#if defined(ESP32)
+#include <driver/gpio.h>
+#include <driver/rmt.h>
+#include <esp_sleep.h>
+#else  // ESP32
 extern "C" {
 #include <gpio.h>
 #include <user_interface.h>
 }
+#endif  // ESP32
 #include <Arduino.h>
 #endif
 #include <algorithm>
 #include "IRremoteESP8266.h"
+#include "IRtimer.h"
 #include "IRutils.h"
+#include "ir_NEC.h"  // For the NEC repeat-frame fast path in decode().
 
-#ifdef UNIT_TEST
-#undef ICACHE_RAM_ATTR
-#define ICACHE_RAM_ATTR
-#endif
 // Updated by Sebastien Warin (http://sebastien.warin.fr) for receiving IR code
 // on ESP8266
 // Updated by markszabo (https://github.com/markszabo/IRremoteESP8266) for
 // sending IR code on ESP8266
 
 // Globals
-#ifndef UNIT_TEST
-static ETSTimer timer;
+#if !defined(UNIT_TEST) && !defined(ESP32)
+// Registry of the receivers currently capturing, one per interrupt
+// trampoline/timer slot. enableIRIn() claims a slot, disableIRIn() releases
+// it. attachInterrupt() only takes a plain no-argument handler, so each slot
+// needs its own trampoline. Add another if you ever need more than two
+// receivers (e.g. a 38kHz & a 56kHz module) on one board.
+const uint8_t kMaxIrReceivers = 2;
+static IRrecv *volatile receivers[kMaxIrReceivers] = {NULL, NULL};
+static ETSTimer timers[kMaxIrReceivers];
 #endif
-volatile irparams_t irparams;
-irparams_t *irparams_save;  // A copy of the interrupt state while decoding.
 
-#ifndef UNIT_TEST
-static void ICACHE_RAM_ATTR read_timeout(void *arg __attribute__((unused))) {
+// The frame queue. A lock-free (single producer/single consumer) ring of
+// completed captures between the interrupt handler & decode().
+// See IRrecv::setFrameQueue(). Inactive (framequeue_size == 0) by default.
+// One ring slot is always left unused to tell a full queue from an empty one,
+// so head == tail means empty.
+static volatile irframe_t *framequeue = NULL;
+static volatile uint8_t framequeue_size = 0;  // Nr. of ring slots. 0 == off.
+static volatile uint8_t framequeue_head = 0;  // Producer. ISR writes only.
+static volatile uint8_t framequeue_tail = 0;  // Consumer. decode() writes only.
+// A spare buffer popFrame() trades with a slot, so the slot can be reused by
+// the interrupt handler while the popped capture is still being decoded.
+static uint16_t *framequeue_decodebuf = NULL;
+// Which IRrecv instance the queue belongs to. The queue is a single set of
+// global buffers, so only one receiver at a time may use it.
+static IRrecv *volatile framequeue_owner = NULL;
+#if RAWBUF_COMPRESSION
+// Is the frame queue storing its captures compressed?
+static volatile bool framequeue_compress = false;
+
+// Fetch the pos'th 4-bit code from a compressed capture's nibble stream.
+static uint8_t IR_ISR_ATTR frame_nibble(volatile uint8_t *nibbles,
+                                            uint16_t pos) {
+  uint8_t b = nibbles[pos >> 1];
+  return (pos & 1) ? (b & 0xF) : (b >> 4);
+}
+
+// Store a 4-bit code at position pos of a compressed capture's nibble stream.
+// Positions must be written in ascending order.
+static void IR_ISR_ATTR frame_nibble_put(volatile uint8_t *nibbles,
+                                             uint16_t pos, uint8_t code) {
+  if (pos & 1)
+    nibbles[pos >> 1] |= code;
+  else
+    nibbles[pos >> 1] = code << 4;
+}
+#endif  // RAWBUF_COMPRESSION
+
+#if COMPACT_RAWBUF
+// Inflate a compact (8-bit) capture back into full-width kRawTick entries.
+// See IRrecv::setCompactBuffer() for the format.
+//
+// Args:
+//   src: The compact byte stream.
+//   nbytes: Nr. of bytes of src in use.
+//   dst: Where to write the full-width entries.
+//   max_entries: Capacity of dst.
+// Returns:
+//   The nr. of entries produced.
+static uint16_t IR_FLASH_ATTR compactInflate(volatile uint8_t *src,
+                                             uint16_t nbytes, uint16_t *dst,
+                                             uint16_t max_entries) {
+  uint16_t entries = 0;
+  for (uint16_t i = 0; i < nbytes && entries < max_entries;) {
+    uint8_t b = src[i++];
+    if (b != kCompactEscape) {
+      dst[entries++] = b * (kCompactTick / kRawTick);
+    } else {
+      if (i + 2 > nbytes) break;  // A truncated escape. Shouldn't happen.
+      dst[entries++] = src[i] | (src[i + 1] << 8);
+      i += 2;
+    }
+  }
+  return entries;
+}
+#endif  // COMPACT_RAWBUF
+
+#if defined(ESP32) && !defined(UNIT_TEST)
+// The RMT peripheral runs off the 80MHz APB clock.
+// Divide it down so each RMT duration tick is exactly 1 uSecond.
+const uint8_t kRmtClkDiv = 80;
+#endif  // ESP32 && !UNIT_TEST
+
+#if !defined(UNIT_TEST) && !defined(ESP32)
+#if RAWBUF_COMPRESSION
+// Compress the just-completed capture into a frame queue slot, as a per-frame
+// dictionary of timing symbols plus a stream of 4-bit codes.
+// Runs in interrupt context, hence integer-only & allocation free.
+// A duration within ~12.5% of an existing symbol is stored as that symbol,
+// which is well inside the matching tolerance the decoders use anyway.
+// A duration that fits neither the dictionary nor a free symbol slot is kept
+// exact: an escape code followed by its 4 value nibbles.
+//
+// Args:
+//   slot: The frame queue slot to compress into.
+// Returns:
+//   A boolean indicating if the capture fit. If not, the slot is unusable &
+//   the capture should be dropped.
+bool IR_ISR_ATTR IRrecv::frameCompress(volatile irframe_t *slot) {
+  // The nibble buffer holds bufsize + 4 codes. (See setFrameQueue())
+  uint16_t maxnibbles = irparams.bufsize + 4;
+  uint16_t nibble = 0;
+  uint8_t dictlen = 0;
+  for (uint16_t i = 0; i < irparams.rawlen; i++) {
+    uint16_t usecs = irparams.rawbuf[i];
+    uint8_t code = kFrameDictEscape;
+    for (uint8_t j = 0; j < dictlen; j++) {
+      uint16_t symbol = slot->dict[j];
+      uint16_t slack = symbol >> 3;  // i.e. Within ~12.5% of the symbol.
+      if (usecs >= symbol - slack && usecs <= symbol + slack) {
+        code = j;
+        break;
+      }
+    }
+    if (code == kFrameDictEscape && dictlen < kFrameDictEntries) {
+      slot->dict[dictlen] = usecs;
+      code = dictlen++;
+    }
+    if (code != kFrameDictEscape) {
+      if (nibble >= maxnibbles) return false;  // Out of space.
+      frame_nibble_put(slot->nibbles, nibble++, code);
+    } else {
+      if (nibble + 5 > maxnibbles) return false;  // Out of space.
+      frame_nibble_put(slot->nibbles, nibble++, kFrameDictEscape);
+      for (uint8_t shift = 16; shift;)  // Most significant nibble first.
+        frame_nibble_put(slot->nibbles, nibble++,
+                         (usecs >> (shift -= 4)) & 0xF);
+    }
+  }
+  slot->dictlen = dictlen;
+  slot->rawlen = irparams.rawlen;
+  slot->overflow = irparams.overflow;
+  return true;
+}
+#endif  // RAWBUF_COMPRESSION
+
+// The os_timer callback. Forwards to the receiver instance that was handed
+// to os_timer_setfn() as the callback argument. (See enableIRIn())
+static void IR_ISR_ATTR read_timeout(void *arg) {
+  IR_PROFILE_HIGH();
+  ((IRrecv *)arg)->readTimeout();
+  IR_PROFILE_LOW();
+}
+
+// The capture timed out. i.e. The current message (if any) is complete.
+// Runs in (timer) interrupt context.
+void IR_ISR_ATTR IRrecv::readTimeout() {
   os_intr_lock();
-  if (irparams.rawlen) irparams.rcvstate = kStopState;
+  if (irparams.rawlen) {
+    if (framequeue_size && framequeue_owner == this) {
+      // Frame-queued mode. Publish the completed capture to the ring and
+      // keep right on capturing into the slot's (already consumed) buffer,
+      // so back-to-back messages aren't lost while decode() is busy.
+      uint8_t next = framequeue_head + 1;
+      if (next >= framequeue_size) next = 0;
+      if (next != framequeue_tail) {  // Drop the capture if the ring is full.
+#if RAWBUF_COMPRESSION
+        if (framequeue_compress) {
+          // Compressed mode. Pack the capture into the slot & carry on
+          // capturing into the same buffer. No swap needed.
+          if (frameCompress(&framequeue[framequeue_head]))
+            framequeue_head = next;
+        } else {
+#else  // RAWBUF_COMPRESSION
+        {
+#endif  // RAWBUF_COMPRESSION
+          uint16_t *spare = framequeue[framequeue_head].rawbuf;
+          framequeue[framequeue_head].rawbuf = irparams.rawbuf;
+          framequeue[framequeue_head].rawlen = irparams.rawlen;
+          framequeue[framequeue_head].overflow = irparams.overflow;
+          framequeue_head = next;
+          irparams.rawbuf = spare;
+        }
+      }
+      irparams.rawlen = 0;
+      irparams.overflow = false;
+      irparams.rcvstate = kIdleState;
+    } else {
+      irparams.rcvstate = kStopState;
+    }
+  }
   os_intr_unlock();
 }
 
-static void ICACHE_RAM_ATTR gpio_intr() {
+// The GPIO edge interrupt trampolines, one per receiver slot. They only
+// exist because attachInterrupt() (on the cores we support) takes a plain
+// no-argument handler, so the instance has to come from the registry.
+static void IR_ISR_ATTR gpio_intr0() {
+  IR_PROFILE_HIGH();
+  IRrecv *self = receivers[0];
+  if (self != NULL) self->gpioIntr();
+  IR_PROFILE_LOW();
+}
+
+static void IR_ISR_ATTR gpio_intr1() {
+  IR_PROFILE_HIGH();
+  IRrecv *self = receivers[1];
+  if (self != NULL) self->gpioIntr();
+  IR_PROFILE_LOW();
+}
+
+// An edge on our pin. Record the duration since the previous edge.
+// Runs in interrupt context.
+void IR_ISR_ATTR IRrecv::gpioIntr() {
   uint32_t now = system_get_time();
   uint32_t gpio_status = GPIO_REG_READ(GPIO_STATUS_ADDRESS);
-  static uint32_t start = 0;
+  uint32_t start = _edge_start;
 
-  os_timer_disarm(&timer);
+  if (!_lazy_timeout) os_timer_disarm(&timers[_slot]);
   GPIO_REG_WRITE(GPIO_STATUS_W1TC_ADDRESS, gpio_status);
 
-  // Grab a local copy of rawlen to reduce instructions used in IRAM.
-  // This is an ugly premature optimisation code-wise, but we do everything we
-  // can to save IRAM.
-  // It seems referencing the value via the structure uses more instructions.
-  // Less instructions means faster and less IRAM used.
-  // N.B. It saves about 13 bytes of IRAM.
-  uint16_t rawlen = irparams.rawlen;
+  // Work on a local copy of the capture state to reduce instructions used
+  // in IRAM. This is an ugly premature optimisation code-wise, but we do
+  // everything we can to save IRAM & per-edge cycles. rcvstate, overflow &
+  // rawlen share one word in irparams_t precisely so that this is a single
+  // volatile load, & the write-back at the end a single volatile store,
+  // instead of one memory access per field.
+  uint32_t state = irparams.capture_word;
+  uint8_t rcvstate = state & 0xFF;
+  uint16_t rawlen = state >> 16;
 
   if (rawlen >= irparams.bufsize) {
-    irparams.overflow = true;
-    irparams.rcvstate = kStopState;
+    // i.e. overflow = true; rcvstate = kStopState;
+    irparams.capture_word = ((uint32_t)rawlen << 16) | (1 << 8) | kStopState;
+    return;
   }
 
-  if (irparams.rcvstate == kStopState) return;
+  if (rcvstate == kStopState) return;
 
-  if (irparams.rcvstate == kIdleState) {
-    irparams.rcvstate = kMarkState;
+#if COMPACT_RAWBUF
+  if (irparams.compact) {
+    // Compact (8-bit) mode. The buffer holds bufsize *bytes*, not entries.
+    volatile uint8_t *buf = (volatile uint8_t *)irparams.rawbuf;
+    uint32_t ticks;  // In kRawTick units, as per the classic buffer.
+    if (rcvstate == kIdleState) {
+      rcvstate = kMarkState;
+      ticks = 1;  // The usual dummy first entry.
+    } else if (now < start) {
+      ticks = (UINT32_MAX - start + now) / kRawTick;
+    } else {
+      ticks = (now - start) / kRawTick;
+    }
+    uint32_t compacted = ticks / (kCompactTick / kRawTick);
+    uint16_t bytes = irparams.rawbytes;
+    // 1 byte for a short entry, 3 (escape + exact 16 bit value) for a long.
+    uint8_t needed = (compacted < kCompactEscape) ? 1 : 3;
+    if (bytes + needed > irparams.bufsize) {
+      // i.e. overflow = true; rcvstate = kStopState;
+      irparams.capture_word = ((uint32_t)rawlen << 16) | (1 << 8) | kStopState;
+      return;
+    }
+    if (needed == 1) {
+      buf[bytes++] = compacted;
+    } else {
+      if (ticks > UINT16_MAX) ticks = UINT16_MAX;
+      buf[bytes++] = kCompactEscape;
+      buf[bytes++] = ticks & 0xFF;
+      buf[bytes++] = ticks >> 8;
+    }
+    irparams.rawbytes = bytes;
+    irparams.capture_word =
+        ((uint32_t)(rawlen + 1) << 16) | (state & 0xFF00) | rcvstate;
+    _edge_start = now;
+#define ONCE 0
+    if (!_lazy_timeout) os_timer_arm(&timers[_slot], irparams.timeout, ONCE);
+    return;
+  }
+#endif  // COMPACT_RAWBUF
+
+  if (rcvstate == kIdleState) {
+    rcvstate = kMarkState;
     irparams.rawbuf[rawlen] = 1;
   } else {
     if (now < start)
@@ -71,16 +308,78 @@ static void ICACHE_RAM_ATTR gpio_intr() {
     else
       irparams.rawbuf[rawlen] = (now - start) / kRawTick;
   }
-  irparams.rawlen++;
+  // Write rcvstate & the incremented rawlen back in a single store.
+  irparams.capture_word =
+      ((uint32_t)(rawlen + 1) << 16) | (state & 0xFF00) | rcvstate;
 
-  start = now;
+  _edge_start = now;
 #define ONCE 0
-  os_timer_arm(&timer, irparams.timeout, ONCE);
+  if (!_lazy_timeout) os_timer_arm(&timers[_slot], irparams.timeout, ONCE);
 }
-#endif  // UNIT_TEST
+#endif  // !UNIT_TEST && !ESP32
 
 // Start of IRrecv class -------------------
 
+#if IRMEM_STATS
+// The capture buffer allocation-failure policy. Applies to IRrecv
+// construction from the point it is set. See IRrecv::setHeapPolicy().
+static irheap_policy_t heap_policy = kIRHeapReboot;
+// The static fallback capture buffer for kIRHeapStatic, & a claim marker so
+// only one IRrecv can end up using it at a time.
+static uint16_t heap_fallbackbuf[kRawBuf];
+static bool heap_fallback_used = false;
+
+// Set what the constructor does if a capture buffer allocation fails.
+// The default (kIRHeapReboot) is the historic ESP.restart() behaviour.
+// Call *before* constructing the IRrecv it is to apply to.
+//
+// Args:
+//   policy: The irheap_policy_t to use from now on.
+void IRrecv::setHeapPolicy(const irheap_policy_t policy) {
+  heap_policy = policy;
+}
+#endif  // IRMEM_STATS
+
+// Allocate a capture buffer of `*bufsize` entries, applying the configured
+// allocation-failure policy. (IRMEM_STATS only. Otherwise a plain new.)
+//
+// Args:
+//   bufsize: In/Out. Nr. of entries wanted. May be reduced by kIRHeapShrink
+//            or kIRHeapStatic.
+//   is_static: Out. Set true if the static fallback buffer was handed out.
+//              i.e. The result must not be delete[]d, nor counted as heap.
+// Returns:
+//   A pointer to the buffer, or NULL if every avenue failed.
+static uint16_t *allocCaptureBuf(uint16_t *bufsize, bool *is_static) {
+  *is_static = false;
+  uint16_t *buf = new uint16_t[*bufsize];
+#if IRMEM_STATS
+  switch (heap_policy) {
+    case kIRHeapShrink:
+      // Retry with progressively halved sizes. A small capture buffer beats
+      // a reboot; simple protocols still decode fine from kRawBuf entries.
+      while (buf == NULL && *bufsize > kRawBuf) {
+        *bufsize = std::max((uint16_t)(*bufsize / 2), kRawBuf);
+        buf = new uint16_t[*bufsize];
+      }
+      break;
+    case kIRHeapStatic:
+      // Hand out the (one) static fallback buffer. First come, first served.
+      if (buf == NULL && !heap_fallback_used) {
+        heap_fallback_used = true;
+        *is_static = true;
+        *bufsize = kRawBuf;
+        buf = heap_fallbackbuf;
+      }
+      break;
+    case kIRHeapReboot:
+    default:
+      break;  // Leave the NULL for the caller to reboot on. i.e. As before.
+  }
+#endif  // IRMEM_STATS
+  return buf;
+}
+
 // Class constructor
 // Args:
 //   recvpin: GPIO pin the IR receiver module's data pin is connected to.
@@ -88,16 +387,28 @@ static void ICACHE_RAM_ATTR gpio_intr() {
 //   timeout: Nr. of milli-Seconds of no signal before we stop capturing data.
 //            (Default: kTimeoutMs)
 //   save_buffer:  Use a second (save) buffer to decode from. (Def: false)
+//   rmt_channel: ESP32 only. Which RMT channel to use for the hardware
+//                capture. (Default: 0)
 // Returns:
 //   An IRrecv class object.
+#if defined(ESP32)
+IRrecv::IRrecv(uint16_t recvpin, uint16_t bufsize, uint8_t timeout,
+               bool save_buffer, uint8_t rmt_channel) {
+  _rmt_channel = rmt_channel;
+  _rmt_ringbuf = NULL;
+  _decode_task = NULL;
+  _decode_callback = NULL;
+#else  // ESP32
 IRrecv::IRrecv(uint16_t recvpin, uint16_t bufsize, uint8_t timeout,
                bool save_buffer) {
-  irparams.recvpin = recvpin;
-  irparams.bufsize = bufsize;
-  // Ensure we are going to be able to store all possible values in the
-  // capture buffer.
-  irparams.timeout = std::min(timeout, (uint8_t)kMaxTimeoutMs);
-  irparams.rawbuf = new uint16_t[bufsize];
+#endif  // ESP32
+  commonInit(recvpin, timeout);
+  bool is_static = false;
+  irparams.rawbuf = allocCaptureBuf(&bufsize, &is_static);
+  irparams.bufsize = bufsize;  // May have been reduced by the heap policy.
+#if IRMEM_STATS
+  _rawbuf_static = is_static;
+#endif  // IRMEM_STATS
   if (irparams.rawbuf == NULL) {
     DPRINTLN(
         "Could not allocate memory for the primary IR buffer.\n"
@@ -105,6 +416,8 @@ IRrecv::IRrecv(uint16_t recvpin, uint16_t bufsize, uint8_t timeout,
 #ifndef UNIT_TEST
     ESP.restart();  // Mem alloc failure. Reboot.
 #endif
+  } else if (!is_static) {
+    irMemRecordAlloc((uint32_t)bufsize * sizeof(uint16_t));
   }
   // If we have been asked to use a save buffer (for decoding), then create one.
   if (save_buffer) {
@@ -112,311 +425,3152 @@ IRrecv::IRrecv(uint16_t recvpin, uint16_t bufsize, uint8_t timeout,
     irparams_save->rawbuf = new uint16_t[bufsize];
     // Check we allocated the memory successfully.
     if (irparams_save->rawbuf == NULL) {
+#if IRMEM_STATS
+      if (heap_policy != kIRHeapReboot) {
+        // Degrade to decoding directly from the live buffer rather than
+        // rebooting. i.e. As if save_buffer had been false.
+        delete irparams_save;
+        irparams_save = NULL;
+      } else {
+#endif  // IRMEM_STATS
       DPRINTLN(
           "Could not allocate memory for the second IR buffer.\n"
           "Try a smaller size for CAPTURE_BUFFER_SIZE.\nRebooting!");
 #ifndef UNIT_TEST
       ESP.restart();  // Mem alloc failure. Reboot.
 #endif
+#if IRMEM_STATS
+      }
+#endif  // IRMEM_STATS
+    } else {
+      irMemRecordAlloc(sizeof(irparams_t) +
+                       (uint32_t)bufsize * sizeof(uint16_t));
     }
   } else {
     irparams_save = NULL;
   }
+}
+
+// As above, but using caller-provided capture buffers instead of heap
+// allocating them. e.g. `static` arrays living in .bss, for a deterministic
+// memory layout, zero startup allocation & no chance of the allocation
+// failure reboot on a fragmented heap.
+// The caller keeps ownership: the buffers must outlive the IRrecv & are
+// never delete[]d by it.
+//
+// Args:
+//   recvpin: GPIO pin the IR receiver module's data pin is connected to.
+//   rawbuf: The capture buffer to use. Must hold `bufsize` entries.
+//   bufsize: Nr. of entries in the supplied buffer(s).
+//   timeout: Nr. of milli-Seconds of no signal before we stop capturing data.
+//            (Default: kTimeoutMs)
+//   save_rawbuf: Optional second buffer (also `bufsize` entries) to decode
+//                from, as per save_buffer above. (Default: NULL. i.e. none)
+//   rmt_channel: ESP32 only. Which RMT channel to use for the hardware
+//                capture. (Default: 0)
+// Returns:
+//   An IRrecv class object.
+#if defined(ESP32)
+IRrecv::IRrecv(uint16_t recvpin, uint16_t *rawbuf, uint16_t bufsize,
+               uint8_t timeout, uint16_t *save_rawbuf, uint8_t rmt_channel) {
+  _rmt_channel = rmt_channel;
+  _rmt_ringbuf = NULL;
+  _decode_task = NULL;
+  _decode_callback = NULL;
+#else  // ESP32
+IRrecv::IRrecv(uint16_t recvpin, uint16_t *rawbuf, uint16_t bufsize,
+               uint8_t timeout, uint16_t *save_rawbuf) {
+#endif  // ESP32
+  commonInit(recvpin, timeout);
+  _extern_buffers = true;
+  irparams.rawbuf = rawbuf;
+  irparams.bufsize = bufsize;
+  if (save_rawbuf != NULL) {
+    // The bookkeeping struct comes from an inline member, so this
+    // constructor never touches the heap.
+    irparams_save = &_save_storage;
+    irparams_save->rawbuf = save_rawbuf;
+    irparams_save->bufsize = bufsize;
+  } else {
+    irparams_save = NULL;
+  }
+}
+
+// The (non-buffer) initialisation shared by the constructors.
+//
+// Args:
+//   recvpin: GPIO pin the IR receiver module's data pin is connected to.
+//   timeout: Nr. of milli-Seconds of no signal before we stop capturing data.
+void IRrecv::commonInit(uint16_t recvpin, uint8_t timeout) {
+  irparams.recvpin = recvpin;
+  // Ensure we are going to be able to store all possible values in the
+  // capture buffer.
+  irparams.timeout = std::min(timeout, (uint8_t)kMaxTimeoutMs);
+  _timeout_default = irparams.timeout;
+  _adaptive_timeout = false;
+  // irparams is a class member (not a zero-initialised global), so put the
+  // capture state machine into a known state ourselves.
+  irparams.rawbuf = NULL;
+  irparams.rcvstate = kIdleState;
+  irparams.rawlen = 0;
+  irparams.overflow = false;
+#if !defined(UNIT_TEST) && !defined(ESP32)
+  _slot = 0;
+  _edge_start = 0;
+  _lazy_timeout = false;
+#endif  // !UNIT_TEST && !ESP32
+  _priority_len = 0;
+  _adaptive = false;
+  _adaptive_last = UNKNOWN;
+  _trigger_len = 0;
+#if DECODE_MAGIQUEST
+  _wands_len = 0;
+#endif  // DECODE_MAGIQUEST
+#if (DECODE_RC5 || DECODE_RC6 || DECODE_LASERTAG || DECODE_MWM)
+  _rc_bitTime = 0;  // i.e. The getRClevel() span bounds aren't computed yet.
+#endif
 #if DECODE_HASH
   unknown_threshold = kUnknownThreshold;
+  _hash_value = 0;
+  _hash_valid = false;
+  _repeatcache_on = false;
+  _repeatcache_next = 0;
+  for (uint8_t i = 0; i < kRepeatCacheEntries; i++)
+    _repeatcache[i].fingerprint = 0;
+  _dedup_window = 0;  // Duplicate suppression is off by default.
+  _dedup_valid = false;
 #endif  // DECODE_HASH
+#if IRRECV_STATS
+  resetDecodeStats();
+#endif  // IRRECV_STATS
+  // Allow every protocol by default.
+  for (uint16_t i = 0; i < kProtocolMaskWords; i++)
+    _protocolmask[i] = UINT64_MAX;
+  _budget_active = false;  // No budgeted decode walk until decodeBudgeted().
+  _budget_out = false;
+  _budget_resumed = false;
+  _budget_usecs = 0;
+  _budget_done = 0;
+  _budget_pos = 0;
+  _budget_new = 0;
+  _on_decode = NULL;  // No decode callback until onDecode() registers one.
+  _on_decode_filter = UNKNOWN;
+  _streambuf = NULL;  // Only allocated if decodePoll() is actually used.
+  _stream_lastlen = 0;
+  _stream_triedlen = 0;
+  _injectbuf = NULL;  // Only allocated if decodeRaw() is actually used.
+  _injectsize = 0;
+  _tolerance = kTolerance;  // Default runtime match tolerance.
+  _tol_len = 0;             // No per-protocol overrides registered.
+  _tol_active = UNKNOWN;
+  _noise_floor = 0;  // The capture noise filter is off by default.
+  _bufsize_max = 0;  // Adaptive buffer growth is off by default.
+  _bufsize_highwater = 0;  // No captures observed yet.
+  _wake_assist = false;   // No light-sleep wake assistance until asked for.
+  _wake_recovery = false;
+  _single_frame = false;  // Multi-frame protocols verify every copy.
+#if DECODE_RC5 || DECODE_RC6
+  _toggle_track = false;  // No RC-5/RC-6 toggle tracking until asked for.
+  _toggle_coalesce = false;
+  _toggle_prev = 0;
+  _toggle_prev_type = UNKNOWN;  // i.e. Nothing surfaced yet.
+  _toggle_repeats = 0;
+#endif  // DECODE_RC5 || DECODE_RC6
+  _extern_buffers = false;
+#if IRMEM_STATS
+  _rawbuf_static = false;
+#endif  // IRMEM_STATS
+#if COMPACT_RAWBUF
+  irparams.compact = false;
+  irparams.rawbytes = 0;
+#endif  // COMPACT_RAWBUF
 }
 
 // Class destructor
 IRrecv::~IRrecv(void) {
-  delete[] irparams.rawbuf;
+#if defined(ESP32)
+  stopDecodeTask();  // Don't leave the task decoding from freed buffers.
+#elif !defined(UNIT_TEST)
+  disableIRIn();  // Don't leave a dangling pointer in the slot registry.
+#endif  // ESP32
+  setFrameQueue(0);  // Free any frame queue allocations.
+  if (_streambuf != NULL) {
+    irMemRecordFree((uint32_t)irparams.bufsize * sizeof(uint16_t));
+    delete[] _streambuf;
+  }
+  if (_injectbuf != NULL) {
+    irMemRecordFree((uint32_t)_injectsize * sizeof(uint16_t));
+    delete[] _injectbuf;
+  }
+  if (_extern_buffers) return;  // The caller owns the capture buffers.
+#if IRMEM_STATS
+  if (_rawbuf_static) {
+    heap_fallback_used = false;  // Release our claim on the fallback buffer.
+  } else
+#endif  // IRMEM_STATS
+  if (irparams.rawbuf != NULL) {
+    uint32_t words = irparams.bufsize;
+#if COMPACT_RAWBUF
+    if (irparams.compact) words = (irparams.bufsize + 1) / 2;
+#endif  // COMPACT_RAWBUF
+    irMemRecordFree(words * sizeof(uint16_t));
+    delete[] irparams.rawbuf;
+  }
   if (irparams_save != NULL) {
+    irMemRecordFree(sizeof(irparams_t) +
+                    (uint32_t)irparams.bufsize * sizeof(uint16_t));
     delete[] irparams_save->rawbuf;
     delete irparams_save;
   }
 }
 
-// initialization
-void IRrecv::enableIRIn() {
-  // initialize state machine variables
-  resume();
-
-#ifndef UNIT_TEST
-  // Initialize timer
-  os_timer_disarm(&timer);
-  os_timer_setfn(&timer, reinterpret_cast<os_timer_func_t *>(read_timeout),
-                 NULL);
-
-  // Attach Interrupt
-  attachInterrupt(irparams.recvpin, gpio_intr, CHANGE);
-#endif
+// Enable (or disable) the frame queue between the interrupt handler and
+// decode(). When enabled, completed captures are published to a lock-free
+// ring and capturing continues immediately, so back-to-back messages are not
+// lost while a previous one is still being decoded. decode() then consumes
+// the oldest capture from the ring.
+// Call this before enableIRIn(). It is not needed (nor useful) with the ESP32
+// RMT backend, as the RMT driver's own ring buffer already queues captures.
+//
+// Args:
+//   nr_of_frames: How many completed captures to be able to hold. 0 disables
+//                 the queue & frees its memory.
+//   compress: Store the queued captures compressed (a per-frame dictionary of
+//             timing symbols + 4-bit codes), roughly quartering the queue's
+//             memory use. Needs RAWBUF_COMPRESSION enabled in
+//             IRremoteESP8266.h. Durations get snapped to within ~12.5% of a
+//             dictionary symbol, which is well inside the decoders' matching
+//             tolerance, but know your timing data is no longer exact.
+//             (Default: false)
+// Returns:
+//   A boolean indicating success. i.e. false on memory allocation failure,
+//   or asking for compression without RAWBUF_COMPRESSION compiled in.
+//
+// Note:
+//   Each frame costs an extra capture buffer (bufsize entries, or a quarter
+//   of that when compressed), plus one full-size buffer for the decoder to
+//   work from. Choose a suitably small bufsize/nr_of_frames combination for
+//   your available memory.
+bool IRrecv::setFrameQueue(uint8_t nr_of_frames, bool compress) {
+  // The queue's buffers are (single) globals, so only one receiver at a time
+  // may use it. i.e. Hands off another instance's queue.
+  if (framequeue != NULL && framequeue_owner != this) return false;
+  // Tear down any existing queue first.
+  if (framequeue != NULL) {
+    uint8_t slots = framequeue_size;
+    framequeue_size = 0;  // Stops the interrupt handler touching the queue.
+    uint32_t slotbytes = (uint32_t)irparams.bufsize * sizeof(uint16_t);
+#if RAWBUF_COMPRESSION
+    if (framequeue_compress) slotbytes = irparams.bufsize / 2 + 2;
+#endif  // RAWBUF_COMPRESSION
+    for (uint8_t i = 0; i < slots; i++) {
+      delete[] framequeue[i].rawbuf;
+#if RAWBUF_COMPRESSION
+      delete[] framequeue[i].nibbles;
+#endif  // RAWBUF_COMPRESSION
+    }
+    delete[] framequeue;
+    delete[] framequeue_decodebuf;
+    framequeue = NULL;
+    framequeue_decodebuf = NULL;
+    framequeue_owner = NULL;
+    irMemRecordFree(slots * sizeof(irframe_t) + slots * slotbytes +
+                    (uint32_t)irparams.bufsize * sizeof(uint16_t));
+  }
+  framequeue_head = 0;
+  framequeue_tail = 0;
+#if !RAWBUF_COMPRESSION
+  if (compress) return false;  // No compressor compiled in. Can't do it.
+#endif  // !RAWBUF_COMPRESSION
+  if (nr_of_frames == 0) return true;  // All done if we are just disabling.
+#if COMPACT_RAWBUF
+  // The queue's buffer swapping assumes full-width capture buffers.
+  if (irparams.compact) return false;
+#endif  // COMPACT_RAWBUF
+
+  // One extra ring slot, as one is always left unused to tell a full ring
+  // from an empty one.
+  uint8_t slots = nr_of_frames + 1;
+  volatile irframe_t *queue = new irframe_t[slots];
+  if (queue == NULL) return false;
+  for (uint8_t i = 0; i < slots; i++) {
+    bool failed;
+#if RAWBUF_COMPRESSION
+    if (compress) {
+      // Compressed mode slots hold nibble codes, not a raw buffer.
+      // bufsize + 4 nibble capacity, so a capture ending in an escaped
+      // (non-dictionary) duration still fits.
+      queue[i].rawbuf = NULL;
+      queue[i].nibbles = new uint8_t[irparams.bufsize / 2 + 2];
+      queue[i].dictlen = 0;
+      failed = (queue[i].nibbles == NULL);
+    } else {
+      queue[i].rawbuf = new uint16_t[irparams.bufsize];
+      queue[i].nibbles = NULL;
+      failed = (queue[i].rawbuf == NULL);
+    }
+#else  // RAWBUF_COMPRESSION
+    queue[i].rawbuf = new uint16_t[irparams.bufsize];
+    failed = (queue[i].rawbuf == NULL);
+#endif  // RAWBUF_COMPRESSION
+    queue[i].rawlen = 0;
+    queue[i].overflow = false;
+    if (failed) {
+      // Allocation failed part way. Free what we got & give up.
+      for (uint8_t j = 0; j <= i; j++) {
+        delete[] queue[j].rawbuf;
+#if RAWBUF_COMPRESSION
+        delete[] queue[j].nibbles;
+#endif  // RAWBUF_COMPRESSION
+      }
+      delete[] queue;
+      return false;
+    }
+  }
+  framequeue_decodebuf = new uint16_t[irparams.bufsize];
+  if (framequeue_decodebuf == NULL) {
+    for (uint8_t i = 0; i < slots; i++) {
+      delete[] queue[i].rawbuf;
+#if RAWBUF_COMPRESSION
+      delete[] queue[i].nibbles;
+#endif  // RAWBUF_COMPRESSION
+    }
+    delete[] queue;
+    return false;
+  }
+#if RAWBUF_COMPRESSION
+  framequeue_compress = compress;
+#endif  // RAWBUF_COMPRESSION
+  uint32_t slotbytes = (uint32_t)irparams.bufsize * sizeof(uint16_t);
+#if RAWBUF_COMPRESSION
+  if (compress) slotbytes = irparams.bufsize / 2 + 2;
+#endif  // RAWBUF_COMPRESSION
+  irMemRecordAlloc(slots * sizeof(irframe_t) + slots * slotbytes +
+                   (uint32_t)irparams.bufsize * sizeof(uint16_t));
+  framequeue = queue;
+  framequeue_owner = this;
+  framequeue_size = slots;  // Queue is now live.
+  return true;
+}
+
+#if COMPACT_RAWBUF
+// Switch the live capture buffer to (or from) the compact 8-bit format,
+// halving its memory. Entries are stored as single bytes in kCompactTick
+// (16 uSec) units; the rare durations too long for that (e.g. inter-message
+// gaps) are kept exact as kCompactEscape + a 16 bit value, costing 3 bytes.
+// decode() inflates the stream into the save buffer & decodes from that, so
+// the decoders themselves are untouched.
+// Requires the save-buffer mode. (i.e. Constructed with save_buffer = true)
+// Call before enableIRIn(). Not compatible with the frame queue, nor
+// caller-provided buffers.
+//
+// Args:
+//   on: Use the compact format?
+// Returns:
+//   A boolean indicating success. i.e. false if the prerequisites aren't
+//   met, or on memory allocation failure.
+bool IRrecv::setCompactBuffer(bool on) {
+  if (on == (bool)irparams.compact) return true;  // Nothing to change.
+  if ((framequeue_size && framequeue_owner == this) || _extern_buffers)
+    return false;
+  if (on && irparams_save == NULL) return false;
+  // Swap the live buffer for one of the right size for the new format.
+  // Compact mode needs bufsize *bytes*; classic needs bufsize entries.
+  uint16_t newwords = on ? (irparams.bufsize + 1) / 2 : irparams.bufsize;
+  uint16_t *newbuf = new uint16_t[newwords];
+  if (newbuf == NULL) return false;
+  uint16_t oldwords = on ? irparams.bufsize : (irparams.bufsize + 1) / 2;
+#if IRMEM_STATS
+  if (_rawbuf_static) {
+    heap_fallback_used = false;  // Release our claim on the fallback buffer.
+    _rawbuf_static = false;
+  } else
+#endif  // IRMEM_STATS
+  {
+    irMemRecordFree((uint32_t)oldwords * sizeof(uint16_t));
+    delete[] irparams.rawbuf;
+  }
+  irMemRecordAlloc((uint32_t)newwords * sizeof(uint16_t));
+  irparams.rawbuf = newbuf;
+  irparams.compact = on;
+  irparams.rawlen = 0;
+  irparams.rawbytes = 0;
+  irparams.overflow = false;
+  return true;
+}
+#endif  // COMPACT_RAWBUF
+
+// Consume the oldest completed capture from the frame queue, if there is one,
+// and point the results at it.
+//
+// Args:
+//   results:  A pointer to where the capture's buffer details will be stored.
+// Returns:
+//   A boolean indicating if a capture was waiting in the queue or not.
+bool IR_FLASH_ATTR IRrecv::popFrame(decode_results *results) {
+  if (framequeue_tail == framequeue_head) return false;  // The queue is empty.
+  volatile irframe_t *frame = &framequeue[framequeue_tail];
+  uint16_t rawlen = frame->rawlen;
+  bool overflow = frame->overflow;
+  uint16_t *buf;
+#if RAWBUF_COMPRESSION
+  if (framequeue_compress) {
+    // Compressed mode. Expand the slot's nibble codes into the decode buffer
+    // *before* releasing the slot back to the interrupt handler.
+    buf = framequeue_decodebuf;
+    uint16_t nibble = 0;
+    for (uint16_t i = 0; i < rawlen; i++) {
+      uint8_t code = frame_nibble(frame->nibbles, nibble++);
+      if (code == kFrameDictEscape) {  // A raw (non-dictionary) duration.
+        uint16_t usecs = 0;
+        for (uint8_t j = 0; j < 4; j++)
+          usecs = (usecs << 4) | frame_nibble(frame->nibbles, nibble++);
+        buf[i] = usecs;
+      } else {
+        buf[i] = frame->dict[code];
+      }
+    }
+  } else {
+#endif  // RAWBUF_COMPRESSION
+    // Trade the slot's buffer for our spare decode buffer, so the interrupt
+    // handler can refill the slot while we are still decoding the capture.
+    buf = frame->rawbuf;
+    frame->rawbuf = framequeue_decodebuf;
+    framequeue_decodebuf = buf;
+#if RAWBUF_COMPRESSION
+  }
+#endif  // RAWBUF_COMPRESSION
+  uint8_t next = framequeue_tail + 1;
+  if (next >= framequeue_size) next = 0;
+  framequeue_tail = next;  // Release the slot back to the interrupt handler.
+  // An overflowed slot is completely full; sacrifice its final entry (it
+  // borders the lost data) so the trailing-entry handling stays in-bounds,
+  // like the non-queued path does.
+  if (overflow && rawlen >= irparams.bufsize) rawlen = irparams.bufsize - 1;
+  // Clear the trailing (junk) entry, like the non-queued path does.
+  if (rawlen < irparams.bufsize) buf[rawlen] = 0;
+  // The queue's slots can't be resized, but the high-water mark report
+  // should still cover their traffic. (See getBufHighWaterMark())
+  if (rawlen > _bufsize_highwater) _bufsize_highwater = rawlen;
+  results->rawbuf = buf;
+  results->rawlen = rawlen;
+  results->overflow = overflow;
+  return true;
+}
+
+// initialization
+void IRrecv::enableIRIn() {
+  // initialize state machine variables
+  resume();
+
+#ifndef UNIT_TEST
+  IR_PROFILE_INIT();  // Set up the profiling pin, if one is configured.
+#if defined(ESP32)
+  // Let the RMT peripheral capture the mark/space durations in hardware.
+  // Zero ISR cpu cost & immune to WiFi/interrupt latency jitter.
+  rmt_config_t config;
+  config.rmt_mode = RMT_MODE_RX;
+  config.channel = (rmt_channel_t)_rmt_channel;
+  config.gpio_num = (gpio_num_t)irparams.recvpin;
+  config.mem_block_num = 4;
+  config.clk_div = kRmtClkDiv;  // i.e. 1 uSec per RMT duration tick.
+  // Filter out pulses the GPIO interrupt capture couldn't even see.
+  config.rx_config.filter_en = true;
+  config.rx_config.filter_ticks_thresh = 255;  // In APB ticks. (Max, ~3 uSecs)
+  // Stop the capture after `timeout` of no signal, just like read_timeout().
+  config.rx_config.idle_threshold = (uint16_t)std::min(
+      (uint32_t)MS_TO_USEC(irparams.timeout), (uint32_t)UINT16_MAX);
+  rmt_config(&config);
+  rmt_driver_install((rmt_channel_t)_rmt_channel,
+                     irparams.bufsize * sizeof(rmt_item32_t), 0);
+  rmt_get_ringbuf_handle((rmt_channel_t)_rmt_channel,
+                         (RingbufHandle_t *)&_rmt_ringbuf);
+  rmt_rx_start((rmt_channel_t)_rmt_channel, true);
+#else  // ESP32
+  // Claim an interrupt trampoline/timer slot for this receiver.
+  int8_t slot = -1;
+  for (uint8_t i = 0; i < kMaxIrReceivers; i++) {
+    if (receivers[i] == this) {  // Already enabled. Just reuse our slot.
+      slot = i;
+      break;
+    }
+    if (slot < 0 && receivers[i] == NULL) slot = i;
+  }
+  if (slot < 0) return;  // Every slot is in use. i.e. Too many receivers.
+  _slot = slot;
+  _edge_start = 0;
+  receivers[slot] = this;
+
+  // Initialize timer. In lazy mode the timer stays untouched & free for the
+  // application; decode()/decodePoll() detect end-of-frame instead.
+  if (!_lazy_timeout) {
+    os_timer_disarm(&timers[slot]);
+    os_timer_setfn(&timers[slot],
+                   reinterpret_cast<os_timer_func_t *>(read_timeout), this);
+  }
+
+  // Attach Interrupt
+  attachInterrupt(irparams.recvpin, slot ? gpio_intr1 : gpio_intr0, CHANGE);
+#endif  // ESP32
+#endif  // UNIT_TEST
+}
+
+void IRrecv::disableIRIn() {
+#ifndef UNIT_TEST
+#if defined(ESP32)
+  rmt_rx_stop((rmt_channel_t)_rmt_channel);
+  rmt_driver_uninstall((rmt_channel_t)_rmt_channel);
+  _rmt_ringbuf = NULL;
+#else  // ESP32
+  if (receivers[_slot] == this) {
+    if (!_lazy_timeout) os_timer_disarm(&timers[_slot]);
+    detachInterrupt(irparams.recvpin);
+    receivers[_slot] = NULL;  // Release our trampoline/timer slot.
+  }
+#endif  // ESP32
+#endif  // UNIT_TEST
+}
+
+// Temporarily stop capturing, without the teardown disableIRIn() does.
+// Just the edge interrupt is masked; the trampoline/timer slot, the timer
+// callback registration & all the buffers stay intact, so a later
+// resumeIRIn() is nearly free. Intended for duty-cycled listening (e.g.
+// battery nodes that listen a few tens of msecs per second), where a full
+// disableIRIn()/enableIRIn() round trip per cycle is needless work.
+// Harmless if the receiver isn't currently enabled.
+void IRrecv::pauseIRIn() {
+#ifndef UNIT_TEST
+#if defined(ESP32)
+  // The RMT peripheral equivalent: stop the capture, keep the driver.
+  rmt_rx_stop((rmt_channel_t)_rmt_channel);
+#else  // ESP32
+  if (receivers[_slot] != this) return;  // Not enabled. Nothing to pause.
+  if (!_lazy_timeout) os_timer_disarm(&timers[_slot]);
+  detachInterrupt(irparams.recvpin);  // i.e. Mask our GPIO interrupt.
+#endif  // ESP32
+#endif  // UNIT_TEST
+}
+
+// Restart capturing after a pauseIRIn(). Any frame that was mid-capture
+// when we paused is abandoned. Only valid after enableIRIn() has claimed
+// its slot; harmless otherwise.
+void IRrecv::resumeIRIn() {
+#ifndef UNIT_TEST
+#if defined(ESP32)
+  rmt_rx_start((rmt_channel_t)_rmt_channel, true);
+#else  // ESP32
+  if (receivers[_slot] != this) return;  // enableIRIn() hasn't run.
+  resume();  // Don't decode a frame half-captured before the pause.
+  _edge_start = 0;
+  if (digitalRead(irparams.recvpin) == LOW) {
+    // The pin is already active, i.e. we're resuming inside a mark. Most
+    // likely it's the very mark whose leading edge woke us from light
+    // sleep. (See enableIRWake()) Seed the capture as if that edge had
+    // been seen, so the mark/space parity of the entries stays right & the
+    // mark's remainder is recorded, instead of the whole frame shifting by
+    // one entry & becoming undecodable.
+    irparams.rawbuf[0] = 1;  // The usual dummy first entry.
+    irparams.rawlen = 1;
+    irparams.rcvstate = kMarkState;
+    _edge_start = system_get_time();
+    // Let decode() know this capture's opening mark is truncated.
+    if (_wake_assist) _wake_recovery = true;
+  }
+  attachInterrupt(irparams.recvpin, _slot ? gpio_intr1 : gpio_intr0, CHANGE);
+#endif  // ESP32
+#endif  // UNIT_TEST
+}
+
+// Arm a GPIO wake on the receive pin, so the device can light-sleep while
+// listening: the first edge of an incoming mark wakes it, & a prompt
+// resumeIRIn() then captures the rest of the message. Expected flow:
+//   pauseIRIn(); enableIRWake(); <enter light sleep>; resumeIRIn();
+// The wake latency eats the front of that first mark (& any whole frame
+// is lost if the sleep entry raced it), so pair this with setWakeAssist()
+// to still recognise what tolerantly can be. The actual sleep entry is
+// the application's business; we only arm the wake source.
+void IRrecv::enableIRWake() {
+#ifndef UNIT_TEST
+#if defined(ESP32)
+  gpio_wakeup_enable((gpio_num_t)irparams.recvpin, GPIO_INTR_LOW_LEVEL);
+  esp_sleep_enable_gpio_wakeup();
+#else  // ESP32
+  // Demodulating IR receivers idle high & pull low for a mark.
+  gpio_pin_wakeup_enable(GPIO_ID_PIN(irparams.recvpin),
+                         GPIO_PIN_INTR_LOLEVEL);
+#endif  // ESP32
+#endif  // UNIT_TEST
+}
+
+// Measure the modulation (carrier) frequency of an incoming IR signal.
+// Needs an *unfiltered* (TSMP-style, e.g. TSMP58000) receiver module on
+// `pin`, whose output follows the raw carrier cycles rather than the
+// demodulated envelope a normal (TSOP-style) receiver produces. i.e. A
+// second, dedicated pin - NOT the normal receive pin.
+// Busy-polls the pin for the whole window, timing the edge-to-edge
+// intervals inside the carrier bursts & averaging them into a frequency.
+// Intervals longer than kCarrierMeasureMaxGapUsecs are the spaces between
+// marks (or silence) & are excluded from the average.
+// Hold a button down on the remote under test while calling this.
+//
+// Args:
+//   pin: The GPIO the unfiltered receiver's output is connected to.
+//   window_ms: How long to sample for. (Default: kCarrierMeasureWindowMs)
+// Returns:
+//   The measured carrier frequency in Hz. e.g. circa 38000 or 56000.
+//   0 if no carrier was seen in the window.
+//
+// Status: BETA / Believed working on both platforms.
+//
+// Note:
+//   The result feeds straight into IRsend::enableIROut() or a sendGeneric()
+//   style frequency argument, so a site can verify (or auto-correct) that
+//   what it transmits matches the receiver hardware it was paired with.
+uint32_t IRrecv::measureCarrierFreq(const uint16_t pin,
+                                    const uint16_t window_ms) {
+#ifdef UNIT_TEST
+  (void)pin;
+  (void)window_ms;
+  return 0;  // No hardware to measure in a test build.
+#else  // UNIT_TEST
+  pinMode(pin, INPUT);
+  uint32_t burst_usecs = 0;  // Time spent inside carrier bursts.
+  uint32_t intervals = 0;    // Nr. of edge-to-edge intervals in them.
+  bool last_level = digitalRead(pin);
+  const uint32_t start = micros();
+  uint32_t last_edge = start;
+  while (micros() - start < window_ms * 1000UL) {
+    bool level = digitalRead(pin);
+    if (level == last_level) continue;  // No edge yet. Keep polling.
+    uint32_t now = micros();
+    uint32_t width = now - last_edge;
+    last_level = level;
+    last_edge = now;
+    if (width <= kCarrierMeasureMaxGapUsecs) {  // Still inside a burst.
+      burst_usecs += width;
+      intervals++;
+    }
+  }
+  if (intervals < kCarrierMeasureMinEdges || burst_usecs == 0)
+    return 0;  // Not enough edges to have been a real transmission.
+  // Each interval is half a carrier cycle. i.e. freq = intervals / 2 / time.
+  return (uint64_t)intervals * 500000ULL / burst_usecs;
+#endif  // UNIT_TEST
+}
+
+// Disarm the GPIO wake set up by enableIRWake().
+void IRrecv::disableIRWake() {
+#ifndef UNIT_TEST
+#if defined(ESP32)
+  gpio_wakeup_disable((gpio_num_t)irparams.recvpin);
+#else  // ESP32
+  gpio_pin_wakeup_disable();
+#endif  // ESP32
+#endif  // UNIT_TEST
+}
+
+// Enable (or disable) lost-header recovery for wake-assisted captures.
+// The first capture after a mid-mark resumeIRIn() has a truncated opening
+// mark, so header-strict decoding fails even though the rest of the frame
+// was captured fine. With this on, decode() makes one extra attempt on
+// exactly that capture, accepting frames whose shape is unambiguous
+// without the header's full length. Currently that means the NEC repeat
+// frame - the main thing a duty-cycled/sleepy node needs to not lose, as
+// a held button produces a stream of them & only the first full frame
+// carries the data. Off by default.
+//
+// Args:
+//   on: Whether to enable the recovery mode. (Default: true)
+void IRrecv::setWakeAssist(const bool on) {
+  _wake_assist = on;
+  if (!on) _wake_recovery = false;
+}
+
+// Enable (or disable) early acceptance for protocols that transmit their
+// message multiple times back-to-back. With this on, such a decoder stops
+// at the earliest point the message can be self-verified & skips the
+// remaining copies: Kelvinator accepts its first frame once that frame's
+// own checksum validates (the result then carries just that frame, i.e. 64
+// bits), & Carrier accepts after the first data+inverse pair confirms (it
+// has no checksum, so one inverted copy is the earliest check possible).
+// This roughly halves the decode work & lets a capture that was split by
+// the inter-frame gap/timeout still produce a result, at the cost of the
+// extra end-to-end redundancy the repeats provide. Off by default.
+//
+// Args:
+//   on: Whether to enable the mode. (Default: true)
+void IRrecv::setSingleFrameAccept(const bool on) { _single_frame = on; }
+
+#if DECODE_RC5 || DECODE_RC6
+// Enable (or disable) toggle-bit tracking for the RC-5/RC-6 family.
+// Those protocols flip a toggle bit on each new button press & repeat the
+// frame unchanged (toggle included) while the button is held, so with this
+// on, results->repeat distinguishes a held button (true) from a fresh
+// press (false) without the application re-deriving it from the value.
+// With `coalesce` also set, the held repeats (RC-5 remotes emit roughly 9
+// a second) aren't surfaced at all: decode() swallows them & counts them
+// instead, see getToggleRepeats(). Off by default.
+//
+// Args:
+//   on: Whether to track the toggle bit. (Default: true)
+//   coalesce: Also swallow & count unchanged-toggle repeats.
+//             (Default: false)
+void IRrecv::setToggleTracking(const bool on, const bool coalesce) {
+  _toggle_track = on;
+  _toggle_coalesce = on && coalesce;
+  _toggle_prev_type = UNKNOWN;  // Forget any tracked press.
+  _toggle_repeats = 0;
+}
+
+// How many unchanged-toggle (held button) frames have been coalesced since
+// the last result decode() surfaced. i.e. For how long the button has been
+// held, in frames. Only counts while setToggleTracking(true, true) is set.
+uint16_t IRrecv::getToggleRepeats(void) { return _toggle_repeats; }
+#endif  // DECODE_RC5 || DECODE_RC6
+
+#if !defined(UNIT_TEST) && !defined(ESP32)
+// Enable (or disable) lazy (i.e. timer-free) capture finalization.
+// Normally the edge interrupt re-arms an OS timer on every single edge, so
+// the timer callback can declare the capture complete `timeout` msecs after
+// the last one. That's two os_timer_*() calls of overhead per edge & it
+// monopolises one of the (scarce) OS timers. In lazy mode the interrupt
+// handler just timestamps the edge, & decode()/decodePoll() notice the
+// frame is complete by comparing that timestamp against the timeout. This
+// trims the per-edge interrupt work & leaves the timer slot free for the
+// application.
+// The trade-off: a completed capture is only noticed when decode() or
+// decodePoll() is called, so call one of them often. (e.g. every loop())
+// Call before enableIRIn(). ESP8266 only; the ESP32 RMT peripheral already
+// detects end-of-frame in hardware.
+//
+// Args:
+//   on: true = lazy finalization. false = the classic timer. (Default: true)
+void IRrecv::setLazyTimeout(const bool on) { _lazy_timeout = on; }
+
+// Lazy-mode end-of-frame check. If the capture has been idle for at least
+// `timeout` msecs since its last edge, finalize it exactly as the timer
+// callback would have. See setLazyTimeout().
+void IRrecv::pollTimeout() {
+  if (!_lazy_timeout) return;
+  bool expired = false;
+  os_intr_lock();
+  if (irparams.rawlen && irparams.rcvstate != kStopState) {
+    uint32_t now = system_get_time();
+    uint32_t start = _edge_start;
+    uint32_t elapsed = (now < start) ? UINT32_MAX - start + now : now - start;
+    expired = elapsed >= MS_TO_USEC((uint32_t)irparams.timeout);
+  }
+  os_intr_unlock();
+  // readTimeout() takes the interrupt lock itself, hence the tiny window
+  // here. It's benign: the line has already been quiet for a full timeout,
+  // so the capture can't still be mid-frame.
+  if (expired) readTimeout();
+}
+#endif  // !UNIT_TEST && !ESP32
+
+void IRrecv::resume() {
+  irparams.rcvstate = kIdleState;
+  irparams.rawlen = 0;
+  irparams.overflow = false;
+#if COMPACT_RAWBUF
+  irparams.rawbytes = 0;
+#endif  // COMPACT_RAWBUF
+  _stream_lastlen = 0;
+  _stream_triedlen = 0;
+}
+
+// Set the runtime match tolerance, i.e. the percentage window the timing
+// comparisons accept, for every decoder that doesn't pass an explicit
+// (protocol-tuned) tolerance of its own. The kTolerance (25%) default is
+// sized for the worst remotes & receiver modules in the wild; a fixed
+// install with a known-clean signal can run much narrower (e.g. 10%),
+// which rejects junk earlier (fewer deep false partial matches before a
+// decoder finally fails) & better separates timing-adjacent protocols.
+// Too narrow & genuine messages start failing to decode: back off if
+// decode reliability drops.
+//
+// Args:
+//   percent: The tolerance percentage. Values > 100 are clamped.
+//            (Default: kTolerance)
+void IRrecv::setTolerance(const uint8_t percent) {
+  _tolerance = std::min(percent, (uint8_t)100);
+}
+
+// Set (or clear) a per-protocol override of the runtime match tolerance.
+// Overrides win over the plain setTolerance() value whenever that
+// protocol's decoder is the one being attempted, so a single receiver can
+// e.g. run a narrow window for the one protocol it cares about while
+// leaving everything else at the default.
+//
+// Args:
+//   protocol: The protocol the override applies to.
+//   percent:  The tolerance percentage. Values > 100 are clamped.
+//             kUseDefTol removes the protocol's override.
+// Returns:
+//   A boolean. true if the override was set (or removed). false if the
+//   override table is full (kToleranceOverridesMax).
+bool IRrecv::setTolerance(const decode_type_t protocol,
+                          const uint8_t percent) {
+  uint8_t i;
+  for (i = 0; i < _tol_len; i++)
+    if (_tol_overrides[i].protocol == protocol) break;
+  if (percent == kUseDefTol) {  // Remove any existing override.
+    if (i < _tol_len) _tol_overrides[i] = _tol_overrides[--_tol_len];
+    return true;
+  }
+  if (i >= kToleranceOverridesMax) return false;  // Table is full.
+  _tol_overrides[i].protocol = protocol;
+  _tol_overrides[i].percent = std::min(percent, (uint8_t)100);
+  if (i == _tol_len) _tol_len++;
+  return true;
+}
+
+// Returns the current (non-override) runtime match tolerance percentage.
+uint8_t IRrecv::getTolerance(void) { return _tolerance; }
+
+// The tolerance percentage in effect right now: the active protocol's
+// override if one is registered, else the plain setTolerance() value.
+// The active protocol is maintained by the decode dispatch, so the match
+// primitives resolve their kUseDefTol default through here.
+uint8_t IRrecv::activeTolerance(void) {
+  for (uint8_t i = 0; i < _tol_len; i++)
+    if (_tol_overrides[i].protocol == _tol_active)
+      return _tol_overrides[i].percent;
+  return _tolerance;
+}
+
+// Enable (or disable) the capture noise filter, & set its threshold.
+// Marks/spaces shorter than `min_pulse_usecs` are treated as electrical
+// glitches (e.g. from a nearby fluorescent ballast) & merged back into the
+// interval they interrupted, before any decoder sees the capture. Just a few
+// such glitches are enough to turn a clean frame into UNKNOWN, wasting the
+// entire decode chain (plus decodeHash()) on garbage.
+// Pick a threshold shorter than the shortest genuine mark/space of the
+// protocols you care about. (Most are >= 200 uSecs)
+//
+// Args:
+//   min_pulse_usecs: Minimum pulse width (in uSeconds) considered genuine
+//                    signal. 0 turns the filter off.
+//                    (Default: kNoiseFloorUsecs)
+void IRrecv::setNoiseFilter(uint16_t min_pulse_usecs) {
+  _noise_floor = min_pulse_usecs;
+}
+
+// Merge sub-threshold (i.e. noise) marks/spaces of a capture, in place, in
+// a single linear pass. A glitch splits what should have been one interval
+// into three (before / glitch / after), so folding the trio back into a
+// single interval undoes the damage exactly.
+//
+// Args:
+//   rawbuf: The capture buffer. In kRawTick units, with the usual dummy
+//           first entry.
+//   rawlen: Nr. of entries in use.
+// Returns:
+//   The new nr. of entries in use.
+uint16_t IR_FLASH_ATTR IRrecv::noiseReduce(uint16_t *rawbuf,
+                                           uint16_t rawlen) {
+  uint16_t min_ticks = _noise_floor / kRawTick;
+  uint16_t out = 1;  // Entry [0] is the usual dummy entry. Keep it.
+  for (uint16_t in = 1; in < rawlen; in++) {
+    if (rawbuf[in] < min_ticks) {
+      if (in + 1 >= rawlen) break;  // A trailing glitch. Just drop it.
+      if (out > 1) {
+        // A glitch mid-capture. Fold it & the interval after it into the
+        // interval before it, i.e. the single interval they had split.
+        uint32_t ticks = rawbuf[out - 1] + rawbuf[in] + rawbuf[in + 1];
+        rawbuf[out - 1] = std::min(ticks, (uint32_t)UINT16_MAX);
+      }
+      // Else it's a glitch before the message proper: drop it & the gap
+      // after it entirely.
+      in++;
+      continue;
+    }
+    rawbuf[out++] = rawbuf[in];
+  }
+  return out;
+}
+
+// Set an explicit decoder trial order. decode() will attempt these
+// protocols, in the order given, before consulting the header-timing
+// dispatch index or the full chain. A site dominated by one remote (e.g. a
+// single A/C brand) then decodes it on the very first attempt, every time.
+// Use getDecodeStats() to find out which protocols dominate yours.
+// Note: This only re-orders the trials, it never disables anything. See
+// setProtocolMask() for that.
+//
+// Args:
+//   protocols: The protocols to try first, most likely first.
+//   length:    Nr. of entries in protocols. Capped at kDecodePriorityMax.
+//              0 (with any pointer) clears the list.
+void IRrecv::setDecodePriority(const decode_type_t *protocols,
+                               const uint8_t length) {
+  _priority_len = std::min(length, kDecodePriorityMax);
+  for (uint8_t i = 0; i < _priority_len; i++) _priority[i] = protocols[i];
+}
+
+// Enable (or disable) adaptive decoder ordering: whatever protocol decoded
+// the previous message is tried first for the next one (i.e. move-to-front).
+// Most environments see the same remote(s) over & over, so this gets the
+// first-attempt hit rate of a hand-tuned setDecodePriority() list with zero
+// configuration. Runs in addition to (& ahead of) any explicit list.
+//
+// Args:
+//   on: Learn & re-use the last successful protocol? (Default: true)
+void IRrecv::setAdaptiveDecode(const bool on) {
+  _adaptive = on;
+  if (!on) _adaptive_last = UNKNOWN;  // Forget what was learnt.
+}
+
+// Register a pattern with the first-stage trigger filter.
+// Once any pattern is registered, decode() evaluates every capture against
+// the registered patterns in a single cheap pass *before* running any
+// decoder, & rejects captures that can't be one of them. This turns the
+// common reject path from a full decoder-chain run (milliseconds) into a
+// couple of timing compares &/or one FNV hash of the capture (tens of
+// micro-seconds), which matters a lot for battery-powered nodes that only
+// care about one or two specific codes.
+//
+// A capture is a candidate for a pattern if:
+//   * Its header timings are consistent with `protocol`. (Protocols
+//     without a header-index entry pass this check. UNKNOWN skips it.)
+//   * Its getCaptureHash() fingerprint equals `fingerprint`. (0 skips it.)
+// i.e. Register (NEC, 0) to wake on anything NEC-header-shaped, or
+// (NEC, fingerprint) to wake (almost) only on one specific button. Learn a
+// button's fingerprint by capturing it once & calling getCaptureHash().
+//
+// The filter is intentionally permissive: a candidate match still has to
+// survive the full decoder, so false positives only cost time, never
+// correctness. Use clearTriggerFilters() to turn the filter back off.
+//
+// Args:
+//   protocol: Protocol whose header timings the capture must have.
+//             UNKNOWN means any.
+//   fingerprint: getCaptureHash() value the capture must have. 0 means any.
+// Returns:
+//   A boolean. true if the pattern was registered. false if the table is
+//   full (kTriggerFiltersMax), or both args were wildcards.
+bool IRrecv::addTriggerFilter(const decode_type_t protocol,
+                              const uint32_t fingerprint) {
+  if (_trigger_len >= kTriggerFiltersMax) return false;  // Table is full.
+  if (protocol == UNKNOWN && !fingerprint) return false;  // Matches anything.
+  _triggers[_trigger_len].protocol = protocol;
+  _triggers[_trigger_len].fingerprint = fingerprint;
+  _trigger_len++;
+  return true;
+}
+
+// Forget all registered trigger patterns. i.e. Turn the filter off, so
+// every capture goes to the decoders again.
+void IRrecv::clearTriggerFilters(void) { _trigger_len = 0; }
+
+#if DECODE_MAGIQUEST
+// Register a MagiQuest wand ID with the registered-wand filter.
+// Once any ID is registered, decodeMagiQuest() aborts a decode as soon as
+// the 32 wand-ID bits have been assembled if the ID isn't one of the
+// registered ones, skipping the rest of the frame. Installations that only
+// care about a handful of known wands (e.g. interactive exhibits fielding
+// waves from every passing wand) avoid fully decoding all the foreign
+// traffic. Use clearMagiQuestWands() to turn the filter back off.
+//
+// Args:
+//   wand_id: The 32-bit wand ID to accept.
+// Returns:
+//   A boolean. true if the ID was registered. false if the table is full
+//   (kMagiQuestWandsMax).
+bool IRrecv::addMagiQuestWand(const uint32_t wand_id) {
+  if (_wands_len >= kMagiQuestWandsMax) return false;  // Table is full.
+  _wands[_wands_len++] = wand_id;
+  return true;
+}
+
+// Forget all registered wand IDs. i.e. Turn the filter off, so every wand
+// decodes again.
+void IRrecv::clearMagiQuestWands(void) { _wands_len = 0; }
+#endif  // DECODE_MAGIQUEST
+
+#if DECODE_HASH
+// Enable (or disable) the repeat-frame cache.
+// NEC-style protocols signal a held button with a special short repeat
+// frame, but most (especially A/C) remotes just re-send the full identical
+// frame. When enabled, decode() remembers the timing fingerprint (the FNV
+// hash from the decodeHash() machinery) & result of the last
+// kRepeatCacheEntries successful decodes: a capture whose fingerprint
+// matches returns the remembered result, flagged as a repeat, without
+// running a single decoder. Held-button streams thus cost one hash &
+// compare each, instead of a full decode.
+// Note: The fingerprint buckets similar timings together (that is what
+// makes it repeat-tolerant), so in theory two different messages could
+// collide. The window is just the last few messages, making that risk
+// mostly academic, but don't enable it if a stale-but-identical result
+// would be worse for you than the decode time saved.
+//
+// Args:
+//   on: Use the cache?
+void IRrecv::setRepeatCache(bool on) {
+  _repeatcache_on = on;
+  // Always start (or finish) with an empty cache.
+  _repeatcache_next = 0;
+  for (uint8_t i = 0; i < kRepeatCacheEntries; i++)
+    _repeatcache[i].fingerprint = 0;
+}
+
+// Set the duplicate-capture suppression window.
+// Most remotes transmit every button press 2-3 times in quick succession.
+// With a window set, decode() reports the first copy as normal, then
+// swallows any capture with an identical timing fingerprint (the same FNV
+// hash the repeat-frame cache uses, so the check costs one compare) seen
+// within `window_ms` milli-seconds of the previous copy. i.e. The caller
+// sees each distinct press once, instead of once per transmitted copy.
+//
+// Notes:
+//   Every suppressed copy restarts the window, so a held-down button stays
+//   suppressed until it has been released for `window_ms`. Choose a window
+//   a bit longer than your remote's inter-copy gap; 200-500ms suits most.
+//   A *different* message always gets through immediately.
+//
+// Args:
+//   window_ms: Suppression horizon in milli-seconds. 0 means report every
+//              copy. (The default)
+void IRrecv::setDedupWindow(const uint32_t window_ms) {
+  _dedup_window = window_ms;
+  _dedup_valid = false;  // Whatever comes next is "new".
+}
+
+// Is this (successfully decoded) capture a duplicate of the previous one,
+// inside the suppression window? Updates the window bookkeeping either way.
+// (See setDedupWindow())
+//
+// Args:
+//   results:  A pointer to the freshly decoded capture.
+// Returns:
+//   A boolean. true if the caller should suppress this result.
+bool IRrecv::dedupCheck(decode_results *results) {
+  if (!_dedup_window) return false;  // Suppression is off.
+  uint32_t fingerprint = getCaptureHash(results);
+  uint32_t now = _dedup_timer.elapsed();
+  bool duplicate = _dedup_valid && fingerprint == _dedup_fingerprint &&
+                   now - _dedup_last <= _dedup_window;
+  _dedup_fingerprint = fingerprint;
+  _dedup_last = now;
+  _dedup_valid = true;
+  return duplicate;
+}
+
+// Check the current capture against the repeat-frame cache.
+//
+// Args:
+//   results: Where the capture is, & where the remembered decode result is
+//            written on a hit.
+// Returns:
+//   A boolean indicating a cache hit. i.e. results is ready to use.
+bool IRrecv::repeatCacheLookup(decode_results *results) {
+  uint32_t fingerprint = getCaptureHash(results);
+  if (fingerprint == 0) return false;  // 0 doubles as the empty marker.
+  for (uint8_t i = 0; i < kRepeatCacheEntries; i++) {
+    if (_repeatcache[i].fingerprint != fingerprint) continue;
+    results->decode_type = _repeatcache[i].decode_type;
+    results->bits = _repeatcache[i].bits;
+    // value/address/command & state are a union. Only restore the side the
+    // protocol actually uses, or they'd overwrite each other.
+    if (hasACState(_repeatcache[i].decode_type)) {
+      for (uint16_t j = 0; j < kStateSizeMax; j++)
+        results->state[j] = _repeatcache[i].state[j];
+    } else {
+      results->value = _repeatcache[i].value;
+      results->address = _repeatcache[i].address;
+      results->command = _repeatcache[i].command;
+    }
+    results->repeat = true;  // An identical frame. i.e. A repeat.
+    return true;
+  }
+  return false;
+}
+
+// Remember a freshly decoded capture in the repeat-frame cache.
+//
+// Args:
+//   results: The capture & its (successful) decode result.
+void IRrecv::repeatCacheStore(decode_results *results) {
+  uint32_t fingerprint = getCaptureHash(results);  // Cached. i.e. Free here.
+  if (fingerprint == 0) return;  // 0 doubles as the empty marker.
+  irrepeat_t *slot = &_repeatcache[_repeatcache_next];
+  _repeatcache_next = (_repeatcache_next + 1) % kRepeatCacheEntries;
+  slot->fingerprint = fingerprint;
+  slot->decode_type = (decode_type_t)results->decode_type;
+  slot->bits = results->bits;
+  if (hasACState((decode_type_t)results->decode_type)) {
+    for (uint16_t j = 0; j < kStateSizeMax; j++)
+      slot->state[j] = results->state[j];
+  } else {
+    slot->value = results->value;
+    slot->address = results->address;
+    slot->command = results->command;
+  }
+}
+#endif  // DECODE_HASH
+
+#if defined(ESP32) && !defined(UNIT_TEST)
+// Drain any completed RMT hardware capture into the irparams raw buffer,
+// using the exact same layout gpio_intr() would have produced, so decode()
+// and all the decodeXxx() routines work unchanged.
+//
+// Returns:
+//   A boolean indicating if a complete message is waiting to be decoded.
+bool IRrecv::rmtPoll() {
+  if (irparams.rcvstate == kStopState)
+    return true;  // A previous capture hasn't been consumed yet.
+  if (_rmt_ringbuf == NULL) return false;  // Not enabled yet.
+  size_t length = 0;
+  rmt_item32_t *items = (rmt_item32_t *)xRingbufferReceive(
+      (RingbufHandle_t)_rmt_ringbuf, &length, 0);  // Don't block.
+  if (items == NULL) return false;  // Nothing captured yet.
+  length /= sizeof(rmt_item32_t);
+  // Mimic gpio_intr()'s first edge entry, then store the durations.
+  uint16_t rawlen = 0;
+  irparams.rawbuf[rawlen++] = 1;
+  for (size_t i = 0; i < length; i++) {
+    // Each item holds a mark (duration0) & a space (duration1) in uSecs,
+    // thanks to kRmtClkDiv. rawbuf however is in kRawTick units.
+    if (rawlen >= irparams.bufsize) {
+      irparams.overflow = true;
+      break;
+    }
+    irparams.rawbuf[rawlen++] = items[i].duration0 / kRawTick;
+    if (items[i].duration1 == 0) break;  // Idle timeout. End of the message.
+    if (rawlen >= irparams.bufsize) {
+      irparams.overflow = true;
+      break;
+    }
+    irparams.rawbuf[rawlen++] = items[i].duration1 / kRawTick;
+  }
+  vRingbufferReturnItem((RingbufHandle_t)_rmt_ringbuf, (void *)items);
+  irparams.rawlen = rawlen;
+  irparams.rcvstate = kStopState;
+  return true;
+}
+
+// Stack size for the dedicated decode task. decode() itself is modest, but
+// allow for the callback doing some formatting on top.
+const uint16_t kDecodeTaskStackSize = 4096;  // In bytes.
+
+// The dedicated decode task's main loop. Polls decode() & hands each
+// successful capture to the user's callback. See startDecodeTask().
+void IRrecv::decodeTaskLoop(void *arg) {
+  IRrecv *irrecv = (IRrecv *)arg;
+  decode_results results;
+  for (;;) {
+    if (irrecv->decode(&results)) {
+      // Honour any protocol filter registered via onDecode().
+      if (irrecv->_on_decode_filter == UNKNOWN ||
+          results.decode_type == irrecv->_on_decode_filter)
+        irrecv->_decode_callback(&results);
+      irrecv->resume();  // The callback is done with the capture. Rearm.
+    } else {
+      vTaskDelay(1);  // Nothing waiting. Give the core back for a tick.
+    }
+  }
+}
+
+// Start a dedicated FreeRTOS task that runs decode() & invokes `callback`
+// for every successfully decoded message. Pinning it to the other core from
+// the sketch's loop() (e.g. WiFi/MQTT work) removes decode latency spikes
+// entirely: the RMT peripheral captures in hardware & this task drains it
+// without loop() ever being involved.
+// Call after enableIRIn().
+//
+// Note: The callback runs in the decode task's context, not loop()'s, so
+// anything it shares with the rest of the sketch needs to be thread-safe.
+// The results pointer is only valid for the duration of the callback.
+//
+// Args:
+//   callback: Invoked (from the task) with each successful decode result.
+//   core: Which core to pin the task to. (Default: 1. i.e. Arduino's core)
+//   priority: FreeRTOS priority for the task. (Default: 1. i.e. Just above
+//             the idle task)
+// Returns:
+//   A boolean indicating if the task was started.
+bool IRrecv::startDecodeTask(void (*callback)(const decode_results *),
+                             uint8_t core, uint8_t priority) {
+  if (callback == NULL || _decode_task != NULL) return false;
+  _decode_callback = callback;
+  TaskHandle_t handle = NULL;
+  if (xTaskCreatePinnedToCore(decodeTaskLoop, "IRrecv", kDecodeTaskStackSize,
+                              this, priority, &handle,
+                              core % portNUM_PROCESSORS) != pdPASS)
+    return false;
+  _decode_task = handle;
+  return true;
+}
+
+// Stop (& delete) the dedicated decode task, if one is running.
+void IRrecv::stopDecodeTask() {
+  if (_decode_task == NULL) return;
+  vTaskDelete((TaskHandle_t)_decode_task);
+  _decode_task = NULL;
+  _decode_callback = NULL;
+}
+#endif  // ESP32 && !UNIT_TEST
+
+// Make a copy of the interrupt state & buffer data.
+// Needed because irparams is marked as volatile, thus memcpy() isn't allowed.
+// Only call this when you know the interrupt handlers won't modify anything.
+// i.e. In kStopState.
+//
+// Args:
+//   src: Pointer to an irparams_t structure to copy from.
+//   dst: Pointer to an irparams_t structure to copy to.
+void IRrecv::copyIrParams(volatile irparams_t *src, irparams_t *dst) {
+  // Typecast src and dst addresses to (char *)
+  char *csrc = (char *)src;  // NOLINT(readability/casting)
+  char *cdst = (char *)dst;  // NOLINT(readability/casting)
+
+  // Save the pointer to the destination's rawbuf so we don't lose it as
+  // the for-loop/copy after this will overwrite it with src's rawbuf pointer.
+  // This isn't immediately obvious due to typecasting/different variable names.
+  uint16_t *dst_rawbuf_ptr;
+  dst_rawbuf_ptr = dst->rawbuf;
+
+  // Copy contents of src[] to dst[]
+  for (uint16_t i = 0; i < sizeof(irparams_t); i++) cdst[i] = csrc[i];
+
+  // Restore the buffer pointer
+  dst->rawbuf = dst_rawbuf_ptr;
+
+  // Copy the rawbuf
+  for (uint16_t i = 0; i < dst->bufsize; i++) dst->rawbuf[i] = src->rawbuf[i];
+}
+
+// Swap the raw capture buffer between the interrupt state & a saved state,
+// rather than copying its contents like copyIrParams() does.
+// The interrupt handler is handed our old (already processed) buffer and we
+// take ownership of the freshly captured one. i.e. Classic double-buffering.
+// Zero copy & constant time, no matter how big the capture buffers are.
+// Only safe when both rawbuf's were allocated with the same bufsize. i.e. Only
+// use this with the internally created irparams_save, never a user-supplied
+// irparams_t, as we can't know how big their buffer allocation really is.
+//
+// Args:
+//   src: Pointer to an irparams_t structure to swap buffers with. (interrupt)
+//   dst: Pointer to an irparams_t structure to swap buffers with. (saved)
+void IRrecv::swapIrParams(volatile irparams_t *src, irparams_t *dst) {
+#if !defined(UNIT_TEST) && !defined(ESP32)
+  // Keep the interrupt handler away while the pointers are inconsistent.
+  // Not needed with the ESP32 RMT backend, as nothing asynchronous writes
+  // into rawbuf there.
+  os_intr_lock();
+#endif
+  uint16_t *dst_rawbuf_ptr = dst->rawbuf;
+  // Duplicate the small scalar state of the capture.
+  dst->recvpin = src->recvpin;
+  dst->rcvstate = src->rcvstate;
+  dst->timer = src->timer;
+  dst->bufsize = src->bufsize;
+  dst->rawlen = src->rawlen;
+  dst->overflow = src->overflow;
+  dst->timeout = src->timeout;
+  // Swap the buffers, instead of a (slow) copy of up to bufsize entries.
+  dst->rawbuf = src->rawbuf;
+  src->rawbuf = dst_rawbuf_ptr;
+#if !defined(UNIT_TEST) && !defined(ESP32)
+  os_intr_unlock();
+#endif
+}
+
+// Obtain the maximum number of entries possible in the capture buffer.
+// i.e. It's size.
+uint16_t IRrecv::getBufSize() { return irparams.bufsize; }
+
+// Enable adaptive capture-buffer sizing: if a capture overflows the buffer,
+// decode() grows it to the next size tier (double the current size, capped
+// at `max_bufsize`) before decoding, so a device converges on the size its
+// actual traffic needs instead of having a worst-case buffer provisioned up
+// front. The overflowed (truncated) capture itself is kept & decoded as
+// before; only messages arriving before the growth catches up to their
+// length stay truncated.
+// Growth needs library-owned heap buffers: it is skipped for caller-provided
+// buffers, the static fallback buffer & while a frame queue is active.
+// Use getBufHighWaterMark() to read back the largest capture observed. e.g.
+// To hand-provision the right size once it is known.
+//
+// Args:
+//   max_bufsize: The cap (in entries) growth may reach. 0 disables growth.
+void IRrecv::setAdaptiveBufSize(const uint16_t max_bufsize) {
+  _bufsize_max = max_bufsize;
+}
+
+// Obtain the largest capture (nr. of entries) seen so far, for tuning the
+// capture buffer provisioning. Note: An overflowed capture only counts the
+// entries that fit, so if overflows are still occurring the real traffic
+// needs more than this.
+uint16_t IRrecv::getBufHighWaterMark(void) { return _bufsize_highwater; }
+
+// Grow the capture buffer(s) to the next size tier, in response to an
+// overflowed capture. Does nothing if the buffers aren't library-owned
+// heap, a frame queue's slots are sized to the old bufsize, the cap has
+// been reached, or an allocation fails. (A truncated capture now & then
+// beats an exhausted heap.)
+// Only call from decode() while the capture state machine is stopped. i.e.
+// When nothing asynchronous is writing into rawbuf.
+// See setAdaptiveBufSize().
+void IRrecv::growCaptureBuf(void) {
+  if (_extern_buffers) return;  // We don't own the buffers. Can't resize.
+#if IRMEM_STATS
+  if (_rawbuf_static) return;  // The static fallback buffer can't grow.
+#endif  // IRMEM_STATS
+  if (framequeue_size && framequeue_owner == this) return;
+  // The next size tier: double the current size, up to the cap.
+  uint32_t grown = (uint32_t)irparams.bufsize * 2;
+  uint16_t newsize = (grown > _bufsize_max) ? _bufsize_max : grown;
+  if (newsize <= irparams.bufsize) return;  // Already at (or past) the cap.
+  // Compact mode stores bufsize *bytes* in the live buffer; classic mode
+  // (& the save buffer, always) bufsize entries.
+  uint16_t oldwords = irparams.bufsize;
+  uint16_t newwords = newsize;
+#if COMPACT_RAWBUF
+  if (irparams.compact) {
+    oldwords = (irparams.bufsize + 1) / 2;
+    newwords = (newsize + 1) / 2;
+  }
+#endif  // COMPACT_RAWBUF
+  uint16_t *newbuf = new uint16_t[newwords];
+  if (newbuf == NULL) return;  // No heap for it. Keep limping along as-is.
+  uint16_t *newsave = NULL;
+  if (irparams_save != NULL) {
+    // The save buffer must stay the same size as the live one, as decode()
+    // swaps the two. (See swapIrParams())
+    newsave = new uint16_t[newsize];
+    if (newsave == NULL) {  // All or nothing.
+      delete[] newbuf;
+      return;
+    }
+  }
+  // Preserve the (truncated) capture that is awaiting decode.
+  for (uint16_t i = 0; i < oldwords; i++) newbuf[i] = irparams.rawbuf[i];
+  irMemRecordFree((uint32_t)oldwords * sizeof(uint16_t));
+  irMemRecordAlloc((uint32_t)newwords * sizeof(uint16_t));
+  delete[] irparams.rawbuf;
+  irparams.rawbuf = newbuf;
+  if (irparams_save != NULL) {
+    // Its contents (the previous capture) have already been processed.
+    irMemRecordFree((uint32_t)irparams.bufsize * sizeof(uint16_t));
+    irMemRecordAlloc((uint32_t)newsize * sizeof(uint16_t));
+    delete[] irparams_save->rawbuf;
+    irparams_save->rawbuf = newsave;
+    irparams_save->bufsize = newsize;
+  }
+  // Any decodePoll() snapshot is sized to the old bufsize. Drop it; it gets
+  // reallocated at the new size if polling continues.
+  if (_streambuf != NULL) {
+    irMemRecordFree((uint32_t)irparams.bufsize * sizeof(uint16_t));
+    delete[] _streambuf;
+    _streambuf = NULL;
+  }
+  irparams.bufsize = newsize;
+}
+
+#if DECODE_HASH
+// Set the minimum length we will consider for reporting UNKNOWN message types.
+void IRrecv::setUnknownThreshold(uint16_t length) {
+  unknown_threshold = length;
+}
+#endif  // DECODE_HASH
+
+// Set which protocols decode() is allowed to try, so e.g. a device that only
+// ever sees NEC & Samsung traffic can skip the rest of the decoders without
+// recompiling with different DECODE_* flags.
+// Disabled protocols are skipped in both the header-timing dispatch index and
+// the full decoder chain. All protocols are enabled by default.
+//
+// Args:
+//   bitmap: An array of kProtocolMaskWords x 64-bit words. Bit (protocol + 1)
+//           enables that decode_type_t. Bit 0 (i.e. UNKNOWN) governs the
+//           decodeHash() fall-back for unrecognised messages.
+void IRrecv::setProtocolMask(const uint64_t *bitmap) {
+  for (uint16_t i = 0; i < kProtocolMaskWords; i++)
+    _protocolmask[i] = bitmap[i];
+  if (_adaptive_timeout) recalcTimeout();
+}
+
+// Allow decode() to try the given protocol. See setProtocolMask().
+void IRrecv::enableProtocol(const decode_type_t protocol) {
+  if (protocol < UNKNOWN || protocol > kLastDecodeType) return;
+  _protocolmask[(protocol + 1) / 64] |= 1ULL << ((protocol + 1) % 64);
+  if (_adaptive_timeout) recalcTimeout();
+}
+
+// Stop decode() from trying the given protocol. See setProtocolMask().
+void IRrecv::disableProtocol(const decode_type_t protocol) {
+  if (protocol < UNKNOWN || protocol > kLastDecodeType) return;
+  _protocolmask[(protocol + 1) / 64] &= ~(1ULL << ((protocol + 1) % 64));
+  if (_adaptive_timeout) recalcTimeout();
+}
+
+// Is decode() currently allowed to try the given protocol?
+bool IRrecv::isProtocolEnabled(const decode_type_t protocol) {
+  if (protocol < UNKNOWN || protocol > kLastDecodeType) return false;
+  return _protocolmask[(protocol + 1) / 64] & (1ULL << ((protocol + 1) % 64));
+}
+
+// The longest quiet period a single message of the protocol can contain,
+// expressed as the receive timeout (mSecs) needed to outlast it. A shorter
+// timeout declares the capture finished mid-message & the decode is lost.
+// The values are the protocol's longest in-frame space/gap plus ~25%
+// headroom. Errs big: too big only delays the result, too small loses
+// real decodes.
+//
+// Args:
+//   protocol: The protocol in question.
+// Returns:
+//   The minimum receive timeout (mSecs) the protocol needs.
+static uint8_t minTimeoutMsFor(const decode_type_t protocol) {
+  switch (protocol) {
+    case MITSUBISHI2:  // kMitsubishi2MinGap between the data halves.
+      return 36;
+    case CARRIER_AC:  // kCarrierAcGap between the three copies.
+      return 25;
+    case GREE:  // kGreeMsgSpace between the two blocks.
+      return 24;
+    case SAMSUNG_AC:  // kSamsungAcHdrSpace after the leader mark.
+      return 23;
+    case MITSUBISHI_AC:  // kMitsubishiAcRptSpace between the two frames.
+      return 22;
+    case PANASONIC_AC:  // kPanasonicAcSectionGap between the sections.
+      return 13;
+    // The other big gaps in the library (Haier, Lutron, MWM etc.) are
+    // message *footers*: the decoders accept them truncated, so they
+    // don't constrain the timeout.
+    default:
+      return kTimeoutAdaptiveFloorMs;
+  }
+}
+
+// Re-derive the receive timeout from the current protocol mask.
+// See setAdaptiveTimeout().
+void IRrecv::recalcTimeout(void) {
+  uint8_t needed = kTimeoutAdaptiveFloorMs;
+  for (int16_t p = 0; p <= kLastDecodeType; p++)
+    if (isProtocolEnabled((decode_type_t)p))
+      needed = std::max(needed, minTimeoutMsFor((decode_type_t)p));
+  irparams.timeout = std::min(needed, (uint8_t)kMaxTimeoutMs);
+}
+
+// Derive the receive timeout from the enabled protocols, instead of using
+// the fixed constructor value.
+// The timeout is pure latency: a capture only becomes visible to decode()
+// once the line has been quiet for that long, so every result arrives
+// `timeout` mSecs after its message actually ended. A safe-for-everything
+// setting (e.g. 90 mSecs for some aircon units) pays that on every single
+// message, even when the protocols actually in use finish their frames
+// quickly. With this mode on, the timeout becomes the largest in-frame
+// quiet period any *enabled* protocol can contain (see minTimeoutMsFor()),
+// floored at kTimeoutAdaptiveFloorMs. e.g. A mask trimmed to NEC & SAMSUNG
+// runs at 12 mSecs. It is re-derived automatically whenever the mask
+// changes.
+// Note: UNKNOWN (decodeHash()) messages can't be accounted for. If you
+//       rely on hash results from remotes with long mid-message gaps,
+//       keep the fixed timeout.
+// Note: On the ESP32, the RMT idle threshold is programmed from the
+//       timeout in enableIRIn(), so set the mask & call this before
+//       enableIRIn() for it to apply there.
+//
+// Args:
+//   on: Derive the timeout from the mask? Turning it off restores the
+//       constructor-supplied value.
+void IRrecv::setAdaptiveTimeout(const bool on) {
+  _adaptive_timeout = on;
+  if (on)
+    recalcTimeout();
+  else
+    irparams.timeout = _timeout_default;
+}
+
+// Obtain the receive timeout (mSecs) currently in effect.
+uint8_t IRrecv::getTimeout(void) { return irparams.timeout; }
+
+#if IRRECV_STATS
+// Record the outcome of a decode attempt in the statistics counters.
+// Called with UNKNOWN to record the overall (whole decode() call) figures.
+//
+// Args:
+//   protocol: Which decoder the attempt was for. UNKNOWN == overall total.
+//   success:  Did the attempt successfully decode?
+//   usecs:    How many uSeconds the attempt took.
+void IRrecv::statsRecord(const decode_type_t protocol, const bool success,
+                         const uint32_t usecs) {
+  if (protocol < UNKNOWN || protocol > kLastDecodeType) return;
+  decoder_stats_t *entry = &_stats[protocol + 1];
+  entry->attempts++;
+  if (success) entry->successes++;
+  entry->usecs += usecs;
+}
+
+// Obtain the decode statistics collected so far for a given protocol.
+//
+// Args:
+//   protocol: Which decoder to report on. Use UNKNOWN for the overall
+//             figures of the decode() calls themselves.
+// Returns:
+//   A decoder_stats_t with the attempt/success/uSecond counters. All zero
+//   for an out of range protocol.
+decoder_stats_t IRrecv::getDecodeStats(const decode_type_t protocol) {
+  if (protocol < UNKNOWN || protocol > kLastDecodeType) {
+    decoder_stats_t empty = {0, 0, 0};
+    return empty;
+  }
+  return _stats[protocol + 1];
+}
+
+// Reset all the decode statistics counters back to zero.
+void IRrecv::resetDecodeStats() {
+  for (uint16_t i = 0; i < kLastDecodeType + 2; i++) {
+    _stats[i].attempts = 0;
+    _stats[i].successes = 0;
+    _stats[i].usecs = 0;
+  }
+}
+#endif  // IRRECV_STATS
+
+// The header-timing dispatch index.
+// Maps the expected header mark/space of each protocol to its decoder, so
+// decode() can try just the decoders consistent with the start of the capture
+// before falling back to trying absolutely everything.
+// IMPORTANT: Entries *must* be in the same order as the full decode chain in
+//            decode() below, so the documented inter-protocol ordering
+//            requirements (e.g. Sanyo before NEC, Kelvinator before Gree)
+//            still hold when several entries match the same capture.
+// Note: The timing values are duplicates of the per-protocol constants which
+//       are local to their respective ir_*.cpp files. An entry that drifts
+//       out of sync only costs us the shortcut, not correctness, as the full
+//       chain is still tried on a miss.
+// Each entry's acceptance window is computed at compile time from the
+// nominal timings, using kHeaderIndexTolerance. (See header_index_t)
+// Minimum nr. of rawbuf entries before decodePoll() will attempt a decode of
+// an still-in-progress capture. i.e. A header + a dozen or so bits.
+const uint16_t kStreamDecodeMinRawlen = 24;
+static const header_index_t kHeaderIndex[] = {
+#if DECODE_AIWA_RC_T501
+    {AIWA_RC_T501, 8960, 4480},  // NEC-based. kNecHdrMark/kNecHdrSpace
+#endif
+#if DECODE_SANYO
+    {SANYO_LC7461, 9000, 4500},  // kSanyoLc7461HdrMark/Space
+#endif
+#if DECODE_CARRIER_AC
+    {CARRIER_AC, 8532, 4228},  // kCarrierAcHdrMark/Space
+#endif
+#if DECODE_PIONEER
+    {PIONEER, 8960, 4480},  // NEC-based. kNecHdrMark/kNecHdrSpace
+#endif
+#if DECODE_NEC
+    {NEC, 8960, 4480},  // kNecHdrMark/kNecHdrSpace
+    {NEC, 8960, 2240},  // kNecHdrMark/kNecRptSpace (repeat code)
+#endif
+#if DECODE_SONY
+    {SONY, 2400, 0},  // kSonyHdrMark. First space is data, so don't care.
+#endif
+#if DECODE_MITSUBISHI_AC
+    {MITSUBISHI_AC, 3400, 1750},  // kMitsubishiAcHdrMark/Space
+#endif
+#if DECODE_MITSUBISHI2
+    {MITSUBISHI2, 8400, 4200},  // kMitsubishi2HdrMark/Space
+#endif
+#if DECODE_RC6
+    {RC6, 2664, 888},  // kRc6HdrMark/Space
+#endif
+#if DECODE_RCMM
+    {RCMM, 416, 277},  // kRcmmHdrMark/Space
+#endif
+#if DECODE_FUJITSU_AC
+    {FUJITSU_AC, 3324, 1574},  // kFujitsuAcHdrMark/Space
+#endif
+#if DECODE_DENON
+    {DENON, 3456, 1728},  // 48-bit variant. kPanasonicHdrMark/Space
+    // Note: No entry for the legacy (kDenonHdrMark/Space) variant. Its
+    // "header" is just a bit-sized mark, whose window also swallows the
+    // opening bit of the header-less MITSUBISHI frames the chain must get
+    // to try first. It still decodes via the full chain.
+#endif
+#if DECODE_PANASONIC
+    {PANASONIC, 3456, 1728},  // kPanasonicHdrMark/Space
+#endif
+#if DECODE_LG
+    {LG, 8500, 4250},  // kLgHdrMark/Space
+    {LG, 4500, 4450},  // kLg32HdrMark/Space
+#endif
+#if DECODE_GICABLE
+    {GICABLE, 9000, 4400},  // kGicableHdrMark/Space
+#endif
+#if DECODE_JVC
+    {JVC, 8400, 4200},  // kJvcHdrMark/Space
+#endif
+#if DECODE_SAMSUNG
+    {SAMSUNG, 4480, 4480},  // kSamsungHdrMark/Space
+#endif
+#if DECODE_SAMSUNG36
+    {SAMSUNG36, 4480, 4480},  // kSamsungHdrMark/Space
+#endif
+#if DECODE_WHYNTER
+    {WHYNTER, 2850, 2850},  // kWhynterHdrMark/Space
+#endif
+#if DECODE_DISH
+    {DISH, 400, 6100},  // kDishHdrMark/Space
+#endif
+#if DECODE_COOLIX
+    {COOLIX, 4480, 4480},  // kCoolixHdrMark/Space
+#endif
+#if DECODE_NIKAI
+    {NIKAI, 4000, 4000},  // kNikaiHdrMark/Space
+#endif
+#if DECODE_KELVINATOR
+    {KELVINATOR, 9010, 4505},  // kKelvinatorHdrMark/Space
+#endif
+#if DECODE_DAIKIN
+    {DAIKIN, 3650, 1623},  // kDaikinHdrMark/Space
+#endif
+#if DECODE_DAIKIN2
+    {DAIKIN2, 10024, 25180},  // kDaikin2LeaderMark/Space
+#endif
+#if DECODE_DAIKIN216
+    {DAIKIN216, 3440, 1750},  // kDaikin216HdrMark/Space
+#endif
+#if DECODE_TOSHIBA_AC
+    {TOSHIBA_AC, 4400, 4300},  // kToshibaAcHdrMark/Space
+#endif
+#if DECODE_MIDEA
+    {MIDEA, 4480, 4480},  // kMideaHdrMark/Space
+#endif
+#if DECODE_GREE
+    {GREE, 9000, 4500},  // kGreeHdrMark/Space
+#endif
+#if DECODE_HAIER_AC
+    {HAIER_AC, 3000, 3000},  // kHaierAcHdr x2
+#endif
+#if DECODE_HAIER_AC_YRW02
+    {HAIER_AC_YRW02, 3000, 3000},  // kHaierAcHdr x2
+#endif
+#if DECODE_HITACHI_AC2
+    {HITACHI_AC2, 3300, 1700},  // kHitachiAcHdrMark/Space
+#endif
+#if DECODE_HITACHI_AC
+    {HITACHI_AC, 3300, 1700},  // kHitachiAcHdrMark/Space
+#endif
+#if DECODE_HITACHI_AC1
+    {HITACHI_AC1, 3400, 3400},  // kHitachiAc1HdrMark/Space
+#endif
+#if DECODE_WHIRLPOOL_AC
+    {WHIRLPOOL_AC, 8950, 4484},  // kWhirlpoolAcHdrMark/Space
+#endif
+#if DECODE_SAMSUNG_AC
+    {SAMSUNG_AC, 690, 17844},  // kSamsungAcHdrMark/Space
+#endif
+#if DECODE_ELECTRA_AC
+    {ELECTRA_AC, 9166, 4470},  // kElectraAcHdrMark/Space
+#endif
+#if DECODE_PANASONIC_AC
+    {PANASONIC_AC, 3456, 1728},  // kPanasonicHdrMark/Space
+#endif
+#if DECODE_VESTEL_AC
+    {VESTEL_AC, 3110, 9066},  // kVestelAcHdrMark/Space
+#endif
+#if DECODE_TCL112AC
+    {TCL112AC, 3000, 1650},  // kTcl112AcHdrMark/Space
+#endif
+#if DECODE_TECO
+    {TECO, 9000, 4440},  // kTecoHdrMark/Space
+#endif
+#if DECODE_LEGOPF
+    {LEGOPF, 158, 1026},  // kLegoPfBitMark/kLegoPfHdrSpace
+#endif
+#if DECODE_MITSUBISHIHEAVY
+    {MITSUBISHI_HEAVY_152, 3140, 1630},  // kMitsubishiHeavyHdrMark/Space
+    {MITSUBISHI_HEAVY_88, 3140, 1630},   // kMitsubishiHeavyHdrMark/Space
+#endif
+#if DECODE_SHARP_AC
+    {SHARP_AC, 3800, 1900},  // kSharpAcHdrMark/Space
+#endif
+#if DECODE_ARGO
+    {ARGO, 6400, 3300},  // kArgoHdrMark/Space
+#endif
+#if DECODE_TROTEC
+    {TROTEC, 5952, 7364},  // kTrotecHdrMark/Space
+#endif
+    // Protocols without a simple fixed header (e.g. RC5, Sharp, Lutron, MWM,
+    // Lasertag, MagiQuest, Mitsubishi TV) are handled by the full chain only.
+    {UNKNOWN, 0, 0},  // End of index marker. Must be last.
+};
+
+// Attempt a single protocol's decoder(s) against the current capture.
+// Used by the header-timing dispatch index in decode().
+// The calls here must mirror exactly what the full decode chain does for the
+// given protocol, including any multiple bit-length attempts.
+//
+// Args:
+//   protocol: The protocol to attempt to decode.
+//   results:  A pointer to where the decoded IR message will be stored.
+// Returns:
+//   A boolean indicating if the decode was successful or not.
+bool IRrecv::tryDecode(const decode_type_t protocol, decode_results *results) {
+  _tol_active = protocol;  // For the runtime-tolerance resolution.
+  switch (protocol) {
+#if DECODE_AIWA_RC_T501
+    case AIWA_RC_T501:
+      return decodeAiwaRCT501(results);
+#endif
+#if DECODE_SANYO
+    case SANYO_LC7461:
+      return decodeSanyoLC7461(results);
+#endif
+#if DECODE_CARRIER_AC
+    case CARRIER_AC:
+      return decodeCarrierAC(results);
+#endif
+#if DECODE_PIONEER
+    case PIONEER:
+      return decodePioneer(results);
+#endif
+#if DECODE_NEC
+    case NEC:
+      return decodeNEC(results);
+#endif
+#if DECODE_SONY
+    case SONY:
+      return decodeSony(results);
+#endif
+#if DECODE_MITSUBISHI_AC
+    case MITSUBISHI_AC:
+      return decodeMitsubishiAC(results);
+#endif
+#if DECODE_MITSUBISHI2
+    case MITSUBISHI2:
+      return decodeMitsubishi2(results);
+#endif
+#if DECODE_RC6
+    case RC6:
+      return decodeRC6(results);
+#endif
+#if DECODE_RCMM
+    case RCMM:
+      return decodeRCMM(results);
+#endif
+#if DECODE_FUJITSU_AC
+    case FUJITSU_AC:
+      return decodeFujitsuAC(results);
+#endif
+#if DECODE_DENON
+    case DENON:
+      return decodeDenonAll(results);
+#endif
+#if DECODE_PANASONIC
+    case PANASONIC:
+      return decodePanasonic(results);
+#endif
+#if DECODE_LG
+    case LG:
+      return decodeLGAll(results);
+#endif
+#if DECODE_GICABLE
+    case GICABLE:
+      return decodeGICable(results);
+#endif
+#if DECODE_JVC
+    case JVC:
+      return decodeJVC(results);
+#endif
+#if DECODE_SAMSUNG
+    case SAMSUNG:
+      return decodeSAMSUNG(results);
+#endif
+#if DECODE_SAMSUNG36
+    case SAMSUNG36:
+      return decodeSamsung36(results);
+#endif
+#if DECODE_WHYNTER
+    case WHYNTER:
+      return decodeWhynter(results);
+#endif
+#if DECODE_DISH
+    case DISH:
+      return decodeDISH(results);
+#endif
+#if DECODE_COOLIX
+    case COOLIX:
+      return decodeCOOLIX(results);
+#endif
+#if DECODE_NIKAI
+    case NIKAI:
+      return decodeNikai(results);
+#endif
+#if DECODE_KELVINATOR
+    case KELVINATOR:
+      return decodeKelvinator(results);
+#endif
+#if DECODE_DAIKIN
+    case DAIKIN:
+      return decodeDaikin(results);
+#endif
+#if DECODE_DAIKIN2
+    case DAIKIN2:
+      return decodeDaikin2(results);
+#endif
+#if DECODE_DAIKIN216
+    case DAIKIN216:
+      return decodeDaikin216(results);
+#endif
+#if DECODE_TOSHIBA_AC
+    case TOSHIBA_AC:
+      return decodeToshibaAC(results);
+#endif
+#if DECODE_MIDEA
+    case MIDEA:
+      return decodeMidea(results);
+#endif
+#if DECODE_GREE
+    case GREE:
+      return decodeGree(results);
+#endif
+#if DECODE_HAIER_AC
+    case HAIER_AC:
+      return decodeHaierAC(results);
+#endif
+#if DECODE_HAIER_AC_YRW02
+    case HAIER_AC_YRW02:
+      return decodeHaierACYRW02(results);
+#endif
+#if DECODE_HITACHI_AC2
+    case HITACHI_AC2:
+      return decodeHitachiAC(results, kHitachiAc2Bits);
+#endif
+#if DECODE_HITACHI_AC
+    case HITACHI_AC:
+      return decodeHitachiAC(results, kHitachiAcBits);
+#endif
+#if DECODE_HITACHI_AC1
+    case HITACHI_AC1:
+      return decodeHitachiAC(results, kHitachiAc1Bits);
+#endif
+#if DECODE_WHIRLPOOL_AC
+    case WHIRLPOOL_AC:
+      return decodeWhirlpoolAC(results);
+#endif
+#if DECODE_SAMSUNG_AC
+    case SAMSUNG_AC:
+      // Check the extended size first, as the chain does.
+      return decodeSamsungAC(results, kSamsungAcExtendedBits, false) ||
+             decodeSamsungAC(results, kSamsungAcBits);
+#endif
+#if DECODE_ELECTRA_AC
+    case ELECTRA_AC:
+      return decodeElectraAC(results);
+#endif
+#if DECODE_PANASONIC_AC
+    case PANASONIC_AC:
+      return decodePanasonicAC(results) ||
+             decodePanasonicAC(results, kPanasonicAcShortBits);
+#endif
+#if DECODE_VESTEL_AC
+    case VESTEL_AC:
+      return decodeVestelAc(results);
+#endif
+#if DECODE_TCL112AC
+    case TCL112AC:
+      return decodeTcl112Ac(results);
+#endif
+#if DECODE_TECO
+    case TECO:
+      return decodeTeco(results);
+#endif
+#if DECODE_LEGOPF
+    case LEGOPF:
+      return decodeLegoPf(results);
+#endif
+#if DECODE_MITSUBISHIHEAVY
+    case MITSUBISHI_HEAVY_152:
+      return decodeMitsubishiHeavy(results, kMitsubishiHeavy152Bits);
+    case MITSUBISHI_HEAVY_88:
+      return decodeMitsubishiHeavy(results, kMitsubishiHeavy88Bits);
+#endif
+#if DECODE_SHARP_AC
+    case SHARP_AC:
+      return decodeSharpAc(results);
+#endif
+#if DECODE_ARGO
+    case ARGO:
+      return decodeArgo(results);
+#endif
+#if DECODE_TROTEC
+    case TROTEC:
+      return decodeTrotec(results);
+#endif
+    default:
+      return false;
+  }
+}
+
+#if defined(IR_PROFILE_PIN) && !defined(UNIT_TEST)
+// Holds the profiling pin high for the lifetime of the enclosing scope, so
+// decode()'s many exit paths all drop it without needing a hook at each
+// return. (See the IR_PROFILE_* notes in IRremoteESP8266.h)
+struct IRProfileDecodeScope {
+  IRProfileDecodeScope() { IR_PROFILE_HIGH(); }
+  ~IRProfileDecodeScope() { IR_PROFILE_LOW(); }
+};
+#define IR_PROFILE_SCOPE() IRProfileDecodeScope ir_profile_scope
+#else  // IR_PROFILE_PIN && !UNIT_TEST
+#define IR_PROFILE_SCOPE()
+#endif  // IR_PROFILE_PIN && !UNIT_TEST
+
+// Decodes the received IR message.
+// If the interrupt state is saved, we will immediately resume waiting
+// for the next IR message to avoid missing messages.
+// Note: There is a trade-off here. Saving the state means less time lost until
+// we can receiving the next message vs. using more RAM. Choose appropriately.
+//
+// Args:
+//   results:  A pointer to where the decoded IR message will be stored.
+//   save:  A pointer to an irparams_t instance in which to save
+//          the interrupt's memory/state. NULL means don't save it.
+// Returns:
+//   A boolean indicating if an IR message is ready or not.
+bool IR_FLASH_ATTR IRrecv::decode(decode_results *results,
+                                  irparams_t *save) {
+  IR_PROFILE_SCOPE();  // Profiling pin high until we return, if configured.
+  bool resumed = false;  // Flag indicating if we have resumed.
+
+#if !defined(UNIT_TEST) && !defined(ESP32)
+  // Lazy (timer-free) end-of-frame detection, if enabled. This is what
+  // completes captures (incl. publishing them to the frame queue) when no
+  // OS timer is armed. See setLazyTimeout().
+  pollTimeout();
+#endif  // !UNIT_TEST && !ESP32
+  if (framequeue_size && framequeue_owner == this) {
+    // Frame-queued mode. Consume the oldest completed capture, if there is
+    // one. The capture never stops in this mode, so there is nothing to
+    // resume and the save buffer isn't involved.
+    if (!popFrame(results)) return false;
+    resumed = true;
+  } else {
+    // Proceed only if an IR message been received.
+#ifndef UNIT_TEST
+#if defined(ESP32)
+    // The RMT peripheral captures in hardware, so pull any completed capture
+    // into the raw buffer first.
+    if (!rmtPoll()) return false;
+#endif  // ESP32
+    if (irparams.rcvstate != kStopState) return false;
+#endif
+    // Adaptive buffer bookkeeping. The capture is complete & nothing is
+    // writing into rawbuf, so this is the one safe point to resize it.
+    // (See setAdaptiveBufSize())
+    if (irparams.rawlen > _bufsize_highwater)
+      _bufsize_highwater = irparams.rawlen;
+    if (irparams.overflow && _bufsize_max) growCaptureBuf();
+
+#if COMPACT_RAWBUF
+    if (irparams.compact) {
+      // Compact (8-bit) capture mode. Inflate the byte stream into the save
+      // buffer & decode from that. See setCompactBuffer().
+      if (save == NULL) save = irparams_save;
+      save->rawlen = compactInflate((volatile uint8_t *)irparams.rawbuf,
+                                    irparams.rawbytes, save->rawbuf,
+                                    irparams.bufsize);
+      save->overflow = irparams.overflow;
+      // As below: keep an overflowed capture's trailing entry in-bounds.
+      if (save->overflow && save->rawlen >= irparams.bufsize)
+        save->rawlen = irparams.bufsize - 1;
+      resume();  // It's now safe to rearm. The message has been copied out.
+      resumed = true;
+      results->rawbuf = save->rawbuf;
+      results->rawlen = save->rawlen;
+      results->overflow = save->overflow;
+    } else {
+#endif  // COMPACT_RAWBUF
+    // An overflowed capture fills the buffer completely, so its final entry
+    // borders the lost data & can't be decoded against anyway. Sacrifice it,
+    // keeping the cleared trailing entry (below) & the decoders' gap peeks
+    // at rawbuf[rawlen] inside the buffer. The complete message(s) at the
+    // front of the capture then get their normal decode attempt instead of
+    // the whole capture being unusable.
+    if (irparams.overflow && irparams.rawlen >= irparams.bufsize)
+      irparams.rawlen = irparams.bufsize - 1;
+    // Clear the entry we are currently pointing to when we got the timeout.
+    // i.e. Stopped collecting IR data.
+    // It's junk as we never wrote an entry to it and can only confuse decoding.
+    // This is done here rather than logically the best place in read_timeout()
+    // as it saves a few bytes of ICACHE_RAM as that routine is bound to an
+    // interrupt. decode() is not stored in ICACHE_RAM.
+    // Another better option would be to zero the entire irparams.rawbuf[] on
+    // resume() but that is a much more expensive operation compare to this.
+    irparams.rawbuf[irparams.rawlen] = 0;
+
+    // If we were requested to use a save buffer previously, do so.
+    if (save == NULL) save = irparams_save;
+
+    if (save == NULL) {
+      // We haven't been asked to copy it so use the existing memory.
+#ifndef UNIT_TEST
+      results->rawbuf = irparams.rawbuf;
+      results->rawlen = irparams.rawlen;
+      results->overflow = irparams.overflow;
+#endif
+    } else {
+      if (save == irparams_save)
+        // Our internal save buffer is interchangeable with the interrupt's
+        // buffer, so just swap the buffer pointers instead of copying the
+        // data.
+        swapIrParams(&irparams, save);
+      else
+        copyIrParams(&irparams, save);  // Duplicate the interrupt's memory.
+      resume();  // It's now safe to rearm. The IR message won't be overridden.
+      resumed = true;
+      // Point the results at the saved copy.
+      results->rawbuf = save->rawbuf;
+      results->rawlen = save->rawlen;
+      results->overflow = save->overflow;
+    }
+#if COMPACT_RAWBUF
+    }
+#endif  // COMPACT_RAWBUF
+  }
+
+  return decodeCapture(results, resumed);
+}
+
+// The decode pipeline proper, from a fully acquired capture (already
+// pointed to by results->rawbuf/rawlen) to a final verdict: noise scrub,
+// trigger filter, repeat fast paths, then the prioritised/header-indexed/
+// full decoder chain & the post-chain bookkeeping. Shared by decode() (ISR
+// captures) & decodeRaw() (caller-supplied buffers).
+//
+// Args:
+//   results: A pointer holding the capture, & where the decoded IR message
+//            will be stored.
+//   resumed: true if the capture no longer occupies the interrupt's buffer
+//            (or never did), i.e. there is nothing to resume() on failure.
+// Returns:
+//   A boolean indicating if the capture decoded successfully.
+bool IR_FLASH_ATTR IRrecv::decodeCapture(decode_results *results,
+                                         const bool resumed) {
+  // Whatever happens below, this capture consumes the wake-truncation
+  // grace: only the first capture after a mid-mark resumeIRIn() can have
+  // a wake-shortened header. (See setWakeAssist())
+#if DECODE_NEC
+  bool wake_recovery = _wake_recovery;
+#endif  // DECODE_NEC
+  _wake_recovery = false;
+
+  // Scrub any sub-threshold glitches out of the capture before spending
+  // decoder time on them. (See setNoiseFilter())
+  if (_noise_floor)
+    results->rawlen = noiseReduce(results->rawbuf, results->rawlen);
+
+  // A fresh capture starts with no decoder active, so any per-protocol
+  // tolerance override from a previous dispatch can't leak into the
+  // pre-dispatch stages below. (See activeTolerance())
+  _tol_active = UNKNOWN;
+
+  // Reset any previously partially processed results.
+  results->decode_type = UNKNOWN;
+  results->bits = 0;
+  results->value = 0;
+  results->address = 0;
+  results->command = 0;
+  results->repeat = false;
+#if DECODE_HASH
+  _hash_valid = false;  // A new capture, so invalidate the cached hash.
+#endif  // DECODE_HASH
+
+  // First-stage trigger filter. If the capture can't be one of the
+  // registered patterns, reject it here without running a single decoder.
+  // (See addTriggerFilter())
+  if (_trigger_len && !triggerMatch(results)) {
+    if (!resumed) resume();  // Throw the capture away and start over.
+    return false;
+  }
+
+#if IRRECV_STATS
+  IRtimer usecTimer = IRtimer();  // Time the entire decode attempt.
+#endif  // IRRECV_STATS
+
+#if DECODE_NEC
+  // Ultra-fast path for the NEC repeat frame. A held button on an NEC
+  // remote (i.e. most TVs) produces dozens of these per second, so the
+  // highest-volume capture gets answered with three timing compares,
+  // before any decoder trial. The 4-entry signature can't belong to
+  // anything else, & the checks are decodeNEC()'s own, so acceptance is
+  // identical.
+  _tol_active = NEC;  // So an NEC tolerance override applies here too.
+  if (results->rawlen == kNecRptLength &&
+      matchMark(results->rawbuf[kStartOffset], kNecHdrMark) &&
+      matchSpace(results->rawbuf[kStartOffset + 1], kNecRptSpace) &&
+      matchMark(results->rawbuf[kStartOffset + 2],
+                kNecBitMarkTicks * (results->rawbuf[kStartOffset] * kRawTick /
+                                    kNecHdrMarkTicks))) {
+    results->decode_type = NEC;
+    results->value = kRepeat;
+    results->bits = 0;
+    results->address = 0;
+    results->command = 0;
+    results->repeat = true;
+#if IRRECV_STATS
+    statsRecord(NEC, true, usecTimer.elapsed());
+#endif  // IRRECV_STATS
+#if DECODE_HASH
+    if (dedupCheck(results)) {  // A recent duplicate. Swallow it.
+      if (!resumed) resume();
+      return false;
+    }
+#endif  // DECODE_HASH
+    return true;
+  }
+#endif  // DECODE_NEC
+
+#if DECODE_HASH
+  // Is the capture identical to one of the last few decoded messages?
+  // i.e. A held button. Answer straight from the repeat-frame cache then,
+  // without running a single decoder. (See setRepeatCache())
+  if (_repeatcache_on && repeatCacheLookup(results)) {
+#if IRRECV_STATS
+    statsRecord(UNKNOWN, true, usecTimer.elapsed());
+#endif  // IRRECV_STATS
+    if (dedupCheck(results)) {  // A recent duplicate. Swallow it.
+      if (!resumed) resume();
+      return false;
+    }
+    return true;
+  }
+#endif  // DECODE_HASH
+
+  // Zeroth pass: anything the caller prioritised, plus the adaptively
+  // learnt last winner. See setDecodePriority() & setAdaptiveDecode().
+  if ((_priority_len || _adaptive) && tryPriority(results)) {
+#if IRRECV_STATS
+    statsRecord(UNKNOWN, true, usecTimer.elapsed());
+#endif  // IRRECV_STATS
+#if DECODE_HASH
+    if (_repeatcache_on) repeatCacheStore(results);
+#endif  // DECODE_HASH
+    if (_adaptive) _adaptive_last = (decode_type_t)results->decode_type;
+#if DECODE_HASH
+    if (dedupCheck(results)) {  // A recent duplicate. Swallow it.
+      if (!resumed) resume();
+      return false;
+    }
+#endif  // DECODE_HASH
+    return true;
+  }
+
+  // First pass: use the header-timing dispatch index to try only the decoders
+  // whose expected header is consistent with the start of the capture.
+  // This typically means a handful of decoder attempts instead of trialling
+  // the entire chain below. If nothing in the index matches (or decodes), we
+  // fall through to the full chain, so nothing is ever lost, just time saved.
+  if (tryHeaderIndex(results)) {
+#if IRRECV_STATS
+    statsRecord(UNKNOWN, true, usecTimer.elapsed());
+#endif  // IRRECV_STATS
+#if DECODE_HASH
+    if (_repeatcache_on) repeatCacheStore(results);
+#endif  // DECODE_HASH
+    if (_adaptive) _adaptive_last = (decode_type_t)results->decode_type;
+#if DECODE_HASH
+    if (dedupCheck(results)) {  // A recent duplicate. Swallow it.
+      if (!resumed) resume();
+      return false;
+    }
+#endif  // DECODE_HASH
+    return true;
+  }
+
+  // Nothing in the index matched (or decoded), so try the entire chain.
+#if IRRECV_STATS
+  IRtimer chainTimer = IRtimer();
+#endif  // IRRECV_STATS
+  bool success = tryFullChain(results);
+  if (_budget_out) {
+    // The decode budget expired mid-chain. Keep the capture as-is; the
+    // next decodeBudgeted() call resumes the chain walk where this one
+    // stopped. (See decodeBudgeted())
+    _budget_resumed = resumed;
+    return false;
+  }
+#if DECODE_NEC
+  // Lost-header recovery for a wake-assisted capture. (See setWakeAssist())
+  // The only plausible damage is a wake-shortened opening mark, so accept
+  // an NEC repeat frame whose other three entries all check out & whose
+  // opening mark is no *longer* than a real header mark. Unscaled timings,
+  // as a truncated header can't calibrate anything.
+  _tol_active = NEC;  // So an NEC tolerance override applies here too.
+  if (!success && wake_recovery && results->rawlen == kNecRptLength &&
+      results->rawbuf[kStartOffset] * kRawTick <= ticksHigh(kNecHdrMark) &&
+      matchSpace(results->rawbuf[kStartOffset + 1], kNecRptSpace) &&
+      matchMark(results->rawbuf[kStartOffset + 2], kNecBitMark)) {
+    results->decode_type = NEC;
+    results->value = kRepeat;
+    results->bits = 0;
+    results->address = 0;
+    results->command = 0;
+    results->repeat = true;
+    success = true;
+  }
+#endif  // DECODE_NEC
+#if IRRECV_STATS
+  if (success && results->decode_type != UNKNOWN)
+    // Attribute the winning decoder with the cost of the whole chain run,
+    // as that is what decoding this message actually cost us.
+    statsRecord((decode_type_t)results->decode_type, true,
+                chainTimer.elapsed());
+  statsRecord(UNKNOWN, success, usecTimer.elapsed());
+#endif  // IRRECV_STATS
+#if DECODE_HASH
+  if (success && _repeatcache_on) repeatCacheStore(results);
+#endif  // DECODE_HASH
+  // decodeHash() successes (i.e. UNKNOWN) aren't worth learning from.
+  if (success && _adaptive && results->decode_type != UNKNOWN)
+    _adaptive_last = (decode_type_t)results->decode_type;
+#if DECODE_HASH
+  // Suppress recent duplicate copies of a message, if asked to.
+  // (See setDedupWindow())
+  if (success && dedupCheck(results)) success = false;
+#endif  // DECODE_HASH
+#if DECODE_RC5 || DECODE_RC6
+  // Coalesce held-button (unchanged toggle bit) RC-5/RC-6 repeats into a
+  // counter, if asked to. (See setToggleTracking())
+  if (success && _toggle_coalesce && results->repeat &&
+      (results->decode_type == RC5 || results->decode_type == RC5X ||
+       results->decode_type == RC6)) {
+    _toggle_repeats++;
+    success = false;
+  }
+#endif  // DECODE_RC5 || DECODE_RC6
+  if (!success && !resumed)  // Check if we have already resumed.
+    resume();  // Throw the capture away and start over.
+  return success;
+}
+
+// Run the full decoder chain over a caller-supplied buffer of raw timings,
+// with no interrupt or capture hardware involved. This lets e.g. a gateway
+// node forward captures (results->rawbuf + results->rawlen, straight off
+// the wire) to a central box that does the actual decoding.
+//
+// The buffer entries are mark/space durations in kRawTick (2 usec) units,
+// i.e. exactly what decode_results::rawbuf holds, starting with the usual
+// dummy gap entry at index 0. A sender with timings in usec must halve them
+// first. The buffer is copied into an internal scratch buffer (allocated on
+// first use, grown as needed), so decoding never scribbles on the caller's
+// data & results->rawbuf stays valid after the call.
+//
+// Note: Injected captures go through the same receiver state as live ones:
+// the repeat cache, dedup window, adaptive ordering, etc. all see them.
+//
+// Args:
+//   buf:     The raw capture. (In kRawTick units. See above.)
+//   len:     Nr. of entries in buf.
+//   results: A pointer to where the decoded IR message will be stored.
+// Returns:
+//   A boolean indicating if the buffer decoded successfully.
+bool IRrecv::decodeRaw(const uint16_t *buf, const uint16_t len,
+                       decode_results *results) {
+  if (buf == NULL || results == NULL || len < 2) return false;
+  if (len + 1 > _injectsize) {  // (Re)allocate the scratch buffer.
+    if (_injectbuf != NULL) {
+      irMemRecordFree((uint32_t)_injectsize * sizeof(uint16_t));
+      delete[] _injectbuf;
+    }
+    // +1 for the zeroed trailing entry, matching what decode() guarantees
+    // to the decoders for an interrupt capture.
+    _injectsize = len + 1;
+    _injectbuf = new uint16_t[_injectsize];
+    if (_injectbuf == NULL) {
+      _injectsize = 0;
+      return false;
+    }
+    irMemRecordAlloc((uint32_t)_injectsize * sizeof(uint16_t));
+  }
+  for (uint16_t i = 0; i < len; i++) _injectbuf[i] = buf[i];
+  _injectbuf[len] = 0;
+  results->rawbuf = _injectbuf;
+  results->rawlen = len;
+  results->overflow = false;
+  // The interrupt's buffer isn't involved, so there is nothing to resume.
+  return decodeCapture(results, true);
+}
+
+// IRCompactResult ------------------------------------------------------
+
+IRCompactResult::IRCompactResult() {
+  _state = NULL;
+  clear();
+}
+
+IRCompactResult::~IRCompactResult() { clear(); }
+
+// Move construction/assignment: take over the other result's state buffer
+// (if any) & leave it empty.
+IRCompactResult::IRCompactResult(IRCompactResult &&other) {
+  _state = NULL;
+  *this = static_cast<IRCompactResult &&>(other);
+}
+
+IRCompactResult &IRCompactResult::operator=(IRCompactResult &&other) {
+  if (this != &other) {
+    clear();
+    decode_type = other.decode_type;
+    value = other.value;
+    bits = other.bits;
+    repeat = other.repeat;
+    _state = other._state;
+    other._state = NULL;
+    other.clear();
+  }
+  return *this;
+}
+
+// Discard any owned state & reset to the (empty) UNKNOWN result.
+void IRCompactResult::clear(void) {
+  delete[] _state;
+  _state = NULL;
+  decode_type = UNKNOWN;
+  value = 0;
+  bits = 0;
+  repeat = false;
+}
+
+// Load this result from a full decode_results.
+// For the byte-array protocols a right-sized copy of the state is made on
+// the heap, so this result stays valid after the capture buffer is reused.
+//
+// Args:
+//   results: Ptr to the decode_results to summarise.
+void IRCompactResult::loadFrom(const decode_results *results) {
+  clear();
+  decode_type = results->decode_type;
+  bits = results->bits;
+  repeat = results->repeat;
+  if (hasACState(results->decode_type)) {
+    uint16_t nbytes = (bits + 7) / 8;
+    _state = new uint8_t[nbytes];
+    for (uint16_t i = 0; i < nbytes; i++) _state[i] = results->state[i];
+  } else {
+    value = results->value;
+  }
+}
+
+// As decode(decode_results *, ...), but produces a compact result suitable
+// for cheap queueing. The full decode still happens internally; only the
+// bits a consumer typically wants survive into the result.
+//
+// Args:
+//   result: A pointer to the compact result to fill in.
+//   save:  A pointer to an irparams_t instance in which to save
+//          the interrupt's memory/state. NULL means don't save it.
+// Returns:
+//   A boolean indicating if an IR message is ready or not.
+bool IRrecv::decode(IRCompactResult *result, irparams_t *save) {
+  decode_results results;
+  if (!decode(&results, save)) return false;
+  result->loadFrom(&results);
+  return true;
+}
+
+// Attempt to decode a message whose capture may still be in progress.
+// Unlike decode(), this doesn't wait out the end-of-message gap (i.e. the
+// timeout, up to kMaxTimeoutMs): as soon as enough of the capture has arrived
+// for one of the header-indexed decoders to fully match, the result is
+// reported, removing the timeout from the perceived response latency.
+// Call it frequently, e.g. once per loop(). It falls back to the normal
+// decode() path whenever a completed capture is waiting, so it can be used
+// as a drop-in replacement for decode() in a polling loop.
+//
+// An attempt is only made when no new edges have arrived since the previous
+// call, i.e. the poll interval doubles as a short quiet-time check. Beware of
+// calling it extremely rapidly (i.e. well inside a single bit-time): a pause
+// between edges is then indistinguishable from the end of a message, which
+// increases the chance of an early false match for protocols that embed a
+// shorter protocol as a prefix.
+//
+// Note: Only decoders in the header-timing dispatch index can match early.
+//       Anything else (incl. UNKNOWN/hash results) is still reported via the
+//       normal path once the capture completes.
+//
+// Args:
+//   results: A pointer to where the decoded IR message will be stored.
+//   save:  A pointer to an irparams_t instance in which to copy the interrupt
+//          state while decoding. (See decode(). Default: NULL)
+// Returns:
+//   A boolean indicating if an IR message is ready & has been decoded.
+bool IRrecv::decodePoll(decode_results *results, irparams_t *save) {
+#if defined(ESP32)
+  // The RMT peripheral hands us only whole captures, so there is nothing to
+  // peek at mid-message. Just use the normal path.
+  return decode(results, save);
+#else  // ESP32
+#ifndef UNIT_TEST
+  // Lazy (timer-free) end-of-frame detection, if enabled.
+  pollTimeout();
+#endif  // UNIT_TEST
+  // If a completed capture is already waiting, use the normal path.
+  if ((framequeue_size && framequeue_owner == this) ||
+      irparams.rcvstate == kStopState)
+    return decode(results, save);
+  // Read the (volatile) capture length just once. The interrupt handler only
+  // ever appends, so entries [0 .. rawlen) are stable & safe to copy.
+  uint16_t rawlen = irparams.rawlen;
+  if (rawlen != _stream_lastlen) {  // Still actively capturing edges.
+    _stream_lastlen = rawlen;
+    return false;
+  }
+  // Too little data to be worth a try, or already tried at this length?
+  if (rawlen < kStreamDecodeMinRawlen || rawlen == _stream_triedlen)
+    return false;
+  _stream_triedlen = rawlen;
+  if (_streambuf == NULL) {  // Allocate the snapshot buffer on first use.
+    _streambuf = new uint16_t[irparams.bufsize];
+    if (_streambuf == NULL) return false;
+    irMemRecordAlloc((uint32_t)irparams.bufsize * sizeof(uint16_t));
+  }
+  for (uint16_t i = 0; i < rawlen; i++) _streambuf[i] = irparams.rawbuf[i];
+  // The snapshot gets the same glitch scrub a completed capture would.
+  if (_noise_floor) rawlen = noiseReduce(_streambuf, rawlen);
+  results->rawbuf = _streambuf;
+  results->rawlen = rawlen;
+  results->overflow = false;
+  results->decode_type = UNKNOWN;
+  results->bits = 0;
+  results->value = 0;
+  results->address = 0;
+  results->command = 0;
+  results->repeat = false;
+#if DECODE_HASH
+  _hash_valid = false;  // A new capture, so invalidate the cached hash.
+#endif  // DECODE_HASH
+  if (((_priority_len || _adaptive) && tryPriority(results)) ||
+      tryHeaderIndex(results)) {
+    // Success. Throw away what remains of this message's capture, so it
+    // isn't reported a second time once the gap/timeout finally expires.
+    resume();
+    if (_adaptive) _adaptive_last = (decode_type_t)results->decode_type;
+    return true;
+  }
+  return false;
+#endif  // ESP32
+}
+
+// As decode(), but bounded to (roughly) max_usecs of work per call, with the
+// decode resuming where it stopped on the next call. Intended for loop()s
+// with a hard latency budget: a worst-case walk of the full decode chain
+// over a big UNKNOWN capture can take far longer than e.g. a 5ms display
+// refresh deadline allows, so this amortises it over several loop passes.
+//
+// The budget is enforced at chain-entry boundaries: a decoder already
+// underway isn't preempted, so a call can overshoot the budget by (at most)
+// one decoder's runtime. At least one new chain entry is attempted per
+// call, so the walk always finishes eventually, even with a tiny budget.
+// The cheap pre-chain stages (repeat fast-paths, prioritised decoders & the
+// header-timing index) all run within the first slice.
+//
+// Call it with the *same* results pointer until it stops returning false
+// with a walk in flight; the capture snapshot the continuation works on is
+// carried in *results between calls. The receiver stays stalled (or the
+// frame stays popped, in frame-queued mode) while a walk is in flight, so
+// the capture can't be overwritten mid-walk.
+//
+// Args:
+//   results:   A pointer to where the decoded IR message will be stored.
+//   max_usecs: The (approx.) max. nr. of usecs of decode work per call.
+//   save:  A pointer to an irparams_t instance in which to save
+//          the interrupt's memory/state. NULL means don't save it.
+//          (See decode())
+// Returns:
+//   A boolean indicating if an IR message is ready & has been decoded.
+bool IRrecv::decodeBudgeted(decode_results *results, const uint32_t max_usecs,
+                            irparams_t *save) {
+  _budget_usecs = max_usecs;
+  _budget_pos = 0;
+  _budget_new = 0;
+  _budget_out = false;
+  _budget_timer.reset();
+  bool success;
+  if (!_budget_active) {  // No walk in flight. Start a fresh attempt.
+    _budget_active = true;
+    _budget_done = 0;
+    success = decode(results, save);
+    if (_budget_out) return false;  // Unfinished. Resumes on the next call.
+  } else {
+    // Mid-walk. The capture is still in *results from the earlier
+    // slice(s); continue the full chain from where the last slice stopped.
+    // Clear the partially processed result fields, as decode() does.
+    results->decode_type = UNKNOWN;
+    results->bits = 0;
+    results->value = 0;
+    results->address = 0;
+    results->command = 0;
+    results->repeat = false;
+    success = tryFullChain(results);
+    if (_budget_out) return false;  // Still unfinished. Try again next call.
+    // The walk is over. Mirror decode()'s post-chain bookkeeping.
+#if DECODE_HASH
+    if (success && _repeatcache_on) repeatCacheStore(results);
+#endif  // DECODE_HASH
+    if (success && _adaptive && results->decode_type != UNKNOWN)
+      _adaptive_last = (decode_type_t)results->decode_type;
+#if DECODE_HASH
+    if (success && dedupCheck(results)) success = false;
+#endif  // DECODE_HASH
+    if (!success && !_budget_resumed)
+      resume();  // Throw the capture away and start over.
+  }
+  _budget_active = false;  // Done (either way). The next call starts fresh.
+  _budget_done = 0;
+  return success;
+}
+
+// Decode every complete pending frame in one call, filling successive
+// entries of results[]. With the frame queue enabled (see setFrameQueue())
+// a burst, e.g. a remote's customary triple-send, thus arrives at the
+// application as one coherent batch instead of dribbling out over several
+// loop() passes, & the per-call overhead (timeout poll, state copy, chain
+// setup) is paid once per batch rather than once per frame.
+// A queued frame that doesn't decode (noise, or a duplicate swallowed by
+// dedup, see setDedup()) is consumed & skipped; it doesn't end the drain,
+// as the frames behind it are still wanted.
+// Without the frame queue at most one complete capture can be pending, so
+// this degrades gracefully into a decode() that reports its result count.
+//
+// Args:
+//   results: An array in which to store the decoded IR messages.
+//   max: The capacity of results[]. i.e. The max. nr. of frames to drain.
+// Returns:
+//   The nr. of entries of results[] that were filled with a decoded message.
+uint16_t IRrecv::decodeAll(decode_results results[], const uint16_t max) {
+  uint16_t decoded = 0;
+  bool queued = framequeue_size != 0 && framequeue_owner == this;
+  while (decoded < max) {
+    if (decode(&results[decoded])) {
+      decoded++;  // Filled an entry. Carry on with the next one.
+    } else if (!queued || framequeue_tail == framequeue_head) {
+      break;  // Nothing (further) is pending.
+    }
+    // else: an undecodable queued frame was consumed. Keep draining.
+  }
+  return decoded;
+}
+
+// Register (or clear) a callback for successfully decoded messages,
+// optionally filtered to a single protocol. Pair it with handle() in
+// loop(), or on the ESP32 with the dedicated decode task (see
+// startDecodeTask()), whose callback honours the same protocol filter.
+//
+// Args:
+//   callback: Invoked with each wanted decode result. NULL unregisters.
+//   protocol: Only invoke the callback for this protocol. UNKNOWN (the
+//             default) means any successfully decoded message.
+void IRrecv::onDecode(void (*callback)(const decode_results *),
+                      const decode_type_t protocol) {
+  _on_decode = callback;
+  _on_decode_filter = protocol;
 }
 
-void IRrecv::disableIRIn() {
-#ifndef UNIT_TEST
-  os_timer_disarm(&timer);
-  detachInterrupt(irparams.recvpin);
-#endif
+// Event-driven replacement for polling decode() from loop(). Checks the
+// frame-completion state directly & only enters the decode pipeline when a
+// completed capture is actually waiting, handing any successful result to
+// the callback registered with onDecode(). The nothing-arrived case — the
+// vast majority of loop() passes — thus costs a couple of flag reads
+// instead of decode()'s full entry bookkeeping & chain setup.
+//
+// Note: The results pointer handed to the callback is only valid for the
+// duration of the callback; the capture is released when it returns.
+// Returns:
+//   A boolean indicating if the callback was invoked.
+bool IRrecv::handle(void) {
+  if (_on_decode == NULL) return false;  // Nobody is listening.
+#if !defined(UNIT_TEST) && !defined(ESP32)
+  pollTimeout();  // Lazy end-of-frame detection still needs its nudge.
+  if (framequeue_size && framequeue_owner == this) {
+    if (framequeue_tail == framequeue_head) return false;  // Ring is empty.
+  } else if (irparams.rcvstate != kStopState) {
+    return false;  // No capture has completed. (The cheap common case.)
+  }
+#endif  // !UNIT_TEST && !ESP32
+  decode_results results;
+  if (!decode(&results)) return false;
+  bool wanted = _on_decode_filter == UNKNOWN ||
+                results.decode_type == _on_decode_filter;
+  if (wanted) _on_decode(&results);
+  // An in-place capture (no save buffer, no frame queue) still occupies the
+  // interrupt's buffer. Release it now the callback is done with it.
+  if (irparams_save == NULL &&
+      !(framequeue_size && framequeue_owner == this))
+    resume();
+  return wanted;
 }
 
-void IRrecv::resume() {
-  irparams.rcvstate = kIdleState;
-  irparams.rawlen = 0;
-  irparams.overflow = false;
+// The shared early-exit length gate, consulted before dispatching to any
+// decoder: the minimum nr. of rawbuf entries the protocol's shortest
+// legitimate frame (including repeat/short forms) occupies. A shorter
+// capture can't possibly contain the protocol, so its decoder isn't even
+// called.
+// The values mirror each decoder's own entry guard, using its least strict
+// form & the nbits the decode chain actually passes it. Where a decoder's
+// guard uses constants local to its ir_*.cpp file, the entry errs small
+// instead: too small only costs a wasted decoder call, too big would lose
+// real decodes.
+//
+// Args:
+//   protocol: The protocol in question.
+// Returns:
+//   The minimum nr. of rawbuf entries. 0 == no gate. i.e. Always attempt.
+static uint16_t minRawlenFor(const decode_type_t protocol) {
+  switch (protocol) {
+    case AIWA_RC_T501:  // Errs small: real frames add pre & post bits.
+      return 2 * kAiwaRcT501Bits + kHeader + kFooter - 1;
+    case SANYO_LC7461:
+      return 2 * kSanyoLC7461Bits + kHeader - 1;
+    case CARRIER_AC:
+      return 3 * (2 * kCarrierAcBits + kHeader + kFooter) - 1;
+    case PIONEER:
+      return 2 * (kPioneerBits + kHeader + kFooter) - 1;
+    case NEC:
+    case NEC_LIKE:
+      return 4;  // kNecRptLength. i.e. An NEC repeat frame.
+    case SONY:
+      return 2 * kSonyMinBits + kHeader - 1;
+    case MITSUBISHI:
+      return 2 * kMitsubishiBits + kFooter - 1;
+    case MITSUBISHI2:
+      return 2 * kMitsubishiBits + kHeader + 2 * kFooter - 1;
+    case MITSUBISHI_AC:
+      return 2 * kMitsubishiACBits + 2;
+    case RC5:
+      return 11 + kHeader - 1;  // 11 == kRc5SamplesMin.
+    case RC6:
+      return kHeader + 2 + 4;  // Up to the double-wide T bit.
+    case RCMM:
+      return 5;
+    case FUJITSU_AC:
+      return 2 * kFujitsuAcMinBits + kHeader + kFooter - 1;
+    case DENON:  // The legacy (smallest) variant the chain tries.
+      return 2 * kDenonLegacyBits + kHeader + kFooter - 1;
+    case PANASONIC:
+      return 2 * kPanasonicBits + kHeader + kFooter - 1;
+    case LG:
+      return 2 * kLgBits + kHeader + kFooter - 1;
+    case GICABLE:
+      return 2 * (kGicableBits + kHeader + kFooter) - 1;
+    case JVC:
+      return 2 * kJvcBits + kFooter - 1;
+    case SAMSUNG:
+      return 2 * kSamsungBits + kHeader + kFooter - 1;
+    case SAMSUNG36:
+      return 2 * kSamsung36Bits + kHeader + 2 * kFooter - 1;
+    case SAMSUNG_AC:  // Errs small: extra section headers/footers on top.
+      return 2 * kSamsungAcBits;
+    case WHYNTER:
+      return 2 * kWhynterBits + 2 * kHeader + kFooter - 1;
+    case DISH:
+      return 2 * kDishBits + kHeader + kFooter - 1;
+    case SHARP:
+      return 2 * kSharpBits + kFooter - 1;
+    case SHARP_AC:
+      return 2 * kSharpAcBits + kHeader + kFooter - 1;
+    case COOLIX:  // Sent a bit & its inverse at a time. i.e. 4x per bit.
+      return 4 * kCoolixBits + kHeader + kFooter - 1;
+    case NIKAI:
+      return 2 * kNikaiBits + kHeader + kFooter - 1;
+    case KELVINATOR:  // Errs small: command footer bits etc. on top.
+      return 2 * kKelvinatorBits;
+    case DAIKIN:  // Errs small: leading header section on top.
+      return 2 * kDaikinBits;
+    case DAIKIN2:
+      return 2 * kDaikin2Bits;
+    case DAIKIN216:
+      return 2 * kDaikin216Bits;
+    case TOSHIBA_AC:  // Note: Its guard is per bit pair, not per bit.
+      return kToshibaACBits + kHeader + kFooter - 1;
+    case MIDEA:
+      return 2 * kMideaBits + kHeader + kFooter - 1;
+    case MAGIQUEST:
+      return 2 * kMagiquestBits;
+    case LASERTAG:
+      return 13;  // kLasertagMinSamples.
+    case GREE:  // Errs small: block footer bits on top.
+      return 2 * kGreeBits;
+    case HAIER_AC:
+      return 2 * kHaierACBits + kHeader + kFooter - 1;
+    case HAIER_AC_YRW02:
+      return 2 * kHaierACYRW02Bits;
+    case HITACHI_AC:
+      return 2 * kHitachiAcBits;
+    case HITACHI_AC1:
+      return 2 * kHitachiAc1Bits;
+    case HITACHI_AC2:
+      return 2 * kHitachiAc2Bits;
+    case WHIRLPOOL_AC:
+      return 2 * kWhirlpoolAcBits;
+    case ELECTRA_AC:
+      return 2 * kElectraAcBits + kHeader + kFooter - 1;
+    case PANASONIC_AC:  // The short variant the chain also tries.
+      return 2 * kPanasonicAcShortBits + kHeader + kFooter - 1;
+    case MWM:
+      return 6;  // kMWMMinSamples.
+    case VESTEL_AC:  // Errs small: no guard of its own to mirror.
+      return 2 * kVestelAcBits;
+    case TCL112AC:
+      return 2 * kTcl112AcBits + kHeader + kFooter - 1;
+    case TECO:
+      return 2 * kTecoBits + kHeader + kFooter - 1;
+    case LEGOPF:
+      return 2 * kLegoPfBits + kHeader + kFooter - 1;
+    case MITSUBISHI_HEAVY_152:
+      return 2 * kMitsubishiHeavy152Bits + kHeader + kFooter - 1;
+    case MITSUBISHI_HEAVY_88:
+      return 2 * kMitsubishiHeavy88Bits + kHeader + kFooter - 1;
+    case ARGO:  // No footer.
+      return 2 * kArgoBits + kHeader - 1;
+    case TROTEC:
+      return 2 * kTrotecBits + kHeader + 2 * kFooter - 1;
+    // LUTRON merges consecutive identical bits into single wide intervals,
+    // so no useful minimum exists. Anything else unlisted: no gate either.
+    default:
+      return 0;
+  }
 }
 
-// Make a copy of the interrupt state & buffer data.
-// Needed because irparams is marked as volatile, thus memcpy() isn't allowed.
-// Only call this when you know the interrupt handlers won't modify anything.
-// i.e. In kStopState.
+// The structural *upper* bound on rawlen per protocol, for the few
+// protocols that have one. e.g. LUTRON's run-length format has no header
+// for the dispatch index to key on, but every entry it accepts spans at
+// least one whole bit-period, so a capture with more entries than it has
+// bits (plus a trailing gap) can't be one of its frames & long A/C style
+// captures can skip its (otherwise mandatory) attempt.
 //
 // Args:
-//   src: Pointer to an irparams_t structure to copy from.
-//   dst: Pointer to an irparams_t structure to copy to.
-void IRrecv::copyIrParams(volatile irparams_t *src, irparams_t *dst) {
-  // Typecast src and dst addresses to (char *)
-  char *csrc = (char *)src;  // NOLINT(readability/casting)
-  char *cdst = (char *)dst;  // NOLINT(readability/casting)
-
-  // Save the pointer to the destination's rawbuf so we don't lose it as
-  // the for-loop/copy after this will overwrite it with src's rawbuf pointer.
-  // This isn't immediately obvious due to typecasting/different variable names.
-  uint16_t *dst_rawbuf_ptr;
-  dst_rawbuf_ptr = dst->rawbuf;
-
-  // Copy contents of src[] to dst[]
-  for (uint16_t i = 0; i < sizeof(irparams_t); i++) cdst[i] = csrc[i];
-
-  // Restore the buffer pointer
-  dst->rawbuf = dst_rawbuf_ptr;
+//   protocol: The protocol in question.
+// Returns:
+//   The maximum nr. of rawbuf entries. UINT16_MAX == no gate.
+static uint16_t maxRawlenFor(const decode_type_t protocol) {
+  switch (protocol) {
+    case LUTRON:  // 35 data bits + the assumed leading '1' + a gap.
+      return kLutronBits + 2 + kStartOffset;
+    default:
+      return UINT16_MAX;
+  }
+}
 
-  // Copy the rawbuf
-  for (uint16_t i = 0; i < dst->bufsize; i++) dst->rawbuf[i] = src->rawbuf[i];
+// Is it even worth calling `protocol`s decoder on the current capture?
+// i.e. Is the protocol enabled, & the capture long enough (but not
+// structurally too long) to possibly contain it?
+//
+// Args:
+//   protocol: The protocol in question.
+//   rawlen: Nr. of entries in the capture being decoded.
+// Returns:
+//   A boolean indicating if the decoder should be attempted.
+bool IRrecv::worthAttempting(const decode_type_t protocol,
+                             const uint16_t rawlen) {
+  // Every dispatch path consults us immediately before its decoder call,
+  // so this is also where the active protocol for the runtime-tolerance
+  // resolution is maintained. (See activeTolerance())
+  _tol_active = protocol;
+  return isProtocolEnabled(protocol) && rawlen >= minRawlenFor(protocol) &&
+         rawlen <= maxRawlenFor(protocol);
 }
 
-// Obtain the maximum number of entries possible in the capture buffer.
-// i.e. It's size.
-uint16_t IRrecv::getBufSize() { return irparams.bufsize; }
+// Try the caller-prioritised protocols (& the adaptively learnt last
+// winner, if enabled) against the capture in results, ahead of any other
+// dispatch. See setDecodePriority() & setAdaptiveDecode().
+//
+// Args:
+//   results:  A pointer to where the decoded IR message will be stored.
+// Returns:
+//   A boolean indicating if one of the prioritised decoders succeeded.
+bool IRrecv::tryPriority(decode_results *results) {
+  // Slot 0 is the adaptive last-winner, then the explicit list.
+  const decode_type_t first = _adaptive ? _adaptive_last : UNKNOWN;
+  for (uint8_t i = 0; i <= _priority_len; i++) {
+    decode_type_t protocol;
+    if (i == 0) {
+      protocol = first;
+    } else {
+      protocol = _priority[i - 1];
+      if (protocol == first) continue;  // Already tried as the last winner.
+    }
+    if (protocol == UNKNOWN) continue;
+    if (!worthAttempting(protocol, results->rawlen)) continue;
+    DPRINT("Priority attempt of protocol ");
+    DPRINTLN(protocol);
+#if IRRECV_STATS
+    IRtimer attemptTimer = IRtimer();
+    bool matched = tryDecode(protocol, results);
+    statsRecord(protocol, matched, attemptTimer.elapsed());
+    if (matched) return true;
+#else  // IRRECV_STATS
+    if (tryDecode(protocol, results)) return true;
+#endif  // IRRECV_STATS
+  }
+  return false;
+}
 
+// The single cheap pass of the first-stage trigger filter: could the
+// capture in results be one of the registered patterns?
+// See addTriggerFilter() for the matching rules. Only called when at least
+// one pattern is registered.
+//
+// Args:
+//   results:  A pointer to the (yet to be decoded) capture.
+// Returns:
+//   A boolean indicating if any registered pattern is a candidate match.
+bool IRrecv::triggerMatch(decode_results *results) {
+  uint32_t mark = 0;
+  uint32_t space = 0;
+  if (results->rawlen > kStartOffset + 1) {
+    mark = results->rawbuf[kStartOffset] * kRawTick;
+    space = results->rawbuf[kStartOffset + 1] * kRawTick;
+  }
+  for (uint8_t i = 0; i < _trigger_len; i++) {
+    if (_triggers[i].protocol != UNKNOWN) {
+      // Check the capture's header timings against the protocol's entries
+      // in the header-timing dispatch index. Protocols with no entry can't
+      // be cheaply checked, so they pass this stage.
+      bool indexed = false;
+      bool header_ok = false;
+      for (uint16_t j = 0; kHeaderIndex[j].hdrmark && !header_ok; j++) {
+        if (kHeaderIndex[j].protocol != _triggers[i].protocol) continue;
+        indexed = true;
+        header_ok = mark >= kHeaderIndex[j].mark_low &&
+                    mark <= kHeaderIndex[j].mark_high &&
+                    (!kHeaderIndex[j].hdrspace ||
+                     (space >= kHeaderIndex[j].space_low &&
+                      space <= kHeaderIndex[j].space_high));
+      }
+      if (indexed && !header_ok) continue;  // Wrong header for this pattern.
+    }
 #if DECODE_HASH
-// Set the minimum length we will consider for reporting UNKNOWN message types.
-void IRrecv::setUnknownThreshold(uint16_t length) {
-  unknown_threshold = length;
-}
+    if (_triggers[i].fingerprint &&
+        getCaptureHash(results) != _triggers[i].fingerprint)
+      continue;  // Wrong shape for this pattern.
 #endif  // DECODE_HASH
+    return true;  // A candidate. Worth waking the real decoders for.
+  }
+  return false;  // No registered pattern can match this capture.
+}
 
-// Decodes the received IR message.
-// If the interrupt state is saved, we will immediately resume waiting
-// for the next IR message to avoid missing messages.
-// Note: There is a trade-off here. Saving the state means less time lost until
-// we can receiving the next message vs. using more RAM. Choose appropriately.
+// Run the header-timing dispatch index over the capture in results,
+// attempting only the decoders whose expected header is consistent with its
+// start. Respects the runtime protocol enable bitmap.
 //
 // Args:
 //   results:  A pointer to where the decoded IR message will be stored.
-//   save:  A pointer to an irparams_t instance in which to save
-//          the interrupt's memory/state. NULL means don't save it.
 // Returns:
-//   A boolean indicating if an IR message is ready or not.
-bool IRrecv::decode(decode_results *results, irparams_t *save) {
-  // Proceed only if an IR message been received.
-#ifndef UNIT_TEST
-  if (irparams.rcvstate != kStopState) return false;
-#endif
-
-  // Clear the entry we are currently pointing to when we got the timeout.
-  // i.e. Stopped collecting IR data.
-  // It's junk as we never wrote an entry to it and can only confuse decoding.
-  // This is done here rather than logically the best place in read_timeout()
-  // as it saves a few bytes of ICACHE_RAM as that routine is bound to an
-  // interrupt. decode() is not stored in ICACHE_RAM.
-  // Another better option would be to zero the entire irparams.rawbuf[] on
-  // resume() but that is a much more expensive operation compare to this.
-  irparams.rawbuf[irparams.rawlen] = 0;
-
-  bool resumed = false;  // Flag indicating if we have resumed.
-
-  // If we were requested to use a save buffer previously, do so.
-  if (save == NULL) save = irparams_save;
-
-  if (save == NULL) {
-    // We haven't been asked to copy it so use the existing memory.
-#ifndef UNIT_TEST
-    results->rawbuf = irparams.rawbuf;
-    results->rawlen = irparams.rawlen;
-    results->overflow = irparams.overflow;
-#endif
-  } else {
-    copyIrParams(&irparams, save);  // Duplicate the interrupt's memory.
-    resume();  // It's now safe to rearm. The IR message won't be overridden.
-    resumed = true;
-    // Point the results at the saved copy.
-    results->rawbuf = save->rawbuf;
-    results->rawlen = save->rawlen;
-    results->overflow = save->overflow;
+//   A boolean indicating if one of the indexed decoders succeeded.
+bool IRrecv::tryHeaderIndex(decode_results *results) {
+  if (results->rawlen <= kStartOffset + 1) return false;
+  const uint32_t mark = results->rawbuf[kStartOffset] * kRawTick;
+  const uint32_t space = results->rawbuf[kStartOffset + 1] * kRawTick;
+  for (uint16_t i = 0; kHeaderIndex[i].hdrmark; i++) {
+    if (!worthAttempting(kHeaderIndex[i].protocol, results->rawlen)) continue;
+    // The bounds were computed at compile time, so an index miss costs just
+    // a couple of compares against immediate constants.
+    if (mark < kHeaderIndex[i].mark_low || mark > kHeaderIndex[i].mark_high)
+      continue;
+    if (kHeaderIndex[i].hdrspace &&
+        (space < kHeaderIndex[i].space_low ||
+         space > kHeaderIndex[i].space_high))
+      continue;
+    DPRINT("Header index hit. Attempting protocol ");
+    DPRINTLN(kHeaderIndex[i].protocol);
+#if IRRECV_STATS
+    IRtimer attemptTimer = IRtimer();
+    bool matched = tryDecode(kHeaderIndex[i].protocol, results);
+    statsRecord(kHeaderIndex[i].protocol, matched, attemptTimer.elapsed());
+    if (matched) return true;
+#else  // IRRECV_STATS
+    if (tryDecode(kHeaderIndex[i].protocol, results)) return true;
+#endif  // IRRECV_STATS
   }
+  return false;
+}
 
-  // Reset any previously partially processed results.
-  results->decode_type = UNKNOWN;
-  results->bits = 0;
-  results->value = 0;
-  results->address = 0;
-  results->command = 0;
-  results->repeat = false;
-
+// Try every compiled-in decoder, in the documented priority order, against
+// the current capture. This is the fall-back path for captures the
+// header-timing dispatch index couldn't shortcut.
+//
+// Args:
+//   results:  A pointer to where the decoded IR message will be stored.
+// Returns:
+//   A boolean indicating if the decode was successful or not.
+// Single-pass entry for the NEC-timing family: Aiwa RC-T501, Sanyo LC7461,
+// Carrier AC, Pioneer & NEC itself. (Sherwood is plain NEC.) Every member
+// opens with an NEC-compatible header (8.5-9ms mark, 4.2-4.5ms space), so
+// that shared timing is vetted once here & a capture that can't possibly be
+// any of them costs a couple of compares instead of five decoder attempts.
+// The vet matches against the outermost members' timings (Carrier's 8532us
+// mark is the shortest, Sanyo LC7461's 9000us the longest; ditto their
+// spaces), so no member's own tolerance window is narrowed. Precedence &
+// acceptance between the members are unchanged: the longer/more specific
+// variants still get attempted before plain NEC.
+//
+// Args:
+//   results:  A pointer to where the decoded IR message will be stored.
+// Returns:
+//   A boolean indicating if the decode was successful or not.
+#if (DECODE_NEC || DECODE_SHERWOOD || DECODE_AIWA_RC_T501 || DECODE_SANYO || \
+     DECODE_CARRIER_AC || DECODE_PIONEER)
+bool IRrecv::decodeNECFamily(decode_results *results) {
+  if (results->rawlen < kNecRptLength) return false;
+  const uint16_t hdrmark = results->rawbuf[kStartOffset];
+  if (!matchMark(hdrmark, 8532) &&  // kCarrierAcHdrMark. (The shortest)
+      !matchMark(hdrmark, 9000))    // kSanyoLc7461HdrMark. (The longest)
+    return false;
+#if DECODE_NEC
+  if (results->rawlen == kNecRptLength)  // Can only be an NEC repeat frame.
+    return worthAttempting(NEC, results->rawlen) && decodeNEC(results);
+#endif
+  const uint16_t hdrspace = results->rawbuf[kStartOffset + 1];
+  if (!matchSpace(hdrspace, 4228) &&  // kCarrierAcHdrSpace. (The shortest)
+      !matchSpace(hdrspace, 4500))    // kSanyoLc7461HdrSpace. (The longest)
+    return false;
 #if DECODE_AIWA_RC_T501
-  DPRINTLN("Attempting Aiwa RC T501 decode");
-  // Try decodeAiwaRCT501() before decodeSanyoLC7461() & decodeNEC()
-  // because the protocols are similar. This protocol is more specific than
-  // those ones, so should got before them.
-  if (decodeAiwaRCT501(results)) return true;
+  if (worthAttempting(AIWA_RC_T501, results->rawlen)) {
+    DPRINTLN("Attempting Aiwa RC T501 decode");
+    // Try decodeAiwaRCT501() before decodeSanyoLC7461() & decodeNEC()
+    // because the protocols are similar. This protocol is more specific than
+    // those ones, so should got before them.
+    if (decodeAiwaRCT501(results)) return true;
+  }
 #endif
 #if DECODE_SANYO
-  DPRINTLN("Attempting Sanyo LC7461 decode");
-  // Try decodeSanyoLC7461() before decodeNEC() because the protocols are
-  // similar in timings & structure, but the Sanyo one is much longer than the
-  // NEC protocol (42 vs 32 bits) so this one should be tried first to try to
-  // reduce false detection as a NEC packet.
-  if (decodeSanyoLC7461(results)) return true;
+  if (worthAttempting(SANYO_LC7461, results->rawlen)) {
+    DPRINTLN("Attempting Sanyo LC7461 decode");
+    // Try decodeSanyoLC7461() before decodeNEC() because the protocols are
+    // similar in timings & structure, but the Sanyo one is much longer than the
+    // NEC protocol (42 vs 32 bits) so this one should be tried first to try to
+    // reduce false detection as a NEC packet.
+    if (decodeSanyoLC7461(results)) return true;
+  }
 #endif
 #if DECODE_CARRIER_AC
-  DPRINTLN("Attempting Carrier AC decode");
-  // Try decodeCarrierAC() before decodeNEC() because the protocols are
-  // similar in timings & structure, but the Carrier one is much longer than the
-  // NEC protocol (3x32 bits vs 1x32 bits) so this one should be tried first to
-  // try to reduce false detection as a NEC packet.
-  if (decodeCarrierAC(results)) return true;
+  if (worthAttempting(CARRIER_AC, results->rawlen)) {
+    DPRINTLN("Attempting Carrier AC decode");
+    // Try decodeCarrierAC() before decodeNEC() because the protocols are
+    // similar in timings & structure, but the Carrier one is much longer than
+    // the NEC protocol (3x32 bits vs 1x32 bits) so this one should be tried
+    // first to try to reduce false detection as a NEC packet.
+    if (decodeCarrierAC(results)) return true;
+  }
 #endif
 #if DECODE_PIONEER
-  DPRINTLN("Attempting Pioneer decode");
-  // Try decodePioneer() before decodeNEC() because the protocols are
-  // similar in timings & structure, but the Pioneer one is much longer than the
-  // NEC protocol (2x32 bits vs 1x32 bits) so this one should be tried first to
-  // try to reduce false detection as a NEC packet.
-  if (decodePioneer(results)) return true;
+  if (worthAttempting(PIONEER, results->rawlen)) {
+    DPRINTLN("Attempting Pioneer decode");
+    // Try decodePioneer() before decodeNEC() because the protocols are
+    // similar in timings & structure, but the Pioneer one is much longer than
+    // the NEC protocol (2x32 bits vs 1x32 bits) so this one should be tried
+    // first to try to reduce false detection as a NEC packet.
+    if (decodePioneer(results)) return true;
+  }
 #endif
 #if DECODE_NEC
-  DPRINTLN("Attempting NEC decode");
-  if (decodeNEC(results)) return true;
+  if (worthAttempting(NEC, results->rawlen)) {
+    DPRINTLN("Attempting NEC decode");
+    if (decodeNEC(results)) return true;
+  }
+#endif
+  return false;
+}
+#endif  // The NEC family.
+
+// Budgeted decode bookkeeping. Called once per full-chain entry, in chain
+// order, to decide if that entry should be attempted on this call.
+// Entries finished by an earlier decodeBudgeted() slice are skipped; fresh
+// entries are attempted until the slice's time budget expires. At least one
+// new entry is always attempted per slice, so a walk always makes progress,
+// even under a budget smaller than a single decoder's runtime.
+// A no-op (always attempt) when no budgeted decode is in flight.
+// See decodeBudgeted().
+//
+// Returns:
+//   A boolean indicating if the calling chain entry should be attempted.
+bool IRrecv::chainStep(void) {
+  if (!_budget_active) return true;  // Not budgeted. Always attempt.
+  if (_budget_pos++ < _budget_done) return false;  // Done in a prior slice.
+  if (_budget_out) return false;  // This slice is already out of time.
+  // Only consult the clock once this slice has attempted something new.
+  if (_budget_new && _budget_timer.elapsed() >= _budget_usecs) {
+    _budget_out = true;
+    return false;
+  }
+  _budget_new++;
+  _budget_done++;
+  return true;
+}
+
+bool IRrecv::tryFullChain(decode_results *results) {
+#if (DECODE_NEC || DECODE_SHERWOOD || DECODE_AIWA_RC_T501 || DECODE_SANYO || \
+     DECODE_CARRIER_AC || DECODE_PIONEER)
+  // The whole NEC-timing family (Aiwa, Sanyo LC7461, Carrier AC, Pioneer &
+  // NEC) hangs off one shared header vet. See decodeNECFamily().
+  if (chainStep() && decodeNECFamily(results)) return true;
 #endif
 #if DECODE_SONY
-  DPRINTLN("Attempting Sony decode");
-  if (decodeSony(results)) return true;
+  if (chainStep() && worthAttempting(SONY, results->rawlen)) {
+    DPRINTLN("Attempting Sony decode");
+    if (decodeSony(results)) return true;
+  }
 #endif
 #if DECODE_MITSUBISHI
-  DPRINTLN("Attempting Mitsubishi decode");
-  if (decodeMitsubishi(results)) return true;
+  if (chainStep() && worthAttempting(MITSUBISHI, results->rawlen)) {
+    DPRINTLN("Attempting Mitsubishi decode");
+    if (decodeMitsubishi(results)) return true;
+  }
 #endif
 #if DECODE_MITSUBISHI_AC
-  DPRINTLN("Attempting Mitsubishi AC decode");
-  if (decodeMitsubishiAC(results)) return true;
+  if (chainStep() && worthAttempting(MITSUBISHI_AC, results->rawlen)) {
+    DPRINTLN("Attempting Mitsubishi AC decode");
+    if (decodeMitsubishiAC(results)) return true;
+  }
 #endif
 #if DECODE_MITSUBISHI2
-  DPRINTLN("Attempting Mitsubishi2 decode");
-  if (decodeMitsubishi2(results)) return true;
+  if (chainStep() && worthAttempting(MITSUBISHI2, results->rawlen)) {
+    DPRINTLN("Attempting Mitsubishi2 decode");
+    if (decodeMitsubishi2(results)) return true;
+  }
 #endif
 #if DECODE_RC5
-  DPRINTLN("Attempting RC5 decode");
-  if (decodeRC5(results)) return true;
+  if (chainStep() && worthAttempting(RC5, results->rawlen)) {
+    DPRINTLN("Attempting RC5 decode");
+    if (decodeRC5(results)) return true;
+  }
 #endif
 #if DECODE_RC6
-  DPRINTLN("Attempting RC6 decode");
-  if (decodeRC6(results)) return true;
+  if (chainStep() && worthAttempting(RC6, results->rawlen)) {
+    DPRINTLN("Attempting RC6 decode");
+    if (decodeRC6(results)) return true;
+  }
 #endif
 #if DECODE_RCMM
-  DPRINTLN("Attempting RC-MM decode");
-  if (decodeRCMM(results)) return true;
+  if (chainStep() && worthAttempting(RCMM, results->rawlen)) {
+    DPRINTLN("Attempting RC-MM decode");
+    if (decodeRCMM(results)) return true;
+  }
 #endif
 #if DECODE_FUJITSU_AC
-  // Fujitsu A/C needs to precede Panasonic and Denon as it has a short
-  // message which looks exactly the same as a Panasonic/Denon message.
-  DPRINTLN("Attempting Fujitsu A/C decode");
-  if (decodeFujitsuAC(results)) return true;
+  if (chainStep() && worthAttempting(FUJITSU_AC, results->rawlen)) {
+    // Fujitsu A/C needs to precede Panasonic and Denon as it has a short
+    // message which looks exactly the same as a Panasonic/Denon message.
+    DPRINTLN("Attempting Fujitsu A/C decode");
+    if (decodeFujitsuAC(results)) return true;
+  }
 #endif
 #if DECODE_DENON
-  // Denon needs to precede Panasonic as it is a special case of Panasonic.
-  DPRINTLN("Attempting Denon decode");
-  if (decodeDenon(results, DENON_48_BITS) || decodeDenon(results, DENON_BITS) ||
-      decodeDenon(results, kDenonLegacyBits))
-    return true;
+  if (chainStep() && worthAttempting(DENON, results->rawlen)) {
+    // Denon needs to precede Panasonic as it is a special case of Panasonic.
+    DPRINTLN("Attempting Denon decode");
+    if (decodeDenonAll(results)) return true;
+  }
 #endif
 #if DECODE_PANASONIC
-  DPRINTLN("Attempting Panasonic decode");
-  if (decodePanasonic(results)) return true;
+  if (chainStep() && worthAttempting(PANASONIC, results->rawlen)) {
+    DPRINTLN("Attempting Panasonic decode");
+    if (decodePanasonic(results)) return true;
+  }
 #endif
 #if DECODE_LG
-  DPRINTLN("Attempting LG (28-bit) decode");
-  if (decodeLG(results, kLgBits, true)) return true;
-  DPRINTLN("Attempting LG (32-bit) decode");
-  // LG32 should be tried before Samsung
-  if (decodeLG(results, kLg32Bits, true)) return true;
+  if (chainStep() && worthAttempting(LG, results->rawlen)) {
+    // Covers both the 28 & 32-bit variants. Needs to be tried before
+    // Samsung.
+    DPRINTLN("Attempting LG decode");
+    if (decodeLGAll(results)) return true;
+  }
 #endif
 #if DECODE_GICABLE
-  // Note: Needs to happen before JVC decode, because it looks similar except
-  //       with a required NEC-like repeat code.
-  DPRINTLN("Attempting GICable decode");
-  if (decodeGICable(results)) return true;
+  if (chainStep() && worthAttempting(GICABLE, results->rawlen)) {
+    // Note: Needs to happen before JVC decode, because it looks similar except
+    //       with a required NEC-like repeat code.
+    DPRINTLN("Attempting GICable decode");
+    if (decodeGICable(results)) return true;
+  }
 #endif
 #if DECODE_JVC
-  DPRINTLN("Attempting JVC decode");
-  if (decodeJVC(results)) return true;
-#endif
-#if DECODE_SAMSUNG
-  DPRINTLN("Attempting SAMSUNG decode");
-  if (decodeSAMSUNG(results)) return true;
+  if (chainStep() && worthAttempting(JVC, results->rawlen)) {
+    DPRINTLN("Attempting JVC decode");
+    if (decodeJVC(results)) return true;
+  }
 #endif
-#if DECODE_SAMSUNG36
-  DPRINTLN("Attempting Samsung36 decode");
-  if (decodeSamsung36(results)) return true;
+#if (DECODE_SAMSUNG || DECODE_SAMSUNG36)
+  // Both Samsung variants hang off one shared header vet.
+  // See decodeSamsungFamily().
+  if (chainStep() && decodeSamsungFamily(results)) return true;
 #endif
 #if DECODE_WHYNTER
-  DPRINTLN("Attempting Whynter decode");
-  if (decodeWhynter(results)) return true;
+  if (chainStep() && worthAttempting(WHYNTER, results->rawlen)) {
+    DPRINTLN("Attempting Whynter decode");
+    if (decodeWhynter(results)) return true;
+  }
 #endif
 #if DECODE_DISH
-  DPRINTLN("Attempting DISH decode");
-  if (decodeDISH(results)) return true;
+  if (chainStep() && worthAttempting(DISH, results->rawlen)) {
+    DPRINTLN("Attempting DISH decode");
+    if (decodeDISH(results)) return true;
+  }
 #endif
 #if DECODE_SHARP
-  DPRINTLN("Attempting Sharp decode");
-  if (decodeSharp(results)) return true;
+  if (chainStep() && worthAttempting(SHARP, results->rawlen)) {
+    DPRINTLN("Attempting Sharp decode");
+    if (decodeSharp(results)) return true;
+  }
 #endif
 #if DECODE_COOLIX
-  DPRINTLN("Attempting Coolix decode");
-  if (decodeCOOLIX(results)) return true;
+  if (chainStep() && worthAttempting(COOLIX, results->rawlen)) {
+    DPRINTLN("Attempting Coolix decode");
+    if (decodeCOOLIX(results)) return true;
+  }
 #endif
 #if DECODE_NIKAI
-  DPRINTLN("Attempting Nikai decode");
-  if (decodeNikai(results)) return true;
+  if (chainStep() && worthAttempting(NIKAI, results->rawlen)) {
+    DPRINTLN("Attempting Nikai decode");
+    if (decodeNikai(results)) return true;
+  }
 #endif
 #if DECODE_KELVINATOR
-  // Kelvinator based-devices use a similar code to Gree ones, to avoid false
-  // matches this needs to happen before decodeGree().
-  DPRINTLN("Attempting Kelvinator decode");
-  if (decodeKelvinator(results)) return true;
+  if (chainStep() && worthAttempting(KELVINATOR, results->rawlen)) {
+    // Kelvinator based-devices use a similar code to Gree ones, to avoid false
+    // matches this needs to happen before decodeGree().
+    DPRINTLN("Attempting Kelvinator decode");
+    if (decodeKelvinator(results)) return true;
+  }
 #endif
 #if DECODE_DAIKIN
-  DPRINTLN("Attempting Daikin decode");
-  if (decodeDaikin(results)) return true;
+  if (chainStep() && worthAttempting(DAIKIN, results->rawlen)) {
+    DPRINTLN("Attempting Daikin decode");
+    if (decodeDaikin(results)) return true;
+  }
 #endif
 #if DECODE_DAIKIN2
-  DPRINTLN("Attempting Daikin2 decode");
-  if (decodeDaikin2(results)) return true;
+  if (chainStep() && worthAttempting(DAIKIN2, results->rawlen)) {
+    DPRINTLN("Attempting Daikin2 decode");
+    if (decodeDaikin2(results)) return true;
+  }
 #endif
 #if DECODE_DAIKIN216
-  DPRINTLN("Attempting Daikin216 decode");
-  if (decodeDaikin216(results)) return true;
+  if (chainStep() && worthAttempting(DAIKIN216, results->rawlen)) {
+    DPRINTLN("Attempting Daikin216 decode");
+    if (decodeDaikin216(results)) return true;
+  }
 #endif
 #if DECODE_TOSHIBA_AC
-  DPRINTLN("Attempting Toshiba AC decode");
-  if (decodeToshibaAC(results)) return true;
+  if (chainStep() && worthAttempting(TOSHIBA_AC, results->rawlen)) {
+    DPRINTLN("Attempting Toshiba AC decode");
+    if (decodeToshibaAC(results)) return true;
+  }
 #endif
 #if DECODE_MIDEA
-  DPRINTLN("Attempting Midea decode");
-  if (decodeMidea(results)) return true;
+  if (chainStep() && worthAttempting(MIDEA, results->rawlen)) {
+    DPRINTLN("Attempting Midea decode");
+    if (decodeMidea(results)) return true;
+  }
 #endif
 #if DECODE_MAGIQUEST
-  DPRINTLN("Attempting Magiquest decode");
-  if (decodeMagiQuest(results)) return true;
+  if (chainStep() && worthAttempting(MAGIQUEST, results->rawlen)) {
+    DPRINTLN("Attempting Magiquest decode");
+    if (decodeMagiQuest(results)) return true;
+  }
 #endif
 /* NOTE: Disabled due to poor quality.
 #if DECODE_SANYO
@@ -429,116 +3583,162 @@ bool IRrecv::decode(decode_results *results, irparams_t *save) {
 #endif
 */
 #if DECODE_NEC
-  // Some devices send NEC-like codes that don't follow the true NEC spec.
-  // This should detect those. e.g. Apple TV remote etc.
-  // This needs to be done after all other codes that use strict and some
-  // other protocols that are NEC-like as well, as turning off strict may
-  // cause this to match other valid protocols.
-  DPRINTLN("Attempting NEC (non-strict) decode");
-  if (decodeNEC(results, kNECBits, false)) {
-    results->decode_type = NEC_LIKE;
-    return true;
+  if (chainStep() && worthAttempting(NEC_LIKE, results->rawlen)) {
+    // Some devices send NEC-like codes that don't follow the true NEC spec.
+    // This should detect those. e.g. Apple TV remote etc.
+    // This needs to be done after all other codes that use strict and some
+    // other protocols that are NEC-like as well, as turning off strict may
+    // cause this to match other valid protocols.
+    DPRINTLN("Attempting NEC (non-strict) decode");
+    if (decodeNEC(results, kNECBits, false)) {
+      results->decode_type = NEC_LIKE;
+      return true;
+    }
   }
 #endif
 #if DECODE_LASERTAG
-  DPRINTLN("Attempting Lasertag decode");
-  if (decodeLasertag(results)) return true;
+  if (chainStep() && worthAttempting(LASERTAG, results->rawlen)) {
+    DPRINTLN("Attempting Lasertag decode");
+    if (decodeLasertag(results)) return true;
+  }
 #endif
 #if DECODE_GREE
-  // Gree based-devices use a similar code to Kelvinator ones, to avoid false
-  // matches this needs to happen after decodeKelvinator().
-  DPRINTLN("Attempting Gree decode");
-  if (decodeGree(results)) return true;
+  if (chainStep() && worthAttempting(GREE, results->rawlen)) {
+    // Gree based-devices use a similar code to Kelvinator ones, to avoid false
+    // matches this needs to happen after decodeKelvinator().
+    DPRINTLN("Attempting Gree decode");
+    if (decodeGree(results)) return true;
+  }
 #endif
 #if DECODE_HAIER_AC
-  DPRINTLN("Attempting Haier AC decode");
-  if (decodeHaierAC(results)) return true;
+  if (chainStep() && worthAttempting(HAIER_AC, results->rawlen)) {
+    DPRINTLN("Attempting Haier AC decode");
+    if (decodeHaierAC(results)) return true;
+  }
 #endif
 #if DECODE_HAIER_AC_YRW02
-  DPRINTLN("Attempting Haier AC YR-W02 decode");
-  if (decodeHaierACYRW02(results)) return true;
-#endif
-#if DECODE_HITACHI_AC2
-  // HitachiAC2 should be checked before HitachiAC
-  DPRINTLN("Attempting Hitachi AC2 decode");
-  if (decodeHitachiAC(results, kHitachiAc2Bits)) return true;
-#endif
-#if DECODE_HITACHI_AC
-  DPRINTLN("Attempting Hitachi AC decode");
-  if (decodeHitachiAC(results, kHitachiAcBits)) return true;
+  if (chainStep() && worthAttempting(HAIER_AC_YRW02, results->rawlen)) {
+    DPRINTLN("Attempting Haier AC YR-W02 decode");
+    if (decodeHaierACYRW02(results)) return true;
+  }
 #endif
-#if DECODE_HITACHI_AC1
-  DPRINTLN("Attempting Hitachi AC1 decode");
-  if (decodeHitachiAC(results, kHitachiAc1Bits)) return true;
+#if (DECODE_HITACHI_AC || DECODE_HITACHI_AC1 || DECODE_HITACHI_AC2)
+  // A single attempt serves all three Hitachi variants: the decoder picks
+  // the variant from the capture length. The gates are ordered largest
+  // frame first so the one that fits also sets the active tolerance.
+  if (chainStep() && (worthAttempting(HITACHI_AC2, results->rawlen) ||
+                      worthAttempting(HITACHI_AC, results->rawlen) ||
+                      worthAttempting(HITACHI_AC1, results->rawlen))) {
+    DPRINTLN("Attempting Hitachi AC decode");
+    if (decodeHitachiAC(results)) return true;
+  }
 #endif
 #if DECODE_WHIRLPOOL_AC
-  DPRINTLN("Attempting Whirlpool AC decode");
-  if (decodeWhirlpoolAC(results)) return true;
+  if (chainStep() && worthAttempting(WHIRLPOOL_AC, results->rawlen)) {
+    DPRINTLN("Attempting Whirlpool AC decode");
+    if (decodeWhirlpoolAC(results)) return true;
+  }
 #endif
 #if DECODE_SAMSUNG_AC
-  DPRINTLN("Attempting Samsung AC (extended) decode");
-  // Check the extended size first, as it should fail fast due to longer length.
-  if (decodeSamsungAC(results, kSamsungAcExtendedBits, false)) return true;
-  // Now check for the more common length.
-  DPRINTLN("Attempting Samsung AC decode");
-  if (decodeSamsungAC(results, kSamsungAcBits)) return true;
+  if (chainStep() && worthAttempting(SAMSUNG_AC, results->rawlen)) {
+    DPRINTLN("Attempting Samsung AC (extended) decode");
+    // Check the extended size first, as it should fail fast due to longer
+    // length.
+    if (decodeSamsungAC(results, kSamsungAcExtendedBits, false)) return true;
+    // Now check for the more common length.
+    DPRINTLN("Attempting Samsung AC decode");
+    if (decodeSamsungAC(results, kSamsungAcBits)) return true;
+  }
 #endif
 #if DECODE_ELECTRA_AC
-  DPRINTLN("Attempting Electra AC decode");
-  if (decodeElectraAC(results)) return true;
+  if (chainStep() && worthAttempting(ELECTRA_AC, results->rawlen)) {
+    DPRINTLN("Attempting Electra AC decode");
+    if (decodeElectraAC(results)) return true;
+  }
 #endif
 #if DECODE_PANASONIC_AC
-  DPRINTLN("Attempting Panasonic AC decode");
-  if (decodePanasonicAC(results)) return true;
-  DPRINTLN("Attempting Panasonic AC short decode");
-  if (decodePanasonicAC(results, kPanasonicAcShortBits)) return true;
+  if (chainStep() && worthAttempting(PANASONIC_AC, results->rawlen)) {
+    DPRINTLN("Attempting Panasonic AC decode");
+    if (decodePanasonicAC(results)) return true;
+    DPRINTLN("Attempting Panasonic AC short decode");
+    if (decodePanasonicAC(results, kPanasonicAcShortBits)) return true;
+  }
 #endif
 #if DECODE_LUTRON
-  DPRINTLN("Attempting Lutron decode");
-  if (decodeLutron(results)) return true;
+  if (chainStep() && worthAttempting(LUTRON, results->rawlen)) {
+    DPRINTLN("Attempting Lutron decode");
+    if (decodeLutron(results)) return true;
+  }
 #endif
 #if DECODE_MWM
-  DPRINTLN("Attempting MWM decode");
-  if (decodeMWM(results)) return true;
+  if (chainStep() && worthAttempting(MWM, results->rawlen)) {
+    DPRINTLN("Attempting MWM decode");
+    if (decodeMWM(results)) return true;
+  }
 #endif
 #if DECODE_VESTEL_AC
-  DPRINTLN("Attempting Vestel AC decode");
-  if (decodeVestelAc(results)) return true;
+  if (chainStep() && worthAttempting(VESTEL_AC, results->rawlen)) {
+    DPRINTLN("Attempting Vestel AC decode");
+    if (decodeVestelAc(results)) return true;
+  }
 #endif
 #if DECODE_TCL112AC
-  DPRINTLN("Attempting TCL112AC decode");
-  if (decodeTcl112Ac(results)) return true;
+  if (chainStep() && worthAttempting(TCL112AC, results->rawlen)) {
+    DPRINTLN("Attempting TCL112AC decode");
+    if (decodeTcl112Ac(results)) return true;
+  }
 #endif
 #if DECODE_TECO
-  DPRINTLN("Attempting Teco decode");
-  if (decodeTeco(results)) return true;
+  if (chainStep() && worthAttempting(TECO, results->rawlen)) {
+    DPRINTLN("Attempting Teco decode");
+    if (decodeTeco(results)) return true;
+  }
 #endif
 #if DECODE_LEGOPF
-  DPRINTLN("Attempting LEGOPF decode");
-  if (decodeLegoPf(results)) return true;
+  if (chainStep() && worthAttempting(LEGOPF, results->rawlen)) {
+    DPRINTLN("Attempting LEGOPF decode");
+    if (decodeLegoPf(results)) return true;
+  }
 #endif
 #if DECODE_MITSUBISHIHEAVY
-  DPRINTLN("Attempting MITSUBISHIHEAVY (152 bit) decode");
-  if (decodeMitsubishiHeavy(results, kMitsubishiHeavy152Bits)) return true;
-  DPRINTLN("Attempting MITSUBISHIHEAVY (88 bit) decode");
-  if (decodeMitsubishiHeavy(results, kMitsubishiHeavy88Bits)) return true;
+  if (chainStep() && worthAttempting(MITSUBISHI_HEAVY_152, results->rawlen)) {
+    DPRINTLN("Attempting MITSUBISHIHEAVY (152 bit) decode");
+    if (decodeMitsubishiHeavy(results, kMitsubishiHeavy152Bits)) return true;
+  }
+  if (chainStep() && worthAttempting(MITSUBISHI_HEAVY_88, results->rawlen)) {
+    DPRINTLN("Attempting MITSUBISHIHEAVY (88 bit) decode");
+    if (decodeMitsubishiHeavy(results, kMitsubishiHeavy88Bits)) return true;
+  }
 #endif
 #if DECODE_SHARP_AC
-  DPRINTLN("Attempting SHARP_AC decode");
-  if (decodeSharpAc(results)) return true;
+  if (chainStep() && worthAttempting(SHARP_AC, results->rawlen)) {
+    DPRINTLN("Attempting SHARP_AC decode");
+    if (decodeSharpAc(results)) return true;
+  }
 #endif
+#if DECODE_ARGO
+  if (chainStep() && worthAttempting(ARGO, results->rawlen)) {
+    DPRINTLN("Attempting Argo decode");
+    if (decodeArgo(results)) return true;
+  }
+#endif  // DECODE_ARGO
+#if DECODE_TROTEC
+  if (chainStep() && worthAttempting(TROTEC, results->rawlen)) {
+    DPRINTLN("Attempting Trotec decode");
+    if (decodeTrotec(results)) return true;
+  }
+#endif  // DECODE_TROTEC
 #if DECODE_HASH
-  // decodeHash returns a hash on any input.
-  // Thus, it needs to be last in the list.
-  // If you add any decodes, add them before this.
-  if (decodeHash(results)) {
-    return true;
+  if (chainStep() && worthAttempting(UNKNOWN, results->rawlen)) {
+    // decodeHash returns a hash on any input.
+    // Thus, it needs to be last in the list.
+    // If you add any decodes, add them before this.
+    if (decodeHash(results)) {
+      return true;
+    }
   }
 #endif  // DECODE_HASH
-  // Throw away and start over
-  if (!resumed)  // Check if we have already resumed.
-    resume();
-  return false;
+  return false;  // Nothing matched.
 }
 
 // Calculate the lower bound of the nr. of ticks.
@@ -550,9 +3750,12 @@ bool IRrecv::decode(decode_results *results, irparams_t *save) {
 // Returns:
 //   Nr. of ticks.
 uint32_t IRrecv::ticksLow(uint32_t usecs, uint8_t tolerance, uint16_t delta) {
-  // max() used to ensure the result can't drop below 0 before the cast.
-  return ((uint32_t)std::max(
-      (int32_t)(usecs * (1.0 - tolerance / 100.0) - delta), 0));
+  if (tolerance == kUseDefTol) tolerance = activeTolerance();
+  // Integer-only version of 'usecs * (1.0 - tolerance / 100.0) - delta'.
+  // Much cheaper than the floating point it replaces, & gives same results.
+  // The maths lives in matchBoundLow() so it can also be evaluated at
+  // compile time. (e.g. By the header-timing dispatch index.)
+  return matchBoundLow(usecs, tolerance, delta);
 }
 
 // Calculate the upper bound of the nr. of ticks.
@@ -564,7 +3767,11 @@ uint32_t IRrecv::ticksLow(uint32_t usecs, uint8_t tolerance, uint16_t delta) {
 // Returns:
 //   Nr. of ticks.
 uint32_t IRrecv::ticksHigh(uint32_t usecs, uint8_t tolerance, uint16_t delta) {
-  return ((uint32_t)(usecs * (1.0 + tolerance / 100.0)) + 1 + delta);
+  if (tolerance == kUseDefTol) tolerance = activeTolerance();
+  // Integer-only version of 'usecs * (1.0 + tolerance / 100.0)'.
+  // Much cheaper than the floating point it replaces, & gives same results.
+  // See ticksLow() above re: matchBoundHigh().
+  return matchBoundHigh(usecs, tolerance, delta);
 }
 
 // Check if we match a pulse(measured) with the desired within
@@ -580,15 +3787,37 @@ uint32_t IRrecv::ticksHigh(uint32_t usecs, uint8_t tolerance, uint16_t delta) {
 //   Boolean: true if it matches, false if it doesn't.
 bool IRrecv::match(uint32_t measured, uint32_t desired, uint8_t tolerance,
                    uint16_t delta) {
+  // Resolve the runtime-tolerance sentinel before the cache key below, so
+  // setTolerance() changes can never serve stale bounds.
+  if (tolerance == kUseDefTol) tolerance = activeTolerance();
   measured *= kRawTick;  // Convert to uSecs.
+  // Cache the most recently computed bounds. Decoders call us with the same
+  // desired/tolerance/delta for every bit of a message, so this removes the
+  // bounds arithmetic for all but the first bit of each kind.
+  // Per-thread in the desktop build, so parallel corpus decodes can't
+  // poison each other's cache. (See IR_THREAD_LOCAL)
+  static IR_THREAD_LOCAL bool bounds_cached = false;
+  static IR_THREAD_LOCAL uint32_t cached_desired;
+  static IR_THREAD_LOCAL uint8_t cached_tolerance;
+  static IR_THREAD_LOCAL uint16_t cached_delta;
+  static IR_THREAD_LOCAL uint32_t cached_low;
+  static IR_THREAD_LOCAL uint32_t cached_high;
+  if (!bounds_cached || desired != cached_desired ||
+      tolerance != cached_tolerance || delta != cached_delta) {
+    cached_low = ticksLow(desired, tolerance, delta);
+    cached_high = ticksHigh(desired, tolerance, delta);
+    cached_desired = desired;
+    cached_tolerance = tolerance;
+    cached_delta = delta;
+    bounds_cached = true;
+  }
   DPRINT("Matching: ");
-  DPRINT(ticksLow(desired, tolerance, delta));
+  DPRINT(cached_low);
   DPRINT(" <= ");
   DPRINT(measured);
   DPRINT(" <= ");
-  DPRINTLN(ticksHigh(desired, tolerance, delta));
-  return (measured >= ticksLow(desired, tolerance, delta) &&
-          measured <= ticksHigh(desired, tolerance, delta));
+  DPRINTLN(cached_high);
+  return (measured >= cached_low && measured <= cached_high);
 }
 
 // Check if we match a pulse(measured) of at least desired within
@@ -673,6 +3902,105 @@ bool IRrecv::matchSpace(uint32_t measured, uint32_t desired, uint8_t tolerance,
   return match(measured, desired - excess, tolerance);
 }
 
+// Borrow the decode scratch arena.
+// A single fixed-size workspace, part of the IRrecv object itself, that
+// any decoder attempt can use for its temporaries (run-length arrays,
+// symbol strings, precomputed bounds tables etc.) instead of each keeping
+// its own. i.e. No heap activity during a decode, ever, & a deterministic
+// memory footprint regardless of which decoders run.
+//
+// The arena has exactly one user at a time: borrowing it again simply
+// hands out the same memory, so nothing a decoder leaves in it survives
+// into the next attempt unless that attempt knowingly re-reads it (which
+// is also how prescan artifacts can be shared within one decode() pass).
+// Contents are NOT initialised; the borrower does that.
+//
+// Args:
+//   nr_of_bytes: How much workspace the caller needs.
+// Returns:
+//   A pointer to the (32-bit aligned) arena, or NULL if the request
+//   exceeds kDecodeScratchSize.
+void *IRrecv::scratch(const uint16_t nr_of_bytes) {
+  if (nr_of_bytes > kDecodeScratchSize) return NULL;
+  return _scratch;
+}
+
+// Snap a capture onto a protocol's timing alphabet, in one linear pass.
+// Each rawbuf entry is classified against the supplied list of expected
+// durations (e.g. header mark, bit mark, one space, zero space, gap) &
+// replaced by the index of the first alphabet entry whose tolerance window
+// contains it, producing a small symbol string. A decoder (or sketch) can
+// then recognise a known message by exact symbol comparison (e.g. memcmp()
+// against a stored signature) with no per-entry tolerance arithmetic left
+// at all. Combined with the header-timing dispatch index, recognising a
+// known code becomes: classify the header, quantize, compare symbols.
+//
+// The windows are the same ones matchMark()/matchSpace() use: mark entries
+// (the even positions) are matched with `excess` added to the expected
+// duration & space entries (the odd positions) with it subtracted. Where
+// windows overlap, the earliest alphabet entry wins, so list the most
+// specific (shortest) durations first if that matters.
+//
+// The pass stops at the first entry that fits no window (that entry gets
+// kQuantizeNoSymbol), so the returned length also doubles as "how much of
+// the capture looked like this protocol". The trailing inter-message gap
+// is usually truncated by the capture timeout; give the alphabet no gap
+// entry & expect the pass to stop there instead.
+//
+// Args:
+//   results:       A pointer to the capture to quantize.
+//   alphabet:      The expected durations (usecs), in precedence order.
+//   nr_of_symbols: Nr. of entries in alphabet. Max. kQuantizeAlphabetMax.
+//   symbols:       Where to store the symbol string.
+//   max_symbols:   Capacity of symbols[].
+//   tolerance:     Percentage error margin to allow. (Def: kTolerance)
+//   excess:        Nr. of useconds. (Def: kMarkExcess)
+// Returns:
+//   The nr. of capture entries successfully snapped to a symbol. i.e. The
+//   length of the symbol string, excluding any kQuantizeNoSymbol entry.
+uint16_t IRrecv::quantize(const decode_results *results,
+                          const uint32_t *alphabet,
+                          const uint8_t nr_of_symbols, uint8_t *symbols,
+                          const uint16_t max_symbols, const uint8_t tolerance,
+                          const int16_t excess) {
+  if (nr_of_symbols == 0 || nr_of_symbols > kQuantizeAlphabetMax) return 0;
+  // Precompute each alphabet entry's (inclusive) rawbuf tick bounds once,
+  // for both pulse types, so the classification loop below is pure integer
+  // compares. The uSec bounds are converted to ticks the same way the bulk
+  // kernels (matchData() etc.) do, so the verdicts are exactly what
+  // matchMark()/matchSpace() would have given.
+  uint32_t mark_lo[kQuantizeAlphabetMax];
+  uint32_t mark_hi[kQuantizeAlphabetMax];
+  uint32_t space_lo[kQuantizeAlphabetMax];
+  uint32_t space_hi[kQuantizeAlphabetMax];
+  for (uint8_t s = 0; s < nr_of_symbols; s++) {
+    mark_lo[s] =
+        (ticksLow(alphabet[s] + excess, tolerance) + kRawTick - 1) / kRawTick;
+    mark_hi[s] = ticksHigh(alphabet[s] + excess, tolerance) / kRawTick;
+    space_lo[s] =
+        (ticksLow(alphabet[s] - excess, tolerance) + kRawTick - 1) / kRawTick;
+    space_hi[s] = ticksHigh(alphabet[s] - excess, tolerance) / kRawTick;
+  }
+  uint16_t len = 0;
+  bool is_mark = true;  // Entry kStartOffset is a mark; they alternate.
+  for (uint16_t offset = kStartOffset;
+       offset < results->rawlen && len < max_symbols;
+       offset++, is_mark = !is_mark) {
+    const uint32_t entry = results->rawbuf[offset];
+    const uint32_t *lo = is_mark ? mark_lo : space_lo;
+    const uint32_t *hi = is_mark ? mark_hi : space_hi;
+    uint8_t s = 0;
+    while (s < nr_of_symbols && !(entry >= lo[s] && entry <= hi[s])) s++;
+    symbols[len] = s;
+    if (s >= nr_of_symbols) {  // Fits nothing in the alphabet. Stop here.
+      symbols[len] = kQuantizeNoSymbol;
+      return len;
+    }
+    len++;
+  }
+  return len;
+}
+
 /* -----------------------------------------------------------------------
  * hashdecode - decode an arbitrary IR code.
  * Instead of decoding using a standard encoding scheme
@@ -707,6 +4035,27 @@ int16_t IRrecv::compare(uint16_t oldval, uint16_t newval) {
 bool IRrecv::decodeHash(decode_results *results) {
   // Require at least some samples to prevent triggering on noise
   if (results->rawlen < unknown_threshold) return false;
+  results->value = getCaptureHash(results);
+  results->bits = results->rawlen / 2;
+  results->address = 0;
+  results->command = 0;
+  results->decode_type = UNKNOWN;
+  return true;
+}
+
+// Obtain the FNV-1 hash of the capture in results.
+// This is the same hash decodeHash() reports for UNKNOWN messages, making it
+// usable as a cheap dedup/fingerprint key even when a message was decoded as
+// a proper protocol. It is calculated at most once per capture: the value is
+// cached, & further calls during the same decode are free.
+//
+// Args:
+//   results:  A pointer to the capture to hash. i.e. The most recent
+//             decode()/decodePoll() result.
+// Returns:
+//   A 32-bit FNV-1 hash of the capture's timing sequence.
+uint32_t IRrecv::getCaptureHash(decode_results *results) {
+  if (_hash_valid) return _hash_value;
   int32_t hash = kFnvBasis32;
   // 'rawlen - 2' to avoid the look ahead from going out of bounds.
   // Should probably be -3 to avoid comparing the trailing space entry,
@@ -717,12 +4066,9 @@ bool IRrecv::decodeHash(decode_results *results) {
     // Add value into the hash
     hash = (hash * kFnvPrime32) ^ value;
   }
-  results->value = hash & 0xFFFFFFFF;
-  results->bits = results->rawlen / 2;
-  results->address = 0;
-  results->command = 0;
-  results->decode_type = UNKNOWN;
-  return true;
+  _hash_value = hash & 0xFFFFFFFF;
+  _hash_valid = true;
+  return _hash_value;
 }
 #endif  // DECODE_HASH
 
@@ -744,24 +4090,71 @@ bool IRrecv::decodeHash(decode_results *results) {
 //  A match_result_t structure containing the success (or not), the data value,
 //  and how many buffer entries were used.
 match_result_t IRrecv::matchData(
-    volatile uint16_t *data_ptr, const uint16_t nbits, const uint16_t onemark,
+    const uint16_t *data_ptr, const uint16_t nbits, const uint16_t onemark,
     const uint32_t onespace, const uint16_t zeromark, const uint32_t zerospace,
     const uint8_t tolerance, const int16_t excess, const bool MSBfirst) {
   match_result_t result;
   result.success = false;  // Fail by default.
   result.data = 0;
-  for (result.used = 0; result.used < nbits * 2;
-       result.used += 2, data_ptr += 2) {
-    // Is the bit a '1'?
-    if (matchMark(*data_ptr, onemark, tolerance, excess) &&
-        matchSpace(*(data_ptr + 1), onespace, tolerance, excess)) {
-      result.data = (result.data << 1) | 1;
-    } else if (matchMark(*data_ptr, zeromark, tolerance, excess) &&
-               matchSpace(*(data_ptr + 1), zerospace, tolerance, excess)) {
-      result.data <<= 1;  // The bit is a '0'.
-    } else {
-      if (!MSBfirst) result.data = reverseBits(result.data, result.used / 2);
-      return result;  // It's neither, so fail.
+  // Precompute the (inclusive) rawbuf tick bounds for each of the four
+  // expected pulse types once, instead of via matchMark()/matchSpace() for
+  // every single bit. This is the hot loop for the long A/C decodes, where
+  // it means 4 bounds calculations total instead of up to 4 per bit.
+  // The uSec bounds are converted to rawbuf ticks here (ceiling for the
+  // lower, floor for the upper), so the comparisons below are exactly
+  // equivalent to what matchMark()/matchSpace() would have concluded.
+  const uint32_t om_low =
+      (ticksLow(onemark + excess, tolerance) + kRawTick - 1) / kRawTick;
+  const uint32_t om_high = ticksHigh(onemark + excess, tolerance) / kRawTick;
+  const uint32_t os_low =
+      (ticksLow(onespace - excess, tolerance) + kRawTick - 1) / kRawTick;
+  const uint32_t os_high = ticksHigh(onespace - excess, tolerance) / kRawTick;
+  const uint32_t zm_low =
+      (ticksLow(zeromark + excess, tolerance) + kRawTick - 1) / kRawTick;
+  const uint32_t zm_high = ticksHigh(zeromark + excess, tolerance) / kRawTick;
+  const uint32_t zs_low =
+      (ticksLow(zerospace - excess, tolerance) + kRawTick - 1) / kRawTick;
+  const uint32_t zs_high = ticksHigh(zerospace - excess, tolerance) / kRawTick;
+  if (nbits <= 32) {
+    // Accumulate in a native 32 bit value whenever the data fits. 64 bit
+    // shifts are library helper calls on these 32 bit MCUs, & this loop
+    // runs per bit for every decoder built on matchData(). Most remote
+    // control protocols are <= 32 bits, so this is the dominant case.
+    uint32_t data32 = 0;
+    for (result.used = 0; result.used < nbits * 2;
+         result.used += 2, data_ptr += 2) {
+      const uint32_t mark = *data_ptr;
+      const uint32_t space = *(data_ptr + 1);
+      // Is the bit a '1'?
+      if (mark >= om_low && mark <= om_high &&
+          space >= os_low && space <= os_high) {
+        data32 = (data32 << 1) | 1;
+      } else if (mark >= zm_low && mark <= zm_high &&
+                 space >= zs_low && space <= zs_high) {
+        data32 <<= 1;  // The bit is a '0'.
+      } else {
+        result.data = data32;
+        if (!MSBfirst) result.data = reverseBits(result.data, result.used / 2);
+        return result;  // It's neither, so fail.
+      }
+    }
+    result.data = data32;
+  } else {
+    for (result.used = 0; result.used < nbits * 2;
+         result.used += 2, data_ptr += 2) {
+      const uint32_t mark = *data_ptr;
+      const uint32_t space = *(data_ptr + 1);
+      // Is the bit a '1'?
+      if (mark >= om_low && mark <= om_high &&
+          space >= os_low && space <= os_high) {
+        result.data = (result.data << 1) | 1;
+      } else if (mark >= zm_low && mark <= zm_high &&
+                 space >= zs_low && space <= zs_high) {
+        result.data <<= 1;  // The bit is a '0'.
+      } else {
+        if (!MSBfirst) result.data = reverseBits(result.data, result.used / 2);
+        return result;  // It's neither, so fail.
+      }
     }
   }
   result.success = true;
@@ -769,4 +4162,214 @@ match_result_t IRrecv::matchData(
   return result;
 }
 
+// Match & decode a run of whole bytes of an IR message into a byte array.
+// This is the bulk kernel for the byte-array A/C decoders. Compared to
+// calling matchData() once per byte it calculates the pulse bounds once per
+// run instead of once per byte, and it can accumulate a running sum of the
+// bytes as they are stored, so a simple additive checksum can be verified
+// without a second pass over the state afterwards.
+//
+// Args:
+//   data_ptr:   A pointer to where we are at in the capture buffer.
+//   result_ptr: Where to store the bytes we decode.
+//   remaining:  Nr. of entries left in the capture buffer.
+//   nbytes:     Nr. of data bytes we want.
+//   onemark:    Nr. of uSeconds in an expected mark signal for a '1' bit.
+//   onespace:   Nr. of uSeconds in an expected space signal for a '1' bit.
+//   zeromark:   Nr. of uSeconds in an expected mark signal for a '0' bit.
+//   zerospace:  Nr. of uSeconds in an expected space signal for a '0' bit.
+//   tolerance:  Percentage error margin to allow. (Def: kTolerance)
+//   excess:     Nr. of useconds. (Def: kMarkExcess)
+//   MSBfirst:   Bit order to save the data in. (Def: true)
+//   sum:        Ptr to a running sum to add each stored byte to. (Def: NULL)
+// Returns:
+//   The nr. of bytes (fully) matched & stored. Anything less than nbytes
+//   means the message ran out or stopped matching at that point.
+uint16_t IRrecv::matchBytes(const uint16_t *data_ptr, uint8_t *result_ptr,
+                            const uint16_t remaining, const uint16_t nbytes,
+                            const uint16_t onemark, const uint32_t onespace,
+                            const uint16_t zeromark, const uint32_t zerospace,
+                            const uint8_t tolerance, const int16_t excess,
+                            const bool MSBfirst, uint8_t *sum) {
+  // Precompute the (inclusive) rawbuf tick bounds for the four expected
+  // pulse types, exactly as matchData() does, but for the entire run.
+  const uint32_t om_low =
+      (ticksLow(onemark + excess, tolerance) + kRawTick - 1) / kRawTick;
+  const uint32_t om_high = ticksHigh(onemark + excess, tolerance) / kRawTick;
+  const uint32_t os_low =
+      (ticksLow(onespace - excess, tolerance) + kRawTick - 1) / kRawTick;
+  const uint32_t os_high = ticksHigh(onespace - excess, tolerance) / kRawTick;
+  const uint32_t zm_low =
+      (ticksLow(zeromark + excess, tolerance) + kRawTick - 1) / kRawTick;
+  const uint32_t zm_high = ticksHigh(zeromark + excess, tolerance) / kRawTick;
+  const uint32_t zs_low =
+      (ticksLow(zerospace - excess, tolerance) + kRawTick - 1) / kRawTick;
+  const uint32_t zs_high = ticksHigh(zerospace - excess, tolerance) / kRawTick;
+  // Only whole bytes the capture buffer can actually contain.
+  const uint16_t limit = std::min(nbytes, (uint16_t)(remaining / 16));
+  for (uint16_t byte = 0; byte < limit; byte++) {
+    uint8_t data = 0;
+    for (uint8_t bit = 0; bit < 8; bit++, data_ptr += 2) {
+      const uint32_t mark = *data_ptr;
+      const uint32_t space = *(data_ptr + 1);
+      // Is the bit a '1'?
+      if (mark >= om_low && mark <= om_high &&
+          space >= os_low && space <= os_high) {
+        data = (data << 1) | 1;
+      } else if (mark >= zm_low && mark <= zm_high &&
+                 space >= zs_low && space <= zs_high) {
+        data <<= 1;  // The bit is a '0'.
+      } else {
+        return byte;  // It's neither, so stop here.
+      }
+    }
+    if (!MSBfirst) data = reverseBits(data, 8);
+    result_ptr[byte] = data;
+    if (sum != NULL) *sum += data;
+  }
+  return limit;
+}
+
+// Match & decode a generic/typical IR message in a single fused pass.
+// i.e. Header mark + Header space + Data + Footer mark + Footer space/gap.
+// This is the shared engine behind the two matchGeneric() wrappers below.
+// The header & footer are matched inline and the data section is handed to
+// the precomputed-bounds bulk kernels (matchData()/matchBytes()), so a
+// decoder built on this does one call & no offset bookkeeping of its own.
+//
+// Note: Values of 0 for hdrmark, hdrspace, footermark, or footerspace mean
+//       that phase is skipped & consumes no buffer entries.
+//
+// Args:
+//   data_ptr:         A pointer to where we are at in the capture buffer.
+//   result_bits_ptr:  A pointer to where to start storing the bits we decode.
+//   result_bytes_ptr: A pointer to where to start storing the bytes we decode.
+//   use_bits:         A flag indicating if we are to decode bits or bytes.
+//   remaining:        Nr. of entries remaining in the capture buffer.
+//   nbits:            Nr. of data bits we expect.
+//   hdrmark:          Nr. of uSeconds for the expected header mark signal.
+//   hdrspace:         Nr. of uSeconds for the expected header space signal.
+//   onemark:          Nr. of uSeconds in an expected mark signal for a '1'.
+//   onespace:         Nr. of uSeconds in an expected space signal for a '1'.
+//   zeromark:         Nr. of uSeconds in an expected mark signal for a '0'.
+//   zerospace:        Nr. of uSeconds in an expected space signal for a '0'.
+//   footermark:       Nr. of uSeconds for the expected footer mark signal.
+//   footerspace:      Nr. of uSeconds for the expected footer space/gap.
+//   atleast:          Is the footer space an "at least" length? (Def: false)
+//   tolerance:        Percentage error margin to allow. (Def: kTolerance)
+//   excess:           Nr. of useconds. (Def: kMarkExcess)
+//   MSBfirst:         Bit order to save the data in. (Def: true)
+// Returns:
+//   The nr. of capture buffer entries matched & used, or 0 if no match.
+uint16_t IRrecv::_matchGeneric(const uint16_t *data_ptr,
+                               uint64_t *result_bits_ptr,
+                               uint8_t *result_bytes_ptr,
+                               const bool use_bits,
+                               const uint16_t remaining,
+                               const uint16_t nbits,
+                               const uint16_t hdrmark,
+                               const uint32_t hdrspace,
+                               const uint16_t onemark,
+                               const uint32_t onespace,
+                               const uint16_t zeromark,
+                               const uint32_t zerospace,
+                               const uint16_t footermark,
+                               const uint32_t footerspace,
+                               const bool atleast,
+                               const uint8_t tolerance,
+                               const int16_t excess,
+                               const bool MSBfirst) {
+  // If we are expecting byte sizes, check it's a factor of 8 or fail.
+  if (!use_bits && nbits % 8 != 0) return 0;
+  // Calculate the minimum nr. of buffer entries the message needs.
+  // Note: The footer space isn't included as it may be the end of the capture.
+  uint16_t min_remaining = nbits * 2;
+  if (hdrmark) min_remaining++;
+  if (hdrspace) min_remaining++;
+  if (footermark) min_remaining++;
+  if (remaining < min_remaining) return 0;  // Can't possibly fit. Fail.
+
+  uint16_t offset = 0;
+  // Header
+  if (hdrmark && !matchMark(*(data_ptr + offset++), hdrmark, tolerance,
+                            excess))
+    return 0;
+  if (hdrspace && !matchSpace(*(data_ptr + offset++), hdrspace, tolerance,
+                              excess))
+    return 0;
+  // Data
+  if (use_bits) {  // Decode as a single value.
+    match_result_t result =
+        matchData(data_ptr + offset, nbits, onemark, onespace, zeromark,
+                  zerospace, tolerance, excess, MSBfirst);
+    if (!result.success) return 0;
+    *result_bits_ptr = result.data;
+    offset += result.used;
+  } else {  // Decode as a byte array.
+    if (matchBytes(data_ptr + offset, result_bytes_ptr,
+                   remaining - offset, nbits / 8, onemark, onespace,
+                   zeromark, zerospace, tolerance, excess,
+                   MSBfirst) != nbits / 8)
+      return 0;  // We didn't match all the bytes we wanted.
+    offset += nbits * 2;
+  }
+  // Footer
+  if (footermark && !matchMark(*(data_ptr + offset++), footermark, tolerance,
+                               excess))
+    return 0;
+  // If we have something still to match & haven't reached the end of the
+  // buffer.
+  if (footerspace && offset < remaining) {
+    if (atleast) {
+      if (!matchAtLeast(*(data_ptr + offset), footerspace, tolerance, excess))
+        return 0;
+    } else {
+      if (!matchSpace(*(data_ptr + offset), footerspace, tolerance, excess))
+        return 0;
+    }
+    offset++;
+  }
+  return offset;
+}
+
+// Match & decode a generic/typical <= 64bit IR message.
+// The data is stored at result_ptr.
+// See _matchGeneric() above for the details of the Args & Returns.
+uint16_t IRrecv::matchGeneric(const uint16_t *data_ptr,
+                              uint64_t *result_ptr,
+                              const uint16_t remaining, const uint16_t nbits,
+                              const uint16_t hdrmark, const uint32_t hdrspace,
+                              const uint16_t onemark, const uint32_t onespace,
+                              const uint16_t zeromark,
+                              const uint32_t zerospace,
+                              const uint16_t footermark,
+                              const uint32_t footerspace, const bool atleast,
+                              const uint8_t tolerance, const int16_t excess,
+                              const bool MSBfirst) {
+  return _matchGeneric(data_ptr, result_ptr, NULL, true, remaining, nbits,
+                       hdrmark, hdrspace, onemark, onespace, zeromark,
+                       zerospace, footermark, footerspace, atleast, tolerance,
+                       excess, MSBfirst);
+}
+
+// Match & decode a generic/typical > 64bit IR message.
+// The bytes are stored at result_ptr. The first byte in the result equates
+// to the first byte encountered, and so on.
+// See _matchGeneric() above for the details of the Args & Returns.
+uint16_t IRrecv::matchGeneric(const uint16_t *data_ptr, uint8_t *result_ptr,
+                              const uint16_t remaining, const uint16_t nbits,
+                              const uint16_t hdrmark, const uint32_t hdrspace,
+                              const uint16_t onemark, const uint32_t onespace,
+                              const uint16_t zeromark,
+                              const uint32_t zerospace,
+                              const uint16_t footermark,
+                              const uint32_t footerspace, const bool atleast,
+                              const uint8_t tolerance, const int16_t excess,
+                              const bool MSBfirst) {
+  return _matchGeneric(data_ptr, NULL, result_ptr, false, remaining, nbits,
+                       hdrmark, hdrspace, onemark, onespace, zeromark,
+                       zerospace, footermark, footerspace, atleast, tolerance,
+                       excess, MSBfirst);
+}
+
 // End of IRrecv class -------------------
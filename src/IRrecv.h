@@ -13,6 +13,7 @@
 #define __STDC_LIMIT_MACROS
 #include <stdint.h>
 #include "IRremoteESP8266.h"
+#include "IRtimer.h"
 
 // Constants
 const uint16_t kHeader = 2;        // Usual nr. of header entries.
@@ -33,7 +34,28 @@ const uint8_t kMarkState = 3;
 const uint8_t kSpaceState = 4;
 const uint8_t kStopState = 5;
 const uint8_t kTolerance = 25;  // default percent tolerance in measurements.
+// Sentinel tolerance value meaning "use the receiver's runtime setting".
+// i.e. setTolerance()'s per-instance value, or a per-protocol override of
+// it. Only call sites passing an *explicit* tolerance bypass it.
+const uint8_t kUseDefTol = 0xFF;
 const uint16_t kRawTick = 2;    // Capture tick to uSec factor.
+
+// Compile-time equivalents of IRrecv::ticksLow()/ticksHigh(). (Identical
+// integer maths.) Use these to derive match bounds from protocol timing
+// constants at build time, rather than recomputing them per decode call.
+constexpr uint32_t matchBoundLow(const uint32_t usecs,
+                                 const uint8_t tolerance = kTolerance,
+                                 const uint16_t delta = 0) {
+  return ((int64_t)usecs * (100 - tolerance) / 100 - delta < 0)
+             ? 0
+             : (uint32_t)((int64_t)usecs * (100 - tolerance) / 100 - delta);
+}
+
+constexpr uint32_t matchBoundHigh(const uint32_t usecs,
+                                  const uint8_t tolerance = kTolerance,
+                                  const uint16_t delta = 0) {
+  return (uint32_t)((int64_t)usecs * (100 + tolerance) / 100) + 1 + delta;
+}
 #define RAWTICK kRawTick  // Deprecated. For legacy user code support only.
 // How long (ms) before we give up wait for more data?
 // Don't exceed kMaxTimeoutMs without a good reason.
@@ -46,32 +68,255 @@ const uint16_t kRawTick = 2;    // Capture tick to uSec factor.
 const uint8_t kTimeoutMs = 15;  // In MilliSeconds.
 #define TIMEOUT_MS kTimeoutMs   // For legacy documentation.
 const uint16_t kMaxTimeoutMs = kRawTick * (UINT16_MAX / MS_TO_USEC(1));
+// The shortest effective timeout the protocol-mask-derived (adaptive)
+// timeout mode will drop to. Comfortably covers the common consumer
+// (TV/set-top) protocols, whose longest in-frame quiet periods are all
+// under ~10ms. See IRrecv::setAdaptiveTimeout().
+const uint8_t kTimeoutAdaptiveFloorMs = 12;  // In MilliSeconds.
+
+// Default minimum pulse width for the optional capture noise filter.
+// Demodulated IR marks/spaces are rarely shorter than this, while electrical
+// glitches (e.g. from fluorescent ballasts) usually are.
+// See IRrecv::setNoiseFilter().
+const uint16_t kNoiseFloorUsecs = 100;  // In uSeconds.
+// Max nr. of protocols in an explicit decoder trial order.
+// See IRrecv::setDecodePriority().
+const uint8_t kDecodePriorityMax = 8;
+// Max nr. of patterns the first-stage trigger filter can hold.
+// See IRrecv::addTriggerFilter().
+const uint8_t kTriggerFiltersMax = 4;
+// Max nr. of per-protocol tolerance overrides. See IRrecv::setTolerance().
+const uint8_t kToleranceOverridesMax = 8;
+// Max nr. of wand IDs the MagiQuest registered-wand filter can hold.
+// See IRrecv::addMagiQuestWand().
+const uint8_t kMagiQuestWandsMax = 8;
+// Carrier frequency measurement, for checking emitter/receiver hardware
+// pairing. See IRrecv::measureCarrierFreq().
+// How long to sample the unfiltered receiver for, by default.
+const uint16_t kCarrierMeasureWindowMs = 100;  // In MilliSeconds.
+// An edge-to-edge interval longer than this is the gap between two marks
+// (or plain silence), not part of a carrier burst.
+const uint16_t kCarrierMeasureMaxGapUsecs = 100;  // In uSeconds.
+// Fewer carrier edges than this in the window means we didn't really see
+// a transmission, just noise.
+const uint16_t kCarrierMeasureMinEdges = 32;
+// Size (bytes) of the fixed scratch arena decoders can borrow for their
+// working memory (run arrays, symbol strings, bounds tables etc.), instead
+// of each keeping their own. See IRrecv::scratch().
+const uint16_t kDecodeScratchSize = 160;
+// Max. nr. of durations in a timing alphabet handed to IRrecv::quantize().
+const uint8_t kQuantizeAlphabetMax = 8;
+// The symbol IRrecv::quantize() emits for an entry that fits no alphabet
+// window.
+const uint8_t kQuantizeNoSymbol = 0xFF;
+
+// Max nr. of successive half-bit widths getRClevel() can be asked to span.
+// i.e. The largest `maxwidth` any of the Manchester-coded decoders use.
+// (Currently kMWMMaxWidth, at 9)
+const uint8_t kRcLevelMaxWidth = 9;
 
 // Use FNV hash algorithm: http://isthe.com/chongo/tech/comp/fnv/#FNV-param
 const uint32_t kFnvPrime32 = 16777619UL;
 const uint32_t kFnvBasis32 = 2166136261UL;
 
-#if DECODE_AC
-// Hitachi AC is the current largest state size.
-const uint16_t kStateSizeMax = kHitachiAc2StateLength;
-#else
-// Just define something
-const uint16_t kStateSizeMax = 0;
-#endif
+// The state[] sizes of the enabled multi-byte (A/C) decoders, each
+// contributing its largest form. Disabled protocols contribute nothing, so
+// a build's decode_results (& every saved/queued copy of it) is sized by
+// the largest protocol it actually decodes, not by the largest one the
+// library knows about.
+constexpr uint16_t kStateSizes[] = {
+    0,  // So the list is never empty. (e.g. A 64-bit-protocols-only build)
+#if DECODE_ARGO
+    kArgoStateLength,
+#endif  // DECODE_ARGO
+#if DECODE_DAIKIN
+    kDaikinStateLength,
+#endif  // DECODE_DAIKIN
+#if DECODE_DAIKIN2
+    kDaikin2StateLength,
+#endif  // DECODE_DAIKIN2
+#if DECODE_DAIKIN216
+    kDaikin216StateLength,
+#endif  // DECODE_DAIKIN216
+#if DECODE_ELECTRA_AC
+    kElectraAcStateLength,
+#endif  // DECODE_ELECTRA_AC
+#if DECODE_FUJITSU_AC
+    kFujitsuAcStateLength,
+#endif  // DECODE_FUJITSU_AC
+#if DECODE_GREE
+    kGreeStateLength,
+#endif  // DECODE_GREE
+#if DECODE_HAIER_AC
+    kHaierACStateLength,
+#endif  // DECODE_HAIER_AC
+#if DECODE_HAIER_AC_YRW02
+    kHaierACYRW02StateLength,
+#endif  // DECODE_HAIER_AC_YRW02
+#if DECODE_HITACHI_AC
+    kHitachiAcStateLength,
+#endif  // DECODE_HITACHI_AC
+#if DECODE_HITACHI_AC1
+    kHitachiAc1StateLength,
+#endif  // DECODE_HITACHI_AC1
+#if DECODE_HITACHI_AC2
+    kHitachiAc2StateLength,
+#endif  // DECODE_HITACHI_AC2
+#if DECODE_KELVINATOR
+    kKelvinatorStateLength,
+#endif  // DECODE_KELVINATOR
+#if DECODE_MITSUBISHI_AC
+    kMitsubishiACStateLength,
+#endif  // DECODE_MITSUBISHI_AC
+#if DECODE_MITSUBISHIHEAVY
+    kMitsubishiHeavy152StateLength,
+#endif  // DECODE_MITSUBISHIHEAVY
+#if DECODE_MWM
+    // MWM is a free-length serial stream whose decoder caps itself at
+    // kStateSizeMax, so it has no natural size. Keep its historical
+    // (largest-A/C) ceiling.
+    kHitachiAc2StateLength,
+#endif  // DECODE_MWM
+#if DECODE_PANASONIC_AC
+    kPanasonicAcStateLength,
+#endif  // DECODE_PANASONIC_AC
+#if DECODE_SAMSUNG_AC
+    kSamsungAcExtendedStateLength,
+#endif  // DECODE_SAMSUNG_AC
+#if DECODE_SHARP_AC
+    kSharpAcStateLength,
+#endif  // DECODE_SHARP_AC
+#if DECODE_TCL112AC
+    kTcl112AcStateLength,
+#endif  // DECODE_TCL112AC
+#if DECODE_TOSHIBA_AC
+    kToshibaACStateLength,
+#endif  // DECODE_TOSHIBA_AC
+#if DECODE_TROTEC
+    kTrotecStateLength,
+#endif  // DECODE_TROTEC
+#if DECODE_WHIRLPOOL_AC
+    kWhirlpoolAcStateLength,
+#endif  // DECODE_WHIRLPOOL_AC
+};
+
+// Compile-time maximum over kStateSizes[]. (A C++11 constexpr function is
+// a single return expression, hence the accumulator-style recursion.)
+constexpr uint16_t stateSizeMax(const uint16_t *sizes, const uint16_t len,
+                                const uint16_t best = 0) {
+  return len == 0 ? best
+                  : stateSizeMax(sizes + 1, len - 1,
+                                 sizes[0] > best ? sizes[0] : best);
+}
+
+// The largest state[] any enabled protocol can produce.
+constexpr uint16_t kStateSizeMax =
+    stateSizeMax(kStateSizes, sizeof(kStateSizes) / sizeof(kStateSizes[0]));
 
 // Types
+// A registered trigger-filter pattern. See IRrecv::addTriggerFilter().
+typedef struct {
+  decode_type_t protocol;  // Required header timings. UNKNOWN == any.
+  uint32_t fingerprint;    // Required getCaptureHash() value. 0 == any.
+} irtrigger_t;
+
+// A per-protocol match-tolerance override. See IRrecv::setTolerance().
+typedef struct {
+  decode_type_t protocol;
+  uint8_t percent;
+} irtolerance_t;
+
+#if IRRECV_STATS
+// Per-decoder decode statistics. See IRrecv::getDecodeStats().
+typedef struct {
+  uint32_t attempts;   // Nr. of times the decoder was attempted.
+  uint32_t successes;  // Nr. of attempts that successfully decoded.
+  uint32_t usecs;      // Total nr. of uSeconds spent on those attempts.
+} decoder_stats_t;
+#endif  // IRRECV_STATS
+
+#if IRMEM_STATS
+// What an IRrecv constructor does when a capture buffer allocation fails.
+// See IRrecv::setHeapPolicy().
+typedef enum {
+  kIRHeapReboot = 0,  // Legacy behaviour. Reboot the device. (Default)
+  kIRHeapShrink,      // Retry with progressively halved buffer sizes.
+  kIRHeapStatic,      // Fall back to a small (kRawBuf entries) static buffer.
+} irheap_policy_t;
+#endif  // IRMEM_STATS
+
+#if RAWBUF_COMPRESSION
+// Frame queue capture compression. See IRrecv::setFrameQueue().
+const uint8_t kFrameDictEntries = 15;  // Max nr. of timing symbols per frame.
+const uint8_t kFrameDictEscape = 15;   // Nibble code marking a raw value.
+#endif  // RAWBUF_COMPRESSION
+
+#if COMPACT_RAWBUF
+// Compact (8-bit) live capture buffer format. See IRrecv::setCompactBuffer().
+// Entries are single bytes in kCompactTick uSecond units. A duration too long
+// for a byte is kept exact: kCompactEscape followed by two bytes
+// (little-endian) in the usual kRawTick units.
+const uint16_t kCompactTick = 16;     // uSecs. i.e. 8 * kRawTick.
+const uint8_t kCompactEscape = 0xFF;  // Marks a full 16-bit entry following.
+#endif  // COMPACT_RAWBUF
+
+#if DECODE_HASH
+// The repeat-frame cache. See IRrecv::setRepeatCache().
+const uint8_t kRepeatCacheEntries = 4;  // Nr. of distinct captures remembered.
+
+// A remembered decode, keyed on the capture's timing fingerprint.
+typedef struct {
+  uint32_t fingerprint;  // FNV hash of the capture's timings. 0 == unused.
+  decode_type_t decode_type;
+  uint16_t bits;
+  uint64_t value;    // value/address/command & state mirror decode_results.
+  uint32_t address;
+  uint32_t command;
+  uint8_t state[kStateSizeMax];  // Multi-byte (A/C) results.
+} irrepeat_t;
+#endif  // DECODE_HASH
+
+// A completed capture in the frame queue. See IRrecv::setFrameQueue().
+typedef struct {
+  uint16_t *rawbuf;  // The captured raw data.
+  uint16_t rawlen;   // Nr. of entries in rawbuf.
+  uint8_t overflow;  // Buffer overflow indicator.
+#if RAWBUF_COMPRESSION
+  // Compressed capture storage, used instead of rawbuf when the queue is in
+  // compressed mode.
+  uint8_t *nibbles;  // 4-bit dictionary codes, two per byte.
+  uint16_t dict[kFrameDictEntries];  // This frame's timing symbols (ticks).
+  uint8_t dictlen;   // Nr. of entries of dict in use.
+#endif  // RAWBUF_COMPRESSION
+} irframe_t;
+
 // information for the interrupt handler
 typedef struct {
-  uint8_t recvpin;   // pin for IR data from detector
-  uint8_t rcvstate;  // state machine
-  uint16_t timer;    // state timer, counts 50uS ticks.
+  // The hot cluster: the edge interrupt reads & writes all three of these
+  // on every edge, so they share one aligned word it can load & store in a
+  // single volatile access. (See IRrecv::gpioIntr())
+  union {
+    struct {
+      uint8_t rcvstate;  // state machine
+      uint8_t overflow;  // Buffer overflow indicator.
+      // uint16_t is used for rawlen as it saves 3 bytes of iram in the
+      // interrupt handler. Don't ask why, I don't know. It just does.
+      uint16_t rawlen;   // counter of entries in rawbuf.
+    };
+    // The cluster as a single 32-bit word. i.e.
+    // rcvstate | overflow << 8 | rawlen << 16, on the little-endian cores
+    // we support. Interrupt handler use only.
+    uint32_t capture_word;
+  };
   uint16_t bufsize;  // max. nr. of entries in the capture buffer.
-  uint16_t *rawbuf;  // raw data
-  // uint16_t is used for rawlen as it saves 3 bytes of iram in the interrupt
-  // handler. Don't ask why, I don't know. It just does.
-  uint16_t rawlen;   // counter of entries in rawbuf.
-  uint8_t overflow;  // Buffer overflow indicator.
   uint8_t timeout;   // Nr. of milliSeconds before we give up.
+  uint8_t recvpin;   // pin for IR data from detector
+  uint16_t *rawbuf;  // raw data
+  uint16_t timer;    // state timer, counts 50uS ticks.
+#if COMPACT_RAWBUF
+  uint8_t compact;    // Is rawbuf storing compact (8-bit) entries?
+  uint16_t rawbytes;  // Nr. of bytes of rawbuf used in compact mode.
+#endif  // COMPACT_RAWBUF
 } irparams_t;
 
 // results from a data match
@@ -81,6 +326,47 @@ typedef struct {
   uint16_t used;  // How many buffer positions were used.
 } match_result_t;
 
+// Nr. of 64-bit words needed for the runtime protocol enable bitmap.
+// Bit (protocol + 1) of the bitmap governs that protocol, so UNKNOWN (i.e.
+// the decodeHash() fall-back) gets bit 0. See IRrecv::setProtocolMask().
+const uint16_t kProtocolMaskWords = (kLastDecodeType + 2 + 63) / 64;
+
+// The tolerance used by the header-timing dispatch index. A bump over
+// kTolerance, as the index is just a crude classifier and we never want it
+// to be fussier than the actual decoders.
+const uint8_t kHeaderIndexTolerance = kTolerance + 10;  // Percent.
+
+// An entry in the header-timing dispatch index used by decode().
+// It maps the expected header timings of a protocol to the decoder to try.
+// The acceptance windows are derived from the nominal timings at compile
+// time (via matchBoundLow()/matchBoundHigh()), so at runtime the index only
+// compares the capture against immediate constants.
+struct header_index_t {
+  decode_type_t protocol;  // Protocol to attempt if the header matches.
+  uint16_t hdrmark;        // Nominal header mark (uSecs). 0 == end of index.
+  uint16_t hdrspace;       // Nominal header space (uSecs). 0 == don't care.
+  uint32_t mark_low;       // Smallest acceptable header mark (uSecs).
+  uint32_t mark_high;      // Largest acceptable header mark (uSecs).
+  uint32_t space_low;      // Smallest acceptable header space (uSecs).
+  uint32_t space_high;     // Largest acceptable header space (uSecs).
+  constexpr header_index_t(const decode_type_t protocol_,
+                           const uint16_t hdrmark_, const uint16_t hdrspace_)
+      : protocol(protocol_),
+        hdrmark(hdrmark_),
+        hdrspace(hdrspace_),
+        // The same adjustments matchMark()/matchSpace() apply at runtime.
+        mark_low(matchBoundLow(hdrmark_ + kMarkExcess,
+                               kHeaderIndexTolerance)),
+        mark_high(matchBoundHigh(hdrmark_ + kMarkExcess,
+                                 kHeaderIndexTolerance)),
+        space_low(hdrspace_ ? matchBoundLow(hdrspace_ - kMarkExcess,
+                                            kHeaderIndexTolerance)
+                            : 0),
+        space_high(hdrspace_ ? matchBoundHigh(hdrspace_ - kMarkExcess,
+                                              kHeaderIndexTolerance)
+                             : 0) {}
+};
+
 // Classes
 
 // Results returned from the decoder
@@ -98,59 +384,384 @@ class decode_results {
     };
     uint8_t state[kStateSizeMax];  // Multi-byte results.
   };
-  uint16_t bits;              // Number of bits in decoded value
-  volatile uint16_t *rawbuf;  // Raw intervals in .5 us ticks
-  uint16_t rawlen;            // Number of records in rawbuf.
+  uint16_t bits;     // Number of bits in decoded value
+  // Raw intervals in .5 us ticks. Deliberately NOT volatile: decode() only
+  // points this at a capture the interrupt handler has finished with (i.e.
+  // post-kStopState, a saved copy, or a released frame queue slot), so the
+  // decoders' many reads of it may be cached/combined by the compiler.
+  uint16_t *rawbuf;
+  uint16_t rawlen;   // Number of records in rawbuf.
   bool overflow;
   bool repeat;  // Is the result a repeat code?
 };
 
+// A compact decode result, for queueing or passing between tasks/cores.
+// Unlike decode_results it carries no capture buffer pointers & no
+// kStateSizeMax-sized union, so for the simple (<= 64 bit) protocols it is
+// a small trivially-copyable value. For the byte-array A/C protocols it
+// owns a right-sized heap copy of the state instead; ownership is explicit
+// & transferred on move, never silently duplicated on copy.
+class IRCompactResult {
+ public:
+  IRCompactResult();
+  ~IRCompactResult();
+  // Movable, not copyable. Moving transfers ownership of any state buffer.
+  IRCompactResult(IRCompactResult &&other);
+  IRCompactResult &operator=(IRCompactResult &&other);
+  IRCompactResult(const IRCompactResult &) = delete;
+  IRCompactResult &operator=(const IRCompactResult &) = delete;
+
+  // Load from a full decode_results. Copies the state (if any) to the heap.
+  void loadFrom(const decode_results *results);
+  // Discard any owned state & reset to the (empty) UNKNOWN result.
+  void clear(void);
+  // Does this result use a state array rather than the value?
+  bool hasState(void) const { return _state != NULL; }
+  // Nr. of bytes in the state array. (0 if hasState() is false)
+  uint16_t stateSize(void) const { return _state != NULL ? (bits + 7) / 8 : 0; }
+  const uint8_t *state(void) const { return _state; }
+
+  decode_type_t decode_type;  // NEC, SONY, RC5, UNKNOWN etc.
+  uint64_t value;             // Decoded value. (unused when hasState())
+  uint16_t bits;              // Number of bits in the decoded result.
+  bool repeat;                // Is the result a repeat code?
+
+ private:
+  uint8_t *_state;  // Owned heap copy of the state, or NULL.
+};
+
 // main class for receiving IR
 class IRrecv {
  public:
+#if defined(ESP32)
+  // On the ESP32 the RMT peripheral does the capture in hardware, so we also
+  // need to know which RMT channel to claim for it.
+  explicit IRrecv(uint16_t recvpin, uint16_t bufsize = kRawBuf,
+                  uint8_t timeout = kTimeoutMs, bool save_buffer = false,
+                  uint8_t rmt_channel = 0);  // Constructor
+  // As above, but with caller-provided (e.g. static) capture buffers.
+  // i.e. Zero heap allocation. The buffers must outlive the IRrecv.
+  IRrecv(uint16_t recvpin, uint16_t *rawbuf, uint16_t bufsize,
+         uint8_t timeout = kTimeoutMs, uint16_t *save_rawbuf = NULL,
+         uint8_t rmt_channel = 0);
+#else  // ESP32
   explicit IRrecv(uint16_t recvpin, uint16_t bufsize = kRawBuf,
                   uint8_t timeout = kTimeoutMs,
                   bool save_buffer = false);  // Constructor
+  // As above, but with caller-provided (e.g. static) capture buffers.
+  // i.e. Zero heap allocation. The buffers must outlive the IRrecv.
+  IRrecv(uint16_t recvpin, uint16_t *rawbuf, uint16_t bufsize,
+         uint8_t timeout = kTimeoutMs, uint16_t *save_rawbuf = NULL);
+#endif  // ESP32
   ~IRrecv();                                  // Destructor
   bool decode(decode_results *results, irparams_t *save = NULL);
+  bool decode(IRCompactResult *result, irparams_t *save = NULL);
+  bool decodePoll(decode_results *results, irparams_t *save = NULL);
+  bool decodeBudgeted(decode_results *results, const uint32_t max_usecs,
+                      irparams_t *save = NULL);
+  uint16_t decodeAll(decode_results results[], const uint16_t max);
+  bool decodeRaw(const uint16_t *buf, const uint16_t len,
+                 decode_results *results);
+  void onDecode(void (*callback)(const decode_results *),
+                const decode_type_t protocol = UNKNOWN);
+  bool handle(void);
   void enableIRIn();
   void disableIRIn();
+  void pauseIRIn();
+  void resumeIRIn();
+  void enableIRWake();
+  void disableIRWake();
+  void setWakeAssist(const bool on = true);
+  static uint32_t measureCarrierFreq(
+      const uint16_t pin, const uint16_t window_ms = kCarrierMeasureWindowMs);
   void resume();
   uint16_t getBufSize();
+  void setAdaptiveBufSize(const uint16_t max_bufsize);
+  uint16_t getBufHighWaterMark(void);
+  void setAdaptiveTimeout(const bool on = true);
+  uint8_t getTimeout(void);
+  void setTolerance(const uint8_t percent = kTolerance);
+  bool setTolerance(const decode_type_t protocol, const uint8_t percent);
+  uint8_t getTolerance(void);
+  void setSingleFrameAccept(const bool on = true);
+#if DECODE_RC5 || DECODE_RC6
+  void setToggleTracking(const bool on = true, const bool coalesce = false);
+  uint16_t getToggleRepeats(void);
+#endif  // DECODE_RC5 || DECODE_RC6
+  void setNoiseFilter(uint16_t min_pulse_usecs = kNoiseFloorUsecs);
+  void setDecodePriority(const decode_type_t *protocols, const uint8_t length);
+  void setAdaptiveDecode(const bool on = true);
+  bool addTriggerFilter(const decode_type_t protocol,
+                        const uint32_t fingerprint = 0);
+  void clearTriggerFilters(void);
+#if DECODE_MAGIQUEST
+  bool addMagiQuestWand(const uint32_t wand_id);
+  void clearMagiQuestWands(void);
+#endif  // DECODE_MAGIQUEST
+  bool setFrameQueue(uint8_t nr_of_frames, bool compress = false);
+#if COMPACT_RAWBUF
+  bool setCompactBuffer(bool on);
+#endif  // COMPACT_RAWBUF
+#if defined(ESP32)
+  // Run decode() in a dedicated FreeRTOS task, pinned to a core, invoking
+  // `callback` for each successful decode. See startDecodeTask().
+  bool startDecodeTask(void (*callback)(const decode_results *),
+                       uint8_t core = 1, uint8_t priority = 1);
+  void stopDecodeTask();
+#endif  // ESP32
+#if IRRECV_STATS
+  decoder_stats_t getDecodeStats(const decode_type_t protocol);
+  void resetDecodeStats();
+#endif  // IRRECV_STATS
+#if IRMEM_STATS
+  // Set what the constructor does if a capture buffer allocation fails.
+  // Call *before* constructing the IRrecv it is to apply to.
+  static void setHeapPolicy(const irheap_policy_t policy);
+#endif  // IRMEM_STATS
+  void setProtocolMask(const uint64_t *bitmap);
+  void enableProtocol(const decode_type_t protocol);
+  void disableProtocol(const decode_type_t protocol);
+  bool isProtocolEnabled(const decode_type_t protocol);
 #if DECODE_HASH
   void setUnknownThreshold(uint16_t length);
-#endif
-  static bool match(uint32_t measured, uint32_t desired,
-                    uint8_t tolerance = kTolerance, uint16_t delta = 0);
-  static bool matchMark(uint32_t measured, uint32_t desired,
-                        uint8_t tolerance = kTolerance,
-                        int16_t excess = kMarkExcess);
-  static bool matchSpace(uint32_t measured, uint32_t desired,
-                         uint8_t tolerance = kTolerance,
-                         int16_t excess = kMarkExcess);
+  uint32_t getCaptureHash(decode_results *results);
+  void setRepeatCache(bool on);
+  void setDedupWindow(const uint32_t window_ms);
+#endif
+  bool match(uint32_t measured, uint32_t desired,
+             uint8_t tolerance = kUseDefTol, uint16_t delta = 0);
+  bool matchMark(uint32_t measured, uint32_t desired,
+                 uint8_t tolerance = kUseDefTol,
+                 int16_t excess = kMarkExcess);
+  bool matchSpace(uint32_t measured, uint32_t desired,
+                  uint8_t tolerance = kUseDefTol,
+                  int16_t excess = kMarkExcess);
+  uint16_t quantize(const decode_results *results,
+                    const uint32_t *alphabet,
+                    const uint8_t nr_of_symbols, uint8_t *symbols,
+                    const uint16_t max_symbols,
+                    const uint8_t tolerance = kUseDefTol,
+                    const int16_t excess = kMarkExcess);
+#if !defined(UNIT_TEST) && !defined(ESP32)
+  // Internal. The per-instance interrupt bodies. Only the interrupt
+  // trampolines & the timer callback in IRrecv.cpp should call these.
+  void gpioIntr();
+  void readTimeout();
+  // Timer-free (lazy) end-of-frame detection. ESP8266 only.
+  void setLazyTimeout(const bool on = true);
+#endif  // !UNIT_TEST && !ESP32
 #ifndef UNIT_TEST
 
  private:
 #endif
+  // This instance's interrupt capture state. One per instance (rather than
+  // the historic single global), so several receivers on different pins can
+  // capture in parallel.
+  volatile irparams_t irparams;
   irparams_t *irparams_save;
 #if DECODE_HASH
   uint16_t unknown_threshold;
-#endif
+  uint32_t _hash_value;  // Cached getCaptureHash() value for this capture.
+  bool _hash_valid;      // Is _hash_value valid for the current capture?
+  // Repeat-frame cache state. See setRepeatCache().
+  bool _repeatcache_on;
+  uint8_t _repeatcache_next;  // Next slot to (over)write. Round-robin.
+  irrepeat_t _repeatcache[kRepeatCacheEntries];
+  bool repeatCacheLookup(decode_results *results);
+  void repeatCacheStore(decode_results *results);
+  // Duplicate-capture suppression state. See setDedupWindow().
+  uint32_t _dedup_window;       // Suppression horizon in mSecs. 0 == off.
+  uint32_t _dedup_fingerprint;  // Fingerprint of the last seen message.
+  uint32_t _dedup_last;         // _dedup_timer reading when it was seen.
+  bool _dedup_valid;            // Have we seen a message yet?
+  TimerMs _dedup_timer;         // Time base for the window.
+  bool dedupCheck(decode_results *results);
+#endif
+  void commonInit(uint16_t recvpin, uint8_t timeout);
+  // Were the capture buffers supplied by the caller? i.e. We must not
+  // delete[] them, nor count them as library-owned heap.
+  bool _extern_buffers;
+  // Save buffer bookkeeping for the caller-provided buffer constructor, so
+  // it doesn't have to heap allocate an irparams_t.
+  irparams_t _save_storage;
+#if !defined(UNIT_TEST) && !defined(ESP32)
+  // Which interrupt trampoline/timer slot enableIRIn() claimed for us.
+  uint8_t _slot;
+  // Timestamp (uSecs) of the previous edge. Interrupt handler use only.
+  uint32_t _edge_start;
+  // Lazy (timer-free) finalization mode. See setLazyTimeout().
+  bool _lazy_timeout;
+  void pollTimeout();
+#if RAWBUF_COMPRESSION
+  bool frameCompress(volatile irframe_t *slot);
+#endif  // RAWBUF_COMPRESSION
+#endif  // !UNIT_TEST && !ESP32
   // These are called by decode
   void copyIrParams(volatile irparams_t *src, irparams_t *dst);
+  void swapIrParams(volatile irparams_t *src, irparams_t *dst);
+  bool popFrame(decode_results *results);
+  bool decodeCapture(decode_results *results, const bool resumed);
   int16_t compare(uint16_t oldval, uint16_t newval);
-  static uint32_t ticksLow(uint32_t usecs, uint8_t tolerance = kTolerance,
-                           uint16_t delta = 0);
-  static uint32_t ticksHigh(uint32_t usecs, uint8_t tolerance = kTolerance,
-                            uint16_t delta = 0);
+  uint32_t ticksLow(uint32_t usecs, uint8_t tolerance = kUseDefTol,
+                    uint16_t delta = 0);
+  uint32_t ticksHigh(uint32_t usecs, uint8_t tolerance = kUseDefTol,
+                     uint16_t delta = 0);
   bool matchAtLeast(uint32_t measured, uint32_t desired,
-                    uint8_t tolerance = kTolerance, uint16_t delta = 0);
-  match_result_t matchData(volatile uint16_t *data_ptr, const uint16_t nbits,
+                    uint8_t tolerance = kUseDefTol, uint16_t delta = 0);
+  bool tryDecode(const decode_type_t protocol, decode_results *results);
+  bool worthAttempting(const decode_type_t protocol, const uint16_t rawlen);
+  // Wake-assisted (light sleep) reception. See setWakeAssist().
+  bool _wake_assist;    // Is the lost-header recovery mode enabled?
+  bool _wake_recovery;  // Might the *next* capture have a truncated header?
+  // Early accept for multi-frame protocols. See setSingleFrameAccept().
+  bool _single_frame;
+#if DECODE_RC5 || DECODE_RC6
+  // RC-5/RC-6 toggle-bit tracking. See setToggleTracking().
+  bool _toggle_track;         // Annotate results->repeat from the toggle?
+  bool _toggle_coalesce;      // Swallow unchanged-toggle (held) repeats?
+  uint64_t _toggle_prev;      // Last surfaced value. (Toggle bit included)
+  decode_type_t _toggle_prev_type;  // ... & its protocol.
+  uint16_t _toggle_repeats;   // Frames coalesced since the last surfaced.
+  void rcToggleAnnotate(decode_results *results);
+#endif  // DECODE_RC5 || DECODE_RC6
+  // Runtime match tolerance. See setTolerance().
+  uint8_t _tolerance;  // Percent. Used when no per-protocol override applies.
+  irtolerance_t _tol_overrides[kToleranceOverridesMax];
+  uint8_t _tol_len;           // Nr. of registered overrides.
+  decode_type_t _tol_active;  // Protocol whose decoder is being attempted.
+  uint8_t activeTolerance(void);
+  // Capture noise filter. See setNoiseFilter().
+  uint16_t _noise_floor;  // Minimum pulse width (uSecs). 0 == filter off.
+  uint16_t noiseReduce(uint16_t *rawbuf, uint16_t rawlen);
+  // Adaptive capture-buffer sizing. See setAdaptiveBufSize().
+  uint16_t _bufsize_max;        // Growth cap (entries). 0 == growth off.
+  uint16_t _bufsize_highwater;  // Largest capture (entries) seen so far.
+  void growCaptureBuf(void);
+  // Protocol-mask-derived receive timeout. See setAdaptiveTimeout().
+  bool _adaptive_timeout;    // Is the derived timeout mode on?
+  uint8_t _timeout_default;  // The constructor-supplied timeout. (mSecs)
+  void recalcTimeout(void);
+  // Decoder trial-order overrides. See setDecodePriority().
+  decode_type_t _priority[kDecodePriorityMax];
+  uint8_t _priority_len;         // Nr. of entries in use. 0 == none set.
+  bool _adaptive;                // Try the last winner first? (move-to-front)
+  decode_type_t _adaptive_last;  // The last protocol that decoded.
+  bool tryPriority(decode_results *results);
+  // First-stage (wake/trigger) filter state. See addTriggerFilter().
+  irtrigger_t _triggers[kTriggerFiltersMax];
+  uint8_t _trigger_len;  // Nr. of registered patterns. 0 == filter off.
+  bool triggerMatch(decode_results *results);
+#if DECODE_MAGIQUEST
+  // Registered-wand filter state. See addMagiQuestWand().
+  uint32_t _wands[kMagiQuestWandsMax];
+  uint8_t _wands_len;  // Nr. of registered wand IDs. 0 == filter off.
+#endif  // DECODE_MAGIQUEST
+  bool tryHeaderIndex(decode_results *results);
+#if (DECODE_NEC || DECODE_SHERWOOD || DECODE_AIWA_RC_T501 || DECODE_SANYO || \
+     DECODE_CARRIER_AC || DECODE_PIONEER)
+  bool decodeNECFamily(decode_results *results);
+#endif
+#if (DECODE_SAMSUNG || DECODE_SAMSUNG36)
+  bool decodeSamsungFamily(decode_results *results);
+#endif
+  bool tryFullChain(decode_results *results);
+  // Budgeted (resumable) decode state. See decodeBudgeted().
+  bool _budget_active;     // Is a budgeted chain walk in flight?
+  bool _budget_out;        // Has the current slice's budget expired?
+  bool _budget_resumed;    // Did the walk's first slice already resume()?
+  uint32_t _budget_usecs;  // The current slice's time budget.
+  uint16_t _budget_done;   // Nr. of chain entries finished in prior slices.
+  uint16_t _budget_pos;    // Chain entry counter within the current slice.
+  uint16_t _budget_new;    // Nr. of new entries attempted this slice.
+  IRtimer _budget_timer;   // Time spent in the current slice.
+  bool chainStep(void);
+  // Streaming (mid-capture) decode state. See decodePoll().
+  uint16_t *_streambuf;       // Snapshot of an in-progress capture.
+  uint16_t _stream_lastlen;   // Capture length when we last polled.
+  uint16_t _stream_triedlen;  // Capture length of the last decode attempt.
+  // Scratch copy of a caller-supplied capture. See decodeRaw().
+  uint16_t *_injectbuf;
+  uint16_t _injectsize;
+  // The decode scratch arena. See scratch().
+  // Declared as 32-bit words so borrowed bounds tables etc. are aligned.
+  uint32_t _scratch[(kDecodeScratchSize + 3) / sizeof(uint32_t)];
+  void *scratch(const uint16_t nr_of_bytes);
+  // Which protocols decode() is allowed to try. All enabled by default.
+  uint64_t _protocolmask[kProtocolMaskWords];
+#if IRMEM_STATS
+  // Did kIRHeapStatic hand this instance the static fallback buffer?
+  // i.e. The buffer must not be delete[]d, nor counted as heap.
+  bool _rawbuf_static;
+#endif  // IRMEM_STATS
+#if IRRECV_STATS
+  decoder_stats_t _stats[kLastDecodeType + 2];  // [0] is the overall total.
+  void statsRecord(const decode_type_t protocol, const bool success,
+                   const uint32_t usecs);
+#endif  // IRRECV_STATS
+#if defined(ESP32)
+  // RMT peripheral capture backend.
+  // Note: kept as primitive types so we don't drag the RMT driver headers
+  //       into everything that includes this file.
+  uint8_t _rmt_channel;  // Which RMT channel we are to use.
+  void *_rmt_ringbuf;    // The RMT driver's ring buffer handle.
+  bool rmtPoll();
+  // Dedicated decode task state. See startDecodeTask(). The handle is kept
+  // as a void* for the same header-hygiene reason as _rmt_ringbuf.
+  void *_decode_task;  // The FreeRTOS TaskHandle_t, or NULL if not running.
+  void (*_decode_callback)(const decode_results *);
+  static void decodeTaskLoop(void *arg);
+#endif  // ESP32
+  // Decode callback registration. See onDecode().
+  void (*_on_decode)(const decode_results *);
+  decode_type_t _on_decode_filter;
+  match_result_t matchData(const uint16_t *data_ptr, const uint16_t nbits,
                            const uint16_t onemark, const uint32_t onespace,
                            const uint16_t zeromark, const uint32_t zerospace,
-                           const uint8_t tolerance = kTolerance,
+                           const uint8_t tolerance = kUseDefTol,
                            const int16_t excess = kMarkExcess,
                            const bool MSBfirst = true);
+  uint16_t matchBytes(const uint16_t *data_ptr, uint8_t *result_ptr,
+                      const uint16_t remaining, const uint16_t nbytes,
+                      const uint16_t onemark, const uint32_t onespace,
+                      const uint16_t zeromark, const uint32_t zerospace,
+                      const uint8_t tolerance = kUseDefTol,
+                      const int16_t excess = kMarkExcess,
+                      const bool MSBfirst = true, uint8_t *sum = NULL);
+  uint16_t _matchGeneric(const uint16_t *data_ptr,
+                         uint64_t *result_bits_ptr,
+                         uint8_t *result_bytes_ptr,
+                         const bool use_bits,
+                         const uint16_t remaining,
+                         const uint16_t nbits,
+                         const uint16_t hdrmark, const uint32_t hdrspace,
+                         const uint16_t onemark, const uint32_t onespace,
+                         const uint16_t zeromark, const uint32_t zerospace,
+                         const uint16_t footermark,
+                         const uint32_t footerspace,
+                         const bool atleast,
+                         const uint8_t tolerance,
+                         const int16_t excess,
+                         const bool MSBfirst);
+  uint16_t matchGeneric(const uint16_t *data_ptr, uint64_t *result_ptr,
+                        const uint16_t remaining, const uint16_t nbits,
+                        const uint16_t hdrmark, const uint32_t hdrspace,
+                        const uint16_t onemark, const uint32_t onespace,
+                        const uint16_t zeromark, const uint32_t zerospace,
+                        const uint16_t footermark, const uint32_t footerspace,
+                        const bool atleast = false,
+                        const uint8_t tolerance = kUseDefTol,
+                        const int16_t excess = kMarkExcess,
+                        const bool MSBfirst = true);
+  uint16_t matchGeneric(const uint16_t *data_ptr, uint8_t *result_ptr,
+                        const uint16_t remaining, const uint16_t nbits,
+                        const uint16_t hdrmark, const uint32_t hdrspace,
+                        const uint16_t onemark, const uint32_t onespace,
+                        const uint16_t zeromark, const uint32_t zerospace,
+                        const uint16_t footermark, const uint32_t footerspace,
+                        const bool atleast = false,
+                        const uint8_t tolerance = kUseDefTol,
+                        const int16_t excess = kMarkExcess,
+                        const bool MSBfirst = true);
   bool decodeHash(decode_results *results);
 #if (DECODE_NEC || DECODE_SHERWOOD || DECODE_AIWA_RC_T501 || SEND_SANYO)
   bool decodeNEC(decode_results *results, uint16_t nbits = kNECBits,
@@ -185,11 +796,24 @@ class IRrecv {
   bool decodeMitsubishiHeavy(decode_results *results, const uint16_t nbits,
                              const bool strict = true);
 #endif
-#if (DECODE_RC5 || DECODE_R6 || DECODE_LASERTAG || DECODE_MWM)
+#if (DECODE_RC5 || DECODE_RC6 || DECODE_LASERTAG || DECODE_MWM)
   int16_t getRClevel(decode_results *results, uint16_t *offset, uint16_t *used,
-                     uint16_t bitTime, uint8_t tolerance = kTolerance,
+                     uint16_t bitTime, uint8_t tolerance = kUseDefTol,
                      int16_t excess = kMarkExcess, uint16_t delta = 0,
                      uint8_t maxwidth = 3);
+  // Precomputed mark/space width bounds for getRClevel(), so the Manchester
+  // state machines compare against ready-made integer spans instead of
+  // re-running the match() tolerance maths per half-bit.
+  void rcSpanInit(uint16_t bitTime, uint8_t tolerance, int16_t excess,
+                  uint16_t delta, uint8_t maxwidth);
+  uint32_t _rc_low[2][kRcLevelMaxWidth];   // [kMark/kSpace][width - 1]
+  uint32_t _rc_high[2][kRcLevelMaxWidth];  // Bounds in uSeconds.
+  // The parameters the bounds were computed for. (bitTime 0 == not yet)
+  uint16_t _rc_bitTime;
+  uint8_t _rc_tolerance;
+  int16_t _rc_excess;
+  uint16_t _rc_delta;
+  uint8_t _rc_maxwidth;
 #endif
 #if DECODE_RC5
   bool decodeRC5(decode_results *results, uint16_t nbits = kRC5XBits,
@@ -211,6 +835,7 @@ class IRrecv {
 #if DECODE_LG
   bool decodeLG(decode_results *results, uint16_t nbits = kLgBits,
                 bool strict = false);
+  bool decodeLGAll(decode_results *results);
 #endif
 #if DECODE_JVC
   bool decodeJVC(decode_results *results, uint16_t nbits = kJvcBits,
@@ -220,7 +845,7 @@ class IRrecv {
   bool decodeSAMSUNG(decode_results *results, uint16_t nbits = kSamsungBits,
                      bool strict = true);
 #endif
-#if DECODE_SAMSUNG
+#if DECODE_SAMSUNG36
   bool decodeSamsung36(decode_results *results,
                        const uint16_t nbits = kSamsung36Bits,
                        const bool strict = true);
@@ -240,6 +865,7 @@ class IRrecv {
 #if DECODE_DENON
   bool decodeDenon(decode_results *results, uint16_t nbits = DENON_BITS,
                    bool strict = true);
+  bool decodeDenonAll(decode_results *results);
 #endif
 #if DECODE_DISH
   bool decodeDISH(decode_results *results, uint16_t nbits = kDishBits,
@@ -283,6 +909,14 @@ class IRrecv {
                        const uint16_t nbits = kDaikin216Bits,
                        const bool strict = true);
 #endif
+#if DECODE_ARGO
+  bool decodeArgo(decode_results *results, const uint16_t nbits = kArgoBits,
+                  const bool strict = true);
+#endif
+#if DECODE_TROTEC
+  bool decodeTrotec(decode_results *results, const uint16_t nbits = kTrotecBits,
+                    const bool strict = true);
+#endif
 #if DECODE_TOSHIBA_AC
   bool decodeToshibaAC(decode_results *results,
                        uint16_t nbytes = kToshibaACBits, bool strict = true);
@@ -316,14 +950,10 @@ class IRrecv {
                           uint16_t nbits = kHaierACYRW02Bits,
                           bool strict = true);
 #endif
-#if (DECODE_HITACHI_AC || DECODE_HITACHI_AC2)
+#if (DECODE_HITACHI_AC || DECODE_HITACHI_AC1 || DECODE_HITACHI_AC2)
   bool decodeHitachiAC(decode_results *results, uint16_t nbits = kHitachiAcBits,
                        bool strict = true);
 #endif
-#if DECODE_HITACHI_AC1
-  bool decodeHitachiAC1(decode_results *results,
-                        uint16_t nbits = kHitachiAc1Bits, bool strict = true);
-#endif
 #if DECODE_GICABLE
   bool decodeGICable(decode_results *results, uint16_t nbits = kGicableBits,
                      bool strict = true);
@@ -56,177 +56,502 @@
 // Disable (set to false) all the protocols you do not need/want!
 // The Air Conditioner protocols are the most expensive memory-wise.
 //
-#define DECODE_HASH            true  // Semi-unique code for unknown messages
-
-#define SEND_RAW               true
-
-#define DECODE_NEC             true
-#define SEND_NEC               true
-
-#define DECODE_SHERWOOD        true  // Doesn't exist. Actually is DECODE_NEC
-#define SEND_SHERWOOD          true
-
-#define DECODE_RC5             true
-#define SEND_RC5               true
-
-#define DECODE_RC6             true
-#define SEND_RC6               true
-
-#define DECODE_RCMM            true
-#define SEND_RCMM              true
-
-#define DECODE_SONY            true
-#define SEND_SONY              true
-
-#define DECODE_PANASONIC       true
-#define SEND_PANASONIC         true
-
-#define DECODE_JVC             true
-#define SEND_JVC               true
-
-#define DECODE_SAMSUNG         true
-#define SEND_SAMSUNG           true
-
-#define DECODE_SAMSUNG36       true
-#define SEND_SAMSUNG36         true
-
-#define DECODE_SAMSUNG_AC      true
-#define SEND_SAMSUNG_AC        true
-
-#define DECODE_WHYNTER         true
-#define SEND_WHYNTER           true
-
-#define DECODE_AIWA_RC_T501    true
-#define SEND_AIWA_RC_T501      true
-
-#define DECODE_LG              true
-#define SEND_LG                true
-
-#define DECODE_SANYO           true
-#define SEND_SANYO             true
-
-#define DECODE_MITSUBISHI      true
-#define SEND_MITSUBISHI        true
-
-#define DECODE_MITSUBISHI2     true
-#define SEND_MITSUBISHI2       true
-
-#define DECODE_DISH            true
-#define SEND_DISH              true
-
-#define DECODE_SHARP           true
-#define SEND_SHARP             true
-
-#define DECODE_SHARP_AC        true
-#define SEND_SHARP_AC          true
-
-#define DECODE_DENON           true
-#define SEND_DENON             true
-
-#define DECODE_KELVINATOR      true
-#define SEND_KELVINATOR        true
-
-#define DECODE_MITSUBISHI_AC   true  // Beta.
-#define SEND_MITSUBISHI_AC     true
-
-#define DECODE_FUJITSU_AC      true
-#define SEND_FUJITSU_AC        true
-
-#define DECODE_DAIKIN          true
-#define SEND_DAIKIN            true
-
-#define DECODE_COOLIX          true
-#define SEND_COOLIX            true
-
+// Each flag can also be set from the build system (e.g. a -D compiler
+// argument) without editing this file. Flags left unset default to
+// _IR_ENABLE_DEFAULT_, so a minimal (e.g. NEC-only) build is just:
+//   -D_IR_ENABLE_DEFAULT_=false -DDECODE_NEC=true -DSEND_NEC=true
+// Everything not explicitly enabled is compiled out of the dispatch
+// tables & chains too, so the linker drops the unused protocol modules
+// entirely.
+#ifndef _IR_ENABLE_DEFAULT_
+#define _IR_ENABLE_DEFAULT_ true
+#endif  // _IR_ENABLE_DEFAULT_
+
+// Build profiles. Curated presets for the common targeted builds, so a
+// minimal image is a single -D instead of a study of the dozens of
+// individual switches below. Define at most one of:
+//   IR_PROFILE_MINIMAL_NEC: NEC send & receive only. The smallest, fastest
+//       booting image. e.g. For a fixed NEC-only sensor node. (DECODE_HASH
+//       & the hash-based extras are compiled out too: with one known
+//       protocol an unknown-hash result is just noise.)
+//   IR_PROFILE_TV_BASIC: The common TV/set-top protocols. (NEC, Samsung,
+//       Sony, RC-5, RC-6) DECODE_HASH stays on, so unrecognised remotes
+//       still yield a usable (hash) code.
+//   IR_PROFILE_AC_ONLY: Every air-conditioner protocol, & nothing else.
+// Everything outside the profile is compiled out, incl. its decode chain &
+// dispatch entries, so the linker drops the unused protocol modules. The
+// A/C-free profiles also shrink every decode_results by the A/C state
+// array. (See kStateSizeMax) Individual flags can still be stacked on top.
+// e.g. -DIR_PROFILE_TV_BASIC -DDECODE_JVC=true -DSEND_JVC=true
+#if defined(IR_PROFILE_MINIMAL_NEC) || defined(IR_PROFILE_TV_BASIC) || \
+    defined(IR_PROFILE_AC_ONLY)
+#undef _IR_ENABLE_DEFAULT_
+#define _IR_ENABLE_DEFAULT_ false  // A profile enables only what it lists.
+#endif  // IR_PROFILE_*
+
+#if defined(IR_PROFILE_MINIMAL_NEC)
+#ifndef DECODE_NEC
+#define DECODE_NEC true
+#endif  // DECODE_NEC
+#ifndef SEND_NEC
+#define SEND_NEC true
+#endif  // SEND_NEC
+#endif  // IR_PROFILE_MINIMAL_NEC
+
+#if defined(IR_PROFILE_TV_BASIC)
+#ifndef DECODE_HASH
+#define DECODE_HASH true
+#endif  // DECODE_HASH
+#ifndef DECODE_NEC
+#define DECODE_NEC true
+#endif  // DECODE_NEC
+#ifndef SEND_NEC
+#define SEND_NEC true
+#endif  // SEND_NEC
+#ifndef DECODE_SAMSUNG
+#define DECODE_SAMSUNG true
+#endif  // DECODE_SAMSUNG
+#ifndef SEND_SAMSUNG
+#define SEND_SAMSUNG true
+#endif  // SEND_SAMSUNG
+#ifndef DECODE_SONY
+#define DECODE_SONY true
+#endif  // DECODE_SONY
+#ifndef SEND_SONY
+#define SEND_SONY true
+#endif  // SEND_SONY
+#ifndef DECODE_RC5
+#define DECODE_RC5 true
+#endif  // DECODE_RC5
+#ifndef SEND_RC5
+#define SEND_RC5 true
+#endif  // SEND_RC5
+#ifndef DECODE_RC6
+#define DECODE_RC6 true
+#endif  // DECODE_RC6
+#ifndef SEND_RC6
+#define SEND_RC6 true
+#endif  // SEND_RC6
+#endif  // IR_PROFILE_TV_BASIC
+
+#if defined(IR_PROFILE_AC_ONLY)
+#ifndef _IR_ENABLE_AC_
+#define _IR_ENABLE_AC_ true
+#endif  // _IR_ENABLE_AC_
+#ifndef DECODE_HASH
+#define DECODE_HASH true  // Dedup etc. matter for A/C bursts.
+#endif  // DECODE_HASH
+#endif  // IR_PROFILE_AC_ONLY
+
+// The default for the air-conditioner protocol family. Follows
+// _IR_ENABLE_DEFAULT_ unless set explicitly, so the whole (memory-hungry)
+// A/C family can also be dropped from an otherwise-full build with a
+// single -D_IR_ENABLE_AC_=false.
+#ifndef _IR_ENABLE_AC_
+#define _IR_ENABLE_AC_ _IR_ENABLE_DEFAULT_
+#endif  // _IR_ENABLE_AC_
+
+// Semi-unique code for unknown messages.
+#ifndef DECODE_HASH
+#define DECODE_HASH            _IR_ENABLE_DEFAULT_
+#endif  // DECODE_HASH
+
+#ifndef SEND_RAW
+#define SEND_RAW               _IR_ENABLE_DEFAULT_
+#endif  // SEND_RAW
+
+#ifndef DECODE_NEC
+#define DECODE_NEC             _IR_ENABLE_DEFAULT_
+#endif  // DECODE_NEC
+#ifndef SEND_NEC
+#define SEND_NEC               _IR_ENABLE_DEFAULT_
+#endif  // SEND_NEC
+
+// Doesn't exist. Actually is DECODE_NEC.
+#ifndef DECODE_SHERWOOD
+#define DECODE_SHERWOOD        _IR_ENABLE_DEFAULT_
+#endif  // DECODE_SHERWOOD
+#ifndef SEND_SHERWOOD
+#define SEND_SHERWOOD          _IR_ENABLE_DEFAULT_
+#endif  // SEND_SHERWOOD
+
+#ifndef DECODE_RC5
+#define DECODE_RC5             _IR_ENABLE_DEFAULT_
+#endif  // DECODE_RC5
+#ifndef SEND_RC5
+#define SEND_RC5               _IR_ENABLE_DEFAULT_
+#endif  // SEND_RC5
+
+#ifndef DECODE_RC6
+#define DECODE_RC6             _IR_ENABLE_DEFAULT_
+#endif  // DECODE_RC6
+#ifndef SEND_RC6
+#define SEND_RC6               _IR_ENABLE_DEFAULT_
+#endif  // SEND_RC6
+
+#ifndef DECODE_RCMM
+#define DECODE_RCMM            _IR_ENABLE_DEFAULT_
+#endif  // DECODE_RCMM
+#ifndef SEND_RCMM
+#define SEND_RCMM              _IR_ENABLE_DEFAULT_
+#endif  // SEND_RCMM
+
+#ifndef DECODE_SONY
+#define DECODE_SONY            _IR_ENABLE_DEFAULT_
+#endif  // DECODE_SONY
+#ifndef SEND_SONY
+#define SEND_SONY              _IR_ENABLE_DEFAULT_
+#endif  // SEND_SONY
+
+#ifndef DECODE_PANASONIC
+#define DECODE_PANASONIC       _IR_ENABLE_DEFAULT_
+#endif  // DECODE_PANASONIC
+#ifndef SEND_PANASONIC
+#define SEND_PANASONIC         _IR_ENABLE_DEFAULT_
+#endif  // SEND_PANASONIC
+
+#ifndef DECODE_JVC
+#define DECODE_JVC             _IR_ENABLE_DEFAULT_
+#endif  // DECODE_JVC
+#ifndef SEND_JVC
+#define SEND_JVC               _IR_ENABLE_DEFAULT_
+#endif  // SEND_JVC
+
+#ifndef DECODE_SAMSUNG
+#define DECODE_SAMSUNG         _IR_ENABLE_DEFAULT_
+#endif  // DECODE_SAMSUNG
+#ifndef SEND_SAMSUNG
+#define SEND_SAMSUNG           _IR_ENABLE_DEFAULT_
+#endif  // SEND_SAMSUNG
+
+#ifndef DECODE_SAMSUNG36
+#define DECODE_SAMSUNG36       _IR_ENABLE_DEFAULT_
+#endif  // DECODE_SAMSUNG36
+#ifndef SEND_SAMSUNG36
+#define SEND_SAMSUNG36         _IR_ENABLE_DEFAULT_
+#endif  // SEND_SAMSUNG36
+
+#ifndef DECODE_SAMSUNG_AC
+#define DECODE_SAMSUNG_AC      _IR_ENABLE_AC_
+#endif  // DECODE_SAMSUNG_AC
+#ifndef SEND_SAMSUNG_AC
+#define SEND_SAMSUNG_AC        _IR_ENABLE_AC_
+#endif  // SEND_SAMSUNG_AC
+
+#ifndef DECODE_WHYNTER
+#define DECODE_WHYNTER         _IR_ENABLE_AC_
+#endif  // DECODE_WHYNTER
+#ifndef SEND_WHYNTER
+#define SEND_WHYNTER           _IR_ENABLE_AC_
+#endif  // SEND_WHYNTER
+
+#ifndef DECODE_AIWA_RC_T501
+#define DECODE_AIWA_RC_T501    _IR_ENABLE_DEFAULT_
+#endif  // DECODE_AIWA_RC_T501
+#ifndef SEND_AIWA_RC_T501
+#define SEND_AIWA_RC_T501      _IR_ENABLE_DEFAULT_
+#endif  // SEND_AIWA_RC_T501
+
+#ifndef DECODE_LG
+#define DECODE_LG              _IR_ENABLE_DEFAULT_
+#endif  // DECODE_LG
+#ifndef SEND_LG
+#define SEND_LG                _IR_ENABLE_DEFAULT_
+#endif  // SEND_LG
+
+#ifndef DECODE_SANYO
+#define DECODE_SANYO           _IR_ENABLE_DEFAULT_
+#endif  // DECODE_SANYO
+#ifndef SEND_SANYO
+#define SEND_SANYO             _IR_ENABLE_DEFAULT_
+#endif  // SEND_SANYO
+
+#ifndef DECODE_MITSUBISHI
+#define DECODE_MITSUBISHI      _IR_ENABLE_DEFAULT_
+#endif  // DECODE_MITSUBISHI
+#ifndef SEND_MITSUBISHI
+#define SEND_MITSUBISHI        _IR_ENABLE_DEFAULT_
+#endif  // SEND_MITSUBISHI
+
+#ifndef DECODE_MITSUBISHI2
+#define DECODE_MITSUBISHI2     _IR_ENABLE_DEFAULT_
+#endif  // DECODE_MITSUBISHI2
+#ifndef SEND_MITSUBISHI2
+#define SEND_MITSUBISHI2       _IR_ENABLE_DEFAULT_
+#endif  // SEND_MITSUBISHI2
+
+#ifndef DECODE_DISH
+#define DECODE_DISH            _IR_ENABLE_DEFAULT_
+#endif  // DECODE_DISH
+#ifndef SEND_DISH
+#define SEND_DISH              _IR_ENABLE_DEFAULT_
+#endif  // SEND_DISH
+
+#ifndef DECODE_SHARP
+#define DECODE_SHARP           _IR_ENABLE_DEFAULT_
+#endif  // DECODE_SHARP
+#ifndef SEND_SHARP
+#define SEND_SHARP             _IR_ENABLE_DEFAULT_
+#endif  // SEND_SHARP
+
+#ifndef DECODE_SHARP_AC
+#define DECODE_SHARP_AC        _IR_ENABLE_AC_
+#endif  // DECODE_SHARP_AC
+#ifndef SEND_SHARP_AC
+#define SEND_SHARP_AC          _IR_ENABLE_AC_
+#endif  // SEND_SHARP_AC
+
+#ifndef DECODE_DENON
+#define DECODE_DENON           _IR_ENABLE_DEFAULT_
+#endif  // DECODE_DENON
+#ifndef SEND_DENON
+#define SEND_DENON             _IR_ENABLE_DEFAULT_
+#endif  // SEND_DENON
+
+#ifndef DECODE_KELVINATOR
+#define DECODE_KELVINATOR      _IR_ENABLE_AC_
+#endif  // DECODE_KELVINATOR
+#ifndef SEND_KELVINATOR
+#define SEND_KELVINATOR        _IR_ENABLE_AC_
+#endif  // SEND_KELVINATOR
+
+#ifndef DECODE_MITSUBISHI_AC
+#define DECODE_MITSUBISHI_AC   _IR_ENABLE_AC_  // Beta.
+#endif  // DECODE_MITSUBISHI_AC
+#ifndef SEND_MITSUBISHI_AC
+#define SEND_MITSUBISHI_AC     _IR_ENABLE_AC_
+#endif  // SEND_MITSUBISHI_AC
+
+#ifndef DECODE_FUJITSU_AC
+#define DECODE_FUJITSU_AC      _IR_ENABLE_AC_
+#endif  // DECODE_FUJITSU_AC
+#ifndef SEND_FUJITSU_AC
+#define SEND_FUJITSU_AC        _IR_ENABLE_AC_
+#endif  // SEND_FUJITSU_AC
+
+#ifndef DECODE_DAIKIN
+#define DECODE_DAIKIN          _IR_ENABLE_AC_
+#endif  // DECODE_DAIKIN
+#ifndef SEND_DAIKIN
+#define SEND_DAIKIN            _IR_ENABLE_AC_
+#endif  // SEND_DAIKIN
+
+#ifndef DECODE_COOLIX
+#define DECODE_COOLIX          _IR_ENABLE_AC_
+#endif  // DECODE_COOLIX
+#ifndef SEND_COOLIX
+#define SEND_COOLIX            _IR_ENABLE_AC_
+#endif  // SEND_COOLIX
+
+#ifndef DECODE_GLOBALCACHE
 #define DECODE_GLOBALCACHE     false  // Not written.
-#define SEND_GLOBALCACHE       true
-
-#define DECODE_GREE            true
-#define SEND_GREE              true
-
+#endif  // DECODE_GLOBALCACHE
+#ifndef SEND_GLOBALCACHE
+#define SEND_GLOBALCACHE       _IR_ENABLE_DEFAULT_
+#endif  // SEND_GLOBALCACHE
+
+#ifndef DECODE_GREE
+#define DECODE_GREE            _IR_ENABLE_AC_
+#endif  // DECODE_GREE
+#ifndef SEND_GREE
+#define SEND_GREE              _IR_ENABLE_AC_
+#endif  // SEND_GREE
+
+#ifndef DECODE_PRONTO
 #define DECODE_PRONTO          false  // Not written.
-#define SEND_PRONTO            true
-
-#define DECODE_ARGO            false  // Not written.
-#define SEND_ARGO              true
-
-#define DECODE_TROTEC          false  // Not implemented.
-#define SEND_TROTEC            true
-
-#define DECODE_NIKAI           true
-#define SEND_NIKAI             true
-
-#define DECODE_TOSHIBA_AC      true
-#define SEND_TOSHIBA_AC        true
-
-#define DECODE_MAGIQUEST       true
-#define SEND_MAGIQUEST         true
-
-#define DECODE_MIDEA           true
-#define SEND_MIDEA             true
-
-#define DECODE_LASERTAG        true
-#define SEND_LASERTAG          true
-
-#define DECODE_CARRIER_AC      true
-#define SEND_CARRIER_AC        true
-
-#define DECODE_HAIER_AC        true
-#define SEND_HAIER_AC          true
-
-#define DECODE_HITACHI_AC      true
-#define SEND_HITACHI_AC        true
-
-#define DECODE_HITACHI_AC1     true
-#define SEND_HITACHI_AC1       true
-
-#define DECODE_HITACHI_AC2     true
-#define SEND_HITACHI_AC2       true
-
-#define DECODE_GICABLE         true
-#define SEND_GICABLE           true
-
-#define DECODE_HAIER_AC_YRW02  true
-#define SEND_HAIER_AC_YRW02    true
-
-#define DECODE_WHIRLPOOL_AC    true
-#define SEND_WHIRLPOOL_AC      true
-
-#define DECODE_LUTRON          true
-#define SEND_LUTRON            true
-
-#define DECODE_ELECTRA_AC      true
-#define SEND_ELECTRA_AC        true
-
-#define DECODE_PANASONIC_AC    true
-#define SEND_PANASONIC_AC      true
-
-#define DECODE_MWM             true
-#define SEND_MWM               true
-
-#define DECODE_PIONEER         true
-#define SEND_PIONEER           true
-
-#define DECODE_DAIKIN2         true
-#define SEND_DAIKIN2           true
-
-#define DECODE_VESTEL_AC       true
-#define SEND_VESTEL_AC         true
-
-#define DECODE_TECO            true
-#define SEND_TECO              true
-
-#define DECODE_TCL112AC        true
-#define SEND_TCL112AC          true
-
-#define DECODE_LEGOPF          true
-#define SEND_LEGOPF            true
-
-#define DECODE_MITSUBISHIHEAVY true
-#define SEND_MITSUBISHIHEAVY   true
-
-#define DECODE_DAIKIN216       true
-#define SEND_DAIKIN216         true
+#endif  // DECODE_PRONTO
+#ifndef SEND_PRONTO
+#define SEND_PRONTO            _IR_ENABLE_DEFAULT_
+#endif  // SEND_PRONTO
+
+#ifndef DECODE_ARGO
+#define DECODE_ARGO            _IR_ENABLE_AC_
+#endif  // DECODE_ARGO
+#ifndef SEND_ARGO
+#define SEND_ARGO              _IR_ENABLE_AC_
+#endif  // SEND_ARGO
+
+#ifndef DECODE_TROTEC
+#define DECODE_TROTEC          _IR_ENABLE_AC_
+#endif  // DECODE_TROTEC
+#ifndef SEND_TROTEC
+#define SEND_TROTEC            _IR_ENABLE_AC_
+#endif  // SEND_TROTEC
+
+#ifndef DECODE_NIKAI
+#define DECODE_NIKAI           _IR_ENABLE_DEFAULT_
+#endif  // DECODE_NIKAI
+#ifndef SEND_NIKAI
+#define SEND_NIKAI             _IR_ENABLE_DEFAULT_
+#endif  // SEND_NIKAI
+
+#ifndef DECODE_TOSHIBA_AC
+#define DECODE_TOSHIBA_AC      _IR_ENABLE_AC_
+#endif  // DECODE_TOSHIBA_AC
+#ifndef SEND_TOSHIBA_AC
+#define SEND_TOSHIBA_AC        _IR_ENABLE_AC_
+#endif  // SEND_TOSHIBA_AC
+
+#ifndef DECODE_MAGIQUEST
+#define DECODE_MAGIQUEST       _IR_ENABLE_DEFAULT_
+#endif  // DECODE_MAGIQUEST
+#ifndef SEND_MAGIQUEST
+#define SEND_MAGIQUEST         _IR_ENABLE_DEFAULT_
+#endif  // SEND_MAGIQUEST
+
+#ifndef DECODE_MIDEA
+#define DECODE_MIDEA           _IR_ENABLE_AC_
+#endif  // DECODE_MIDEA
+#ifndef SEND_MIDEA
+#define SEND_MIDEA             _IR_ENABLE_AC_
+#endif  // SEND_MIDEA
+
+#ifndef DECODE_LASERTAG
+#define DECODE_LASERTAG        _IR_ENABLE_DEFAULT_
+#endif  // DECODE_LASERTAG
+#ifndef SEND_LASERTAG
+#define SEND_LASERTAG          _IR_ENABLE_DEFAULT_
+#endif  // SEND_LASERTAG
+
+#ifndef DECODE_CARRIER_AC
+#define DECODE_CARRIER_AC      _IR_ENABLE_AC_
+#endif  // DECODE_CARRIER_AC
+#ifndef SEND_CARRIER_AC
+#define SEND_CARRIER_AC        _IR_ENABLE_AC_
+#endif  // SEND_CARRIER_AC
+
+#ifndef DECODE_HAIER_AC
+#define DECODE_HAIER_AC        _IR_ENABLE_AC_
+#endif  // DECODE_HAIER_AC
+#ifndef SEND_HAIER_AC
+#define SEND_HAIER_AC          _IR_ENABLE_AC_
+#endif  // SEND_HAIER_AC
+
+#ifndef DECODE_HITACHI_AC
+#define DECODE_HITACHI_AC      _IR_ENABLE_AC_
+#endif  // DECODE_HITACHI_AC
+#ifndef SEND_HITACHI_AC
+#define SEND_HITACHI_AC        _IR_ENABLE_AC_
+#endif  // SEND_HITACHI_AC
+
+#ifndef DECODE_HITACHI_AC1
+#define DECODE_HITACHI_AC1     _IR_ENABLE_AC_
+#endif  // DECODE_HITACHI_AC1
+#ifndef SEND_HITACHI_AC1
+#define SEND_HITACHI_AC1       _IR_ENABLE_AC_
+#endif  // SEND_HITACHI_AC1
+
+#ifndef DECODE_HITACHI_AC2
+#define DECODE_HITACHI_AC2     _IR_ENABLE_AC_
+#endif  // DECODE_HITACHI_AC2
+#ifndef SEND_HITACHI_AC2
+#define SEND_HITACHI_AC2       _IR_ENABLE_AC_
+#endif  // SEND_HITACHI_AC2
+
+#ifndef DECODE_GICABLE
+#define DECODE_GICABLE         _IR_ENABLE_DEFAULT_
+#endif  // DECODE_GICABLE
+#ifndef SEND_GICABLE
+#define SEND_GICABLE           _IR_ENABLE_DEFAULT_
+#endif  // SEND_GICABLE
+
+#ifndef DECODE_HAIER_AC_YRW02
+#define DECODE_HAIER_AC_YRW02  _IR_ENABLE_AC_
+#endif  // DECODE_HAIER_AC_YRW02
+#ifndef SEND_HAIER_AC_YRW02
+#define SEND_HAIER_AC_YRW02    _IR_ENABLE_AC_
+#endif  // SEND_HAIER_AC_YRW02
+
+#ifndef DECODE_WHIRLPOOL_AC
+#define DECODE_WHIRLPOOL_AC    _IR_ENABLE_AC_
+#endif  // DECODE_WHIRLPOOL_AC
+#ifndef SEND_WHIRLPOOL_AC
+#define SEND_WHIRLPOOL_AC      _IR_ENABLE_AC_
+#endif  // SEND_WHIRLPOOL_AC
+
+#ifndef DECODE_LUTRON
+#define DECODE_LUTRON          _IR_ENABLE_DEFAULT_
+#endif  // DECODE_LUTRON
+#ifndef SEND_LUTRON
+#define SEND_LUTRON            _IR_ENABLE_DEFAULT_
+#endif  // SEND_LUTRON
+
+#ifndef DECODE_ELECTRA_AC
+#define DECODE_ELECTRA_AC      _IR_ENABLE_AC_
+#endif  // DECODE_ELECTRA_AC
+#ifndef SEND_ELECTRA_AC
+#define SEND_ELECTRA_AC        _IR_ENABLE_AC_
+#endif  // SEND_ELECTRA_AC
+
+#ifndef DECODE_PANASONIC_AC
+#define DECODE_PANASONIC_AC    _IR_ENABLE_AC_
+#endif  // DECODE_PANASONIC_AC
+#ifndef SEND_PANASONIC_AC
+#define SEND_PANASONIC_AC      _IR_ENABLE_AC_
+#endif  // SEND_PANASONIC_AC
+
+#ifndef DECODE_MWM
+#define DECODE_MWM             _IR_ENABLE_DEFAULT_
+#endif  // DECODE_MWM
+#ifndef SEND_MWM
+#define SEND_MWM               _IR_ENABLE_DEFAULT_
+#endif  // SEND_MWM
+
+#ifndef DECODE_PIONEER
+#define DECODE_PIONEER         _IR_ENABLE_DEFAULT_
+#endif  // DECODE_PIONEER
+#ifndef SEND_PIONEER
+#define SEND_PIONEER           _IR_ENABLE_DEFAULT_
+#endif  // SEND_PIONEER
+
+#ifndef DECODE_DAIKIN2
+#define DECODE_DAIKIN2         _IR_ENABLE_AC_
+#endif  // DECODE_DAIKIN2
+#ifndef SEND_DAIKIN2
+#define SEND_DAIKIN2           _IR_ENABLE_AC_
+#endif  // SEND_DAIKIN2
+
+#ifndef DECODE_VESTEL_AC
+#define DECODE_VESTEL_AC       _IR_ENABLE_AC_
+#endif  // DECODE_VESTEL_AC
+#ifndef SEND_VESTEL_AC
+#define SEND_VESTEL_AC         _IR_ENABLE_AC_
+#endif  // SEND_VESTEL_AC
+
+#ifndef DECODE_TECO
+#define DECODE_TECO            _IR_ENABLE_AC_
+#endif  // DECODE_TECO
+#ifndef SEND_TECO
+#define SEND_TECO              _IR_ENABLE_AC_
+#endif  // SEND_TECO
+
+#ifndef DECODE_TCL112AC
+#define DECODE_TCL112AC        _IR_ENABLE_AC_
+#endif  // DECODE_TCL112AC
+#ifndef SEND_TCL112AC
+#define SEND_TCL112AC          _IR_ENABLE_AC_
+#endif  // SEND_TCL112AC
+
+#ifndef DECODE_LEGOPF
+#define DECODE_LEGOPF          _IR_ENABLE_DEFAULT_
+#endif  // DECODE_LEGOPF
+#ifndef SEND_LEGOPF
+#define SEND_LEGOPF            _IR_ENABLE_DEFAULT_
+#endif  // SEND_LEGOPF
+
+#ifndef DECODE_MITSUBISHIHEAVY
+#define DECODE_MITSUBISHIHEAVY _IR_ENABLE_AC_
+#endif  // DECODE_MITSUBISHIHEAVY
+#ifndef SEND_MITSUBISHIHEAVY
+#define SEND_MITSUBISHIHEAVY   _IR_ENABLE_AC_
+#endif  // SEND_MITSUBISHIHEAVY
+
+#ifndef DECODE_DAIKIN216
+#define DECODE_DAIKIN216       _IR_ENABLE_AC_
+#endif  // DECODE_DAIKIN216
+#ifndef SEND_DAIKIN216
+#define SEND_DAIKIN216         _IR_ENABLE_AC_
+#endif  // SEND_DAIKIN216
 
 #if (DECODE_ARGO || DECODE_DAIKIN || DECODE_FUJITSU_AC || DECODE_GREE || \
      DECODE_KELVINATOR || DECODE_MITSUBISHI_AC || DECODE_TOSHIBA_AC || \
@@ -241,11 +566,122 @@
 #define DECODE_AC false   // We don't need that infrastructure.
 #endif
 
+// Collect per-decoder attempt/success/latency statistics in IRrecv.
+// See IRrecv::getDecodeStats(). Costs a small counter structure per protocol
+// in RAM. Set this to false if you need that memory back.
+#ifndef IRRECV_STATS
+#define IRRECV_STATS true
+#endif  // IRRECV_STATS
+
+// Collect requested vs. achieved timing statistics in IRsend's mark() &
+// space(). See IRsend::getSendStats(). Useful for quantifying how badly
+// interrupt load (e.g. WiFi) stretches the transmitted timings, & for
+// validating the hardware carrier back-ends.
+#ifndef IRSEND_STATS
+#define IRSEND_STATS true
+#endif  // IRSEND_STATS
+
+// Track the nr. of heap bytes owned by the library's own allocations.
+// (Capture buffers, frame/send queues, the send cache, etc.)
+// See irMemCurrent()/irMemPeak() in IRutils.h. Also enables
+// IRrecv::setHeapPolicy() for choosing what to do when a capture buffer
+// allocation fails, instead of the default reboot.
+#ifndef IRMEM_STATS
+#define IRMEM_STATS true
+#endif  // IRMEM_STATS
+
+// Support storing the frame queue's captures in a compressed form, roughly
+// quartering the queue's memory use. See IRrecv::setFrameQueue().
+// Off by default, as the compressor runs in interrupt context & thus has to
+// live in scarce IRAM whether or not the mode is actually enabled at runtime.
+#ifndef RAWBUF_COMPRESSION
+#define RAWBUF_COMPRESSION false
+#endif  // RAWBUF_COMPRESSION
+
+// Support the compact (8-bit) live capture buffer format, halving the
+// interrupt buffer's memory for big (e.g. A/C) captures.
+// See IRrecv::setCompactBuffer(). Needs the save-buffer mode.
+// Off by default for the same reason as RAWBUF_COMPRESSION: the encoder
+// runs in interrupt context & so costs scarce IRAM even when unused.
+#ifndef COMPACT_RAWBUF
+#define COMPACT_RAWBUF false
+#endif  // COMPACT_RAWBUF
+
+// Function placement control.
+// IRAM is tiny (& shared with WiFi etc. on the ESP8266), so where code lands
+// matters:
+//   IR_ISR_ATTR: interrupt-context code ONLY. Placed in IRAM, as the flash
+//     cache may be unavailable when an interrupt fires.
+//   IR_FLASH_ATTR: explicit flash placement. Flash is already the default on
+//     the Arduino cores, so this is for pinning heavyweight functions that
+//     sit next to IRAM code, making sure they can never silently migrate.
+// Set IRAM_AUDIT to true to compile all of the library's IRAM-resident code
+// into a single dedicated ".iram.text.irremote" section with inlining
+// disabled. The library's exact IRAM byte bill is then a one-liner against
+// the build's object files. e.g.
+//   xtensa-lx106-elf-objdump -h *.o | grep iram.text.irremote
+// For audit builds only; normal builds keep the core's standard placement.
+#ifndef IRAM_AUDIT
+#define IRAM_AUDIT false
+#endif  // IRAM_AUDIT
+#if defined(UNIT_TEST)
+#define IR_ISR_ATTR
+#elif IRAM_AUDIT
+#define IR_ISR_ATTR __attribute__((section(".iram.text.irremote"), noinline))
+#else
+#define IR_ISR_ATTR ICACHE_RAM_ATTR
+#endif  // UNIT_TEST / IRAM_AUDIT
+#if defined(ESP8266) && !defined(UNIT_TEST)
+#define IR_FLASH_ATTR ICACHE_FLASH_ATTR
+#else
+#define IR_FLASH_ATTR
+#endif  // ESP8266 && !UNIT_TEST
+
+// Thread-local storage, for the desktop (UNIT_TEST) build only.
+// The decode path is pure computation over the caller's buffer there, so
+// test corpora can be sharded across std::thread workers (see the -j
+// option in test/replay.cpp) provided each worker uses its own IRrecv &
+// the few shared mutable statics become per-thread. On the embedded
+// cores there is one thread of execution & `thread_local` isn't reliably
+// available, so this compiles away.
+#ifdef UNIT_TEST
+#define IR_THREAD_LOCAL thread_local
+#else
+#define IR_THREAD_LOCAL
+#endif  // UNIT_TEST
+
+// Hardware-scope profiling hooks.
+// Define IR_PROFILE_PIN as a spare GPIO nr. at compile time & the library
+// will toggle that pin around its time-critical phases:
+//   * The capture edge & timeout interrupts: high on entry, low on exit.
+//     (The latter covers frame finalization/frame queue publishing.)
+//   * IRrecv::decode(): high for the duration of each call.
+//   * IRsend transmission: the pin follows the modulation envelope.
+//     i.e. High for a mark(), low for a space().
+// A logic analyser or scope on the pin then gives ISR latency/jitter,
+// decode durations & the achieved transmit timing directly, with none of
+// the printf()/micros() style measurement cost that would perturb the very
+// paths being measured. digitalWrite() is IRAM-resident on the cores we
+// support, so the interrupt hooks are safe. Profile one direction at a
+// time; the receive & transmit hooks share the single pin.
+// Off (& the hooks compile away to nothing) unless IR_PROFILE_PIN is set.
+#if defined(IR_PROFILE_PIN) && !defined(UNIT_TEST)
+#define IR_PROFILE_INIT() pinMode(IR_PROFILE_PIN, OUTPUT)
+#define IR_PROFILE_HIGH() digitalWrite(IR_PROFILE_PIN, HIGH)
+#define IR_PROFILE_LOW() digitalWrite(IR_PROFILE_PIN, LOW)
+#else  // IR_PROFILE_PIN && !UNIT_TEST
+#define IR_PROFILE_INIT()
+#define IR_PROFILE_HIGH()
+#define IR_PROFILE_LOW()
+#endif  // IR_PROFILE_PIN && !UNIT_TEST
+
 // Use millisecond 'delay()' calls where we can to avoid tripping the WDT.
 // Note: If you plan to send IR messages in the callbacks of the AsyncWebserver
 //       library, you need to set ALLOW_DELAY_CALLS to false.
 //       Ref: https://github.com/markszabo/IRremoteESP8266/issues/430
+#ifndef ALLOW_DELAY_CALLS
 #define ALLOW_DELAY_CALLS true
+#endif  // ALLOW_DELAY_CALLS
 
 /*
  * Always add to the end of the list and should never remove entries
@@ -328,6 +764,7 @@ const uint16_t kSingleRepeat = 1;
 const uint16_t kAiwaRcT501Bits = 15;
 const uint16_t kAiwaRcT501MinRepeats = kSingleRepeat;
 const uint16_t kArgoStateLength = 12;
+const uint16_t kArgoBits = kArgoStateLength * 8;
 const uint16_t kArgoDefaultRepeat = kNoRepeat;
 const uint16_t kCoolixBits = 24;
 const uint16_t kCoolixDefaultRepeat = 1;
@@ -381,6 +818,9 @@ const uint16_t kLasertagBits = 13;
 const uint16_t kLasertagMinRepeat = kNoRepeat;
 const uint16_t kLegoPfBits = 16;
 const uint16_t kLegoPfMinRepeat = kNoRepeat;
+// The spec requires a command be sent at least 5 times, with channel-based
+// spacing. i.e. Engage sendLegoPf()'s repeat mode.
+const uint16_t kLegoPfSpecRepeat = 5;
 const uint16_t kLgBits = 28;
 const uint16_t kLg32Bits = 32;
 const uint16_t kLutronBits = 35;
@@ -451,6 +891,7 @@ const uint16_t kToshibaACStateLength = 9;
 const uint16_t kToshibaACBits = kToshibaACStateLength * 8;
 const uint16_t kToshibaACMinRepeat = kSingleRepeat;
 const uint16_t kTrotecStateLength = 9;
+const uint16_t kTrotecBits = kTrotecStateLength * 8;
 const uint16_t kTrotecDefaultRepeat = kNoRepeat;
 const uint16_t kWhirlpoolAcStateLength = 21;
 const uint16_t kWhirlpoolAcBits = kWhirlpoolAcStateLength * 8;
@@ -538,6 +979,17 @@ const uint8_t  kVestelAcBits = 56;
 // See: https://github.com/markszabo/IRremoteESP8266/issues/667
 #define F(x) x
 #endif  // F
+#ifndef PSTR
+// Ditto for the PSTR() macro. i.e. Outside Arduino it's a plain string.
+#define PSTR(x) x
+#endif  // PSTR
+#ifndef PROGMEM
+// Ditto for the PROGMEM attribute & accessors: outside of the Arduino
+// framework "flash" is just plain memory, so read it directly.
+#define PROGMEM
+#define pgm_read_byte(addr) (*reinterpret_cast<const uint8_t *>(addr))
+#define pgm_read_word(addr) (*reinterpret_cast<const uint16_t *>(addr))
+#endif  // PROGMEM
 #endif  // UNIT_TEST
 
 #endif  // IRREMOTEESP8266_H_
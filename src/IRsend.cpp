@@ -13,12 +13,98 @@
 #ifdef UNIT_TEST
 #include <cmath>
 #endif
+#include "IRrecv.h"
 #include "IRtimer.h"
+#include "IRutils.h"
 
 // Originally from https://github.com/shirriff/Arduino-IRremote/
 // Updated by markszabo (https://github.com/markszabo/IRremoteESP8266) for
 // sending IR code on ESP8266
 
+#if defined(ESP32) && !defined(UNIT_TEST)
+// Resolution (bits) of the LEDC timer used for hardware carrier generation.
+// 8 bits gives us duty cycle steps of <0.4% & works to well over 300kHz.
+const uint8_t kLedcResolution = 8;
+const uint32_t kLedcDutyMax = (1UL << kLedcResolution) - 1;
+#endif  // ESP32 && !UNIT_TEST
+
+#if defined(ESP32) && !defined(UNIT_TEST)
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+// Producer-side serialisation for the send queue, so several FreeRTOS
+// tasks can enqueue concurrently. (See setSendQueue()) The lock is only
+// ever held across the compile & ring publish of a single message, which
+// is pure CPU work (capture mode never waits out any timings), so a
+// contending producer blocks for at most one enqueue's worth of work.
+// Recursive, as a macro auto-split commits & re-begins mid-compile.
+#define Q_LOCK()                                                          \
+  if (_q_mutex != NULL)                                                   \
+    xSemaphoreTakeRecursive((SemaphoreHandle_t)_q_mutex, portMAX_DELAY)
+#define Q_UNLOCK() \
+  if (_q_mutex != NULL) xSemaphoreGiveRecursive((SemaphoreHandle_t)_q_mutex)
+#else  // ESP32 && !UNIT_TEST
+// Single-task cores. Producers can't overlap, so no locking is needed.
+#define Q_LOCK()
+#define Q_UNLOCK()
+#endif  // ESP32 && !UNIT_TEST
+
+#if !defined(ESP32) && !defined(UNIT_TEST)
+// Timer1-driven carrier generation state. (See IRsend::mark())
+// Timer1 is run off the 80MHz clock with a /16 divider, so each timer tick
+// is exactly 0.2 uSeconds. i.e. Sub-microsecond period accounting, with no
+// need for the empirical kPeriodOffset/calibrate() corrections.
+const uint32_t kHwTimerTicksPerUsec = 5;
+static uint8_t hwc_pin;             // GPIO the carrier is driven on.
+static uint8_t hwc_on_level;        // Pin level for "LED lit".
+static uint8_t hwc_off_level;       // Pin level for "LED dark".
+static int16_t hwc_pin2;            // Second emitter GPIO. -1 == none.
+static uint8_t hwc2_on_level;       // Ditto, for the second emitter.
+static uint8_t hwc2_off_level;
+static uint32_t hwc_on_ticks;       // Duty cycle "on" phase, in timer ticks.
+static uint32_t hwc_off_ticks;      // Duty cycle "off" phase, in timer ticks.
+static volatile bool hwc_phase_on;  // Is the pin currently in "on" phase?
+#if defined(ESP8266)
+// Direct-register copies of the IRsend fast-pin masks. (See ledMaskInit())
+// Statics rather than member access, as this runs in interrupt context.
+static bool hwc_fast;          // Use the register masks below?
+static uint32_t hwc_on_set;    // GPOS mask for the "on" phase.
+static uint32_t hwc_on_clear;  // GPOC mask for the "on" phase.
+static uint32_t hwc_off_set;   // GPOS mask for the "off" phase.
+static uint32_t hwc_off_clear;  // GPOC mask for the "off" phase.
+#endif  // ESP8266
+
+// The carrier generator. Flips the output to the next duty cycle phase &
+// re-arms timer1 for that phase's duration.
+static void IR_ISR_ATTR hwCarrierIsr(void) {
+  if (hwc_phase_on) {
+#if defined(ESP8266)
+    if (hwc_fast) {
+      if (hwc_off_set) GPOS = hwc_off_set;
+      if (hwc_off_clear) GPOC = hwc_off_clear;
+    } else
+#endif  // ESP8266
+    {
+      digitalWrite(hwc_pin, hwc_off_level);
+      if (hwc_pin2 >= 0) digitalWrite(hwc_pin2, hwc2_off_level);
+    }
+    timer1_write(hwc_off_ticks);
+  } else {
+#if defined(ESP8266)
+    if (hwc_fast) {
+      if (hwc_on_set) GPOS = hwc_on_set;
+      if (hwc_on_clear) GPOC = hwc_on_clear;
+    } else
+#endif  // ESP8266
+    {
+      digitalWrite(hwc_pin, hwc_on_level);
+      if (hwc_pin2 >= 0) digitalWrite(hwc_pin2, hwc2_on_level);
+    }
+    timer1_write(hwc_on_ticks);
+  }
+  hwc_phase_on = !hwc_phase_on;
+}
+#endif  // !ESP32 && !UNIT_TEST
+
 // IRsend ----------------------------------------------------------------------
 // Create an IRsend object.
 //
@@ -32,10 +118,38 @@
 //   use_modulation: Do we do frequency modulation during transmission?
 //                   i.e. If not, assume a 100% duty cycle. Ignore attempts
 //                        to change the duty cycle etc.
+//   ledc_channel: ESP32 only. Which LEDC PWM channel to generate the carrier
+//                 with in hardware. -1 (default) means generate it in
+//                 software, as on the ESP8266.
+//   use_hw_timer: ESP8266 only. Generate the carrier from a timer1 interrupt
+//                 with 0.2 uSec period accounting, rather than from paired
+//                 delay calls in mark(). More accurate under WiFi interrupt
+//                 load, but claims timer1. (Default: false)
+//   load_calibration: ESP8266 only. Apply a calibration previously persisted
+//                     with saveCalibration(), so no boot-time calibrate()
+//                     transmission is needed. Silently keeps the compiled-in
+//                     default if no valid calibration is found.
+//                     (Default: false)
 // Returns:
 //   An IRsend object.
-IRsend::IRsend(uint16_t IRsendPin, bool inverted, bool use_modulation)
+#if defined(ESP32)
+IRsend::IRsend(uint16_t IRsendPin, bool inverted, bool use_modulation,
+               int8_t ledc_channel)
     : IRpin(IRsendPin), periodOffset(kPeriodOffset) {
+  _ledc_channel = ledc_channel;
+  _ledc_duty = 0;
+  _ledc_off = 0;
+#else  // ESP32
+IRsend::IRsend(uint16_t IRsendPin, bool inverted, bool use_modulation,
+               bool use_hw_timer, bool load_calibration)
+    : IRpin(IRsendPin), periodOffset(kPeriodOffset) {
+  _use_hw_timer = use_hw_timer;
+#if defined(ESP8266) && !defined(UNIT_TEST)
+  if (load_calibration) loadCalibration();
+#else  // ESP8266 && !UNIT_TEST
+  (void)load_calibration;  // There is no persistent storage to load from.
+#endif  // ESP8266 && !UNIT_TEST
+#endif  // ESP32
   if (inverted) {
     outputOn = LOW;
     outputOff = HIGH;
@@ -43,32 +157,180 @@ IRsend::IRsend(uint16_t IRsendPin, bool inverted, bool use_modulation)
     outputOn = HIGH;
     outputOff = LOW;
   }
+  // No second emitter until setSecondPin() is called.
+  _pin2 = -1;
+  _pin2_on = HIGH;
+  _pin2_off = LOW;
+#if defined(ESP8266)
+  // No fast-pin register masks until begin() computes them.
+  _fastpins = false;
+  _on_set = _on_clear = _off_set = _off_clear = 0;
+#endif  // ESP8266
   modulation = use_modulation;
   if (modulation)
     _dutycycle = kDutyDefault;
   else
     _dutycycle = kDutyMax;
+  // Cooperative (yielding) sends are off until setYieldGap() is called.
+  _yield_gap = 0;
+  // Nothing is being compiled to a pulse train until asked.
+  _capbuf = NULL;
+  _caplen = 0;
+  _capmaxlen = 0;
+  _capfreq = 0;
+  _capturing = false;
+  _capoverflow = false;
+  _cap_predelay = 0;
+  _cap_autosplit = false;
+  _cap_commitfail = false;
+  // The send queue is off until setSendQueue() is called.
+  _queue = NULL;
+  _q_size = 0;
+  _q_head = 0;
+  _q_tail = 0;
+  _q_maxlen = 0;
+  _q_capbuf = NULL;
+#if defined(ESP32)
+  _q_mutex = NULL;
+#endif  // ESP32
+#if IRSEND_STATS
+  resetSendStats();
+#endif  // IRSEND_STATS
+#if SEND_GLOBALCACHE
+  // The sendGC() converted-code cache is off until setGCCache() is called.
+  _gc_cache_on = false;
+  _gc_key = NULL;
+  _gc_len = 0;
+  _gc_sum = 0;
+  _gc_entries = 0;
+  _gc_usecs = NULL;
+#endif  // SEND_GLOBALCACHE
+  // No loopback verification until setVerifyReceiver() is called.
+  _verify_recv = NULL;
+  // Ditto the send cache & setSendCache().
+  _cache = NULL;
+  _c_size = 0;
+  _c_maxlen = 0;
+  _c_agecounter = 0;
+}
+
+// Class destructor.
+IRsend::~IRsend(void) {
+  setSendQueue(0, 0);  // Free any send queue allocations.
+  setSendCache(0, 0);  // Ditto for the send cache.
+#if SEND_GLOBALCACHE
+  setGCCache(false);  // Ditto for the sendGC() converted-code cache.
+#endif  // SEND_GLOBALCACHE
 }
 
 // Enable the pin for output.
 void IRsend::begin() {
 #ifndef UNIT_TEST
   pinMode(IRpin, OUTPUT);
+  if (_pin2 >= 0) pinMode(_pin2, OUTPUT);
+#if defined(ESP8266)
+  ledMaskInit();  // (Re)compute the direct GPIO register masks.
+#endif  // ESP8266
+  IR_PROFILE_INIT();  // Set up the profiling pin, if one is configured.
+  IR_PROFILE_LOW();  // Start it in the idle (space) state.
+#endif
+  ledOff();  // Ensure the LED(s) are in a known safe state when we start.
+}
+
+#if defined(ESP8266)
+// Precompute the direct GPIO register masks for ledOn()/ledOff().
+// digitalWrite() does a pin-table lookup & an indirect register select on
+// every call, & the software carrier makes two such calls per carrier
+// period (~76k/sec of mark time at 38kHz). A write of a precomputed mask
+// to GPOS (set) or GPOC (clear) drives the same pin in a single store, &
+// both emitters (see setSecondPin()) fold into the same store for free.
+// The masks encode the configured polarities, so inverted outputs cost
+// nothing extra either.
+void IRsend::ledMaskInit() {
+  _on_set = _on_clear = _off_set = _off_clear = 0;
+  // GPIO16 lives in the RTC I/O block & has no GPOS/GPOC bits, so any pin
+  // above 15 keeps the digitalWrite() fall-back for all of them.
+  _fastpins = IRpin < 16 && _pin2 < 16;
+  if (!_fastpins) return;
+  if (outputOn == HIGH)
+    _on_set |= 1UL << IRpin;
+  else
+    _on_clear |= 1UL << IRpin;
+  if (outputOff == HIGH)
+    _off_set |= 1UL << IRpin;
+  else
+    _off_clear |= 1UL << IRpin;
+  if (_pin2 >= 0) {
+    if (_pin2_on == HIGH)
+      _on_set |= 1UL << _pin2;
+    else
+      _on_clear |= 1UL << _pin2;
+    if (_pin2_off == HIGH)
+      _off_set |= 1UL << _pin2;
+    else
+      _off_clear |= 1UL << _pin2;
+  }
+}
+#endif  // ESP8266
+
+// Drive a second IR emitter pin with the same signal. e.g. Front & rear
+// blasters in the same room. Both pins are toggled in the same mark()/
+// space() (or carrier interrupt) operations, so one send reaches both
+// emitters simultaneously instead of transmitting twice.
+//
+// Args:
+//   pin: GPIO to use for the second emitter. -1 disables it.
+//   inverted: *DANGER* Invert the second output. The same warnings as the
+//             constructor's `inverted` flag apply. (Default: false)
+//             Note: Not supported (ignored) in ESP32 LEDC hardware carrier
+//             mode, where both pins are fed by the same PWM channel.
+void IRsend::setSecondPin(int16_t pin, bool inverted) {
+  _pin2 = pin;
+  if (inverted) {
+    _pin2_on = LOW;
+    _pin2_off = HIGH;
+  } else {
+    _pin2_on = HIGH;
+    _pin2_off = LOW;
+  }
+  if (_pin2 >= 0) {
+#ifndef UNIT_TEST
+    pinMode(_pin2, OUTPUT);
 #endif
-  ledOff();  // Ensure the LED is in a known safe state when we start.
+  }
+#if defined(ESP8266)
+  ledMaskInit();  // The pin set changed; recompute the register masks.
+#endif  // ESP8266
+  if (_pin2 >= 0) ledOff();  // Start the new emitter in a known safe state.
 }
 
 // Turn off the IR LED.
 void IRsend::ledOff() {
 #ifndef UNIT_TEST
+#if defined(ESP8266)
+  if (_fastpins) {  // Single-store register writes. (See ledMaskInit())
+    if (_off_set) GPOS = _off_set;
+    if (_off_clear) GPOC = _off_clear;
+    return;
+  }
+#endif  // ESP8266
   digitalWrite(IRpin, outputOff);
+  if (_pin2 >= 0) digitalWrite(_pin2, _pin2_off);
 #endif
 }
 
 // Turn on the IR LED.
 void IRsend::ledOn() {
 #ifndef UNIT_TEST
+#if defined(ESP8266)
+  if (_fastpins) {  // Single-store register writes. (See ledMaskInit())
+    if (_on_set) GPOS = _on_set;
+    if (_on_clear) GPOC = _on_clear;
+    return;
+  }
+#endif  // ESP8266
   digitalWrite(IRpin, outputOn);
+  if (_pin2 >= 0) digitalWrite(_pin2, _pin2_on);
 #endif
 }
 
@@ -90,6 +352,44 @@ uint32_t IRsend::calcUSecPeriod(uint32_t hz, bool use_offset) {
     return std::max((uint32_t)1, period);
 }
 
+#if IRSEND_STATS
+// Fold a measured mark/space duration into the timing statistics.
+//
+// Args:
+//   requested: The duration (uSecs) the sender asked for.
+//   achieved: The duration (uSecs) it actually took to produce.
+void IRsend::sendStatsRecord(uint32_t requested, uint32_t achieved) {
+  int32_t skew = (int32_t)achieved - (int32_t)requested;
+  if (_sendstats.entries == 0) {
+    _sendstats.min_skew = skew;
+    _sendstats.max_skew = skew;
+  } else {
+    _sendstats.min_skew = std::min(_sendstats.min_skew, skew);
+    _sendstats.max_skew = std::max(_sendstats.max_skew, skew);
+  }
+  _sendstats.entries++;
+  _sendstats.requested += requested;
+  _sendstats.achieved += achieved;
+}
+
+// Get the requested vs. achieved timing statistics collected since the
+// last resetSendStats(). Call resetSendStats() before a send & this after
+// it to profile a single message.
+//
+// Returns:
+//   An irsend_stats_t. With entries == 0 the skew fields are meaningless.
+irsend_stats_t IRsend::getSendStats() { return _sendstats; }
+
+// Zero the timing statistics. e.g. Before a send you want to profile.
+void IRsend::resetSendStats() {
+  _sendstats.entries = 0;
+  _sendstats.requested = 0;
+  _sendstats.achieved = 0;
+  _sendstats.min_skew = 0;
+  _sendstats.max_skew = 0;
+}
+#endif  // IRSEND_STATS
+
 // Set the output frequency modulation and duty cycle.
 //
 // Args:
@@ -113,11 +413,64 @@ void IRsend::enableIROut(uint32_t freq, uint8_t duty) {
 #ifdef UNIT_TEST
   _freq_unittest = freq;
 #endif  // UNIT_TEST
+  if (_capturing) {  // Compiling? Record the carrier freq.
+    if (_cap_autosplit && _caplen > 0 && freq != _capfreq) {
+      // A macro is switching carrier frequency mid-compile. A pulse train
+      // only has one carrier, so park what we have as its own queued
+      // message & carry on compiling into a fresh one.
+      if (!queueCommit(NULL)) _cap_commitfail = true;
+      queueBegin();
+    }
+    _capfreq = freq;
+  }
   uint32_t period = calcUSecPeriod(freq);
   // Nr. of uSeconds the LED will be on per pulse.
   onTimePeriod = (period * _dutycycle) / kDutyMax;
   // Nr. of uSeconds the LED will be off per pulse.
   offTimePeriod = period - onTimePeriod;
+#if !defined(ESP32) && !defined(UNIT_TEST)
+  if (_use_hw_timer) {
+    // Timer interrupt carrier. Work the duty cycle phases out in 0.2 uSec
+    // timer ticks straight from the frequency. No kPeriodOffset needed, as
+    // there is no per-pulse software overhead to compensate for.
+    uint32_t period_ticks = kHwTimerTicksPerUsec * 1000000UL / freq;
+    hwc_on_ticks = period_ticks * _dutycycle / kDutyMax;
+    hwc_off_ticks = period_ticks - hwc_on_ticks;
+    hwc_pin = IRpin;
+    hwc_on_level = outputOn;
+    hwc_off_level = outputOff;
+    hwc_pin2 = _pin2;
+    hwc2_on_level = _pin2_on;
+    hwc2_off_level = _pin2_off;
+#if defined(ESP8266)
+    // Hand the interrupt handler the direct-register masks too.
+    ledMaskInit();
+    hwc_fast = _fastpins;
+    hwc_on_set = _on_set;
+    hwc_on_clear = _on_clear;
+    hwc_off_set = _off_set;
+    hwc_off_clear = _off_clear;
+#endif  // ESP8266
+  }
+#endif  // !ESP32 && !UNIT_TEST
+#if defined(ESP32) && !defined(UNIT_TEST)
+  if (_ledc_channel >= 0) {
+    // Hardware carrier generation. Drive the pin from a LEDC PWM timer
+    // running at the carrier frequency, so mark() & space() only have to
+    // flip the duty cycle rather than bit-bang every single carrier pulse.
+    ledcSetup(_ledc_channel, freq, kLedcResolution);
+    ledcAttachPin(IRpin, _ledc_channel);
+    // A LEDC channel can feed any number of pins, so a second emitter is
+    // free: route it to the same channel. (No per-pin inversion, though.)
+    if (_pin2 >= 0) ledcAttachPin(_pin2, _ledc_channel);
+    // Scale the duty cycle percentage to the LEDC timer's range, flipped
+    // when the output is inverted.
+    uint32_t duty = kLedcDutyMax * _dutycycle / kDutyMax;
+    _ledc_duty = (outputOn == HIGH) ? duty : kLedcDutyMax - duty;
+    _ledc_off = (outputOn == HIGH) ? 0 : kLedcDutyMax;
+    ledcWrite(_ledc_channel, _ledc_off);  // Start with the carrier off.
+  }
+#endif  // ESP32 && !UNIT_TEST
 }
 
 #if ALLOW_DELAY_CALLS
@@ -133,10 +486,24 @@ void IRsend::_delayMicroseconds(uint32_t usec) {
 #endif
   } else {
 #ifndef UNIT_TEST
-    // Invoke a delay(), where possible, to avoid triggering the WDT.
-    delay(usec / 1000UL);  // Delay for as many whole milliseconds as we can.
-    // Delay the remaining sub-millisecond.
-    delayMicroseconds(static_cast<uint16_t>(usec % 1000UL));
+    // Long wait (e.g. a kDefaultMessageGap inter-frame gap). Work against a
+    // micros() deadline rather than one big delay() call: delay() only has
+    // millisecond granularity & the scheduler can stretch it further, which
+    // is enough to upset protocols with strict repeat spacing. Sleeping in
+    // 1ms slices still yields to WiFi/lwIP & feeds the soft-WDT the whole
+    // time; only the final, sub-16383us remainder is busy-waited, &
+    // it absorbs however much the slices overshot. i.e. Accurate to the
+    // final busy-wait, no matter what the scheduler did in between.
+    IRtimer deadlineTimer = IRtimer();
+    // Note: The explicit not-yet-expired check guards the subtraction. A
+    // single delay(1) slice can stretch past the whole deadline when the
+    // SDK stalls us, & `usec - elapsed` would underflow & spin for ages.
+    for (uint32_t elapsed = 0;
+         elapsed < usec && usec - elapsed > kMaxAccurateUsecDelay;
+         elapsed = deadlineTimer.elapsed())
+      delay(1);  // Yields. i.e. The network stack etc. get serviced.
+    uint32_t elapsed = deadlineTimer.elapsed();
+    if (elapsed < usec) delayMicroseconds(usec - elapsed);
 #endif
   }
 }
@@ -174,11 +541,56 @@ void IRsend::_delayMicroseconds(uint32_t usec) {
 // Ref:
 //   https://www.analysir.com/blog/2017/01/29/updated-esp8266-nodemcu-backdoor-upwm-hack-for-ir-signals/
 uint16_t IRsend::mark(uint16_t usec) {
+  if (_capturing) {  // Compiling to a pulse train, not transmitting.
+    captureAppend(usec, true);
+    return 0;  // No actual pulses were sent.
+  }
+  IR_PROFILE_HIGH();  // Profiling pin follows the modulation envelope.
+#if IRSEND_STATS
+  IRtimer statsTimer = IRtimer();
+#endif  // IRSEND_STATS
+#if defined(ESP32) && !defined(UNIT_TEST)
+  if (_ledc_channel >= 0) {  // Hardware carrier generation.
+    ledcWrite(_ledc_channel, _ledc_duty);  // Carrier on.
+    _delayMicroseconds(usec);
+    ledcWrite(_ledc_channel, _ledc_off);   // Carrier off.
+#if IRSEND_STATS
+    sendStatsRecord(usec, statsTimer.elapsed());
+#endif  // IRSEND_STATS
+    // We didn't have to count pulses, so report how many the hardware
+    // should have produced in that time.
+    return usec / (onTimePeriod + offTimePeriod);
+  }
+#endif  // ESP32 && !UNIT_TEST
+#if !defined(ESP32) && !defined(UNIT_TEST)
+  if (_use_hw_timer && modulation && _dutycycle < 100) {
+    // Timer interrupt carrier generation. Start the "on" phase, then let
+    // hwCarrierIsr() produce the pulses while we wait out the mark. WiFi &
+    // other interrupt load no longer stretches individual pulses, as the
+    // timer keeps its own time.
+    hwc_phase_on = true;
+    digitalWrite(IRpin, outputOn);
+    if (_pin2 >= 0) digitalWrite(_pin2, _pin2_on);
+    timer1_attachInterrupt(hwCarrierIsr);
+    timer1_enable(TIM_DIV16, TIM_EDGE, TIM_SINGLE);
+    timer1_write(hwc_on_ticks);
+    _delayMicroseconds(usec);
+    timer1_disable();
+    ledOff();
+#if IRSEND_STATS
+    sendStatsRecord(usec, statsTimer.elapsed());
+#endif  // IRSEND_STATS
+    return usec / (onTimePeriod + offTimePeriod);
+  }
+#endif  // !ESP32 && !UNIT_TEST
   // Handle the simple case of no required frequency modulation.
   if (!modulation || _dutycycle >= 100) {
     ledOn();
     _delayMicroseconds(usec);
     ledOff();
+#if IRSEND_STATS
+    sendStatsRecord(usec, statsTimer.elapsed());
+#endif  // IRSEND_STATS
     return 1;
   }
 
@@ -196,13 +608,20 @@ uint16_t IRsend::mark(uint16_t usec) {
     _delayMicroseconds(std::min((uint32_t)onTimePeriod, usec - elapsed));
     ledOff();
     counter++;
-    if (elapsed + onTimePeriod >= usec)
+    if (elapsed + onTimePeriod >= usec) {
+#if IRSEND_STATS
+      sendStatsRecord(usec, statsTimer.elapsed());
+#endif  // IRSEND_STATS
       return counter;  // LED is now off & we've passed our allotted time.
+    }
     // Wait for the lesser of the rest of the duty cycle, or the time remaining.
     _delayMicroseconds(
         std::min(usec - elapsed - onTimePeriod, (uint32_t)offTimePeriod));
     elapsed = usecTimer.elapsed();  // Update & recache the actual elapsed time.
   }
+#if IRSEND_STATS
+  sendStatsRecord(usec, statsTimer.elapsed());
+#endif  // IRSEND_STATS
   return counter;
 }
 
@@ -213,9 +632,72 @@ uint16_t IRsend::mark(uint16_t usec) {
 // Args:
 //   time: Time in microseconds (us).
 void IRsend::space(uint32_t time) {
+  if (_capturing) {  // Compiling to a pulse train, not transmitting.
+    if (_cap_autosplit && _caplen == 0) {
+      // A space before the first mark can't live in the pulse train (a
+      // leading space is dropped), but it needn't be lost: fold it into
+      // this message's pre-delay, so sendQueueLoop() waits it out instead.
+      // e.g. Lego PF's spec'd pause before transmission.
+      _cap_predelay += time;
+      return;
+    }
+    if (_cap_autosplit && time > UINT16_MAX) {
+      // The gap is too long to store in a pulse train entry. Split the
+      // macro here & have sendQueueLoop() wait out the gap instead, so it
+      // is honoured exactly without ever blocking the main loop.
+      if (!queueCommit(NULL)) _cap_commitfail = true;
+      queueBegin();
+      _cap_predelay = time;
+      return;
+    }
+    captureAppend(time, false);
+    return;
+  }
+  IR_PROFILE_LOW();  // Profiling pin follows the modulation envelope.
+#if IRSEND_STATS
+  IRtimer statsTimer = IRtimer();
+#endif  // IRSEND_STATS
+  if (_yield_gap && time >= _yield_gap) {
+    // Cooperative mode & this space is long enough to be a protocol-safe
+    // point (an inter-frame or inter-section gap). Give the network stack
+    // & the soft-WDT a turn, & absorb the time that took into the gap
+    // itself, so the transmitted timing is unchanged.
+    IRtimer gapTimer = IRtimer();
+#if defined(ESP32) && !defined(UNIT_TEST)
+    if (_ledc_channel >= 0)
+      ledcWrite(_ledc_channel, _ledc_off);  // Ensure the carrier is off.
+    else
+#endif  // ESP32 && !UNIT_TEST
+      ledOff();
+#ifndef UNIT_TEST
+    yield();  // Aka. delay(0). Lets lwIP etc. get serviced mid-send.
+#endif  // UNIT_TEST
+    uint32_t elapsed = gapTimer.elapsed();
+    if (elapsed < time) _delayMicroseconds(time - elapsed);
+#if IRSEND_STATS
+    sendStatsRecord(time, statsTimer.elapsed());
+#endif  // IRSEND_STATS
+    return;
+  }
+#if defined(ESP32) && !defined(UNIT_TEST)
+  if (_ledc_channel >= 0) {  // Hardware carrier generation.
+    // Use the LEDC timer, not digitalWrite(), as the pin is routed to the
+    // PWM peripheral while a LEDC channel is attached to it.
+    ledcWrite(_ledc_channel, _ledc_off);  // Ensure the carrier is off.
+    if (time == 0) return;
+    _delayMicroseconds(time);
+#if IRSEND_STATS
+    sendStatsRecord(time, statsTimer.elapsed());
+#endif  // IRSEND_STATS
+    return;
+  }
+#endif  // ESP32 && !UNIT_TEST
   ledOff();
   if (time == 0) return;
   _delayMicroseconds(time);
+#if IRSEND_STATS
+  sendStatsRecord(time, statsTimer.elapsed());
+#endif  // IRSEND_STATS
 }
 
 // Calculate & set any offsets to account for execution times.
@@ -259,6 +741,87 @@ int8_t IRsend::calibrate(uint16_t hz) {
   return periodOffset;
 }
 
+// Enable (or disable) cooperative sends.
+// Long frames (e.g. 53 byte Hitachi A/C states) keep the CPU busy in
+// mark()/space() for hundreds of milliseconds, which starves the network
+// stack & risks a soft-WDT reset. With a yield gap set, any space() of at
+// least that many usecs (i.e. a protocol-safe point: an inter-frame gap, or
+// an inter-section gap like Gree's & Whirlpool's) calls yield() first & then
+// waits out only the remainder of the gap, so the scheduler gets serviced
+// mid-send without disturbing the transmitted timings.
+//
+// Args:
+//   usecs: Min. length of a space (usecs) at which to yield().
+//          Must be longer than the protocol's longest data bit space, or
+//          frames will be corrupted by mid-data yields. 0 disables.
+//          (Default: kYieldSafeGapMin)
+void IRsend::setYieldGap(const uint32_t usecs) { _yield_gap = usecs; }
+
+// Get the current cooperative send yield gap. (usecs. 0 == disabled)
+uint32_t IRsend::getYieldGap(void) { return _yield_gap; }
+
+// Pack the current calibration into a single 32-bit blob suitable for
+// persisting across boots. e.g. In RTC user memory or EEPROM.
+// Layout: [31:16] kCalibrationTag, [15:8] the offset byte inverted (an
+// integrity check), [7:0] the period offset as an unsigned byte.
+//
+// Returns:
+//   The packed calibration blob.
+uint32_t IRsend::calibrationBlob(void) {
+  const uint8_t offset = (uint8_t)periodOffset;
+  return ((uint32_t)kCalibrationTag << 16) |
+         ((uint32_t)(uint8_t)~offset << 8) | offset;
+}
+
+// Validate a blob made by calibrationBlob() & adopt the period offset it
+// carries, skipping the boot-time calibrate() transmission & measurement.
+//
+// Args:
+//   blob: A value previously obtained from calibrationBlob().
+// Returns:
+//   A boolean. true if the blob checked out & the offset is now in use.
+//   false leaves the current offset untouched. e.g. On the first ever boot,
+//   or after the storage lost power.
+bool IRsend::restoreCalibration(const uint32_t blob) {
+  if ((blob >> 16) != kCalibrationTag) return false;  // Not our tag.
+  const uint8_t offset = blob & 0xFF;
+  if (((blob >> 8) & 0xFF) != (uint8_t)~offset)
+    return false;  // Integrity byte mismatch. e.g. Corrupt storage.
+  periodOffset = (int8_t)offset;
+  return true;
+}
+
+#if defined(ESP8266) && !defined(UNIT_TEST)
+// Persist the current calibration to ESP8266 RTC user memory, where it
+// survives deep sleep & resets (though not power removal). Call once after
+// calibrate(); construct later IRsend objects with load_calibration set (or
+// call loadCalibration()) & the boot sequence needs no calibration
+// transmission at all.
+//
+// Args:
+//   rtc_slot: Which 4-byte RTC user memory block to write.
+//             (Default: kCalibrationRtcSlot)
+// Returns:
+//   A boolean. true if the write succeeded.
+bool IRsend::saveCalibration(const uint8_t rtc_slot) {
+  uint32_t blob = calibrationBlob();
+  return ESP.rtcUserMemoryWrite(rtc_slot, &blob, sizeof(blob));
+}
+
+// Load & apply a calibration persisted by saveCalibration().
+//
+// Args:
+//   rtc_slot: Which 4-byte RTC user memory block to read.
+//             (Default: kCalibrationRtcSlot)
+// Returns:
+//   A boolean. true if a valid calibration was found & is now in use.
+bool IRsend::loadCalibration(const uint8_t rtc_slot) {
+  uint32_t blob = 0;
+  if (!ESP.rtcUserMemoryRead(rtc_slot, &blob, sizeof(blob))) return false;
+  return restoreCalibration(blob);
+}
+#endif  // ESP8266 && !UNIT_TEST
+
 // Generic method for sending data that is common to most protocols.
 // Will send leading or trailing 0's if the nbits is larger than the number
 // of bits in data.
@@ -284,7 +847,70 @@ void IRsend::sendData(uint16_t onemark, uint32_t onespace, uint16_t zeromark,
       nbits--;
     }
     // Send the supplied data.
-    for (uint64_t mask = 1ULL << (nbits - 1); mask; mask >>= 1)
+    // Work in native 32 bit values whenever the data fits. 64 bit shifts &
+    // compares are library calls on these 32 bit MCUs, & that software
+    // overhead between bits stretches the transmitted timings.
+    if (nbits <= 32) {
+      uint32_t data32 = (uint32_t)data;
+      for (uint32_t mask = 1UL << (nbits - 1); mask; mask >>= 1)
+        if (data32 & mask) {  // Send a 1
+          mark(onemark);
+          space(onespace);
+        } else {  // Send a 0
+          mark(zeromark);
+          space(zerospace);
+        }
+    } else {
+      for (uint64_t mask = 1ULL << (nbits - 1); mask; mask >>= 1)
+        if (data & mask) {  // Send a 1
+          mark(onemark);
+          space(onespace);
+        } else {  // Send a 0
+          mark(zeromark);
+          space(zerospace);
+        }
+    }
+  } else {  // Send the Least Significant Bit (LSB) first / MSB last.
+    if (nbits <= 32) {  // Native 32 bit fast path, as above.
+      uint32_t data32 = (uint32_t)data;
+      for (uint16_t bit = 0; bit < nbits; bit++, data32 >>= 1)
+        if (data32 & 1) {  // Send a 1
+          mark(onemark);
+          space(onespace);
+        } else {  // Send a 0
+          mark(zeromark);
+          space(zerospace);
+        }
+    } else {
+      for (uint16_t bit = 0; bit < nbits; bit++, data >>= 1)
+        if (data & 1) {  // Send a 1
+          mark(onemark);
+          space(onespace);
+        } else {  // Send a 0
+          mark(zeromark);
+          space(zerospace);
+        }
+    }
+  }
+}
+
+// Send a single byte of data. A slimmed down version of sendData() for the
+// byte-array senders (i.e. most A/C protocols): the bit order branch is
+// hoisted out of the bit loop, & all the mask arithmetic is 8 bit wide.
+// The fixed 8-trip loops are simple enough for the compiler to unroll, so
+// there is minimal software overhead between bits in a long message.
+//
+// Args:
+//   onemark:    Nr. of usecs for the led to be pulsed for a '1' bit.
+//   onespace:   Nr. of usecs for the led to be fully off for a '1' bit.
+//   zeromark:   Nr. of usecs for the led to be pulsed for a '0' bit.
+//   zerospace:  Nr. of usecs for the led to be fully off for a '0' bit.
+//   data:       The byte to be transmitted.
+//   MSBfirst:   Flag for bit transmission order. Defaults to MSB->LSB order.
+void IRsend::sendByte(uint16_t onemark, uint32_t onespace, uint16_t zeromark,
+                      uint32_t zerospace, uint8_t data, bool MSBfirst) {
+  if (MSBfirst) {  // Send the MSB first.
+    for (uint8_t mask = 0x80; mask; mask >>= 1)
       if (data & mask) {  // Send a 1
         mark(onemark);
         space(onespace);
@@ -293,8 +919,9 @@ void IRsend::sendData(uint16_t onemark, uint32_t onespace, uint16_t zeromark,
         space(zerospace);
       }
   } else {  // Send the Least Significant Bit (LSB) first / MSB last.
-    for (uint16_t bit = 0; bit < nbits; bit++, data >>= 1)
-      if (data & 1) {  // Send a 1
+    // The mask shifts out of the top of the byte after the 8th bit.
+    for (uint8_t mask = 0x01; mask; mask <<= 1)
+      if (data & mask) {  // Send a 1
         mark(onemark);
         space(onespace);
       } else {  // Send a 0
@@ -345,6 +972,49 @@ void IRsend::sendGeneric(const uint16_t headermark, const uint32_t headerspace,
               dutycycle);
 }
 
+// Append the mark/space pairs for the `nbits` of `data` to a frame image.
+// i.e. The rendering equivalent of sendData(), minus the modulation.
+//
+// Args:
+//   image: The frame image buffer to append to. Must have room for
+//          2 * nbits more entries.
+//   len:   Nr. of entries already in the image.
+//   (The rest are as per sendData().)
+// Returns:
+//   The new nr. of entries in the image.
+static uint16_t renderDataImage(uint32_t *image, uint16_t len,
+                                const uint16_t onemark,
+                                const uint32_t onespace,
+                                const uint16_t zeromark,
+                                const uint32_t zerospace, const uint64_t data,
+                                const uint16_t nbits, const bool MSBfirst) {
+  if (MSBfirst) {  // MSB first.
+    for (uint64_t mask = 1ULL << (nbits - 1); mask; mask >>= 1)
+      if (data & mask) {  // A '1' bit.
+        image[len++] = onemark;
+        image[len++] = onespace;
+      } else {  // A '0' bit.
+        image[len++] = zeromark;
+        image[len++] = zerospace;
+      }
+  } else {  // LSB first.
+    uint64_t copy = data;
+    for (uint16_t bit = 0; bit < nbits; bit++, copy >>= 1)
+      if (copy & 1) {  // A '1' bit.
+        image[len++] = onemark;
+        image[len++] = onespace;
+      } else {  // A '0' bit.
+        image[len++] = zeromark;
+        image[len++] = zerospace;
+      }
+  }
+  return len;
+}
+
+// Max. nr. of entries in a rendered <= 64 bit frame image:
+// header mark + space (2) + 64 data bits (128) + footer mark (1).
+const uint16_t kFrameImageMax = 131;
+
 // Generic method for sending simple protocol messages.
 // Will send leading or trailing 0's if the nbits is larger than the number
 // of bits in data.
@@ -387,19 +1057,46 @@ void IRsend::sendGeneric(const uint16_t headermark, const uint32_t headerspace,
   enableIROut(frequency, dutycycle);
   IRtimer usecs = IRtimer();
 
+  // Render the frame into a mark/space image once, so every iteration
+  // (incl. repeats) is a straight playback of precomputed timings rather
+  // than a re-walk of the data bits. The trailing gap isn't part of the
+  // image as it depends on the actual elapsed time of each iteration.
+  // Frames needing leading zero bits (nbits > 64) don't fit the image
+  // buffer & are modulated the old way below.
+  const bool use_image = (nbits <= sizeof(data) * 8);
+  uint32_t image[kFrameImageMax];
+  uint16_t image_len = 0;
+  // Does the image start with a space? i.e. A headerspace & no headermark.
+  const bool lead_space = (!headermark && headerspace);
+  if (use_image) {
+    if (headermark) image[image_len++] = headermark;
+    if (headerspace) image[image_len++] = headerspace;
+    if (nbits)
+      image_len = renderDataImage(image, image_len, onemark, onespace,
+                                  zeromark, zerospace, data, nbits, MSBfirst);
+    if (footermark) image[image_len++] = footermark;
+  }
+
   // We always send a message, even for repeat=0, hence '<= repeat'.
   for (uint16_t r = 0; r <= repeat; r++) {
     usecs.reset();
 
-    // Header
-    if (headermark) mark(headermark);
-    if (headerspace) space(headerspace);
-
-    // Data
-    sendData(onemark, onespace, zeromark, zerospace, data, nbits, MSBfirst);
-
-    // Footer
-    if (footermark) mark(footermark);
+    if (use_image) {  // Play back the rendered frame.
+      bool is_space = lead_space;
+      for (uint16_t i = 0; i < image_len; i++, is_space = !is_space)
+        if (is_space)
+          space(image[i]);
+        else
+          mark(image[i]);
+    } else {  // Modulate the frame directly.
+      // Header
+      if (headermark) mark(headermark);
+      if (headerspace) space(headerspace);
+      // Data
+      sendData(onemark, onespace, zeromark, zerospace, data, nbits, MSBfirst);
+      // Footer
+      if (footermark) mark(footermark);
+    }
     uint32_t elapsed = usecs.elapsed();
     // Avoid potential unsigned integer underflow. e.g. when mesgtime is 0.
     if (elapsed >= mesgtime)
@@ -445,6 +1142,41 @@ void IRsend::sendGeneric(const uint16_t headermark, const uint32_t headerspace,
                          const uint16_t repeat, const uint8_t dutycycle) {
   // Setup
   enableIROut(frequency, dutycycle);
+  // For repeated messages, render the frame image once & replay it, as the
+  // per-bit work for a long A/C state is done per frame otherwise. A
+  // single-shot message (the common case) is just modulated directly, as
+  // is a repeated one if the image allocation fails.
+  uint32_t *image = NULL;
+  uint32_t image_size = 0;
+  if (repeat && nbytes) {
+    // Header mark + space (2) + the data bits + footer mark (1).
+    image_size = ((uint32_t)nbytes * 16 + 3) * sizeof(uint32_t);
+    image = new uint32_t[nbytes * 16 + 3];
+    if (image != NULL) {
+      irMemRecordAlloc(image_size);
+      uint16_t len = 0;
+      if (headermark) image[len++] = headermark;
+      if (headerspace) image[len++] = headerspace;
+      for (uint16_t i = 0; i < nbytes; i++)
+        len = renderDataImage(image, len, onemark, onespace, zeromark,
+                              zerospace, *(dataptr + i), 8, MSBfirst);
+      if (footermark) image[len++] = footermark;
+      // Does the image start with a space? Only if there was no headermark.
+      const bool lead_space = (!headermark && headerspace);
+      for (uint16_t r = 0; r <= repeat; r++) {
+        bool is_space = lead_space;
+        for (uint16_t i = 0; i < len; i++, is_space = !is_space)
+          if (is_space)
+            space(image[i]);
+          else
+            mark(image[i]);
+        space(gap);
+      }
+      delete[] image;
+      irMemRecordFree(image_size);
+      return;
+    }
+  }
   // We always send a message, even for repeat=0, hence '<= repeat'.
   for (uint16_t r = 0; r <= repeat; r++) {
     // Header
@@ -453,7 +1185,7 @@ void IRsend::sendGeneric(const uint16_t headermark, const uint32_t headerspace,
 
     // Data
     for (uint16_t i = 0; i < nbytes; i++)
-      sendData(onemark, onespace, zeromark, zerospace, *(dataptr + i), 8,
+      sendByte(onemark, onespace, zeromark, zerospace, *(dataptr + i),
                MSBfirst);
 
     // Footer
@@ -462,6 +1194,568 @@ void IRsend::sendGeneric(const uint16_t headermark, const uint32_t headerspace,
   }
 }
 
+// Generic method for sending simple protocol messages, with the fixed
+// timing parameters supplied as a single descriptor. See irtiming_t.
+//
+// Args:
+//   proto:  The protocol's timing descriptor.
+//   data:   The data to be transmitted.
+//   nbits:  Nr. of bits of data to be sent.
+//   repeat: Nr. of extra times the message will be sent.
+void IRsend::sendGeneric(const irtiming_t &proto, const uint64_t data,
+                         const uint16_t nbits, const uint16_t repeat) {
+  sendGeneric(proto.headermark, proto.headerspace, proto.onemark,
+              proto.onespace, proto.zeromark, proto.zerospace,
+              proto.footermark, proto.gap, data, nbits, proto.frequency,
+              proto.msbfirst, repeat, proto.dutycycle);
+}
+
+// As above, but for protocols whose data is an array of bytes.
+//
+// Args:
+//   proto:   The protocol's timing descriptor.
+//   dataptr: Pointer to the data to be transmitted.
+//   nbytes:  Nr. of bytes of data to be sent.
+//   repeat:  Nr. of extra times the message will be sent.
+void IRsend::sendGeneric(const irtiming_t &proto, const uint8_t *dataptr,
+                         const uint16_t nbytes, const uint16_t repeat) {
+  sendGeneric(proto.headermark, proto.headerspace, proto.onemark,
+              proto.onespace, proto.zeromark, proto.zerospace,
+              proto.footermark, proto.gap, dataptr, nbytes, proto.frequency,
+              proto.msbfirst, repeat, proto.dutycycle);
+}
+
+// Enable (or disable) the asynchronous send queue.
+// When enabled, messages can be compiled to a flat pulse train between
+// queueBegin() & queueCommit() without transmitting, parked in a ring, and
+// transmitted later by calling sendQueueLoop() from the main loop. That lets
+// bursts of send requests (e.g. from a network) be accepted instantly instead
+// of serialising through a blocking sender.
+// On the ESP32 the producer side is multi-task safe: any FreeRTOS task can
+// queueBegin()/queueCommit() (or sendQueued()/sendMacro()) & blocks for at
+// most one other task's enqueue, never for a transmission. Transmission
+// stays serialised through whichever single context calls sendQueueLoop().
+//
+// Args:
+//   nr_of_messages: How many compiled messages the ring can hold. 0 disables
+//                   the queue & frees its memory.
+//   max_entries: Capacity, in mark/space entries, of each message buffer.
+//                e.g. 2 entries per bit, plus header & footer. A Daikin2
+//                needs ~700. Simple remotes fit in ~100.
+// Returns:
+//   A boolean indicating success. i.e. false on memory allocation failure.
+bool IRsend::setSendQueue(uint8_t nr_of_messages, uint16_t max_entries) {
+  // Tear down any existing queue first.
+  if (_queue != NULL) {
+    for (uint8_t i = 0; i < _q_size; i++) delete[] _queue[i].buf;
+    delete[] _queue;
+    delete[] _q_capbuf;
+    _queue = NULL;
+    _q_capbuf = NULL;
+    irMemRecordFree(_q_size * sizeof(irsendmsg_t) +
+                    (uint32_t)(_q_size + 1) * _q_maxlen * sizeof(uint16_t));
+#if defined(ESP32) && !defined(UNIT_TEST)
+    vSemaphoreDelete((SemaphoreHandle_t)_q_mutex);
+    _q_mutex = NULL;
+#endif  // ESP32 && !UNIT_TEST
+  }
+  _q_size = 0;
+  _q_head = 0;
+  _q_tail = 0;
+  if (nr_of_messages == 0) return true;  // Just disabling. All done.
+
+  // One extra ring slot, as one is always left unused to tell a full ring
+  // from an empty one.
+  uint8_t slots = nr_of_messages + 1;
+  irsendmsg_t *queue = new irsendmsg_t[slots];
+  if (queue == NULL) return false;
+  bool failed = false;
+  for (uint8_t i = 0; i < slots; i++) {
+    queue[i].buf = new uint16_t[max_entries];
+    queue[i].len = 0;
+    queue[i].freq = 0;
+    queue[i].predelay = 0;
+    queue[i].done = NULL;
+    failed |= (queue[i].buf == NULL);
+  }
+  _q_capbuf = new uint16_t[max_entries];
+  if (failed || _q_capbuf == NULL) {
+    // An allocation failed somewhere. Free the lot & give up.
+    for (uint8_t i = 0; i < slots; i++) delete[] queue[i].buf;
+    delete[] queue;
+    delete[] _q_capbuf;
+    _q_capbuf = NULL;
+    return false;
+  }
+#if defined(ESP32) && !defined(UNIT_TEST)
+  // Enqueues from other FreeRTOS tasks serialise on this. See Q_LOCK().
+  _q_mutex = xSemaphoreCreateRecursiveMutex();
+  if (_q_mutex == NULL) {
+    for (uint8_t i = 0; i < slots; i++) delete[] queue[i].buf;
+    delete[] queue;
+    delete[] _q_capbuf;
+    _q_capbuf = NULL;
+    return false;
+  }
+#endif  // ESP32 && !UNIT_TEST
+  irMemRecordAlloc(slots * sizeof(irsendmsg_t) +
+                   (uint32_t)(slots + 1) * max_entries * sizeof(uint16_t));
+  _queue = queue;
+  _q_maxlen = max_entries;
+  _q_size = slots;
+  return true;
+}
+
+// Start compiling a message instead of transmitting it.
+// Until the matching queueCommit(), any sendXxx()/mark()/space() calls
+// accumulate their timings into a pulse train buffer & return immediately,
+// without touching the IR LED.
+// On the ESP32 this may be called from any FreeRTOS task: it takes the
+// producer lock (released again by queueCommit()), waiting out at most one
+// other task's in-flight enqueue. See Q_LOCK().
+//
+// Returns:
+//   A boolean indicating if compile mode was entered. i.e. false if the
+//   queue isn't enabled, or a message is already being compiled.
+bool IRsend::queueBegin() {
+  if (_queue == NULL) return false;
+  Q_LOCK();
+  if (captureBegin(_q_capbuf, _q_maxlen)) return true;  // Lock stays held.
+  // Already compiling. i.e. An unmatched queueBegin() by this same task.
+  // (The lock is recursive, so another task's compile would have been
+  // waited out above, not observed here.)
+  Q_UNLOCK();
+  return false;
+}
+
+// Finish compiling a message & park it in the send queue ring.
+//
+// Args:
+//   done: Optional callback, invoked (from sendQueueLoop()) once the message
+//         has actually been transmitted. (Default: NULL)
+// Returns:
+//   A boolean indicating if the message was queued. false if nothing was
+//   being compiled, the compiled message didn't fit its buffer, or the ring
+//   is full. In the failure cases the compiled message is discarded.
+bool IRsend::queueCommit(void (*done)(void)) {
+  if (!_capturing) return false;
+  uint16_t len = captureEnd();
+  bool queued = false;
+  // An empty message is only worth queuing if it carries a pre-delay (i.e.
+  // a macro ended with a gap). Then it still waits the gap out & fires the
+  // completion callback at the right time.
+  if (!_capoverflow && (len > 0 || _cap_predelay > 0)) {
+    uint8_t next = _q_head + 1;
+    if (next >= _q_size) next = 0;
+    if (next != _q_tail) {  // i.e. The ring isn't full.
+      irsendmsg_t *msg = &_queue[_q_head];
+      // Trade buffers with the slot rather than copying the pulse train.
+      uint16_t *slotbuf = msg->buf;
+      msg->buf = _q_capbuf;
+      msg->len = len;
+      msg->freq = _capfreq;
+      msg->predelay = _cap_predelay;
+      msg->done = done;
+      _q_capbuf = slotbuf;
+      // Publish last, once the slot is fully filled in: sendQueueLoop()
+      // treats any slot before _q_head as ready to transmit.
+      _q_head = next;
+      queued = true;
+    }
+  }
+  Q_UNLOCK();  // The producer lock taken by queueBegin(). See Q_LOCK().
+  return queued;
+}
+
+// Transmit the oldest queued message, if there is one. Call this regularly
+// from the main loop. Transmission of a given message is still synchronous,
+// but at most one message is sent per call, so the loop stays responsive
+// while a burst of queued messages drains.
+// This must remain the queue's *single* drain context: it is the only
+// writer of _q_tail & takes no lock, which is safe against the (serialised)
+// producers because they only ever move _q_head, & only after their slot
+// is complete.
+//
+// Returns:
+//   The number of messages transmitted by this call. i.e. 0 or 1.
+uint16_t IRsend::sendQueueLoop() {
+  if (_queue == NULL || _q_tail == _q_head) return 0;
+  irsendmsg_t *msg = &_queue[_q_tail];
+  // Does the message require some silence first? (e.g. a macro gap that was
+  // too long to store in the pulse train.) If it hasn't elapsed yet, don't
+  // wait for it. Just try again on a later call.
+  if (msg->predelay && _q_idletimer.elapsed() < msg->predelay) return 0;
+  sendPulseTrain(msg->buf, msg->len, msg->freq);
+  _q_idletimer.reset();  // Gaps are measured from the end of a message.
+  void (*done)(void) = msg->done;
+  uint8_t next = _q_tail + 1;
+  if (next >= _q_size) next = 0;
+  _q_tail = next;  // Release the slot.
+  if (done != NULL) done();
+  return 1;
+}
+
+// Send a macro: a batch of messages with precise gaps between them.
+// The whole batch is pre-compiled into contiguous pulse trains & parked on
+// the send queue (when one is enabled; see setSendQueue()), so a multi-code
+// sequence (e.g. TV on, wait, switch the amp input) completes in minimum
+// wall time with no loop() timing logic. Gaps simply become spaces in the
+// compiled train. Steps that change carrier frequency, or whose gap is too
+// long for a train entry (> 65535 uSecs), transparently split the macro
+// into several queued messages; sendQueueLoop() then waits out the long
+// gaps without blocking.
+//
+// Args:
+//   steps: Array of (protocol, data, nbits, gap) entries to send, in order.
+//   nr_of_steps: Nr. of entries in steps[].
+//   done: Optional callback, invoked once the whole macro has been
+//         transmitted. (Default: NULL)
+// Returns:
+//   A boolean indicating success. false if a protocol couldn't be sent, or
+//   the queue/message buffers couldn't hold the macro. Without a send
+//   queue the macro is transmitted synchronously instead.
+bool IRsend::sendMacro(const irmacrostep_t steps[], uint16_t nr_of_steps,
+                       void (*done)(void)) {
+  bool all_ok = true;
+  bool queued = (_queue != NULL && !_capturing);
+  if (queued) {
+    if (!queueBegin()) return false;
+    _cap_autosplit = true;
+    _cap_commitfail = false;
+  }
+  for (uint16_t i = 0; i < nr_of_steps; i++) {
+    all_ok &= send(steps[i].type, steps[i].data, steps[i].nbits);
+    if (steps[i].gap) space(steps[i].gap);
+  }
+  if (queued) {
+    _cap_autosplit = false;
+    all_ok &= queueCommit(done);
+    all_ok &= !_cap_commitfail;
+  } else if (done != NULL) {
+    done();
+  }
+  return all_ok;
+}
+
+// Send one logical command via the async send queue. (see setSendQueue())
+// The protocol's mandated repeats are compiled & queued rather than
+// transmitted, so the caller gets control back immediately &
+// sendQueueLoop() performs the repeats in the background. That also makes
+// this the right place to honour repeat counts too slow for a blocking
+// send(). e.g. Lego PF's spec'd >= 5 sends (kLegoPfSpecRepeat) with its
+// channel-based inter-repeat gaps. Inter-repeat gaps too long for a pulse
+// train entry (> 65535 uSecs) become pre-delays on split messages & are
+// timed out exactly, one repeat per sendQueueLoop() call. Note: Such a
+// command can need a ring slot per repeat, plus one for a trailing gap.
+// Without a send queue this is just a blocking send().
+//
+// Args:
+//   type:  Protocol number/type of the message you want to send.
+//   data:  The data you want to send (up to 64 bits).
+//   nbits: How many bits long the message is to be.
+//   done: Optional callback, invoked once the command (all of its repeats)
+//         has been transmitted. (Default: NULL)
+// Returns:
+//   bool: True if the command & its repeats were dispatched successfully.
+bool IRsend::sendQueued(const decode_type_t type, const uint64_t data,
+                        const uint16_t nbits, void (*done)(void)) {
+  if (_queue == NULL || _capturing) {  // No queue (or mid-compile already).
+    bool ok = send(type, data, nbits);
+    if (ok && done != NULL) done();
+    return ok;
+  }
+  if (!queueBegin()) return false;
+  _cap_autosplit = true;
+  _cap_commitfail = false;
+  bool all_ok;
+  switch (type) {
+#if SEND_LEGOPF
+    case LEGOPF:
+      // The PF spec mandates >= 5 sends with channel-based spacing. Here
+      // the repeats are merely compiled & their gaps become timed
+      // pre-delays, so honour it. (A blocking send() stays at one frame.)
+      sendLegoPf(data, nbits, kLegoPfSpecRepeat);
+      all_ok = true;
+      break;
+#endif  // SEND_LEGOPF
+    default:
+      all_ok = send(type, data, nbits);
+  }
+  _cap_autosplit = false;
+  all_ok &= queueCommit(done);
+  all_ok &= !_cap_commitfail;
+  return all_ok;
+}
+
+// How long (ms) sendVerified() waits for the paired receiver to report the
+// capture of our own transmission. The receiver only completes a capture
+// once its inter-message timeout (typ. 15ms) has expired, so this needs to
+// comfortably cover that, plus decode time.
+const uint16_t kSendVerifyTimeoutMs = 100;
+
+// Attach a receiver that is physically watching this emitter. (loopback)
+// Once attached, sendVerified() captures each transmission back via that
+// receiver, decodes it & compares it against what was meant to be sent,
+// retransmitting once on a mismatch or a missed capture. i.e. Closed-loop
+// verification, instead of blind extra repeats to paper over a marginal
+// emitter or a busy channel.
+// Note: The receiver should be dedicated to watching the emitter, & have
+// been begin()'d by the caller.
+//
+// Args:
+//   recv: Ptr to the paired IRrecv. NULL detaches it, & sendVerified()
+//         becomes a plain send().
+void IRsend::setVerifyReceiver(IRrecv *recv) { _verify_recv = recv; }
+
+// Wait for the paired receiver to capture the message we just transmitted,
+// then check the decode matches what we intended to send.
+//
+// Args:
+//   type:  Protocol the message was sent as.
+//   data:  The data sent, for simple (<= 64 bit) protocols.
+//   state: The bytes sent, for byte-array (A/C) protocols. NULL == simple.
+//   nbits: Nr. of bits the message was.
+// Returns:
+//   A boolean indicating if the capture matched the intended message.
+bool IRsend::verifyLoopback(const decode_type_t type, const uint64_t data,
+                            const uint8_t *state, const uint16_t nbits) {
+  decode_results results;
+  bool captured = false;
+  // The receiver reports nothing until its inter-message timeout expires,
+  // so poll in 1ms slices. (A counted loop, so the wait is bounded even if
+  // the clock misbehaves.)
+  for (uint16_t waited = 0; waited <= kSendVerifyTimeoutMs; waited++) {
+    if (_verify_recv->decode(&results)) {
+      captured = true;
+      break;
+    }
+    _delayMicroseconds(1000);
+  }
+  bool matched = captured && results.decode_type == type &&
+                 results.bits == nbits;
+  if (matched) {
+    if (state != NULL) {  // A byte-array (A/C) message.
+      for (uint16_t i = 0; i < nbits / 8; i++)
+        matched &= (results.state[i] == state[i]);
+    } else {
+      matched &= (results.value == data);
+    }
+  }
+  _verify_recv->resume();  // Ready the receiver for the next message.
+  return matched;
+}
+
+// Send a simple (up to 64 bits) message & verify it arrived intact via the
+// paired receiver. (see setVerifyReceiver()) A mismatch, or no capture at
+// all, triggers a single targeted retransmit. Without a receiver attached
+// this is just send().
+//
+// Args:
+//   type:  Protocol number/type of the message you want to send.
+//   data:  The data you want to send (up to 64 bits).
+//   nbits: How many bits long the message is to be.
+// Returns:
+//   bool: True if the message was sent & verified. (Or just sent, when no
+//         receiver is attached.)
+bool IRsend::sendVerified(const decode_type_t type, const uint64_t data,
+                          const uint16_t nbits) {
+  if (_verify_recv == NULL) return send(type, data, nbits);
+  for (uint8_t attempt = 0; attempt < 2; attempt++) {
+    if (!send(type, data, nbits)) return false;
+    if (verifyLoopback(type, data, NULL, nbits)) return true;
+  }
+  return false;
+}
+
+// As above, but for complex (i.e. >64 bits / byte-array) messages.
+//
+// Args:
+//   type:   Protocol number/type of the message you want to send.
+//   state:  A pointer to the array of bytes that make up the state[].
+//   nbytes: How many bytes are in the state.
+// Returns:
+//   bool: True if the message was sent & verified. (Or just sent, when no
+//         receiver is attached.)
+bool IRsend::sendVerified(const decode_type_t type, const uint8_t *state,
+                          const uint16_t nbytes) {
+  if (_verify_recv == NULL) return send(type, state, nbytes);
+  for (uint8_t attempt = 0; attempt < 2; attempt++) {
+    if (!send(type, state, nbytes)) return false;
+    if (verifyLoopback(type, 0, state, nbytes * 8)) return true;
+  }
+  return false;
+}
+
+// Start compiling mark()/space() timings into the given buffer instead of
+// transmitting them.
+//
+// Args:
+//   buf:  Where the compiled pulse train accumulates.
+//   maxlen: Capacity (entries) of buf.
+// Returns:
+//   A boolean indicating if compile mode was entered. i.e. false if a
+//   message is already being compiled.
+bool IRsend::captureBegin(uint16_t *buf, uint16_t maxlen) {
+  if (_capturing || buf == NULL) return false;
+  _capbuf = buf;
+  _caplen = 0;
+  _capmaxlen = maxlen;
+  _capfreq = 38000;  // A sane default, if the sender never sets a frequency.
+  _capoverflow = false;
+  _cap_predelay = 0;
+  _capturing = true;
+  return true;
+}
+
+// Stop compiling mark()/space() timings.
+//
+// Returns:
+//   The nr. of entries compiled, or 0 if the message didn't fit the buffer.
+uint16_t IRsend::captureEnd() {
+  _capturing = false;
+  return _capoverflow ? 0 : _caplen;
+}
+
+// Append a duration to the message being compiled, merging it into the
+// previous entry when it is of the same kind, so the buffer always
+// alternates mark, space, mark, ... as sendRaw() style senders expect.
+//
+// Args:
+//   usec: The duration (uSecs) to append.
+//   is_mark: Is the duration a mark (true) or a space (false)?
+void IRsend::captureAppend(uint32_t usec, bool is_mark) {
+  if (usec == 0) return;  // e.g. space(0) is just used to turn the LED off.
+  if (_caplen == 0 && !is_mark) return;  // Drop any leading space.
+  // An odd in-use length means the last entry was a mark.
+  bool last_is_mark = _caplen & 1;
+  if (_caplen && is_mark == last_is_mark) {
+    // Same kind as the previous entry, so just extend it. Saturate rather
+    // than wrap if the combined duration no longer fits in an entry.
+    uint32_t total = _capbuf[_caplen - 1] + usec;
+    _capbuf[_caplen - 1] = (total > UINT16_MAX) ? UINT16_MAX : total;
+  } else if (_caplen < _capmaxlen) {
+    _capbuf[_caplen++] = (usec > UINT16_MAX) ? UINT16_MAX : usec;
+  } else {
+    _capoverflow = true;  // Ran out of buffer. captureEnd() will report it.
+  }
+}
+
+// Transmit an already-compiled pulse train.
+//
+// Args:
+//   buf:  The alternating mark/space durations (uSecs) to send.
+//   len:  Nr. of entries of buf to send.
+//   freq: Carrier frequency (Hz) to send it at.
+void IRsend::sendPulseTrain(uint16_t *buf, uint16_t len, uint32_t freq) {
+  enableIROut(freq);
+  for (uint16_t i = 0; i < len; i++) {
+    if (i & 1)  // Odd entries are spaces.
+      space(buf[i]);
+    else  // Even entries are marks.
+      mark(buf[i]);
+  }
+  ledOff();  // We potentially ended with a mark(), so turn off the LED.
+}
+
+// Enable (or disable) the send cache: pre-compiled pulse trains for the
+// most recently sent (protocol, data) pairs. See sendCached().
+//
+// Args:
+//   nr_of_codes: How many distinct codes to cache. The least recently used
+//                entry is evicted when a new code needs a slot. 0 disables
+//                the cache & frees its memory.
+//   max_entries: Capacity, in mark/space entries, of each cached message.
+//                Codes too big to fit are simply never cached.
+// Returns:
+//   A boolean indicating success. i.e. false on memory allocation failure.
+bool IRsend::setSendCache(uint8_t nr_of_codes, uint16_t max_entries) {
+  // Tear down any existing cache first.
+  if (_cache != NULL) {
+    for (uint8_t i = 0; i < _c_size; i++) delete[] _cache[i].buf;
+    delete[] _cache;
+    _cache = NULL;
+    irMemRecordFree(_c_size * (sizeof(irsendcache_t) +
+                               (uint32_t)_c_maxlen * sizeof(uint16_t)));
+  }
+  _c_size = 0;
+  if (nr_of_codes == 0) return true;  // Just disabling. All done.
+
+  irsendcache_t *cache = new irsendcache_t[nr_of_codes];
+  if (cache == NULL) return false;
+  bool failed = false;
+  for (uint8_t i = 0; i < nr_of_codes; i++) {
+    cache[i].type = UNUSED;  // Mark the entry as empty.
+    cache[i].buf = new uint16_t[max_entries];
+    cache[i].len = 0;
+    cache[i].age = 0;
+    failed |= (cache[i].buf == NULL);
+  }
+  if (failed) {
+    // An allocation failed somewhere. Free the lot & give up.
+    for (uint8_t i = 0; i < nr_of_codes; i++) delete[] cache[i].buf;
+    delete[] cache;
+    return false;
+  }
+  irMemRecordAlloc(nr_of_codes * (sizeof(irsendcache_t) +
+                                  (uint32_t)max_entries * sizeof(uint16_t)));
+  _cache = cache;
+  _c_maxlen = max_entries;
+  _c_size = nr_of_codes;
+  return true;
+}
+
+// Send a simple (up to 64 bits) message of the given type, via the send
+// cache. A repeat send of a recently-sent (type, data, nbits) triple skips
+// all the per-bit protocol computation & carrier setup maths and replays the
+// cached pulse train. A cache miss compiles the message (evicting the least
+// recently used entry), then transmits it.
+// Without setSendCache() having been called, this is just send().
+//
+// Args:
+//   type:  Protocol number/type of the message you want to send.
+//   data:  The data you want to send (up to 64 bits).
+//   nbits: How many bits long the message is to be.
+// Returns:
+//   bool: True if it is a type we can attempt to send, false if not.
+bool IRsend::sendCached(const decode_type_t type, const uint64_t data,
+                        const uint16_t nbits) {
+  // No cache, or we are already compiling something (e.g. for the send
+  // queue)? Just pass it through.
+  if (_cache == NULL || _capturing) return send(type, data, nbits);
+  irsendcache_t *victim = &_cache[0];
+  for (uint8_t i = 0; i < _c_size; i++) {
+    irsendcache_t *entry = &_cache[i];
+    if (entry->type == type && entry->data == data &&
+        entry->nbits == nbits) {  // A hit. Just replay it.
+      entry->age = ++_c_agecounter;
+      sendPulseTrain(entry->buf, entry->len, entry->freq);
+      return true;
+    }
+    // Remember the oldest (or an empty) entry in case we need to evict.
+    if (entry->type == UNUSED ||
+        (victim->type != UNUSED && entry->age < victim->age))
+      victim = entry;
+  }
+  // A miss. Compile the message into the victim entry.
+  captureBegin(victim->buf, _c_maxlen);
+  bool can_send = send(type, data, nbits);
+  uint16_t len = captureEnd();
+  if (!can_send || len == 0) {
+    // Unsendable type, or the message didn't fit the cache buffer.
+    victim->type = UNUSED;
+    if (can_send) return send(type, data, nbits);  // Send it uncached.
+    return false;
+  }
+  victim->type = type;
+  victim->data = data;
+  victim->nbits = nbits;
+  victim->len = len;
+  victim->freq = _capfreq;
+  victim->age = ++_c_agecounter;
+  sendPulseTrain(victim->buf, victim->len, victim->freq);
+  return true;
+}
+
 #if SEND_RAW
 // Send a raw IRremote message.
 //
@@ -489,184 +1783,357 @@ void IRsend::sendRaw(uint16_t buf[], uint16_t len, uint16_t hz) {
   }
   ledOff();  // We potentially have ended with a mark(), so turn of the LED.
 }
-#endif  // SEND_RAW
 
-// Send a simple (up to 64 bits) IR message of a given type.
-// An unknown/unsupported type will do nothing.
+// As sendRaw(), but reads the timings directly from PROGMEM (flash), so
+// large stored code libraries don't need to be copied into RAM to be sent.
+//
 // Args:
-//   type:  Protocol number/type of the message you want to send.
-//   data:  The data you want to send (up to 64 bits).
-//   nbits: How many bits long the message is to be.
-// Returns:
-//   bool: True if it is a type we can attempt to send, false if not.
-bool IRsend::send(decode_type_t type, uint64_t data, uint16_t nbits) {
-  switch (type) {
+//   buf: An array of uint16_t's in PROGMEM that has microseconds elements.
+//   len: Nr. of entries in the buf[] array.
+//   hz:  Frequency of the IR carrier signal. See sendRaw().
+void IRsend::sendRaw_P(const uint16_t buf[], uint16_t len, uint16_t hz) {
+  // Set IR carrier frequency
+  enableIROut(hz);
+  for (uint16_t i = 0; i < len; i++) {
+    if (i & 1) {  // Odd bit.
+      space(pgm_read_word(buf + i));
+    } else {  // Even bit.
+      mark(pgm_read_word(buf + i));
+    }
+  }
+  ledOff();  // We potentially have ended with a mark(), so turn of the LED.
+}
+#endif  // SEND_RAW
+
+// A registry row mapping a protocol to its simple (up to 64 bit) send
+// routine, so IRsend::send() doesn't need a per-protocol switch statement.
+typedef struct {
+  decode_type_t type;  // The protocol.
+  void (IRsend::*send)(uint64_t data, uint16_t nbits, uint16_t repeat);
+  uint16_t repeat;  // Default nr. of repeats for this protocol.
+} simple_send_entry_t;
+
+// Registry of the simple (up to 64 bit) protocols IRsend::send() can
+// dispatch to. One row per protocol, in decode_type_t order. The repeat
+// value matches the default of the matching sendXYZ() routine, as the old
+// switch statement relied on those defaults.
+// Protocols disabled at compile time simply have no row, so their send
+// routines aren't referenced from here and the linker can drop them.
+static const simple_send_entry_t kSimpleSendTable[] = {
+#if SEND_RC5
+    {RC5, &IRsend::sendRC5, kNoRepeat},
+#endif
+#if SEND_RC6
+    {RC6, &IRsend::sendRC6, kNoRepeat},
+#endif
+#if SEND_NEC
+    {NEC, &IRsend::sendNEC, kNoRepeat},
+#endif
+#if SEND_SONY
+    {SONY, &IRsend::sendSony, kSonyMinRepeat},
+#endif
+#if SEND_PANASONIC
+    {PANASONIC, &IRsend::sendPanasonic64, kNoRepeat},
+#endif
+#if SEND_JVC
+    {JVC, &IRsend::sendJVC, kNoRepeat},
+#endif
+#if SEND_SAMSUNG
+    {SAMSUNG, &IRsend::sendSAMSUNG, kNoRepeat},
+#endif
+#if SEND_WHYNTER
+    {WHYNTER, &IRsend::sendWhynter, kNoRepeat},
+#endif
 #if SEND_AIWA_RC_T501
-    case AIWA_RC_T501:
-      sendAiwaRCT501(data, nbits);
-      break;
+    {AIWA_RC_T501, &IRsend::sendAiwaRCT501, kAiwaRcT501MinRepeats},
 #endif
-#if SEND_CARRIER_AC
-    case CARRIER_AC:
-      sendCarrierAC(data, nbits);
-      break;
+#if SEND_LG
+    {LG, &IRsend::sendLG, kNoRepeat},
+#endif
+#if SEND_SANYO
+    {SANYO_LC7461, &IRsend::sendSanyoLC7461, kNoRepeat},
+#endif
+#if SEND_MITSUBISHI
+    {MITSUBISHI, &IRsend::sendMitsubishi, kMitsubishiMinRepeat},
+#endif
+#if SEND_DISH
+    {DISH, &IRsend::sendDISH, kDishMinRepeat},
+#endif
+#if SEND_SHARP
+    {SHARP, &IRsend::sendSharpRaw, kNoRepeat},
 #endif
 #if SEND_COOLIX
-    case COOLIX:
-      sendCOOLIX(data, nbits);
-      break;
+    {COOLIX, &IRsend::sendCOOLIX, kCoolixDefaultRepeat},
 #endif
 #if SEND_DENON
-    case DENON:
-      sendDenon(data, nbits);
-      break;
+    {DENON, &IRsend::sendDenon, kNoRepeat},
 #endif
-#if SEND_DISH
-    case DISH:
-      sendDISH(data, nbits);
-      break;
+#if SEND_SHERWOOD
+    {SHERWOOD, &IRsend::sendSherwood, kSherwoodMinRepeat},
 #endif
-#if SEND_GICABLE
-    case GICABLE:
-      sendGICable(data, nbits);
-      break;
+#if SEND_RCMM
+    {RCMM, &IRsend::sendRCMM, kNoRepeat},
 #endif
 #if SEND_GREE
-    case GREE:
-      sendGree(data, nbits);
-      break;
+    {GREE, &IRsend::sendGree, kGreeDefaultRepeat},
 #endif
-#if SEND_JVC
-    case JVC:
-      sendJVC(data, nbits);
-      break;
+#if SEND_NEC
+    {NEC_LIKE, &IRsend::sendNEC, kNoRepeat},
+#endif
+#if SEND_NIKAI
+    {NIKAI, &IRsend::sendNikai, kNoRepeat},
+#endif
+#if SEND_MIDEA
+    {MIDEA, &IRsend::sendMidea, kMideaMinRepeat},
+#endif
+#if SEND_MAGIQUEST
+    {MAGIQUEST, &IRsend::sendMagiQuest, kNoRepeat},
 #endif
 #if SEND_LASERTAG
-    case LASERTAG:
-      sendLasertag(data, nbits);
-      break;
+    {LASERTAG, &IRsend::sendLasertag, kLasertagMinRepeat},
 #endif
-#if SEND_LEGOPF
-    case LEGOPF:
-      sendLegoPf(data, nbits);
-      break;
+#if SEND_CARRIER_AC
+    {CARRIER_AC, &IRsend::sendCarrierAC, kCarrierAcMinRepeat},
+#endif
+#if SEND_MITSUBISHI2
+    {MITSUBISHI2, &IRsend::sendMitsubishi2, kMitsubishiMinRepeat},
+#endif
+#if SEND_GICABLE
+    {GICABLE, &IRsend::sendGICable, kGicableMinRepeat},
+#endif
+#if SEND_LUTRON
+    {LUTRON, &IRsend::sendLutron, kNoRepeat},
 #endif
 #if SEND_LG
-    case LG:
-      sendLG(data, nbits);
+    {LG2, &IRsend::sendLG2, kNoRepeat},
+#endif
+#if SEND_PIONEER
+    {PIONEER, &IRsend::sendPioneer, kNoRepeat},
+#endif
+#if SEND_VESTEL_AC
+    {VESTEL_AC, &IRsend::sendVestelAc, kNoRepeat},
+#endif
+#if SEND_TECO
+    {TECO, &IRsend::sendTeco, kNoRepeat},
+#endif
+#if SEND_SAMSUNG36
+    {SAMSUNG36, &IRsend::sendSamsung36, kNoRepeat},
+#endif
+#if SEND_LEGOPF
+    // Note: Lego PF's spec'd repeat mode (kLegoPfSpecRepeat) is only
+    // engaged on the async queue path (see sendQueued()), where the
+    // channel-based inter-repeat gaps don't block the caller.
+    {LEGOPF, &IRsend::sendLegoPf, kLegoPfMinRepeat},
+#endif
+};
+
+// Send a simple (up to 64 bits) IR message of a given type.
+// An unknown/unsupported type will do nothing.
+// Args:
+//   type:  Protocol number/type of the message you want to send.
+//   data:  The data you want to send (up to 64 bits).
+//   nbits: How many bits long the message is to be.
+// Returns:
+//   bool: True if it is a type we can attempt to send, false if not.
+bool IRsend::send(decode_type_t type, uint64_t data, uint16_t nbits) {
+  for (uint16_t i = 0;
+       i < sizeof(kSimpleSendTable) / sizeof(kSimpleSendTable[0]); i++) {
+    if (kSimpleSendTable[i].type == type) {
+      (this->*(kSimpleSendTable[i].send))(data, nbits,
+                                          kSimpleSendTable[i].repeat);
+      return true;
+    }
+  }
+  return false;
+}
+
+// Send a complex (i.e. >64 bits / byte-array) IR message of a given type.
+// An unknown/unsupported type will do nothing.
+// Args:
+//   type:   Protocol number/type of the message you want to send.
+//   state:  A pointer to the array of bytes that make up the state[].
+//   nbytes: How many bytes are in the state.
+// Returns:
+//   bool: True if it is a type we can attempt to send, false if not.
+bool IRsend::send(const decode_type_t type, const uint8_t *state,
+                  const uint16_t nbytes) {
+  // Several of the sendXxx() routines predate const-correctness. None of
+  // them modify the buffer, so the cast below is safe.
+  uint8_t *s = const_cast<uint8_t *>(state);
+  (void)s;  // Unused in builds with no state-based protocols enabled.
+  switch (type) {
+#if SEND_ARGO
+    case ARGO:
+      sendArgo(s, nbytes);
       break;
-    case LG2:
-      sendLG2(data, nbits);
+#endif  // SEND_ARGO
+#if SEND_DAIKIN
+    case DAIKIN:
+      sendDaikin(s, nbytes);
       break;
-#endif
-#if SEND_LUTRON
-    case LUTRON:
-      sendLutron(data, nbits);
+#endif  // SEND_DAIKIN
+#if SEND_DAIKIN2
+    case DAIKIN2:
+      sendDaikin2(s, nbytes);
       break;
-#endif
-#if SEND_MAGIQUEST
-    case MAGIQUEST:
-      sendMagiQuest(data, nbits);
+#endif  // SEND_DAIKIN2
+#if SEND_DAIKIN216
+    case DAIKIN216:
+      sendDaikin216(s, nbytes);
       break;
-#endif
-#if SEND_MIDEA
-    case MIDEA:
-      sendMidea(data, nbits);
+#endif  // SEND_DAIKIN216
+#if SEND_ELECTRA_AC
+    case ELECTRA_AC:
+      sendElectraAC(s, nbytes);
       break;
-#endif
-#if SEND_MITSUBISHI
-    case MITSUBISHI:
-      sendMitsubishi(data, nbits);
+#endif  // SEND_ELECTRA_AC
+#if SEND_FUJITSU_AC
+    case FUJITSU_AC:
+      sendFujitsuAC(s, nbytes);
       break;
-#endif
-#if SEND_MITSUBISHI2
-    case MITSUBISHI2:
-      sendMitsubishi2(data, nbits);
+#endif  // SEND_FUJITSU_AC
+#if SEND_GREE
+    case GREE:
+      sendGree(s, nbytes);
       break;
-#endif
-#if SEND_NIKAI
-    case NIKAI:
-      sendNikai(data, nbits);
+#endif  // SEND_GREE
+#if SEND_HAIER_AC
+    case HAIER_AC:
+      sendHaierAC(s, nbytes);
       break;
-#endif
-#if SEND_NEC
-    case NEC:
-    case NEC_LIKE:
-      sendNEC(data, nbits);
+#endif  // SEND_HAIER_AC
+#if SEND_HAIER_AC_YRW02
+    case HAIER_AC_YRW02:
+      sendHaierACYRW02(s, nbytes);
       break;
-#endif
-#if SEND_PANASONIC
-    case PANASONIC:
-      sendPanasonic64(data, nbits);
+#endif  // SEND_HAIER_AC_YRW02
+#if SEND_HITACHI_AC
+    case HITACHI_AC:
+      sendHitachiAC(s, nbytes);
       break;
-#endif
-#if SEND_PIONEER
-    case PIONEER:
-      sendPioneer(data, nbits);
+#endif  // SEND_HITACHI_AC
+#if SEND_HITACHI_AC1
+    case HITACHI_AC1:
+      sendHitachiAC1(s, nbytes);
       break;
-#endif
-#if SEND_RC5
-    case RC5:
-      sendRC5(data, nbits);
+#endif  // SEND_HITACHI_AC1
+#if SEND_HITACHI_AC2
+    case HITACHI_AC2:
+      sendHitachiAC2(s, nbytes);
       break;
-#endif
-#if SEND_RC6
-    case RC6:
-      sendRC6(data, nbits);
+#endif  // SEND_HITACHI_AC2
+#if SEND_KELVINATOR
+    case KELVINATOR:
+      sendKelvinator(s, nbytes);
       break;
-#endif
-#if SEND_RCMM
-    case RCMM:
-      sendRCMM(data, nbits);
+#endif  // SEND_KELVINATOR
+#if SEND_MITSUBISHI_AC
+    case MITSUBISHI_AC:
+      sendMitsubishiAC(s, nbytes);
       break;
-#endif
-#if SEND_SAMSUNG
-    case SAMSUNG:
-      sendSAMSUNG(data, nbits);
+#endif  // SEND_MITSUBISHI_AC
+#if SEND_MITSUBISHIHEAVY
+    case MITSUBISHI_HEAVY_88:
+      sendMitsubishiHeavy88(s, nbytes);
       break;
-#endif
-#if SEND_SAMSUNG36
-    case SAMSUNG36:
-      sendSamsung36(data, nbits);
+    case MITSUBISHI_HEAVY_152:
+      sendMitsubishiHeavy152(s, nbytes);
       break;
-#endif
-#if SEND_SANYO
-    case SANYO_LC7461:
-      sendSanyoLC7461(data, nbits);
+#endif  // SEND_MITSUBISHIHEAVY
+#if SEND_MWM
+    case MWM:
+      sendMWM(s, nbytes);
       break;
-#endif
-#if SEND_SHARP
-    case SHARP:
-      sendSharpRaw(data, nbits);
+#endif  // SEND_MWM
+#if SEND_PANASONIC_AC
+    case PANASONIC_AC:
+      sendPanasonicAC(s, nbytes);
       break;
-#endif
-#if SEND_SHERWOOD
-    case SHERWOOD:
-      sendSherwood(data, nbits);
+#endif  // SEND_PANASONIC_AC
+#if SEND_SAMSUNG_AC
+    case SAMSUNG_AC:
+      sendSamsungAC(s, nbytes);
       break;
-#endif
-#if SEND_SONY
-    case SONY:
-      sendSony(data, nbits);
+#endif  // SEND_SAMSUNG_AC
+#if SEND_SHARP_AC
+    case SHARP_AC:
+      sendSharpAc(s, nbytes);
       break;
-#endif
-#if SEND_TECO
-    case TECO:
-      sendTeco(data, nbits);
+#endif  // SEND_SHARP_AC
+#if SEND_TCL112AC
+    case TCL112AC:
+      sendTcl112Ac(s, nbytes);
       break;
-#endif
-#if SEND_VESTEL_AC
-    case VESTEL_AC:
-      sendVestelAc(data, nbits);
+#endif  // SEND_TCL112AC
+#if SEND_TOSHIBA_AC
+    case TOSHIBA_AC:
+      sendToshibaAC(s, nbytes);
       break;
-#endif
-#if SEND_WHYNTER
-    case WHYNTER:
-      sendWhynter(data, nbits);
+#endif  // SEND_TOSHIBA_AC
+#if SEND_TROTEC
+    case TROTEC:
+      sendTrotec(s, nbytes);
       break;
-#endif
+#endif  // SEND_TROTEC
+#if SEND_WHIRLPOOL_AC
+    case WHIRLPOOL_AC:
+      sendWhirlpoolAC(s, nbytes);
+      break;
+#endif  // SEND_WHIRLPOOL_AC
     default:
       return false;
   }
   return true;
 }
+
+// Replay a decoded capture, whatever its protocol style.
+// i.e. The single dispatch point for a capture-store-replay pipeline:
+// byte-array (A/C) results go via their state[], simple results via their
+// value, so no protocol-specific glue is needed in the caller.
+// Args:
+//   results: The decode_results to replay. (As filled in by IRrecv::decode())
+// Returns:
+//   bool: True if it is a message we can attempt to send, false if not.
+//         (UNKNOWN & raw-only captures can't be replayed this way. Keep
+//         their rawbuf & use sendRaw() for those.)
+bool IRsend::send(const decode_results &results) {
+  const decode_type_t type = (decode_type_t)results.decode_type;
+  if (hasACState(type))
+    return send(type, results.state, results.bits / 8);
+  return send(type, results.value, results.bits);
+}
+
+// Replay a batch of decoded captures, with a gap between the messages.
+// Structured like sendMacro(): if an async send queue is attached (see
+// setSendQueue()) the whole batch is compiled & queued, otherwise it is
+// transmitted (blocking) right away.
+// Args:
+//   results: An array of decode_results to replay, in order.
+//   nr_of_results: Nr. of entries in the results[] array.
+//   gap: Nr. of uSeconds of silence between the messages.
+//   done: Optional. A callback invoked when the batch has been sent.
+// Returns:
+//   bool: True if every message was dispatched successfully.
+bool IRsend::sendBatch(const decode_results results[],
+                       const uint16_t nr_of_results, const uint32_t gap,
+                       void (*done)(void)) {
+  bool all_ok = true;
+  bool queued = (_queue != NULL && !_capturing);
+  if (queued) {
+    if (!queueBegin()) return false;
+    _cap_autosplit = true;
+    _cap_commitfail = false;
+  }
+  for (uint16_t i = 0; i < nr_of_results; i++) {
+    all_ok &= send(results[i]);
+    if (gap && i + 1 < nr_of_results) space(gap);
+  }
+  if (queued) {
+    _cap_autosplit = false;
+    all_ok &= queueCommit(done);
+    all_ok &= !_cap_commitfail;
+  } else if (done != NULL) {
+    done();
+  }
+  return all_ok;
+}
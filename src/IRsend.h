@@ -5,8 +5,10 @@
 #define IRSEND_H_
 
 #define __STDC_LIMIT_MACROS
+#include <stddef.h>
 #include <stdint.h>
 #include "IRremoteESP8266.h"
+#include "IRtimer.h"
 
 // Originally from https://github.com/shirriff/Arduino-IRremote/
 // Updated by markszabo (https://github.com/markszabo/IRremoteESP8266) for
@@ -23,6 +25,17 @@
 // code excution time in producing the software PWM signal.
 // Value was calculated on Wemos D1 mini using v2.4.1 with v2.4.0 ESP core
 const int8_t kPeriodOffset = -5;
+// Validity tag marking a persisted calibrate() result as genuine.
+// See IRsend::calibrationBlob().
+const uint16_t kCalibrationTag = 0xCA1B;
+// Default RTC user memory slot (4-byte block index) the calibration is
+// persisted in. See IRsend::saveCalibration().
+const uint8_t kCalibrationRtcSlot = 0;
+// Default shortest space (in microseconds) considered a protocol-safe
+// point to yield() at during a cooperative send. Inter-frame & inter-section
+// gaps are longer than this; data bit spaces are shorter.
+// See IRsend::setYieldGap().
+const uint32_t kYieldSafeGapMin = 5000;
 const uint8_t kDutyDefault = 50;  // Percentage
 const uint8_t kDutyMax = 100;     // Percentage
 // delayMicroseconds() is only accurate to 16383us.
@@ -72,21 +85,211 @@ namespace stdAc {
   };
 };  // namespace stdAc
 
+// Remote models, for the protocols where several incompatible remote
+// variants share one protocol name. They live here (rather than in each
+// vendor's ir_*.h) so headers like IRac.h can take a model argument without
+// dragging in the vendor's entire header.
+enum fujitsu_ac_remote_model_t {
+  ARRAH2E = 1,
+  ARDB1,
+};
+
+enum panasonic_ac_remote_model_t {
+  kPanasonicUnknown = 0,
+  kPanasonicLke = 1,
+  kPanasonicNke = 2,
+  kPanasonicDke = 3,
+  kPanasonicJke = 4,
+  kPanasonicCkp = 5,
+  kPanasonicRkr = 6,
+};
+
+enum whirlpool_ac_remote_model_t {
+  DG11J13A = 1,  // DG11J1-04 too
+  DG11J191,
+};
+
+#if IRSEND_STATS
+// Transmit timing statistics. See IRsend::getSendStats().
+typedef struct {
+  uint32_t entries;    // Nr. of mark()/space() durations measured.
+  uint64_t requested;  // Total uSecs the senders asked for.
+  uint64_t achieved;   // Total uSecs actually taken to produce them.
+  int32_t min_skew;    // Smallest single (achieved - requested) uSec skew.
+  int32_t max_skew;    // Largest single (achieved - requested) uSec skew.
+} irsend_stats_t;
+#endif  // IRSEND_STATS
+
+// A compiled (ready to transmit) message in the send queue.
+// See IRsend::setSendQueue().
+typedef struct {
+  uint16_t *buf;       // Compiled mark/space durations (uSecs).
+  uint16_t len;        // Nr. of entries of buf in use.
+  uint32_t freq;       // Carrier frequency (Hz) to send it at.
+  uint32_t predelay;   // uSecs of required silence *before* sending it.
+  void (*done)(void);  // Completion callback. May be NULL.
+} irsendmsg_t;
+
+// A protocol's fixed sendGeneric() timing parameters, gathered into one
+// (usually constexpr) descriptor so simple sendXxx() routines pass a single
+// reference instead of marshalling ~13 scalar arguments per call.
+typedef struct {
+  uint16_t headermark;   // Nr. of usecs of mark for the header. 0 == none.
+  uint32_t headerspace;  // Nr. of usecs of space after the header mark.
+  uint16_t onemark;      // Nr. of usecs of mark for a '1' bit.
+  uint32_t onespace;     // Nr. of usecs of space for a '1' bit.
+  uint16_t zeromark;     // Nr. of usecs of mark for a '0' bit.
+  uint32_t zerospace;    // Nr. of usecs of space for a '0' bit.
+  uint16_t footermark;   // Nr. of usecs of mark for the footer. 0 == none.
+  uint32_t gap;          // Nr. of usecs of space between messages.
+  uint16_t frequency;    // Modulation frequency. <1000 means kHz, else Hz.
+  bool msbfirst;         // Bit transmission order. true == MSB->LSB.
+  uint8_t dutycycle;     // Percentage duty cycle of the LED.
+} irtiming_t;
+
+// One step of a macro (multi-message) transmission. See IRsend::sendMacro().
+typedef struct {
+  decode_type_t type;  // Protocol of the message to send.
+  uint64_t data;       // The data you want to send (up to 64 bits).
+  uint16_t nbits;      // How many bits long the message is to be.
+  uint32_t gap;        // uSecs of silence after the message.
+} irmacrostep_t;
+
+// A cached pre-compiled (protocol, data) message. See IRsend::setSendCache().
+typedef struct {
+  decode_type_t type;  // Protocol of the cached message. UNUSED == empty.
+  uint64_t data;       // The message's data bits.
+  uint16_t nbits;      // Nr. of data bits.
+  uint16_t *buf;       // Compiled mark/space durations (uSecs).
+  uint16_t len;        // Nr. of entries of buf in use.
+  uint32_t freq;       // Carrier frequency (Hz) to send it at.
+  uint32_t age;        // Last-use stamp, for LRU eviction.
+} irsendcache_t;
+
 // Classes
+class decode_results;  // Forward ref. (IRrecv.h) Used by the replay API.
+class IRrecv;  // Forward ref. (IRrecv.h) Used by setVerifyReceiver().
+
 class IRsend {
  public:
+#if defined(ESP32)
+  // On the ESP32 the carrier can be generated in hardware by a LEDC PWM
+  // channel, leaving the CPU mostly idle during transmission.
+  explicit IRsend(uint16_t IRsendPin, bool inverted = false,
+                  bool use_modulation = true, int8_t ledc_channel = -1);
+#else  // ESP32
+  // On the ESP8266 the carrier can be produced by a timer1 interrupt,
+  // keeping its period accurate under WiFi interrupt load.
   explicit IRsend(uint16_t IRsendPin, bool inverted = false,
-                  bool use_modulation = true);
+                  bool use_modulation = true, bool use_hw_timer = false,
+                  bool load_calibration = false);
+#endif  // ESP32
+  ~IRsend();
   void begin();
+  void setSecondPin(int16_t pin, bool inverted = false);
+#if IRSEND_STATS
+  irsend_stats_t getSendStats();
+  void resetSendStats();
+#endif  // IRSEND_STATS
   void enableIROut(uint32_t freq, uint8_t duty = kDutyDefault);
   VIRTUAL void _delayMicroseconds(uint32_t usec);
   VIRTUAL uint16_t mark(uint16_t usec);
   VIRTUAL void space(uint32_t usec);
   int8_t calibrate(uint16_t hz = 38000U);
+  void setYieldGap(const uint32_t usecs = kYieldSafeGapMin);
+  uint32_t getYieldGap(void);
+  uint32_t calibrationBlob(void);
+  bool restoreCalibration(const uint32_t blob);
+#if defined(ESP8266) && !defined(UNIT_TEST)
+  bool saveCalibration(const uint8_t rtc_slot = kCalibrationRtcSlot);
+  bool loadCalibration(const uint8_t rtc_slot = kCalibrationRtcSlot);
+#endif  // ESP8266 && !UNIT_TEST
+  bool setSendQueue(uint8_t nr_of_messages, uint16_t max_entries);
+  bool queueBegin();
+  bool queueCommit(void (*done)(void) = NULL);
+  uint16_t sendQueueLoop();
+  bool sendMacro(const irmacrostep_t steps[], uint16_t nr_of_steps,
+                 void (*done)(void) = NULL);
+  bool sendQueued(const decode_type_t type, const uint64_t data,
+                  const uint16_t nbits, void (*done)(void) = NULL);
+  bool setSendCache(uint8_t nr_of_codes, uint16_t max_entries);
+  bool sendCached(const decode_type_t type, const uint64_t data,
+                  const uint16_t nbits);
   void sendRaw(uint16_t buf[], uint16_t len, uint16_t hz);
+  void sendRaw_P(const uint16_t buf[], uint16_t len, uint16_t hz);
   void sendData(uint16_t onemark, uint32_t onespace, uint16_t zeromark,
                 uint32_t zerospace, uint64_t data, uint16_t nbits,
                 bool MSBfirst = true);
+  // As sendData(), but with the bit timings & bit order bound as template
+  // (i.e. compile-time) constants. The generated per-bit loop has no timing
+  // argument loads or MSBfirst test left in it; just the data bit test &
+  // the mark()/space() calls with immediate operands. Use this form where a
+  // protocol's send routine drives sendData() directly from its own
+  // transmit loop. e.g.
+  //   sendData<kCoolixBitMark, kCoolixOneSpace, kCoolixBitMark,
+  //            kCoolixZeroSpace>(segment, 8);
+  template <uint16_t onemark, uint32_t onespace,
+            uint16_t zeromark, uint32_t zerospace, bool MSBfirst = true>
+  void sendData(uint64_t data, uint16_t nbits) {
+    if (nbits == 0)  // If we are asked to send nothing, just return.
+      return;
+    if (MSBfirst) {  // Send the MSB first.
+      // Send 0's until we get down to a bit size we can actually manage.
+      while (nbits > sizeof(data) * 8) {
+        mark(zeromark);
+        space(zerospace);
+        nbits--;
+      }
+      // Work in native 32 bit values whenever the data fits. See sendData().
+      if (nbits <= 32) {
+        uint32_t data32 = (uint32_t)data;
+        for (uint32_t mask = 1UL << (nbits - 1); mask; mask >>= 1) {
+          if (data32 & mask) {  // Send a 1
+            mark(onemark);
+            space(onespace);
+          } else {  // Send a 0
+            mark(zeromark);
+            space(zerospace);
+          }
+        }
+      } else {
+        for (uint64_t mask = 1ULL << (nbits - 1); mask; mask >>= 1) {
+          if (data & mask) {  // Send a 1
+            mark(onemark);
+            space(onespace);
+          } else {  // Send a 0
+            mark(zeromark);
+            space(zerospace);
+          }
+        }
+      }
+    } else {  // Send the Least Significant Bit (LSB) first / MSB last.
+      if (nbits <= 32) {  // Native 32 bit fast path, as above.
+        uint32_t data32 = (uint32_t)data;
+        for (uint16_t bit = 0; bit < nbits; bit++, data32 >>= 1) {
+          if (data32 & 1) {  // Send a 1
+            mark(onemark);
+            space(onespace);
+          } else {  // Send a 0
+            mark(zeromark);
+            space(zerospace);
+          }
+        }
+      } else {
+        for (uint16_t bit = 0; bit < nbits; bit++, data >>= 1) {
+          if (data & 1) {  // Send a 1
+            mark(onemark);
+            space(onespace);
+          } else {  // Send a 0
+            mark(zeromark);
+            space(zerospace);
+          }
+        }
+      }
+    }
+  }
+  void sendByte(uint16_t onemark, uint32_t onespace, uint16_t zeromark,
+                uint32_t zerospace, uint8_t data, bool MSBfirst = true);
   void sendGeneric(const uint16_t headermark, const uint32_t headerspace,
                    const uint16_t onemark, const uint32_t onespace,
                    const uint16_t zeromark, const uint32_t zerospace,
@@ -109,7 +312,22 @@ class IRsend {
                    const uint8_t *dataptr, const uint16_t nbytes,
                    const uint16_t frequency, const bool MSBfirst,
                    const uint16_t repeat, const uint8_t dutycycle);
+  void sendGeneric(const irtiming_t &proto, const uint64_t data,
+                   const uint16_t nbits, const uint16_t repeat);
+  void sendGeneric(const irtiming_t &proto, const uint8_t *dataptr,
+                   const uint16_t nbytes, const uint16_t repeat);
   bool send(decode_type_t type, uint64_t data, uint16_t nbits);
+  bool send(const decode_type_t type, const uint8_t *state,
+            const uint16_t nbytes);
+  bool send(const decode_results &results);
+  bool sendBatch(const decode_results results[], const uint16_t nr_of_results,
+                 const uint32_t gap = kDefaultMessageGap,
+                 void (*done)(void) = NULL);
+  void setVerifyReceiver(IRrecv *recv);
+  bool sendVerified(const decode_type_t type, const uint64_t data,
+                    const uint16_t nbits);
+  bool sendVerified(const decode_type_t type, const uint8_t *state,
+                    const uint16_t nbytes);
 #if (SEND_NEC || SEND_SHERWOOD || SEND_AIWA_RC_T501 || SEND_SANYO)
   void sendNEC(uint64_t data, uint16_t nbits = kNECBits,
                uint16_t repeat = kNoRepeat);
@@ -253,6 +471,8 @@ class IRsend {
 #endif
 #if SEND_GLOBALCACHE
   void sendGC(uint16_t buf[], uint16_t len);
+  void sendGC_P(const uint16_t buf[], uint16_t len);
+  void setGCCache(const bool on = true);
 #endif
 #if SEND_KELVINATOR
   void sendKelvinator(unsigned char data[],
@@ -285,6 +505,7 @@ class IRsend {
 #endif
 #if SEND_PRONTO
   void sendPronto(uint16_t data[], uint16_t len, uint16_t repeat = kNoRepeat);
+  void sendPronto(const char *code, uint16_t repeat = kNoRepeat);
 #endif
 #if SEND_ARGO
   void sendArgo(unsigned char data[], uint16_t nbytes = kArgoStateLength,
@@ -351,7 +572,8 @@ class IRsend {
 #if SEND_WHIRLPOOL_AC
   void sendWhirlpoolAC(unsigned char data[],
                        uint16_t nbytes = kWhirlpoolAcStateLength,
-                       uint16_t repeat = kWhirlpoolAcDefaultRepeat);
+                       uint16_t repeat = kWhirlpoolAcDefaultRepeat,
+                       uint8_t sections = 0b111);
 #endif
 #if SEND_LUTRON
   void sendLutron(uint64_t data, uint16_t nbits = kLutronBits,
@@ -417,9 +639,88 @@ class IRsend {
   uint16_t onTimePeriod;
   uint16_t offTimePeriod;
   uint16_t IRpin;
+  // Optional second emitter pin. See setSecondPin().
+  int16_t _pin2;       // GPIO of the second emitter. -1 == not in use.
+  uint8_t _pin2_on;    // Second pin's level for "LED lit".
+  uint8_t _pin2_off;   // Second pin's level for "LED dark".
+#if defined(ESP32)
+  // Hardware (LEDC) carrier generation state. See enableIROut().
+  int8_t _ledc_channel;  // LEDC channel driving the carrier. -1 == software.
+  uint32_t _ledc_duty;   // LEDC duty value for "carrier on".
+  uint32_t _ledc_off;    // LEDC duty value for "carrier off". i.e. idle.
+#else  // ESP32
+  bool _use_hw_timer;    // Generate the carrier from a timer1 interrupt?
+#if defined(ESP8266)
+  // Direct GPIO register (GPOS/GPOC) masks for ledOn()/ledOff(), computed
+  // once by ledMaskInit() so the two calls per carrier period are single
+  // register writes instead of digitalWrite()'s pin-table lookups.
+  bool _fastpins;       // Are all emitter pins register-writable (GPIO0-15)?
+  uint32_t _on_set;     // GPOS mask for ledOn().
+  uint32_t _on_clear;   // GPOC mask for ledOn().
+  uint32_t _off_set;    // GPOS mask for ledOff().
+  uint32_t _off_clear;  // GPOC mask for ledOff().
+  void ledMaskInit();
+#endif  // ESP8266
+#endif  // ESP32
   int8_t periodOffset;
+  // Spaces at least this long yield() to the scheduler. 0 == never yield.
+  // See setYieldGap().
+  uint32_t _yield_gap;
   uint8_t _dutycycle;
   bool modulation;
+  // Pulse train compiling (capture) state. Used by the send queue & the
+  // send cache. See captureBegin().
+  uint16_t *_capbuf;       // Where the message being compiled accumulates.
+  uint16_t _caplen;        // Nr. of entries of _capbuf in use.
+  uint16_t _capmaxlen;     // Capacity (entries) of _capbuf.
+  uint32_t _capfreq;       // Carrier frequency of the message being compiled.
+  bool _capturing;         // Are mark()/space() compiling instead of sending?
+#if SEND_GLOBALCACHE
+  // Converted-code cache for sendGC(). See setGCCache().
+  bool _gc_cache_on;     // Is the cache enabled?
+  uint16_t *_gc_key;     // The buf[] the cache was converted from.
+  uint16_t _gc_len;      // That buf[]'s length (entries).
+  uint16_t _gc_sum;      // Additive sum of that buf[]'s entries.
+  uint16_t _gc_entries;  // Capacity (entries) of _gc_usecs.
+  uint32_t *_gc_usecs;   // The converted (usec) timings. NULL == empty.
+#endif  // SEND_GLOBALCACHE
+  bool _capoverflow;       // Did the message being compiled NOT fit?
+  // Macro compile state. See sendMacro().
+  uint32_t _cap_predelay;  // Required silence before the compiling message.
+  bool _cap_autosplit;     // Split into several queued messages as needed?
+  bool _cap_commitfail;    // Did an automatic split fail to queue a message?
+  bool captureBegin(uint16_t *buf, uint16_t maxlen);
+  uint16_t captureEnd();
+  void captureAppend(uint32_t usec, bool is_mark);
+  void sendPulseTrain(uint16_t *buf, uint16_t len, uint32_t freq);
+  // Send queue state. See setSendQueue().
+  irsendmsg_t *_queue;     // Ring of compiled messages. NULL == queue off.
+  uint8_t _q_size;         // Nr. of ring slots.
+  // The ring positions are volatile as, on the ESP32, the producer &
+  // consumer ends of the queue can live on different FreeRTOS tasks.
+  volatile uint8_t _q_head;  // Producer (queueCommit()) position.
+  volatile uint8_t _q_tail;  // Consumer (sendQueueLoop()) position.
+  uint16_t _q_maxlen;      // Capacity (entries) of each message buffer.
+  uint16_t *_q_capbuf;     // Spare buffer the next queued message compiles to.
+  IRtimer _q_idletimer;    // Time since the last queued message finished.
+#if defined(ESP32)
+  // Multi-producer enqueue serialisation. Kept as a void* so we don't drag
+  // the FreeRTOS headers into everything that includes this file.
+  void *_q_mutex;  // The recursive SemaphoreHandle_t. NULL == no queue.
+#endif  // ESP32
+  // Loopback verification state. See setVerifyReceiver().
+  IRrecv *_verify_recv;    // The paired receiver. NULL == no verification.
+  bool verifyLoopback(const decode_type_t type, const uint64_t data,
+                      const uint8_t *state, const uint16_t nbits);
+  // Send cache state. See setSendCache().
+  irsendcache_t *_cache;   // The cached messages. NULL == cache off.
+  uint8_t _c_size;         // Nr. of cache entries.
+  uint16_t _c_maxlen;      // Capacity (entries) of each cached message.
+  uint32_t _c_agecounter;  // Monotonic stamp source for LRU eviction.
+#if IRSEND_STATS
+  irsend_stats_t _sendstats;
+  void sendStatsRecord(uint32_t requested, uint32_t achieved);
+#endif  // IRSEND_STATS
   uint32_t calcUSecPeriod(uint32_t hz, bool use_offset = true);
 };
 
@@ -66,5 +66,41 @@ uint32_t TimerMs::elapsed() {
 
 // Only used in unit testing.
 #ifdef UNIT_TEST
-void TimerMs::add(uint32_t msecs) { _IRtimer_unittest_now += msecs; }
+void TimerMs::add(uint32_t msecs) { _TimerMs_unittest_now += msecs; }
 #endif  // UNIT_TEST
+
+// This class measures time in CPU cycles, accumulating 32 bit counter wraps
+// into a 64 bit total. See IRtimer.h for the caveats.
+IRtimerCycles::IRtimerCycles() { reset(); }
+
+// Read the current CPU cycle count.
+uint32_t IRtimerCycles::now() {
+#ifdef UNIT_TEST
+  // Derived from the simulated clock, so IRtimer::add() works here too.
+  // The multiply wraps mod 2^32, which conveniently exercises the same
+  // wrap handling as the real counter.
+  return _IRtimer_unittest_now * kCyclesPerMicro;
+#elif defined(ESP8266) || defined(ESP32)
+  return ESP.getCycleCount();  // i.e. The Xtensa CCOUNT register.
+#else
+  return micros() * kCyclesPerMicro;  // Fallback at micros() resolution.
+#endif
+}
+
+void IRtimerCycles::reset() {
+  _last = now();
+  _total = 0;
+}
+
+// Nr. of CPU cycles since the last reset().
+uint64_t IRtimerCycles::elapsedCycles() {
+  uint32_t current = now();
+  // Unsigned 32 bit subtraction yields the correct delta across (a single)
+  // counter wrap.
+  _total += (uint32_t)(current - _last);
+  _last = current;
+  return _total;
+}
+
+// As elapsedCycles(), but in uSeconds.
+uint64_t IRtimerCycles::elapsed() { return elapsedCycles() / kCyclesPerMicro; }
@@ -15,6 +15,77 @@
 #include "IRrecv.h"
 #include "IRremoteESP8266.h"
 
+// Common text fragments for the human readable output. Stored once, in
+// flash, rather than duplicated in RAM by every file that uses them.
+const char kOnStr[] PROGMEM = "On";
+const char kOffStr[] PROGMEM = "Off";
+const char kAutoStr[] PROGMEM = " (AUTO)";
+const char kCoolStr[] PROGMEM = " (COOL)";
+const char kHeatStr[] PROGMEM = " (HEAT)";
+const char kDryStr[] PROGMEM = " (DRY)";
+const char kFanStr[] PROGMEM = " (FAN)";
+const char kMinStr[] PROGMEM = " (MIN)";
+const char kMaxStr[] PROGMEM = " (MAX)";
+const char kQuietStr[] PROGMEM = " (QUIET)";
+const char kUnknownStr[] PROGMEM = " (UNKNOWN)";
+const char kPowerLabelStr[] PROGMEM = "Power: ";
+const char kModeLabelStr[] PROGMEM = ", Mode: ";
+const char kTempLabelStr[] PROGMEM = ", Temp: ";
+const char kFanLabelStr[] PROGMEM = "C, Fan: ";
+const char kQuietLabelStr[] PROGMEM = ", Quiet: ";
+const char kSwingHLabelStr[] PROGMEM = ", Swing (Horizontal): ";
+const char kSwingVLabelStr[] PROGMEM = ", Swing (Vertical): ";
+
+// Copy a PROGMEM (flash) string out to a RAM buffer.
+// Args:
+//   output: Where to write the string & terminating NUL.
+//   str: A NUL-terminated string stored in flash.
+// Returns:
+//   The number of characters copied. (excluding the NUL)
+static uint16_t copyFromProgmem(char *output, const char *str) {
+  uint16_t length = 0;
+  char c;
+  while ((c = pgm_read_byte(str + length)) != '\0') output[length++] = c;
+  output[length] = '\0';
+  return length;
+}
+
+// kReverseBitsLut[i] is 'i' with its 8 bits in reverse order, letting
+// reverseBits() process a byte per step instead of a bit.
+static const uint8_t kReverseBitsLut[256] PROGMEM = {
+    0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0,
+    0x10, 0x90, 0x50, 0xD0, 0x30, 0xB0, 0x70, 0xF0,
+    0x08, 0x88, 0x48, 0xC8, 0x28, 0xA8, 0x68, 0xE8,
+    0x18, 0x98, 0x58, 0xD8, 0x38, 0xB8, 0x78, 0xF8,
+    0x04, 0x84, 0x44, 0xC4, 0x24, 0xA4, 0x64, 0xE4,
+    0x14, 0x94, 0x54, 0xD4, 0x34, 0xB4, 0x74, 0xF4,
+    0x0C, 0x8C, 0x4C, 0xCC, 0x2C, 0xAC, 0x6C, 0xEC,
+    0x1C, 0x9C, 0x5C, 0xDC, 0x3C, 0xBC, 0x7C, 0xFC,
+    0x02, 0x82, 0x42, 0xC2, 0x22, 0xA2, 0x62, 0xE2,
+    0x12, 0x92, 0x52, 0xD2, 0x32, 0xB2, 0x72, 0xF2,
+    0x0A, 0x8A, 0x4A, 0xCA, 0x2A, 0xAA, 0x6A, 0xEA,
+    0x1A, 0x9A, 0x5A, 0xDA, 0x3A, 0xBA, 0x7A, 0xFA,
+    0x06, 0x86, 0x46, 0xC6, 0x26, 0xA6, 0x66, 0xE6,
+    0x16, 0x96, 0x56, 0xD6, 0x36, 0xB6, 0x76, 0xF6,
+    0x0E, 0x8E, 0x4E, 0xCE, 0x2E, 0xAE, 0x6E, 0xEE,
+    0x1E, 0x9E, 0x5E, 0xDE, 0x3E, 0xBE, 0x7E, 0xFE,
+    0x01, 0x81, 0x41, 0xC1, 0x21, 0xA1, 0x61, 0xE1,
+    0x11, 0x91, 0x51, 0xD1, 0x31, 0xB1, 0x71, 0xF1,
+    0x09, 0x89, 0x49, 0xC9, 0x29, 0xA9, 0x69, 0xE9,
+    0x19, 0x99, 0x59, 0xD9, 0x39, 0xB9, 0x79, 0xF9,
+    0x05, 0x85, 0x45, 0xC5, 0x25, 0xA5, 0x65, 0xE5,
+    0x15, 0x95, 0x55, 0xD5, 0x35, 0xB5, 0x75, 0xF5,
+    0x0D, 0x8D, 0x4D, 0xCD, 0x2D, 0xAD, 0x6D, 0xED,
+    0x1D, 0x9D, 0x5D, 0xDD, 0x3D, 0xBD, 0x7D, 0xFD,
+    0x03, 0x83, 0x43, 0xC3, 0x23, 0xA3, 0x63, 0xE3,
+    0x13, 0x93, 0x53, 0xD3, 0x33, 0xB3, 0x73, 0xF3,
+    0x0B, 0x8B, 0x4B, 0xCB, 0x2B, 0xAB, 0x6B, 0xEB,
+    0x1B, 0x9B, 0x5B, 0xDB, 0x3B, 0xBB, 0x7B, 0xFB,
+    0x07, 0x87, 0x47, 0xC7, 0x27, 0xA7, 0x67, 0xE7,
+    0x17, 0x97, 0x57, 0xD7, 0x37, 0xB7, 0x77, 0xF7,
+    0x0F, 0x8F, 0x4F, 0xCF, 0x2F, 0xAF, 0x6F, 0xEF,
+    0x1F, 0x9F, 0x5F, 0xDF, 0x3F, 0xBF, 0x7F, 0xFF};
+
 // Reverse the order of the requested least significant nr. of bits.
 // Args:
 //   input: Bit pattern/integer to reverse.
@@ -25,49 +96,187 @@ uint64_t reverseBits(uint64_t input, uint16_t nbits) {
   if (nbits <= 1) return input;  // Reversing <= 1 bits makes no change at all.
   // Cap the nr. of bits to rotate to the max nr. of bits in the input.
   nbits = std::min(nbits, (uint16_t)(sizeof(input) * 8));
-  uint64_t output = 0;
-  for (uint16_t i = 0; i < nbits; i++) {
-    output <<= 1;
-    output |= (input & 1);
-    input >>= 1;
+  // Reverse all 64 bits a byte at a time via the lookup table. This is on the
+  // hot path of every LSB-first sendData() call, so 8 table loads beat up to
+  // 64 single bit shifts.
+  uint64_t reversed = 0;
+  uint64_t data = input;
+  for (uint8_t i = 0; i < 8; i++) {
+    reversed = (reversed << 8) |
+               pgm_read_byte(kReverseBitsLut + (uint8_t)data);
+    data >>= 8;
   }
-  // Merge any remaining unreversed bits back to the top of the reversed bits.
-  return (input << nbits) | output;
+  if (nbits >= 64) return reversed;
+  // Slide the requested bits down into place & merge any remaining
+  // unreversed bits back on top of them.
+  return ((input >> nbits) << nbits) | (reversed >> (64 - nbits));
 }
 
-// Convert a uint64_t (unsigned long long) to a string.
+// "00" through "99", so base-10 conversion can emit two digits per division.
+static const char kDigitPairs[] PROGMEM =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// Convert a uint64_t (unsigned long long) to a C-style string.
 // Arduino String/toInt/Serial.print() can't handle printing 64 bit values.
 //
 // Args:
+//   output: Where to write the digits & terminating NUL. Must be able to
+//           hold at least 65 chars. (64 binary digits + NUL)
+//   input:  The value to print
+//   base:   The output base.
+// Returns:
+//   The number of characters written. (excluding the NUL)
+// Note: Based on Arduino's Print::printNumber()
+uint16_t uint64ToStr(char *output, uint64_t input, uint8_t base) {
+  // prevent issues if called with base <= 1
+  if (base < 2) base = 10;
+  // Check we have a base that we can actually print.
+  // i.e. [0-9A-Z] == 36
+  if (base > 36) base = 10;
+
+  uint16_t length = 0;
+  if (base == 10) {
+    // Two digits per division, via the pair lookup table. Dividing by the
+    // constant 100 lets the compiler use a reciprocal multiply, and we drop
+    // to 32 bit arithmetic as soon as the value fits. The ESP8266 has no
+    // hardware 64 bit divide, so every call into __udivdi3 we skip here
+    // saves hundreds of cycles on a hot logging path.
+    while (input > UINT32_MAX) {
+      uint8_t pair = input % 100;
+      input /= 100;
+      output[length++] = pgm_read_byte(kDigitPairs + pair * 2 + 1);
+      output[length++] = pgm_read_byte(kDigitPairs + pair * 2);
+    }
+    uint32_t value = input;
+    while (value >= 100) {
+      uint8_t pair = value % 100;
+      value /= 100;
+      output[length++] = pgm_read_byte(kDigitPairs + pair * 2 + 1);
+      output[length++] = pgm_read_byte(kDigitPairs + pair * 2);
+    }
+    // One or two digits remain. (Least significant one first.)
+    output[length++] = pgm_read_byte(kDigitPairs + value * 2 + 1);
+    if (value >= 10) output[length++] = pgm_read_byte(kDigitPairs + value * 2);
+  } else if ((base & (base - 1)) == 0) {
+    // Powers of two (2, 4, 8, 16, 32) need no division at all.
+    uint8_t shift = 0;
+    for (uint8_t b = base; b > 1; b >>= 1) shift++;
+    do {
+      char c = input & (base - 1);
+      input >>= shift;
+      output[length++] = (c < 10) ? c + '0' : c + 'A' - 10;
+    } while (input);
+  } else {
+    do {
+      char c = input % base;
+      input /= base;
+
+      if (c < 10)
+        c += '0';
+      else
+        c += 'A' - 10;
+      output[length++] = c;
+    } while (input);
+  }
+  // The digits were generated least significant first. Reverse in place.
+  for (uint16_t i = 0; i < length / 2; i++)
+    std::swap(output[i], output[length - 1 - i]);
+  output[length] = '\0';
+  return length;
+}
+
+// Convert a uint64_t (unsigned long long) to a string.
+//
+// Args:
 //   input: The value to print
 //   base:  The output base.
 // Returns:
 //   A string representation of the integer.
-// Note: Based on Arduino's Print::printNumber()
 #ifdef ARDUINO  // Arduino's & C++'s string implementations can't co-exist.
 String uint64ToString(uint64_t input, uint8_t base) {
-  String result = "";
 #else
 std::string uint64ToString(uint64_t input, uint8_t base) {
-  std::string result = "";
 #endif
-  // prevent issues if called with base <= 1
-  if (base < 2) base = 10;
-  // Check we have a base that we can actually print.
-  // i.e. [0-9A-Z] == 36
-  if (base > 36) base = 10;
+  char buffer[65];  // Max of 64 binary digits + NUL.
+  uint64ToStr(buffer, input, base);
+  // A single conversion, rather than an allocation per digit.
+  return buffer;
+}
 
-  do {
-    char c = input % base;
-    input /= base;
+// IRStringBuf: Build human readable output in a fixed buffer. (No heap use)
+//
+// Args:
+//   buffer: Where to accumulate the output. Always kept NUL-terminated.
+//   size: Nr. of chars the buffer can hold. (including the NUL)
+IRStringBuf::IRStringBuf(char *buffer, const uint16_t size) {
+  _buffer = buffer;
+  _size = size;
+  _length = 0;
+  _overflow = false;
+  if (_size) _buffer[0] = '\0';
+}
 
-    if (c < 10)
-      c += '0';
-    else
-      c += 'A' - 10;
-    result = c + result;
-  } while (input);
-  return result;
+// Append a C-style string, truncating if it doesn't fit.
+void IRStringBuf::add(const char *str) {
+  while (*str) {
+    if (_length + 1 >= _size) {  // Keep a char spare for the NUL.
+      _overflow = true;
+      break;  // Partial chars are already in; fall through to the NUL.
+    }
+    _buffer[_length++] = *str++;
+  }
+  _buffer[_length] = '\0';
+}
+
+// Append a single character.
+void IRStringBuf::add(const char c) {
+  if (_length + 1 >= _size) {
+    _overflow = true;
+    return;
+  }
+  _buffer[_length++] = c;
+  _buffer[_length] = '\0';
+}
+
+// Append a string stored in flash (PROGMEM), truncating if it doesn't fit.
+void IRStringBuf::add_P(const char *str) {
+  char c;
+  while ((c = pgm_read_byte(str++)) != '\0') {
+    if (_length + 1 >= _size) {  // Keep a char spare for the NUL.
+      _overflow = true;
+      break;  // Partial chars are already in; fall through to the NUL.
+    }
+    _buffer[_length++] = c;
+  }
+  _buffer[_length] = '\0';
+}
+
+// Append an unsigned integer in the given base.
+void IRStringBuf::addUint(const uint64_t value, const uint8_t base) {
+  char buffer[65];  // Max of 64 binary digits + NUL.
+  uint64ToStr(buffer, value, base);
+  add(buffer);
+}
+
+// Append "On" or "Off". The most common case in the A/C toString()s.
+void IRStringBuf::addBool(const bool value) {
+  add_P(value ? kOnStr : kOffStr);
+}
+
+// Empty the buffer so it can be reused. e.g. After flushing it to an output.
+void IRStringBuf::reset(void) {
+  _length = 0;
+  _overflow = false;
+  if (_size) _buffer[0] = '\0';
 }
 
 #ifdef ARDUINO
@@ -221,6 +430,35 @@ decode_type_t strToDecodeType(const char *str) {
     return decode_type_t::UNKNOWN;
 }
 
+#if IRMEM_STATS
+// Current & peak nr. of heap bytes owned by the library's allocations.
+// Shared across all IRrecv/IRsend instances. Peak is never reset implicitly,
+// so it survives buffers being freed. See IRMEM_STATS in IRremoteESP8266.h.
+static uint32_t _irmem_current = 0;
+static uint32_t _irmem_peak = 0;
+
+// Record `bytes` of heap having been successfully allocated by the library.
+void irMemRecordAlloc(const uint32_t bytes) {
+  _irmem_current += bytes;
+  if (_irmem_current > _irmem_peak) _irmem_peak = _irmem_current;
+}
+
+// Record `bytes` of the library's heap having been freed.
+void irMemRecordFree(const uint32_t bytes) {
+  // Clamp rather than wrap if the books are ever unbalanced.
+  _irmem_current = (bytes > _irmem_current) ? 0 : _irmem_current - bytes;
+}
+
+// Nr. of heap bytes the library's allocations are using right now.
+uint32_t irMemCurrent(void) { return _irmem_current; }
+
+// The most heap bytes the library's allocations have ever used.
+uint32_t irMemPeak(void) { return _irmem_peak; }
+
+// Restart the peak tracking from the current usage.
+void irMemResetPeak(void) { _irmem_peak = _irmem_current; }
+#endif  // IRMEM_STATS
+
 // Escape any special HTML (unsafe) characters in a string. e.g. anti-XSS.
 // Args:
 //   unescaped: A string containing text to make HTML safe.
@@ -288,6 +526,98 @@ std::string htmlEscape(const std::string unescaped) {
   return result;
 }
 
+// Convert a protocol type (enum etc) to a human readable C-style string.
+// Args:
+//   output:   Where to write the name & terminating NUL. Must be able to
+//             hold at least 32 chars. (Longest name + " (Repeat)" + NUL)
+//   protocol: Nr. (enum) of the protocol.
+//   isRepeat: A flag indicating if it is a repeat message of the protocol.
+// Returns:
+//   The number of characters written. (excluding the NUL)
+// All the protocol names, in decode_type_t order, NUL separated & stored
+// in flash. A linear scan of this blob is plenty fast for logging code &
+// it avoids both a RAM copy of every name & a pointer table in flash.
+static const char kProtocolNamesStr[] PROGMEM =
+    "UNUSED\0"
+    "RC5\0"
+    "RC6\0"
+    "NEC\0"
+    "SONY\0"
+    "PANASONIC\0"
+    "JVC\0"
+    "SAMSUNG\0"
+    "WHYNTER\0"
+    "AIWA_RC_T501\0"
+    "LG\0"
+    "SANYO\0"
+    "MITSUBISHI\0"
+    "DISH\0"
+    "SHARP\0"
+    "COOLIX\0"
+    "DAIKIN\0"
+    "DENON\0"
+    "KELVINATOR\0"
+    "SHERWOOD\0"
+    "MITSUBISHI_AC\0"
+    "RCMM\0"
+    "SANYO_LC7461\0"
+    "RC5X\0"
+    "GREE\0"
+    "PRONTO\0"
+    "NEC (non-strict)\0"
+    "ARGO\0"
+    "TROTEC\0"
+    "NIKAI\0"
+    "RAW\0"
+    "GLOBALCACHE\0"
+    "TOSHIBA_AC\0"
+    "FUJITSU_AC\0"
+    "MIDEA\0"
+    "MAGIQUEST\0"
+    "LASERTAG\0"
+    "CARRIER_AC\0"
+    "HAIER_AC\0"
+    "MITSUBISHI2\0"
+    "HITACHI_AC\0"
+    "HITACHI_AC1\0"
+    "HITACHI_AC2\0"
+    "GICABLE\0"
+    "HAIER_AC_YRW02\0"
+    "WHIRLPOOL_AC\0"
+    "SAMSUNG_AC\0"
+    "LUTRON\0"
+    "ELECTRA_AC\0"
+    "PANASONIC_AC\0"
+    "PIONEER\0"
+    "LG2\0"
+    "MWM\0"
+    "DAIKIN2\0"
+    "VESTEL_AC\0"
+    "TECO\0"
+    "SAMSUNG36\0"
+    "TCL112AC\0"
+    "LEGOPF\0"
+    "MITSUBISHI_HEAVY_88\0"
+    "MITSUBISHI_HEAVY_152\0"
+    "DAIKIN216\0"
+    "SHARP_AC\0";
+static const char kUnknownProtocolStr[] PROGMEM = "UNKNOWN";
+static const char kRepeatSuffixStr[] PROGMEM = " (Repeat)";
+
+uint16_t typeToStr(char *output, const decode_type_t protocol,
+                   const bool isRepeat) {
+  const char *name = kUnknownProtocolStr;
+  if (protocol >= UNUSED && protocol <= kLastDecodeType) {
+    name = kProtocolNamesStr;
+    // Skip over the names of the protocols before the requested one.
+    for (uint16_t i = protocol; i; i--)
+      while (pgm_read_byte(name++)) {}
+  }
+  uint16_t length = copyFromProgmem(output, name);
+  if (isRepeat) length += copyFromProgmem(output + length, kRepeatSuffixStr);
+  return length;
+}
+
 // Convert a protocol type (enum etc) to a human readable string.
 // Args:
 //   protocol: Nr. (enum) of the protocol.
@@ -296,213 +626,18 @@ std::string htmlEscape(const std::string unescaped) {
 //   A string containing the protocol name.
 #ifdef ARDUINO  // Arduino's & C++'s string implementations can't co-exist.
 String typeToString(const decode_type_t protocol, const bool isRepeat) {
-  String result = "";
 #else
 std::string typeToString(const decode_type_t protocol, const bool isRepeat) {
-  std::string result = "";
 #endif
-  switch (protocol) {
-    case UNUSED:
-      result = F("UNUSED");
-      break;
-    case AIWA_RC_T501:
-      result = F("AIWA_RC_T501");
-      break;
-    case ARGO:
-      result = F("ARGO");
-      break;
-    case CARRIER_AC:
-      result = F("CARRIER_AC");
-      break;
-    case COOLIX:
-      result = F("COOLIX");
-      break;
-    case DAIKIN:
-      result = F("DAIKIN");
-      break;
-    case DAIKIN2:
-      result = F("DAIKIN2");
-      break;
-    case DAIKIN216:
-      result = F("DAIKIN216");
-      break;
-    case DENON:
-      result = F("DENON");
-      break;
-    case DISH:
-      result = F("DISH");
-      break;
-    case ELECTRA_AC:
-      result = F("ELECTRA_AC");
-      break;
-    case FUJITSU_AC:
-      result = F("FUJITSU_AC");
-      break;
-    case GICABLE:
-      result = F("GICABLE");
-      break;
-    case GLOBALCACHE:
-      result = F("GLOBALCACHE");
-      break;
-    case GREE:
-      result = F("GREE");
-      break;
-    case HAIER_AC:
-      result = F("HAIER_AC");
-      break;
-    case HAIER_AC_YRW02:
-      result = F("HAIER_AC_YRW02");
-      break;
-    case HITACHI_AC:
-      result = F("HITACHI_AC");
-      break;
-    case HITACHI_AC1:
-      result = F("HITACHI_AC1");
-      break;
-    case HITACHI_AC2:
-      result = F("HITACHI_AC2");
-      break;
-    case JVC:
-      result = F("JVC");
-      break;
-    case KELVINATOR:
-      result = F("KELVINATOR");
-      break;
-    case LEGOPF:
-      result = F("LEGOPF");
-      break;
-    case LG:
-      result = F("LG");
-      break;
-    case LG2:
-      result = F("LG2");
-      break;
-    case LASERTAG:
-      result = F("LASERTAG");
-      break;
-    case LUTRON:
-      result = F("LUTRON");
-      break;
-    case MAGIQUEST:
-      result = F("MAGIQUEST");
-      break;
-    case MIDEA:
-      result = F("MIDEA");
-      break;
-    case MITSUBISHI:
-      result = F("MITSUBISHI");
-      break;
-    case MITSUBISHI2:
-      result = F("MITSUBISHI2");
-      break;
-    case MITSUBISHI_AC:
-      result = F("MITSUBISHI_AC");
-      break;
-    case MITSUBISHI_HEAVY_88:
-      result = F("MITSUBISHI_HEAVY_88");
-      break;
-    case MITSUBISHI_HEAVY_152:
-      result = F("MITSUBISHI_HEAVY_152");
-      break;
-    case MWM:
-      result = F("MWM");
-      break;
-    case NEC:
-      result = F("NEC");
-      break;
-    case NEC_LIKE:
-      result = F("NEC (non-strict)");
-      break;
-    case NIKAI:
-      result = F("NIKAI");
-      break;
-    case PANASONIC:
-      result = F("PANASONIC");
-      break;
-    case PANASONIC_AC:
-      result = F("PANASONIC_AC");
-      break;
-    case PIONEER:
-      result = F("PIONEER");
-      break;
-    case PRONTO:
-      result = F("PRONTO");
-      break;
-    case RAW:
-      result = F("RAW");
-      break;
-    case RC5:
-      result = F("RC5");
-      break;
-    case RC5X:
-      result = F("RC5X");
-      break;
-    case RC6:
-      result = F("RC6");
-      break;
-    case RCMM:
-      result = F("RCMM");
-      break;
-    case SAMSUNG:
-      result = F("SAMSUNG");
-      break;
-    case SAMSUNG36:
-      result = F("SAMSUNG36");
-      break;
-    case SAMSUNG_AC:
-      result = F("SAMSUNG_AC");
-      break;
-    case SANYO:
-      result = F("SANYO");
-      break;
-    case SANYO_LC7461:
-      result = F("SANYO_LC7461");
-      break;
-    case SHARP:
-      result = F("SHARP");
-      break;
-    case SHARP_AC:
-      result = F("SHARP_AC");
-      break;
-    case SHERWOOD:
-      result = F("SHERWOOD");
-      break;
-    case SONY:
-      result = F("SONY");
-      break;
-    case TCL112AC:
-      result = F("TCL112AC");
-      break;
-    case TECO:
-      result = F("TECO");
-      break;
-    case TOSHIBA_AC:
-      result = F("TOSHIBA_AC");
-      break;
-    case TROTEC:
-      result = F("TROTEC");
-      break;
-    case VESTEL_AC:
-      result = F("VESTEL_AC");
-      break;
-    case WHIRLPOOL_AC:
-      result = F("WHIRLPOOL_AC");
-      break;
-    case WHYNTER:
-      result = F("WHYNTER");
-      break;
-    case UNKNOWN:
-    default:
-      result = F("UNKNOWN");
-      break;
-  }
-  if (isRepeat) result += F(" (Repeat)");
-  return result;
+  char buffer[32];
+  typeToStr(buffer, protocol, isRepeat);
+  return buffer;
 }
 
 // Does the given protocol use a complex state as part of the decode?
 bool hasACState(const decode_type_t protocol) {
   switch (protocol) {
+    case ARGO:
     case DAIKIN:
     case DAIKIN2:
     case DAIKIN216:
@@ -524,6 +659,7 @@ bool hasACState(const decode_type_t protocol) {
     case SHARP_AC:
     case TCL112AC:
     case TOSHIBA_AC:
+    case TROTEC:
     case WHIRLPOOL_AC:
       return true;
     default:
@@ -661,6 +797,146 @@ std::string resultToTimingInfo(const decode_results *results) {
   return output;
 }
 
+// Push the current contents of an IRStringBuf to the output target & empty
+// the buffer for re-use.
+#ifdef ARDUINO
+static void flushBuffer(Print *out, IRStringBuf *buf) {
+  out->print(buf->c_str());
+#else
+static void flushBuffer(std::ostream *out, IRStringBuf *buf) {
+  *out << buf->c_str();
+#endif
+  buf->reset();
+}
+
+// As resultToSourceCode(), but streams the text straight to `out` (e.g.
+// &Serial) chunk by chunk via a small stack buffer. Memory use is constant
+// & tiny regardless of capture size, so even a several hundred entry A/C
+// rawbuf can be dumped on a fragmented heap where building the whole
+// multi-KB String version would fail to allocate.
+// Args:
+//   out: Where to write the text.
+//   results: A ptr to a decode_results structure.
+#ifdef ARDUINO
+void resultToSourceCode(Print *out, const decode_results *results) {
+#else
+void resultToSourceCode(std::ostream *out, const decode_results *results) {
+#endif
+  char stack[64];
+  IRStringBuf buf(stack, sizeof(stack));
+  // Start declaration
+  buf.add_P(PSTR("uint16_t rawData["));  // variable type & array name
+  buf.addUint(getCorrectedRawLength(results));  // array size
+  buf.add_P(PSTR("] = {"));  // Start declaration
+  flushBuffer(out, &buf);
+
+  // Dump data. One rawbuf entry per chunk keeps the buffer small.
+  for (uint16_t i = 1; i < results->rawlen; i++) {
+    uint32_t usecs;
+    for (usecs = results->rawbuf[i] * kRawTick; usecs > UINT16_MAX;
+         usecs -= UINT16_MAX) {
+      buf.addUint(UINT16_MAX);
+      buf.add_P((i % 2) ? PSTR(", 0,  ") : PSTR(",  0, "));
+    }
+    buf.addUint(usecs);
+    if (i < results->rawlen - 1)
+      buf.add_P(PSTR(", "));        // ',' not needed on the last one
+    if (i % 2 == 0) buf.add(' ');   // Extra if it was even.
+    flushBuffer(out, &buf);
+  }
+
+  // End declaration & comment.
+  buf.add_P(PSTR("};  // "));
+  flushBuffer(out, &buf);
+  char protocol[32];  // Matches typeToString()'s buffer size.
+  typeToStr(protocol, results->decode_type, results->repeat);
+  buf.add(protocol);
+  // Only display the value if the decode type doesn't have an A/C state.
+  if (!hasACState(results->decode_type)) {
+    buf.add(' ');
+    buf.addUint(results->value, 16);
+  }
+  buf.add('\n');
+  flushBuffer(out, &buf);
+
+  // Now dump "known" codes
+  if (results->decode_type != UNKNOWN) {
+    if (hasACState(results->decode_type)) {
+#if DECODE_AC
+      uint16_t nbytes = results->bits / 8;
+      buf.add_P(PSTR("uint8_t state["));
+      buf.addUint(nbytes);
+      buf.add_P(PSTR("] = {"));
+      flushBuffer(out, &buf);
+      for (uint16_t i = 0; i < nbytes; i++) {
+        buf.add_P(PSTR("0x"));
+        if (results->state[i] < 0x10) buf.add('0');  // Zero pad
+        buf.addUint(results->state[i], 16);
+        if (i < nbytes - 1) buf.add_P(PSTR(", "));
+        flushBuffer(out, &buf);
+      }
+      buf.add_P(PSTR("};\n"));
+#endif  // DECODE_AC
+    } else {
+      // Simple protocols
+      // Some protocols have an address &/or command.
+      // NOTE: It will ignore the atypical case when a message has been
+      // decoded but the address & the command are both 0.
+      if (results->address > 0 || results->command > 0) {
+        buf.add_P(PSTR("uint32_t address = 0x"));
+        buf.addUint(results->address, 16);
+        buf.add_P(PSTR(";\n"));
+        flushBuffer(out, &buf);
+        buf.add_P(PSTR("uint32_t command = 0x"));
+        buf.addUint(results->command, 16);
+        buf.add_P(PSTR(";\n"));
+        flushBuffer(out, &buf);
+      }
+      // Most protocols have data
+      buf.add_P(PSTR("uint64_t data = 0x"));
+      buf.addUint(results->value, 16);
+      buf.add_P(PSTR(";\n"));
+    }
+  }
+  flushBuffer(out, &buf);
+}
+
+// As resultToTimingInfo(), but streams the text straight to `out` (e.g.
+// &Serial) chunk by chunk. See resultToSourceCode(Print *, ...) above.
+// Args:
+//   out: Where to write the text.
+//   results: A ptr to a decode_results structure.
+#ifdef ARDUINO
+void resultToTimingInfo(Print *out, const decode_results *results) {
+#else
+void resultToTimingInfo(std::ostream *out, const decode_results *results) {
+#endif
+  char stack[32];
+  IRStringBuf buf(stack, sizeof(stack));
+  buf.add_P(PSTR("Raw Timing["));
+  buf.addUint(results->rawlen - 1);
+  buf.add_P(PSTR("]:\n"));
+  flushBuffer(out, &buf);
+
+  for (uint16_t i = 1; i < results->rawlen; i++) {
+    if (i % 2 == 0)
+      buf.add('-');  // even
+    else
+      buf.add_P(PSTR("   +"));  // odd
+    char value[21];  // Max of 20 decimal digits + NUL.
+    uint16_t len = uint64ToStr(value, results->rawbuf[i] * kRawTick);
+    // Space pad the value till it is at least 6 chars long.
+    for (; len < 6; len++) buf.add(' ');
+    buf.add(value);
+    if (i < results->rawlen - 1)
+      buf.add_P(PSTR(", "));  // ',' not needed for last one
+    if (!(i % 8)) buf.add('\n');  // Newline every 8 entries.
+    flushBuffer(out, &buf);
+  }
+  buf.add('\n');
+  flushBuffer(out, &buf);
+}
+
 // Convert the decode_results structure's value/state to simple hexadecimal.
 //
 #ifdef ARDUINO
@@ -706,20 +982,58 @@ std::string resultToHumanReadableBasic(const decode_results *results) {
   return output;
 }
 
-uint8_t sumBytes(uint8_t *start, const uint16_t length, const uint8_t init) {
-  uint8_t checksum = init;
-  uint8_t *ptr;
-  for (ptr = start; ptr - start < length; ptr++) checksum += *ptr;
-  return checksum;
+uint8_t sumBytes(const uint8_t *start, const uint16_t length,
+                 const uint8_t init) {
+  // Accumulate in a wider type & fold at the end, with the loop unrolled
+  // four bytes per iteration. This one tuned loop serves every protocol's
+  // byte-sum checksum, instead of each ir_*.cpp rolling its own.
+  uint32_t checksum = init;
+  const uint8_t *ptr = start;
+  uint16_t left = length;
+  for (; left >= 4; left -= 4, ptr += 4)
+    checksum += (uint32_t)ptr[0] + ptr[1] + ptr[2] + ptr[3];
+  for (; left; left--, ptr++) checksum += *ptr;
+  return (uint8_t)checksum;
 }
 
-uint8_t xorBytes(uint8_t *start, const uint16_t length, const uint8_t init) {
+uint8_t xorBytes(const uint8_t *start, const uint16_t length,
+                 const uint8_t init) {
   uint8_t checksum = init;
-  uint8_t *ptr;
-  for (ptr = start; ptr - start < length; ptr++) checksum ^= *ptr;
+  const uint8_t *ptr = start;
+  uint16_t left = length;
+  // Unrolled four bytes per iteration, as per sumBytes() above.
+  for (; left >= 4; left -= 4, ptr += 4)
+    checksum ^= ptr[0] ^ ptr[1] ^ ptr[2] ^ ptr[3];
+  for (; left; left--, ptr++) checksum ^= *ptr;
   return checksum;
 }
 
+// Sum the nibbles of an integer, starting from the least significant one.
+// Args:
+//   data: The value to sum the nibbles of.
+//   count: Nr. of nibbles to sum. Max of 16. (i.e. All of them)
+//   init: Start the sum with this value.
+// Returns:
+//   The 8 bit sum of the requested nibbles.
+uint8_t sumNibbles(const uint64_t data, const uint8_t count,
+                   const uint8_t init) {
+  uint8_t sum = init;
+  uint64_t remainder = data;
+  for (uint8_t i = 0; i < count && remainder; i++, remainder >>= 4)
+    sum += remainder & 0xF;
+  return sum;
+}
+
+// Count the set bits in a 64 bit value with the parallel (SWAR) idiom.
+// A handful of operations, rather than one loop iteration per bit.
+static uint16_t popCount64(uint64_t value) {
+  value = value - ((value >> 1) & 0x5555555555555555ULL);
+  value = (value & 0x3333333333333333ULL) +
+          ((value >> 2) & 0x3333333333333333ULL);
+  value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (value * 0x0101010101010101ULL) >> 56;
+}
+
 // Count the number of bits of a certain type.
 // Args:
 //   start: Ptr to the start of data to count bits in.
@@ -731,11 +1045,16 @@ uint8_t xorBytes(uint8_t *start, const uint16_t length, const uint8_t init) {
 uint16_t countBits(const uint8_t *start, const uint16_t length, const bool ones,
                    const uint16_t init) {
   uint16_t count = init;
-  for (uint16_t offset = 0; offset < length; offset++)
-    for (uint8_t currentbyte = *(start + offset);
-         currentbyte;
-         currentbyte >>= 1)
-      if (currentbyte & 1) count++;
+  uint16_t offset = 0;
+  while (offset < length) {
+    // Pack up to 8 bytes into one value, so they are counted in a single
+    // popCount64() pass. Assembled a byte at a time as `start` may not be
+    // suitably aligned for wider loads.
+    uint64_t chunk = 0;
+    for (uint8_t i = 0; i < 8 && offset < length; i++, offset++)
+      chunk |= (uint64_t)start[offset] << (8 * i);
+    count += popCount64(chunk);
+  }
   if (ones || length == 0)
     return count;
   else
@@ -752,11 +1071,10 @@ uint16_t countBits(const uint8_t *start, const uint16_t length, const bool ones,
 //   Nr. of bits found.
 uint16_t countBits(const uint64_t data, const uint8_t length, const bool ones,
                    const uint16_t init) {
-  uint16_t count = init;
-  uint8_t bitsSoFar = length;
-  for (uint64_t remainder = data; remainder && bitsSoFar;
-       remainder >>= 1, bitsSoFar--)
-      if (remainder & 1) count++;
+  uint64_t masked = data;
+  // Only count the requested least significant bits.
+  if (length < 64) masked &= (1ULL << length) - 1;
+  uint16_t count = init + popCount64(masked);
   if (ones || length == 0)
     return count;
   else
@@ -772,3 +1090,166 @@ uint64_t invertBits(const uint64_t data, const uint16_t nbits) {
   // Mask off any unwanted bits and return the result.
   return (result & ((1ULL << nbits) - 1));
 }
+
+// Binary result codec --------------------------------------------------
+
+// Store `nbytes` of `value` into `buffer` in little-endian byte order.
+// Byte-by-byte so it works regardless of host endianness or alignment.
+static void writeLittleEndian(uint8_t *buffer, uint64_t value,
+                              const uint8_t nbytes) {
+  for (uint8_t i = 0; i < nbytes; i++, value >>= 8) buffer[i] = value & 0xFF;
+}
+
+// Read `nbytes` of little-endian data from `buffer`.
+static uint64_t readLittleEndian(const uint8_t *buffer, const uint8_t nbytes) {
+  uint64_t value = 0;
+  for (uint8_t i = nbytes; i;) value = (value << 8) | buffer[--i];
+  return value;
+}
+
+// Serialise the key values of a decode result into a compact, versioned,
+// little-endian binary form. Suitable for shipping off-device. (e.g. MQTT)
+// A typical A/C message fits in ~40 bytes vs several hundred for the
+// human readable text formats.
+// Args:
+//   buffer: Where to write the serialised form.
+//   size: Nr. of bytes available in `buffer`. kBinaryResultMaxSize is
+//         always enough.
+//   results: A ptr to the decode result to serialise.
+// Returns:
+//   Nr. of bytes written, or 0 if `buffer` is too small.
+uint16_t resultToBinary(uint8_t *buffer, const uint16_t size,
+                        const decode_results *results) {
+  uint16_t needed = kBinaryResultHeaderLength;
+  const bool has_state = hasACState(results->decode_type);
+  const uint16_t nbytes = (results->bits + 7) / 8;
+  if (has_state)
+    needed += nbytes;
+  else
+    needed += 8 + 4 + 4;  // value + address + command
+  if (size < needed) return 0;
+  buffer[0] = kBinaryResultVersion;
+  buffer[1] = (uint8_t)((int8_t)results->decode_type);
+  writeLittleEndian(buffer + 2, results->bits, 2);
+  buffer[4] = results->repeat ? 1 : 0;  // Flags.
+  if (has_state) {
+#if DECODE_AC
+    for (uint16_t i = 0; i < nbytes; i++)
+      buffer[kBinaryResultHeaderLength + i] = results->state[i];
+#endif  // DECODE_AC
+  } else {
+    writeLittleEndian(buffer + kBinaryResultHeaderLength, results->value, 8);
+    writeLittleEndian(buffer + kBinaryResultHeaderLength + 8,
+                      results->address, 4);
+    writeLittleEndian(buffer + kBinaryResultHeaderLength + 12,
+                      results->command, 4);
+  }
+  return needed;
+}
+
+// Parse a binary serialised result (see resultToBinary()) in place.
+// No allocation or copying is done: `result->state` points into `buffer`,
+// so `buffer` must outlive `result`.
+// Args:
+//   buffer: The serialised form to parse.
+//   size: Nr. of bytes in `buffer`.
+//   result: Where to store the parsed view.
+// Returns:
+//   A boolean indicating if the buffer held a valid serialised result.
+bool binaryToResult(const uint8_t *buffer, const uint16_t size,
+                    binary_result_t *result) {
+  if (buffer == NULL || result == NULL || size < kBinaryResultHeaderLength)
+    return false;
+  if (buffer[0] != kBinaryResultVersion) return false;  // Unknown version.
+  result->version = buffer[0];
+  result->decode_type = (decode_type_t)((int8_t)buffer[1]);
+  if (result->decode_type > kLastDecodeType) return false;
+  result->bits = readLittleEndian(buffer + 2, 2);
+  result->repeat = buffer[4] & 1;
+  result->value = 0;
+  result->address = 0;
+  result->command = 0;
+  result->state = NULL;
+  result->state_length = 0;
+  if (hasACState(result->decode_type)) {
+    const uint16_t nbytes = (result->bits + 7) / 8;
+    if (size < kBinaryResultHeaderLength + nbytes) return false;
+    result->state = buffer + kBinaryResultHeaderLength;  // Zero copy.
+    result->state_length = nbytes;
+  } else {
+    if (size < kBinaryResultHeaderLength + 16) return false;
+    result->value = readLittleEndian(buffer + kBinaryResultHeaderLength, 8);
+    result->address = readLittleEndian(
+        buffer + kBinaryResultHeaderLength + 8, 4);
+    result->command = readLittleEndian(
+        buffer + kBinaryResultHeaderLength + 12, 4);
+  }
+  return true;
+}
+
+// Serialise an A/C class's state into a checksummed snapshot record, for
+// persisting across reboots in a small EEPROM/RTC region. On boot, a
+// bridge can acSnapshotRestore() the region & setRaw() each A/C class back
+// to its pre-reboot state, so the first reconcile cycle finds everything
+// already in sync & transmits nothing. e.g.
+//   offset += acSnapshotSave(DAIKIN, ac.getRaw(), kDaikinStateLength,
+//                            region + offset, sizeof(region) - offset);
+// Records are self-delimiting (each is `length` + kAcSnapshotOverhead
+// bytes), so snapshots of several A/C units can be laid back-to-back.
+//
+// Args:
+//   protocol: The state's protocol, stored in the record so a multi-unit
+//             region is self-describing.
+//   state:    The state bytes. i.e. What getRaw() returned.
+//   length:   Nr. of bytes in `state`.
+//   dest:     Where to write the record.
+//   dest_size: Nr. of bytes available at `dest`.
+// Returns:
+//   The nr. of bytes written, or 0 if the record doesn't fit.
+uint16_t acSnapshotSave(const decode_type_t protocol, const uint8_t *state,
+                        const uint8_t length, uint8_t *dest,
+                        const uint16_t dest_size) {
+  if (dest == NULL || state == NULL ||
+      dest_size < length + kAcSnapshotOverhead)
+    return 0;
+  dest[0] = kAcSnapshotTag;
+  dest[1] = (uint8_t)protocol;
+  dest[2] = length;
+  copyBytes(dest + 3, state, length);
+  // An inverted additive sum, so all-zeros & all-ones regions (i.e. blank
+  // or erased storage) can never verify.
+  dest[3 + length] = ~sumBytes(dest, 3 + length);
+  return length + kAcSnapshotOverhead;
+}
+
+// Validate & unpack an acSnapshotSave() record.
+// The caller should hand the returned state to the matching A/C class's
+// setRaw(), so the class re-derives its settings from it as usual.
+//
+// Args:
+//   src:      Where the record is expected to start.
+//   src_size: Nr. of bytes readable at `src`.
+//   state:    Where to copy the state bytes to.
+//   max_length: Capacity of `state`.
+//   protocol: Where to store the record's protocol. (Optional)
+// Returns:
+//   The nr. of state bytes restored, or 0 if there is no valid record at
+//   `src` (bad tag, truncated, or failed checksum). The record occupies
+//   the returned length + kAcSnapshotOverhead bytes, should the caller
+//   want to walk to the next record in the region.
+uint16_t acSnapshotRestore(const uint8_t *src, const uint16_t src_size,
+                           uint8_t *state, const uint8_t max_length,
+                           decode_type_t *protocol) {
+  if (src == NULL || state == NULL || src_size < kAcSnapshotOverhead)
+    return 0;
+  if (src[0] != kAcSnapshotTag) return 0;
+  const uint8_t length = src[2];
+  if (length == 0 || length > max_length ||
+      src_size < length + kAcSnapshotOverhead)
+    return 0;
+  if (src[3 + length] != (uint8_t)~sumBytes(src, 3 + length))
+    return 0;  // Corrupt, stale or blank storage.
+  copyBytes(state, src + 3, length);
+  if (protocol != NULL) *protocol = (decode_type_t)((int8_t)src[1]);
+  return length;
+}
@@ -8,13 +8,39 @@
 #endif
 #define __STDC_LIMIT_MACROS
 #include <stdint.h>
+#include <string.h>
 #ifndef ARDUINO
+#include <ostream>
 #include <string>
 #endif
 #include "IRremoteESP8266.h"
 #include "IRrecv.h"
 
+// Common text fragments for the human readable output, stored in flash
+// (PROGMEM) to save RAM. Use via IRStringBuf::add_P().
+extern const char kOnStr[] PROGMEM;             // "On"
+extern const char kOffStr[] PROGMEM;            // "Off"
+extern const char kAutoStr[] PROGMEM;           // " (AUTO)"
+extern const char kCoolStr[] PROGMEM;           // " (COOL)"
+extern const char kHeatStr[] PROGMEM;           // " (HEAT)"
+extern const char kDryStr[] PROGMEM;            // " (DRY)"
+extern const char kFanStr[] PROGMEM;            // " (FAN)"
+extern const char kMinStr[] PROGMEM;            // " (MIN)"
+extern const char kMaxStr[] PROGMEM;            // " (MAX)"
+extern const char kQuietStr[] PROGMEM;          // " (QUIET)"
+extern const char kUnknownStr[] PROGMEM;        // " (UNKNOWN)"
+extern const char kPowerLabelStr[] PROGMEM;     // "Power: "
+extern const char kModeLabelStr[] PROGMEM;      // ", Mode: "
+extern const char kTempLabelStr[] PROGMEM;      // ", Temp: "
+extern const char kFanLabelStr[] PROGMEM;       // "C, Fan: "
+extern const char kQuietLabelStr[] PROGMEM;     // ", Quiet: "
+extern const char kSwingHLabelStr[] PROGMEM;    // ", Swing (Horizontal): "
+extern const char kSwingVLabelStr[] PROGMEM;    // ", Swing (Vertical): "
+
 uint64_t reverseBits(uint64_t input, uint16_t nbits);
+uint16_t uint64ToStr(char *output, uint64_t input, uint8_t base = 10);
+uint16_t typeToStr(char *output, const decode_type_t protocol,
+                   const bool isRepeat = false);
 #ifdef ARDUINO  // Arduino's & C++'s string implementations can't co-exist.
 String uint64ToString(uint64_t input, uint8_t base = 10);
 String typeToString(const decode_type_t protocol,
@@ -22,6 +48,8 @@ String typeToString(const decode_type_t protocol,
 void serialPrintUint64(uint64_t input, uint8_t base = 10);
 String resultToSourceCode(const decode_results *results);
 String resultToTimingInfo(const decode_results *results);
+void resultToSourceCode(Print *out, const decode_results *results);
+void resultToTimingInfo(Print *out, const decode_results *results);
 String resultToHumanReadableBasic(const decode_results *results);
 String resultToHexidecimal(const decode_results *result);
 String htmlEscape(const String unescaped);
@@ -31,18 +59,230 @@ std::string typeToString(const decode_type_t protocol,
                          const bool isRepeat = false);
 std::string resultToSourceCode(const decode_results *results);
 std::string resultToTimingInfo(const decode_results *results);
+void resultToSourceCode(std::ostream *out, const decode_results *results);
+void resultToTimingInfo(std::ostream *out, const decode_results *results);
 std::string resultToHumanReadableBasic(const decode_results *results);
 std::string resultToHexidecimal(const decode_results *result);
 std::string htmlEscape(const std::string unescaped);
 #endif  // ARDUINO
 bool hasACState(const decode_type_t protocol);
 uint16_t getCorrectedRawLength(const decode_results *results);
-uint8_t sumBytes(uint8_t *start, const uint16_t length, const uint8_t init = 0);
-uint8_t xorBytes(uint8_t *start, const uint16_t length, const uint8_t init = 0);
+uint16_t resultToPronto(uint16_t *dest, const uint16_t dest_len,
+                        const decode_results *results);
+uint8_t sumBytes(const uint8_t *start, const uint16_t length,
+                 const uint8_t init = 0);
+uint8_t xorBytes(const uint8_t *start, const uint16_t length,
+                 const uint8_t init = 0);
+uint8_t sumNibbles(const uint64_t data, const uint8_t count = 16,
+                   const uint8_t init = 0);
 uint16_t countBits(const uint8_t *start, const uint16_t length,
                    const bool ones = true, const uint16_t init = 0);
 uint16_t countBits(const uint64_t data, const uint8_t length,
                    const bool ones = true, const uint16_t init = 0);
 uint64_t invertBits(const uint64_t data, const uint16_t nbits);
 decode_type_t strToDecodeType(const char *str);
+
+// Word-width copy & compare for the A/C classes' remote_state arrays.
+// memcpy()/memcmp() move a machine word per iteration where the vendor
+// classes' hand-rolled for loops moved a byte. Inline, so a constant
+// k*StateLength argument propagates straight into the library call.
+inline void copyBytes(uint8_t *dst, const uint8_t *src,
+                      const uint16_t length) {
+  memcpy(dst, src, length);
+}
+
+// Are the two byte arrays identical for the given length?
+inline bool equalBytes(const uint8_t *a, const uint8_t *b,
+                       const uint16_t length) {
+  return memcmp(a, b, length) == 0;
+}
+
+// As copyBytes()/equalBytes(), but with the second argument in PROGMEM
+// (flash). On the ESPs these map to the word-granularity memcpy_P()/
+// memcmp_P() routines, so reading a flash-resident table costs about the
+// same as a RAM one; outside the Arduino framework PROGMEM is plain
+// memory & they collapse to the RAM versions.
+inline void copyBytes_P(uint8_t *dst, const uint8_t *src,
+                        const uint16_t length) {
+#if defined(ESP8266) || defined(ESP32)
+  memcpy_P(dst, src, length);
+#else
+  memcpy(dst, src, length);
+#endif
+}
+
+inline bool equalBytes_P(const uint8_t *a, const uint8_t *b,
+                         const uint16_t length) {
+#if defined(ESP8266) || defined(ESP32)
+  return memcmp_P(a, b, length) == 0;
+#else
+  return memcmp(a, b, length) == 0;
+#endif
+}
+
+// Bit-field accessors, for the A/C classes' packed remote states.
+// GETBIT*() tests the bit at `position`. GETBITS*() extracts the `size`-bit
+// field starting at bit `offset`. They are macros rather than functions so
+// that with constant arguments (the normal case: a kXxxOffset constant) the
+// whole expression folds down to a single shift & mask at compile time.
+// Pick the variant matching the width of `data`.
+#define GETBIT8(data, position) ((data) & ((uint8_t)1 << (position)))
+#define GETBIT16(data, position) ((data) & ((uint16_t)1 << (position)))
+#define GETBIT32(data, position) ((data) & ((uint32_t)1 << (position)))
+#define GETBIT64(data, position) ((data) & ((uint64_t)1 << (position)))
+#define GETBITS8(data, offset, size) \
+  (((data) & (((uint8_t)UINT8_MAX >> (8 - (size))) << (offset))) >> (offset))
+#define GETBITS16(data, offset, size) \
+  (((data) & (((uint16_t)UINT16_MAX >> (16 - (size))) << (offset))) >> \
+   (offset))
+#define GETBITS32(data, offset, size) \
+  (((data) & (((uint32_t)UINT32_MAX >> (32 - (size))) << (offset))) >> \
+   (offset))
+#define GETBITS64(data, offset, size) \
+  (((data) & (((uint64_t)UINT64_MAX >> (64 - (size))) << (offset))) >> \
+   (offset))
+
+// Set (on == true) or clear the bit at `position` of `*data`.
+inline void setBit(uint8_t *data, const uint8_t position,
+                   const bool on = true) {
+  uint8_t mask = (uint8_t)1 << position;
+  if (on)
+    *data |= mask;
+  else
+    *data &= ~mask;
+}
+
+inline void setBit(uint32_t *data, const uint8_t position,
+                   const bool on = true) {
+  uint32_t mask = (uint32_t)1 << position;
+  if (on)
+    *data |= mask;
+  else
+    *data &= ~mask;
+}
+
+inline void setBit(uint64_t *data, const uint8_t position,
+                   const bool on = true) {
+  uint64_t mask = (uint64_t)1 << position;
+  if (on)
+    *data |= mask;
+  else
+    *data &= ~mask;
+}
+
+// Insert the `nbits` least significant bits of `data` into `*dst`, starting
+// at bit `offset`. Bits outside the field are preserved. i.e. A single
+// mask & insert, replacing the clear-then-OR pairs the setters used to
+// hand-roll. The byte-array A/C states use the uint8_t form on the byte
+// holding the field.
+inline void setBits(uint8_t *dst, const uint8_t offset, const uint8_t nbits,
+                    const uint8_t data) {
+  if (!nbits) return;  // Nothing to do.
+  uint8_t mask = (uint8_t)(UINT8_MAX >> (8 - nbits)) << offset;
+  *dst = (*dst & ~mask) | (((uint8_t)(data << offset)) & mask);
+}
+
+inline void setBits(uint32_t *dst, const uint8_t offset, const uint8_t nbits,
+                    const uint32_t data) {
+  if (!nbits) return;  // Nothing to do.
+  uint32_t mask = (uint32_t)(UINT32_MAX >> (32 - nbits)) << offset;
+  *dst = (*dst & ~mask) | ((data << offset) & mask);
+}
+
+inline void setBits(uint64_t *dst, const uint8_t offset, const uint8_t nbits,
+                    const uint64_t data) {
+  if (!nbits) return;  // Nothing to do.
+  uint64_t mask = (uint64_t)(UINT64_MAX >> (64 - nbits)) << offset;
+  *dst = (*dst & ~mask) | ((data << offset) & mask);
+}
+
+// Accounting of the heap owned by the library's own allocations. See
+// IRMEM_STATS in IRremoteESP8266.h. The record calls are internal plumbing
+// used at the allocation points; sketches normally only read
+// irMemCurrent()/irMemPeak().
+#if IRMEM_STATS
+void irMemRecordAlloc(const uint32_t bytes);
+void irMemRecordFree(const uint32_t bytes);
+uint32_t irMemCurrent(void);
+uint32_t irMemPeak(void);
+void irMemResetPeak(void);
+#else  // IRMEM_STATS
+// No-op stand-ins, so the allocation points don't need #if guards.
+inline void irMemRecordAlloc(const uint32_t) {}
+inline void irMemRecordFree(const uint32_t) {}
+inline uint32_t irMemCurrent(void) { return 0; }
+inline uint32_t irMemPeak(void) { return 0; }
+inline void irMemResetPeak(void) {}
+#endif  // IRMEM_STATS
+
+// Compact, versioned, little-endian binary form of a decode result, for
+// shipping off-device (e.g. MQTT/TCP) without the cost of formatting &
+// re-parsing text. See resultToBinary()/binaryToResult().
+const uint8_t kBinaryResultVersion = 1;
+// Layout: version(1), protocol(1), bits(2), flags(1), then either the
+// A/C state bytes, or value(8) + address(4) + command(4).
+const uint16_t kBinaryResultHeaderLength = 5;
+// Big enough for any result. (Largest A/C state is kStateSizeMax bytes)
+const uint16_t kBinaryResultMaxSize = kBinaryResultHeaderLength +
+                                      kStateSizeMax;
+
+// A parsed view of a binary serialised result. `state` points into the
+// buffer it was parsed from. i.e. Zero copy, no ownership.
+typedef struct {
+  uint8_t version;
+  decode_type_t decode_type;
+  uint16_t bits;
+  bool repeat;
+  uint64_t value;            // Only valid for non-A/C state protocols.
+  uint32_t address;          // Ditto.
+  uint32_t command;          // Ditto.
+  const uint8_t *state;      // NULL for non-A/C state protocols.
+  uint16_t state_length;     // Nr. of bytes in `state`.
+} binary_result_t;
+
+uint16_t resultToBinary(uint8_t *buffer, const uint16_t size,
+                        const decode_results *results);
+bool binaryToResult(const uint8_t *buffer, const uint16_t size,
+                    binary_result_t *result);
+
+// Checksummed A/C state snapshots, for persisting a vendor class's
+// remote_state (via getRaw()/setRaw()) across reboots in a small
+// EEPROM/RTC region. Records are self-delimiting, so several A/C units'
+// snapshots can sit back-to-back in one region.
+// See acSnapshotSave()/acSnapshotRestore().
+const uint8_t kAcSnapshotTag = 0xA5;  // Marks a record as one of ours.
+// Layout: tag(1), protocol(1), length(1), the state bytes, sum(1).
+const uint16_t kAcSnapshotOverhead = 4;
+
+uint16_t acSnapshotSave(const decode_type_t protocol, const uint8_t *state,
+                        const uint8_t length, uint8_t *dest,
+                        const uint16_t dest_size);
+uint16_t acSnapshotRestore(const uint8_t *src, const uint16_t src_size,
+                           uint8_t *state, const uint8_t max_length,
+                           decode_type_t *protocol = NULL);
+
+// A simple appender for building human readable output in a caller-supplied
+// fixed buffer. Unlike String/std::string concatenation it never touches the
+// heap, so frequent message formatting (e.g. for MQTT/logging) can't
+// fragment the ESP8266's heap. Output is always NUL-terminated & silently
+// truncated if the buffer is too small. See overflowed().
+class IRStringBuf {
+ public:
+  IRStringBuf(char *buffer, const uint16_t size);
+  void add(const char *str);
+  void add(const char c);
+  void add_P(const char *str);  // As add(), but str is in flash. (PROGMEM)
+  void addUint(const uint64_t value, const uint8_t base = 10);
+  void addBool(const bool value);  // Adds "On" or "Off".
+  void reset(void);  // Empty the buffer so it can be reused.
+  const char *c_str(void) const { return _buffer; }
+  uint16_t length(void) const { return _length; }
+  bool overflowed(void) const { return _overflow; }
+
+ private:
+  char *_buffer;
+  uint16_t _size;
+  uint16_t _length;
+  bool _overflow;
+};
 #endif  // IRUTILS_H_
@@ -6,6 +6,7 @@ Copyright 2017 Schmolders
 
 #include "ir_Argo.h"
 #include <algorithm>
+#include "IRrecv.h"
 #include "IRremoteESP8266.h"
 #include "IRutils.h"
 
@@ -25,13 +26,16 @@ const uint16_t kArgoZeroSpace = 900;
 //
 // Status: ALPHA / Untested.
 
+static constexpr irtiming_t kArgoTiming = {
+    kArgoHdrMark, kArgoHdrSpace, kArgoBitMark,  kArgoOneSpace,
+    kArgoBitMark, kArgoZeroSpace, 0, 0,  // No Footer.
+    38, false, kDutyDefault};
+
 void IRsend::sendArgo(unsigned char data[], uint16_t nbytes, uint16_t repeat) {
   // Check if we have enough bytes to send a proper message.
   if (nbytes < kArgoStateLength) return;
   // TODO(kaschmo): validate
-  sendGeneric(kArgoHdrMark, kArgoHdrSpace, kArgoBitMark, kArgoOneSpace,
-              kArgoBitMark, kArgoZeroSpace, 0, 0,  // No Footer.
-              data, nbytes, 38, false, repeat, kDutyDefault);
+  sendGeneric(kArgoTiming, data, nbytes, repeat);
 }
 #endif  // SEND_ARGO
 
@@ -46,15 +50,26 @@ void IRArgoAC::send(const uint16_t repeat) {
 }
 #endif  // SEND_ARGO
 
-void IRArgoAC::checksum() {
-  uint8_t sum = 2;  // Corresponds to byte 11 being constant 0b01
-  uint8_t i;
+// Verify the checksum of the given state.
+//
+// Args:
+//   state: A pointer to the array of bytes to verify.
+//   length: Nr. of bytes in the state array.
+// Returns:
+//   A boolean indicating if the checksum is valid.
+bool IRArgoAC::validChecksum(const uint8_t state[], const uint16_t length) {
+  if (length < 2) return false;
+  // See checksum() below: the sum lives in the top 6 bits of the 2nd-last
+  // byte & the bottom 2 bits of the last byte.
+  uint8_t sum = sumBytes(state, length - 2, 2);
+  return ((state[length - 2] >> 2) | ((state[length - 1] & 0b11) << 6)) == sum;
+}
 
+void IRArgoAC::checksum() {
+  // Init of 2 corresponds to byte 11 being constant 0b01.
   // Only add up bytes to 9. byte 10 is 0b01 constant anyway.
   // Assume that argo array is MSB first (left)
-  for (i = 0; i < 10; i++) sum += argo[i];
-
-  sum = sum % 256;  // modulo 256
+  uint8_t sum = sumBytes(argo, 10, 2);  // Implicitly modulo 256.
   // Append sum to end of array
   // Set const part of checksum bit 10
   argo[10] = 0b00000010;
@@ -262,3 +277,44 @@ uint8_t IRArgoAC::convertSwingV(const stdAc::swingv_t position) {
       return kArgoFlapAuto;
   }
 }
+
+#if DECODE_ARGO
+// Decode the supplied Argo A/C message.
+//
+// Args:
+//   results: Ptr to the data to decode and where to store the decode result.
+//   nbits:   The number of data bits to expect. Typically kArgoBits.
+//   strict:  Flag indicating if we should perform strict matching.
+// Returns:
+//   boolean: True if it can decode it, false if it can't.
+//
+// Status: ALPHA / Based entirely off sendArgo(). Untested against a real
+//         remote, as we don't have a capture from one.
+bool IRrecv::decodeArgo(decode_results *results, const uint16_t nbits,
+                        const bool strict) {
+  if (results->rawlen < 2 * nbits + kHeader - 1)
+    return false;  // Can't possibly be a valid Argo message.
+  if (strict && nbits != kArgoBits) return false;
+
+  // Header + Data
+  if (!matchGeneric(results->rawbuf + kStartOffset, results->state,
+                    results->rawlen - kStartOffset, nbits,
+                    kArgoHdrMark, kArgoHdrSpace,
+                    kArgoBitMark, kArgoOneSpace,
+                    kArgoBitMark, kArgoZeroSpace,
+                    0, 0,  // No Footer. (See sendArgo())
+                    true, kUseDefTol, 0, false))
+    return false;
+
+  // Compliance
+  if (strict && !IRArgoAC::validChecksum(results->state)) return false;
+
+  // Success
+  results->decode_type = ARGO;
+  results->bits = nbits;
+  // No need to record the state as we stored it as we decoded it.
+  // As we use result->state, we don't record value, address, or command as it
+  // is a union data type.
+  return true;
+}
+#endif  // DECODE_ARGO
@@ -122,6 +122,8 @@ class IRArgoAC {
   void setRoomTemp(uint8_t temp);
 
   uint8_t* getRaw();
+  static bool validChecksum(const uint8_t state[],
+                            const uint16_t length = kArgoStateLength);
   uint8_t convertFan(const stdAc::fanspeed_t speed);
   uint8_t convertSwingV(const stdAc::swingv_t position);
 #ifndef UNIT_TEST
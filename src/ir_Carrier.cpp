@@ -35,15 +35,17 @@ const uint16_t kCarrierAcGap = 20000;
 //
 // Status: BETA / Appears to work on real devices.
 //
+static constexpr irtiming_t kCarrierAcTiming = {
+    kCarrierAcHdrMark, kCarrierAcHdrSpace, kCarrierAcBitMark,
+    kCarrierAcOneSpace, kCarrierAcBitMark, kCarrierAcZeroSpace,
+    kCarrierAcBitMark, kCarrierAcGap, 38, true, kDutyDefault};
+
 void IRsend::sendCarrierAC(uint64_t data, uint16_t nbits, uint16_t repeat) {
   for (uint16_t r = 0; r <= repeat; r++) {
     uint64_t temp_data = data;
     // Carrier sends the data block three times. normal + inverted + normal.
     for (uint16_t i = 0; i < 3; i++) {
-      sendGeneric(kCarrierAcHdrMark, kCarrierAcHdrSpace, kCarrierAcBitMark,
-                  kCarrierAcOneSpace, kCarrierAcBitMark, kCarrierAcZeroSpace,
-                  kCarrierAcBitMark, kCarrierAcGap, temp_data, nbits, 38, true,
-                  0, kDutyDefault);
+      sendGeneric(kCarrierAcTiming, temp_data, nbits, 0);
       temp_data = invertBits(temp_data, nbits);
     }
   }
@@ -66,7 +68,12 @@ void IRsend::sendCarrierAC(uint64_t data, uint16_t nbits, uint16_t repeat) {
 //
 bool IRrecv::decodeCarrierAC(decode_results *results, uint16_t nbits,
                              bool strict) {
-  if (results->rawlen < ((2 * nbits + kHeader + kFooter) * 3) - 1)
+  // Carrier carries no checksum; the triple-send with alternating inversion
+  // *is* the verification. In single-frame-accept mode stop at the earliest
+  // self-check possible: the first data+inverse pair. i.e. Two copies
+  // instead of three. (See setSingleFrameAccept())
+  const uint8_t copies = _single_frame ? 2 : 3;
+  if (results->rawlen < ((2 * nbits + kHeader + kFooter) * copies) - 1)
     return false;  // Can't possibly be a valid Carrier message.
   if (strict && nbits != kCarrierAcBits)
     return false;  // We expect Carrier to be 32 bits of message.
@@ -75,24 +82,17 @@ bool IRrecv::decodeCarrierAC(decode_results *results, uint16_t nbits,
   uint64_t prev_data = 0;
   uint16_t offset = kStartOffset;
 
-  for (uint8_t i = 0; i < 3; i++) {
+  for (uint8_t i = 0; i < copies; i++) {
     prev_data = data;
-    // Header
-    if (!matchMark(results->rawbuf[offset++], kCarrierAcHdrMark)) return false;
-    if (!matchSpace(results->rawbuf[offset++], kCarrierAcHdrSpace))
-      return false;
-    // Data
-    match_result_t data_result =
-        matchData(&(results->rawbuf[offset]), nbits, kCarrierAcBitMark,
-                  kCarrierAcOneSpace, kCarrierAcBitMark, kCarrierAcZeroSpace);
-    if (data_result.success == false) return false;
-    data = data_result.data;
-    offset += data_result.used;
-    // Footer
-    if (!matchMark(results->rawbuf[offset++], kCarrierAcBitMark)) return false;
-    if (offset < results->rawlen &&
-        !matchAtLeast(results->rawbuf[offset++], kCarrierAcGap))
-      return false;
+    // Header + Data + Footer
+    uint16_t used = matchGeneric(results->rawbuf + offset, &data,
+                                 results->rawlen - offset, nbits,
+                                 kCarrierAcHdrMark, kCarrierAcHdrSpace,
+                                 kCarrierAcBitMark, kCarrierAcOneSpace,
+                                 kCarrierAcBitMark, kCarrierAcZeroSpace,
+                                 kCarrierAcBitMark, kCarrierAcGap, true);
+    if (!used) return false;
+    offset += used;
     // Compliance.
     if (strict) {
       // Check if the data is an inverted copy of the previous data.
@@ -100,6 +100,10 @@ bool IRrecv::decodeCarrierAC(decode_results *results, uint16_t nbits,
     }
   }
 
+  // With an even number of copies the loop ends on an inverted one; the
+  // message proper is the copy before it.
+  if (copies % 2 == 0) data = prev_data;
+
   // Success
   results->bits = nbits;
   results->value = data;
@@ -72,11 +72,11 @@ void IRsend::sendCOOLIX(uint64_t data, uint16_t nbits, uint16_t repeat) {
       // Grab a bytes worth of data.
       uint8_t segment = (data >> (nbits - i)) & 0xFF;
       // Normal
-      sendData(kCoolixBitMark, kCoolixOneSpace, kCoolixBitMark,
-               kCoolixZeroSpace, segment, 8, true);
+      sendData<kCoolixBitMark, kCoolixOneSpace, kCoolixBitMark,
+               kCoolixZeroSpace>(segment, 8);
       // Inverted.
-      sendData(kCoolixBitMark, kCoolixOneSpace, kCoolixBitMark,
-               kCoolixZeroSpace, segment ^ 0xFF, 8, true);
+      sendData<kCoolixBitMark, kCoolixOneSpace, kCoolixBitMark,
+               kCoolixZeroSpace>(segment ^ 0xFF, 8);
     }
 
     // Footer
@@ -91,16 +91,31 @@ void IRsend::sendCOOLIX(uint64_t data, uint16_t nbits, uint16_t repeat) {
 //   RG57K7(B)/BGEF remote control for Beko BINR 070/071 split-type aircon.
 // Ref:
 //   https://github.com/markszabo/IRremoteESP8266/issues/484
-IRCoolixAC::IRCoolixAC(uint16_t pin) : _irsend(pin) { stateReset(); }
+IRCoolixAC::IRCoolixAC(uint16_t pin) : _irsend(pin) {
+  _repeat = kCoolixDefaultRepeat;
+  stateReset();
+}
 
 void IRCoolixAC::stateReset() { setRaw(kCoolixDefaultState); }
 
 void IRCoolixAC::begin() { _irsend.begin(); }
 
 #if SEND_COOLIX
+// Send the current desired state to the IR LED, using the configured repeat
+// count. See setRepeat().
+void IRCoolixAC::send() { send(_repeat); }
+
 void IRCoolixAC::send(const uint16_t repeat) {
   _irsend.sendCOOLIX(remote_state, kCoolixBits, repeat);
 }
+
+// Set the nr. of extra times send() will transmit the message.
+// The message is doubled by default (kCoolixDefaultRepeat) as per the
+// protocol. Deployments that verify reception can set kNoRepeat to halve
+// the transmission & blocking time.
+void IRCoolixAC::setRepeat(const uint16_t repeat) { _repeat = repeat; }
+
+uint16_t IRCoolixAC::getRepeat() { return _repeat; }
 #endif  // SEND_COOLIX
 
 uint32_t IRCoolixAC::getRaw() { return remote_state; }
@@ -143,33 +158,33 @@ uint32_t IRCoolixAC::getNormalState(void) {
 
 void IRCoolixAC::setTempRaw(const uint8_t code) {
   recoverSavedState();
-  remote_state &= ~kCoolixTempMask;  // Clear the old temp.
-  remote_state |= (code << 4);
+  setBits(&remote_state, kCoolixTempOffset, kCoolixTempSize, code);
 }
 
 uint8_t IRCoolixAC::getTempRaw() {
-  return (getNormalState() & kCoolixTempMask) >> 4;
+  return GETBITS32(getNormalState(), kCoolixTempOffset, kCoolixTempSize);
 }
 
 void IRCoolixAC::setTemp(const uint8_t desired) {
   // Range check.
   uint8_t temp = std::min(desired, kCoolixTempMax);
   temp = std::max(temp, kCoolixTempMin);
-  setTempRaw(kCoolixTempMap[temp - kCoolixTempMin]);
+  setTempRaw(pgm_read_byte(kCoolixTempMap + temp - kCoolixTempMin));
 }
 
 uint8_t IRCoolixAC::getTemp() {
   uint8_t code = getTempRaw();
   uint8_t i;
   for (i = 0; i < kCoolixTempRange; i++)
-    if (kCoolixTempMap[i] == code) return kCoolixTempMin + i;
+    if (pgm_read_byte(kCoolixTempMap + i) == code)
+      return kCoolixTempMin + i;
   return kCoolixUnknown;  // Not a temp we expected.
 }
 
 void IRCoolixAC::setSensorTempRaw(const uint8_t code) {
   recoverSavedState();
-  remote_state &= ~kCoolixSensorTempMask;  // Clear previous sensor temp.
-  remote_state |= ((code & 0xF) << 8);
+  setBits(&remote_state, kCoolixSensorTempOffset, kCoolixSensorTempSize,
+          code);
 }
 
 void IRCoolixAC::setSensorTemp(const uint8_t desired) {
@@ -181,8 +196,8 @@ void IRCoolixAC::setSensorTemp(const uint8_t desired) {
 }
 
 uint8_t IRCoolixAC::getSensorTemp() {
-  return ((getNormalState() & kCoolixSensorTempMask) >> 8) +
-         kCoolixSensorTempMin;
+  return GETBITS32(getNormalState(), kCoolixSensorTempOffset,
+                   kCoolixSensorTempSize) + kCoolixSensorTempMin;
 }
 
 bool IRCoolixAC::getPower() {
@@ -239,17 +254,13 @@ void IRCoolixAC::setClean() {
 }
 
 bool IRCoolixAC::getZoneFollow() {
-  return getNormalState() & kCoolixZoneFollowMask;
+  return GETBIT32(getNormalState(), kCoolixZoneFollowMaskOffset);
 }
 
 // Internal use only.
 void IRCoolixAC::setZoneFollow(bool state) {
   recoverSavedState();
-  if (state) {
-    remote_state |= kCoolixZoneFollowMask;
-  } else {
-    remote_state &= ~kCoolixZoneFollowMask;
-  }
+  setBit(&remote_state, kCoolixZoneFollowMaskOffset, state);
 }
 
 void IRCoolixAC::clearSensorTemp() {
@@ -268,7 +279,7 @@ void IRCoolixAC::setMode(const uint8_t mode) {
     case kCoolixHeat:
     case kCoolixDry:
       recoverSavedState();
-      remote_state = (remote_state & ~kCoolixModeMask) | (actualmode << 2);
+      setBits(&remote_state, kCoolixModeOffset, kCoolixModeSize, actualmode);
       // Force the temp into a known-good state.
       setTemp(getTemp());
   }
@@ -276,14 +287,15 @@ void IRCoolixAC::setMode(const uint8_t mode) {
 }
 
 uint8_t IRCoolixAC::getMode() {
-  uint8_t mode = (getNormalState() & kCoolixModeMask) >> 2;
+  uint8_t mode = GETBITS32(getNormalState(), kCoolixModeOffset,
+                           kCoolixModeSize);
   if (mode == kCoolixDry)
     if (getTempRaw() == kCoolixFanTempCode) return kCoolixFan;
   return mode;
 }
 
 uint8_t IRCoolixAC::getFan() {
-  return (getNormalState() & kCoolixFanMask) >> 13;
+  return GETBITS32(getNormalState(), kCoolixFanOffset, kCoolixFanSize);
 }
 
 void IRCoolixAC::setFan(const uint8_t speed) {
@@ -301,8 +313,7 @@ void IRCoolixAC::setFan(const uint8_t speed) {
     default:  // Unknown speed requested.
       newspeed = kCoolixFanAuto;
   }
-  remote_state &= ~kCoolixFanMask;
-  remote_state |= ((newspeed << 13) & kCoolixFanMask);
+  setBits(&remote_state, kCoolixFanOffset, kCoolixFanSize, newspeed);
 }
 
 // Convert a standard A/C mode into its native mode.
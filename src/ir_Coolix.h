@@ -38,8 +38,9 @@ const uint8_t kCoolixDry = 0b001;
 const uint8_t kCoolixAuto = 0b010;
 const uint8_t kCoolixHeat = 0b011;
 const uint8_t kCoolixFan = 0b100;                                 // Synthetic.
-const uint32_t kCoolixModeMask = 0b000000000000000000001100;  // 0xC
-const uint32_t kCoolixZoneFollowMask = 0b000010000000000000000000;  // 0x80000
+const uint8_t kCoolixModeOffset = 2;
+const uint8_t kCoolixModeSize = 2;  // Bits.
+const uint8_t kCoolixZoneFollowMaskOffset = 19;  // A single bit.
 // Fan Control
 const uint8_t kCoolixFanMin = 0b100;
 const uint8_t kCoolixFanMed = 0b010;
@@ -48,14 +49,16 @@ const uint8_t kCoolixFanAuto = 0b101;
 const uint8_t kCoolixFanAuto0 = 0b000;
 const uint8_t kCoolixFanZoneFollow = 0b110;
 const uint8_t kCoolixFanFixed = 0b111;
-const uint32_t kCoolixFanMask = 0b000000001110000000000000;  // 0x00E000
+const uint8_t kCoolixFanOffset = 13;
+const uint8_t kCoolixFanSize = 3;  // Bits.
 // Temperature
 const uint8_t kCoolixTempMin = 17;  // Celsius
 const uint8_t kCoolixTempMax = 30;  // Celsius
 const uint8_t kCoolixTempRange = kCoolixTempMax - kCoolixTempMin + 1;
 const uint8_t kCoolixFanTempCode = 0b1110;  // Part of Fan Mode.
-const uint32_t kCoolixTempMask = 0b11110000;
-const uint8_t kCoolixTempMap[kCoolixTempRange] = {
+const uint8_t kCoolixTempOffset = 4;
+const uint8_t kCoolixTempSize = 4;  // Bits.
+const uint8_t kCoolixTempMap[kCoolixTempRange] PROGMEM = {
     0b0000,  // 17C
     0b0001,  // 18c
     0b0011,  // 19C
@@ -74,7 +77,8 @@ const uint8_t kCoolixTempMap[kCoolixTempRange] = {
 const uint8_t kCoolixSensorTempMin = 16;  // Celsius
 const uint8_t kCoolixSensorTempMax = 30;  // Celsius
 const uint8_t kCoolixSensorTempIgnoreCode = 0b1111;
-const uint32_t kCoolixSensorTempMask = 0b000000000000111100000000;  // 0xF00
+const uint8_t kCoolixSensorTempOffset = 8;
+const uint8_t kCoolixSensorTempSize = 4;  // Bits.
 // Fixed states/messages.
 const uint8_t kCoolixPrefix = 0b1011;  // 0xB
 const uint8_t kCoolixUnknown = 0xFF;
@@ -94,7 +98,10 @@ class IRCoolixAC {
 
   void stateReset();
 #if SEND_COOLIX
-  void send(const uint16_t repeat = kCoolixDefaultRepeat);
+  void send();
+  void send(const uint16_t repeat);
+  void setRepeat(const uint16_t repeat);
+  uint16_t getRepeat();
 #endif  // SEND_COOLIX
   void begin();
   void on();
@@ -139,6 +146,10 @@ class IRCoolixAC {
 #endif
   uint32_t remote_state;  // The state of the IR remote in IR code form.
   uint32_t saved_state;   // Copy of the state if we required a special mode.
+  // Nr. of extra times send() transmits the message. The protocol doubles
+  // the message by default (kCoolixDefaultRepeat); installs that verify
+  // reception can drop it to kNoRepeat to halve the airtime.
+  uint16_t _repeat;
   void setTempRaw(const uint8_t code);
   uint8_t getTempRaw();
   void setSensorTempRaw(const uint8_t code);
@@ -86,7 +86,10 @@ void IRsend::sendDaikin(const unsigned char data[], const uint16_t nbytes,
 }
 #endif  // SEND_DAIKIN
 
-IRDaikinESP::IRDaikinESP(uint16_t pin) : _irsend(pin) { stateReset(); }
+IRDaikinESP::IRDaikinESP(uint16_t pin) : _irsend(pin) {
+  _prev_valid = false;  // Nothing has been transmitted yet.
+  stateReset();
+}
 
 void IRDaikinESP::begin(void) { _irsend.begin(); }
 
@@ -94,6 +97,30 @@ void IRDaikinESP::begin(void) { _irsend.begin(); }
 void IRDaikinESP::send(const uint16_t repeat) {
   this->checksum();
   _irsend.sendDaikin(remote, kDaikinStateLength, repeat);
+  // Remember what we sent, for sendDiff().
+  copyBytes(remote_prev, remote, kDaikinStateLength);
+  _prev_valid = true;
+}
+
+// Send the current state only if it differs from the last transmitted one.
+// The Daikin protocol has no valid partial frame - units apply a complete
+// 3-section message - so the minimal frame set for an unchanged state is
+// no frames at all. Use send() instead if the unit needs an unconditional
+// keep-alive.
+//
+// Args:
+//   repeat: Nr. of times the message will be repeated, if it is sent.
+// Returns:
+//   A boolean indicating if anything was actually transmitted.
+bool IRDaikinESP::sendDiff(const uint16_t repeat) {
+  this->checksum();
+  if (_prev_valid) {
+    uint8_t i = 0;
+    while (i < kDaikinStateLength && remote[i] == remote_prev[i]) i++;
+    if (i >= kDaikinStateLength) return false;  // Nothing changed. Skip it.
+  }
+  send(repeat);
+  return true;
 }
 #endif  // SEND_DAIKIN
 
@@ -124,39 +151,26 @@ bool IRDaikinESP::validChecksum(uint8_t state[], const uint16_t length) {
 }
 
 // Calculate and set the checksum values for the internal state.
+// Skipped entirely when no setting has changed since the last calculation,
+// so steady-state re-sends don't pay for the three section sums each time.
 void IRDaikinESP::checksum(void) {
-  remote[kDaikinByteChecksum1] = sumBytes(remote, kDaikinSection1Length - 1);
-  remote[kDaikinByteChecksum2] = sumBytes(remote + kDaikinSection1Length,
-                                          kDaikinSection2Length - 1);
-  remote[kDaikinByteChecksum3] = sumBytes(remote + kDaikinSection1Length +
-                                          kDaikinSection2Length,
-                                          kDaikinSection3Length - 1);
+  if (!_dirty) return;  // Nothing has changed. The checksums are still good.
+  // Only the sections that changed need their sums recalculated.
+  if (_dirty & kDaikinDirtySection1)
+    remote[kDaikinByteChecksum1] = sumBytes(remote, kDaikinSection1Length - 1);
+  if (_dirty & kDaikinDirtySection2)
+    remote[kDaikinByteChecksum2] = sumBytes(remote + kDaikinSection1Length,
+                                            kDaikinSection2Length - 1);
+  if (_dirty & kDaikinDirtySection3)
+    remote[kDaikinByteChecksum3] = sumBytes(remote + kDaikinSection1Length +
+                                            kDaikinSection2Length,
+                                            kDaikinSection3Length - 1);
+  _dirty = 0;
 }
 
 void IRDaikinESP::stateReset(void) {
-  for (uint8_t i = 0; i < kDaikinStateLength; i++) remote[i] = 0x0;
-
-  remote[0] = 0x11;
-  remote[1] = 0xDA;
-  remote[2] = 0x27;
-  remote[4] = 0xC5;
-  // remote[7] is a checksum byte, it will be set by checksum().
-
-  remote[8] = 0x11;
-  remote[9] = 0xDA;
-  remote[10] = 0x27;
-  remote[12] = 0x42;
-  // remote[15] is a checksum byte, it will be set by checksum().
-  remote[16] = 0x11;
-  remote[17] = 0xDA;
-  remote[18] = 0x27;
-  remote[21] = 0x49;
-  remote[22] = 0x1E;
-  remote[24] = 0xB0;
-  remote[27] = 0x06;
-  remote[28] = 0x60;
-  remote[31] = 0xC0;
-  // remote[34] is a checksum byte, it will be set by checksum().
+  _dirty = kDaikinDirtyAll;
+  copyBytes_P(remote, kDaikinKnownGoodState, kDaikinStateLength);
   this->checksum();
 }
 
@@ -173,11 +187,20 @@ void IRDaikinESP::setRaw(const uint8_t new_code[], const uint16_t length) {
   }
   for (uint8_t i = 0; i < length && i < kDaikinStateLength; i++)
     remote[i + offset] = new_code[i];
+  // Marked *after* the copy, as stateReset() ends with a checksum() which
+  // would otherwise clear the mask with the new code only partially in.
+  _dirty = kDaikinDirtyAll;
 }
 
-void IRDaikinESP::on(void) { remote[kDaikinBytePower] |= kDaikinBitPower; }
+void IRDaikinESP::on(void) {
+  _dirty |= kDaikinDirtySection3;
+  remote[kDaikinBytePower] |= kDaikinBitPower;
+}
 
-void IRDaikinESP::off(void) { remote[kDaikinBytePower] &= ~kDaikinBitPower; }
+void IRDaikinESP::off(void) {
+  _dirty |= kDaikinDirtySection3;
+  remote[kDaikinBytePower] &= ~kDaikinBitPower;
+}
 
 void IRDaikinESP::setPower(const bool on) {
   if (on)
@@ -192,6 +215,7 @@ bool IRDaikinESP::getPower(void) {
 
 // Set the temp in deg C
 void IRDaikinESP::setTemp(const uint8_t temp) {
+  _dirty |= kDaikinDirtySection3;
   uint8_t degrees = std::max(temp, kDaikinMinTemp);
   degrees = std::min(degrees, kDaikinMaxTemp);
   remote[kDaikinByteTemp] = degrees << 1;
@@ -201,6 +225,7 @@ uint8_t IRDaikinESP::getTemp(void) { return remote[kDaikinByteTemp] >> 1; }
 
 // Set the speed of the fan, 1-5 or kDaikinFanAuto or kDaikinFanQuiet
 void IRDaikinESP::setFan(const uint8_t fan) {
+  _dirty |= kDaikinDirtySection3;
   // Set the fan speed bits, leave low 4 bits alone
   uint8_t fanset;
   if (fan == kDaikinFanQuiet || fan == kDaikinFanAuto)
@@ -222,6 +247,7 @@ uint8_t IRDaikinESP::getFan(void) {
 uint8_t IRDaikinESP::getMode(void) { return remote[kDaikinBytePower] >> 4; }
 
 void IRDaikinESP::setMode(const uint8_t mode) {
+  _dirty |= kDaikinDirtySection3;
   switch (mode) {
     case kDaikinAuto:
     case kDaikinCool:
@@ -237,6 +263,7 @@ void IRDaikinESP::setMode(const uint8_t mode) {
 }
 
 void IRDaikinESP::setSwingVertical(const bool on) {
+  _dirty |= kDaikinDirtySection3;
   if (on)
     remote[kDaikinByteFan] |= 0x0F;
   else
@@ -248,6 +275,7 @@ bool IRDaikinESP::getSwingVertical(void) {
 }
 
 void IRDaikinESP::setSwingHorizontal(const bool on) {
+  _dirty |= kDaikinDirtySection3;
   if (on)
     remote[kDaikinByteSwingH] |= 0x0F;
   else
@@ -259,6 +287,7 @@ bool IRDaikinESP::getSwingHorizontal(void) {
 }
 
 void IRDaikinESP::setQuiet(const bool on) {
+  _dirty |= kDaikinDirtySection3;
   if (on) {
     remote[kDaikinByteSilent] |= kDaikinBitSilent;
     // Powerful & Quiet mode being on are mutually exclusive.
@@ -273,6 +302,7 @@ bool IRDaikinESP::getQuiet(void) {
 }
 
 void IRDaikinESP::setPowerful(const bool on) {
+  _dirty |= kDaikinDirtySection3;
   if (on) {
     remote[kDaikinBytePowerful] |= kDaikinBitPowerful;
     // Powerful, Quiet, & Econo mode being on are mutually exclusive.
@@ -288,6 +318,7 @@ bool IRDaikinESP::getPowerful(void) {
 }
 
 void IRDaikinESP::setSensor(const bool on) {
+  _dirty |= kDaikinDirtySection3;
   if (on)
     remote[kDaikinByteSensor] |= kDaikinBitSensor;
   else
@@ -299,6 +330,7 @@ bool IRDaikinESP::getSensor(void) {
 }
 
 void IRDaikinESP::setEcono(const bool on) {
+  _dirty |= kDaikinDirtySection3;
   if (on) {
     remote[kDaikinByteEcono] |= kDaikinBitEcono;
     // Powerful & Econo mode being on are mutually exclusive.
@@ -313,6 +345,7 @@ bool IRDaikinESP::getEcono(void) {
 }
 
 void IRDaikinESP::setEye(const bool on) {
+  _dirty |= kDaikinDirtySection3;
   if (on)
     remote[kDaikinByteEye] |= kDaikinBitEye;
   else
@@ -324,6 +357,7 @@ bool IRDaikinESP::getEye(void) {
 }
 
 void IRDaikinESP::setMold(const bool on) {
+  _dirty |= kDaikinDirtySection3;
   if (on)
     remote[kDaikinByteMold] |= kDaikinBitMold;
   else
@@ -335,6 +369,7 @@ bool IRDaikinESP::getMold(void) {
 }
 
 void IRDaikinESP::setComfort(const bool on) {
+  _dirty |= kDaikinDirtySection1;  // Comfort lives in byte 6.
   if (on)
     remote[kDaikinByteComfort] |= kDaikinBitComfort;
   else
@@ -347,6 +382,7 @@ bool IRDaikinESP::getComfort(void) {
 
 // starttime: Number of minutes after midnight.
 void IRDaikinESP::enableOnTimer(const uint16_t starttime) {
+  _dirty |= kDaikinDirtySection3;
   remote[kDaikinByteOnTimer] |= kDaikinBitOnTimer;
   remote[kDaikinByteOnTimerMinsLow] = starttime;
   // only keep 4 bits
@@ -355,6 +391,7 @@ void IRDaikinESP::enableOnTimer(const uint16_t starttime) {
 }
 
 void IRDaikinESP::disableOnTimer(void) {
+  _dirty |= kDaikinDirtySection3;
   this->enableOnTimer(kDaikinUnusedTime);
   remote[kDaikinByteOnTimer] &= ~kDaikinBitOnTimer;
 }
@@ -370,6 +407,7 @@ bool IRDaikinESP::getOnTimerEnabled(void) {
 
 // endtime: Number of minutes after midnight.
 void IRDaikinESP::enableOffTimer(const uint16_t endtime) {
+  _dirty |= kDaikinDirtySection3;
   remote[kDaikinByteOffTimer] |= kDaikinBitOffTimer;
   remote[kDaikinByteOffTimerMinsHigh] = endtime >> 4;
   remote[kDaikinByteOffTimerMinsLow] &= 0x0F;
@@ -377,6 +415,7 @@ void IRDaikinESP::enableOffTimer(const uint16_t endtime) {
 }
 
 void IRDaikinESP::disableOffTimer(void) {
+  _dirty |= kDaikinDirtySection3;
   this->enableOffTimer(kDaikinUnusedTime);
   remote[kDaikinByteOffTimer] &= ~kDaikinBitOffTimer;
 }
@@ -391,6 +430,7 @@ bool IRDaikinESP::getOffTimerEnabled(void) {
 }
 
 void IRDaikinESP::setCurrentTime(const uint16_t mins_since_midnight) {
+  _dirty |= kDaikinDirtySection2;  // The clock lives in bytes 13 & 14.
   uint16_t mins = mins_since_midnight;
   if (mins > 24 * 60) mins = 0;  // If > 23:59, set to 00:00
   remote[kDaikinByteClockMinsLow] = mins;
@@ -405,6 +445,7 @@ uint16_t IRDaikinESP::getCurrentTime(void) {
 }
 
 void IRDaikinESP::setCurrentDay(const uint8_t day_of_week) {
+  _dirty |= kDaikinDirtySection2;  // The clock lives in bytes 13 & 14.
   // 1 is SUN, 2 is MON, ..., 7 is SAT
   uint8_t days = day_of_week;
   if (days > 7) days = 0;  // Enforce the limit
@@ -431,104 +472,124 @@ std::string IRDaikinESP::renderTime(const uint16_t timemins) {
   return ret;
 }
 
-// Convert the internal state into a human readable string.
-#ifdef ARDUINO
-String IRDaikinESP::toString(void) {
-  String result = "";
-#else   // ARDUINO
-std::string IRDaikinESP::toString(void) {
-  std::string result = "";
-#endif  // ARDUINO
-  result.reserve(230);  // Reserve some heap for the string to reduce fragging.
-  result += F("Power: ");
-  result += this->getPower() ? F("On") : F("Off");
-  result += F(", Mode: ");
-  result += uint64ToString(this->getMode());
+// Append a "H:MM" rendering of a time (in minutes past midnight) to the
+// supplied buffer.
+static void renderTimeToBuf(IRStringBuf *result, const uint16_t timemins) {
+  result->addUint(timemins / 60);
+  result->add(':');
+  uint8_t mins = timemins % 60;
+  if (mins < 10) result->add('0');
+  result->addUint(mins);
+}
+
+// Format the current state into the supplied buffer as a human readable
+// string. Unlike toString() below, this does no heap allocation at all.
+//
+// Args:
+//   buffer: Where to write the description. Always NUL-terminated.
+//   size: Nr. of chars the buffer can hold. (including the NUL)
+void IRDaikinESP::toString(char *buffer, const uint16_t size) {
+  IRStringBuf result(buffer, size);
+  result.add_P(kPowerLabelStr);
+  result.addBool(this->getPower());
+  result.add_P(kModeLabelStr);
+  result.addUint(this->getMode());
   switch (this->getMode()) {
     case kDaikinAuto:
-      result += F(" (AUTO)");
+      result.add_P(kAutoStr);
       break;
     case kDaikinCool:
-      result += F(" (COOL)");
+      result.add_P(kCoolStr);
       break;
     case kDaikinHeat:
-      result += F(" (HEAT)");
+      result.add_P(kHeatStr);
       break;
     case kDaikinDry:
-      result += F(" (DRY)");
+      result.add_P(kDryStr);
       break;
     case kDaikinFan:
-      result += F(" (FAN)");
+      result.add_P(kFanStr);
       break;
     default:
-      result += F(" (UNKNOWN)");
+      result.add_P(kUnknownStr);
   }
-  result += F(", Temp: ");
-  result += uint64ToString(this->getTemp());
-  result += F("C, Fan: ");
-  result += uint64ToString(this->getFan());
+  result.add_P(kTempLabelStr);
+  result.addUint(this->getTemp());
+  result.add_P(kFanLabelStr);
+  result.addUint(this->getFan());
   switch (this->getFan()) {
     case kDaikinFanAuto:
-      result += F(" (AUTO)");
+      result.add_P(kAutoStr);
       break;
     case kDaikinFanQuiet:
-      result += F(" (QUIET)");
+      result.add_P(kQuietStr);
       break;
     case kDaikinFanMin:
-      result += F(" (MIN)");
+      result.add_P(kMinStr);
       break;
     case kDaikinFanMax:
-      result += F(" (MAX)");
+      result.add_P(kMaxStr);
       break;
   }
-  result += F(", Powerful: ");
-  result += this->getPowerful() ? F("On") : F("Off");
-  result += F(", Quiet: ");
-  result += this->getQuiet() ? F("On") : F("Off");
-  result += F(", Sensor: ");
-  result += this->getSensor() ? F("On") : F("Off");
-  result += F(", Eye: ");
-  result += this->getEye() ? F("On") : F("Off");
-  result += F(", Mold: ");
-  result += this->getMold() ? F("On") : F("Off");
-  result += F(", Comfort: ");
-  result += this->getComfort() ? F("On") : F("Off");
-  result += F(", Swing (Horizontal): ");
-  result += this->getSwingHorizontal() ? F("On") : F("Off");
-  result += F(", Swing (Vertical): ");
-  result += this->getSwingVertical() ? F("On") : F("Off");
-  result += F(", Current Time: ");
-  result += this->renderTime(this->getCurrentTime());
-  result += F(", Current Day: ");
+  result.add(", Powerful: ");
+  result.addBool(this->getPowerful());
+  result.add_P(kQuietLabelStr);
+  result.addBool(this->getQuiet());
+  result.add(", Sensor: ");
+  result.addBool(this->getSensor());
+  result.add(", Eye: ");
+  result.addBool(this->getEye());
+  result.add(", Mold: ");
+  result.addBool(this->getMold());
+  result.add(", Comfort: ");
+  result.addBool(this->getComfort());
+  result.add_P(kSwingHLabelStr);
+  result.addBool(this->getSwingHorizontal());
+  result.add_P(kSwingVLabelStr);
+  result.addBool(this->getSwingVertical());
+  result.add(", Current Time: ");
+  renderTimeToBuf(&result, this->getCurrentTime());
+  result.add(", Current Day: ");
   switch (this->getCurrentDay()) {
   case 1:
-    result +=F("SUN"); break;
+    result.add("SUN"); break;
   case 2:
-    result +=F("MON"); break;
+    result.add("MON"); break;
   case 3:
-    result +=F("TUE"); break;
+    result.add("TUE"); break;
   case 4:
-    result +=F("WED"); break;
+    result.add("WED"); break;
   case 5:
-    result +=F("THU"); break;
+    result.add("THU"); break;
   case 6:
-    result +=F("FRI"); break;
+    result.add("FRI"); break;
   case 7:
-    result +=F("SAT"); break;
+    result.add("SAT"); break;
   default:
-    result +=F("(UNKNOWN)"); break;
+    result.add("(UNKNOWN)"); break;
   }
-  result += F(", On Time: ");
+  result.add(", On Time: ");
   if (this->getOnTimerEnabled())
-    result += this->renderTime(this->getOnTime());
+    renderTimeToBuf(&result, this->getOnTime());
   else
-    result += F("Off");
-  result += F(", Off Time: ");
+    result.add_P(kOffStr);
+  result.add(", Off Time: ");
   if (this->getOffTimerEnabled())
-    result += this->renderTime(this->getOffTime());
+    renderTimeToBuf(&result, this->getOffTime());
   else
-    result += F("Off");
-  return result;
+    result.add_P(kOffStr);
+}
+
+// Convert the internal state into a human readable string.
+#ifdef ARDUINO
+String IRDaikinESP::toString(void) {
+#else   // ARDUINO
+std::string IRDaikinESP::toString(void) {
+#endif  // ARDUINO
+  char buffer[256];  // Worst case output is ~237 chars. Sized with margin.
+  toString(buffer, sizeof(buffer));
+  // A single conversion, rather than an allocation per append.
+  return buffer;
 }
 
 // Convert a standard A/C mode into its native mode.
@@ -565,6 +626,16 @@ uint8_t IRDaikinESP::convertFan(const stdAc::fanspeed_t speed) {
   }
 }
 
+#if (DECODE_DAIKIN || DECODE_DAIKIN2 || DECODE_DAIKIN216)
+// Does a running byte sum which included the trailing checksum byte agree
+// with that checksum byte? i.e. Is the checksum the sum of all the other
+// bytes? Used to validate the sections right out of the decode pass,
+// without a second read of the state array.
+static bool validRunningSum(const uint8_t sum, const uint8_t checksum) {
+  return (uint8_t)(sum - checksum) == checksum;
+}
+#endif  // (DECODE_DAIKIN || DECODE_DAIKIN2 || DECODE_DAIKIN216)
+
 #if DECODE_DAIKIN
 // Decode the supplied Daikin A/C message.
 // Args:
@@ -606,6 +677,7 @@ bool IRrecv::decodeDaikin(decode_results *results, const uint16_t nbits,
   // Keep reading bytes until we either run out of section or state to fill.
   const uint8_t kSectionSize[kDaikinSections] = {
       kDaikinSection1Length, kDaikinSection2Length, kDaikinSection3Length};
+  uint8_t sectionSum[kDaikinSections] = {};
   for (uint8_t section = 0, pos = 0; section < kDaikinSections;
        section++) {
     pos += kSectionSize[section];
@@ -621,17 +693,19 @@ bool IRrecv::decodeDaikin(decode_results *results, const uint16_t nbits,
                    kDaikinTolerance, kDaikinMarkExcess)) return false;
 
     // Section Data
-    for (; offset <= results->rawlen - 16 && i < pos;
-         i++, dataBitsSoFar += 8, offset += data_result.used) {
-      // Read in a byte at a time.
-      data_result =
-          matchData(&(results->rawbuf[offset]), 8,
-                    kDaikinBitMark, kDaikinOneSpace,
-                    kDaikinBitMark, kDaikinZeroSpace,
-                    kDaikinTolerance, kDaikinMarkExcess, false);
-      if (data_result.success == false) break;  // Fail
-      results->state[i] = (uint8_t)data_result.data;
-    }
+    // Read the section's bytes in a single pass, summing them as they are
+    // stored so the checksums can be verified without a re-read later.
+    uint16_t matched = matchBytes(&(results->rawbuf[offset]),
+                                  results->state + i,
+                                  results->rawlen - offset,
+                                  (uint16_t)(pos - i),
+                                  kDaikinBitMark, kDaikinOneSpace,
+                                  kDaikinBitMark, kDaikinZeroSpace,
+                                  kDaikinTolerance, kDaikinMarkExcess, false,
+                                  &sectionSum[section]);
+    i += matched;
+    dataBitsSoFar += matched * 8;
+    offset += matched * 16;
   }
 
   // Footer
@@ -644,8 +718,14 @@ bool IRrecv::decodeDaikin(decode_results *results, const uint16_t nbits,
   if (strict) {
     // Re-check we got the correct size/length due to the way we read the data.
     if (dataBitsSoFar != kDaikinBits) return false;
-    // Validate the checksum.
-    if (!IRDaikinESP::validChecksum(results->state)) return false;
+    // Validate the checksums using the sums from the decode pass. Each
+    // section ends in a checksum byte which our running sums include.
+    if (!validRunningSum(sectionSum[0], results->state[kDaikinByteChecksum1]))
+      return false;
+    if (!validRunningSum(sectionSum[1], results->state[kDaikinByteChecksum2]))
+      return false;
+    if (!validRunningSum(sectionSum[2], results->state[kDaikinByteChecksum3]))
+      return false;
   }
 
   // Success
@@ -735,41 +815,21 @@ bool IRDaikin2::validChecksum(uint8_t state[], const uint16_t length) {
 }
 
 // Calculate and set the checksum values for the internal state.
+// Only the sections that changed since the last calculation are resummed.
 void IRDaikin2::checksum() {
-  remote_state[kDaikin2Section1Length - 1] = sumBytes(
-      remote_state, kDaikin2Section1Length - 1);
-  remote_state[kDaikin2StateLength -1 ] = sumBytes(
-      remote_state + kDaikin2Section1Length, kDaikin2Section2Length - 1);
+  if (!_dirty) return;  // Nothing has changed. The checksums are still good.
+  if (_dirty & kDaikinDirtySection1)
+    remote_state[kDaikin2Section1Length - 1] = sumBytes(
+        remote_state, kDaikin2Section1Length - 1);
+  if (_dirty & kDaikinDirtySection2)
+    remote_state[kDaikin2StateLength -1 ] = sumBytes(
+        remote_state + kDaikin2Section1Length, kDaikin2Section2Length - 1);
+  _dirty = 0;
 }
 
 void IRDaikin2::stateReset() {
-  for (uint8_t i = 0; i < kDaikin2StateLength; i++) remote_state[i] = 0x0;
-
-  remote_state[0] = 0x11;
-  remote_state[1] = 0xDA;
-  remote_state[2] = 0x27;
-  remote_state[4] = 0x01;
-  remote_state[6] = 0xC0;
-  remote_state[7] = 0x70;
-  remote_state[8] = 0x08;
-  remote_state[9] = 0x0C;
-  remote_state[10] = 0x80;
-  remote_state[11] = 0x04;
-  remote_state[12] = 0xB0;
-  remote_state[13] = 0x16;
-  remote_state[14] = 0x24;
-  remote_state[17] = 0xBE;
-  remote_state[18] = 0xD0;
-  // remote_state[19] is a checksum byte, it will be set by checksum().
-  remote_state[20] = 0x11;
-  remote_state[21] = 0xDA;
-  remote_state[22] = 0x27;
-  remote_state[25] = 0x08;
-  remote_state[28] = 0xA0;
-  remote_state[35] = 0xC1;
-  remote_state[36] = 0x80;
-  remote_state[37] = 0x60;
-  // remote_state[38] is a checksum byte, it will be set by checksum().
+  _dirty = kDaikinDirtyAll;
+  copyBytes_P(remote_state, kDaikin2KnownGoodState, kDaikin2StateLength);
   disableOnTimer();
   disableOffTimer();
   disableSleepTimer();
@@ -782,16 +842,20 @@ uint8_t *IRDaikin2::getRaw() {
 }
 
 void IRDaikin2::setRaw(const uint8_t new_code[]) {
-  for (uint8_t i = 0; i < kDaikin2StateLength; i++)
-    remote_state[i] = new_code[i];
+  copyBytes(remote_state, new_code, kDaikin2StateLength);
+  _dirty = kDaikinDirtyAll;
 }
 
 void IRDaikin2::on() {
+  // Power touches bytes 6 & 25. i.e. Both sections.
+  _dirty |= kDaikinDirtySection1 | kDaikinDirtySection2;
   remote_state[25] |= kDaikinBitPower;
   remote_state[6] &= ~kDaikin2BitPower;
 }
 
 void IRDaikin2::off() {
+  // Power touches bytes 6 & 25. i.e. Both sections.
+  _dirty |= kDaikinDirtySection1 | kDaikinDirtySection2;
   remote_state[25] &= ~kDaikinBitPower;
   remote_state[6] |= kDaikin2BitPower;
 }
@@ -811,6 +875,7 @@ bool IRDaikin2::getPower() {
 uint8_t IRDaikin2::getMode() { return remote_state[25] >> 4; }
 
 void IRDaikin2::setMode(const uint8_t desired_mode) {
+  _dirty |= kDaikinDirtySection2;
   uint8_t mode = desired_mode;
   switch (mode) {
     case kDaikinCool:
@@ -829,6 +894,7 @@ void IRDaikin2::setMode(const uint8_t desired_mode) {
 
 // Set the temp in deg C
 void IRDaikin2::setTemp(const uint8_t desired) {
+  _dirty |= kDaikinDirtySection2;
   // The A/C has a different min temp if in cool mode.
   uint8_t temp = std::max(
       (this->getMode() == kDaikinCool) ? kDaikin2MinCoolTemp : kDaikinMinTemp,
@@ -839,6 +905,7 @@ void IRDaikin2::setTemp(const uint8_t desired) {
 
 // Set the speed of the fan, 1-5 or kDaikinFanAuto or kDaikinFanQuiet
 void IRDaikin2::setFan(const uint8_t fan) {
+  _dirty |= kDaikinDirtySection2;
   // Set the fan speed bits, leave low 4 bits alone
   uint8_t fanset;
   if (fan == kDaikinFanQuiet || fan == kDaikinFanAuto)
@@ -860,6 +927,7 @@ uint8_t IRDaikin2::getFan() {
 uint8_t IRDaikin2::getTemp() { return remote_state[26] / 2; }
 
 void IRDaikin2::setSwingVertical(const uint8_t position) {
+  _dirty |= kDaikinDirtySection1;
   switch (position) {
     case kDaikin2SwingVHigh:
     case 2:
@@ -878,12 +946,14 @@ void IRDaikin2::setSwingVertical(const uint8_t position) {
 uint8_t IRDaikin2::getSwingVertical() { return remote_state[18] & 0x0F; }
 
 void IRDaikin2::setSwingHorizontal(const uint8_t position) {
+  _dirty |= kDaikinDirtySection1;
   remote_state[17] = position;
 }
 
 uint8_t IRDaikin2::getSwingHorizontal() { return remote_state[17]; }
 
 void IRDaikin2::setCurrentTime(const uint16_t numMins) {
+  _dirty |= kDaikinDirtySection1;
   uint16_t mins = numMins;
   if (numMins > 24 * 60) mins = 0;  // If > 23:59, set to 00:00
   remote_state[5] = (uint8_t)(mins & 0xFF);
@@ -899,6 +969,7 @@ uint16_t IRDaikin2::getCurrentTime() {
 // starttime: Number of minutes after midnight.
 // Note: Timer location is shared with sleep timer.
 void IRDaikin2::enableOnTimer(const uint16_t starttime) {
+  _dirty |= kDaikinDirtySection2;
   clearSleepTimerFlag();
   remote_state[25] |= kDaikinBitOnTimer;  // Set the On Timer flag.
   remote_state[30] = (uint8_t)(starttime & 0xFF);
@@ -908,6 +979,7 @@ void IRDaikin2::enableOnTimer(const uint16_t starttime) {
 }
 
 void IRDaikin2::clearOnTimerFlag() {
+  _dirty |= kDaikinDirtySection2;
   remote_state[25] &= ~kDaikinBitOnTimer;
 }
 
@@ -927,6 +999,7 @@ bool IRDaikin2::getOnTimerEnabled() {
 
 // endtime: Number of minutes after midnight.
 void IRDaikin2::enableOffTimer(const uint16_t endtime) {
+  _dirty |= kDaikinDirtySection2;
   remote_state[25] |= kDaikinBitOffTimer;  // Set the Off Timer flag.
   remote_state[32] = (uint8_t)((endtime >> 4) & 0xFF);
   remote_state[31] &= 0x0F;
@@ -934,6 +1007,7 @@ void IRDaikin2::enableOffTimer(const uint16_t endtime) {
 }
 
 void IRDaikin2::disableOffTimer() {
+  _dirty |= kDaikinDirtySection2;
   enableOffTimer(kDaikinUnusedTime);
   remote_state[25] &= ~kDaikinBitOffTimer;  // Clear the Off Timer flag.
 }
@@ -951,6 +1025,7 @@ uint8_t IRDaikin2::getBeep() {
 }
 
 void IRDaikin2::setBeep(const uint8_t beep) {
+  _dirty |= kDaikinDirtySection1;
   remote_state[7] &= ~kDaikin2BeepMask;
   remote_state[7] |= ((beep << 6) & kDaikin2BeepMask);
 }
@@ -960,11 +1035,13 @@ uint8_t IRDaikin2::getLight() {
 }
 
 void IRDaikin2::setLight(const uint8_t light) {
+  _dirty |= kDaikinDirtySection1;
   remote_state[7] &= ~kDaikin2LightMask;
   remote_state[7] |= ((light << 4) & kDaikin2LightMask);
 }
 
 void IRDaikin2::setMold(const bool on) {
+  _dirty |= kDaikinDirtySection1;
   if (on)
     remote_state[8] |= kDaikin2BitMold;
   else
@@ -977,6 +1054,7 @@ bool IRDaikin2::getMold() {
 
 // Auto clean setting.
 void IRDaikin2::setClean(const bool on) {
+  _dirty |= kDaikinDirtySection1;
   if (on)
     remote_state[8] |= kDaikin2BitClean;
   else
@@ -989,6 +1067,7 @@ bool IRDaikin2::getClean() {
 
 // Fresh Air settings.
 void IRDaikin2::setFreshAir(const bool on) {
+  _dirty |= kDaikinDirtySection1;
   if (on)
     remote_state[8] |= kDaikin2BitFreshAir;
   else
@@ -1000,6 +1079,7 @@ bool IRDaikin2::getFreshAir() {
 }
 
 void IRDaikin2::setFreshAirHigh(const bool on) {
+  _dirty |= kDaikinDirtySection1;
   if (on)
     remote_state[8] |= kDaikin2BitFreshAirHigh;
   else
@@ -1011,6 +1091,7 @@ bool IRDaikin2::getFreshAirHigh() {
 }
 
 void IRDaikin2::setEyeAuto(bool on) {
+  _dirty |= kDaikinDirtySection1;
   if (on)
     remote_state[13] |= kDaikin2BitEyeAuto;
   else
@@ -1022,6 +1103,7 @@ bool IRDaikin2::getEyeAuto() {
 }
 
 void IRDaikin2::setEye(bool on) {
+  _dirty |= kDaikinDirtySection2;
   if (on)
     remote_state[36] |= kDaikin2BitEye;
   else
@@ -1033,6 +1115,7 @@ bool IRDaikin2::getEye() {
 }
 
 void IRDaikin2::setEcono(bool on) {
+  _dirty |= kDaikinDirtySection2;
   if (on)
     remote_state[36] |= kDaikinBitEcono;
   else
@@ -1046,12 +1129,14 @@ bool IRDaikin2::getEcono() {
 // sleeptime: Number of minutes.
 // Note: Timer location is shared with On Timer.
 void IRDaikin2::enableSleepTimer(const uint16_t sleeptime) {
+  _dirty |= kDaikinDirtySection2;
   enableOnTimer(sleeptime);
   clearOnTimerFlag();
   remote_state[36] |= kDaikin2BitSleepTimer;  // Set the Sleep Timer flag.
 }
 
 void IRDaikin2::clearSleepTimerFlag() {
+  _dirty |= kDaikinDirtySection2;
   remote_state[36] &= ~kDaikin2BitSleepTimer;
 }
 
@@ -1068,6 +1153,7 @@ bool IRDaikin2::getSleepTimerEnabled() {
 }
 
 void IRDaikin2::setQuiet(const bool on) {
+  _dirty |= kDaikinDirtySection2;
   if (on) {
     remote_state[33] |= kDaikinBitSilent;
     // Powerful & Quiet mode being on are mutually exclusive.
@@ -1080,6 +1166,7 @@ void IRDaikin2::setQuiet(const bool on) {
 bool IRDaikin2::getQuiet() { return remote_state[33] & kDaikinBitSilent; }
 
 void IRDaikin2::setPowerful(const bool on) {
+  _dirty |= kDaikinDirtySection2;
   if (on) {
     remote_state[33] |= kDaikinBitPowerful;
     // Powerful & Quiet mode being on are mutually exclusive.
@@ -1092,6 +1179,7 @@ void IRDaikin2::setPowerful(const bool on) {
 bool IRDaikin2::getPowerful() { return remote_state[33] & kDaikinBitPowerful; }
 
 void IRDaikin2::setPurify(const bool on) {
+  _dirty |= kDaikinDirtySection2;
   if (on)
     remote_state[36] |= kDaikin2BitPurify;
   else
@@ -1312,7 +1400,6 @@ bool IRrecv::decodeDaikin2(decode_results *results, uint16_t nbits,
   uint16_t offset = kStartOffset;
   uint16_t dataBitsSoFar = 0;
   uint16_t i = 0;
-  match_result_t data_result;
   uint8_t sectionSize[kDaikin2Sections] = {kDaikin2Section1Length,
                                            kDaikin2Section2Length};
 
@@ -1324,6 +1411,7 @@ bool IRrecv::decodeDaikin2(decode_results *results, uint16_t nbits,
 
   // Sections
   // Keep reading bytes until we either run out of section or state to fill.
+  uint8_t sectionSum[kDaikin2Sections] = {};
   for (uint8_t section = 0, pos = 0; section < kDaikin2Sections;
        section++) {
     pos += sectionSize[section];
@@ -1335,16 +1423,19 @@ bool IRrecv::decodeDaikin2(decode_results *results, uint16_t nbits,
                     kDaikin2Tolerance)) return false;
 
     // Section Data
-    for (; offset <= results->rawlen - 16 && i < pos;
-         i++, dataBitsSoFar += 8, offset += data_result.used) {
-      // Read in a byte at a time.
-      data_result =
-          matchData(&(results->rawbuf[offset]), 8, kDaikin2BitMark,
-                    kDaikin2OneSpace, kDaikin2BitMark,
-                    kDaikin2ZeroSpace, kDaikin2Tolerance, kMarkExcess, false);
-      if (data_result.success == false) break;  // Fail
-      results->state[i] = (uint8_t)data_result.data;
-    }
+    // Read the section's bytes in a single pass, summing them as they are
+    // stored so the checksums can be verified without a re-read later.
+    uint16_t matched = matchBytes(&(results->rawbuf[offset]),
+                                  results->state + i,
+                                  results->rawlen - offset,
+                                  (uint16_t)(pos - i),
+                                  kDaikin2BitMark, kDaikin2OneSpace,
+                                  kDaikin2BitMark, kDaikin2ZeroSpace,
+                                  kDaikin2Tolerance, kMarkExcess, false,
+                                  &sectionSum[section]);
+    i += matched;
+    dataBitsSoFar += matched * 8;
+    offset += matched * 16;
 
     // Section Footer
     if (!matchMark(results->rawbuf[offset++], kDaikin2BitMark,
@@ -1363,8 +1454,14 @@ bool IRrecv::decodeDaikin2(decode_results *results, uint16_t nbits,
   if (strict) {
     // Re-check we got the correct size/length due to the way we read the data.
     if (dataBitsSoFar != kDaikin2Bits) return false;
-    // Validate the checksum.
-    if (!IRDaikin2::validChecksum(results->state)) return false;
+    // Validate the checksums using the sums from the decode pass. Each
+    // section ends in a checksum byte which our running sums include.
+    if (!validRunningSum(sectionSum[0],
+                         results->state[kDaikin2Section1Length - 1]))
+      return false;
+    if (!validRunningSum(sectionSum[1],
+                         results->state[kDaikin2StateLength - 1]))
+      return false;
   }
 
   // Success
@@ -1463,17 +1560,7 @@ void IRDaikin216::checksum() {
 }
 
 void IRDaikin216::stateReset() {
-  for (uint8_t i = 0; i < kDaikin216StateLength; i++) remote_state[i] = 0x00;
-  remote_state[0] =  0x11;
-  remote_state[1] =  0xDA;
-  remote_state[2] =  0x27;
-  remote_state[3] =  0xF0;
-  // remote_state[7] is a checksum byte, it will be set by checksum().
-  remote_state[8] =  0x11;
-  remote_state[9] =  0xDA;
-  remote_state[10] = 0x27;
-  remote_state[23] = 0xC0;
-  // remote_state[26] is a checksum byte, it will be set by checksum().
+  copyBytes_P(remote_state, kDaikin216KnownGoodState, kDaikin216StateLength);
 }
 
 uint8_t *IRDaikin216::getRaw() {
@@ -1482,8 +1569,7 @@ uint8_t *IRDaikin216::getRaw() {
 }
 
 void IRDaikin216::setRaw(const uint8_t new_code[]) {
-  for (uint8_t i = 0; i < kDaikin216StateLength; i++)
-    remote_state[i] = new_code[i];
+  copyBytes(remote_state, new_code, kDaikin216StateLength);
 }
 
 
@@ -1711,12 +1797,12 @@ bool IRrecv::decodeDaikin216(decode_results *results, const uint16_t nbits,
   uint16_t offset = kStartOffset;
   uint16_t dataBitsSoFar = 0;
   uint16_t i = 0;
-  match_result_t data_result;
   uint8_t sectionSize[kDaikin216Sections] = {kDaikin216Section1Length,
                                              kDaikin216Section2Length};
 
   // Sections
   // Keep reading bytes until we either run out of section or state to fill.
+  uint8_t sectionSum[kDaikin216Sections] = {};
   for (uint8_t section = 0, pos = 0; section < kDaikin216Sections;
        section++) {
     pos += sectionSize[section];
@@ -1727,17 +1813,19 @@ bool IRrecv::decodeDaikin216(decode_results *results, const uint16_t nbits,
       return false;
 
     // Section Data
-    for (; offset <= results->rawlen - 16 && i < pos;
-         i++, dataBitsSoFar += 8, offset += data_result.used) {
-      // Read in a byte at a time.
-      data_result =
-          matchData(&(results->rawbuf[offset]), 8, kDaikin216BitMark,
-                    kDaikin216OneSpace, kDaikin216BitMark,
-                    kDaikin216ZeroSpace, kDaikinTolerance, kDaikinMarkExcess,
-                    false);
-      if (data_result.success == false) break;  // Fail
-      results->state[i] = (uint8_t)data_result.data;
-    }
+    // Read the section's bytes in a single pass, summing them as they are
+    // stored so the checksums can be verified without a re-read later.
+    uint16_t matched = matchBytes(&(results->rawbuf[offset]),
+                                  results->state + i,
+                                  results->rawlen - offset,
+                                  (uint16_t)(pos - i),
+                                  kDaikin216BitMark, kDaikin216OneSpace,
+                                  kDaikin216BitMark, kDaikin216ZeroSpace,
+                                  kDaikinTolerance, kDaikinMarkExcess, false,
+                                  &sectionSum[section]);
+    i += matched;
+    dataBitsSoFar += matched * 8;
+    offset += matched * 16;
 
     // Section Footer
     if (!matchMark(results->rawbuf[offset++], kDaikin216BitMark,
@@ -1754,8 +1842,14 @@ bool IRrecv::decodeDaikin216(decode_results *results, const uint16_t nbits,
   if (strict) {
     // Re-check we got the correct size/length due to the way we read the data.
     if (dataBitsSoFar != kDaikin216Bits) return false;
-    // Validate the checksum.
-    if (!IRDaikin216::validChecksum(results->state)) return false;
+    // Validate the checksums using the sums from the decode pass. Each
+    // section ends in a checksum byte which our running sums include.
+    if (!validRunningSum(sectionSum[0],
+                         results->state[kDaikin216Section1Length - 1]))
+      return false;
+    if (!validRunningSum(sectionSum[1],
+                         results->state[kDaikin216StateLength - 1]))
+      return false;
   }
 
   // Success
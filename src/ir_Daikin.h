@@ -98,6 +98,12 @@ const uint8_t kDaikinSection1Length = 8;
 const uint8_t kDaikinSection2Length = 8;
 const uint8_t kDaikinSection3Length =
     kDaikinStateLength - kDaikinSection1Length - kDaikinSection2Length;
+// Bits of the _dirty masks, one per independently checksummed section of
+// the state. Used by both IRDaikinESP & IRDaikin2.
+const uint8_t kDaikinDirtySection1 = 0b001;
+const uint8_t kDaikinDirtySection2 = 0b010;
+const uint8_t kDaikinDirtySection3 = 0b100;
+const uint8_t kDaikinDirtyAll = 0b111;
 const uint8_t kDaikinByteComfort = 6;
 const uint8_t kDaikinByteChecksum1 = 7;
 const uint8_t kDaikinBitComfort = 0b00010000;
@@ -225,12 +231,22 @@ const uint8_t kDaikin216BytePowerful = 21;
 #define DAIKIN_FAN_AUTO kDaikinFanAuto
 #define DAIKIN_FAN_QUIET kDaikinFanQuiet
 
+// The default (reset) state: the three frame headers & constant bytes,
+// with the checksum bytes (7, 15 & 34) left for checksum() to fill in.
+const uint8_t kDaikinKnownGoodState[kDaikinStateLength] PROGMEM = {
+    0x11, 0xDA, 0x27, 0x00, 0xC5, 0x00, 0x00, 0x00,
+    0x11, 0xDA, 0x27, 0x00, 0x42, 0x00, 0x00, 0x00,
+    0x11, 0xDA, 0x27, 0x00, 0x00, 0x49, 0x1E, 0x00,
+    0xB0, 0x00, 0x00, 0x06, 0x60, 0x00, 0x00, 0xC0,
+    0x00, 0x00, 0x00};
+
 class IRDaikinESP {
  public:
   explicit IRDaikinESP(uint16_t pin);
 
 #if SEND_DAIKIN
   void send(const uint16_t repeat = kDaikinDefaultRepeat);
+  bool sendDiff(const uint16_t repeat = kDaikinDefaultRepeat);
 #endif
   void begin(void);
   void on(void);
@@ -287,6 +303,7 @@ class IRDaikinESP {
   std::string toString(void);
   static std::string renderTime(const uint16_t timemins);
 #endif
+  void toString(char *buffer, const uint16_t size);
 #ifndef UNIT_TEST
 
  private:
@@ -296,10 +313,24 @@ class IRDaikinESP {
 #endif
   // # of bytes per command
   uint8_t remote[kDaikinStateLength];
+  // Bitmask of the sections changed since the checksums were last calculated.
+  uint8_t _dirty;
+  // The state as it was last transmitted. See sendDiff().
+  uint8_t remote_prev[kDaikinStateLength];
+  bool _prev_valid;
   void stateReset(void);
   void checksum(void);
 };
 
+// The default (reset) state, with the checksum bytes (19 & 38) left for
+// checksum() to fill in.
+const uint8_t kDaikin2KnownGoodState[kDaikin2StateLength] PROGMEM = {
+    0x11, 0xDA, 0x27, 0x00, 0x01, 0x00, 0xC0, 0x70,
+    0x08, 0x0C, 0x80, 0x04, 0xB0, 0x16, 0x24, 0x00,
+    0x00, 0xBE, 0xD0, 0x00, 0x11, 0xDA, 0x27, 0x00,
+    0x00, 0x08, 0x00, 0x00, 0xA0, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xC1, 0x80, 0x60, 0x00};
+
 // Class to emulate a Daikin ARC477A1 remote.
 class IRDaikin2 {
  public:
@@ -388,12 +419,22 @@ class IRDaikin2 {
 #endif
   // # of bytes per command
   uint8_t remote_state[kDaikin2StateLength];
+  // Bitmask of the sections changed since the checksums were last calculated.
+  uint8_t _dirty;
   void stateReset();
   void checksum();
   void clearOnTimerFlag();
   void clearSleepTimerFlag();
 };
 
+// The default (reset) state, with the checksum bytes (7 & 26) left for
+// checksum() to fill in.
+const uint8_t kDaikin216KnownGoodState[kDaikin216StateLength] PROGMEM = {
+    0x11, 0xDA, 0x27, 0xF0, 0x00, 0x00, 0x00, 0x00,
+    0x11, 0xDA, 0x27, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xC0,
+    0x00, 0x00, 0x00};
+
 // Class to emulate a Daikin ARC433B69 remote.
 class IRDaikin216 {
  public:
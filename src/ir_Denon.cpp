@@ -145,4 +145,36 @@ bool IRrecv::decodeDenon(decode_results *results, uint16_t nbits, bool strict) {
   results->decode_type = DENON;
   return true;
 }
+
+// Try every Denon variant over the capture in a single pass.
+//
+// The three variants need very differently sized captures, so the capture
+// length gates which of the underlying matchers get a full attempt, instead
+// of trying each variant (& its internal Sharp/Panasonic/legacy fallbacks)
+// sequentially. Acceptance & precedence are unchanged; a non-Denon capture
+// just stops paying for the impossible variants.
+//
+// Args:
+//   results: Ptr to the data to decode and where to store the decode result.
+// Returns:
+//   boolean: True if it can decode it as any variant, false if it can't.
+bool IRrecv::decodeDenonAll(decode_results *results) {
+  // The 48-bit, Panasonic(Kaseikyo)-style variant. The longest.
+  if (results->rawlen >= 2 * DENON_48_BITS + kHeader + kFooter - 1 &&
+      decodePanasonic(results, DENON_48_BITS, true, kDenonManufacturer)) {
+    results->decode_type = DENON;
+    return true;
+  }
+  // The 15-bit, Sharp-style variant. (Denon leaves the expansion bit clear,
+  // hence expansion=false.)
+  if (results->rawlen >= 2 * DENON_BITS + kFooter - 1 &&
+      decodeSharp(results, DENON_BITS, true, false)) {
+    results->decode_type = DENON;
+    return true;
+  }
+  // The legacy 14-bit variant. decodeDenon()'s Sharp & Panasonic attempts
+  // reject 14 bits before touching the buffer, so this runs just the legacy
+  // matcher.
+  return decodeDenon(results, kDenonLegacyBits);
+}
 #endif
@@ -38,12 +38,14 @@ const uint16_t kFujitsuAcMinGap = 8100;
 //
 // Status: BETA / Appears to be working.
 //
+static constexpr irtiming_t kFujitsuAcTiming = {
+    kFujitsuAcHdrMark, kFujitsuAcHdrSpace, kFujitsuAcBitMark,
+    kFujitsuAcOneSpace, kFujitsuAcBitMark, kFujitsuAcZeroSpace,
+    kFujitsuAcBitMark, kFujitsuAcMinGap, 38, false, 50};
+
 void IRsend::sendFujitsuAC(unsigned char data[], uint16_t nbytes,
                            uint16_t repeat) {
-  sendGeneric(kFujitsuAcHdrMark, kFujitsuAcHdrSpace, kFujitsuAcBitMark,
-              kFujitsuAcOneSpace, kFujitsuAcBitMark, kFujitsuAcZeroSpace,
-              kFujitsuAcBitMark, kFujitsuAcMinGap, data, nbytes, 38, false,
-              repeat, 50);
+  sendGeneric(kFujitsuAcTiming, data, nbytes, repeat);
 }
 #endif  // SEND_FUJITSU_AC
 
@@ -53,10 +55,13 @@ void IRsend::sendFujitsuAC(unsigned char data[], uint16_t nbytes,
 IRFujitsuAC::IRFujitsuAC(uint16_t pin, fujitsu_ac_remote_model_t model)
     : _irsend(pin) {
   setModel(model);
+  _prev_valid = false;  // Nothing has been transmitted yet.
+  _dirty = true;  // No state has been built yet.
   stateReset();
 }
 
 void IRFujitsuAC::setModel(fujitsu_ac_remote_model_t model) {
+  if (_model != model) _dirty = true;  // Model affects bytes 5 & 14 & length.
   _model = model;
   switch (model) {
     case ARDB1:
@@ -76,6 +81,7 @@ void IRFujitsuAC::stateReset() {
   _mode = kFujitsuAcModeCool;
   _swingMode = kFujitsuAcSwingBoth;
   _cmd = kFujitsuAcCmdTurnOn;
+  _dirty = true;
   buildState();
 }
 
@@ -86,11 +92,45 @@ void IRFujitsuAC::begin() { _irsend.begin(); }
 // Send the current desired state to the IR LED.
 void IRFujitsuAC::send(const uint16_t repeat) {
   getRaw();
-  _irsend.sendFujitsuAC(remote_state, getStateLength(), repeat);
+  uint8_t length = getStateLength();
+  _irsend.sendFujitsuAC(remote_state, length, repeat);
+  // Remember what we sent, for sendDiff().
+  copyBytes(remote_prev, remote_state, kFujitsuAcStateLength);
+  _prev_length = length;
+  _prev_valid = true;
+}
+
+// Send the current state only if it differs from the last transmitted one.
+// The protocol already sends its minimal frame - the short message form -
+// for the momentary commands (off & vane stepping), so the remaining
+// saving is not re-sending an unchanged settings frame at all. Momentary
+// commands are always transmitted, as repeating them isn't redundant.
+// Use send() instead if the unit needs an unconditional keep-alive.
+//
+// Args:
+//   repeat: Nr. of times the message will be repeated, if it is sent.
+// Returns:
+//   A boolean indicating if anything was actually transmitted.
+bool IRFujitsuAC::sendDiff(const uint16_t repeat) {
+  // Vane steps move the vane every time. Never skip them.
+  if (_cmd != kFujitsuAcCmdStepHoriz && _cmd != kFujitsuAcCmdStepVert) {
+    getRaw();
+    if (_prev_valid && getStateLength() == _prev_length) {
+      uint8_t i = 0;
+      while (i < _prev_length && remote_state[i] == remote_prev[i]) i++;
+      if (i >= _prev_length) return false;  // Nothing changed. Skip it.
+    }
+  }
+  send(repeat);
+  return true;
 }
 #endif  // SEND_FUJITSU_AC
 
+// Rebuild remote_state[] from the current settings, but only if a setting
+// has actually changed since the last rebuild. Repeated sends of an
+// unchanged state get the cached buffer back for free.
 void IRFujitsuAC::buildState() {
+  if (!_dirty) return;  // The cached state is still current.
   remote_state[0] = 0x14;
   remote_state[1] = 0x63;
   remote_state[2] = 0x00;
@@ -156,15 +196,22 @@ void IRFujitsuAC::buildState() {
     for (uint8_t i = _state_length_short; i < kFujitsuAcStateLength; i++)
       remote_state[i] = 0;
   }
+  _dirty = false;
 }
 
+// Nr. of bytes the current settings will occupy on the wire. The momentary
+// commands (off & vane stepping) always go out as the short frame, which is
+// less than half the airtime of a full settings frame. Decided straight from
+// the command, so this doesn't force a state rebuild.
 uint8_t IRFujitsuAC::getStateLength() {
-  buildState();  // Force an update of the internal state.
-  if ((_model == ARRAH2E && remote_state[5] != 0xFE) ||
-      (_model == ARDB1 && remote_state[5] != 0xFC))
-    return _state_length_short;
-  else
-    return _state_length;
+  switch (_cmd) {
+    case kFujitsuAcCmdTurnOff:
+    case kFujitsuAcCmdStepHoriz:
+    case kFujitsuAcCmdStepVert:
+      return _state_length_short;
+    default:
+      return _state_length;
+  }
 }
 
 // Return a pointer to the internal state date of the remote.
@@ -216,40 +263,34 @@ bool IRFujitsuAC::setRaw(const uint8_t newState[], const uint16_t length) {
       remote_state[i] = 0;
   }
   buildFromState(length);
+  _dirty = true;  // Make getRaw() re-canonicalise the supplied state.
   return true;
 }
 
 // Set the requested power state of the A/C to off.
-void IRFujitsuAC::off() { _cmd = kFujitsuAcCmdTurnOff; }
+void IRFujitsuAC::off() { setCmd(kFujitsuAcCmdTurnOff); }
 
-void IRFujitsuAC::stepHoriz() {
-  switch (_model) {
-    case ARDB1:
-      break;  // This remote doesn't have a horizontal option.
-    default:
-      _cmd = kFujitsuAcCmdStepHoriz;
-  }
-}
+void IRFujitsuAC::stepHoriz() { setCmd(kFujitsuAcCmdStepHoriz); }
 
-void IRFujitsuAC::stepVert() { _cmd = kFujitsuAcCmdStepVert; }
+void IRFujitsuAC::stepVert() { setCmd(kFujitsuAcCmdStepVert); }
 
 // Set the requested command of the A/C.
 void IRFujitsuAC::setCmd(uint8_t cmd) {
   switch (cmd) {
+    case kFujitsuAcCmdStepHoriz:
+      if (_model == ARDB1) return;  // AR-DB1 doesn't have step horizontal.
+      // FALLTHRU
     case kFujitsuAcCmdTurnOff:
     case kFujitsuAcCmdTurnOn:
     case kFujitsuAcCmdStayOn:
     case kFujitsuAcCmdStepVert:
-      _cmd = cmd;
       break;
-    case kFujitsuAcCmdStepHoriz:
-      if (_model != ARDB1)  // AR-DB1 remote doesn't have step horizontal.
-        _cmd = cmd;
-      // FALLTHRU
     default:
-      _cmd = kFujitsuAcCmdStayOn;
+      cmd = kFujitsuAcCmdStayOn;
       break;
   }
+  if (_cmd != cmd) _dirty = true;
+  _cmd = cmd;
 }
 
 uint8_t IRFujitsuAC::getCmd() { return _cmd; }
@@ -260,6 +301,7 @@ bool IRFujitsuAC::getPower() { return _cmd != kFujitsuAcCmdTurnOff; }
 void IRFujitsuAC::setTemp(uint8_t temp) {
   temp = std::max((uint8_t)kFujitsuAcMinTemp, temp);
   temp = std::min((uint8_t)kFujitsuAcMaxTemp, temp);
+  if (_temp != temp) _dirty = true;
   _temp = temp;
 }
 
@@ -269,6 +311,7 @@ uint8_t IRFujitsuAC::getTemp() { return _temp; }
 void IRFujitsuAC::setFanSpeed(uint8_t fanSpeed) {
   if (fanSpeed > kFujitsuAcFanQuiet)
     fanSpeed = kFujitsuAcFanHigh;  // Set the fan to maximum if out of range.
+  if (_fanSpeed != fanSpeed) _dirty = true;
   _fanSpeed = fanSpeed;
 }
 uint8_t IRFujitsuAC::getFanSpeed() { return _fanSpeed; }
@@ -277,6 +320,7 @@ uint8_t IRFujitsuAC::getFanSpeed() { return _fanSpeed; }
 void IRFujitsuAC::setMode(uint8_t mode) {
   if (mode > kFujitsuAcModeHeat)
     mode = kFujitsuAcModeHeat;  // Set the mode to maximum if out of range.
+  if (_mode != mode) _dirty = true;
   _mode = mode;
 }
 
@@ -294,6 +338,7 @@ void IRFujitsuAC::setSwing(uint8_t swingMode) {
       // Set the mode to max if out of range
       if (swingMode > kFujitsuAcSwingBoth) swingMode = kFujitsuAcSwingBoth;
   }
+  if (_swingMode != swingMode) _dirty = true;
   _swingMode = swingMode;
 }
 
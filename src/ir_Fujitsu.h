@@ -69,11 +69,6 @@ const uint8_t kFujitsuAcSwingBoth = 0x03;
 #define FUJITSU_AC_SWING_HORIZ kFujitsuAcSwingHoriz
 #define FUJITSU_AC_SWING_BOTH kFujitsuAcSwingBoth
 
-enum fujitsu_ac_remote_model_t {
-  ARRAH2E = 1,
-  ARDB1,
-};
-
 class IRFujitsuAC {
  public:
   explicit IRFujitsuAC(uint16_t pin, fujitsu_ac_remote_model_t model = ARRAH2E);
@@ -82,6 +77,7 @@ class IRFujitsuAC {
   void stateReset();
 #if SEND_FUJITSU_AC
   void send(const uint16_t repeat = kFujitsuAcMinRepeat);
+  bool sendDiff(const uint16_t repeat = kFujitsuAcMinRepeat);
 #endif  // SEND_FUJITSU_AC
   void begin();
   void off();
@@ -125,6 +121,12 @@ class IRFujitsuAC {
   fujitsu_ac_remote_model_t _model;
   uint8_t _state_length;
   uint8_t _state_length_short;
+  // The state as it was last transmitted. See sendDiff().
+  uint8_t remote_prev[kFujitsuAcStateLength];
+  uint8_t _prev_length;
+  bool _prev_valid;
+  // Does remote_state[] need rebuilding from the settings before use?
+  bool _dirty;
   void buildState();
   void buildFromState(const uint16_t length);
 };
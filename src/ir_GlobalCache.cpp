@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include "IRsend.h"
+#include "IRutils.h"
 
 //   GGG  L       OOOO  BBBB     AA   L       CCCC    AA    CCCC  H    H EEEEEE
 //  G   G L      O    O B   B   AAAA  L      C    C  AAAA  C    C H    H E
@@ -45,6 +46,38 @@ void IRsend::sendGC(uint16_t buf[], uint16_t len) {
   uint32_t periodic_time = calcUSecPeriod(hz, false);
   uint8_t emits =
       std::min(buf[kGlobalCacheRptIndex], (uint16_t)kGlobalCacheMaxRepeat);
+  // Converted-code cache. If it holds this exact code already, replay the
+  // stored microsecond timings & skip the per-element conversion entirely.
+  // Otherwise convert once into the cache, so the next send of the same
+  // code is a straight playback. (See setGCCache())
+  const uint32_t *usecs = NULL;
+  if (_gc_cache_on && len > kGlobalCacheStartIndex) {
+    const uint16_t entries = len - kGlobalCacheStartIndex;
+    uint16_t sum = 0;  // Cheap content check, in case buf[] was edited
+    for (uint16_t i = 0; i < len; i++) sum += buf[i];  // in place.
+    if (_gc_usecs != NULL && _gc_key == buf && _gc_len == len &&
+        _gc_sum == sum) {
+      usecs = _gc_usecs;  // The cache already holds this code.
+    } else {
+      if (_gc_usecs == NULL || _gc_entries < entries) {  // (Re)size it.
+        delete[] _gc_usecs;
+        irMemRecordFree((uint32_t)_gc_entries * sizeof(uint32_t));
+        _gc_usecs = new uint32_t[entries];
+        _gc_entries = (_gc_usecs != NULL) ? entries : 0;
+        irMemRecordAlloc((uint32_t)_gc_entries * sizeof(uint32_t));
+      }
+      if (_gc_usecs != NULL) {  // Convert the code into the cache.
+        for (uint16_t i = 0; i < entries; i++)
+          _gc_usecs[i] =
+              std::max(buf[kGlobalCacheStartIndex + i] * periodic_time,
+                       kGlobalCacheMinUsec);
+        _gc_key = buf;
+        _gc_len = len;
+        _gc_sum = sum;
+        usecs = _gc_usecs;
+      }  // On allocation failure just fall through to converting per send.
+    }
+  }
   // Repeat
   for (uint8_t repeat = 0; repeat < emits; repeat++) {
     // First time through, start at the beginning (kGlobalCacheStartIndex),
@@ -52,11 +85,77 @@ void IRsend::sendGC(uint16_t buf[], uint16_t len) {
     uint16_t offset = kGlobalCacheStartIndex;
     if (repeat) offset += buf[kGlobalCacheRptStartIndex] - 1;
     // Data
+    for (; offset < len; offset++) {
+      uint32_t microseconds;
+      if (usecs != NULL) {  // Already converted. Straight playback.
+        microseconds = usecs[offset - kGlobalCacheStartIndex];
+      } else {
+        // Convert periodic units to microseconds.
+        // Minimum is kGlobalCacheMinUsec for actual GC units.
+        microseconds =
+            std::max(buf[offset] * periodic_time, kGlobalCacheMinUsec);
+      }
+      // These codes start at an odd index (not even as with sendRaw).
+      if (offset & 1)  // Odd bit.
+        mark(microseconds);
+      else  // Even bit.
+        space(microseconds);
+    }
+  }
+  // It's possible that we've ended on a mark(), thus ensure the LED is off.
+  ledOff();
+}
+
+// Enable (or disable & free) the sendGC() converted-code cache.
+// When enabled, sendGC() remembers the microsecond conversion of the last
+// code it sent (keyed on the buffer's address, length & an additive sum of
+// its contents), so replaying a fixed library of GC codes skips the
+// per-element period arithmetic on every send after a code's first.
+// Note: Only sendGC() uses it; sendGC_P() always converts as it reads.
+//
+// Args:
+//   on: Whether the cache is to be enabled. false frees the cache memory.
+//       (Default: true)
+void IRsend::setGCCache(const bool on) {
+  _gc_cache_on = on;
+  if (on) return;
+  delete[] _gc_usecs;
+  irMemRecordFree((uint32_t)_gc_entries * sizeof(uint32_t));
+  _gc_usecs = NULL;
+  _gc_entries = 0;
+  _gc_key = NULL;
+  _gc_len = 0;
+  _gc_sum = 0;
+}
+
+// As sendGC(), but reads the message directly from PROGMEM (flash), so
+// large stored code libraries don't need to be copied into RAM to be sent.
+//
+// Args:
+//   buf: An array of uint16_t's in PROGMEM containing the shortened
+//        GlobalCache data.
+//   len: Nr. of entries in the buf[] array.
+//
+// Status: ALPHA / Should be identical in behaviour to sendGC().
+void IRsend::sendGC_P(const uint16_t buf[], uint16_t len) {
+  uint16_t hz = pgm_read_word(buf + kGlobalCacheFreqIndex);  // Freq is in Hz.
+  enableIROut(hz);
+  uint32_t periodic_time = calcUSecPeriod(hz, false);
+  uint8_t emits = std::min((uint16_t)pgm_read_word(buf + kGlobalCacheRptIndex),
+                           (uint16_t)kGlobalCacheMaxRepeat);
+  // Repeat
+  for (uint8_t repeat = 0; repeat < emits; repeat++) {
+    // First time through, start at the beginning (kGlobalCacheStartIndex),
+    // otherwise for repeats, we start a specified offset from that.
+    uint16_t offset = kGlobalCacheStartIndex;
+    if (repeat) offset += pgm_read_word(buf + kGlobalCacheRptStartIndex) - 1;
+    // Data
     for (; offset < len; offset++) {
       // Convert periodic units to microseconds.
       // Minimum is kGlobalCacheMinUsec for actual GC units.
-      uint32_t microseconds =
-          std::max(buf[offset] * periodic_time, kGlobalCacheMinUsec);
+      uint32_t microseconds = std::max(
+          (uint32_t)pgm_read_word(buf + offset) * periodic_time,
+          kGlobalCacheMinUsec);
       // These codes start at an odd index (not even as with sendRaw).
       if (offset & 1)  // Odd bit.
         mark(microseconds);
@@ -93,12 +93,12 @@ void IRsend::sendGree(uint64_t data, uint16_t nbits, uint16_t repeat) {
 
     // Data
     for (int16_t i = 8; i <= nbits; i += 8) {
-      sendData(kGreeBitMark, kGreeOneSpace, kGreeBitMark, kGreeZeroSpace,
-               (data >> (nbits - i)) & 0xFF, 8, false);
+      sendData<kGreeBitMark, kGreeOneSpace, kGreeBitMark, kGreeZeroSpace,
+               false>((data >> (nbits - i)) & 0xFF, 8);
       if (i == nbits / 2) {
         // Send the mid-message Footer.
-        sendData(kGreeBitMark, kGreeOneSpace, kGreeBitMark, kGreeZeroSpace,
-                 0b010, 3);
+        sendData<kGreeBitMark, kGreeOneSpace, kGreeBitMark, kGreeZeroSpace>(
+            0b010, 3);
         mark(kGreeBitMark);
         space(kGreeMsgSpace);
       }
@@ -110,16 +110,13 @@ void IRsend::sendGree(uint64_t data, uint16_t nbits, uint16_t repeat) {
 }
 #endif  // SEND_GREE
 
-IRGreeAC::IRGreeAC(uint16_t pin) : _irsend(pin) { stateReset(); }
+IRGreeAC::IRGreeAC(uint16_t pin) : _irsend(pin) {
+  _image_valid = false;  // Nothing has been compiled yet.
+  stateReset();
+}
 
 void IRGreeAC::stateReset() {
-  // This resets to a known-good state to Power Off, Fan Auto, Mode Auto, 25C.
-  for (uint8_t i = 0; i < kGreeStateLength; i++) remote_state[i] = 0x0;
-  remote_state[1] = 0x09;
-  remote_state[2] = 0x20;
-  remote_state[3] = 0x50;
-  remote_state[5] = 0x20;
-  remote_state[7] = 0x50;
+  copyBytes_P(remote_state, kGreeKnownGoodState, kGreeStateLength);
 }
 
 void IRGreeAC::fixup() {
@@ -129,9 +126,47 @@ void IRGreeAC::fixup() {
 void IRGreeAC::begin() { _irsend.begin(); }
 
 #if SEND_GREE
+// Compile the current state into one flat pulse train: header, block #1,
+// the mid-frame sync (block footer bits & the long sync gap), block #2 &
+// the trailing gap. Byte data goes out LSB first, as per sendGree().
+void IRGreeAC::renderImage() {
+  uint16_t len = 0;
+  _image[len++] = kGreeHdrMark;
+  _image[len++] = kGreeHdrSpace;
+  for (uint8_t i = 0; i < kGreeStateLength; i++) {
+    if (i == kGreeStateLength / 2) {
+      // Mid-frame sync between the two blocks.
+      for (uint8_t bit = 0; bit < kGreeBlockFooterBits; bit++) {
+        _image[len++] = kGreeBitMark;
+        _image[len++] = ((kGreeBlockFooter >> bit) & 1) ? kGreeOneSpace
+                                                        : kGreeZeroSpace;
+      }
+      _image[len++] = kGreeBitMark;
+      _image[len++] = kGreeMsgSpace;
+    }
+    uint8_t databyte = remote_state[i];
+    for (uint8_t bit = 0; bit < 8; bit++, databyte >>= 1) {  // LSB first.
+      _image[len++] = kGreeBitMark;
+      _image[len++] = (databyte & 1) ? kGreeOneSpace : kGreeZeroSpace;
+    }
+  }
+  // Footer
+  _image[len++] = kGreeBitMark;
+  _image[len++] = kGreeMsgSpace;  // i.e. len == kGreeImageEntries.
+  copyBytes(_image_state, remote_state, kGreeStateLength);
+  _image_valid = true;
+}
+
 void IRGreeAC::send(const uint16_t repeat) {
   fixup();  // Ensure correct settings before sending.
-  _irsend.sendGree(remote_state, kGreeStateLength, repeat);
+  // The first send of a given state compiles the whole frame into a flat
+  // pulse train; sends of the same state after that (e.g. a periodic
+  // keep-alive) are pure playback with no per-bit work.
+  if (!_image_valid ||
+      !equalBytes(remote_state, _image_state, kGreeStateLength))
+    renderImage();
+  for (uint16_t r = 0; r <= repeat; r++)
+    _irsend.sendRaw(_image, kGreeImageEntries, 38);
 }
 #endif  // SEND_GREE
 
@@ -141,9 +176,7 @@ uint8_t* IRGreeAC::getRaw() {
 }
 
 void IRGreeAC::setRaw(uint8_t new_code[]) {
-  for (uint8_t i = 0; i < kGreeStateLength; i++) {
-    remote_state[i] = new_code[i];
-  }
+  copyBytes(remote_state, new_code, kGreeStateLength);
 }
 
 void IRGreeAC::checksum(const uint16_t length) {
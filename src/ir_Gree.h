@@ -25,6 +25,11 @@
 //                     GGGGGG RR   RR EEEEEEE EEEEEEE
 
 // Constants
+// Nr. of mark/space entries in a compiled Gree pulse train:
+// header (2) + 64 data bits (128) + 3 mid-frame sync bits (6) +
+// sync mark & gap (2) + footer mark & gap (2).
+const uint16_t kGreeImageEntries = 140;
+
 const uint8_t kGreeAuto = 0;
 const uint8_t kGreeCool = 1;
 const uint8_t kGreeDry = 2;
@@ -82,6 +87,10 @@ const uint8_t kGreeSwingUpAuto = 0b00001011;
 #define GREE_SWING_MIDDLE_AUTO kGreeSwingMiddleAuto
 #define GREE_SWING_UP_AUTO kGreeSwingUpAuto
 
+// A known-good state: Power Off, Fan Auto, Mode Auto, 25C.
+const uint8_t kGreeKnownGoodState[kGreeStateLength] PROGMEM = {
+    0x00, 0x09, 0x20, 0x50, 0x00, 0x20, 0x00, 0x50};
+
 // Classes
 class IRGreeAC {
  public:
@@ -134,6 +143,13 @@ class IRGreeAC {
 #endif  // UNIT_TEST
   // The state of the IR remote in IR code form.
   uint8_t remote_state[kGreeStateLength];
+  // Compiled pulse-train cache for send(). The whole frame - both blocks &
+  // the mid-frame sync gap - is rendered flat once per state, then replayed
+  // on later sends of the same state. See send().
+  uint16_t _image[kGreeImageEntries];
+  uint8_t _image_state[kGreeStateLength];
+  bool _image_valid;
+  void renderImage();
   void checksum(const uint16_t length = kGreeStateLength);
   void fixup();
 };
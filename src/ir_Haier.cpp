@@ -81,12 +81,19 @@ void IRsend::sendHaierACYRW02(unsigned char data[], uint16_t nbytes,
 #endif  // SEND_HAIER_AC_YRW02
 
 // Class for emulating a Haier HSU07-HEA03 remote
-IRHaierAC::IRHaierAC(uint16_t pin) : _irsend(pin) { stateReset(); }
+IRHaierAC::IRHaierAC(uint16_t pin) : _irsend(pin) {
+  _pending_time = -1;  // No deferred clock refresh waiting.
+  stateReset();
+}
 
 void IRHaierAC::begin() { _irsend.begin(); }
 
 #if SEND_HAIER_AC
 void IRHaierAC::send(const uint16_t repeat) {
+  if (_pending_time >= 0) {  // A deferred clock refresh. Stamp it now.
+    setTime(remote_state + 2, _pending_time);
+    _pending_time = -1;
+  }
   checksum();
   _irsend.sendHaierAC(remote_state, kHaierACStateLength, repeat);
 }
@@ -121,9 +128,7 @@ uint8_t* IRHaierAC::getRaw() {
 }
 
 void IRHaierAC::setRaw(uint8_t new_code[]) {
-  for (uint8_t i = 0; i < kHaierACStateLength; i++) {
-    remote_state[i] = new_code[i];
-  }
+  copyBytes(remote_state, new_code, kHaierACStateLength);
 }
 
 void IRHaierAC::setCommand(uint8_t state) {
@@ -278,10 +283,41 @@ void IRHaierAC::cancelTimers() {
   remote_state[3] &= 0b00111111;
 }
 
-void IRHaierAC::setCurrTime(const uint16_t nr_mins) {
+// Set the unit's current time clock.
+// Args:
+//   nr_mins: Nr. of minutes past midnight.
+//   on_send_only: When true, don't touch the message now. The clock is
+//       only stamped in when send() next transmits a real command. This
+//       stops periodic clock refreshes from making the state look changed
+//       to shadow-copy comparisons. (See sameSettings())
+void IRHaierAC::setCurrTime(const uint16_t nr_mins, const bool on_send_only) {
+  if (on_send_only) {
+    _pending_time =
+        (nr_mins > kHaierAcMaxTime) ? kHaierAcMaxTime : nr_mins;
+    return;
+  }
+  _pending_time = -1;  // An immediate set overrides any deferred one.
   setTime(remote_state + 2, nr_mins);
 }
 
+// Compare two Haier A/C states, ignoring the volatile current-time fields
+// & the checksum byte they perturb.
+// i.e. Would the two states command the same settings?
+// Args:
+//   a: Ptr to a kHaierACStateLength byte state.
+//   b: Ptr to another kHaierACStateLength byte state.
+// Returns:
+//   A boolean. true if nothing but the clock (& checksum) differs.
+bool IRHaierAC::sameSettings(const uint8_t a[], const uint8_t b[]) {
+  for (uint8_t i = 0; i < kHaierACStateLength - 1; i++) {
+    uint8_t mask = 0xFF;
+    if (i == 2) mask = 0b11100000;  // Byte 2's low bits are the hours.
+    if (i == 3) mask = 0b11000000;  // Byte 3's low bits are the minutes.
+    if ((a[i] & mask) != (b[i] & mask)) return false;
+  }
+  return true;  // Only the clock (& the checksum in the last byte) differed.
+}
+
 uint8_t IRHaierAC::getSwing() { return (remote_state[2] & 0b11000000) >> 6; }
 
 void IRHaierAC::setSwing(const uint8_t state) {
@@ -537,9 +573,7 @@ uint8_t* IRHaierACYRW02::getRaw() {
 }
 
 void IRHaierACYRW02::setRaw(uint8_t new_code[]) {
-  for (uint8_t i = 0; i < kHaierACYRW02StateLength; i++) {
-    remote_state[i] = new_code[i];
-  }
+  copyBytes(remote_state, new_code, kHaierACYRW02StateLength);
 }
 
 void IRHaierACYRW02::setButton(uint8_t button) {
@@ -217,7 +217,7 @@ class IRHaierAC {
   void cancelTimers();
 
   uint16_t getCurrTime();
-  void setCurrTime(const uint16_t mins);
+  void setCurrTime(const uint16_t mins, const bool on_send_only = false);
 
   uint8_t getSwing();
   void setSwing(const uint8_t state);
@@ -226,6 +226,7 @@ class IRHaierAC {
   void setRaw(uint8_t new_code[]);
   static bool validChecksum(uint8_t state[],
                             const uint16_t length = kHaierACStateLength);
+  static bool sameSettings(const uint8_t a[], const uint8_t b[]);
   uint8_t convertMode(const stdAc::opmode_t mode);
   uint8_t convertFan(const stdAc::fanspeed_t speed);
   uint8_t convertSwingV(const stdAc::swingv_t position);
@@ -245,6 +246,9 @@ class IRHaierAC {
   IRsendTest _irsend;
 #endif
   uint8_t remote_state[kHaierACStateLength];
+  // A clock value to be stamped into the message at send() time.
+  // -1 means there isn't one pending. See setCurrTime().
+  int16_t _pending_time;
   void stateReset();
   void checksum();
   static uint16_t getTime(const uint8_t ptr[]);
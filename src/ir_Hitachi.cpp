@@ -113,20 +113,7 @@ void IRsend::sendHitachiAC2(unsigned char data[], uint16_t nbytes,
 IRHitachiAc::IRHitachiAc(uint16_t pin) : _irsend(pin) { stateReset(); }
 
 void IRHitachiAc::stateReset() {
-  remote_state[0] = 0x80;
-  remote_state[1] = 0x08;
-  remote_state[2] = 0x0C;
-  remote_state[3] = 0x02;
-  remote_state[4] = 0xFD;
-  remote_state[5] = 0x80;
-  remote_state[6] = 0x7F;
-  remote_state[7] = 0x88;
-  remote_state[8] = 0x48;
-  remote_state[9] = 0x10;
-  for (uint8_t i = 10; i < kHitachiAcStateLength; i++) remote_state[i] = 0x00;
-  remote_state[14] = 0x60;
-  remote_state[15] = 0x60;
-  remote_state[24] = 0x80;
+  copyBytes_P(remote_state, kHitachiAcKnownGoodState, kHitachiAcStateLength);
   setTemp(23);
 }
 
@@ -154,8 +141,8 @@ uint8_t *IRHitachiAc::getRaw() {
 }
 
 void IRHitachiAc::setRaw(const uint8_t new_code[], const uint16_t length) {
-  for (uint8_t i = 0; i < length && i < kHitachiAcStateLength; i++)
-    remote_state[i] = new_code[i];
+  copyBytes(remote_state, new_code,
+            std::min(length, (uint16_t)kHitachiAcStateLength));
 }
 
 #if SEND_HITACHI_AC
@@ -360,6 +347,11 @@ std::string IRHitachiAc::toString() {
 #if (DECODE_HITACHI_AC || DECODE_HITACHI_AC1 || DECODE_HITACHI_AC2)
 // Decode the supplied Hitachi A/C message.
 //
+// Serves all three variants (kHitachiAcBits, kHitachiAc1Bits &
+// kHitachiAc2Bits) in a single pass: the frame sizes are far enough apart
+// that the capture length picks the variant, so the capture is only ever
+// matched once no matter which length arrives.
+//
 // Args:
 //   results: Ptr to the data to decode and where to store the decode result.
 //   nbits:   The number of data bits to expect.
@@ -379,7 +371,7 @@ std::string IRHitachiAc::toString() {
 bool IRrecv::decodeHitachiAC(decode_results *results, uint16_t nbits,
                              bool strict) {
   const uint8_t kTolerance = 30;
-  if (results->rawlen < 2 * nbits + kHeader + kFooter - 1)
+  if (results->rawlen < 2 * kHitachiAc1Bits + kHeader + kFooter - 1)
     return false;  // Can't possibly be a valid HitachiAC message.
   if (strict) {
     switch (nbits) {
@@ -391,12 +383,18 @@ bool IRrecv::decodeHitachiAC(decode_results *results, uint16_t nbits,
         return false;  // Not strictly a Hitachi message.
     }
   }
+  // Select the variant: the largest frame the capture could hold.
+  uint16_t expected_nbytes = kHitachiAc1StateLength;
+  if (results->rawlen >= 2 * kHitachiAc2Bits + kHeader + kFooter - 1)
+    expected_nbytes = kHitachiAc2StateLength;
+  else if (results->rawlen >= 2 * kHitachiAcBits + kHeader + kFooter - 1)
+    expected_nbytes = kHitachiAcStateLength;
+
   uint16_t offset = kStartOffset;
   uint16_t dataBitsSoFar = 0;
-  match_result_t data_result;
 
-  // Header
-  if (nbits == kHitachiAc1Bits) {
+  // Header (The 13-byte variant uses a different one.)
+  if (expected_nbytes == kHitachiAc1StateLength) {
     if (!matchMark(results->rawbuf[offset++], kHitachiAc1HdrMark, kTolerance))
       return false;
     if (!matchSpace(results->rawbuf[offset++], kHitachiAc1HdrSpace, kTolerance))
@@ -408,15 +406,17 @@ bool IRrecv::decodeHitachiAC(decode_results *results, uint16_t nbits,
       return false;
   }
   // Data
-  // Keep reading bytes until we either run out of message or state to fill.
-  for (uint16_t i = 0; offset <= results->rawlen - 16 && i < nbits / 8;
-       i++, dataBitsSoFar += 8, offset += data_result.used) {
-    data_result = matchData(&(results->rawbuf[offset]), 8, kHitachiAcBitMark,
-                            kHitachiAcOneSpace, kHitachiAcBitMark,
-                            kHitachiAcZeroSpace, kTolerance);
-    if (data_result.success == false) break;  // Fail
-    results->state[i] = (uint8_t)data_result.data;
-  }
+  // Read as many whole bytes as the message & the state can hold, in a
+  // single pass. Note: This protocol's checksum is over bit-reversed bytes,
+  // so it can't use matchBytes()'s running sum; validChecksum() below still
+  // re-reads the state for that.
+  uint16_t matched = matchBytes(&(results->rawbuf[offset]), results->state,
+                                results->rawlen - offset, expected_nbytes,
+                                kHitachiAcBitMark, kHitachiAcOneSpace,
+                                kHitachiAcBitMark, kHitachiAcZeroSpace,
+                                kTolerance);
+  dataBitsSoFar += matched * 8;
+  offset += matched * 16;
 
   // Footer
   if (!matchMark(results->rawbuf[offset++], kHitachiAcBitMark, kTolerance))
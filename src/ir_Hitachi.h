@@ -31,6 +31,13 @@ const uint8_t kHitachiAcMinTemp = 16;   // 16C
 const uint8_t kHitachiAcMaxTemp = 32;   // 32C
 const uint8_t kHitachiAcAutoTemp = 23;  // 23C
 
+// The default (reset) state.
+const uint8_t kHitachiAcKnownGoodState[kHitachiAcStateLength] PROGMEM = {
+    0x80, 0x08, 0x0C, 0x02, 0xFD, 0x80, 0x7F, 0x88,
+    0x48, 0x10, 0x00, 0x00, 0x00, 0x00, 0x60, 0x60,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x80, 0x00, 0x00, 0x00};
+
 // Classes
 class IRHitachiAc {
  public:
@@ -127,9 +127,7 @@ void IRsend::sendKelvinator(unsigned char data[], uint16_t nbytes,
 IRKelvinatorAC::IRKelvinatorAC(uint16_t pin) : _irsend(pin) { stateReset(); }
 
 void IRKelvinatorAC::stateReset() {
-  for (uint8_t i = 0; i < kKelvinatorStateLength; i++) remote_state[i] = 0x0;
-  remote_state[3] = 0x50;
-  remote_state[11] = 0x70;
+  copyState_P(kKelvinatorKnownGoodState);
 }
 
 void IRKelvinatorAC::begin() { _irsend.begin(); }
@@ -153,11 +151,7 @@ uint8_t *IRKelvinatorAC::getRaw() {
   return remote_state;
 }
 
-void IRKelvinatorAC::setRaw(uint8_t new_code[]) {
-  for (uint8_t i = 0; i < kKelvinatorStateLength; i++) {
-    remote_state[i] = new_code[i];
-  }
-}
+void IRKelvinatorAC::setRaw(uint8_t new_code[]) { copyState(new_code); }
 
 uint8_t IRKelvinatorAC::calcBlockChecksum(const uint8_t *block,
                                           const uint16_t length) {
@@ -172,12 +166,18 @@ uint8_t IRKelvinatorAC::calcBlockChecksum(const uint8_t *block,
 }
 
 // Many Bothans died to bring us this information.
+// Does nothing if no setting has changed since the checksums were last
+// calculated, so steady-state re-sends skip the block sums.
 void IRKelvinatorAC::checksum(const uint16_t length) {
+  if (!_dirty) return;  // Nothing has changed. The checksums are still good.
   // For each command + options block.
   for (uint16_t offset = 0; offset + 7 < length; offset += 8) {
+    // Skip any block whose bytes haven't changed. Its checksum is still good.
+    if (!(_dirty & (1 << (offset / 8)))) continue;
     uint8_t sum = calcBlockChecksum(remote_state + offset);
     remote_state[7 + offset] = (sum << 4) | (remote_state[7 + offset] & 0xFU);
   }
+  _dirty = 0;
 }
 
 // Verify the checksum is valid for a given state.
@@ -197,11 +197,13 @@ bool IRKelvinatorAC::validChecksum(const uint8_t state[],
 }
 
 void IRKelvinatorAC::on() {
+  markAllDirty();  // Writes to both command blocks.
   remote_state[0] |= kKelvinatorPower;
   remote_state[8] = remote_state[0];  // Duplicate to the 2nd command chunk.
 }
 
 void IRKelvinatorAC::off() {
+  markAllDirty();  // Writes to both command blocks.
   remote_state[0] &= ~kKelvinatorPower;
   remote_state[8] = remote_state[0];  // Duplicate to the 2nd command chunk.
 }
@@ -219,8 +221,8 @@ bool IRKelvinatorAC::getPower() {
 
 // Set the temp. in deg C
 void IRKelvinatorAC::setTemp(uint8_t temp) {
-  temp = std::max(kKelvinatorMinTemp, temp);
-  temp = std::min(kKelvinatorMaxTemp, temp);
+  markAllDirty();  // Writes to both command blocks.
+  temp = clampValue(temp, kKelvinatorMinTemp, kKelvinatorMaxTemp);
   remote_state[1] = (remote_state[1] & 0xF0U) | (temp - kKelvinatorMinTemp);
   remote_state[9] = remote_state[1];  // Duplicate to the 2nd command chunk.
 }
@@ -232,6 +234,7 @@ uint8_t IRKelvinatorAC::getTemp() {
 
 // Set the speed of the fan, 0-5, 0 is auto, 1-5 is the speed
 void IRKelvinatorAC::setFan(uint8_t fan) {
+  markAllDirty();  // Writes to both command blocks.
   fan = std::min(kKelvinatorFanMax, fan);  // Bounds check
 
   // Only change things if we need to.
@@ -257,6 +260,7 @@ uint8_t IRKelvinatorAC::getMode() {
 }
 
 void IRKelvinatorAC::setMode(uint8_t mode) {
+  markAllDirty();  // Writes to both command blocks.
   // If we get an unexpected mode, default to AUTO.
   if (mode > kKelvinatorHeat) mode = kKelvinatorAuto;
   remote_state[0] = (remote_state[0] & kKelvinatorModeMask) | mode;
@@ -268,6 +272,7 @@ void IRKelvinatorAC::setMode(uint8_t mode) {
 }
 
 void IRKelvinatorAC::setSwingVertical(bool state) {
+  markAllDirty();  // Writes to both command blocks.
   if (state) {
     remote_state[0] |= kKelvinatorVentSwing;
     remote_state[4] |= kKelvinatorVentSwingV;
@@ -283,6 +288,7 @@ bool IRKelvinatorAC::getSwingVertical() {
 }
 
 void IRKelvinatorAC::setSwingHorizontal(bool state) {
+  markAllDirty();  // Writes to both command blocks.
   if (state) {
     remote_state[0] |= kKelvinatorVentSwing;
     remote_state[4] |= kKelvinatorVentSwingH;
@@ -298,6 +304,7 @@ bool IRKelvinatorAC::getSwingHorizontal() {
 }
 
 void IRKelvinatorAC::setQuiet(bool state) {
+  markDirty(12);  // Quiet lives in the 2nd block only.
   remote_state[12] &= ~kKelvinatorQuiet;
   remote_state[12] |= (state << kKelvinatorQuietOffset);
 }
@@ -307,6 +314,7 @@ bool IRKelvinatorAC::getQuiet() {
 }
 
 void IRKelvinatorAC::setIonFilter(bool state) {
+  markAllDirty();  // Writes to both command blocks.
   remote_state[2] &= ~kKelvinatorIonFilter;
   remote_state[2] |= (state << kKelvinatorIonFilterOffset);
   remote_state[10] = remote_state[2];  // Duplicate to the 2nd command chunk.
@@ -317,6 +325,7 @@ bool IRKelvinatorAC::getIonFilter() {
 }
 
 void IRKelvinatorAC::setLight(bool state) {
+  markAllDirty();  // Writes to both command blocks.
   remote_state[2] &= ~kKelvinatorLight;
   remote_state[2] |= (state << kKelvinatorLightOffset);
   remote_state[10] = remote_state[2];  // Duplicate to the 2nd command chunk.
@@ -328,6 +337,7 @@ bool IRKelvinatorAC::getLight() {
 
 // Note: XFan mode is only valid in Cool or Dry mode.
 void IRKelvinatorAC::setXFan(bool state) {
+  markAllDirty();  // Writes to both command blocks.
   remote_state[2] &= ~kKelvinatorXfan;
   remote_state[2] |= (state << kKelvinatorXfanOffset);
   remote_state[10] = remote_state[2];  // Duplicate to the 2nd command chunk.
@@ -339,6 +349,7 @@ bool IRKelvinatorAC::getXFan() {
 
 // Note: Turbo mode is turned off if the fan speed is changed.
 void IRKelvinatorAC::setTurbo(bool state) {
+  markAllDirty();  // Writes to both command blocks.
   remote_state[2] &= ~kKelvinatorTurbo;
   remote_state[2] |= (state << kKelvinatorTurboOffset);
   remote_state[10] = remote_state[2];  // Duplicate to the 2nd command chunk.
@@ -364,89 +375,75 @@ uint8_t IRKelvinatorAC::convertMode(const stdAc::opmode_t mode) {
   }
 }
 
-// Convert the internal state into a human readable string.
-#ifdef ARDUINO
-String IRKelvinatorAC::toString() {
-  String result = "";
-#else
-std::string IRKelvinatorAC::toString() {
-  std::string result = "";
-#endif  // ARDUINO
-  result.reserve(160);  // Reserve some heap for the string to reduce fragging.
-  result += F("Power: ");
-  if (getPower())
-    result += F("On");
-  else
-    result += F("Off");
-  result += F(", Mode: ");
-  result += uint64ToString(getMode());
+// Format the current state into the supplied buffer as a human readable
+// string. Unlike toString() below, this does no heap allocation at all.
+//
+// Args:
+//   buffer: Where to write the description. Always NUL-terminated.
+//   size: Nr. of chars the buffer can hold. (including the NUL)
+void IRKelvinatorAC::toString(char *buffer, const uint16_t size) {
+  IRStringBuf result(buffer, size);
+  result.add_P(kPowerLabelStr);
+  result.addBool(getPower());
+  result.add_P(kModeLabelStr);
+  result.addUint(getMode());
   switch (getMode()) {
     case kKelvinatorAuto:
-      result += F(" (AUTO)");
+      result.add_P(kAutoStr);
       break;
     case kKelvinatorCool:
-      result += F(" (COOL)");
+      result.add_P(kCoolStr);
       break;
     case kKelvinatorHeat:
-      result += F(" (HEAT)");
+      result.add_P(kHeatStr);
       break;
     case kKelvinatorDry:
-      result += F(" (DRY)");
+      result.add_P(kDryStr);
       break;
     case kKelvinatorFan:
-      result += F(" (FAN)");
+      result.add_P(kFanStr);
       break;
     default:
-      result += F(" (UNKNOWN)");
+      result.add_P(kUnknownStr);
   }
-  result += F(", Temp: ");
-  result += uint64ToString(getTemp());
-  result += F("C, Fan: ");
-  result += uint64ToString(getFan());
+  result.add_P(kTempLabelStr);
+  result.addUint(getTemp());
+  result.add_P(kFanLabelStr);
+  result.addUint(getFan());
   switch (getFan()) {
     case kKelvinatorFanAuto:
-      result += F(" (AUTO)");
+      result.add_P(kAutoStr);
       break;
     case kKelvinatorFanMax:
-      result += F(" (MAX)");
+      result.add_P(kMaxStr);
       break;
   }
-  result += F(", Turbo: ");
-  if (getTurbo())
-    result += F("On");
-  else
-    result += F("Off");
-  result += F(", Quiet: ");
-  if (getQuiet())
-    result += F("On");
-  else
-    result += F("Off");
-  result += F(", XFan: ");
-  if (getXFan())
-    result += F("On");
-  else
-    result += F("Off");
-  result += F(", IonFilter: ");
-  if (getIonFilter())
-    result += F("On");
-  else
-    result += F("Off");
-  result += F(", Light: ");
-  if (getLight())
-    result += F("On");
-  else
-    result += F("Off");
-  result += F(", Swing (Horizontal): ");
-  if (getSwingHorizontal())
-    result += F("On");
-  else
-    result += F("Off");
-  result += F(", Swing (Vertical): ");
-  if (getSwingVertical())
-    result += F("On");
-  else
-    result += F("Off");
-  return result;
+  result.add(", Turbo: ");
+  result.addBool(getTurbo());
+  result.add_P(kQuietLabelStr);
+  result.addBool(getQuiet());
+  result.add(", XFan: ");
+  result.addBool(getXFan());
+  result.add(", IonFilter: ");
+  result.addBool(getIonFilter());
+  result.add(", Light: ");
+  result.addBool(getLight());
+  result.add_P(kSwingHLabelStr);
+  result.addBool(getSwingHorizontal());
+  result.add_P(kSwingVLabelStr);
+  result.addBool(getSwingVertical());
+}
+
+// Convert the internal state into a human readable string.
+#ifdef ARDUINO
+String IRKelvinatorAC::toString() {
+#else
+std::string IRKelvinatorAC::toString() {
+#endif  // ARDUINO
+  char buffer[192];  // Worst case output is ~163 chars. Sized with margin.
+  toString(buffer, sizeof(buffer));
+  // A single conversion, rather than an allocation per append.
+  return buffer;
 }
 
 #if DECODE_KELVINATOR
@@ -462,8 +459,12 @@ std::string IRKelvinatorAC::toString() {
 // Status: ALPHA / Untested.
 bool IRrecv::decodeKelvinator(decode_results *results, uint16_t nbits,
                               bool strict) {
+  // In single-frame-accept mode one frame (self-verified by its own block
+  // checksum below) is enough. (See setSingleFrameAccept())
+  const uint8_t frames = _single_frame ? 1 : 2;
   if (results->rawlen <
-      2 * (nbits + kKelvinatorCmdFooterBits) + (kHeader + kFooter + 1) * 2 - 1)
+      frames * ((nbits + kKelvinatorCmdFooterBits) + (kHeader + kFooter + 1))
+          - 1)
     return false;  // Can't possibly be a valid Kelvinator message.
   if (strict && nbits != kKelvinatorBits)
     return false;  // Not strictly a Kelvinator message.
@@ -474,7 +475,7 @@ bool IRrecv::decodeKelvinator(decode_results *results, uint16_t nbits,
   // There are two messages back-to-back in a full Kelvinator IR message
   // sequence.
   int8_t state_pos = 0;
-  for (uint8_t s = 0; s < 2; s++) {
+  for (uint8_t s = 0; s < frames; s++) {
     match_result_t data_result;
 
     // Header
@@ -540,7 +541,7 @@ bool IRrecv::decodeKelvinator(decode_results *results, uint16_t nbits,
     if (!matchMark(results->rawbuf[offset++],
                    kKelvinatorBitMarkTicks * mark_tick))
       return false;
-    if (s == 0) {
+    if (s + 1 < frames) {
       if (!matchSpace(results->rawbuf[offset++],
                       kKelvinatorGapSpaceTicks * space_tick * 2))
         return false;
@@ -555,9 +556,15 @@ bool IRrecv::decodeKelvinator(decode_results *results, uint16_t nbits,
   // Compliance
   if (strict) {
     // Correct size/length)
-    if (state_pos != kKelvinatorStateLength) return false;
+    if (state_pos != frames * 8) return false;
     // Verify the message's checksum is correct.
-    if (!IRKelvinatorAC::validChecksum(results->state)) return false;
+    if (!IRKelvinatorAC::validChecksum(results->state, state_pos))
+      return false;
+  } else if (frames == 1) {
+    // Single-frame acceptance trades away the second frame, so the one
+    // frame must at least self-verify via its block checksum.
+    if (!IRKelvinatorAC::validChecksum(results->state, state_pos))
+      return false;
   }
 
   // Success
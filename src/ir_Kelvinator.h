@@ -12,6 +12,7 @@
 #else
 #include <string>
 #endif
+#include "IRACstate.h"
 #include "IRremoteESP8266.h"
 #include "IRsend.h"
 #ifdef UNIT_TEST
@@ -126,8 +127,14 @@ const uint8_t kKelvinatorAutoTemp = 25;  // 25C
     b7-4 = checksum of the previous bytes (8-14)
 */
 
+// The default (reset) state. Everything off, but the constant bits set.
+const uint8_t kKelvinatorKnownGoodState[kKelvinatorStateLength] PROGMEM = {
+    0x00, 0x00, 0x00, 0x50, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x70, 0x00, 0x00, 0x00, 0x00};
+
 // Classes
-class IRKelvinatorAC {
+class IRKelvinatorAC
+    : public IRACState<kKelvinatorStateLength, kKelvinatorStateLength / 2> {
  public:
   explicit IRKelvinatorAC(uint16_t pin);
 
@@ -172,6 +179,7 @@ class IRKelvinatorAC {
 #else
   std::string toString();
 #endif
+  void toString(char *buffer, const uint16_t size);
 #ifndef UNIT_TEST
 
  private:
@@ -179,8 +187,6 @@ class IRKelvinatorAC {
 #else
   IRsendTest _irsend;
 #endif
-  // The state of the IR remote in IR code form.
-  uint8_t remote_state[kKelvinatorStateLength];
   void checksum(const uint16_t length = kKelvinatorStateLength);
   void fixup();
 };
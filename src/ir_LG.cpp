@@ -62,9 +62,7 @@ const uint16_t kLg2BitMark = kLg2BitMarkTicks * kLgTick;  // 500
 //  Returns:
 //    A 4-bit checksum.
 uint8_t calcLGChecksum(uint16_t data) {
-  return (((data >> 12) + ((data >> 8) & 0xF) + ((data >> 4) & 0xF) +
-           (data & 0xF)) &
-          0xF);
+  return sumNibbles(data, 4) & 0xF;
 }
 #endif
 
@@ -289,4 +287,22 @@ bool IRrecv::decodeLG(decode_results *results, uint16_t nbits, bool strict) {
   results->address = data >> 20;  // The bits before the command.
   return true;
 }
+
+// Try both LG variants over the capture in a single pass.
+//
+// The 32-bit variant carries a mandatory repeat & thus needs a noticeably
+// longer capture, so a capture too short for it skips that attempt instead
+// of paying a second full match pass. The 28-bit variant keeps its
+// precedence.
+//
+// Args:
+//   results: Ptr to the data to decode and where to store the decode result.
+// Returns:
+//   boolean: True if it can decode it as either variant, false if it can't.
+bool IRrecv::decodeLGAll(decode_results *results) {
+  if (decodeLG(results, kLgBits, true)) return true;
+  if (results->rawlen < 2 * kLg32Bits + 2 * (kHeader + kFooter) - 1)
+    return false;  // Too short to possibly be the 32-bit variant.
+  return decodeLG(results, kLg32Bits, true);
+}
 #endif
@@ -71,6 +71,10 @@ void IRsend::sendLutron(uint64_t data, uint16_t nbits, uint16_t repeat) {
 // Status: ALPHA / Untested.
 //
 // Notes:
+//   Decoding is done in two cheap passes: a prescan divides each entry by
+//   the bit-period once (no per-period tolerance loop), classifying it
+//   into the nr. of identical bits its Run Length encodes, then the value
+//   is assembled from those run lengths with pure shifts & ors.
 //
 // Ref:
 //   https://github.com/markszabo/IRremoteESP8266/issues/515
@@ -86,55 +90,56 @@ bool IRrecv::decodeLutron(decode_results *results, uint16_t nbits,
   int16_t bitsSoFar = -1;
 
   if (nbits > sizeof(data) * 8) return false;  // To large to store the data.
-  for (uint16_t offset = kStartOffset;
-       bitsSoFar < nbits && offset < results->rawlen; offset++) {
-    uint16_t entry = results->rawbuf[offset];
+  // Prescan: classify each entry into how many bit-periods it spans, with
+  // a single integer division per entry. An entry encoding N bits sits
+  // within kLutronDelta below N periods (both polarities), or up to
+  // 2 * kLutronDelta above for a mark. There's never a reason to look at
+  // more entries than could fit the bits (+ a trailing gap).
+  uint8_t *runs = (uint8_t *)scratch(sizeof(data) * 8 + 2);
+  if (runs == NULL) return false;  // Can't happen at the current sizing.
+  const uint16_t max_entries =
+      std::min((uint16_t)(results->rawlen - kStartOffset),
+               (uint16_t)(nbits + 2));
+  uint16_t entries = 0;  // Nr. of entries that classified cleanly.
+  bool clean = true;  // Did the prescan stop at a malformed entry?
+  for (; entries < max_entries; entries++) {
+    uint32_t usecs = results->rawbuf[kStartOffset + entries] * kRawTick;
     // It has to be large enough to qualify as a bit.
-    if (!matchAtLeast(entry, kLutronTick, 0, kLutronDelta)) {
+    if (usecs + kLutronDelta < kLutronTick) {
       DPRINTLN("Entry too small. Aborting.");
-      return false;
+      clean = false;
+      break;
     }
-    // Keep reading bits of the same value until we run out.
-    while (entry != 0 && matchAtLeast(entry, kLutronTick, 0, kLutronDelta)) {
-      bitsSoFar++;
-      DPRINT("Bit: ");
-      DPRINT(bitsSoFar);
-      if (offset % 2) {          // Is Odd?
-        data = (data << 1) + 1;  // Append a '1'.
-        DPRINTLN(" is a 1.");
-      } else {       // Is it Even?
-        data <<= 1;  // Append a '0'.
-        DPRINTLN(" is a 0.");
-        if (bitsSoFar == nbits && matchAtLeast(entry, kLutronGap))
-          break;  // We've likely reached the end of a message.
-      }
-      // Remove a bit length from the current entry.
-      entry = std::max(entry, (uint16_t)(kLutronTick / kRawTick)) -
-              kLutronTick / kRawTick;
-    }
-    if (offset % 2 && !match(entry, kLutronDelta, 0, kLutronDelta)) {
-      DPRINT("offset = ");
-      DPRINTLN(offset);
-      DPRINT("rawlen = ");
-      DPRINTLN(results->rawlen);
-      DPRINT("entry = ");
-      DPRINTLN(entry);
+    uint32_t nr_periods = (usecs + kLutronDelta) / kLutronTick;
+    // A mark with too much left over isn't a clean multiple of the period.
+    // (Spaces absorb their excess into the following/trailing gap.)
+    if ((kStartOffset + entries) % 2 &&
+        usecs > nr_periods * kLutronTick + 2 * kLutronDelta) {
       DPRINTLN("Odd Entry has too much left over. Aborting.");
-      return false;  // Too much left over to be a good value. Reject it.
+      clean = false;
+      break;
     }
-    if (offset % 2 == 0 && offset <= results->rawlen - 1 &&
-        !matchAtLeast(entry, kLutronDelta, 0, kLutronDelta)) {
-      DPRINT("offset = ");
-      DPRINTLN(offset);
-      DPRINT("rawlen = ");
-      DPRINTLN(results->rawlen);
-      DPRINT("entry = ");
-      DPRINTLN(entry);
-      DPRINTLN("Entry has too much left over. Aborting.");
-      return false;  // Too much left over to be a good value. Reject it.
+    runs[entries] = std::min(nr_periods, (uint32_t)UINT8_MAX);
+  }
+
+  // Assemble the value from the run lengths.
+  for (uint16_t i = 0; bitsSoFar < nbits && i < entries; i++) {
+    uint16_t nr_bits = runs[i];
+    if ((kStartOffset + i) % 2) {  // Is Odd? i.e. A run of '1's.
+      data = (data << nr_bits) | ((1ULL << nr_bits) - 1);
+    } else {  // Is it Even? i.e. A run of '0's.
+      if (bitsSoFar + nr_bits >= nbits &&
+          matchAtLeast(results->rawbuf[kStartOffset + i], kLutronGap))
+        // We've likely reached the end of a message. The rest of this
+        // space is the inter-message gap, not data.
+        nr_bits = nbits - bitsSoFar;
+      data <<= nr_bits;
     }
+    bitsSoFar += nr_bits;
   }
 
+  // A malformed entry is only fatal if we still needed bits from it.
+  if (!clean && bitsSoFar < nbits) return false;
   // We got too many bits.
   if (bitsSoFar > nbits || bitsSoFar < 0) {
     DPRINTLN("Wrong number of bits found. Aborting.");
@@ -74,6 +74,11 @@ void IRsend::sendMWM(uint8_t data[], uint16_t nbytes, uint16_t repeat) {
 // This protocol is 2400 bps serial, 1 start bit (mark), 1 stop bit (space), no
 // parity
 //
+// The payload is a byte stream of (nearly) arbitrary length, so it is read
+// byte-at-a-time: each byte is emitted straight into results->state as its
+// framing completes, a framing error aborts without parsing the rest of the
+// buffer, & the message length is bounded only by the state capacity.
+//
 // Args:
 //   results: Ptr to the data to decode and where to store the decode result.
 //   nbits:   The number of data bits to expect.
@@ -94,65 +99,57 @@ bool IRrecv::decodeMWM(decode_results *results, uint16_t nbits, bool strict) {
 
   uint16_t offset = kStartOffset;
   uint16_t used = 0;
-  uint64_t data = 0;
-  uint16_t frame_bits = 0;
   uint16_t data_bits = 0;
+  uint16_t nbytes = 0;
+  bool running = true;
 
   // No Header
 
   // Data
-  uint8_t bits_per_frame = 10;
-  for (; offset < results->rawlen && results->bits < 8 * kStateSizeMax;
-       frame_bits++) {
+  while (running && offset < results->rawlen && nbytes < kStateSizeMax) {
     DPRINT("DEBUG: decodeMWM: offset = ");
     DPRINTLN(offset);
+    // Start bit. (A mark)
     int16_t level = getRClevel(results, &offset, &used, kMWMTick, kMWMTolerance,
                                kMWMExcess, kMWMDelta, kMWMMaxWidth);
-    if (level < 0) {
-      DPRINTLN("DEBUG: decodeMWM: getRClevel returned error");
-      break;
+    if (level < 0) break;  // Ran out of message. e.g. We hit the gap.
+    if (level != kMark) {
+      DPRINTLN("DEBUG: decodeMWM: framing error - invalid start bit");
+      break;  // Stop reading; what we have so far is judged below.
     }
-    switch (frame_bits % bits_per_frame) {
-      case 0:
-        // Start bit
-        if (level != kMark) {
-          DPRINTLN("DEBUG: decodeMWM: framing error - invalid start bit");
-          goto done;
-        }
-        break;
-      case 9:
-        // Stop bit
-        if (level != kSpace) {
-          DPRINTLN("DEBUG: decodeMWM: framing error - invalid stop bit");
-          return false;
-        } else {
-          DPRINT("DEBUG: decodeMWM: data_bits = ");
-          DPRINTLN(data_bits);
-          DPRINT("DEBUG: decodeMWM: Finished byte: ");
-          DPRINTLN(uint64ToString(data));
-          results->state[data_bits / 8 - 1] = data & 0xFF;
-          results->bits = data_bits;
-          data = 0;
-        }
-        break;
-      default:
-        // Data bits
-        DPRINT("DEBUG: decodeMWM: Storing bit: ");
-        DPRINTLN((level == kSpace));
-        // Transmission is LSB-first, space=1
-        data |= ((level == kSpace)) << 8;
-        data >>= 1;
-        data_bits++;
+    // Data bits. (Transmission is LSB-first, space=1)
+    uint8_t byte = 0;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      if (offset >= results->rawlen ||
+          (level = getRClevel(results, &offset, &used, kMWMTick, kMWMTolerance,
+                              kMWMExcess, kMWMDelta, kMWMMaxWidth)) < 0) {
+        running = false;  // Ran out mid-byte. Note: its bits still count.
         break;
+      }
+      byte >>= 1;
+      if (level == kSpace) byte |= 0x80;
+      data_bits++;
+    }
+    if (!running) break;
+    // Stop bit. (A space)
+    if (offset >= results->rawlen ||
+        (level = getRClevel(results, &offset, &used, kMWMTick, kMWMTolerance,
+                            kMWMExcess, kMWMDelta, kMWMMaxWidth)) < 0)
+      break;
+    if (level != kSpace) {
+      DPRINTLN("DEBUG: decodeMWM: framing error - invalid stop bit");
+      return false;
     }
+    // The byte's framing checked out, so emit it.
+    DPRINT("DEBUG: decodeMWM: Finished byte: ");
+    DPRINTLN(uint64ToString(byte));
+    results->state[nbytes++] = byte;
+    results->bits = data_bits;
   }
 
-done:
   // Footer (None)
 
   // Compliance
-  DPRINT("DEBUG: decodeMWM: frame_bits = ");
-  DPRINTLN(frame_bits);
   DPRINT("DEBUG: decodeMWM: data_bits = ");
   DPRINTLN(data_bits);
   if (data_bits < nbits) {
@@ -129,6 +129,17 @@ bool IRrecv::decodeMagiQuest(decode_results *results, uint16_t nbits,
     // The first 8 bits of this protocol are supposed to all be 0.
     // Exit out early as it is never going to match.
     if (strict && bits == 8 && data != 0) return false;
+
+    // Registered-wand filter. The wand ID is everything except the final
+    // 16 magnitude bits, so once it is fully assembled we can drop foreign
+    // wands without decoding the rest of the frame.
+    // See addMagiQuestWand().
+    if (_wands_len > 0 && bits == nbits - 16) {
+      const uint32_t wand_id = data;  // The 8 zero header bits don't fit.
+      uint8_t i = 0;
+      while (i < _wands_len && _wands[i] != wand_id) i++;
+      if (i >= _wands_len) return false;  // Not a wand we care about.
+    }
   }
 
   // Last bit is special as the protocol ends with a SPACE, not a MARK.
@@ -58,10 +58,16 @@ void IRsend::sendMidea(uint64_t data, uint16_t nbits, uint16_t repeat) {
   // Set IR carrier frequency
   enableIROut(38);
 
+  // Precompute the inverted copy once. The protocol follows the payload
+  // with its entire bitwise inverse, & computing that up front beats
+  // flipping `data` back & forth twice per repeat.
+  const uint64_t inverted = ~data;
+
   for (uint16_t r = 0; r <= repeat; r++) {
     // The protcol sends the message, then follows up with an entirely
     // inverted payload.
     for (size_t inner_loop = 0; inner_loop < 2; inner_loop++) {
+      uint64_t source = inner_loop ? inverted : data;
       // Header
       mark(kMideaHdrMark);
       space(kMideaHdrSpace);
@@ -70,18 +76,13 @@ void IRsend::sendMidea(uint64_t data, uint16_t nbits, uint16_t repeat) {
       //   Byte. Each byte then being sent normal, then followed inverted.
       for (uint16_t i = 8; i <= nbits; i += 8) {
         // Grab a bytes worth of data.
-        uint8_t segment = (data >> (nbits - i)) & 0xFF;
-        sendData(kMideaBitMark, kMideaOneSpace, kMideaBitMark, kMideaZeroSpace,
-                 segment, 8, true);
+        uint8_t segment = (source >> (nbits - i)) & 0xFF;
+        sendData<kMideaBitMark, kMideaOneSpace, kMideaBitMark,
+                 kMideaZeroSpace>(segment, 8);
       }
       // Footer
       mark(kMideaBitMark);
       space(kMideaMinGap);  // Pause before repeating
-
-      // Invert the data for the 2nd phase of the message.
-      // As we get called twice in the inner loop, we will always revert
-      // to the original 'data' state.
-      data = ~data;
     }
   }
 }
@@ -382,7 +383,6 @@ bool IRrecv::decodeMidea(decode_results *results, uint16_t nbits, bool strict) {
     return false;  // Can't possibly be a valid MIDEA message.
 
   uint64_t data = 0;
-  uint64_t inverted = 0;
   uint16_t offset = kStartOffset;
 
   if (nbits > sizeof(data) * 8)
@@ -398,17 +398,32 @@ bool IRrecv::decodeMidea(decode_results *results, uint16_t nbits, bool strict) {
     uint32_t s_tick =
         results->rawbuf[offset++] * kRawTick / kMideaHdrSpaceTicks;
 
-    // Data (Normal)
-    match_result_t data_result = matchData(
-        &(results->rawbuf[offset]), nbits, kMideaBitMarkTicks * m_tick,
-        kMideaOneSpaceTicks * s_tick, kMideaBitMarkTicks * m_tick,
-        kMideaZeroSpaceTicks * s_tick, kMideaTolerance);
-    if (data_result.success == false) return false;
-    offset += data_result.used;
-    if (i % 2 == 0)
+    if (i == 0) {
+      // Data (Normal)
+      match_result_t data_result = matchData(
+          &(results->rawbuf[offset]), nbits, kMideaBitMarkTicks * m_tick,
+          kMideaOneSpaceTicks * s_tick, kMideaBitMarkTicks * m_tick,
+          kMideaZeroSpaceTicks * s_tick, kMideaTolerance);
+      if (data_result.success == false) return false;
+      offset += data_result.used;
       data = data_result.data;
-    else
-      inverted = data_result.data;
+    } else {
+      // Data (Inverted). The protocol requires it to be a bitwise inverse
+      // of the first message, so verify it against `data` a byte at a time
+      // as it arrives, rather than assembling all of it & comparing at the
+      // end. A mismatch (i.e. not really a Midea message) thus bails out
+      // up to 7 bytes of match work earlier.
+      for (uint16_t bitsleft = nbits; bitsleft; bitsleft -= 8) {
+        match_result_t data_result = matchData(
+            &(results->rawbuf[offset]), 8, kMideaBitMarkTicks * m_tick,
+            kMideaOneSpaceTicks * s_tick, kMideaBitMarkTicks * m_tick,
+            kMideaZeroSpaceTicks * s_tick, kMideaTolerance);
+        if (data_result.success == false) return false;
+        if ((uint8_t)data_result.data != (uint8_t)~(data >> (bitsleft - 8)))
+          return false;  // Not the inverse of the first message's byte.
+        offset += data_result.used;
+      }
+    }
 
     // Footer
     if (!matchMark(results->rawbuf[offset++], kMideaBitMarkTicks * m_tick,
@@ -422,11 +437,8 @@ bool IRrecv::decodeMidea(decode_results *results, uint16_t nbits, bool strict) {
 
   // Compliance
   if (strict) {
-    // Protocol requires a second message with all the data bits inverted.
-    // We should have checked we got a second message in the previous loop.
-    // Just need to check it's value is an inverted copy of the first message.
-    uint64_t mask = (1ULL << kMideaBits) - 1;
-    if ((data & mask) != ((inverted ^ mask) & mask)) return false;
+    // The second (inverted) message was already verified against the first
+    // as it was matched above. Only the checksum remains.
     if (!IRMideaAC::validChecksum(data)) return false;
   }
 
@@ -420,31 +420,15 @@ bool IRrecv::decodeMitsubishiAC(decode_results *results, uint16_t nbits,
 // Equipment it seems compatible with:
 //  * <Add models (A/C & remotes) you've gotten it working with here>
 // Initialise the object.
-IRMitsubishiAC::IRMitsubishiAC(uint16_t pin) : _irsend(pin) { stateReset(); }
+IRMitsubishiAC::IRMitsubishiAC(uint16_t pin) : _irsend(pin) {
+  _repeat = kMitsubishiACMinRepeat;
+  stateReset();
+}
 
 // Reset the state of the remote to a known good state/sequence.
 void IRMitsubishiAC::stateReset() {
-  // The state of the IR remote in IR code form.
-  // Known good state obtained from:
-  //   https://github.com/r45635/HVAC-IR-Control/blob/master/HVAC_ESP8266/HVAC_ESP8266.ino#L108
-  // Note: Can't use the following because it requires -std=c++11
-  // uint8_t known_good_state[kMitsubishiACStateLength] = {
-  //    0x23, 0xCB, 0x26, 0x01, 0x00, 0x20, 0x08, 0x06, 0x30, 0x45, 0x67, 0x00,
-  //    0x00, 0x00, 0x00, 0x00, 0x00, 0x1F};
-  remote_state[0] = 0x23;
-  remote_state[1] = 0xCB;
-  remote_state[2] = 0x26;
-  remote_state[3] = 0x01;
-  remote_state[4] = 0x00;
-  remote_state[5] = 0x20;
-  remote_state[6] = 0x08;
-  remote_state[7] = 0x06;
-  remote_state[8] = 0x30;
-  remote_state[9] = 0x45;
-  remote_state[10] = 0x67;
-  for (uint8_t i = 11; i < kMitsubishiACStateLength - 1; i++)
-    remote_state[i] = 0;
-  remote_state[kMitsubishiACStateLength - 1] = 0x1F;
+  // See kMitsubishiAcKnownGoodState (ir_Mitsubishi.h) for its provenance.
+  copyState_P(kMitsubishiAcKnownGoodState);
   checksum();  // Calculate the checksum
 }
 
@@ -452,11 +436,24 @@ void IRMitsubishiAC::stateReset() {
 void IRMitsubishiAC::begin() { _irsend.begin(); }
 
 #if SEND_MITSUBISHI_AC
+// Send the current desired state to the IR LED, using the configured repeat
+// count. See setRepeat().
+void IRMitsubishiAC::send() { send(_repeat); }
+
 // Send the current desired state to the IR LED.
 void IRMitsubishiAC::send(const uint16_t repeat) {
   checksum();  // Ensure correct checksum before sending.
   _irsend.sendMitsubishiAC(remote_state, kMitsubishiACStateLength, repeat);
 }
+
+// Set the nr. of extra times send() will transmit the message.
+// The protocol spec calls for the frame to be sent twice
+// (kMitsubishiACMinRepeat, the default). Deployments that verify reception
+// (e.g. close range, dedicated blaster) can set kNoRepeat to halve the
+// transmission & blocking time.
+void IRMitsubishiAC::setRepeat(const uint16_t repeat) { _repeat = repeat; }
+
+uint16_t IRMitsubishiAC::getRepeat() { return _repeat; }
 #endif  // SEND_MITSUBISHI_AC
 
 // Return a pointer to the internal state date of the remote.
@@ -466,36 +463,30 @@ uint8_t *IRMitsubishiAC::getRaw() {
 }
 
 void IRMitsubishiAC::setRaw(uint8_t *data) {
-  for (uint8_t i = 0; i < (kMitsubishiACStateLength - 1); i++) {
-    remote_state[i] = data[i];
-  }
-  checksum();
+  _dirty = true;
+  copyBytes(remote_state, data, kMitsubishiACStateLength - 1);
+  checksum();  // The last byte is the checksum, so just recalculate it.
 }
 
 // Calculate the checksum for the current internal state of the remote.
+// Skipped when no setting has changed since the last calculation.
 void IRMitsubishiAC::checksum() {
+  if (!_dirty) return;  // Nothing has changed. The checksum is still good.
   remote_state[17] = calculateChecksum(remote_state);
+  _dirty = false;
 }
 
 uint8_t IRMitsubishiAC::calculateChecksum(uint8_t *data) {
-  uint8_t sum = 0;
   // Checksum is simple addition of all previous bytes stored
   // as an 8 bit value.
-  for (uint8_t i = 0; i < 17; i++) sum += data[i];
-  return sum & 0xFFU;
+  return sumBytes(data, 17);
 }
 
-// Set the requested power state of the A/C to off.
-void IRMitsubishiAC::on() {
-  // state = ON;
-  remote_state[5] |= kMitsubishiAcPower;
-}
+// Set the requested power state of the A/C to on.
+void IRMitsubishiAC::on() { setBitMask(5, kMitsubishiAcPower, true); }
 
 // Set the requested power state of the A/C to off.
-void IRMitsubishiAC::off() {
-  // state = OFF;
-  remote_state[5] &= ~kMitsubishiAcPower;
-}
+void IRMitsubishiAC::off() { setBitMask(5, kMitsubishiAcPower, false); }
 
 // Set the requested power state of the A/C.
 void IRMitsubishiAC::setPower(bool state) {
@@ -507,13 +498,13 @@ void IRMitsubishiAC::setPower(bool state) {
 
 // Return the requested power state of the A/C.
 bool IRMitsubishiAC::getPower() {
-  return ((remote_state[5] & kMitsubishiAcPower) != 0);
+  return getBitMask(5, kMitsubishiAcPower);
 }
 
 // Set the temp. in deg C
 void IRMitsubishiAC::setTemp(uint8_t temp) {
-  temp = std::max((uint8_t)kMitsubishiAcMinTemp, temp);
-  temp = std::min((uint8_t)kMitsubishiAcMaxTemp, temp);
+  _dirty = true;
+  temp = clampValue(temp, kMitsubishiAcMinTemp, kMitsubishiAcMaxTemp);
   remote_state[7] = temp - kMitsubishiAcMinTemp;
 }
 
@@ -525,6 +516,7 @@ uint8_t IRMitsubishiAC::getTemp() {
 // Set the speed of the fan, 0-6.
 // 0 is auto, 1-5 is the speed, 6 is silent.
 void IRMitsubishiAC::setFan(uint8_t fan) {
+  _dirty = true;
   // Bounds check
   if (fan > kMitsubishiAcFanSilent)
     fan = kMitsubishiAcFanMax;        // Set the fan to maximum if out of range.
@@ -550,6 +542,7 @@ uint8_t IRMitsubishiAC::getMode() { return (remote_state[6]); }
 
 // Set the requested climate operation mode of the a/c unit.
 void IRMitsubishiAC::setMode(uint8_t mode) {
+  _dirty = true;
   // If we get an unexpected mode, default to AUTO.
   switch (mode) {
     case kMitsubishiAcAuto:
@@ -573,6 +566,7 @@ void IRMitsubishiAC::setMode(uint8_t mode) {
 
 // Set the requested vane operation mode of the a/c unit.
 void IRMitsubishiAC::setVane(uint8_t mode) {
+  _dirty = true;
   mode = std::min(mode, (uint8_t)0b111);  // bounds check
   mode |= 0b1000;
   mode <<= 3;
@@ -589,19 +583,28 @@ uint8_t IRMitsubishiAC::getVane() {
 uint8_t IRMitsubishiAC::getClock() { return remote_state[10]; }
 
 // Set the current time. 1 = 1/6 hour. e.g. 6am = 36.
-void IRMitsubishiAC::setClock(uint8_t clock) { remote_state[10] = clock; }
+void IRMitsubishiAC::setClock(uint8_t clock) {
+  _dirty = true;
+  remote_state[10] = clock;
+}
 
 // Return the desired start time. 1 = 1/6 hour. e.g. 1am = 6
 uint8_t IRMitsubishiAC::getStartClock() { return remote_state[12]; }
 
 // Set the desired start tiem of the AC.  1 = 1/6 hour. e.g. 8pm = 120
-void IRMitsubishiAC::setStartClock(uint8_t clock) { remote_state[12] = clock; }
+void IRMitsubishiAC::setStartClock(uint8_t clock) {
+  _dirty = true;
+  remote_state[12] = clock;
+}
 
 // Return the desired stop time of the AC. 1 = 1/6 hour. e.g 10pm = 132
 uint8_t IRMitsubishiAC::getStopClock() { return remote_state[11]; }
 
 // Set the desired stop time of the AC. 1 = 1/6 hour. e.g 10pm = 132
-void IRMitsubishiAC::setStopClock(uint8_t clock) { remote_state[11] = clock; }
+void IRMitsubishiAC::setStopClock(uint8_t clock) {
+  _dirty = true;
+  remote_state[11] = clock;
+}
 
 // Return the timer setting. Possible values: kMitsubishiAcNoTimer,
 //  kMitsubishiAcStartTimer, kMitsubishiAcStopTimer,
@@ -612,6 +615,7 @@ uint8_t IRMitsubishiAC::getTimer() { return remote_state[13] & 0b111; }
 //  kMitsubishiAcStartTimer, kMitsubishiAcStopTimer,
 //  kMitsubishiAcStartStopTimer
 void IRMitsubishiAC::setTimer(uint8_t timer) {
+  _dirty = true;
   remote_state[13] = timer & 0b111;
 }
 
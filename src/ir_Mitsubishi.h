@@ -10,6 +10,7 @@
 #else
 #include <string>
 #endif
+#include "IRACstate.h"
 #include "IRremoteESP8266.h"
 #include "IRsend.h"
 #ifdef UNIT_TEST
@@ -59,7 +60,13 @@ const uint8_t kMitsubishiAcStartStopTimer = 7;
 #define MITSUBISHI_AC_COOL kMitsubishiAcCool
 #define MITSUBISHI_AC_AUTO kMitsubishiAcAuto
 
-class IRMitsubishiAC {
+// Known good state obtained from:
+//   https://github.com/r45635/HVAC-IR-Control/blob/master/HVAC_ESP8266/HVAC_ESP8266.ino#L108
+const uint8_t kMitsubishiAcKnownGoodState[kMitsubishiACStateLength] PROGMEM = {
+    0x23, 0xCB, 0x26, 0x01, 0x00, 0x20, 0x08, 0x06, 0x30,
+    0x45, 0x67, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F};
+
+class IRMitsubishiAC : public IRACState<kMitsubishiACStateLength> {
  public:
   explicit IRMitsubishiAC(uint16_t pin);
 
@@ -67,7 +74,10 @@ class IRMitsubishiAC {
 
   void stateReset();
 #if SEND_MITSUBISHI_AC
-  void send(const uint16_t repeat = kMitsubishiACMinRepeat);
+  void send();
+  void send(const uint16_t repeat);
+  void setRepeat(const uint16_t repeat);
+  uint16_t getRepeat();
 #endif  // SEND_MITSUBISHI_AC
   void begin();
   void on();
@@ -107,12 +117,15 @@ class IRMitsubishiAC {
 #else
   IRsendTest _irsend;
 #endif
+  // Nr. of extra times send() transmits the message. The protocol spec wants
+  // the frame doubled (kMitsubishiACMinRepeat); installs that verify
+  // reception can drop it to kNoRepeat to halve the airtime.
+  uint16_t _repeat;
 #ifdef ARDUINO
   String timeToString(uint64_t time);
 #else
   std::string timeToString(uint64_t time);
 #endif
-  uint8_t remote_state[kMitsubishiACStateLength];
   void checksum();
 };
 
@@ -86,10 +86,10 @@ void IRMitsubishiHeavy152Ac::send(const uint16_t repeat) {
 #endif  // SEND_MITSUBISHIHEAVY
 
 void IRMitsubishiHeavy152Ac::stateReset(void) {
-  uint8_t i = 0;
-  for (; i < kMitsubishiHeavySigLength; i++)
-    remote_state[i] = kMitsubishiHeavyZmsSig[i];
-  for (; i < kMitsubishiHeavy152StateLength - 3; i += 2) remote_state[i] = 0;
+  copyBytes_P(remote_state, kMitsubishiHeavyZmsSig, kMitsubishiHeavySigLength);
+  for (uint8_t i = kMitsubishiHeavySigLength;
+       i < kMitsubishiHeavy152StateLength - 3; i += 2)
+    remote_state[i] = 0;
   remote_state[17] = 0x80;
 }
 
@@ -99,8 +99,7 @@ uint8_t *IRMitsubishiHeavy152Ac::getRaw(void) {
 }
 
 void IRMitsubishiHeavy152Ac::setRaw(const uint8_t *data) {
-  for (uint8_t i = 0; i < kMitsubishiHeavy152StateLength; i++)
-    remote_state[i] = data[i];
+  copyBytes(remote_state, data, kMitsubishiHeavy152StateLength);
 }
 
 void IRMitsubishiHeavy152Ac::on(void) {
@@ -274,9 +273,8 @@ bool IRMitsubishiHeavy152Ac::getEcono(void) {
 
 // Verify the given state has a ZM-S signature.
 bool IRMitsubishiHeavy152Ac::checkZmsSig(const uint8_t *state) {
-  for (uint8_t i = 0; i < kMitsubishiHeavySigLength; i++)
-    if (state[i] != kMitsubishiHeavyZmsSig[i]) return false;
-  return true;
+  return equalBytes_P(state, kMitsubishiHeavyZmsSig,
+                      kMitsubishiHeavySigLength);
 }
 
 // Protocol technically has no checksum, but does has inverted byte pairs.
@@ -531,10 +529,10 @@ void IRMitsubishiHeavy88Ac::send(const uint16_t repeat) {
 #endif  // SEND_MITSUBISHIHEAVY
 
 void IRMitsubishiHeavy88Ac::stateReset(void) {
-  uint8_t i = 0;
-  for (; i < kMitsubishiHeavySigLength; i++)
-    remote_state[i] = kMitsubishiHeavyZjsSig[i];
-  for (; i < kMitsubishiHeavy88StateLength; i++) remote_state[i] = 0;
+  copyBytes_P(remote_state, kMitsubishiHeavyZjsSig, kMitsubishiHeavySigLength);
+  for (uint8_t i = kMitsubishiHeavySigLength;
+       i < kMitsubishiHeavy88StateLength; i++)
+    remote_state[i] = 0;
 }
 
 uint8_t *IRMitsubishiHeavy88Ac::getRaw(void) {
@@ -543,8 +541,7 @@ uint8_t *IRMitsubishiHeavy88Ac::getRaw(void) {
 }
 
 void IRMitsubishiHeavy88Ac::setRaw(const uint8_t *data) {
-  for (uint8_t i = 0; i < kMitsubishiHeavy88StateLength; i++)
-    remote_state[i] = data[i];
+  copyBytes(remote_state, data, kMitsubishiHeavy88StateLength);
 }
 
 void IRMitsubishiHeavy88Ac::on(void) {
@@ -713,9 +710,8 @@ bool IRMitsubishiHeavy88Ac::getClean(void) {
 
 // Verify the given state has a ZJ-S signature.
 bool IRMitsubishiHeavy88Ac::checkZjsSig(const uint8_t *state) {
-  for (uint8_t i = 0; i < kMitsubishiHeavySigLength; i++)
-    if (state[i] != kMitsubishiHeavyZjsSig[i]) return false;
-  return true;
+  return equalBytes_P(state, kMitsubishiHeavyZjsSig,
+                      kMitsubishiHeavySigLength);
 }
 
 // Protocol technically has no checksum, but does has inverted byte pairs.
@@ -24,7 +24,7 @@ const uint8_t kMitsubishiHeavySigLength = 5;
 
 
 // ZMS (152 bit)
-const uint8_t kMitsubishiHeavyZmsSig[kMitsubishiHeavySigLength] = {
+const uint8_t kMitsubishiHeavyZmsSig[kMitsubishiHeavySigLength] PROGMEM = {
     0xAD, 0x51, 0x3C, 0xE5, 0x1A};
 // Byte[5]
 const uint8_t kMitsubishiHeavyFilterBit =     0b01000000;
@@ -76,7 +76,7 @@ const uint8_t kMitsubishiHeavySilentBit =  0b10000000;
 
 
 // ZJS (88 bit)
-const uint8_t kMitsubishiHeavyZjsSig[kMitsubishiHeavySigLength] = {
+const uint8_t kMitsubishiHeavyZjsSig[kMitsubishiHeavySigLength] PROGMEM = {
     0xAD, 0x51, 0x3C, 0xD9, 0x26};
 // Byte [5]
 const uint8_t kMitsubishiHeavy88CleanBit =                  0b00100000;
@@ -162,12 +162,28 @@ bool IRrecv::decodePanasonic(decode_results *results, uint16_t nbits,
       results->rawbuf[offset++] * kRawTick / kPanasonicHdrSpaceTicks;
 
   // Data
+  uint16_t bits_left = nbits;
+  if (strict) {
+    // The 16-bit manufacturer code leads the message, so match & verify just
+    // it before committing to the remaining two thirds of the match work.
+    // Cheap early rejection for the non-Panasonic captures this decoder also
+    // fields as decodeDenon()'s fallback.
+    match_result_t mfg_result = matchData(
+        &(results->rawbuf[offset]), 16, kPanasonicBitMarkTicks * m_tick,
+        kPanasonicOneSpaceTicks * s_tick, kPanasonicBitMarkTicks * m_tick,
+        kPanasonicZeroSpaceTicks * s_tick);
+    if (mfg_result.success == false) return false;
+    if (mfg_result.data != manufacturer) return false;  // Wrong manufacturer.
+    data = mfg_result.data;
+    offset += mfg_result.used;
+    bits_left -= 16;
+  }
   match_result_t data_result = matchData(
-      &(results->rawbuf[offset]), nbits, kPanasonicBitMarkTicks * m_tick,
+      &(results->rawbuf[offset]), bits_left, kPanasonicBitMarkTicks * m_tick,
       kPanasonicOneSpaceTicks * s_tick, kPanasonicBitMarkTicks * m_tick,
       kPanasonicZeroSpaceTicks * s_tick);
   if (data_result.success == false) return false;
-  data = data_result.data;
+  data = (data << bits_left) | data_result.data;
   offset += data_result.used;
 
   // Footer
@@ -181,8 +197,7 @@ bool IRrecv::decodePanasonic(decode_results *results, uint16_t nbits,
   uint32_t address = data >> 32;
   uint32_t command = data & 0xFFFFFFFF;
   if (strict) {
-    if (address != manufacturer)  // Verify the Manufacturer code.
-      return false;
+    // The manufacturer code was already verified above.
     // Verify the checksum.
     uint8_t checksumOrig = data & 0xFF;
     uint8_t checksumCalc = ((data >> 24) ^ (data >> 16) ^ (data >> 8)) & 0xFF;
@@ -239,8 +254,8 @@ void IRsend::sendPanasonicAC(uint8_t data[], uint16_t nbytes, uint16_t repeat) {
 IRPanasonicAc::IRPanasonicAc(uint16_t pin) : _irsend(pin) { stateReset(); }
 
 void IRPanasonicAc::stateReset() {
-  for (uint8_t i = 0; i < kPanasonicAcStateLength; i++)
-    remote_state[i] = kPanasonicKnownGoodState[i];
+  copyBytes_P(remote_state, kPanasonicKnownGoodState,
+              kPanasonicAcStateLength);
   _temp = 25;  // An initial saved desired temp. Completely made up.
   _swingh = kPanasonicAcSwingHMiddle;  // A similar made up value for H Swing.
 }
@@ -341,9 +356,7 @@ uint8_t *IRPanasonicAc::getRaw() {
 }
 
 void IRPanasonicAc::setRaw(const uint8_t state[]) {
-  for (uint8_t i = 0; i < kPanasonicAcStateLength; i++) {
-    remote_state[i] = state[i];
-  }
+  copyBytes(remote_state, state, kPanasonicAcStateLength);
 }
 
 // Control the power state of the A/C unit.
@@ -5,7 +5,7 @@
 
 #define __STDC_LIMIT_MACROS
 #include <stdint.h>
-#ifdef ARDUINO
+#ifndef UNIT_TEST
 #include <Arduino.h>
 #else
 #include <string>
@@ -64,29 +64,19 @@ const uint8_t kPanasonicAcOffTimer = 0b00000100;
 const uint16_t kPanasonicAcTimeMax = 23 * 60 + 59;  // Mins since midnight.
 const uint16_t kPanasonicAcTimeSpecial = 0x600;
 
-const uint8_t kPanasonicKnownGoodState[kPanasonicAcStateLength] = {
+const uint8_t kPanasonicKnownGoodState[kPanasonicAcStateLength] PROGMEM = {
     0x02, 0x20, 0xE0, 0x04, 0x00, 0x00, 0x00, 0x06, 0x02,
     0x20, 0xE0, 0x04, 0x00, 0x00, 0x00, 0x80, 0x00, 0x00,
     0x00, 0x0E, 0xE0, 0x00, 0x00, 0x81, 0x00, 0x00, 0x00};
 
-enum panasonic_ac_remote_model_t {
-  kPanasonicUnknown = 0,
-  kPanasonicLke = 1,
-  kPanasonicNke = 2,
-  kPanasonicDke = 3,
-  kPanasonicJke = 4,
-  kPanasonicCkp = 5,
-  kPanasonicRkr = 6,
-};
-
 class IRPanasonicAc {
  public:
   explicit IRPanasonicAc(uint16_t pin);
 
   void stateReset();
-#if SEND_PANASONIC
+#if SEND_PANASONIC_AC
   void send(const uint16_t repeat = kPanasonicAcDefaultRepeat);
-#endif  // SEND_PANASONIC
+#endif  // SEND_PANASONIC_AC
   void begin();
   void on();
   void off();
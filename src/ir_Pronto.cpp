@@ -1,7 +1,12 @@
 // Copyright 2017 David Conran
 
 #include <algorithm>
+#include "IRrecv.h"
 #include "IRsend.h"
+#include "IRutils.h"
+#ifndef UNIT_TEST
+#include <Arduino.h>
+#endif
 
 //                PPPPPP                        tt
 //                PP   PP rr rr   oooo  nn nnn  tt     oooo
@@ -105,4 +110,177 @@ void IRsend::sendPronto(uint16_t data[], uint16_t len, uint16_t repeat) {
       }
   }
 }
+
+// Parse the next hexadecimal word out of a Pronto hex string stored in
+// flash (PROGMEM) or RAM, advancing the cursor past it.
+//
+// Args:
+//   code: The hex string. e.g. "0000 0067 0000 0015 0060 0018 ..."
+//   pos:  A pointer to the cursor (offset into code). Updated on return.
+// Returns:
+//   The word's value (0x0 - 0xFFFF), or -1 if there are no more words or an
+//   illegal character was hit.
+static int32_t prontoNextWord(const char *code, uint16_t *pos) {
+  uint32_t word = 0;
+  uint8_t digits = 0;
+  for (;;) {
+    char c = pgm_read_byte(code + *pos);
+    if (c == '\0') break;  // End of the string.
+    (*pos)++;
+    if (c >= '0' && c <= '9') {
+      word = (word << 4) | (c - '0');
+      digits++;
+    } else if (c >= 'a' && c <= 'f') {
+      word = (word << 4) | (c - 'a' + 10);
+      digits++;
+    } else if (c >= 'A' && c <= 'F') {
+      word = (word << 4) | (c - 'A' + 10);
+      digits++;
+    } else if (c == ' ' || c == ',' || c == '\t' || c == '\r' || c == '\n') {
+      if (digits) return word;  // A separator ends the word we were reading.
+    } else {
+      return -1;  // An illegal character.
+    }
+    if (digits > 4) return -1;  // Words are at most 4 hex digits.
+  }
+  return digits ? (int32_t)word : -1;
+}
+
+// Send a Pronto Code formatted message, parsed on the fly from its usual
+// hexadecimal string form.
+// Unlike the array version above, this needs no pre-parsing & no temporary
+// buffer: the hex words are read straight from the (flash or RAM) string &
+// fed to mark()/space() as they are decoded, so even a library of thousands
+// of stored codes costs no heap to send.
+//
+// Args:
+//   code: The hex string, e.g. "0000 0067 0000 0015 0060 0018 ...". May live
+//         in PROGMEM. Words may be separated by spaces, commas, or newlines.
+//   repeat: Nr. of times to repeat the message's repeat sequence.
+//
+// Status: ALPHA / Should be identical in behaviour to the array version.
+void IRsend::sendPronto(const char *code, uint16_t repeat) {
+  uint16_t pos = 0;
+  // We only know how to deal with 'raw' pronto code types. Reject all others.
+  if (prontoNextWord(code, &pos) != 0) return;
+  int32_t freq_word = prontoNextWord(code, &pos);
+  int32_t seq_1_words = prontoNextWord(code, &pos);
+  int32_t seq_2_words = prontoNextWord(code, &pos);
+  if (freq_word <= 0 || seq_1_words < 0 || seq_2_words < 0) return;
+
+  // Pronto frequency is in Hz.
+  uint16_t hz = (uint16_t)(1000000U / (freq_word * kProntoFreqFactor));
+  enableIROut(hz);
+  uint32_t periodic_time = calcUSecPeriod(hz, false);
+
+  // Normal (1st sequence) case.
+  if (seq_1_words > 0) {
+    for (uint16_t i = 0; i < seq_1_words; i++) {
+      int32_t on = prontoNextWord(code, &pos);
+      int32_t off = prontoNextWord(code, &pos);
+      if (on < 0 || off < 0) return;  // String ended short. Give up.
+      mark(on * periodic_time);
+      space(off * periodic_time);
+    }
+  } else {
+    // There was no first sequence to send, it is implied that we have to send
+    // the 2nd/repeat sequence an additional time. i.e. At least once.
+    repeat++;
+  }
+
+  // Repeat (2nd sequence) case.
+  if (seq_2_words > 0) {
+    uint16_t seq_2_pos = pos;  // Remember where it starts so we can rewind.
+    for (uint16_t r = 0; r < repeat; r++) {
+      pos = seq_2_pos;
+      for (uint16_t i = 0; i < seq_2_words; i++) {
+        int32_t on = prontoNextWord(code, &pos);
+        int32_t off = prontoNextWord(code, &pos);
+        if (on < 0 || off < 0) return;  // String ended short. Give up.
+        mark(on * periodic_time);
+        space(off * periodic_time);
+      }
+    }
+  }
+}
 #endif
+
+// Infer the carrier frequency (in Hz) a decoded protocol is normally
+// transmitted at. i.e. The frequency the matching sendXxx() routine uses.
+//
+// Args:
+//   protocol: The protocol in question.
+// Returns:
+//   The carrier frequency in Hz. Unknown/unlisted protocols get 38kHz, by
+//   far the most common IR carrier.
+static uint16_t typeToFrequency(const decode_type_t protocol) {
+  switch (protocol) {
+    case MITSUBISHI:
+    case MITSUBISHI2:
+      return 33000;
+    case LASERTAG:
+    case MAGIQUEST:
+    case RC5:
+    case RC5X:
+    case RC6:
+    case RCMM:
+    case TROTEC:
+      return 36000;
+    case DAIKIN2:
+    case PANASONIC:
+    case PANASONIC_AC:
+      return 36700;
+    case LUTRON:
+    case SONY:
+      return 40000;
+    default:
+      return 38000;
+  }
+}
+
+// Convert a capture into Pronto "learned" (type 0000) format, written into
+// a caller-supplied buffer. The carrier frequency is inferred from the
+// decoded protocol (see typeToFrequency() above), so decode the capture
+// first for the best result; an UNKNOWN capture is encoded at 38kHz.
+// One linear pass over the rawbuf & no allocation, so it is cheap enough
+// to run in a learn workflow on-device.
+//
+// The message is emitted as the one-time (first) sequence, with an empty
+// repeat sequence. As captures end on a mark, a trailing gap space is
+// appended to complete the final burst pair.
+//
+// Args:
+//   dest: Where to write the Pronto words.
+//   dest_len: Nr. of uint16_t entries available in dest[].
+//   results: A ptr to the capture to convert.
+// Returns:
+//   The nr. of words written to dest[] (i.e. what to pass to sendPronto()),
+//   or 0 if the capture is empty or dest[] is too small.
+uint16_t resultToPronto(uint16_t *dest, const uint16_t dest_len,
+                        const decode_results *results) {
+  uint16_t timings = results->rawlen ? results->rawlen - 1 : 0;
+  if (timings == 0) return 0;  // Nothing to convert.
+  // Whole burst (mark/space) pairs. Captures end on a mark, so odd counts
+  // get a pad space.
+  uint16_t pairs = (timings + 1) / 2;
+  uint16_t len = kProntoDataOffset + pairs * 2;
+  if (len > dest_len) return 0;  // It won't fit.
+  uint32_t hz = typeToFrequency((decode_type_t)results->decode_type);
+  dest[kProntoTypeOffset] = 0;  // Learned/raw format.
+  // Inverse of sendPronto()'s frequency calculation.
+  dest[kProntoFreqOffset] =
+      (uint16_t)(1000000.0 / (hz * kProntoFreqFactor) + 0.5);
+  dest[kProntoSeq1LenOffset] = pairs;
+  dest[kProntoSeq2LenOffset] = 0;  // No repeat sequence.
+  for (uint16_t i = 0; i < timings; i++) {
+    // Burst values are in carrier cycles, rounded, & at least 1.
+    uint32_t usecs = results->rawbuf[i + 1] * kRawTick;
+    uint32_t cycles = (usecs * hz + 500000UL) / 1000000UL;
+    dest[kProntoDataOffset + i] =
+        (uint16_t)std::min(std::max(cycles, (uint32_t)1), (uint32_t)UINT16_MAX);
+  }
+  if (timings & 1)  // Complete the last burst pair with an inter-message gap.
+    dest[kProntoDataOffset + timings] =
+        (uint16_t)((kDefaultMessageGap * hz + 500000UL) / 1000000UL);
+  return len;
+}
@@ -277,6 +277,37 @@ void IRsend::sendRC6(uint64_t data, uint16_t nbits, uint16_t repeat) {
 #endif  // SEND_RC6
 
 #if (DECODE_RC5 || DECODE_RC6 || DECODE_LASERTAG)
+// Precompute the acceptable width bounds (in uSeconds) for a mark or space
+// spanning 1 .. maxwidth half-bit times, for the given getRClevel()
+// parameters. Each decoder calls getRClevel() with the same parameters for
+// every half-bit of a message, so the tolerance maths (two multiplies &
+// divides per match() call, up to maxwidth calls per level) only needs
+// doing once per parameter set instead of per half-bit. The bounds stay
+// valid across captures & decode attempts until a decoder with different
+// parameters runs.
+//
+// Args: (As per getRClevel())
+void IRrecv::rcSpanInit(uint16_t bitTime, uint8_t tolerance, int16_t excess,
+                        uint16_t delta, uint8_t maxwidth) {
+  if (maxwidth > kRcLevelMaxWidth) maxwidth = kRcLevelMaxWidth;
+  for (uint8_t width = 1; width <= maxwidth; width++) {
+    // Marks run long by `excess`, spaces run short by it. (See match())
+    _rc_low[kMark][width - 1] =
+        ticksLow(width * bitTime + excess, tolerance, delta);
+    _rc_high[kMark][width - 1] =
+        ticksHigh(width * bitTime + excess, tolerance, delta);
+    _rc_low[kSpace][width - 1] =
+        ticksLow(width * bitTime - excess, tolerance, delta);
+    _rc_high[kSpace][width - 1] =
+        ticksHigh(width * bitTime - excess, tolerance, delta);
+  }
+  _rc_bitTime = bitTime;
+  _rc_tolerance = tolerance;
+  _rc_excess = excess;
+  _rc_delta = delta;
+  _rc_maxwidth = maxwidth;
+}
+
 // Gets one undecoded level at a time from the raw buffer.
 // The RC5/6 decoding is easier if the data is broken into time intervals.
 // E.g. if the buffer has MARK for 2 time intervals and SPACE for 1,
@@ -298,6 +329,9 @@ void IRsend::sendRC6(uint64_t data, uint16_t nbits, uint16_t repeat) {
 int16_t IRrecv::getRClevel(decode_results *results, uint16_t *offset,
                            uint16_t *used, uint16_t bitTime, uint8_t tolerance,
                            int16_t excess, uint16_t delta, uint8_t maxwidth) {
+  // Resolve the runtime-tolerance sentinel before the span-bound parameter
+  // compare below, so setTolerance() changes can never serve stale bounds.
+  if (tolerance == kUseDefTol) tolerance = activeTolerance();
   DPRINT("DEBUG: getRClevel: offset = ");
   DPRINTLN(uint64ToString(*offset));
   DPRINT("DEBUG: getRClevel: rawlen = ");
@@ -315,17 +349,23 @@ int16_t IRrecv::getRClevel(decode_results *results, uint16_t *offset,
     DPRINTLN("DEBUG: getRClevel: SPACE, hit end of mesg gap.");
     return kSpace;
   }
-  int16_t correction = (val == kMark) ? excess : -excess;
+  if (maxwidth > kRcLevelMaxWidth) maxwidth = kRcLevelMaxWidth;
+  // (Re)build the precomputed span bounds if the parameters changed.
+  // Within (& usually across) a decode attempt they don't, so the state
+  // machine below just walks ready-made integer bounds.
+  if (bitTime != _rc_bitTime || tolerance != _rc_tolerance ||
+      excess != _rc_excess || delta != _rc_delta || maxwidth != _rc_maxwidth)
+    rcSpanInit(bitTime, tolerance, excess, delta, maxwidth);
 
   // Calculate the look-ahead for our current position in the buffer.
   uint16_t avail;
+  const uint32_t usecs = width * kRawTick;
   // Note: We want to match in greedy order as the other way leads to
   //       mismatches due to overlaps induced by the correction and tolerance
   //       values.
   for (avail = maxwidth; avail > 0; avail--) {
-    if (match(width, avail * bitTime + correction, tolerance, delta)) {
+    if (usecs >= _rc_low[val][avail - 1] && usecs <= _rc_high[val][avail - 1])
       break;
-    }
   }
   if (!avail) {
     DPRINTLN("DEBUG: getRClevel: Unexpected width. Exiting.");
@@ -348,6 +388,26 @@ int16_t IRrecv::getRClevel(decode_results *results, uint16_t *offset,
 }
 #endif  // (DECODE_RC5 || DECODE_RC6 || DECODE_LASERTAG)
 
+#if DECODE_RC5 || DECODE_RC6
+// Toggle-bit bookkeeping for a freshly decoded RC-5/RC-6 result, if
+// enabled. A held button repeats the frame unchanged (toggle bit & all);
+// a new press of even the same key arrives with the toggle flipped. So a
+// value identical to the previously surfaced one means "held", which is
+// recorded in results->repeat. decode() additionally swallows & counts the
+// held frames if coalescing was requested. See setToggleTracking().
+//
+// Args:
+//   results: Ptr to the decoded result to annotate & track.
+void IRrecv::rcToggleAnnotate(decode_results *results) {
+  if (!_toggle_track) return;
+  results->repeat = results->decode_type == _toggle_prev_type &&
+                    results->value == _toggle_prev;
+  if (!results->repeat) _toggle_repeats = 0;  // A fresh press. Hold is over.
+  _toggle_prev = results->value;
+  _toggle_prev_type = (decode_type_t)results->decode_type;
+}
+#endif  // DECODE_RC5 || DECODE_RC6
+
 #if DECODE_RC5
 // Decode the supplied RC-5/RC5X message.
 //
@@ -429,6 +489,7 @@ bool IRrecv::decodeRC5(decode_results *results, uint16_t nbits, bool strict) {
     actual_bits--;  // RC5 doesn't count the field bit as data.
   }
   results->bits = actual_bits;
+  rcToggleAnnotate(results);  // Held-button detection, if enabled.
   return true;
 }
 #endif  // DECODE_RC5
@@ -519,6 +580,7 @@ bool IRrecv::decodeRC6(decode_results *results, uint16_t nbits, bool strict) {
   results->value = data;
   results->address = data >> 8;
   results->command = data & 0xFF;
+  rcToggleAnnotate(results);  // Held-button detection, if enabled.
   return true;
 }
 #endif  // DECODE_RC6
@@ -136,32 +136,48 @@ bool IRrecv::decodeRCMM(decode_results *results, uint16_t nbits, bool strict) {
 
   // Data decode
   // RC-MM has two bits of data per mark/space pair.
+  // Precompute the bit-mark window & the four data-space windows once,
+  // instead of re-running the tolerance maths on every symbol.
+  // Use non-default tolerance & excess for matching some of the spaces as the
+  // defaults are too generous and causes mis-matches in some cases.
+  // The windows are naturally sorted by duration; where neighbouring windows
+  // overlap, the shorter one wins, as it did with the old if-else ladder.
+  const uint32_t mark_lo = ticksLow(kRcmmBitMarkTicks * m_tick);
+  const uint32_t mark_hi = ticksHigh(kRcmmBitMarkTicks * m_tick);
+  const uint32_t space_lo[4] = {
+      ticksLow(kRcmmBitSpace0Ticks * s_tick, kTolerance),
+      ticksLow(kRcmmBitSpace1Ticks * s_tick, kTolerance),
+      ticksLow(kRcmmBitSpace2Ticks * s_tick, kRcmmTolerance),
+      ticksLow(kRcmmBitSpace3Ticks * s_tick, kRcmmTolerance)};
+  const uint32_t space_hi[4] = {
+      ticksHigh(kRcmmBitSpace0Ticks * s_tick, kTolerance),
+      ticksHigh(kRcmmBitSpace1Ticks * s_tick, kTolerance),
+      ticksHigh(kRcmmBitSpace2Ticks * s_tick, kRcmmTolerance),
+      ticksHigh(kRcmmBitSpace3Ticks * s_tick, kRcmmTolerance)};
   uint16_t actualBits;
   for (actualBits = 0; actualBits < maxBitSize; actualBits += 2, offset++) {
-    if (!match(results->rawbuf[offset++], kRcmmBitMarkTicks * m_tick))
-      return false;
+    uint32_t usecs = results->rawbuf[offset++] * kRawTick;
+    if (usecs < mark_lo || usecs > mark_hi) return false;
 
-    data <<= 2;
-    // Use non-default tolerance & excess for matching some of the spaces as the
-    // defaults are too generous and causes mis-matches in some cases.
-    if (match(results->rawbuf[offset], kRcmmBitSpace0Ticks * s_tick,
-              kTolerance))
-      data += 0;
-    else if (match(results->rawbuf[offset], kRcmmBitSpace1Ticks * s_tick,
-                   kTolerance))
-      data += 1;
-    else if (match(results->rawbuf[offset], kRcmmBitSpace2Ticks * s_tick,
-                   kRcmmTolerance))
-      data += 2;
-    else if (match(results->rawbuf[offset], kRcmmBitSpace3Ticks * s_tick,
-                   kRcmmTolerance))
-      data += 3;
-    else
-      return false;
+    // Binary search the sorted windows for the one holding this space.
+    usecs = results->rawbuf[offset] * kRawTick;
+    uint8_t symbol = 0;
+    uint8_t top = 3;
+    while (symbol < top) {
+      const uint8_t mid = (symbol + top) / 2;
+      if (usecs > space_hi[mid])
+        symbol = mid + 1;
+      else
+        top = mid;
+    }
+    if (usecs < space_lo[symbol] || usecs > space_hi[symbol]) return false;
+    data = (data << 2) + symbol;
   }
   // Footer decode
-  if (!match(results->rawbuf[offset++], kRcmmBitMarkTicks * m_tick))
-    return false;
+  {
+    const uint32_t usecs = results->rawbuf[offset++] * kRawTick;
+    if (usecs < mark_lo || usecs > mark_hi) return false;
+  }
   if (offset < results->rawlen &&
       !matchAtLeast(results->rawbuf[offset], kRcmmMinGapTicks * s_tick))
     return false;
@@ -289,6 +289,40 @@ bool IRrecv::decodeSamsung36(decode_results *results, const uint16_t nbits,
 }
 #endif  // DECODE_SAMSUNG36
 
+#if (DECODE_SAMSUNG || DECODE_SAMSUNG36)
+// Single-pass entry for the Samsung-timing family: Samsung (32 bit) &
+// Samsung36. Both members open with the same header (a 4.48ms mark &
+// 4.48ms space), so that shared timing is vetted once here & a capture
+// that can't possibly be either costs two compares instead of two decoder
+// attempts. Precedence & acceptance between the members are unchanged.
+//
+// Args:
+//   results:  A pointer to where the decoded IR message will be stored.
+// Returns:
+//   A boolean indicating if the decode was successful or not.
+bool IRrecv::decodeSamsungFamily(decode_results *results) {
+  if (results->rawlen < 2 * kSamsungBits + kHeader + kFooter - 1)
+    return false;  // Too short for even the smallest family member.
+  // The shared header vet.
+  if (!matchMark(results->rawbuf[kStartOffset], kSamsungHdrMark)) return false;
+  if (!matchSpace(results->rawbuf[kStartOffset + 1], kSamsungHdrSpace))
+    return false;
+#if DECODE_SAMSUNG
+  if (worthAttempting(SAMSUNG, results->rawlen)) {
+    DPRINTLN("Attempting SAMSUNG decode");
+    if (decodeSAMSUNG(results)) return true;
+  }
+#endif  // DECODE_SAMSUNG
+#if DECODE_SAMSUNG36
+  if (worthAttempting(SAMSUNG36, results->rawlen)) {
+    DPRINTLN("Attempting Samsung36 decode");
+    if (decodeSamsung36(results)) return true;
+  }
+#endif  // DECODE_SAMSUNG36
+  return false;
+}
+#endif  // (DECODE_SAMSUNG || DECODE_SAMSUNG36)
+
 #if SEND_SAMSUNG_AC
 // Send a Samsung A/C message.
 //
@@ -326,21 +360,65 @@ void IRsend::sendSamsungAC(const uint8_t data[], const uint16_t nbytes,
 }
 #endif  // SEND_SAMSUNG_AC
 
-IRSamsungAc::IRSamsungAc(uint16_t pin) : _irsend(pin) { stateReset(); }
+IRSamsungAc::IRSamsungAc(uint16_t pin) : _irsend(pin) {
+  _image_valid = false;  // Nothing has been compiled yet.
+  stateReset();
+}
+
+#if SEND_SAMSUNG_AC
+// Compile the given frame into one flat pulse train: the message header,
+// then each 7-byte section's mark/space pair, data bits (LSB first) &
+// footer, exactly as sendSamsungAC() would transmit them.
+// Note: The trailing remainder of the inter-message gap is too long for a
+// pulse train entry. sendImage() appends it at playback time.
+void IRSamsungAc::renderImage(const uint8_t data[], const uint16_t nbytes) {
+  uint16_t len = 0;
+  // Header
+  _image[len++] = kSamsungAcHdrMark;
+  _image[len++] = kSamsungAcHdrSpace;
+  // Compile in 7 byte sections.
+  for (uint16_t offset = 0; offset < nbytes;
+       offset += kSamsungACSectionLength) {
+    _image[len++] = kSamsungAcSectionMark;
+    _image[len++] = kSamsungAcSectionSpace;
+    for (uint16_t i = 0; i < kSamsungACSectionLength; i++) {
+      uint8_t databyte = data[offset + i];
+      for (uint8_t bit = 0; bit < 8; bit++, databyte >>= 1) {  // LSB first.
+        _image[len++] = kSamsungAcBitMark;
+        _image[len++] = (databyte & 1) ? kSamsungAcOneSpace
+                                       : kSamsungAcZeroSpace;
+      }
+    }
+    // Section footer
+    _image[len++] = kSamsungAcBitMark;
+    _image[len++] = kSamsungAcSectionGap;
+  }
+  _image_len = len;
+  _image_nbytes = nbytes;
+  copyBytes(_image_state, data, nbytes);
+  _image_valid = true;
+}
+
+// Transmit the given frame via the compiled pulse train, compiling it
+// first if it isn't the one last compiled. Repeats of the same frame
+// (e.g. a periodic keep-alive of the current settings) are pure raw
+// playback with no per-bit work.
+void IRSamsungAc::sendImage(const uint8_t data[], const uint16_t nbytes,
+                            const uint16_t repeat) {
+  if (!_image_valid || _image_nbytes != nbytes ||
+      !equalBytes(data, _image_state, nbytes))
+    renderImage(data, nbytes);
+  for (uint16_t r = 0; r <= repeat; r++) {
+    _irsend.sendRaw(_image, _image_len, 38);
+    // The rest of the inter-message gap. (See renderImage())
+    _irsend.space(100000 - kSamsungAcSectionGap);
+  }
+}
+#endif  // SEND_SAMSUNG_AC
 
 void IRSamsungAc::stateReset(void) {
-  for (uint8_t i = 0; i < kSamsungAcExtendedStateLength; i++)
-    remote_state[i] = 0x0;
-  remote_state[0] = 0x02;
-  remote_state[1] = 0x92;
-  remote_state[2] = 0x0F;
-  remote_state[6] = 0xF0;
-  remote_state[7] = 0x01;
-  remote_state[8] = 0x02;
-  remote_state[9] = 0xAE;
-  remote_state[10] = 0x71;
-  remote_state[12] = 0x15;
-  remote_state[13] = 0xF0;
+  copyBytes_P(remote_state, kSamsungAcKnownGoodState,
+              kSamsungAcExtendedStateLength);
   _sendpower = false;
 }
 
@@ -392,7 +470,7 @@ void IRSamsungAc::send(const uint16_t repeat, const bool calcchecksum) {
       this->sendOff();
     _sendpower = false;  // It's now been sent.
   }
-  _irsend.sendSamsungAC(remote_state, kSamsungAcStateLength, repeat);
+  sendImage(remote_state, kSamsungAcStateLength, repeat);
 }
 
 // Use this for when you need to power on/off the device.
@@ -412,7 +490,7 @@ void IRSamsungAc::sendExtended(const uint16_t repeat, const bool calcchecksum) {
   // extended_state[8] seems special. This is a guess on how to calculate it.
   extended_state[8] = (extended_state[1] & 0x9F) | 0x40;
   // Send it.
-  _irsend.sendSamsungAC(extended_state, kSamsungAcExtendedStateLength, repeat);
+  sendImage(extended_state, kSamsungAcExtendedStateLength, repeat);
 }
 
 // Send the special extended "On" message as the library can't seem to reproduce
@@ -444,9 +522,8 @@ uint8_t *IRSamsungAc::getRaw(void) {
 }
 
 void IRSamsungAc::setRaw(const uint8_t new_code[], const uint16_t length) {
-  for (uint8_t i = 0; i < length && i < kSamsungAcExtendedStateLength; i++) {
-    remote_state[i] = new_code[i];
-  }
+  copyBytes(remote_state, new_code,
+            std::min(length, (uint16_t)kSamsungAcExtendedStateLength));
   // Shrink the extended state into a normal state.
   if (length > kSamsungAcStateLength) {
     for (uint8_t i = kSamsungAcStateLength; i < length; i++)
@@ -58,6 +58,20 @@ const uint8_t kSamsungAcQuietMask11 = 0x01;
 const uint16_t kSamsungACSectionLength = 7;
 const uint64_t kSamsungAcPowerSection = 0x1D20F00000000;
 
+// Nr. of pulse train entries a compiled frame can need: the header pair,
+// plus (per 7-byte section) a section mark/space pair, 2 entries per bit &
+// a footer pair. Sized for the extended (3 section) frame.
+const uint16_t kSamsungAcSectionImageEntries =
+    4 + 2 * 8 * kSamsungACSectionLength;  // i.e. 116
+const uint16_t kSamsungAcImageEntries =
+    2 + 3 * kSamsungAcSectionImageEntries;  // i.e. 350
+
+// The default (reset) state, in the extended (3 section) form.
+const uint8_t kSamsungAcKnownGoodState[kSamsungAcExtendedStateLength] PROGMEM =
+    {0x02, 0x92, 0x0F, 0x00, 0x00, 0x00, 0xF0,
+     0x01, 0x02, 0xAE, 0x71, 0x00, 0x15, 0xF0,
+     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
 // Classes
 class IRSamsungAc {
  public:
@@ -115,6 +129,18 @@ class IRSamsungAc {
   // The state of the IR remote in IR code form.
   uint8_t remote_state[kSamsungAcExtendedStateLength];
   bool _sendpower;  // Hack to know when we need to send a special power mesg.
+  // The most recently compiled pulse train & what it was compiled from.
+  // Normal & extended frames share the (extended-sized) slot. See send().
+  uint16_t _image[kSamsungAcImageEntries];
+  uint16_t _image_len;  // Nr. of entries compiled into _image[].
+  uint8_t _image_state[kSamsungAcExtendedStateLength];
+  uint16_t _image_nbytes;  // Frame size _image was compiled from.
+  bool _image_valid;
+  void renderImage(const uint8_t data[], const uint16_t nbytes);
+#if SEND_SAMSUNG_AC
+  void sendImage(const uint8_t data[], const uint16_t nbytes,
+                 const uint16_t repeat);
+#endif  // SEND_SAMSUNG_AC
   void checksum(const uint16_t length = kSamsungAcStateLength);
 };
 
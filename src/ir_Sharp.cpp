@@ -337,10 +337,10 @@ void IRSharpAc::checksum(void) {
 }
 
 void IRSharpAc::stateReset(void) {
-  static const uint8_t reset[kSharpAcStateLength] = {
+  static const uint8_t reset[kSharpAcStateLength] PROGMEM = {
       0xAA, 0x5A, 0xCF, 0x10, 0x00, 0x01, 0x00, 0x00, 0x08, 0x80, 0x00, 0xE0,
       0x01};
-  for (uint8_t i = 0; i < kSharpAcStateLength; i++) remote[i] = reset[i];
+  copyBytes_P(remote, reset, kSharpAcStateLength);
 }
 
 uint8_t *IRSharpAc::getRaw(void) {
@@ -102,10 +102,16 @@ uint32_t IRsend::encodeSony(uint16_t nbits, uint16_t command, uint16_t address,
 //
 // Notes:
 //   SONY protocol, SIRC (Serial Infra-Red Control) can be 12,15,20 bits long.
+//   The per-bit match windows are computed once from the header-derived
+//   tick, & with strict on only the exact requested size is accepted, with
+//   an early exit as soon as a frame runs past it. i.e. A single pass
+//   delivers strict-grade results, which matters as Sony remotes send
+//   every message at least 3 times. Non-strict still accepts odd
+//   (Sony-like) sizes, e.g. 8 or 13 bits.
 // Ref:
 // http://www.sbprojects.com/knowledge/ir/sirc.php
 bool IRrecv::decodeSony(decode_results *results, uint16_t nbits, bool strict) {
-  if (results->rawlen < 2 * nbits + kHeader - 1)
+  if (results->rawlen < 2 * kSonyMinBits + kHeader - 1)
     return false;  // Message is smaller than we expected.
 
   // Compliance
@@ -120,6 +126,16 @@ bool IRrecv::decodeSony(decode_results *results, uint16_t nbits, bool strict) {
     }
   }
 
+  // With strict on, only the requested size will do, & the data loop gives
+  // up as soon as a frame runs past it. Non-strict keeps the documented
+  // looser contract: odd (Sony-like) sizes, e.g. 8 or 13 bits, decode too.
+  uint16_t maxBits = UINT16_MAX;  // i.e. No ceiling.
+  if (strict) {
+    if (results->rawlen < 2 * nbits + kHeader - 1)
+      return false;  // The capture can't hold the requested variant.
+    maxBits = nbits;  // Only the requested variant will do.
+  }
+
   uint64_t data = 0;
   uint16_t offset = kStartOffset;
   uint16_t actualBits;
@@ -131,20 +147,44 @@ bool IRrecv::decodeSony(decode_results *results, uint16_t nbits, bool strict) {
   // Calculate how long the common tick time is based on the header mark.
   uint32_t tick = results->rawbuf[offset++] * kRawTick / kSonyHdrMarkTicks;
 
+  // Pre-compute the per-bit match windows (in uSecs) from the tick estimate
+  // once, instead of re-deriving them for every bit. These are exactly the
+  // bounds matchSpace()/matchMark() would arrive at.
+  const uint8_t tolerance = activeTolerance();
+  const uint32_t space_lo = ticksLow(kSonySpaceTicks * tick - kMarkExcess,
+                                     tolerance);
+  const uint32_t space_hi = ticksHigh(kSonySpaceTicks * tick - kMarkExcess,
+                                      tolerance);
+  const uint32_t one_lo = ticksLow(kSonyOneMarkTicks * tick + kMarkExcess,
+                                   tolerance);
+  const uint32_t one_hi = ticksHigh(kSonyOneMarkTicks * tick + kMarkExcess,
+                                    tolerance);
+  const uint32_t zero_lo = ticksLow(kSonyZeroMarkTicks * tick + kMarkExcess,
+                                    tolerance);
+  const uint32_t zero_hi = ticksHigh(kSonyZeroMarkTicks * tick + kMarkExcess,
+                                     tolerance);
+  const uint32_t rptgap_lo = ticksLow(kSonyMinGapTicks * tick - kMarkExcess,
+                                      tolerance);
+  const uint32_t rptgap_hi = ticksHigh(kSonyMinGapTicks * tick - kMarkExcess,
+                                       tolerance);
+
   // Data
   for (actualBits = 0; offset < results->rawlen - 1; actualBits++, offset++) {
+    uint32_t usecs = results->rawbuf[offset] * kRawTick;
     // The gap after a Sony packet for a repeat should be kSonyMinGap or
     //   (kSonyRptLength - timeSoFar) according to the spec.
-    if (matchSpace(results->rawbuf[offset], kSonyMinGapTicks * tick) ||
+    if ((usecs >= rptgap_lo && usecs <= rptgap_hi) ||
         matchAtLeast(results->rawbuf[offset], kSonyRptLength - timeSoFar))
       break;  // Found a repeat space.
-    timeSoFar += results->rawbuf[offset] * kRawTick;
-    if (!matchSpace(results->rawbuf[offset++], kSonySpaceTicks * tick))
-      return false;
-    timeSoFar += results->rawbuf[offset] * kRawTick;
-    if (matchMark(results->rawbuf[offset], kSonyOneMarkTicks * tick))
+    if (actualBits >= maxBits) return false;  // Already past every variant.
+    timeSoFar += usecs;
+    if (usecs < space_lo || usecs > space_hi) return false;
+    offset++;
+    usecs = results->rawbuf[offset] * kRawTick;
+    timeSoFar += usecs;
+    if (usecs >= one_lo && usecs <= one_hi)
       data = (data << 1) | 1;
-    else if (matchMark(results->rawbuf[offset], kSonyZeroMarkTicks * tick))
+    else if (usecs >= zero_lo && usecs <= zero_hi)
       data <<= 1;
     else
       return false;
@@ -65,18 +65,7 @@ bool IRTcl112Ac::validChecksum(uint8_t state[], const uint16_t length) {
 }
 
 void IRTcl112Ac::stateReset() {
-  for (uint8_t i = 0; i < kTcl112AcStateLength; i++)
-    remote_state[i] = 0x0;
-  // A known good state. (On, Cool, 24C)
-  remote_state[0] =  0x23;
-  remote_state[1] =  0xCB;
-  remote_state[2] =  0x26;
-  remote_state[3] =  0x01;
-  remote_state[5] =  0x24;
-  remote_state[6] =  0x03;
-  remote_state[7] =  0x07;
-  remote_state[8] =  0x40;
-  remote_state[13] = 0x03;
+  copyBytes_P(remote_state, kTcl112AcKnownGoodState, kTcl112AcStateLength);
 }
 
 uint8_t* IRTcl112Ac::getRaw() {
@@ -85,9 +74,8 @@ uint8_t* IRTcl112Ac::getRaw() {
 }
 
 void IRTcl112Ac::setRaw(const uint8_t new_code[], const uint16_t length) {
-  for (uint8_t i = 0; i < length && i < kTcl112AcStateLength; i++) {
-    remote_state[i] = new_code[i];
-  }
+  copyBytes(remote_state, new_code,
+            std::min(length, (uint16_t)kTcl112AcStateLength));
 }
 
 // Set the requested power state of the A/C to on.
@@ -378,41 +366,21 @@ bool IRrecv::decodeTcl112Ac(decode_results *results, uint16_t nbits,
     return false;  // Can't possibly be a valid Samsung A/C message.
   if (strict && nbits != kTcl112AcBits) return false;
 
-  uint16_t offset = kStartOffset;
-  uint16_t dataBitsSoFar = 0;
-  match_result_t data_result;
-
-  // Message Header
-  if (!matchMark(results->rawbuf[offset++], kTcl112AcHdrMark)) return false;
-  if (!matchSpace(results->rawbuf[offset++], kTcl112AcHdrSpace)) return false;
-
-  // Data
-  // Keep reading bytes until we either run out of section or state to fill.
-  for (uint16_t i = 0; offset <= results->rawlen - 16 && i < nbits / 8;
-       i++, dataBitsSoFar += 8, offset += data_result.used) {
-    data_result = matchData(&(results->rawbuf[offset]), 8, kTcl112AcBitMark,
-                            kTcl112AcOneSpace, kTcl112AcBitMark,
-                            kTcl112AcZeroSpace, kTolerance, 0, false);
-    if (data_result.success == false) {
-      DPRINT("DEBUG: offset = ");
-      DPRINTLN(offset + data_result.used);
-      return false;  // Fail
-    }
-    results->state[i] = data_result.data;
-  }
-
-  // Footer
-  if (!matchMark(results->rawbuf[offset++], kTcl112AcBitMark)) return false;
-  if (offset <= results->rawlen &&
-      !matchAtLeast(results->rawbuf[offset++], kTcl112AcGap)) return false;
+  // Header + Data + Footer
+  if (!matchGeneric(results->rawbuf + kStartOffset, results->state,
+                    results->rawlen - kStartOffset, nbits,
+                    kTcl112AcHdrMark, kTcl112AcHdrSpace,
+                    kTcl112AcBitMark, kTcl112AcOneSpace,
+                    kTcl112AcBitMark, kTcl112AcZeroSpace,
+                    kTcl112AcBitMark, kTcl112AcGap, true,
+                    kTolerance, 0, false))
+    return false;
   // Compliance
-  // Re-check we got the correct size/length due to the way we read the data.
-  if (dataBitsSoFar != nbits) return false;
   // Verify we got a valid checksum.
   if (strict && !IRTcl112Ac::validChecksum(results->state)) return false;
   // Success
   results->decode_type = TCL112AC;
-  results->bits = dataBitsSoFar;
+  results->bits = nbits;
   // No need to record the state as we stored it as we decoded it.
   // As we use result->state, we don't record value, address, or command as it
   // is a union data type.
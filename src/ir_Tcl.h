@@ -45,6 +45,11 @@ const uint8_t kTcl112AcBitSwingH = 0b00001000;
 const uint8_t kTcl112AcBitSwingV = 0b00111000;
 const uint8_t kTcl112AcBitTurbo  = 0b01000000;
 
+// A known good state. (On, Cool, 24C)
+const uint8_t kTcl112AcKnownGoodState[kTcl112AcStateLength] PROGMEM = {
+    0x23, 0xCB, 0x26, 0x01, 0x00, 0x24, 0x03,
+    0x07, 0x40, 0x00, 0x00, 0x00, 0x00, 0x03};
+
 
 class IRTcl112Ac {
  public:
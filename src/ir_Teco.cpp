@@ -244,33 +244,24 @@ bool IRrecv::decodeTeco(decode_results* results, uint16_t nbits, bool strict) {
   if (strict && nbits != kTecoBits) return false;  // Not what is expected
 
   uint64_t data = 0;
-  uint16_t offset = kStartOffset;
-  match_result_t data_result;
-
-  // Header
-  if (!matchMark(results->rawbuf[offset++], kTecoHdrMark)) return false;
-  if (!matchSpace(results->rawbuf[offset++], kTecoHdrSpace)) return false;
-  // Data (35 bits)
-  data_result =
-      matchData(&(results->rawbuf[offset]), 35, kTecoBitMark, kTecoOneSpace,
-                kTecoBitMark, kTecoZeroSpace, kTolerance, kMarkExcess, false);
-  if (data_result.success == false) return false;
-  data = data_result.data;
-  offset += data_result.used;
-  uint16_t actualBits = data_result.used / 2;
-
-  // Footer.
-  if (!matchMark(results->rawbuf[offset++], kTecoBitMark)) return false;
-  if (offset < results->rawlen &&
-      !matchAtLeast(results->rawbuf[offset], kTecoGap)) return false;
+
+  // Header + Data (35 bits) + Footer
+  if (!matchGeneric(results->rawbuf + kStartOffset, &data,
+                    results->rawlen - kStartOffset, 35,
+                    kTecoHdrMark, kTecoHdrSpace,
+                    kTecoBitMark, kTecoOneSpace,
+                    kTecoBitMark, kTecoZeroSpace,
+                    kTecoBitMark, kTecoGap, true,
+                    kTolerance, kMarkExcess, false))
+    return false;
 
   // Compliance
-  if (actualBits < nbits) return false;
-  if (strict && actualBits != nbits) return false;  // Not as we expected.
+  if (nbits > 35) return false;  // We captured less than asked for.
+  if (strict && nbits != 35) return false;  // Not as we expected.
 
   // Success
   results->decode_type = TECO;
-  results->bits = actualBits;
+  results->bits = 35;
   results->value = data;
   results->address = 0;
   results->command = 0;
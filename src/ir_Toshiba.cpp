@@ -68,18 +68,8 @@ IRToshibaAC::IRToshibaAC(uint16_t pin) : _irsend(pin) { stateReset(); }
 
 // Reset the state of the remote to a known good state/sequence.
 void IRToshibaAC::stateReset() {
-  // The state of the IR remote in IR code form.
-  // Known good state obtained from:
-  //   https://github.com/r45635/HVAC-IR-Control/blob/master/HVAC_ESP8266/HVAC_ESP8266T.ino#L103
-  // Note: Can't use the following because it requires -std=c++11
-  // uint8_t remote_state[kToshibaACStateLength] = {
-  //    0xF2, 0x0D, 0x03, 0xFC, 0x01, 0x00, 0x00, 0x00, 0x00 };
-  remote_state[0] = 0xF2;
-  remote_state[1] = 0x0D;
-  remote_state[2] = 0x03;
-  remote_state[3] = 0xFC;
-  remote_state[4] = 0x01;
-  for (uint8_t i = 5; i < kToshibaACStateLength; i++) remote_state[i] = 0;
+  // See kToshibaAcKnownGoodState (ir_Toshiba.h) for its provenance.
+  copyBytes_P(remote_state, kToshibaAcKnownGoodState, kToshibaACStateLength);
   mode_state = remote_state[6] & 0b00000011;
   checksum();  // Calculate the checksum
 }
@@ -103,9 +93,7 @@ uint8_t* IRToshibaAC::getRaw() {
 
 // Override the internal state with the new state.
 void IRToshibaAC::setRaw(uint8_t newState[]) {
-  for (uint8_t i = 0; i < kToshibaACStateLength; i++) {
-    remote_state[i] = newState[i];
-  }
+  copyBytes(remote_state, newState, kToshibaACStateLength);
   mode_state = getMode(true);
 }
 
@@ -117,13 +105,9 @@ void IRToshibaAC::setRaw(uint8_t newState[]) {
 //   The 8 bit checksum value.
 uint8_t IRToshibaAC::calcChecksum(const uint8_t state[],
                                   const uint16_t length) {
-  uint8_t checksum = 0;
+  // Checksum is simple XOR of all bytes except the last one.
   // Only calculate it for valid lengths.
-  if (length > 1) {
-    // Checksum is simple XOR of all bytes except the last one.
-    for (uint8_t i = 0; i < length - 1; i++) checksum ^= state[i];
-  }
-  return checksum;
+  return (length > 1) ? xorBytes(state, length - 1) : 0;
 }
 
 // Verify the checksum is valid for a given state.
@@ -344,6 +328,7 @@ bool IRrecv::decodeToshibaAC(decode_results* results, uint16_t nbits,
   if (!matchSpace(results->rawbuf[offset++], kToshibaAcHdrSpace)) return false;
 
   // Data
+  uint8_t checksum = 0;  // XOR-accumulated as the bytes arrive.
   for (uint8_t i = 0; i < kToshibaACStateLength; i++) {
     // Read a byte's worth of data.
     match_result_t data_result =
@@ -352,6 +337,7 @@ bool IRrecv::decodeToshibaAC(decode_results* results, uint16_t nbits,
     if (data_result.success == false) return false;  // Fail
     dataBitsSoFar += 8;
     results->state[i] = (uint8_t)data_result.data;
+    checksum ^= results->state[i];
     offset += data_result.used;
   }
 
@@ -361,8 +347,11 @@ bool IRrecv::decodeToshibaAC(decode_results* results, uint16_t nbits,
 
   // Compliance
   if (strict) {
-    // Check that the checksum of the message is correct.
-    if (!IRToshibaAC::validChecksum(results->state)) return false;
+    // Check that the checksum of the message is correct. The last byte is
+    // the XOR of those before it, so a valid message XORs to zero over all
+    // its bytes, & `checksum` already holds exactly that. i.e. No need to
+    // re-walk the state via validChecksum().
+    if (checksum != 0) return false;
   }
 
   // Success
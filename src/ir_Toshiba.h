@@ -4,7 +4,7 @@
 
 #define __STDC_LIMIT_MACROS
 #include <stdint.h>
-#ifdef ARDUINO
+#ifndef UNIT_TEST
 #include <Arduino.h>
 #else
 #include <string>
@@ -45,6 +45,11 @@ const uint8_t kToshibaAcMaxTemp = 30;  // 30C
 #define TOSHIBA_AC_MIN_TEMP kToshibaAcMinTemp
 #define TOSHIBA_AC_MAX_TEMP kToshibaAcMaxTemp
 
+// Known good state obtained from:
+//   https://github.com/r45635/HVAC-IR-Control/blob/master/HVAC_ESP8266/HVAC_ESP8266T.ino#L103
+const uint8_t kToshibaAcKnownGoodState[kToshibaACStateLength] PROGMEM = {
+    0xF2, 0x0D, 0x03, 0xFC, 0x01, 0x00, 0x00, 0x00, 0x00};
+
 class IRToshibaAC {
  public:
   explicit IRToshibaAC(uint16_t pin);
@@ -2,6 +2,7 @@
 
 #include "ir_Trotec.h"
 #include <algorithm>
+#include "IRrecv.h"
 #include "IRremoteESP8266.h"
 #include "IRutils.h"
 
@@ -46,11 +47,33 @@ void IRTrotecESP::send(const uint16_t repeat) {
 }
 #endif  // SEND_TROTEC
 
-void IRTrotecESP::checksum() {
-  uint8_t sum = 0;
+// Calculate the checksum for a given state.
+//
+// Args:
+//   state: A pointer to the array of bytes to calculate over.
+//   length: Nr. of bytes in the state array.
+// Returns:
+//   The 8-bit calculated result.
+uint8_t IRTrotecESP::calcChecksum(const uint8_t state[],
+                                  const uint16_t length) {
+  return sumBytes(state + 2, length - 3);
+}
 
-  for (uint8_t i = 2; i < 8; i++) sum += remote_state[i];
-  remote_state[8] = sum & 0xFF;
+// Verify the checksum of the given state.
+//
+// Args:
+//   state: A pointer to the array of bytes to verify.
+//   length: Nr. of bytes in the state array.
+// Returns:
+//   A boolean indicating if the checksum is valid.
+bool IRTrotecESP::validChecksum(const uint8_t state[], const uint16_t length) {
+  if (length < 4) return false;
+  return state[length - 1] == calcChecksum(state, length);
+}
+
+void IRTrotecESP::checksum() {
+  remote_state[kTrotecStateLength - 1] =
+      calcChecksum(remote_state, kTrotecStateLength);
 }
 
 void IRTrotecESP::stateReset() {
@@ -160,3 +183,52 @@ uint8_t IRTrotecESP::convertFan(const stdAc::fanspeed_t speed) {
       return kTrotecFanMed;
   }
 }
+
+#if DECODE_TROTEC
+// Decode the supplied Trotec A/C message.
+//
+// Args:
+//   results: Ptr to the data to decode and where to store the decode result.
+//   nbits:   The number of data bits to expect. Typically kTrotecBits.
+//   strict:  Flag indicating if we should perform strict matching.
+// Returns:
+//   boolean: True if it can decode it, false if it can't.
+//
+// Status: ALPHA / Based entirely off sendTrotec(). Untested against a real
+//         remote, as we don't have a capture from one.
+bool IRrecv::decodeTrotec(decode_results *results, const uint16_t nbits,
+                          const bool strict) {
+  if (results->rawlen < 2 * nbits + kHeader + 2 * kFooter - 1)
+    return false;  // Can't possibly be a valid Trotec A/C message.
+  if (strict && nbits != kTrotecBits) return false;
+
+  uint16_t offset = kStartOffset;
+  // Header + Data + Footer
+  uint16_t used = matchGeneric(results->rawbuf + offset, results->state,
+                               results->rawlen - offset, nbits,
+                               kTrotecHdrMark, kTrotecHdrSpace,
+                               kTrotecOneMark, kTrotecOneSpace,
+                               kTrotecZeroMark, kTrotecZeroSpace,
+                               kTrotecOneMark, kTrotecGap, false,
+                               kUseDefTol, 0, false);
+  if (!used) return false;
+  offset += used;
+  // The rest of the footer. (See sendTrotec())
+  if (!matchMark(results->rawbuf[offset++], kTrotecOneMark)) return false;
+  if (offset < results->rawlen &&
+      !matchAtLeast(results->rawbuf[offset], kTrotecGapEnd))
+    return false;
+
+  // Compliance
+  if (strict && !IRTrotecESP::validChecksum(results->state, nbits / 8))
+    return false;
+
+  // Success
+  results->decode_type = TROTEC;
+  results->bits = nbits;
+  // No need to record the state as we stored it as we decoded it.
+  // As we use result->state, we don't record value, address, or command as it
+  // is a union data type.
+  return true;
+}
+#endif  // DECODE_TROTEC
@@ -81,6 +81,10 @@ class IRTrotecESP {
   void setTimer(const uint8_t timer);
 
   uint8_t* getRaw();
+  static uint8_t calcChecksum(const uint8_t state[],
+                              const uint16_t length = kTrotecStateLength);
+  static bool validChecksum(const uint8_t state[],
+                            const uint16_t length = kTrotecStateLength);
 
   uint8_t convertMode(const stdAc::opmode_t mode);
   uint8_t convertFan(const stdAc::fanspeed_t speed);
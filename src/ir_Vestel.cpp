@@ -58,8 +58,8 @@ IRVestelAc::IRVestelAc(uint16_t pin) : _irsend(pin) { stateReset(); }
 // Reset the state of the remote to a known good state/sequence.
 void IRVestelAc::stateReset() {
   // Power On, Mode Auto, Fan Auto, Temp = 25C/77F
-  remote_state = kVestelAcStateDefault;
-  remote_time_state = kVestelAcTimeStateDefault;
+  setState(&remote_state, kVestelAcStateDefault);
+  setState(&remote_time_state, kVestelAcTimeStateDefault);
   use_time_state = false;
 }
 
@@ -98,13 +98,13 @@ void IRVestelAc::setRaw(uint8_t* newState) {
 
 void IRVestelAc::setRaw(const uint64_t newState) {
   use_time_state = false;
-  remote_state = newState;
-  remote_time_state = newState;
+  setState(&remote_state, newState);
+  setState(&remote_time_state, newState);
   if (this->isTimeCommand()) {
     use_time_state = true;
-    remote_state = kVestelAcStateDefault;
+    setState(&remote_state, kVestelAcStateDefault);
   } else {
-    remote_time_state = kVestelAcTimeStateDefault;
+    setState(&remote_time_state, kVestelAcTimeStateDefault);
   }
 }
 
@@ -116,11 +116,8 @@ void IRVestelAc::off() { setPower(false); }
 
 // Set the requested power state of the A/C.
 void IRVestelAc::setPower(const bool state) {
-  remote_state &= ~((uint64_t)0xF << kVestelAcPowerOffset);
-  if (state)
-    remote_state |= ((uint64_t)0xF << kVestelAcPowerOffset);
-  else
-    remote_state |= ((uint64_t)0xC << kVestelAcPowerOffset);
+  setStateBits(&remote_state, kVestelAcPowerOffset, 4,
+               state ? (uint64_t)0xF : (uint64_t)0xC);
   use_time_state = false;
 }
 
@@ -135,14 +132,14 @@ void IRVestelAc::setTemp(const uint8_t temp) {
   new_temp = std::max(kVestelAcMinTempC, new_temp);
   // new_temp = std::max(kVestelAcMinTempH, new_temp); Check MODE
   new_temp = std::min(kVestelAcMaxTemp, new_temp);
-  remote_state &= ~((uint64_t)0xF << kVestelAcTempOffset);
-  remote_state |= (uint64_t)(new_temp - 16) << kVestelAcTempOffset;
+  setStateBits(&remote_state, kVestelAcTempOffset, 4,
+               (uint64_t)(new_temp - 16));
   use_time_state = false;
 }
 
 // Return the set temperature.
 uint8_t IRVestelAc::getTemp(void) {
-  return ((remote_state >> kVestelAcTempOffset) & 0xF) + 16;
+  return GETBITS64(remote_state, kVestelAcTempOffset, 4) + 16;
 }
 
 // Set the speed of the fan,
@@ -155,8 +152,7 @@ void IRVestelAc::setFan(const uint8_t fan) {
     case kVestelAcFanAutoCool:
     case kVestelAcFanAutoHot:
     case kVestelAcFanAuto:
-      remote_state &= ~((uint64_t)0xF << kVestelAcFanOffset);
-      remote_state |= (uint64_t)fan << kVestelAcFanOffset;
+      setStateBits(&remote_state, kVestelAcFanOffset, 4, (uint64_t)fan);
       break;
     default:
       setFan(kVestelAcFanAuto);
@@ -166,14 +162,14 @@ void IRVestelAc::setFan(const uint8_t fan) {
 
 // Return the requested state of the unit's fan.
 uint8_t IRVestelAc::getFan() {
-  return (remote_state >> kVestelAcFanOffset) & 0xF;
+  return GETBITS64(remote_state, kVestelAcFanOffset, 4);
 }
 
 // Get the requested climate operation mode of the a/c unit.
 // Returns:
 //   A uint8_t containing the A/C mode.
 uint8_t IRVestelAc::getMode() {
-  return (remote_state >> kVestelAcModeOffset) & 0xF;
+  return GETBITS64(remote_state, kVestelAcModeOffset, 4);
 }
 
 // Set the requested climate operation mode of the a/c unit.
@@ -185,8 +181,7 @@ void IRVestelAc::setMode(const uint8_t mode) {
     case kVestelAcHeat:
     case kVestelAcDry:
     case kVestelAcFan:
-      remote_state &= ~((uint64_t)0xF << kVestelAcModeOffset);
-      remote_state |= (uint64_t)mode << kVestelAcModeOffset;
+      setStateBits(&remote_state, kVestelAcModeOffset, 4, (uint64_t)mode);
       break;
     default:
       setMode(kVestelAcAuto);
@@ -212,26 +207,22 @@ void IRVestelAc::setAuto(const int8_t autoLevel) {
 }
 
 void IRVestelAc::setTimerActive(const bool on) {
-  if (on)  // activation
-    remote_time_state |= ((uint64_t)1 << kVestelAcTimerFlagOffset);
-  else  // deactivate
-    remote_time_state &= ~((uint64_t)1 << kVestelAcTimerFlagOffset);
+  setStateBit(&remote_time_state, kVestelAcTimerFlagOffset, on);
   use_time_state = true;
 }
 
 bool IRVestelAc::isTimerActive(void) {
-  return (remote_time_state >> kVestelAcTimerFlagOffset) & 1;
+  return GETBIT64(remote_time_state, kVestelAcTimerFlagOffset);
 }
 
 // Set Timer option of AC.
 // Valid time arguments are 0, 0.5, 1, 2, 3 and 5 hours (in min). 0 disables the
 // timer.
 void IRVestelAc::setTimer(const uint16_t minutes) {
-  // Clear both On & Off timers.
-  remote_time_state &= ~((uint64_t)0xFFFF << kVestelAcOffTimeOffset);
-  // Set the "Off" time with the nr of minutes before we turn off.
-  remote_time_state |= (uint64_t)(((minutes / 60) << 3) + (minutes % 60) / 10)
-                       << kVestelAcOffTimeOffset;
+  // Clear both On & Off timers & set the "Off" time with the nr of minutes
+  // before we turn off.
+  setStateBits(&remote_time_state, kVestelAcOffTimeOffset, 16,
+               (uint64_t)(((minutes / 60) << 3) + (minutes % 60) / 10));
   setOffTimerActive(false);
   // Yes. On Timer instead of Off timer active.
   setOnTimerActive(minutes != 0);
@@ -243,124 +234,111 @@ uint16_t IRVestelAc::getTimer(void) { return getOffTimer(); }
 
 // Set the AC's internal clock
 void IRVestelAc::setTime(const uint16_t minutes) {
-  remote_time_state &= ~((uint64_t)0x1F << kVestelAcHourOffset);
-  remote_time_state |= (uint64_t)((minutes / 60) & 0x1F)
-                       << kVestelAcHourOffset;
-  remote_time_state &= ~((uint64_t)0xFF << kVestelAcMinuteOffset);
-  remote_time_state |= (uint64_t)((minutes % 60) & 0xFF)
-                       << kVestelAcMinuteOffset;
+  setStateBits(&remote_time_state, kVestelAcHourOffset, 5,
+               (uint64_t)(minutes / 60));
+  setStateBits(&remote_time_state, kVestelAcMinuteOffset, 8,
+               (uint64_t)(minutes % 60));
   use_time_state = true;
 }
 
 uint16_t IRVestelAc::getTime(void) {
-  return ((remote_time_state >> kVestelAcHourOffset) & 0x1F) * 60 +
-         ((remote_time_state >> kVestelAcMinuteOffset) & 0xFF);
+  return GETBITS64(remote_time_state, kVestelAcHourOffset, 5) * 60 +
+         GETBITS64(remote_time_state, kVestelAcMinuteOffset, 8);
 }
 
 void IRVestelAc::setOnTimerActive(const bool on) {
-  if (on)  // activation
-    remote_time_state |= ((uint64_t)1 << kVestelAcOnTimerFlagOffset);
-  else  // deactivate
-    remote_time_state &= ~((uint64_t)1 << kVestelAcOnTimerFlagOffset);
+  setStateBit(&remote_time_state, kVestelAcOnTimerFlagOffset, on);
   use_time_state = true;
 }
 
 bool IRVestelAc::isOnTimerActive(void) {
-  return (remote_time_state >> kVestelAcOnTimerFlagOffset) & 1;
+  return GETBIT64(remote_time_state, kVestelAcOnTimerFlagOffset);
 }
 
 // Set AC's wake up time. Takes time in minute.
 void IRVestelAc::setOnTimer(const uint16_t minutes) {
-  remote_time_state &= ~((uint64_t)0xFF << kVestelAcOnTimeOffset);
-  remote_time_state |= (uint64_t)(((minutes / 60) << 3) + (minutes % 60) / 10)
-                       << kVestelAcOnTimeOffset;
+  setStateBits(&remote_time_state, kVestelAcOnTimeOffset, 8,
+               (uint64_t)(((minutes / 60) << 3) + (minutes % 60) / 10));
   setOnTimerActive(minutes != 0);
   setTimerActive(false);
   use_time_state = true;
 }
 
 uint16_t IRVestelAc::getOnTimer(void) {
-  uint8_t ontime = (remote_time_state >> kVestelAcOnTimeOffset) & 0xFF;
+  uint8_t ontime = GETBITS64(remote_time_state, kVestelAcOnTimeOffset, 8);
   return (ontime >> 3) * 60 + (ontime & 0x7) * 10;
 }
 
 void IRVestelAc::setOffTimerActive(const bool on) {
-  if (on)  // activation
-    remote_time_state |= ((uint64_t)1 << kVestelAcOffTimerFlagOffset);
-  else  // deactivate
-    remote_time_state &= ~((uint64_t)1 << kVestelAcOffTimerFlagOffset);
+  setStateBit(&remote_time_state, kVestelAcOffTimerFlagOffset, on);
   use_time_state = true;
 }
 
 bool IRVestelAc::isOffTimerActive(void) {
-  return (remote_time_state >> kVestelAcOffTimerFlagOffset) & 1;
+  return GETBIT64(remote_time_state, kVestelAcOffTimerFlagOffset);
 }
 
 // Set AC's turn off time. Takes time in minute.
 void IRVestelAc::setOffTimer(const uint16_t minutes) {
-  remote_time_state &= ~((uint64_t)0xFF << kVestelAcOffTimeOffset);
-  remote_time_state |=
-      (uint64_t)((((minutes / 60) << 3) + (minutes % 60) / 10) & 0xFF)
-      << kVestelAcOffTimeOffset;
+  setStateBits(&remote_time_state, kVestelAcOffTimeOffset, 8,
+               (uint64_t)(((minutes / 60) << 3) + (minutes % 60) / 10));
   setOffTimerActive(minutes != 0);
   setTimerActive(false);
   use_time_state = true;
 }
 
 uint16_t IRVestelAc::getOffTimer(void) {
-  uint8_t offtime = (remote_time_state >> kVestelAcOffTimeOffset) & 0xFF;
+  uint8_t offtime = GETBITS64(remote_time_state, kVestelAcOffTimeOffset, 8);
   return (offtime >> 3) * 60 + (offtime & 0x7) * 10;
 }
 
 // Set the Sleep state of the A/C.
 void IRVestelAc::setSleep(const bool state) {
-  remote_state &= ~((uint64_t)0xF << kVestelAcTurboSleepOffset);
-  remote_state |= (uint64_t)(state ? kVestelAcSleep : kVestelAcNormal)
-                  << kVestelAcTurboSleepOffset;
+  setStateBits(&remote_state, kVestelAcTurboSleepOffset, 4,
+               (uint64_t)(state ? kVestelAcSleep : kVestelAcNormal));
   use_time_state = false;
 }
 
 // Return the Sleep state of the A/C.
 bool IRVestelAc::getSleep() {
-  return ((remote_state >> kVestelAcTurboSleepOffset) & 0xF) == kVestelAcSleep;
+  return GETBITS64(remote_state, kVestelAcTurboSleepOffset, 4) ==
+         kVestelAcSleep;
 }
 
 // Set the Turbo state of the A/C.
 void IRVestelAc::setTurbo(const bool state) {
-  remote_state &= ~((uint64_t)0xF << kVestelAcTurboSleepOffset);
-  remote_state |= (uint64_t)(state ? kVestelAcTurbo : kVestelAcNormal)
-                  << kVestelAcTurboSleepOffset;
+  setStateBits(&remote_state, kVestelAcTurboSleepOffset, 4,
+               (uint64_t)(state ? kVestelAcTurbo : kVestelAcNormal));
   use_time_state = false;
 }
 
 // Return the Turbo state of the A/C.
 bool IRVestelAc::getTurbo() {
-  return ((remote_state >> kVestelAcTurboSleepOffset) & 0xF) == kVestelAcTurbo;
+  return GETBITS64(remote_state, kVestelAcTurboSleepOffset, 4) ==
+         kVestelAcTurbo;
 }
 
 // Set the Ion state of the A/C.
 void IRVestelAc::setIon(const bool state) {
-  remote_state &= ~((uint64_t)0x1 << kVestelAcIonOffset);
-
-  remote_state |= (uint64_t)(state ? 1 : 0) << kVestelAcIonOffset;
+  setStateBit(&remote_state, kVestelAcIonOffset, state);
   use_time_state = false;
 }
 
 // Return the Ion state of the A/C.
-bool IRVestelAc::getIon() { return (remote_state >> kVestelAcIonOffset) & 1; }
+bool IRVestelAc::getIon() {
+  return GETBIT64(remote_state, kVestelAcIonOffset);
+}
 
 // Set the Swing Roaming state of the A/C.
 void IRVestelAc::setSwing(const bool state) {
-  remote_state &= ~((uint64_t)0xF << kVestelAcSwingOffset);
-
-  remote_state |= (uint64_t)(state ? kVestelAcSwing : 0xF)
-                  << kVestelAcSwingOffset;
+  setStateBits(&remote_state, kVestelAcSwingOffset, 4,
+               (uint64_t)(state ? kVestelAcSwing : 0xF));
   use_time_state = false;
 }
 
 // Return the Swing Roaming state of the A/C.
 bool IRVestelAc::getSwing() {
-  return ((remote_state >> kVestelAcSwingOffset) & 0xF) == kVestelAcSwing;
+  return GETBITS64(remote_state, kVestelAcSwingOffset, 4) == kVestelAcSwing;
 }
 
 // Calculate the checksum for a given array.
@@ -385,19 +363,21 @@ uint8_t IRVestelAc::calcChecksum(const uint64_t state) {
 // Returns:
 //   A boolean.
 bool IRVestelAc::validChecksum(const uint64_t state) {
-  return (((state >> kVestelAcChecksumOffset) & 0xFF) == calcChecksum(state));
+  return (GETBITS64(state, kVestelAcChecksumOffset, 8) ==
+          calcChecksum(state));
 }
 
 // Calculate & set the checksum for the current internal state of the remote.
+// Does nothing if the state hasn't changed since the last calculation.
+// e.g. A send() followed by a getRaw() only pays for the sums once.
 void IRVestelAc::checksum() {
+  if (!_dirty) return;  // Both checksums are already current.
   // Stored the checksum value in the last byte.
-  remote_state &= ~((uint64_t)0xFF << kVestelAcChecksumOffset);
-  remote_state |= (uint64_t)calcChecksum(remote_state)
-                  << kVestelAcChecksumOffset;
-
-  remote_time_state &= ~((uint64_t)0xFF << kVestelAcChecksumOffset);
-  remote_time_state |= (uint64_t)calcChecksum(remote_time_state)
-                       << kVestelAcChecksumOffset;
+  setStateBits(&remote_state, kVestelAcChecksumOffset, 8,
+               (uint64_t)calcChecksum(remote_state));
+  setStateBits(&remote_time_state, kVestelAcChecksumOffset, 8,
+               (uint64_t)calcChecksum(remote_time_state));
+  _dirty = false;
 }
 
 bool IRVestelAc::isTimeCommand() {
@@ -11,6 +11,7 @@
 #else
 #include <string>
 #endif
+#include "IRACstate.h"
 #include "IRremoteESP8266.h"
 #include "IRsend.h"
 #ifdef UNIT_TEST
@@ -106,7 +107,7 @@ const uint8_t kVestelAcMinuteOffset = 44;
 const uint64_t kVestelAcStateDefault = 0x0F00D9001FEF201ULL;
 const uint64_t kVestelAcTimeStateDefault = 0x201ULL;
 
-class IRVestelAc {
+class IRVestelAc : public IRAC64State {
  public:
   explicit IRVestelAc(uint16_t pin);
 
@@ -39,7 +39,6 @@ const uint16_t kWhirlpoolAcOneSpace = 1649;
 const uint16_t kWhirlpoolAcZeroSpace = 533;
 const uint16_t kWhirlpoolAcGap = 7920;
 const uint32_t kWhirlpoolAcMinGap = kDefaultMessageGap;  // Just a guess.
-const uint8_t kWhirlpoolAcSections = 3;
 
 #if SEND_WHIRLPOOL_AC
 // Send a Whirlpool A/C message.
@@ -48,35 +47,43 @@ const uint8_t kWhirlpoolAcSections = 3;
 //   data: An array of bytes containing the IR command.
 //   nbytes: Nr. of bytes of data in the array. (>=kWhirlpoolAcStateLength)
 //   repeat: Nr. of times the message is to be repeated. (Default = 0).
+//   sections: Bitmask of which of the three sections to transmit.
+//             Bit 0 == section 1, etc. (Default = 0b111, i.e. all of them)
+//             The first transmitted section always carries the header.
+//             Partial messages mirror the section-only updates the real
+//             remote sends for some operations; our own decoder needs all
+//             three sections, so only send partials to an actual A/C unit.
 //
 // Status: ALPHA / Untested.
 //
 // Ref:
 //   https://github.com/markszabo/IRremoteESP8266/issues/509
 void IRsend::sendWhirlpoolAC(unsigned char data[], uint16_t nbytes,
-                             uint16_t repeat) {
+                             uint16_t repeat, uint8_t sections) {
   if (nbytes < kWhirlpoolAcStateLength)
     return;  // Not enough bytes to send a proper message.
+  sections &= 0b111;
+  if (!sections) return;  // No sections selected. Nothing to send.
+  const uint8_t sectionSize[kWhirlpoolAcSections] = {6, 8, 7};
+  // Which section is the last one we will transmit? (For the final gap.)
+  uint8_t lastsection = kWhirlpoolAcSections - 1;
+  while (!(sections & (1 << lastsection))) lastsection--;
   for (uint16_t r = 0; r <= repeat; r++) {
-    // Section 1
-    sendGeneric(kWhirlpoolAcHdrMark, kWhirlpoolAcHdrSpace, kWhirlpoolAcBitMark,
-                kWhirlpoolAcOneSpace, kWhirlpoolAcBitMark,
-                kWhirlpoolAcZeroSpace, kWhirlpoolAcBitMark, kWhirlpoolAcGap,
-                data, 6,  // 6 bytes == 48 bits
-                38000,    // Complete guess of the modulation frequency.
-                false, 0, 50);
-    // Section 2
-    sendGeneric(0, 0, kWhirlpoolAcBitMark, kWhirlpoolAcOneSpace,
-                kWhirlpoolAcBitMark, kWhirlpoolAcZeroSpace, kWhirlpoolAcBitMark,
-                kWhirlpoolAcGap, data + 6, 8,  // 8 bytes == 64 bits
-                38000,  // Complete guess of the modulation frequency.
-                false, 0, 50);
-    // Section 3
-    sendGeneric(0, 0, kWhirlpoolAcBitMark, kWhirlpoolAcOneSpace,
-                kWhirlpoolAcBitMark, kWhirlpoolAcZeroSpace, kWhirlpoolAcBitMark,
-                kWhirlpoolAcMinGap, data + 14, 7,  // 7 bytes == 56 bits
-                38000,  // Complete guess of the modulation frequency.
-                false, 0, 50);
+    bool first = true;
+    uint16_t pos = 0;
+    for (uint8_t section = 0; section < kWhirlpoolAcSections;
+         pos += sectionSize[section], section++) {
+      if (!(sections & (1 << section))) continue;  // Section isn't wanted.
+      sendGeneric(first ? kWhirlpoolAcHdrMark : 0,
+                  first ? kWhirlpoolAcHdrSpace : 0, kWhirlpoolAcBitMark,
+                  kWhirlpoolAcOneSpace, kWhirlpoolAcBitMark,
+                  kWhirlpoolAcZeroSpace, kWhirlpoolAcBitMark,
+                  section == lastsection ? kWhirlpoolAcMinGap : kWhirlpoolAcGap,
+                  data + pos, sectionSize[section],
+                  38000,  // Complete guess of the modulation frequency.
+                  false, 0, 50);
+      first = false;
+    }
   }
 }
 #endif  // SEND_WHIRLPOOL_AC
@@ -85,13 +92,15 @@ void IRsend::sendWhirlpoolAC(unsigned char data[], uint16_t nbytes,
 // Decoding help from:
 //   @redmusicxd, @josh929800, @raducostea
 
-IRWhirlpoolAc::IRWhirlpoolAc(uint16_t pin) : _irsend(pin) { stateReset(); }
+IRWhirlpoolAc::IRWhirlpoolAc(uint16_t pin) : _irsend(pin) {
+  _prev_valid = false;  // Nothing has been transmitted yet.
+  _pending_clock = -1;  // No deferred clock refresh waiting.
+  stateReset();
+}
 
 void IRWhirlpoolAc::stateReset() {
-  for (uint8_t i = 2; i < kWhirlpoolAcStateLength; i++) remote_state[i] = 0x0;
-  remote_state[0] = 0x83;
-  remote_state[1] = 0x06;
-  remote_state[6] = 0x80;
+  copyBytes_P(remote_state, kWhirlpoolAcKnownGoodState,
+              kWhirlpoolAcStateLength);
   _setTemp(kWhirlpoolAcAutoTemp);  // Default to a sane value.
 }
 
@@ -128,8 +137,58 @@ void IRWhirlpoolAc::checksum(uint16_t length) {
 
 #if SEND_WHIRLPOOL_AC
 void IRWhirlpoolAc::send(const uint16_t repeat, const bool calcchecksum) {
+  if (_pending_clock >= 0) {  // A deferred clock refresh. Stamp it now.
+    setTime(kWhirlpoolAcClockPos, _pending_clock);
+    _pending_clock = -1;
+  }
   if (calcchecksum) checksum();
   _irsend.sendWhirlpoolAC(remote_state, kWhirlpoolAcStateLength, repeat);
+  // Remember what we sent, for sendDiff().
+  copyBytes(remote_prev, remote_state, kWhirlpoolAcStateLength);
+  _prev_valid = true;
+}
+
+// Send only the sections that changed since the last transmission, the way
+// the real remote updates just the relevant sections for some operations.
+// e.g. The common temperature-only change goes out as sections 1 & 2 (the
+// second carries the first checksum), a command/timer-only change as just
+// section 3. Falls back to a full send if nothing was sent before. Note:
+// our own decoder expects all three sections, so use send() when the
+// receiver is another IRremoteESP8266 instance rather than an A/C unit.
+//
+// Args:
+//   repeat: Nr. of times the message will be repeated, if it is sent.
+// Returns:
+//   A boolean indicating if anything was actually transmitted.
+bool IRWhirlpoolAc::sendDiff(const uint16_t repeat) {
+  checksum();
+  const uint8_t sectionSize[kWhirlpoolAcSections] = {6, 8, 7};
+  uint8_t sections = 0;
+  if (_prev_valid) {
+    uint16_t pos = 0;
+    for (uint8_t section = 0; section < kWhirlpoolAcSections;
+         pos += sectionSize[section], section++)
+      if (!equalBytes(remote_state + pos, remote_prev + pos,
+                      sectionSize[section]))
+        sections |= 1 << section;
+    if (!sections) return false;  // Nothing changed. Skip the send.
+  } else {
+    sections = 0b111;  // No previous message. Send everything.
+  }
+  // We are definitely transmitting, so stamp in any deferred clock refresh.
+  // Doing it only now, after the change check, means a clock tick alone
+  // can't trigger a transmission. (See setClock())
+  if (_pending_clock >= 0) {
+    setTime(kWhirlpoolAcClockPos, _pending_clock);
+    _pending_clock = -1;
+    checksum();
+    sections |= 0b010;  // The clock lives in the 2nd section.
+  }
+  _irsend.sendWhirlpoolAC(remote_state, kWhirlpoolAcStateLength, repeat,
+                          sections);
+  copyBytes(remote_prev, remote_state, kWhirlpoolAcStateLength);
+  _prev_valid = true;
+  return true;
 }
 #endif  // SEND_WHIRLPOOL_AC
 
@@ -139,8 +198,8 @@ uint8_t *IRWhirlpoolAc::getRaw(const bool calcchecksum) {
 }
 
 void IRWhirlpoolAc::setRaw(const uint8_t new_code[], const uint16_t length) {
-  for (uint8_t i = 0; i < length && i < kWhirlpoolAcStateLength; i++)
-    remote_state[i] = new_code[i];
+  copyBytes(remote_state, new_code,
+            std::min(length, (uint16_t)kWhirlpoolAcStateLength));
 }
 
 whirlpool_ac_remote_model_t IRWhirlpoolAc::getModel() {
@@ -299,10 +358,52 @@ void IRWhirlpoolAc::enableTimer(const uint16_t pos, const bool state) {
     remote_state[pos - 1] &= ~kWhirlpoolAcTimerEnableMask;
 }
 
-void IRWhirlpoolAc::setClock(const uint16_t minspastmidnight) {
+// Set the unit's clock.
+// Args:
+//   minspastmidnight: The time, as the Nr. of minutes past midnight.
+//   on_send_only: When true, don't touch the message now. The clock is
+//       only stamped in when send()/sendDiff() next transmits a real
+//       command. This stops periodic clock refreshes from making the state
+//       look changed to shadow-copy comparisons & from triggering phantom
+//       sendDiff() transmissions. (See sameSettings())
+void IRWhirlpoolAc::setClock(const uint16_t minspastmidnight,
+                             const bool on_send_only) {
+  if (on_send_only) {
+    _pending_clock = minspastmidnight % (24 * 60);
+    return;
+  }
+  _pending_clock = -1;  // An immediate set overrides any deferred one.
   setTime(kWhirlpoolAcClockPos, minspastmidnight);
 }
 
+// Compare two Whirlpool A/C states, ignoring the volatile clock fields &
+// the checksum bytes they perturb.
+// i.e. Would the two states command the same settings?
+// Args:
+//   a: Ptr to a kWhirlpoolAcStateLength byte state.
+//   b: Ptr to another kWhirlpoolAcStateLength byte state.
+// Returns:
+//   A boolean. true if nothing but the clock (& checksums) differs.
+bool IRWhirlpoolAc::sameSettings(const uint8_t a[], const uint8_t b[]) {
+  for (uint8_t i = 0; i < kWhirlpoolAcStateLength; i++) {
+    uint8_t mask = 0xFF;
+    switch (i) {
+      case kWhirlpoolAcClockPos:  // The hour bits of the clock.
+        mask = ~kWhirlpoolAcHourMask;
+        break;
+      case kWhirlpoolAcClockPos + 1:  // The minute bits of the clock.
+        mask = ~kWhirlpoolAcMinuteMask;
+        break;
+      case kWhirlpoolAcChecksumByte1:  // Derived data. Ignore entirely.
+      case kWhirlpoolAcChecksumByte2:
+        mask = 0;
+        break;
+    }
+    if ((a[i] & mask) != (b[i] & mask)) return false;
+  }
+  return true;
+}
+
 uint16_t IRWhirlpoolAc::getClock() { return getTime(kWhirlpoolAcClockPos); }
 
 void IRWhirlpoolAc::setOffTimer(const uint16_t minspastmidnight) {
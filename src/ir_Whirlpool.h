@@ -28,6 +28,7 @@
 //   https://github.com/markszabo/IRremoteESP8266/issues/509
 
 // Constants
+const uint8_t kWhirlpoolAcSections = 3;
 const uint8_t kWhirlpoolAcChecksumByte1 = 13;
 const uint8_t kWhirlpoolAcChecksumByte2 = kWhirlpoolAcStateLength - 1;
 const uint8_t kWhirlpoolAcHeat = 0;
@@ -79,10 +80,11 @@ const uint8_t kWhirlpoolAcCommandOffTimer = 0x1D;
 const uint8_t kWhirlpoolAcAltTempMask = 0b00001000;
 const uint8_t kWhirlpoolAcAltTempPos = 18;
 
-enum whirlpool_ac_remote_model_t {
-  DG11J13A = 1,  // DG11J1-04 too
-  DG11J191,
-};
+// The default (reset) state.
+const uint8_t kWhirlpoolAcKnownGoodState[kWhirlpoolAcStateLength] PROGMEM = {
+    0x83, 0x06, 0x00, 0x00, 0x00, 0x00, 0x80,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 
 // Classes
 class IRWhirlpoolAc {
@@ -93,6 +95,7 @@ class IRWhirlpoolAc {
 #if SEND_WHIRLPOOL_AC
   void send(const uint16_t repeat = kWhirlpoolAcDefaultRepeat,
             const bool calcchecksum = true);
+  bool sendDiff(const uint16_t repeat = kWhirlpoolAcDefaultRepeat);
 #endif  // SEND_WHIRLPOOL_AC
   void begin();
   void on();
@@ -114,7 +117,8 @@ class IRWhirlpoolAc {
   void setLight(const bool on);
   bool getLight();
   uint16_t getClock();
-  void setClock(const uint16_t minspastmidnight);
+  void setClock(const uint16_t minspastmidnight,
+                const bool on_send_only = false);
   uint16_t getOnTimer();
   void setOnTimer(const uint16_t minspastmidnight);
   void enableOnTimer(const bool state);
@@ -132,6 +136,7 @@ class IRWhirlpoolAc {
               const uint16_t length = kWhirlpoolAcStateLength);
   static bool validChecksum(uint8_t state[],
                             const uint16_t length = kWhirlpoolAcStateLength);
+  static bool sameSettings(const uint8_t a[], const uint8_t b[]);
   uint8_t convertMode(const stdAc::opmode_t mode);
   uint8_t convertFan(const stdAc::fanspeed_t speed);
 #ifdef ARDUINO
@@ -148,7 +153,13 @@ class IRWhirlpoolAc {
 #endif
   // The state of the IR remote in IR code form.
   uint8_t remote_state[kWhirlpoolAcStateLength];
+  // The state as it was last transmitted. See sendDiff().
+  uint8_t remote_prev[kWhirlpoolAcStateLength];
+  bool _prev_valid;
   uint8_t _desiredtemp;
+  // A clock value to be stamped into the message at send() time.
+  // -1 means there isn't one pending. See setClock().
+  int16_t _pending_clock;
   void checksum(const uint16_t length = kWhirlpoolAcStateLength);
   uint16_t getTime(const uint16_t pos);
   void setTime(const uint16_t pos, const uint16_t minspastmidnight);
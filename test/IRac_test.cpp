@@ -1,6 +1,7 @@
 // Copyright 2019 David Conran
 
 #include "ir_Argo.h"
+#include "ir_Coolix.h"
 #include "ir_Daikin.h"
 #include "ir_Fujitsu.h"
 #include "ir_Gree.h"
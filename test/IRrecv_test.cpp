@@ -108,6 +108,55 @@ TEST(TestCopyIrParams, CopyNonEmpty) {
   EXPECT_EQ(0xDEAD, dst.rawbuf[test_size - 1]);
 }
 
+// Tests for swapIrParams()
+
+TEST(TestSwapIrParams, SwapTradesBufferPointers) {
+  IRrecv irrecv(1, 100, 15, true);  // i.e. With an internal save buffer.
+  uint16_t *live = irrecv.irparams.rawbuf;
+  uint16_t *saved = irrecv.irparams_save->rawbuf;
+  ASSERT_NE(live, saved);
+  irrecv.irparams.rawlen = 5;
+  irrecv.irparams.overflow = true;
+  live[1] = 0xBEEF;
+
+  irrecv.swapIrParams(&irrecv.irparams, irrecv.irparams_save);
+
+  // The buffers changed hands. Nothing was copied.
+  EXPECT_EQ(saved, irrecv.irparams.rawbuf);
+  EXPECT_EQ(live, irrecv.irparams_save->rawbuf);
+  EXPECT_EQ(0xBEEF, irrecv.irparams_save->rawbuf[1]);
+  // The scalar capture state went with the capture.
+  EXPECT_EQ(5, irrecv.irparams_save->rawlen);
+  EXPECT_TRUE(irrecv.irparams_save->overflow);
+}
+
+// decode() with the internal save buffer should swap the capture out of the
+// interrupt's buffer, not copy it.
+TEST(TestSwapIrParams, DecodeSwapsNotCopies) {
+  IRsendTest irsend(0);
+  IRrecv irrecv(1, 100, 15, true);  // i.e. save_buffer enabled.
+  irsend.begin();
+  irsend.reset();
+  irsend.sendNEC(0x807F40BF);
+  irsend.makeDecodeResult();
+  // Plant the capture in the interrupt's buffer, as gpio_intr() would have.
+  uint16_t *live = irrecv.irparams.rawbuf;
+  for (uint16_t i = 0; i < irsend.capture.rawlen; i++)
+    live[i] = irsend.capture.rawbuf[i];
+  irrecv.irparams.rawlen = irsend.capture.rawlen;
+  irrecv.irparams.overflow = false;
+  irrecv.irparams.rcvstate = kStopState;
+
+  decode_results results;
+  ASSERT_TRUE(irrecv.decode(&results));
+  EXPECT_EQ(NEC, results.decode_type);
+  EXPECT_EQ(0x807F40BF, results.value);
+  // We decoded straight out of the old interrupt buffer, & the interrupt
+  // was handed the (interchangeable) save buffer in exchange.
+  EXPECT_EQ(live, results.rawbuf);
+  EXPECT_NE(live, irrecv.irparams.rawbuf);
+}
+
 // Tests for decode().
 
 // Test decode of a NEC message.
@@ -559,3 +608,157 @@ TEST(TestMatchData, ArbitraryEncoded) {
   result = irrecv.matchData(irsend.capture.rawbuf + 1, 5, 1000, 500, 500, 1000);
   ASSERT_FALSE(result.success);
 }
+
+// Tests for setFrameQueue(). The queue's push side lives in gpio_intr(), so
+// these cover the ownership/lifecycle rules & the consumer's empty-queue
+// behaviour.
+TEST(TestFrameQueue, OwnershipAndLifecycle) {
+  IRrecv irrecv(1, 100);
+  IRrecv other(2, 100);
+  ASSERT_TRUE(irrecv.setFrameQueue(2));
+  // The queue's buffers are (single) globals: one receiver at a time.
+  EXPECT_FALSE(other.setFrameQueue(2));
+  // In frame-queued mode an empty queue just means nothing to decode yet.
+  decode_results results;
+  EXPECT_FALSE(irrecv.decode(&results));
+  // Resizing our own queue is fine, & disabling it frees it up for others.
+  ASSERT_TRUE(irrecv.setFrameQueue(3));
+  ASSERT_TRUE(irrecv.setFrameQueue(0));
+  EXPECT_TRUE(other.setFrameQueue(1));
+  ASSERT_TRUE(other.setFrameQueue(0));
+}
+
+// Tests for decodePoll().
+
+TEST(TestDecodePoll, MidCaptureDecode) {
+  IRsendTest irsend(0);
+  IRrecv irrecv(1);
+  irsend.begin();
+  irsend.reset();
+  irsend.sendNEC(0x807F40BF);
+  irsend.makeDecodeResult();
+  // Plant the (in progress) capture in the interrupt's buffer.
+  for (uint16_t i = 0; i < irsend.capture.rawlen; i++)
+    irrecv.irparams.rawbuf[i] = irsend.capture.rawbuf[i];
+  irrecv.irparams.rawlen = irsend.capture.rawlen;
+  irrecv.irparams.rcvstate = kMarkState;  // i.e. Still capturing.
+
+  decode_results results;
+  // The first sighting of this capture length only establishes quiet time.
+  EXPECT_FALSE(irrecv.decodePoll(&results));
+  // No new edges since the last poll: the early decode attempt runs.
+  ASSERT_TRUE(irrecv.decodePoll(&results));
+  EXPECT_EQ(NEC, results.decode_type);
+  EXPECT_EQ(kNECBits, results.bits);
+  EXPECT_EQ(0x807F40BF, results.value);
+  // Success threw the remainder of the capture away, so the message can't
+  // be reported a second time when the gap/timeout finally expires.
+  EXPECT_EQ(0, irrecv.irparams.rawlen);
+}
+
+TEST(TestDecodePoll, CompletedCaptureUsesTheNormalPath) {
+  IRsendTest irsend(0);
+  IRrecv irrecv(1);
+  irsend.begin();
+  irsend.reset();
+  irsend.sendNEC(0x807F40BF);
+  irsend.makeDecodeResult();
+  for (uint16_t i = 0; i < irsend.capture.rawlen; i++)
+    irrecv.irparams.rawbuf[i] = irsend.capture.rawbuf[i];
+  irrecv.irparams.rawlen = irsend.capture.rawlen;
+  irrecv.irparams.rcvstate = kStopState;  // i.e. The capture is complete.
+
+  decode_results results;
+  results.rawbuf = irrecv.irparams.rawbuf;
+  results.rawlen = irrecv.irparams.rawlen;
+  results.overflow = false;
+  // A completed capture decodes on the first call, like decode() would.
+  ASSERT_TRUE(irrecv.decodePoll(&results));
+  EXPECT_EQ(NEC, results.decode_type);
+  EXPECT_EQ(0x807F40BF, results.value);
+}
+
+// Tests for setAdaptiveBufSize() / getBufHighWaterMark().
+
+TEST(TestAdaptiveBufSize, GrowOnOverflow) {
+  IRrecv irrecv(1, 32);
+  EXPECT_EQ(32, irrecv.getBufSize());
+  EXPECT_EQ(0, irrecv.getBufHighWaterMark());
+  // An empty capture for the decoders to (quickly) fail on; the adaptive
+  // bookkeeping we are testing works off irparams, not the results.
+  decode_results results;
+  uint16_t dummy[2] = {0, 0};
+  results.rawbuf = dummy;
+  results.rawlen = 0;
+  results.overflow = false;
+
+  // The high-water mark tracks every capture, even with growth off.
+  irrecv.irparams.rawlen = 20;
+  irrecv.irparams.overflow = false;
+  irrecv.decode(&results);
+  EXPECT_EQ(20, irrecv.getBufHighWaterMark());
+  EXPECT_EQ(32, irrecv.getBufSize());
+  // An overflow without setAdaptiveBufSize() doesn't grow anything. (The
+  // legacy behaviour.)
+  irrecv.irparams.rawlen = 32;
+  irrecv.irparams.overflow = true;
+  irrecv.decode(&results);
+  EXPECT_EQ(32, irrecv.getBufSize());
+
+  // With growth enabled, an overflow doubles the buffer & the (truncated)
+  // capture awaiting decode survives the move.
+  irrecv.setAdaptiveBufSize(100);
+  irrecv.irparams.rawlen = 32;
+  irrecv.irparams.overflow = true;
+  irrecv.irparams.rawbuf[1] = 0x1234;  // Canary.
+  irrecv.decode(&results);
+  EXPECT_EQ(64, irrecv.getBufSize());
+  EXPECT_EQ(0x1234, irrecv.irparams.rawbuf[1]);
+  // The next tier is clipped to the cap, & the cap is never exceeded.
+  irrecv.irparams.rawlen = 64;
+  irrecv.irparams.overflow = true;
+  irrecv.decode(&results);
+  EXPECT_EQ(100, irrecv.getBufSize());
+  irrecv.irparams.rawlen = 100;
+  irrecv.irparams.overflow = true;
+  irrecv.decode(&results);
+  EXPECT_EQ(100, irrecv.getBufSize());
+  EXPECT_EQ(100, irrecv.getBufHighWaterMark());
+}
+
+TEST(TestAdaptiveBufSize, CallerProvidedBuffersNeverGrow) {
+  // Growth needs library-owned heap buffers. Caller-provided (e.g. static)
+  // buffers keep the zero-heap promise & must be left alone.
+  uint16_t rawbuf[32];
+  IRrecv irrecv(1, rawbuf, 32);
+  irrecv.setAdaptiveBufSize(100);
+  decode_results results;
+  uint16_t dummy[2] = {0, 0};
+  results.rawbuf = dummy;
+  results.rawlen = 0;
+  results.overflow = false;
+  irrecv.irparams.rawlen = 32;
+  irrecv.irparams.overflow = true;
+  irrecv.decode(&results);
+  EXPECT_EQ(32, irrecv.getBufSize());
+  EXPECT_EQ(rawbuf, irrecv.irparams.rawbuf);
+}
+
+// Tests for the decode scratch arena. See scratch().
+
+TEST(TestScratch, FixedArena) {
+  IRrecv irrecv(1);
+  void *arena = irrecv.scratch(1);
+  ASSERT_TRUE(arena != NULL);
+  // It's 32-bit aligned, so borrowed bounds tables etc. can live in it.
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(arena) % sizeof(uint32_t));
+  // Borrowing again hands out the same (single) workspace, right up to its
+  // full size. i.e. No heap activity, ever.
+  EXPECT_EQ(arena, irrecv.scratch(kDecodeScratchSize));
+  // A request it can't hold is refused, not silently truncated.
+  EXPECT_TRUE(irrecv.scratch(kDecodeScratchSize + 1) == NULL);
+  // Successive borrowers share the memory: what one leaves behind, the
+  // next can (knowingly) re-read. i.e. How prescan artifacts are shared.
+  reinterpret_cast<uint8_t *>(arena)[0] = 0xA5;
+  EXPECT_EQ(0xA5, reinterpret_cast<uint8_t *>(irrecv.scratch(16))[0]);
+}
@@ -673,14 +673,139 @@ TEST(TestSend, GenericSimpleSendMethodFailure) {
   for (int i = 0; i < 200; i++) {
     if (hasACState((decode_type_t)i) && i != GREE) {  // Gree is an exception.
       // Check it fails.
-      ASSERT_FALSE(irsend.send((decode_type_t)i, 0, 0));
+      // (uint64_t)0: pick the simple-send overload over the state[] one.
+      ASSERT_FALSE(irsend.send((decode_type_t)i, (uint64_t)0, 0));
     }
   }
 
   // Test some other special cases.
-  ASSERT_FALSE(irsend.send(UNKNOWN, 0, 0));
-  ASSERT_FALSE(irsend.send(UNUSED, 0, 0));
-  ASSERT_FALSE(irsend.send(RAW, 0, 0));
-  ASSERT_FALSE(irsend.send(PRONTO, 0, 0));
-  ASSERT_FALSE(irsend.send(GLOBALCACHE, 0, 0));
+  ASSERT_FALSE(irsend.send(UNKNOWN, (uint64_t)0, 0));
+  ASSERT_FALSE(irsend.send(UNUSED, (uint64_t)0, 0));
+  ASSERT_FALSE(irsend.send(RAW, (uint64_t)0, 0));
+  ASSERT_FALSE(irsend.send(PRONTO, (uint64_t)0, 0));
+  ASSERT_FALSE(irsend.send(GLOBALCACHE, (uint64_t)0, 0));
+}
+
+// Tests for the async send queue. (setSendQueue() et al.)
+
+static uint16_t sendqueue_done_calls = 0;
+static void sendQueueDone(void) { sendqueue_done_calls++; }
+
+TEST(TestSendQueue, CompileParkAndDrain) {
+  // A low-level test instance: the real mark()/space() run, so compiling
+  // to a pulse train works, & transmission shows up as LED activity.
+  IRsendLowLevelTest irsend(4);
+  irsend.begin();
+  sendqueue_done_calls = 0;
+  // Without a queue, sendQueued() degrades to a blocking send, so the
+  // command completes before it returns.
+  EXPECT_TRUE(irsend.sendQueued(NEC, 0x4BB4F00F, kNECBits, &sendQueueDone));
+  EXPECT_EQ(1, sendqueue_done_calls);
+  EXPECT_EQ(0, irsend.sendQueueLoop());  // Nothing was parked.
+
+  ASSERT_TRUE(irsend.setSendQueue(4, 512));
+  irsend.reset();
+  EXPECT_TRUE(irsend.sendQueued(NEC, 0x4BB4F00F, kNECBits, &sendQueueDone));
+  // Parked, not transmitted: no LED activity & no completion yet.
+  EXPECT_EQ("", irsend.low_level_sequence);
+  EXPECT_EQ(1, sendqueue_done_calls);
+  // The first drain call transmits the frame itself.
+  EXPECT_EQ(1, irsend.sendQueueLoop());
+  EXPECT_NE("", irsend.low_level_sequence);
+  // The trailing gap was too long for a pulse train entry, so it became a
+  // timed pre-delay on a follow-up message. Until the gap has elapsed that
+  // message (& with it the completion callback) must wait.
+  EXPECT_EQ(1, sendqueue_done_calls);
+  EXPECT_EQ(0, irsend.sendQueueLoop());
+  _IRtimer_unittest_now += 200000;  // Wait out the gap.
+  EXPECT_EQ(1, irsend.sendQueueLoop());
+  EXPECT_EQ(2, sendqueue_done_calls);  // Now the command is complete.
+  EXPECT_EQ(0, irsend.sendQueueLoop());  // The queue is empty again.
+  irsend.setSendQueue(0, 0);  // Tear down.
+}
+
+TEST(TestSendQueue, RingCapacity) {
+  IRsendLowLevelTest irsend(4);
+  irsend.begin();
+  ASSERT_TRUE(irsend.setSendQueue(2, 64));  // Room for two messages.
+  for (uint16_t i = 0; i < 2; i++) {
+    ASSERT_TRUE(irsend.queueBegin());
+    irsend.enableIROut(38000);
+    irsend.mark(500);
+    EXPECT_TRUE(irsend.queueCommit());
+  }
+  // The ring is full: a third message is refused & discarded.
+  ASSERT_TRUE(irsend.queueBegin());
+  irsend.enableIROut(38000);
+  irsend.mark(500);
+  EXPECT_FALSE(irsend.queueCommit());
+  // One message per drain call, so a burst keeps the loop responsive.
+  EXPECT_EQ(1, irsend.sendQueueLoop());
+  EXPECT_EQ(1, irsend.sendQueueLoop());
+  EXPECT_EQ(0, irsend.sendQueueLoop());
+  irsend.setSendQueue(0, 0);  // Tear down.
+}
+
+// Tests for the replay dispatch. i.e. Sending a captured decode_results
+// back out, incl. the state[] (A/C) protocols & batches.
+
+TEST(TestSend, SendDecodeResults) {
+  IRsendTest irsend(0);
+  irsend.begin();
+
+  // A simple (<= 64 bit) protocol replays from value/bits.
+  decode_results results;
+  results.decode_type = NEC;
+  results.value = 0x807F40BF;
+  results.bits = kNECBits;
+  irsend.reset();
+  ASSERT_TRUE(irsend.send(results));
+  std::string replayed = irsend.outputStr();
+  irsend.reset();
+  irsend.sendNEC(0x807F40BF);
+  EXPECT_EQ(irsend.outputStr(), replayed);
+
+  // A state-based (A/C) protocol replays from state[]/bits.
+  uint8_t state[kKelvinatorStateLength] = {
+      0x19, 0x0B, 0x80, 0x50, 0x00, 0x00, 0x00, 0x70,
+      0x19, 0x0B, 0x80, 0x70, 0x00, 0x00, 0x10, 0xF0};
+  results.decode_type = KELVINATOR;
+  results.bits = kKelvinatorBits;
+  for (uint8_t i = 0; i < kKelvinatorStateLength; i++)
+    results.state[i] = state[i];
+  irsend.reset();
+  ASSERT_TRUE(irsend.send(results));
+  replayed = irsend.outputStr();
+  irsend.reset();
+  irsend.sendKelvinator(state);
+  EXPECT_EQ(irsend.outputStr(), replayed);
+
+  // An undecoded capture can't be replayed.
+  results.decode_type = UNKNOWN;
+  ASSERT_FALSE(irsend.send(results));
+}
+
+TEST(TestSend, SendBatch) {
+  IRsendTest irsend(0);
+  irsend.begin();
+  decode_results batch[2];
+  batch[0].decode_type = NEC;
+  batch[0].value = 0x807F40BF;
+  batch[0].bits = kNECBits;
+  batch[1].decode_type = SAMSUNG;
+  batch[1].value = 0xE0E09966;
+  batch[1].bits = kSamsungBits;
+
+  sendqueue_done_calls = 0;
+  irsend.reset();
+  ASSERT_TRUE(irsend.sendBatch(batch, 2, 100000, &sendQueueDone));
+  // A blocking (no queue) batch has completed by the time it returns.
+  EXPECT_EQ(1, sendqueue_done_calls);
+  std::string batched = irsend.outputStr();
+  // i.e. The messages back to back, with the requested gap between them.
+  irsend.reset();
+  irsend.sendNEC(0x807F40BF);
+  irsend.addGap(100000);
+  irsend.sendSAMSUNG(0xE0E09966);
+  EXPECT_EQ(irsend.outputStr(), batched);
 }
@@ -415,3 +415,61 @@ TEST(TestUtils, htmlEscape) {
       "&amp;quot&semi;&amp;lt&semi;&amp;apos&semi;&amp;gt&semi;&amp;amp&semi;",
       htmlEscape("&quot;&lt;&apos;&gt;&amp;"));
 }
+
+TEST(TestIRStringBuf, BasicAppends) {
+  char buffer[64];
+  IRStringBuf out(buffer, sizeof(buffer));
+  EXPECT_STREQ("", out.c_str());
+  EXPECT_EQ(0, out.length());
+  out.add("Power");
+  out.add(':');
+  out.add(' ');
+  out.addBool(true);
+  out.add(", Temp: ");
+  out.addUint(25);
+  out.add('C');
+  EXPECT_STREQ("Power: On, Temp: 25C", out.c_str());
+  EXPECT_EQ(20, out.length());
+  EXPECT_FALSE(out.overflowed());
+  out.reset();
+  EXPECT_STREQ("", out.c_str());
+  EXPECT_EQ(0, out.length());
+  out.addBool(false);
+  out.add(", 0x");
+  out.addUint(0xDEAD, 16);
+  EXPECT_STREQ("Off, 0xDEAD", out.c_str());
+}
+
+TEST(TestIRStringBuf, TruncationStaysTerminated) {
+  char buffer[8];
+  // Poison the buffer so unterminated output is visible.
+  memset(buffer, 0x7F, sizeof(buffer));
+  IRStringBuf out(buffer, sizeof(buffer));
+  out.add("1234");
+  EXPECT_FALSE(out.overflowed());
+  // Too long: must truncate mid-string but still NUL-terminate.
+  out.add("5678");
+  EXPECT_TRUE(out.overflowed());
+  EXPECT_STREQ("1234567", out.c_str());
+  EXPECT_EQ(7, out.length());
+  // Further appends of any flavour must not break the termination.
+  out.add('X');
+  EXPECT_STREQ("1234567", out.c_str());
+  out.addUint(42);
+  EXPECT_STREQ("1234567", out.c_str());
+  EXPECT_TRUE(out.overflowed());
+  // A reset clears the overflow state & makes the buffer usable again.
+  out.reset();
+  EXPECT_FALSE(out.overflowed());
+  out.add("ok");
+  EXPECT_STREQ("ok", out.c_str());
+}
+
+TEST(TestIRStringBuf, ZeroAndOneSizedBuffers) {
+  char buffer[1] = {0x7F};
+  IRStringBuf tiny(buffer, sizeof(buffer));
+  EXPECT_STREQ("", tiny.c_str());
+  tiny.add("anything");
+  EXPECT_TRUE(tiny.overflowed());
+  EXPECT_STREQ("", tiny.c_str());
+}
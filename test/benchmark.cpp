@@ -0,0 +1,125 @@
+// Copyright 2019 David Conran
+
+// Microbenchmarks for the library's decode & send hot paths.
+//
+// Build & run with:  make run_benchmark
+// (Not part of 'make run'; it measures speed, not correctness.)
+//
+// Canned captures (NEC, RC6, Daikin2 & unmatchable noise) are pushed
+// through IRrecv::decode(), and canned messages through the IRsendTest
+// timing-collection mocks, reporting ns/op & ops/sec per scenario.
+// Absolute numbers are host dependent. Track the relative movement
+// between releases to catch regressions. e.g. A new decoder added early
+// in the decode() chain slowing every UNKNOWN capture down.
+// Note: For the most representative numbers, build everything optimised:
+//   make clean; make CXXFLAGS="-O2 -std=gnu++11 -pthread" benchmark
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include "IRrecv.h"
+#include "IRsend.h"
+#include "IRsend_test.h"
+#include "IRutils.h"
+#include "ir_Daikin.h"
+
+// Run `body` `iterations` times & report how fast it was.
+template <typename F>
+static void bench(const char *name, const uint32_t iterations, F body) {
+  typedef std::chrono::steady_clock clock;
+  clock::time_point start = clock::now();
+  for (uint32_t i = 0; i < iterations; i++) body();
+  double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  clock::now() - start).count();
+  std::printf("%-24s %12.1f ns/op %15.0f ops/sec  (%u iterations)\n", name,
+              ns / iterations, 1e9 * iterations / ns, iterations);
+}
+
+// Check the canned capture decodes as we expect before we time it, so a
+// scenario can't silently degrade into benchmarking the wrong code path.
+static bool expectType(IRrecv *irrecv, decode_results *capture,
+                       const decode_type_t expected, const char *name) {
+  if (!irrecv->decode(capture) || capture->decode_type != expected) {
+    std::printf("%-24s SKIPPED. (Capture decoded as type %d, expected %d)\n",
+                name, capture->decode_type, expected);
+    return false;
+  }
+  return true;
+}
+
+int main() {
+  IRsendTest irsend(0);
+  IRrecv irrecv(1);
+  irsend.begin();
+
+  // An arbitrary but checksum-valid Daikin2 state.
+  uint8_t daikin2[kDaikin2StateLength];
+  for (uint16_t i = 0; i < kDaikin2StateLength; i++)
+    daikin2[i] = (uint8_t)(i * 3 + 1);
+  daikin2[kDaikin2Section1Length - 1] =
+      sumBytes(daikin2, kDaikin2Section1Length - 1);
+  daikin2[kDaikin2StateLength - 1] =
+      sumBytes(daikin2 + kDaikin2Section1Length,
+               kDaikin2StateLength - kDaikin2Section1Length - 1);
+
+  // ---- decode() scenarios ----
+
+  irsend.reset();
+  irsend.sendNEC(0x807F40BF);
+  irsend.makeDecodeResult();
+  if (expectType(&irrecv, &irsend.capture, NEC, "decode(NEC)"))
+    bench("decode(NEC)", 100000, [&]() { irrecv.decode(&irsend.capture); });
+
+  IRsendTest rc6send(0);
+  rc6send.begin();
+  rc6send.reset();
+  rc6send.sendRC6(0x175, kRC6Mode0Bits);
+  rc6send.makeDecodeResult();
+  if (expectType(&irrecv, &rc6send.capture, RC6, "decode(RC6)"))
+    bench("decode(RC6)", 100000, [&]() { irrecv.decode(&rc6send.capture); });
+
+  IRsendTest dai2send(0);
+  dai2send.begin();
+  dai2send.reset();
+  dai2send.sendDaikin2(daikin2);
+  dai2send.makeDecodeResult();
+  if (expectType(&irrecv, &dai2send.capture, DAIKIN2, "decode(DAIKIN2)"))
+    bench("decode(DAIKIN2)", 20000,
+          [&]() { irrecv.decode(&dai2send.capture); });
+
+  // Unmatchable noise. i.e. The worst case: every decoder is attempted &
+  // fails, then decodeHash() reports it as UNKNOWN.
+  IRsendTest noisesend(0);
+  noisesend.begin();
+  noisesend.reset();
+  uint32_t seed = 0xDEADBEEF;  // Simple LCG so runs are reproducible.
+  for (uint16_t i = 0; i < 75; i++) {
+    seed = seed * 1103515245 + 12345;
+    noisesend.mark(100 + ((seed >> 16) % 1400));
+    seed = seed * 1103515245 + 12345;
+    noisesend.space(100 + ((seed >> 16) % 1400));
+  }
+  noisesend.makeDecodeResult();
+  if (expectType(&irrecv, &noisesend.capture, UNKNOWN, "decode(noise)"))
+    bench("decode(noise)", 10000,
+          [&]() { irrecv.decode(&noisesend.capture); });
+
+  // ---- send scenarios (into the timing-collection mock) ----
+
+  bench("sendNEC(32 bits)", 50000, [&]() {
+    irsend.reset();
+    irsend.sendNEC(0x807F40BF);
+  });
+
+  bench("sendRC6(20 bits)", 50000, [&]() {
+    irsend.reset();
+    irsend.sendRC6(0x175, kRC6Mode0Bits);
+  });
+
+  bench("sendDaikin2(state)", 10000, [&]() {
+    irsend.reset();
+    irsend.sendDaikin2(daikin2);
+  });
+
+  return 0;
+}
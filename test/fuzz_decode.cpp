@@ -0,0 +1,103 @@
+// Copyright 2019 David Conran
+
+// Fuzzing entry point for the decoder chain.
+//
+// Maps an arbitrary byte string onto a capture buffer & runs the full
+// IRrecv::decode() chain over it, so coverage-guided fuzzers can hunt for
+// crashes, sanitizer findings & (see below) pathological-latency inputs.
+//
+// libFuzzer build (needs clang):
+//   make fuzz_decode
+//   ./fuzz_decode corpus_dir/
+// Standalone reproducer/corpus runner (any compiler, no fuzzer engine):
+//   make fuzz_repro
+//   ./fuzz_repro crash-file [...]
+// The same entry point is AFL-compatible via afl-clang-fast++ & the
+// standalone driver.
+//
+// Latency assertion mode: set IR_FUZZ_BUDGET_US in the environment & any
+// input whose decode() takes longer than that many microseconds aborts,
+// which the fuzzer then minimises & reports like a crash. That is how the
+// worst-case inputs that the time-budgeted decode work (decodeBudgeted())
+// needs to bound are found. e.g.
+//   IR_FUZZ_BUDGET_US=500 ./fuzz_decode corpus_dir/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include "IRrecv.h"
+
+// More than any real capture. (Matches replay.cpp's sizing)
+const uint16_t kFuzzRawBuf = 2048;
+
+// Decode one fuzzer-supplied input. Consecutive byte pairs become capture
+// entries (little endian, in kRawTick units, zero coerced to one so no
+// "impossible" zero-duration edges distract from real findings).
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  // One receiver for the whole run. Persistent state (the repeat/dedup
+  // caches etc.) is deliberately carried between inputs: it is reachable
+  // state on a real device, so it should be fuzzed too.
+  static IRrecv irrecv(1);
+  static uint16_t rawbuf[kFuzzRawBuf];
+  static int64_t budget_us = -2;  // -2: unread. -1: no budget set.
+  if (budget_us == -2) {
+    const char *env = getenv("IR_FUZZ_BUDGET_US");
+    budget_us = env ? atol(env) : -1;
+  }
+
+  uint16_t rawlen = (uint16_t)std::min(size / 2, (size_t)(kFuzzRawBuf - 1));
+  if (rawlen < 2) return 0;  // Too short to be a capture worth decoding.
+  for (uint16_t i = 0; i < rawlen; i++) {
+    uint16_t ticks = (uint16_t)(data[2 * i] | (data[2 * i + 1] << 8));
+    rawbuf[i + 1] = ticks ? ticks : 1;
+  }
+  decode_results capture;
+  capture.rawbuf = rawbuf;
+  capture.rawlen = rawlen + 1;
+  capture.overflow = false;
+  capture.decode_type = UNKNOWN;
+  capture.bits = 0;
+  capture.repeat = false;
+  capture.value = capture.address = capture.command = 0;
+
+  typedef std::chrono::steady_clock clock;
+  clock::time_point start = clock::now();
+  irrecv.decode(&capture);
+  int64_t usecs = std::chrono::duration_cast<std::chrono::microseconds>(
+                      clock::now() - start).count();
+  if (budget_us >= 0 && usecs > budget_us) {
+    std::fprintf(stderr,
+                 "LATENCY: decode() took %lld usecs (budget %lld) on a "
+                 "%u-entry capture. (decoded as type %d)\n",
+                 (long long)usecs, (long long)budget_us, rawlen,
+                 capture.decode_type);
+    abort();  // Make the fuzzer treat it as a crash & minimise it.
+  }
+  return 0;
+}
+
+#ifdef FUZZ_STANDALONE
+// A minimal driver for running reproducers/corpora without a fuzzing
+// engine. Feeds each file named on the command line to the entry point.
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    std::fprintf(stderr, "Usage: %s <input file> [...]\n", argv[0]);
+    return 2;
+  }
+  for (int i = 1; i < argc; i++) {
+    FILE *file = std::fopen(argv[i], "rb");
+    if (file == NULL) {
+      std::fprintf(stderr, "Can't open '%s'. Skipping.\n", argv[i]);
+      continue;
+    }
+    static uint8_t data[2 * kFuzzRawBuf + 16];
+    size_t size = std::fread(data, 1, sizeof(data), file);
+    std::fclose(file);
+    std::printf("%s: %zu bytes\n", argv[i], size);
+    LLVMFuzzerTestOneInput(data, size);
+  }
+  return 0;
+}
+#endif  // FUZZ_STANDALONE
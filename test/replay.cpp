@@ -0,0 +1,247 @@
+// Copyright 2019 David Conran
+
+// Offline replay of captured IR timing corpora through IRrecv::decode().
+//
+// Build & run with:  make replay && ./replay <capture file> [...]
+//
+// Ingests files of IRrecvDumpV2-style rawData arrays. e.g.
+//   uint16_t rawData[67] = {9000, 4500, 560, ...};  // NEC 807F40BF
+// (Only the {...} numbers matter. If a "//" comment follows the array, its
+// first word is treated as the expected protocol name, when it parses.)
+//
+// Each capture is pumped through IRrecv::decode() and a per-protocol
+// summary of decode rates & decode-time distribution is reported, so the
+// decoder chain can be profiled & tuned against real-world traffic on a
+// desktop instead of flashing hardware.
+//
+// Big corpora can be sharded across threads with `-j N` (`-j 0` == one
+// per hardware core). Each worker gets its own IRrecv & capture buffer;
+// the decode path itself is reentrant in this build. (See IR_THREAD_LOCAL
+// in IRremoteESP8266.h) The per-capture timing methodology is unchanged -
+// only wall-clock time & the ordering of any MISMATCH lines differ from
+// a single-threaded run.
+
+#include <chrono>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include "IRrecv.h"
+#include "IRutils.h"
+
+// Nr. of times each capture is decoded; the fastest run is recorded, to
+// keep host scheduling noise out of the distribution.
+const uint16_t kRepsPerCapture = 16;
+// More than any real capture. (decode_results::rawlen is a uint16_t)
+const uint16_t kReplayRawBuf = 2048;
+
+// One parsed rawData array.
+struct Capture {
+  std::vector<uint16_t> usecs;
+  decode_type_t expected;  // From the trailing comment. UNKNOWN if absent.
+};
+
+// Per-protocol accumulators for the report.
+struct Tally {
+  uint32_t captures = 0;
+  uint64_t total_ns = 0;
+  uint64_t min_ns = UINT64_MAX;
+  uint64_t max_ns = 0;
+};
+
+// Pull every {...} array (& any trailing "//" comment) out of a dump file.
+static void loadCorpus(const char *path, std::vector<Capture> *corpus) {
+  std::ifstream file(path);
+  if (!file) {
+    std::fprintf(stderr, "Can't open '%s'. Skipping.\n", path);
+    return;
+  }
+  std::string text((std::istreambuf_iterator<char>(file)),
+                   std::istreambuf_iterator<char>());
+  // Anchor on the "rawData" token, so the companion `state[]` arrays that
+  // resultToSourceCode() emits for A/C protocols aren't replayed as noise.
+  for (size_t pos = text.find("rawData"); pos != std::string::npos;
+       pos = text.find("rawData", pos)) {
+    Capture capture;
+    capture.expected = UNKNOWN;
+    pos = text.find('{', pos);
+    if (pos == std::string::npos) break;
+    pos++;
+    while (pos < text.size() && text[pos] != '}') {
+      if (isdigit(text[pos])) {
+        uint32_t value = 0;
+        while (pos < text.size() && isdigit(text[pos]))
+          value = value * 10 + (text[pos++] - '0');
+        capture.usecs.push_back(std::min(value, (uint32_t)UINT16_MAX));
+      } else {
+        pos++;
+      }
+    }
+    // Look for an expected protocol in a comment before the next newline.
+    size_t eol = text.find('\n', pos);
+    size_t comment = text.find("//", pos);
+    if (comment != std::string::npos && (eol == std::string::npos ||
+                                         comment < eol)) {
+      comment += 2;
+      while (comment < text.size() && text[comment] == ' ') comment++;
+      size_t end = comment;
+      while (end < text.size() && !isspace(text[end])) end++;
+      capture.expected =
+          strToDecodeType(text.substr(comment, end - comment).c_str());
+      if (capture.expected < UNKNOWN) capture.expected = UNKNOWN;
+    }
+    if (!capture.usecs.empty()) corpus->push_back(capture);
+  }
+}
+
+// One worker's world: its own receiver & buffer, plus its shard of the
+// results, merged into the report after all the workers have joined.
+struct Worker {
+  IRrecv *irrecv;
+  std::vector<uint16_t> rawbuf;
+  std::map<int, Tally> tallies;  // Keyed by decoded protocol.
+  std::vector<std::string> mismatches;  // Printed after the join.
+  uint32_t expectations = 0;
+};
+
+// Decode every `stride`th capture starting at `first`. Striding (rather
+// than contiguous ranges) spreads any pathological file evenly.
+static void decodeShard(const std::vector<Capture> &corpus,
+                        const uint32_t first, const uint32_t stride,
+                        Worker *worker) {
+  decode_results capture;
+  for (size_t index = first; index < corpus.size(); index += stride) {
+    const Capture &entry = corpus[index];
+    // Mirror what IRsendTest::makeDecodeResult() sets up.
+    uint16_t rawlen = std::min((size_t)(kReplayRawBuf - 1),
+                               entry.usecs.size());
+    for (uint16_t i = 0; i < rawlen; i++)
+      worker->rawbuf[i + 1] = entry.usecs[i] / kRawTick;
+    capture.rawbuf = worker->rawbuf.data();
+    capture.rawlen = rawlen + 1;
+    capture.overflow = false;
+
+    uint64_t best_ns = UINT64_MAX;
+    for (uint16_t rep = 0; rep < kRepsPerCapture; rep++) {
+      capture.decode_type = UNKNOWN;
+      capture.bits = 0;
+      capture.repeat = false;
+      capture.value = capture.address = capture.command = 0;
+      typedef std::chrono::steady_clock clock;
+      clock::time_point start = clock::now();
+      worker->irrecv->decode(&capture);
+      uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        clock::now() - start).count();
+      if (ns < best_ns) best_ns = ns;
+    }
+
+    Tally &tally = worker->tallies[capture.decode_type];
+    tally.captures++;
+    tally.total_ns += best_ns;
+    if (best_ns < tally.min_ns) tally.min_ns = best_ns;
+    if (best_ns > tally.max_ns) tally.max_ns = best_ns;
+
+    if (entry.expected != UNKNOWN) {
+      worker->expectations++;
+      if (capture.decode_type != entry.expected) {
+        char line[128];
+        std::snprintf(line, sizeof(line),
+                      "MISMATCH: expected %s, decoded %s (%u entries)",
+                      typeToString(entry.expected).c_str(),
+                      typeToString((decode_type_t)capture.decode_type).c_str(),
+                      rawlen);
+        worker->mismatches.push_back(line);
+      }
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  uint32_t nr_of_workers = 1;
+  int arg = 1;
+  if (arg + 1 < argc && std::string(argv[arg]) == "-j") {
+    nr_of_workers = (uint32_t)atol(argv[arg + 1]);
+    if (!nr_of_workers)  // i.e. `-j 0` means one per hardware core.
+      nr_of_workers = std::max(std::thread::hardware_concurrency(), 1u);
+    arg += 2;
+  }
+  if (arg >= argc) {
+    std::fprintf(stderr, "Usage: %s [-j N] <capture file> [...]\n", argv[0]);
+    return 2;
+  }
+  std::vector<Capture> corpus;
+  for (; arg < argc; arg++) loadCorpus(argv[arg], &corpus);
+  if (corpus.empty()) {
+    std::fprintf(stderr, "No rawData arrays found.\n");
+    return 2;
+  }
+
+  // Construct every worker's receiver here, before any thread runs, so
+  // construction-time library bookkeeping stays single-threaded.
+  std::vector<Worker> workers(nr_of_workers);
+  for (Worker &worker : workers) {
+    worker.irrecv = new IRrecv(1);
+    worker.rawbuf.resize(kReplayRawBuf);
+  }
+
+  typedef std::chrono::steady_clock clock;
+  clock::time_point wall_start = clock::now();
+  if (nr_of_workers == 1) {
+    decodeShard(corpus, 0, 1, &workers[0]);
+  } else {
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < nr_of_workers; i++)
+      threads.push_back(std::thread(decodeShard, std::cref(corpus), i,
+                                    nr_of_workers, &workers[i]));
+    for (std::thread &thread : threads) thread.join();
+  }
+  double wall_secs = std::chrono::duration_cast<std::chrono::microseconds>(
+                         clock::now() - wall_start).count() / 1e6;
+
+  // Merge the shards.
+  std::map<int, Tally> tallies;
+  uint32_t mismatches = 0;
+  uint32_t expectations = 0;
+  for (const Worker &worker : workers) {
+    for (const auto &pair : worker.tallies) {
+      Tally &tally = tallies[pair.first];
+      tally.captures += pair.second.captures;
+      tally.total_ns += pair.second.total_ns;
+      tally.min_ns = std::min(tally.min_ns, pair.second.min_ns);
+      tally.max_ns = std::max(tally.max_ns, pair.second.max_ns);
+    }
+    expectations += worker.expectations;
+    mismatches += worker.mismatches.size();
+    for (const std::string &line : worker.mismatches)
+      std::printf("%s\n", line.c_str());
+  }
+
+  std::printf("\n%-22s %8s %7s %26s\n", "Protocol", "Captures", "Share",
+              "decode time min/avg/max");
+  uint32_t decoded = 0;
+  for (const auto &pair : tallies) {
+    const Tally &tally = pair.second;
+    if (pair.first != UNKNOWN) decoded += tally.captures;
+    std::printf("%-22s %8u %6.1f%% %8.1f/%8.1f/%8.1f us\n",
+                typeToString((decode_type_t)pair.first).c_str(),
+                tally.captures, 100.0 * tally.captures / corpus.size(),
+                tally.min_ns / 1e3,
+                tally.total_ns / 1e3 / tally.captures,
+                tally.max_ns / 1e3);
+  }
+  std::printf("\n%u/%zu captures decoded (%.1f%%)\n", decoded, corpus.size(),
+              100.0 * decoded / corpus.size());
+  std::printf("%.2f secs wall clock. %.0f captures/sec across %u thread%s.\n",
+              wall_secs, corpus.size() * kRepsPerCapture / wall_secs,
+              nr_of_workers, (nr_of_workers == 1) ? "" : "s");
+  if (expectations)
+    std::printf("%u/%u expectations matched\n", expectations - mismatches,
+                expectations);
+  for (Worker &worker : workers) delete worker.irrecv;
+  return (mismatches == 0) ? 0 : 1;
+}